@@ -64,6 +64,12 @@ void ZipOutputStream::putNextEntry(const std::string& entryName) {
 }
 
 
+void ZipOutputStream::putCompressedEntry( const ZipCDirEntry &entry, const char *data,
+                                          uint32 compressedSize, uint32 size, uint32 crc,
+                                          StorageMethod method ) {
+  ozf->putCompressedEntry( entry, data, compressedSize, size, crc, method ) ;
+}
+
 void ZipOutputStream::setComment( const std::string &comment ) {
   ozf->setComment( comment ) ;
 }
@@ -54,6 +54,19 @@ public:
   */
   void putNextEntry(const std::string& entryName);
 
+  /** Writes a complete entry whose data has already been compressed.
+      Closes the current entry first. The data must be raw deflate data
+      (no zlib header) if the method is DEFLATED.
+      @param entry the entry, its size, compressed size and crc are set
+      from the other parameters.
+      @param data pointer to the compressed data.
+      @param compressedSize size of the compressed data.
+      @param size size of the uncompressed data.
+      @param crc crc32 of the uncompressed data. */
+  void putCompressedEntry( const ZipCDirEntry &entry, const char *data,
+                           uint32 compressedSize, uint32 size, uint32 crc,
+                           StorageMethod method = DEFLATED ) ;
+
   /** Sets the global comment for the Zip archive. */
   void setComment( const std::string& comment ) ;
 
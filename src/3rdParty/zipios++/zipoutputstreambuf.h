@@ -49,6 +49,12 @@ public:
       entry. */
   void putNextEntry( const ZipCDirEntry &entry ) ;
 
+  /** Writes a complete entry whose data has already been compressed.
+      Closes the current entry first. */
+  void putCompressedEntry( const ZipCDirEntry &entry, const char *data,
+                           uint32 compressedSize, uint32 size, uint32 crc,
+                           StorageMethod method ) ;
+
   /** Sets the global comment for the Zip archive. */
   void setComment( const string &comment ) ;
 
@@ -68,6 +74,7 @@ protected:
 
   void setEntryClosedState() ;
   void updateEntryHeaderInfo() ;
+  static int dosTime() ;
 
   // Should/could be moved to zipheadio.h ?!
   static void writeCentralDirectory( const vector< ZipCDirEntry > &entries, 
@@ -2121,6 +2121,7 @@ void Application::initTypes()
     App::FeatureTestAbsAddress     ::init();
     App::FeatureTestPlacement      ::init();
     App::FeatureTestAttribute      ::init();
+    App::FeatureTestCache          ::init();
 
     // Feature class
     App::FeaturePython             ::init();
@@ -37,6 +37,7 @@
 #include <list>
 #include <algorithm>
 #include <filesystem>
+#include <numeric>
 #endif
 
 #include <boost/algorithm/string.hpp>
@@ -50,6 +51,7 @@
 
 #include <QCryptographicHash>
 #include <QCoreApplication>
+#include <QtConcurrentMap>
 
 #include <App/DocumentPy.h>
 #include <Base/Interpreter.h>
@@ -108,6 +110,12 @@ namespace App
 
 static bool globalIsRestoring;
 static bool globalIsRelabeling;
+// set on the worker threads of a parallel recompute
+static thread_local bool _ConcurrentRecompute;
+// the object that is recomputed on this worker thread
+static thread_local const DocumentObject* _ConcurrentObject;
+// true if someone observes the 'before change' notifications of that object
+static thread_local bool _ConcurrentObserved;
 
 DocumentP::DocumentP()
 {
@@ -503,6 +511,7 @@ void Document::_commitTransaction(bool notify)
             delete mUndoTransactions.front();
             mUndoTransactions.pop_front();
         }
+        _checkUndoLimit();
         signalCommitTransaction(*this);
 
         // closeActiveTransaction() may call again _commitTransaction()
@@ -715,14 +724,71 @@ int Document::getUndoMode() const
     return d->iUndoMode;
 }
 
-unsigned int Document::getUndoMemSize() const
+std::size_t Document::getUndoMemSize() const
+{
+    std::size_t size = 0;
+    for (auto trans : mUndoTransactions) {
+        size += trans->getPayloadSize();
+    }
+    for (auto trans : mRedoTransactions) {
+        size += trans->getPayloadSize();
+    }
+    return size;
+}
+
+std::size_t Document::getUndoLimit() const
 {
     return d->UndoMemSize;
 }
 
-void Document::setUndoLimit(unsigned int UndoMemSize)
+void Document::setUndoLimit(std::size_t UndoMemSize)
 {
     d->UndoMemSize = UndoMemSize;
+    if (!isPerformingTransaction() && !d->committing) {
+        _checkUndoLimit();
+    }
+}
+
+void Document::_checkUndoLimit()
+{
+    if (!d->UndoMemSize) {
+        return;
+    }
+    std::size_t size = getUndoMemSize();
+    if (size <= d->UndoMemSize) {
+        return;
+    }
+
+    // Spill the oldest steps first but keep the latest undo step in memory
+    // because it's the most likely one to be undone.
+    auto spill = [&](Transaction* trans) {
+        std::size_t oldSize = trans->getPayloadSize();
+        std::string file =
+            Base::FileInfo::getTempFileName("UndoSpill", TransientDir.getValue());
+        if (trans->spill(file)) {
+            size = size - oldSize + trans->getPayloadSize();
+        }
+    };
+    for (auto it = mRedoTransactions.begin(); size > d->UndoMemSize && it != mRedoTransactions.end();
+         ++it) {
+        spill(*it);
+    }
+    for (auto it = mUndoTransactions.begin();
+         size > d->UndoMemSize && !mUndoTransactions.empty() && *it != mUndoTransactions.back();
+         ++it) {
+        spill(*it);
+    }
+
+    // the same order as in clearUndos()
+    while (size > d->UndoMemSize && mUndoTransactions.size() > 1) {
+        size -= std::min(size, mUndoTransactions.front()->getPayloadSize());
+        mUndoMap.erase(mUndoTransactions.front()->getID());
+        delete mUndoTransactions.front();
+        mUndoTransactions.pop_front();
+    }
+    if (size > d->UndoMemSize) {
+        FC_LOG("Undo memory of " << getName() << " exceeds the limit: " << size << " bytes");
+    }
 }
 
 void Document::setMaxUndoStackSize(unsigned int UndoMaxStackSize)
@@ -808,9 +874,35 @@ void Document::onChanged(const Property* prop)
 void Document::onBeforeChangeProperty(const TransactionalObject* Who, const Property* What)
 {
     if (Who->isDerivedFrom<App::DocumentObject>()) {
-        signalBeforeChangeObject(*static_cast<const App::DocumentObject*>(Who), *What);
+        auto obj = static_cast<const App::DocumentObject*>(Who);
+        if (!_ConcurrentRecompute) {
+            signalBeforeChangeObject(*obj, *What);
+        }
+        else if (obj != _ConcurrentObject) {
+            // lazily loaded dependencies are restored by whoever needs them first
+            if (!What->testStatus(Property::RestoringDocFile)) {
+                FC_THROWM(Base::RuntimeError,
+                          "Cannot change " << obj->getFullName() << '.' << What->getName()
+                                           << " while recomputing "
+                                           << _ConcurrentObject->getFullName()
+                                           << " concurrently");
+            }
+            std::lock_guard<std::recursive_mutex> lock(d->recomputeMutex);
+            d->deferredChanges[obj].emplace_back(What, true);
+        }
+        else if (_ConcurrentObserved) {
+            _requestBeforeChange(obj, What);
+        }
+        else {
+            std::lock_guard<std::recursive_mutex> lock(d->recomputeMutex);
+            d->deferredChanges[obj].emplace_back(What, true);
+        }
+    }
+    std::unique_lock<std::recursive_mutex> lock(d->recomputeMutex, std::defer_lock);
+    if (_ConcurrentRecompute) {
+        lock.lock();
     }
-    if (!d->rollback && !globalIsRelabeling) {
+    if (!d->rollback && !globalIsRelabeling && !What->testStatus(Property::RestoringDocFile)) {
         _checkTransaction(nullptr, What, __LINE__);
         if (d->activeUndoTransaction) {
             d->activeUndoTransaction->addObjectChange(Who, What);
@@ -820,6 +912,12 @@ void Document::onBeforeChangeProperty(const TransactionalObject* Who, const Prop
 
 void Document::onChangedProperty(const DocumentObject* Who, const Property* What)
 {
+    d->recomputeCache.forget(Who, What);
+    if (_ConcurrentRecompute) {
+        std::lock_guard<std::recursive_mutex> lock(d->recomputeMutex);
+        d->deferredChanges[Who].emplace_back(What, false);
+        return;
+    }
     signalChangedObject(*Who, *What);
 }
 
@@ -1682,7 +1780,7 @@ unsigned int Document::getMemSize() const
     size += PropertyContainer::getMemSize();
 
     // Undo Redo size
-    size += getUndoMemSize();
+    size += static_cast<unsigned int>(getUndoMemSize());
 
     return size;
 }
@@ -2159,6 +2257,9 @@ bool Document::saveToFile(const char* filename) const
 
         writer.setComment("FreeCAD Document");
         writer.setLevel(compression);
+        if (hGrp->GetBool("SaveBinaryXML", false)) {
+            writer.setMode("BinaryXML");
+        }
         writer.putNextEntry("Document.xml");
 
         if (hGrp->GetBool("SaveBinaryBrep", false)) {
@@ -2313,6 +2414,25 @@ void Document::restore(const char* filename,
         throw Base::FileException("Error reading compression file", filename);
     }
 
+    // Large payloads such as shapes or meshes are then restored when accessed. They are
+    // read from a private copy because the file may be overwritten or removed while the
+    // document is open. Recovery files and files of the cache directory are moved away
+    // right after loading, so they are always read at once.
+    if (GetApplication()
+            .GetParameterGroupByPath("User parameter:BaseApp/Preferences/Document")
+            ->GetBool("LazyRestore", false)
+        && !testStatus(TempDoc) && Base::FileInfo(FileName.getValue()).filePath() == fi.filePath()
+        && fi.filePath().rfind(Application::getUserCachePath(), 0) != 0) {
+        Base::FileInfo copy(Base::FileInfo::getTempFileName("LazyRestore"));
+        if (fi.copyTo(copy.filePath().c_str()) && copy.size() == fi.size()) {
+            reader.setDocFileArchive(
+                std::make_shared<Base::DocFileArchive>(copy.filePath(), true));
+        }
+        else {
+            copy.deleteFile();
+        }
+    }
+
     GetApplication().signalStartRestoreDocument(*this);
     setStatus(Document::Restoring, true);
 
@@ -2964,8 +3084,13 @@ int Document::recompute(const std::vector<App::DocumentObject*>& objs,
 
     // delete recompute log
     d->clearRecomputeLog();
+    d->recomputeCache.clearKeys();
 
     FC_TIME_INIT(t);
+    RecomputeProfiler::Scope profile(&d->recomputeProfiler,
+                                     RecomputeProfiler::Category::Recompute,
+                                     nullptr,
+                                     getName());
 
     Base::ObjectStatusLocker<Document::Status, Document> exe(Document::Recomputing, this);
     signalBeforeRecompute(*this);
@@ -2999,6 +3124,7 @@ int Document::recompute(const std::vector<App::DocumentObject*>& objs,
     ParameterGrp::handle hGrp =
         GetApplication().GetParameterGroupByPath("User parameter:BaseApp/Preferences/Document");
     bool canAbort = hGrp->GetBool("CanAbortRecompute", true);
+    bool parallel = hGrp->GetBool("ParallelRecompute", false);
 
     std::set<App::DocumentObject*> filter;
     size_t idx = 0;
@@ -3014,6 +3140,18 @@ int Document::recompute(const std::vector<App::DocumentObject*>& objs,
                                                                 topoSortedObjects.size());
             }
             FC_LOG("Recompute pass " << passes);
+            if (parallel) {
+                int res = _recomputeConcurrently(topoSortedObjects,
+                                                 idx,
+                                                 filter,
+                                                 objectCount,
+                                                 hasError,
+                                                 seq.get());
+                idx = topoSortedObjects.size();
+                if (res < 0) {
+                    passes = 2;
+                }
+            }
             for (; idx < topoSortedObjects.size(); ++idx) {
                 auto obj = topoSortedObjects[idx];
                 if (!obj->isAttachedToDocument() || filter.find(obj) != filter.end()) {
@@ -3305,6 +3443,225 @@ const char* Document::getErrorDescription(const App::DocumentObject* Obj) const
     return d->findRecomputeLog(Obj);
 }
 
+int Document::_recomputeConcurrently(const std::vector<DocumentObject*>& objs,
+                                     size_t idx,
+                                     std::set<App::DocumentObject*>& filter,
+                                     int& objectCount,
+                                     bool* hasError,
+                                     Base::SequencerLauncher* seq)
+{
+    // Group the objects by the length of their longest dependency chain. The
+    // input is sorted so that dependencies come first, except for those objects
+    // that take part in a dependency inversion. The latter are never executed
+    // on a worker thread.
+    std::unordered_set<DocumentObject*> pending(objs.begin() + idx, objs.end());
+    std::unordered_set<DocumentObject*> unordered;
+    std::unordered_map<DocumentObject*, size_t> levelMap;
+    std::vector<std::vector<DocumentObject*>> levels;
+    for (size_t i = idx; i < objs.size(); ++i) {
+        auto obj = objs[i];
+        size_t level = 0;
+        for (auto dep : obj->getOutList()) {
+            auto it = levelMap.find(dep);
+            if (it != levelMap.end()) {
+                level = std::max(level, it->second + 1);
+            }
+            else if (pending.count(dep)) {
+                unordered.insert(obj);
+            }
+        }
+        levelMap[obj] = level;
+        if (level >= levels.size()) {
+            levels.resize(level + 1);
+        }
+        levels[level].push_back(obj);
+    }
+
+    FC_LOG("Recompute " << levels.size() << " dependency levels");
+
+    // Observers of the 'before change' notifications may need the old value.
+    // So, the workers of observed objects pass them to the main thread and
+    // wait until they're emitted, the others are queued. The document always
+    // forwards the signal to the application.
+    bool observed = signalBeforeChangeObject.num_slots() > 1
+        || !GetApplication().signalBeforeChangeObject.empty();
+
+    for (auto& level : levels) {
+        std::vector<DocumentObject*> concurrent;
+        std::vector<char> observedObjects;
+        for (auto obj : level) {
+            if (obj->isAttachedToDocument() && !filter.count(obj) && obj->mustRecompute()
+                && obj->canRecomputeConcurrently() && !unordered.count(obj)) {
+                concurrent.push_back(obj);
+                observedObjects.push_back(observed || !obj->signalBeforeChange.empty());
+            }
+        }
+
+        std::unordered_map<DocumentObject*, int> results;
+        if (concurrent.size() > 1) {
+            std::vector<int> codes(concurrent.size(), 0);
+            std::vector<size_t> indices(concurrent.size());
+            std::iota(indices.begin(), indices.end(), 0);
+            {
+                // a worker may need the GIL to evaluate an expression
+                std::unique_ptr<Base::PyGILStateRelease> release;
+                if (Py_IsInitialized() && PyGILState_Check()) {
+                    release = std::make_unique<Base::PyGILStateRelease>();
+                }
+                d->runningWorkers = concurrent.size();
+                QFuture<void> future = QtConcurrent::map(indices, [&](size_t i) {
+                    {
+                        Base::StateLocker guard(_ConcurrentRecompute);
+                        _ConcurrentObject = concurrent[i];
+                        _ConcurrentObserved = observedObjects[i] != 0;
+                        codes[i] = _recomputeFeature(concurrent[i]);
+                        _ConcurrentObject = nullptr;
+                    }
+                    std::lock_guard<std::mutex> lock(d->requestMutex);
+                    --d->runningWorkers;
+                    d->requestCondition.notify_all();
+                });
+                _emitBeforeChangeRequests();
+                future.waitForFinished();
+            }
+            _flushDeferredChanges(concurrent);
+            for (size_t i = 0; i < concurrent.size(); ++i) {
+                results[concurrent[i]] = codes[i];
+            }
+        }
+
+        // objects of the same level are independent of each other, so it's safe
+        // to handle the results in the original order
+        for (auto obj : level) {
+            if (!obj->isAttachedToDocument() || filter.count(obj)) {
+                continue;
+            }
+            bool doRecompute = false;
+            auto it = results.find(obj);
+            if (it != results.end() || obj->mustRecompute()) {
+                doRecompute = true;
+                ++objectCount;
+                int res = it != results.end() ? it->second : _recomputeFeature(obj);
+                if (res) {
+                    if (hasError) {
+                        *hasError = true;
+                    }
+                    if (res < 0) {
+                        return -1;
+                    }
+                    obj->getInListEx(filter, true);
+                    filter.insert(obj);
+                    continue;
+                }
+            }
+            if (obj->isTouched() || doRecompute) {
+                signalRecomputedObject(*obj);
+                obj->purgeTouched();
+                for (auto inObjIt : obj->getInList()) {
+                    inObjIt->enforceRecompute();
+                }
+            }
+            if (seq) {
+                seq->next(true);
+            }
+        }
+    }
+
+    return 0;
+}
+
+void Document::_flushDeferredChanges(const std::vector<DocumentObject*>& objs)
+{
+    auto flush = [this](DocumentObject* obj) {
+        auto it = d->deferredChanges.find(obj);
+        if (it == d->deferredChanges.end()) {
+            return;
+        }
+        auto changes = std::move(it->second);
+        d->deferredChanges.erase(it);
+        for (const auto& change : changes) {
+            if (change.second) {
+                signalBeforeChangeObject(*obj, *change.first);
+                obj->signalBeforeChange(*obj, *change.first);
+            }
+            else {
+                signalChangedObject(*obj, *change.first);
+                obj->signalChanged(*obj, *change.first);
+            }
+        }
+    };
+
+    for (auto obj : objs) {
+        flush(obj);
+    }
+
+    // an object may have changed other objects, e.g. when restoring a lazily
+    // loaded dependency, handle them in document order
+    for (size_t i = 0; i < d->objectArray.size() && !d->deferredChanges.empty(); ++i) {
+        flush(d->objectArray[i]);
+    }
+    d->deferredChanges.clear();
+}
+
+void Document::_emitBeforeChangeRequests()
+{
+    std::unique_lock<std::mutex> lock(d->requestMutex);
+    for (;;) {
+        d->requestCondition.wait(lock, [this]() {
+            return d->runningWorkers == 0 || !d->beforeChangeRequests.empty();
+        });
+        if (d->beforeChangeRequests.empty()) {
+            break;
+        }
+        auto request = d->beforeChangeRequests.front();
+        d->beforeChangeRequests.pop_front();
+        lock.unlock();
+        try {
+            signalBeforeChangeObject(*request->object, *request->property);
+            request->object->signalBeforeChange(*request->object, *request->property);
+        }
+        catch (...) {
+            // the worker raises it when changing the property
+            request->error = std::current_exception();
+        }
+        lock.lock();
+        request->done = true;
+        d->requestCondition.notify_all();
+    }
+}
+
+void Document::_requestBeforeChange(const DocumentObject* Who, const Property* What)
+{
+    // the main thread may need the GIL to notify a Python observer
+    std::unique_ptr<Base::PyGILStateRelease> release;
+    if (Py_IsInitialized() && PyGILState_Check()) {
+        release = std::make_unique<Base::PyGILStateRelease>();
+    }
+    DocumentP::BeforeChangeRequest request {Who, What, false, nullptr};
+    {
+        std::unique_lock<std::mutex> lock(d->requestMutex);
+        d->beforeChangeRequests.push_back(&request);
+        d->requestCondition.notify_all();
+        d->requestCondition.wait(lock, [&request]() {
+            return request.done;
+        });
+    }
+    release.reset();
+    if (request.error) {
+        std::rethrow_exception(request.error);
+    }
+}
+
+bool Document::isRecomputingConcurrently()
+{
+    return _ConcurrentRecompute;
+}
+
+RecomputeProfiler& Document::getRecomputeProfiler() const
+{
+    return d->recomputeProfiler;
+}
+
 // call the recompute of the Feature and handle the exceptions and errors.
 int Document::_recomputeFeature(DocumentObject* Feat)
 {
@@ -3314,7 +3671,20 @@ int Document::_recomputeFeature(DocumentObject* Feat)
     try {
         returnCode = Feat->ExpressionEngine.execute(PropertyExpressionEngine::ExecuteNonOutput);
         if (returnCode == DocumentObject::StdReturn) {
-            returnCode = Feat->recompute();
+            bool useCache = RecomputeCache::isEnabled();
+            if (useCache && d->recomputeCache.restore(Feat)) {
+                // the extensions aren't part of the cached result
+                returnCode = Feat->executeExtensions();
+            }
+            else {
+                RecomputeProfiler::Scope profile(&d->recomputeProfiler,
+                                                 RecomputeProfiler::Category::Execute,
+                                                 Feat);
+                returnCode = Feat->recompute();
+                if (useCache && returnCode == DocumentObject::StdReturn) {
+                    d->recomputeCache.save(Feat);
+                }
+            }
             if (returnCode == DocumentObject::StdReturn) {
                 returnCode =
                     Feat->ExpressionEngine.execute(PropertyExpressionEngine::ExecuteOutput);
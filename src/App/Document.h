@@ -34,6 +34,7 @@
 #include "PropertyStandard.h"
 
 #include <map>
+#include <set>
 #include <vector>
 #include <utility>
 #include <list>
@@ -42,6 +43,7 @@
 
 namespace Base
 {
+class SequencerLauncher;
 class Writer;
 }
 
@@ -55,6 +57,7 @@ class DocumentPy;
 class Application;
 class Transaction;
 class StringHasher;
+class RecomputeProfiler;
 using StringHasherRef = Base::Reference<StringHasher>;
 
 /**
@@ -400,6 +403,10 @@ public:
                   int options = 0);
     /// Recompute only one feature
     bool recomputeFeature(DocumentObject* Feat, bool recursive = false);
+    /// Check if the calling thread is a worker of a parallel recompute
+    static bool isRecomputingConcurrently();
+    /// Returns the profiler that records the time spent in recomputes
+    RecomputeProfiler& getRecomputeProfiler() const;
     /// get the text of the error of a specified object
     const char* getErrorDescription(const App::DocumentObject*) const;
     /// return the status bits
@@ -454,10 +461,16 @@ public:
     /// Check if a transaction is open and its list is empty.
     /// If no transaction is open true is returned.
     bool isTransactionEmpty() const;
-    /// Set the Undo limit in Byte!
-    void setUndoLimit(unsigned int UndoMemSize = 0);
+    /** Set the Undo limit in Byte!
+     * If the undo and redo steps use more memory, the payload of the older steps
+     * is spilled to a file in the transient directory and the oldest steps are
+     * removed if that isn't enough. 0 means no limit.
+     */
+    void setUndoLimit(std::size_t UndoMemSize = 0);
+    /// Returns the Undo limit in Byte
+    std::size_t getUndoLimit() const;
     /// Returns the actual memory consumption of the Undo redo stuff.
-    unsigned int getUndoMemSize() const;
+    std::size_t getUndoMemSize() const;
     /// Set the Undo limit as stack size
     void setMaxUndoStackSize(unsigned int UndoMaxStackSize = 20);  // NOLINT
     /// Set the Undo limit as stack size
@@ -637,7 +650,31 @@ protected:
     /// helper which Recompute only this feature
     /// @return 0 if succeeded, 1 if failed, -1 if aborted by user.
     int _recomputeFeature(DocumentObject* Feat);
+    /** helper which recomputes the objects from index @a idx onward level by level
+     *
+     * Objects of the same dependency level don't depend on each other. Those
+     * that can be executed concurrently run on the global thread pool, the
+     * others run on the main thread afterwards.
+     * @return 0 if succeeded, -1 if aborted by user.
+     */
+    int _recomputeConcurrently(const std::vector<DocumentObject*>& objs,
+                               size_t idx,
+                               std::set<App::DocumentObject*>& filter,
+                               int& objectCount,
+                               bool* hasError,
+                               Base::SequencerLauncher* seq);
+    /// emit the property change notifications queued during a parallel recompute,
+    /// those of @a objs come first
+    void _flushDeferredChanges(const std::vector<DocumentObject*>& objs);
+    /// emit the 'before change' notifications that workers pass to the main
+    /// thread until all workers are done
+    void _emitBeforeChangeRequests();
+    /// called on a worker thread, waits until the main thread emitted the
+    /// 'before change' notification of @a What
+    void _requestBeforeChange(const DocumentObject* Who, const Property* What);
     void _clearRedos();
+    /// spill or remove old transactions to respect the undo limit
+    void _checkUndoLimit();
 
     /// refresh the internal dependency graph
     void _rebuildDependencyList(
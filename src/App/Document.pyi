@@ -1,6 +1,6 @@
 from PropertyContainer import PropertyContainer
 from DocumentObject import DocumentObject
-from typing import Final, List, Tuple, Sequence
+from typing import Final, List, Optional, Tuple, Sequence
 
 
 class Document(PropertyContainer):
@@ -52,6 +52,10 @@ class Document(PropertyContainer):
     RecomputesFrozen: bool = False
     """Returns or sets if automatic recomputes for this document are disabled."""
 
+    RecomputeProfiling: bool = False
+    """Returns or sets if the recompute profiler of this document is enabled.
+Enabling the profiler discards the previously recorded entries."""
+
     HasPendingTransaction: Final[bool] = False
     """Check if there is a pending transaction"""
 
@@ -319,6 +323,23 @@ class Document(PropertyContainer):
         """
         ...
 
+    def getRecomputeProfile(self) -> List[dict]:
+        """
+        getRecomputeProfile(): Returns the entries recorded by the recompute profiler
+
+        Each entry is a dictionary with the keys 'Name', 'Category', 'Start',
+        'Duration', 'MemSize' and 'Thread'. Times are given in microseconds.
+        """
+        ...
+
+    def exportRecomputeProfile(self, filename: str = None) -> Optional[str]:
+        """
+        exportRecomputeProfile(filename=None): Export the recompute profile as Chrome trace
+
+        If no file name is given the JSON text is returned.
+        """
+        ...
+
     def mustExecute(self) -> bool:
         """
         Check if any object must be recomputed
@@ -740,6 +740,10 @@ void DocumentObject::onBeforeChange(const Property* prop)
 
     if (_pDoc){
         onBeforeChangeProperty(_pDoc, prop);
+        // the document emits the signal once the concurrent recompute is done
+        if (Document::isRecomputingConcurrently()) {
+            return;
+        }
     }
 
     signalBeforeChange(*this, *prop);
@@ -864,7 +868,7 @@ void DocumentObject::onChanged(const Property* prop)
 
     // set object touched if it is an input property
     if (!testStatus(ObjectStatus::NoTouch) && !(prop->getType() & Prop_Output)
-        && !prop->testStatus(Property::Output)) {
+        && !prop->testStatus(Property::Output) && !prop->testStatus(Property::RestoringDocFile)) {
         if (!StatusBits.test(ObjectStatus::Touch)) {
             FC_TRACE("touch '" << getFullName() << "' on change of '" << prop->getName() << "'");
             StatusBits.set(ObjectStatus::Touch);
@@ -881,6 +885,9 @@ void DocumentObject::onChanged(const Property* prop)
     // Now signal the view provider
     if (_pDoc) {
         _pDoc->onChangedProperty(this, prop);
+        if (Document::isRecomputingConcurrently()) {
+            return;
+        }
     }
 
     signalChanged(*this, *prop);
@@ -512,6 +512,57 @@ public:
         return false;
     }
 
+    /** Return true if execute() may run on a worker thread
+     *
+     * When the document recomputes in parallel mode, objects that return
+     * true here are executed concurrently with other independent objects.
+     * Such an object must only modify its own properties and must not run
+     * any Python code or use the sequencer inside execute(). Changing another
+     * object raises an exception. Property change notifications are queued and
+     * emitted from the main thread once the object is done. If someone observes
+     * the 'before change' notifications, the worker passes them to the main
+     * thread and waits until they're emitted. The default is false, i.e. the
+     * object is executed on the main thread.
+     */
+    virtual bool canRecomputeConcurrently() const
+    {
+        return false;
+    }
+
+    /** @name Recompute result cache
+     * An object whose result only depends on its input properties and on the
+     * objects it links to can have its result cached. If a later recompute
+     * finds identical inputs, the result is restored instead of calling
+     * execute() again.
+     */
+    //@{
+    /// Return the properties set by execute(), or nothing if the result can't be cached
+    virtual std::vector<const Property*> getRecomputeResult() const
+    {
+        return {};
+    }
+    /// Write the result of the last execute() to the stream
+    virtual bool saveRecomputeResult(std::ostream& stream) const
+    {
+        (void)stream;
+        return false;
+    }
+    /// Read back a result written by saveRecomputeResult()
+    virtual bool restoreRecomputeResult(std::istream& stream)
+    {
+        (void)stream;
+        return false;
+    }
+    /** Return the external files read by execute(). Their content is part of
+     * the key, so that the objects depending on this one aren't restored from
+     * a result computed with an older version of the file.
+     */
+    virtual std::vector<std::string> getRecomputeInputFiles() const
+    {
+        return {};
+    }
+    //@}
+
     /* Return true to bypass duplicate label checking */
     virtual bool allowDuplicateLabel() const
     {
@@ -31,6 +31,7 @@
 #include "DocumentObject.h"
 #include "DocumentObjectPy.h"
 #include "MergeDocuments.h"
+#include "RecomputeProfiler.h"
 
 // inclusion of the generated files (generated By DocumentPy.xml)
 #include "DocumentPy.h"
@@ -711,6 +712,57 @@ PyObject* DocumentPy::recompute(PyObject* args)
     PY_CATCH;
 }
 
+PyObject* DocumentPy::getRecomputeProfile(PyObject* args)
+{
+    if (!PyArg_ParseTuple(args, "")) {
+        return nullptr;
+    }
+    PY_TRY
+    {
+        Py::List ret;
+        for (const auto& entry : getDocumentPtr()->getRecomputeProfiler().getEntries()) {
+            Py::Dict dict;
+            dict.setItem("Name", Py::String(entry.name));
+            dict.setItem("Category",
+                         Py::String(RecomputeProfiler::getCategoryName(entry.category)));
+            dict.setItem("Start", Py::Long(static_cast<long>(entry.start)));
+            dict.setItem("Duration", Py::Long(static_cast<long>(entry.duration)));
+            dict.setItem("MemSize", Py::Long(static_cast<unsigned long>(entry.memSize)));
+            dict.setItem("Thread", Py::Long(entry.thread));
+            ret.append(dict);
+        }
+        return Py::new_reference_to(ret);
+    }
+    PY_CATCH;
+}
+
+PyObject* DocumentPy::exportRecomputeProfile(PyObject* args)
+{
+    char* fn = nullptr;
+    if (!PyArg_ParseTuple(args, "|s", &fn)) {
+        return nullptr;
+    }
+    PY_TRY
+    {
+        const auto& profiler = getDocumentPtr()->getRecomputeProfiler();
+        if (fn) {
+            Base::FileInfo fi(fn);
+            Base::ofstream str(fi);
+            if (!str.is_open()) {
+                throw Base::FileException("Cannot open file", fi);
+            }
+            profiler.exportChromeTrace(str);
+            str.close();
+            Py_Return;
+        }
+
+        std::stringstream str;
+        profiler.exportChromeTrace(str);
+        return PyUnicode_FromString(str.str().c_str());
+    }
+    PY_CATCH;
+}
+
 PyObject* DocumentPy::mustExecute(PyObject* args)
 {
     if (!PyArg_ParseTuple(args, "")) {
@@ -973,6 +1025,16 @@ void DocumentPy::setRecomputesFrozen(Py::Boolean arg)
     getDocumentPtr()->setStatus(Document::Status::SkipRecompute, arg.isTrue());
 }
 
+Py::Boolean DocumentPy::getRecomputeProfiling() const
+{
+    return {getDocumentPtr()->getRecomputeProfiler().isEnabled()};
+}
+
+void DocumentPy::setRecomputeProfiling(Py::Boolean arg)
+{
+    getDocumentPtr()->getRecomputeProfiler().setEnabled(arg.isTrue());
+}
+
 PyObject* DocumentPy::getTempFileName(PyObject* args)
 {
     PyObject* value;
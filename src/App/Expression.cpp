@@ -34,6 +34,7 @@
 #include <boost/math/special_functions/round.hpp>
 #include <boost/math/special_functions/trunc.hpp>
 
+#include <atomic>
 #include <numbers>
 #include <limits>
 #include <sstream>
@@ -51,6 +52,7 @@
 #include <Base/RotationPy.h>
 #include <Base/VectorPy.h>
 
+#include "ExpressionCompiler.h"
 #include "ExpressionParser.h"
 
 
@@ -840,8 +842,11 @@ void Expression::Component::toString(std::ostream &ss, bool persistent) const {
 
 TYPESYSTEM_SOURCE_ABSTRACT(App::Expression, Base::BaseClass)
 
+static std::atomic<std::size_t> _ExpressionId;
+
 Expression::Expression(const DocumentObject *_owner)
     : owner(const_cast<App::DocumentObject*>(_owner))
+    , id(++_ExpressionId)
 {
 
 }
@@ -2952,30 +2957,41 @@ void VariableExpression::_getIdentifiers(std::map<App::ObjectIdentifier,bool> &d
 bool VariableExpression::_relabeledDocument(const std::string &oldName,
         const std::string &newName, ExpressionVisitor &v)
 {
-    return var.relabeledDocument(v, oldName, newName);
+    if (!var.relabeledDocument(v, oldName, newName))
+        return false;
+    CompiledExpression::invalidate(owner);
+    return true;
 }
 
 bool VariableExpression::_adjustLinks(
         const std::set<App::DocumentObject *> &inList, ExpressionVisitor &v)
 {
-    return var.adjustLinks(v,inList);
+    if (!var.adjustLinks(v,inList))
+        return false;
+    CompiledExpression::invalidate(owner);
+    return true;
 }
 
 void VariableExpression::_importSubNames(const ObjectIdentifier::SubNameMap &subNameMap)
 {
     var.importSubNames(subNameMap);
+    CompiledExpression::invalidate(owner);
 }
 
 void VariableExpression::_updateLabelReference(
         App::DocumentObject *obj, const std::string &ref, const char *newLabel)
 {
     var.updateLabelReference(obj,ref,newLabel);
+    CompiledExpression::invalidate(owner);
 }
 
 bool VariableExpression::_updateElementReference(
         App::DocumentObject *feature, bool reverse, ExpressionVisitor &v)
 {
-    return var.updateElementReference(v,feature,reverse);
+    if (!var.updateElementReference(v,feature,reverse))
+        return false;
+    CompiledExpression::invalidate(owner);
+    return true;
 }
 
 bool VariableExpression::_renameObjectIdentifier(
@@ -3001,6 +3017,7 @@ bool VariableExpression::_renameObjectIdentifier(
                                       true,
                                       originalSubObjectName);
         }
+        CompiledExpression::invalidate(owner);
         return true;
     }
     return false;
@@ -3036,6 +3053,7 @@ void VariableExpression::_moveCells(const CellAddress &address,
         addr.setRow(thisRow + rowCount);
         addr.setCol(thisCol + colCount);
         var.setComponent(idx,ObjectIdentifier::SimpleComponent(addr.toString()));
+        CompiledExpression::invalidate(owner);
     }
 }
 
@@ -3060,12 +3078,14 @@ void VariableExpression::_offsetCells(int rowOffset, int colOffset, ExpressionVi
     } else {
         v.aboutToChange();
         var.setComponent(idx,ObjectIdentifier::SimpleComponent(addr.toString()));
+        CompiledExpression::invalidate(owner);
     }
 }
 
 void VariableExpression::setPath(const ObjectIdentifier &path)
 {
      var = path;
+     CompiledExpression::invalidate(owner);
 }
 
 //
@@ -172,6 +172,8 @@ public:
     };
 
     App::DocumentObject *  getOwner() const { return owner; }
+    /// Unique id of this expression, e.g. to cache its compiled form
+    std::size_t getId() const { return id; }
     struct Component;
 
     virtual void addComponent(Component* component);
@@ -222,6 +224,9 @@ protected:
 
     ComponentList components;
 
+private:
+    std::size_t id;
+
 public:
     std::string comment;
     // clang-format on
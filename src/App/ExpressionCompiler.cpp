@@ -0,0 +1,1460 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <numbers>
+#include <unordered_map>
+#endif
+
+#include <boost/math/special_functions/round.hpp>
+#include <boost/math/special_functions/trunc.hpp>
+
+#include <Base/Console.h>
+#include <Base/Interpreter.h>
+#include <Base/QuantityPy.h>
+
+#include "ExpressionCompiler.h"
+#include "Application.h"
+#include "Document.h"
+#include "ExpressionParser.h"
+#include "PropertyStandard.h"
+#include "PropertyUnits.h"
+
+
+FC_LOG_LEVEL_INIT("Expression", true, true)
+
+using namespace App;
+
+namespace
+{
+
+using Value = CompiledExpression::Value;
+using OpCode = CompiledExpression::OpCode;
+
+using Counter = std::shared_ptr<std::atomic<std::size_t>>;
+
+// The programs share the counters, so that they outlive deleted documents
+std::mutex CounterMutex;
+std::unordered_map<const Document*, Counter> DocumentCounters;
+// Bumped when a document is added or renamed
+const Counter DocumentsCounter = std::make_shared<std::atomic<std::size_t>>(1);
+
+Counter getCounter(const Document* doc)
+{
+    if (!doc) {
+        return DocumentsCounter;
+    }
+    std::lock_guard<std::mutex> lock(CounterMutex);
+    Counter& counter = DocumentCounters[doc];
+    if (!counter) {
+        counter = std::make_shared<std::atomic<std::size_t>>(1);
+    }
+    return counter;
+}
+
+void bumpCounter(const Document* doc, bool remove = false)
+{
+    std::lock_guard<std::mutex> lock(CounterMutex);
+    auto it = DocumentCounters.find(doc);
+    if (it != DocumentCounters.end()) {
+        ++*it->second;
+        if (remove) {
+            DocumentCounters.erase(it);
+        }
+    }
+}
+
+// Largest magnitude of an integer that converts exactly to double
+constexpr long long MaxExactInteger = 1LL << std::numeric_limits<double>::digits;
+
+bool connectSignals()
+{
+    auto& app = GetApplication();
+    auto invalidateDocument = [](const Document& doc) {
+        // references by the name or label of the document may resolve differently
+        CompiledExpression::invalidate();
+        CompiledExpression::invalidate(&doc);
+    };
+    auto invalidateObject = [](const DocumentObject& obj) {
+        CompiledExpression::invalidate(&obj);
+    };
+    auto invalidateProperty = [](const Property& prop) {
+        auto obj = dynamic_cast<const DocumentObject*>(prop.getContainer());
+        if (obj) {
+            CompiledExpression::invalidate(obj);
+        }
+    };
+    app.signalNewDocument.connect([](const Document&, bool) {
+        CompiledExpression::invalidate();
+    });
+    app.signalDeleteDocument.connect([](const Document& doc) {
+        bumpCounter(&doc, true);
+    });
+    app.signalRelabelDocument.connect(invalidateDocument);
+    app.signalRenameDocument.connect(invalidateDocument);
+    app.signalFinishRestoreDocument.connect(invalidateDocument);
+    app.signalNewObject.connect(invalidateObject);
+    app.signalDeletedObject.connect(invalidateObject);
+    app.signalRelabelObject.connect(invalidateObject);
+    app.signalAppendDynamicProperty.connect(invalidateProperty);
+    app.signalRemoveDynamicProperty.connect(invalidateProperty);
+    return true;
+}
+
+bool isExact(long value)
+{
+    return value <= MaxExactInteger && value >= -MaxExactInteger;
+}
+
+bool isTrue(const Value& value)
+{
+    return value.isIntegral() ? value.integer != 0 : value.number != 0.0;
+}
+
+void setInteger(Value& result, long value)
+{
+    result.type = Value::Integer;
+    result.integer = value;
+}
+
+void setBoolean(Value& result, bool value)
+{
+    result.type = Value::Boolean;
+    result.integer = value ? 1 : 0;
+}
+
+void setFloat(Value& result, double value)
+{
+    result.type = Value::Float;
+    result.number = value;
+}
+
+void setQuantity(Value& result, const Base::Quantity& value)
+{
+    result.type = Value::Quantity;
+    result.number = value.getValue();
+    result.unit = value.getUnit();
+}
+
+bool addOverflows(long a, long b)
+{
+    return (b > 0 && a > std::numeric_limits<long>::max() - b)
+        || (b < 0 && a < std::numeric_limits<long>::min() - b);
+}
+
+bool subtractOverflows(long a, long b)
+{
+    return (b < 0 && a > std::numeric_limits<long>::max() + b)
+        || (b > 0 && a < std::numeric_limits<long>::min() + b);
+}
+
+bool multiplyOverflows(long a, long b)
+{
+    constexpr long max = std::numeric_limits<long>::max();
+    constexpr long min = std::numeric_limits<long>::min();
+    if (a == 0 || b == 0) {
+        return false;
+    }
+    if (a > 0) {
+        return b > 0 ? a > max / b : b < min / a;
+    }
+    return b > 0 ? a < min / b : a < max / b;
+}
+
+// Python's int ** int with a non negative exponent
+bool integerPower(long base, long exponent, long& result)
+{
+    result = 1;
+    while (exponent > 0) {
+        if (exponent & 1) {
+            if (multiplyOverflows(result, base)) {
+                return false;
+            }
+            result *= base;
+        }
+        exponent >>= 1;
+        if (exponent > 0) {
+            if (multiplyOverflows(base, base)) {
+                return false;
+            }
+            base *= base;
+        }
+    }
+    return true;
+}
+
+// Python's float ** float, false where Python raises or returns a complex
+bool floatPower(double base, double exponent, double& result)
+{
+    if (exponent == 0.0) {
+        result = 1.0;
+        return true;
+    }
+    if (std::isnan(base)) {
+        result = base;
+        return true;
+    }
+    if (std::isnan(exponent)) {
+        result = base == 1.0 ? 1.0 : exponent;
+        return true;
+    }
+    if (std::isinf(base) || std::isinf(exponent)) {
+        return false;
+    }
+    if (base == 0.0 && exponent < 0.0) {
+        return false;
+    }
+    if (base < 0.0 && exponent != std::floor(exponent)) {
+        return false;
+    }
+    result = std::pow(base, exponent);
+    return std::isfinite(result);
+}
+
+// Python's float % float
+bool floatRemainder(double a, double b, double& result)
+{
+    if (b == 0.0) {
+        return false;
+    }
+    double mod = std::fmod(a, b);
+    if (mod != 0.0) {
+        if ((b < 0.0) != (mod < 0.0)) {
+            mod += b;
+        }
+    }
+    else {
+        mod = std::copysign(0.0, b);
+    }
+    result = mod;
+    return true;
+}
+
+template<typename T>
+bool compare(int op, T a, T b)
+{
+    switch (op) {
+        case OperatorExpression::EQ:
+            return a == b;
+        case OperatorExpression::NEQ:
+            return a != b;
+        case OperatorExpression::LT:
+            return a < b;
+        case OperatorExpression::GT:
+            return a > b;
+        case OperatorExpression::LTE:
+            return a <= b;
+        default:
+            return a >= b;
+    }
+}
+
+bool isComparison(int op)
+{
+    switch (op) {
+        case OperatorExpression::EQ:
+        case OperatorExpression::NEQ:
+        case OperatorExpression::LT:
+        case OperatorExpression::GT:
+        case OperatorExpression::LTE:
+        case OperatorExpression::GTE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Operators with a QuantityPy operand, see QuantityPy's number protocol
+bool quantityOperator(int op, const Value& a, const Value& b, Value& result)
+{
+    switch (op) {
+        case OperatorExpression::ADD:
+            setQuantity(result, a.toQuantity() + b.toQuantity());
+            return true;
+        case OperatorExpression::SUB:
+            setQuantity(result, a.toQuantity() - b.toQuantity());
+            return true;
+        case OperatorExpression::MUL:
+        case OperatorExpression::UNIT:
+            setQuantity(result, a.toQuantity() * b.toQuantity());
+            return true;
+        case OperatorExpression::DIV:
+            setQuantity(result, a.toQuantity() / b.toQuantity());
+            return true;
+        case OperatorExpression::MOD: {
+            if (a.type != Value::Quantity) {
+                return false;
+            }
+            double mod {};
+            if (!floatRemainder(a.number, b.toDouble(), mod)) {
+                return false;
+            }
+            setQuantity(result, Base::Quantity(mod, a.unit));
+            return true;
+        }
+        case OperatorExpression::POW: {
+            if (a.type != Value::Quantity) {
+                return false;
+            }
+            Base::Quantity base = a.toQuantity();
+            if (b.type == Value::Quantity) {
+                setQuantity(result, base.pow(b.toQuantity()));
+            }
+            else {
+                setQuantity(result, base.pow(b.toDouble()));
+            }
+            return true;
+        }
+        default:
+            break;
+    }
+
+    if (a.type != Value::Quantity || b.type != Value::Quantity) {
+        setBoolean(result, compare(op, a.toDouble(), b.toDouble()));
+        return true;
+    }
+
+    Base::Quantity qa = a.toQuantity();
+    Base::Quantity qb = b.toQuantity();
+    bool res {};
+    switch (op) {
+        case OperatorExpression::EQ:
+            res = qa == qb;
+            break;
+        case OperatorExpression::NEQ:
+            res = !(qa == qb);
+            break;
+        case OperatorExpression::LT:
+            res = qa < qb;
+            break;
+        case OperatorExpression::LTE:
+            res = qa < qb || qa == qb;
+            break;
+        case OperatorExpression::GT:
+            res = !(qa < qb) && !(qa == qb);
+            break;
+        default:
+            res = !(qa < qb);
+            break;
+    }
+    setBoolean(result, res);
+    return true;
+}
+
+// Operators on Python int and float
+bool numberOperator(int op, const Value& a, const Value& b, Value& result)
+{
+    bool integral = a.isIntegral() && b.isIntegral();
+    if (isComparison(op)) {
+        if (integral) {
+            setBoolean(result, compare(op, a.integer, b.integer));
+            return true;
+        }
+        if ((a.isIntegral() && !isExact(a.integer)) || (b.isIntegral() && !isExact(b.integer))) {
+            return false;
+        }
+        setBoolean(result, compare(op, a.toDouble(), b.toDouble()));
+        return true;
+    }
+
+    if (integral) {
+        long l = a.integer;
+        long r = b.integer;
+        switch (op) {
+            case OperatorExpression::ADD:
+                if (addOverflows(l, r)) {
+                    return false;
+                }
+                setInteger(result, l + r);
+                return true;
+            case OperatorExpression::SUB:
+                if (subtractOverflows(l, r)) {
+                    return false;
+                }
+                setInteger(result, l - r);
+                return true;
+            case OperatorExpression::MUL:
+            case OperatorExpression::UNIT:
+                if (multiplyOverflows(l, r)) {
+                    return false;
+                }
+                setInteger(result, l * r);
+                return true;
+            case OperatorExpression::DIV:
+                if (r == 0 || !isExact(l) || !isExact(r)) {
+                    return false;
+                }
+                setFloat(result, static_cast<double>(l) / static_cast<double>(r));
+                return true;
+            case OperatorExpression::MOD: {
+                if (r == 0) {
+                    return false;
+                }
+                long mod = r == -1 ? 0 : l % r;
+                if (mod != 0 && ((mod < 0) != (r < 0))) {
+                    mod += r;
+                }
+                setInteger(result, mod);
+                return true;
+            }
+            case OperatorExpression::POW: {
+                if (r >= 0) {
+                    long power {};
+                    if (!integerPower(l, r, power)) {
+                        return false;
+                    }
+                    setInteger(result, power);
+                    return true;
+                }
+                double power {};
+                if (!floatPower(static_cast<double>(l), static_cast<double>(r), power)) {
+                    return false;
+                }
+                setFloat(result, power);
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+
+    double l = a.toDouble();
+    double r = b.toDouble();
+    double res {};
+    switch (op) {
+        case OperatorExpression::ADD:
+            res = l + r;
+            break;
+        case OperatorExpression::SUB:
+            res = l - r;
+            break;
+        case OperatorExpression::MUL:
+        case OperatorExpression::UNIT:
+            res = l * r;
+            break;
+        case OperatorExpression::DIV:
+            if (r == 0.0) {
+                return false;
+            }
+            res = l / r;
+            break;
+        case OperatorExpression::MOD:
+            if (!floatRemainder(l, r, res)) {
+                return false;
+            }
+            break;
+        case OperatorExpression::POW:
+            if (!floatPower(l, r, res)) {
+                return false;
+            }
+            break;
+        default:
+            return false;
+    }
+    setFloat(result, res);
+    return true;
+}
+
+bool binaryOperator(int op, const Value& a, const Value& b, Value& result)
+{
+    if (a.type == Value::Quantity || b.type == Value::Quantity) {
+        return quantityOperator(op, a, b, result);
+    }
+    return numberOperator(op, a, b, result);
+}
+
+bool unaryOperator(int op, Value& value)
+{
+    switch (value.type) {
+        case Value::Integer:
+        case Value::Boolean:
+            if (op == OperatorExpression::NEG) {
+                if (value.integer == std::numeric_limits<long>::min()) {
+                    return false;
+                }
+                value.integer = -value.integer;
+            }
+            value.type = Value::Integer;
+            return true;
+        case Value::Float:
+            if (op == OperatorExpression::NEG) {
+                value.number = -value.number;
+            }
+            return true;
+        default:
+            if (op == OperatorExpression::NEG) {
+                value.number *= -1.0;
+            }
+            return true;
+    }
+}
+
+// Math functions, see FunctionExpression::evaluate()
+bool callFunction(int f, const Value* args, int count, Value& result)
+{
+    using std::numbers::pi;
+
+    Base::Quantity v1 = args[0].toQuantity();
+    Base::Quantity v2;
+    Base::Quantity v3;
+    if (count > 1) {
+        v2 = args[1].toQuantity();
+    }
+    if (count > 2) {
+        v3 = args[2].toQuantity();
+    }
+
+    double output {};
+    Base::Unit unit;
+    double scaler = 1;
+    double value = v1.getValue();
+
+    switch (f) {
+        case FunctionExpression::COS:
+        case FunctionExpression::SIN:
+        case FunctionExpression::TAN:
+            if (!v1.isDimensionlessOrUnit(Base::Unit::Angle)) {
+                return false;
+            }
+            value *= pi / 180.0;
+            break;
+        case FunctionExpression::ACOS:
+        case FunctionExpression::ASIN:
+        case FunctionExpression::ATAN:
+            if (!v1.isDimensionless()) {
+                return false;
+            }
+            unit = Base::Unit::Angle;
+            scaler = 180.0 / pi;
+            break;
+        case FunctionExpression::EXP:
+        case FunctionExpression::LOG:
+        case FunctionExpression::LOG10:
+        case FunctionExpression::SINH:
+        case FunctionExpression::TANH:
+        case FunctionExpression::COSH:
+            if (!v1.isDimensionless()) {
+                return false;
+            }
+            break;
+        case FunctionExpression::ROUND:
+        case FunctionExpression::TRUNC:
+        case FunctionExpression::CEIL:
+        case FunctionExpression::FLOOR:
+        case FunctionExpression::ABS:
+            unit = v1.getUnit();
+            break;
+        case FunctionExpression::SQRT:
+            unit = v1.getUnit().sqrt();
+            break;
+        case FunctionExpression::CBRT:
+            unit = v1.getUnit().cbrt();
+            break;
+        case FunctionExpression::ATAN2:
+            if (v1.getUnit() != v2.getUnit()) {
+                return false;
+            }
+            unit = Base::Unit::Angle;
+            scaler = 180.0 / pi;
+            break;
+        case FunctionExpression::MOD:
+            if (v1.getUnit() != v2.getUnit() && !v1.isDimensionless() && !v2.isDimensionless()) {
+                return false;
+            }
+            unit = v1.getUnit();
+            break;
+        case FunctionExpression::POW: {
+            if (!v2.isDimensionless()) {
+                return false;
+            }
+            double exponent = v2.getValue();
+            if (!v1.isDimensionless()) {
+                if (exponent - boost::math::round(exponent) < 1e-9) {
+                    unit = v1.getUnit().pow(exponent);
+                }
+                else {
+                    return false;
+                }
+            }
+            break;
+        }
+        case FunctionExpression::HYPOT:
+        case FunctionExpression::CATH:
+            if (v1.getUnit() != v2.getUnit() || (count > 2 && v2.getUnit() != v3.getUnit())) {
+                return false;
+            }
+            unit = v1.getUnit();
+            break;
+        default:
+            return false;
+    }
+
+    switch (f) {
+        case FunctionExpression::ACOS:
+            output = acos(value);
+            break;
+        case FunctionExpression::ASIN:
+            output = asin(value);
+            break;
+        case FunctionExpression::ATAN:
+            output = atan(value);
+            break;
+        case FunctionExpression::ABS:
+            output = fabs(value);
+            break;
+        case FunctionExpression::EXP:
+            output = exp(value);
+            break;
+        case FunctionExpression::LOG:
+            output = log(value);
+            break;
+        case FunctionExpression::LOG10:
+            output = log(value) / log(10.0);
+            break;
+        case FunctionExpression::SIN:
+            output = sin(value);
+            break;
+        case FunctionExpression::SINH:
+            output = sinh(value);
+            break;
+        case FunctionExpression::TAN:
+            output = tan(value);
+            break;
+        case FunctionExpression::TANH:
+            output = tanh(value);
+            break;
+        case FunctionExpression::SQRT:
+            output = sqrt(value);
+            break;
+        case FunctionExpression::CBRT:
+            output = cbrt(value);
+            break;
+        case FunctionExpression::COS:
+            output = cos(value);
+            break;
+        case FunctionExpression::COSH:
+            output = cosh(value);
+            break;
+        case FunctionExpression::MOD:
+            output = fmod(value, v2.getValue());
+            break;
+        case FunctionExpression::ATAN2:
+            output = atan2(value, v2.getValue());
+            break;
+        case FunctionExpression::POW:
+            output = pow(value, v2.getValue());
+            break;
+        case FunctionExpression::HYPOT:
+            output = sqrt(pow(v1.getValue(), 2) + pow(v2.getValue(), 2)
+                          + (count > 2 ? pow(v3.getValue(), 2) : 0));
+            break;
+        case FunctionExpression::CATH:
+            output = sqrt(pow(v1.getValue(), 2) - pow(v2.getValue(), 2)
+                          - (count > 2 ? pow(v3.getValue(), 2) : 0));
+            break;
+        case FunctionExpression::ROUND:
+            output = boost::math::round(value);
+            break;
+        case FunctionExpression::TRUNC:
+            output = boost::math::trunc(value);
+            break;
+        case FunctionExpression::CEIL:
+            output = ceil(value);
+            break;
+        case FunctionExpression::FLOOR:
+            output = floor(value);
+            break;
+        default:
+            return false;
+    }
+
+    setQuantity(result, Base::Quantity(scaler * output, unit));
+    return true;
+}
+
+int getArgumentCount(int f, std::size_t count)
+{
+    switch (f) {
+        case FunctionExpression::ABS:
+        case FunctionExpression::ACOS:
+        case FunctionExpression::ASIN:
+        case FunctionExpression::ATAN:
+        case FunctionExpression::CBRT:
+        case FunctionExpression::CEIL:
+        case FunctionExpression::COS:
+        case FunctionExpression::COSH:
+        case FunctionExpression::EXP:
+        case FunctionExpression::FLOOR:
+        case FunctionExpression::LOG:
+        case FunctionExpression::LOG10:
+        case FunctionExpression::ROUND:
+        case FunctionExpression::SIN:
+        case FunctionExpression::SINH:
+        case FunctionExpression::SQRT:
+        case FunctionExpression::TAN:
+        case FunctionExpression::TANH:
+        case FunctionExpression::TRUNC:
+            return count == 1 ? 1 : 0;
+        case FunctionExpression::ATAN2:
+        case FunctionExpression::MOD:
+        case FunctionExpression::POW:
+            return count == 2 ? 2 : 0;
+        case FunctionExpression::HYPOT:
+        case FunctionExpression::CATH:
+            return count == 2 || count == 3 ? static_cast<int>(count) : 0;
+        default:
+            return 0;
+    }
+}
+
+/// Caches the preference because expressions are evaluated on the worker
+/// threads of a parallel recompute and ParameterGrp is not thread safe
+class CompilerParams: public ParameterGrp::ObserverType
+{
+public:
+    CompilerParams()
+    {
+        handle = GetApplication().GetParameterGroupByPath(
+            "User parameter:BaseApp/Preferences/Document");
+        handle->Attach(this);
+        enabled = handle->GetBool("CompiledExpressions", true);
+    }
+
+    void OnChange(Base::Subject<const char*>&, const char* sReason) override
+    {
+        if (sReason && strcmp(sReason, "CompiledExpressions") == 0) {
+            enabled = handle->GetBool("CompiledExpressions", true);
+        }
+    }
+
+    ParameterGrp::handle handle;
+    std::atomic<bool> enabled;
+};
+
+CompilerParams* params()
+{
+    static CompilerParams* inst = new CompilerParams;
+    return inst;
+}
+
+}  // namespace
+
+namespace App
+{
+
+/// Translates an expression tree into the program of a CompiledExpression
+class ExpressionCompiler
+{
+public:
+    explicit ExpressionCompiler(CompiledExpression& result)
+        : result(result)
+    {}
+
+    /// What is known about the value of a sub-expression at compile time
+    struct Info
+    {
+        bool constant {false};
+        bool typeKnown {false};
+        Value::Type type {Value::Integer};
+        bool unitKnown {false};
+        Base::Unit unit;
+
+        bool isQuantity() const
+        {
+            return typeKnown && type == Value::Quantity;
+        }
+        bool isNumber() const
+        {
+            return typeKnown && type != Value::Quantity;
+        }
+    };
+
+    bool compile(const Expression* expr, Info& info)
+    {
+        if (!expr || expr->hasComponent()) {
+            return false;
+        }
+        if (expr->is<OperatorExpression>()) {
+            return compileOperator(static_cast<const OperatorExpression*>(expr), info);
+        }
+        if (expr->is<ConditionalExpression>()) {
+            return compileConditional(static_cast<const ConditionalExpression*>(expr), info);
+        }
+        if (expr->is<FunctionExpression>()) {
+            return compileFunction(static_cast<const FunctionExpression*>(expr), info);
+        }
+        if (expr->is<VariableExpression>()) {
+            return compileVariable(static_cast<const VariableExpression*>(expr), info);
+        }
+        if (expr->is<UnitExpression>() || expr->is<NumberExpression>()
+            || expr->is<ConstantExpression>()) {
+            return compileConstant(expr, info);
+        }
+        return false;
+    }
+
+private:
+    void emit(OpCode code, int operation = 0, int operand = 0)
+    {
+        result.program.push_back({code, operation, operand});
+    }
+
+    void push()
+    {
+        ++depth;
+        result.stackSize = std::max(result.stackSize, depth);
+    }
+
+    void addConstant(const Value& value, Info& info)
+    {
+        emit(OpCode::Constant, 0, static_cast<int>(result.constants.size()));
+        result.constants.push_back(value);
+        push();
+        info = Info();
+        info.constant = true;
+        info.typeKnown = true;
+        info.type = value.type;
+        info.unitKnown = true;
+        info.unit = value.type == Value::Quantity ? value.unit : Base::Unit();
+    }
+
+    /// Replaces the code of a constant sub-expression by its value
+    bool fold(std::size_t begin, std::size_t depthBefore, Info& info)
+    {
+        std::vector<Value> stack;
+        stack.reserve(result.stackSize);
+        try {
+            if (!result.run(begin, result.program.size(), stack) || stack.size() != 1) {
+                return false;
+            }
+        }
+        catch (Base::Exception&) {
+            return false;
+        }
+        catch (std::exception&) {
+            return false;
+        }
+
+        // the constants of the folded code are the last ones added
+        std::size_t constants = 0;
+        for (std::size_t i = begin; i < result.program.size(); ++i) {
+            if (result.program[i].code == OpCode::Constant) {
+                ++constants;
+            }
+        }
+        result.constants.resize(result.constants.size() - constants);
+        result.program.resize(begin);
+        depth = depthBefore;
+        addConstant(stack.back(), info);
+        return true;
+    }
+
+    bool compileConstant(const Expression* expr, Info& info)
+    {
+        Value value;
+        Base::PyGILStateLocker lock;
+        try {
+            Py::Object pyobj = expr->getPyValue();
+            PyObject* obj = pyobj.ptr();
+            if (PyObject_TypeCheck(obj, &Base::QuantityPy::Type)) {
+                setQuantity(value, *static_cast<Base::QuantityPy*>(obj)->getQuantityPtr());
+            }
+            else if (PyBool_Check(obj)) {
+                setBoolean(value, obj == Py_True);
+            }
+            else if (PyLong_Check(obj)) {
+                long l = PyLong_AsLong(obj);
+                if (l == -1 && PyErr_Occurred()) {
+                    PyErr_Clear();
+                    return false;
+                }
+                setInteger(value, l);
+            }
+            else if (PyFloat_Check(obj)) {
+                setFloat(value, PyFloat_AsDouble(obj));
+            }
+            else {
+                return false;
+            }
+        }
+        catch (Base::Exception&) {
+            return false;
+        }
+        catch (Py::Exception&) {
+            PyErr_Clear();
+            return false;
+        }
+        addConstant(value, info);
+        return true;
+    }
+
+    bool compileVariable(const VariableExpression* expr, Info& info)
+    {
+        const ObjectIdentifier path = expr->getPath();
+        if (!path.getSubObjectName().empty() || path.numSubComponents() != 1) {
+            return false;
+        }
+
+        result.dependencies.add(path.getDocument());
+        int ptype = 0;
+        const Property* prop = path.getProperty(&ptype);
+        // anything but a plain property is a pseudo property, e.g. _shape
+        if (!prop || ptype != 0) {
+            return false;
+        }
+        if (auto obj = dynamic_cast<const DocumentObject*>(prop->getContainer())) {
+            result.dependencies.add(obj->getDocument());
+        }
+
+        Value::Type type {};
+        if (prop->isDerivedFrom<PropertyQuantity>()) {
+            type = Value::Quantity;
+        }
+        else if (prop->isDerivedFrom<PropertyFloat>()) {
+            type = Value::Float;
+        }
+        else if (prop->isDerivedFrom<PropertyInteger>()) {
+            type = Value::Integer;
+        }
+        else if (prop->isDerivedFrom<PropertyBool>()) {
+            type = Value::Boolean;
+        }
+        else {
+            return false;
+        }
+
+        emit(OpCode::Property, type, static_cast<int>(result.properties.size()));
+        result.properties.push_back(prop);
+        push();
+
+        info = Info();
+        info.typeKnown = true;
+        info.type = type;
+        // the unit of a quantity property may change
+        info.unitKnown = type != Value::Quantity;
+        return true;
+    }
+
+    bool compileOperator(const OperatorExpression* expr, Info& info)
+    {
+        int op = expr->getOperator();
+        std::size_t begin = result.program.size();
+        std::size_t depthBefore = depth;
+
+        Info left;
+        if (!compile(expr->getLeft(), left)) {
+            return false;
+        }
+
+        if (op == OperatorExpression::NEG || op == OperatorExpression::POS) {
+            emit(OpCode::Unary, op);
+            info = left;
+            info.constant = false;
+            if (info.typeKnown && info.type == Value::Boolean) {
+                info.type = Value::Integer;
+            }
+            return left.constant ? fold(begin, depthBefore, info) : true;
+        }
+
+        Info right;
+        if (!compile(expr->getRight(), right)) {
+            return false;
+        }
+        emit(OpCode::Binary, op);
+        --depth;
+
+        if (!inferOperator(op, left, right, info)) {
+            return false;
+        }
+        return left.constant && right.constant ? fold(begin, depthBefore, info) : true;
+    }
+
+    bool compileConditional(const ConditionalExpression* expr, Info& info)
+    {
+        Info condition;
+        if (!compile(expr->getCondition(), condition)) {
+            return false;
+        }
+        if (condition.constant) {
+            bool taken = isTrue(result.constants.back());
+            result.constants.pop_back();
+            result.program.pop_back();
+            --depth;
+            return compile(taken ? expr->getTrueExpr() : expr->getFalseExpr(), info);
+        }
+
+        std::size_t jumpIfFalse = result.program.size();
+        emit(OpCode::JumpIfFalse);
+        --depth;
+
+        Info trueInfo;
+        if (!compile(expr->getTrueExpr(), trueInfo)) {
+            return false;
+        }
+        std::size_t jump = result.program.size();
+        emit(OpCode::Jump);
+        --depth;
+
+        result.program[jumpIfFalse].operand = static_cast<int>(result.program.size());
+        Info falseInfo;
+        if (!compile(expr->getFalseExpr(), falseInfo)) {
+            return false;
+        }
+        result.program[jump].operand = static_cast<int>(result.program.size());
+
+        info = Info();
+        info.typeKnown =
+            trueInfo.typeKnown && falseInfo.typeKnown && trueInfo.type == falseInfo.type;
+        info.type = trueInfo.type;
+        info.unitKnown =
+            trueInfo.unitKnown && falseInfo.unitKnown && trueInfo.unit == falseInfo.unit;
+        info.unit = trueInfo.unit;
+        return true;
+    }
+
+    bool compileFunction(const FunctionExpression* expr, Info& info)
+    {
+        int f = expr->getFunction();
+        const auto& args = expr->getArgs();
+        if (f == FunctionExpression::HIDDENREF || f == FunctionExpression::HREF) {
+            return args.size() == 1 && compile(args[0], info);
+        }
+
+        int count = getArgumentCount(f, args.size());
+        if (count == 0) {
+            return false;
+        }
+
+        std::size_t begin = result.program.size();
+        std::size_t depthBefore = depth;
+        std::vector<Info> infos(count);
+        bool constant = true;
+        for (int i = 0; i < count; ++i) {
+            if (!compile(args[i], infos[i])) {
+                return false;
+            }
+            constant = constant && infos[i].constant;
+        }
+        emit(OpCode::Function, f, count);
+        depth -= count - 1;
+
+        if (!inferFunction(f, infos, info)) {
+            return false;
+        }
+        return constant ? fold(begin, depthBefore, info) : true;
+    }
+
+    static bool differ(const Info& a, const Info& b)
+    {
+        return a.unitKnown && b.unitKnown && a.unit != b.unit;
+    }
+
+    /// Derives the result of an operator, false if it always fails
+    static bool inferOperator(int op, const Info& a, const Info& b, Info& info)
+    {
+        info = Info();
+        bool quantity = a.isQuantity() || b.isQuantity();
+        bool numbers = a.isNumber() && b.isNumber();
+        bool integral =
+            numbers && a.type != Value::Float && b.type != Value::Float;
+
+        if (isComparison(op)) {
+            if (op != OperatorExpression::EQ && op != OperatorExpression::NEQ
+                && a.isQuantity() && b.isQuantity() && differ(a, b)) {
+                return false;
+            }
+            info.typeKnown = true;
+            info.type = Value::Boolean;
+            info.unitKnown = true;
+            return true;
+        }
+
+        switch (op) {
+            case OperatorExpression::ADD:
+            case OperatorExpression::SUB:
+                if (quantity && differ(a, b)) {
+                    return false;
+                }
+                info.unitKnown = a.unitKnown || b.unitKnown;
+                info.unit = a.unitKnown ? a.unit : b.unit;
+                break;
+            case OperatorExpression::MUL:
+            case OperatorExpression::UNIT:
+            case OperatorExpression::DIV:
+                if (a.unitKnown && b.unitKnown) {
+                    try {
+                        info.unit = op == OperatorExpression::DIV ? a.unit / b.unit
+                                                                  : a.unit * b.unit;
+                    }
+                    catch (Base::Exception&) {
+                        return false;
+                    }
+                    info.unitKnown = true;
+                }
+                break;
+            case OperatorExpression::MOD:
+                if (b.isQuantity() && a.isNumber()) {
+                    return false;
+                }
+                info.unitKnown = a.unitKnown;
+                info.unit = a.unit;
+                break;
+            case OperatorExpression::POW:
+                if (b.isQuantity() && a.isNumber()) {
+                    return false;
+                }
+                if (a.isQuantity() && b.isQuantity() && b.unitKnown && !b.unit.isEmpty()) {
+                    return false;
+                }
+                info.unitKnown = numbers;
+                break;
+            default:
+                return false;
+        }
+
+        if (quantity) {
+            info.typeKnown = true;
+            info.type = Value::Quantity;
+        }
+        else if (numbers) {
+            // int ** int depends on the sign of the exponent
+            info.typeKnown = !integral || op != OperatorExpression::POW;
+            info.type = integral && op != OperatorExpression::DIV ? Value::Integer : Value::Float;
+            info.unitKnown = true;
+            info.unit = Base::Unit();
+        }
+        return true;
+    }
+
+    /// Derives the result of a math function, false if it always fails
+    static bool inferFunction(int f, const std::vector<Info>& args, Info& info)
+    {
+        info = Info();
+        info.typeKnown = true;
+        info.type = Value::Quantity;
+        info.unitKnown = true;
+
+        const Info& a = args[0];
+        auto hasUnit = [](const Info& arg) {
+            return arg.unitKnown && !arg.unit.isEmpty();
+        };
+
+        try {
+            switch (f) {
+                case FunctionExpression::COS:
+                case FunctionExpression::SIN:
+                case FunctionExpression::TAN:
+                    if (hasUnit(a) && a.unit != Base::Unit::Angle) {
+                        return false;
+                    }
+                    break;
+                case FunctionExpression::ACOS:
+                case FunctionExpression::ASIN:
+                case FunctionExpression::ATAN:
+                    if (hasUnit(a)) {
+                        return false;
+                    }
+                    info.unit = Base::Unit::Angle;
+                    break;
+                case FunctionExpression::EXP:
+                case FunctionExpression::LOG:
+                case FunctionExpression::LOG10:
+                case FunctionExpression::SINH:
+                case FunctionExpression::TANH:
+                case FunctionExpression::COSH:
+                    if (hasUnit(a)) {
+                        return false;
+                    }
+                    break;
+                case FunctionExpression::SQRT:
+                case FunctionExpression::CBRT:
+                    info.unitKnown = a.unitKnown;
+                    if (a.unitKnown) {
+                        info.unit = f == FunctionExpression::SQRT ? a.unit.sqrt() : a.unit.cbrt();
+                    }
+                    break;
+                case FunctionExpression::ATAN2:
+                    if (differ(a, args[1])) {
+                        return false;
+                    }
+                    info.unit = Base::Unit::Angle;
+                    break;
+                case FunctionExpression::MOD:
+                    if (differ(a, args[1]) && hasUnit(a) && hasUnit(args[1])) {
+                        return false;
+                    }
+                    info.unitKnown = a.unitKnown;
+                    info.unit = a.unit;
+                    break;
+                case FunctionExpression::POW:
+                    if (hasUnit(args[1])) {
+                        return false;
+                    }
+                    info.unitKnown = a.unitKnown && a.unit.isEmpty();
+                    break;
+                case FunctionExpression::HYPOT:
+                case FunctionExpression::CATH:
+                    if (differ(a, args[1]) || (args.size() > 2 && differ(args[1], args[2]))) {
+                        return false;
+                    }
+                    info.unitKnown = a.unitKnown;
+                    info.unit = a.unit;
+                    break;
+                default:
+                    info.unitKnown = a.unitKnown;
+                    info.unit = a.unit;
+                    break;
+            }
+        }
+        catch (Base::Exception&) {
+            return false;
+        }
+        return true;
+    }
+
+private:
+    CompiledExpression& result;
+    std::size_t depth {0};
+};
+
+}  // namespace App
+
+bool CompiledExpression::isEnabled()
+{
+    return params()->enabled;
+}
+
+void CompiledExpression::invalidate()
+{
+    ++*DocumentsCounter;
+}
+
+void CompiledExpression::invalidate(const DocumentObject* obj)
+{
+    if (!obj || !obj->getDocument()) {
+        invalidate();
+        return;
+    }
+    invalidate(obj->getDocument());
+}
+
+void CompiledExpression::invalidate(const Document* doc)
+{
+    bumpCounter(doc);
+}
+
+void CompiledExpression::Dependencies::add(const Document* doc)
+{
+    Counter counter = getCounter(doc);
+    for (const auto& entry : counters) {
+        if (entry.first == counter) {
+            return;
+        }
+    }
+    counters.emplace_back(counter, counter->load());
+}
+
+bool CompiledExpression::Dependencies::isOutdated() const
+{
+    for (const auto& entry : counters) {
+        if (entry.first->load() != entry.second) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::unique_ptr<CompiledExpression> CompiledExpression::compile(const Expression* expr,
+                                                                Dependencies* deps)
+{
+    static const bool connected = connectSignals();
+    (void)connected;
+
+    if (deps) {
+        *deps = Dependencies();
+    }
+    if (!expr || !expr->getOwner()) {
+        return {};
+    }
+
+    std::unique_ptr<CompiledExpression> compiled(new CompiledExpression);
+    // unqualified references are looked up in the document of the owner
+    compiled->dependencies.add(expr->getOwner()->getDocument());
+    ExpressionCompiler compiler(*compiled);
+    ExpressionCompiler::Info info;
+    bool ok = false;
+    try {
+        ok = compiler.compile(expr, info);
+    }
+    catch (Base::Exception& e) {
+        FC_LOG("Cannot compile " << expr->toString() << ": " << e.what());
+    }
+    catch (std::exception& e) {
+        FC_LOG("Cannot compile " << expr->toString() << ": " << e.what());
+    }
+    if (deps) {
+        *deps = compiled->dependencies;
+    }
+    if (!ok) {
+        return {};
+    }
+    return compiled;
+}
+
+bool CompiledExpression::run(std::size_t begin, std::size_t end, std::vector<Value>& stack) const
+{
+    for (std::size_t pc = begin; pc < end;) {
+        const Instruction& inst = program[pc++];
+        switch (inst.code) {
+            case OpCode::Constant:
+                stack.push_back(constants[inst.operand]);
+                break;
+            case OpCode::Property: {
+                const Property* prop = properties[inst.operand];
+                Value& value = stack.emplace_back();
+                value.type = static_cast<Value::Type>(inst.operation);
+                switch (value.type) {
+                    case Value::Quantity:
+                        setQuantity(value,
+                                    static_cast<const PropertyQuantity*>(prop)->getQuantityValue());
+                        break;
+                    case Value::Float:
+                        value.number = static_cast<const PropertyFloat*>(prop)->getValue();
+                        break;
+                    case Value::Integer:
+                        value.integer = static_cast<const PropertyInteger*>(prop)->getValue();
+                        break;
+                    case Value::Boolean:
+                        value.integer = static_cast<const PropertyBool*>(prop)->getValue() ? 1 : 0;
+                        break;
+                }
+                break;
+            }
+            case OpCode::Unary:
+                if (!unaryOperator(inst.operation, stack.back())) {
+                    return false;
+                }
+                break;
+            case OpCode::Binary: {
+                Value right = stack.back();
+                stack.pop_back();
+                Value res;
+                if (!binaryOperator(inst.operation, stack.back(), right, res)) {
+                    return false;
+                }
+                stack.back() = res;
+                break;
+            }
+            case OpCode::Function: {
+                Value res;
+                if (!callFunction(inst.operation,
+                                  &stack[stack.size() - inst.operand],
+                                  inst.operand,
+                                  res)) {
+                    return false;
+                }
+                stack.resize(stack.size() - inst.operand + 1);
+                stack.back() = res;
+                break;
+            }
+            case OpCode::Jump:
+                pc = inst.operand;
+                break;
+            case OpCode::JumpIfFalse: {
+                bool condition = isTrue(stack.back());
+                stack.pop_back();
+                if (!condition) {
+                    pc = inst.operand;
+                }
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+bool CompiledExpression::evaluate(Value& value) const
+{
+    std::vector<Value> stack;
+    stack.reserve(stackSize);
+    try {
+        if (!run(0, program.size(), stack) || stack.size() != 1) {
+            return false;
+        }
+    }
+    catch (Base::Exception&) {
+        return false;
+    }
+    catch (std::exception&) {
+        return false;
+    }
+    value = stack.back();
+    return true;
+}
+
+bool CompiledExpression::evaluate(App::any& value) const
+{
+    Value result;
+    if (!evaluate(result)) {
+        return false;
+    }
+    switch (result.type) {
+        case Value::Integer:
+        case Value::Boolean:
+            value = App::any(result.integer);
+            break;
+        case Value::Float:
+            value = App::any(result.number);
+            break;
+        case Value::Quantity:
+            value = App::any(result.toQuantity());
+            break;
+    }
+    return true;
+}
+
+const CompiledExpression* CompiledExpressionCache::get(const Expression* expr)
+{
+    if (!expr) {
+        clear();
+        return nullptr;
+    }
+    if (expr->getId() != expressionId || dependencies.isOutdated()) {
+        expressionId = expr->getId();
+        program = CompiledExpression::compile(expr, &dependencies);
+    }
+    return program.get();
+}
+
+void CompiledExpressionCache::clear()
+{
+    program.reset();
+    dependencies = CompiledExpression::Dependencies();
+    expressionId = 0;
+}
@@ -0,0 +1,210 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+
+#ifndef APP_EXPRESSIONCOMPILER_H
+#define APP_EXPRESSIONCOMPILER_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <Base/Quantity.h>
+#include <Base/Unit.h>
+#include <FCGlobal.h>
+
+#include "ObjectIdentifier.h"
+
+namespace App
+{
+
+class Document;
+class DocumentObject;
+class Expression;
+class Property;
+
+/*!
+ * \brief The CompiledExpression class
+ * Flat stack program evaluating the numeric subset of an expression tree
+ * without going through Python.
+ *
+ * Numbers, units, the arithmetic and comparison operators, conditionals, the
+ * math functions and references to integer, float, boolean and quantity
+ * properties are compiled. Property references are resolved once, constant
+ * sub-expressions are folded and unit mismatches that are already known at
+ * compile time reject the expression. Anything else, e.g. strings, ranges,
+ * sub-object paths or Python objects, is left to the interpreter.
+ *
+ * The program produces exactly the values of Expression::getPyValue(). In
+ * all cases where the interpreter would raise an error (unit mismatch,
+ * division by zero, integer overflow...) evaluate() returns false and the
+ * caller is expected to evaluate the expression tree instead, so that error
+ * messages stay the same.
+ *
+ * Resolved properties are only valid as long as no object, property or
+ * label changes in the documents they were resolved in. Each document has a
+ * generation counter that is bumped on such changes and a program is outdated
+ * as soon as one of the counters it depends on has changed. References whose
+ * document can't be resolved depend on the documents being added or renamed.
+ */
+class AppExport CompiledExpression
+{
+public:
+    /// Result of a compiled program, mirrors the Python type of the interpreter
+    struct Value
+    {
+        enum Type : unsigned char
+        {
+            Integer,
+            Boolean,
+            Float,
+            Quantity
+        };
+        Type type {Integer};
+        long integer {0};
+        double number {0.0};
+        Base::Unit unit;
+
+        bool isIntegral() const
+        {
+            return type == Integer || type == Boolean;
+        }
+        double toDouble() const
+        {
+            return isIntegral() ? static_cast<double>(integer) : number;
+        }
+        Base::Quantity toQuantity() const
+        {
+            return type == Quantity ? Base::Quantity(number, unit) : Base::Quantity(toDouble());
+        }
+    };
+
+    enum class OpCode : unsigned char
+    {
+        Constant,
+        Property,
+        Unary,
+        Binary,
+        Function,
+        Jump,
+        JumpIfFalse,
+    };
+
+    struct Instruction
+    {
+        OpCode code;
+        /// Operator or function of the expression tree
+        int operation;
+        /// Index of the constant or property, jump target or number of arguments
+        int operand;
+    };
+
+    /// Generations of the documents in which references were resolved
+    class AppExport Dependencies
+    {
+    public:
+        /// Depends on \a doc, or on the documents being added or renamed if it's null
+        void add(const Document* doc);
+        /// Check if the references may resolve differently now
+        bool isOutdated() const;
+
+    private:
+        std::vector<std::pair<std::shared_ptr<const std::atomic<std::size_t>>, std::size_t>>
+            counters;
+    };
+
+    /// Check if compiled evaluation is enabled in the preferences
+    static bool isEnabled();
+    /// Outdates the programs with unresolved documents, called when a document is added
+    static void invalidate();
+    /// Outdates the programs that resolved references in the document of \a obj
+    static void invalidate(const DocumentObject* obj);
+    /// Outdates the programs that resolved references in \a doc
+    static void invalidate(const Document* doc);
+
+    /*!
+     * \brief compile
+     * Compiles the expression.
+     * \param deps Receives the dependencies, even if the expression is rejected
+     * \return null if the expression isn't fully supported
+     */
+    static std::unique_ptr<CompiledExpression> compile(const Expression* expr,
+                                                       Dependencies* deps = nullptr);
+
+    /// Check if the references of the program may have changed
+    bool isOutdated() const
+    {
+        return dependencies.isOutdated();
+    }
+
+    /*!
+     * \brief evaluate
+     * Runs the program.
+     * \return false if the expression has to be evaluated by the interpreter
+     */
+    bool evaluate(Value& value) const;
+    /// Runs the program and converts the result like Expression::getValueAsAny()
+    bool evaluate(App::any& value) const;
+
+    /// Number of instructions after folding
+    std::size_t size() const
+    {
+        return program.size();
+    }
+
+private:
+    CompiledExpression() = default;
+    bool run(std::size_t begin, std::size_t end, std::vector<Value>& stack) const;
+
+private:
+    std::vector<Instruction> program;
+    std::vector<Value> constants;
+    std::vector<const Property*> properties;
+    std::size_t stackSize {0};
+    Dependencies dependencies;
+
+    friend class ExpressionCompiler;
+};
+
+/*!
+ * \brief The CompiledExpressionCache class
+ * Keeps the compiled program of one expression and recompiles it when the
+ * expression or its references change. The expression is identified by its
+ * id, so that a new expression at the address of a deleted one is compiled.
+ */
+class AppExport CompiledExpressionCache
+{
+public:
+    /// Returns the program of \a expr or null if it must be interpreted
+    const CompiledExpression* get(const Expression* expr);
+    void clear();
+
+private:
+    std::shared_ptr<const CompiledExpression> program;
+    /// dependencies of the program, or of the rejected expression
+    CompiledExpression::Dependencies dependencies;
+    std::size_t expressionId {0};
+};
+
+}  // namespace App
+
+#endif  // APP_EXPRESSIONCOMPILER_H
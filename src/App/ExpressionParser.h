@@ -270,6 +270,21 @@ public:
 
     int priority() const override;
 
+    Expression* getCondition() const
+    {
+        return condition;
+    }
+
+    Expression* getTrueExpr() const
+    {
+        return trueExpr;
+    }
+
+    Expression* getFalseExpr() const
+    {
+        return falseExpr;
+    }
+
 protected:
     Expression* _copy() const override;
     void _visit(ExpressionVisitor& v) override;
@@ -210,6 +210,11 @@ public:
         }
         return DocumentObject::StdReturn;
     }
+    /// the Python implementation must run on the main thread
+    bool canRecomputeConcurrently() const override
+    {
+        return false;
+    }
     const char* getViewProviderNameOverride() const override
     {
         viewProviderName = imp->getViewProviderName();
@@ -371,3 +371,56 @@ DocumentObjectExecReturn* FeatureTestAttribute::execute()
     }
     return StdReturn;
 }
+
+// ----------------------------------------------------------------------------
+
+PROPERTY_SOURCE(App::FeatureTestCache, App::DocumentObject)
+
+
+FeatureTestCache::FeatureTestCache()
+{
+    ADD_PROPERTY_TYPE(Input, (0), "Test", App::Prop_None, "");
+    ADD_PROPERTY_TYPE(Source, (nullptr), "Test", App::Prop_None, "");
+    ADD_PROPERTY_TYPE(Result, (0), "Test", App::Prop_Output, "");
+    ADD_PROPERTY_TYPE(ExecCount, (0), "Test", App::Prop_Output, "Number of executions");
+}
+
+short FeatureTestCache::mustExecute() const
+{
+    if (Input.isTouched() || Source.isTouched()) {
+        return 1;
+    }
+    return DocumentObject::mustExecute();
+}
+
+DocumentObjectExecReturn* FeatureTestCache::execute()
+{
+    long result = Input.getValue();
+    if (auto source = dynamic_cast<FeatureTestCache*>(Source.getValue())) {
+        result += source->Result.getValue();
+    }
+    Result.setValue(result);
+    ExecCount.setValue(ExecCount.getValue() + 1);
+    return StdReturn;
+}
+
+std::vector<const Property*> FeatureTestCache::getRecomputeResult() const
+{
+    return {&Result};
+}
+
+bool FeatureTestCache::saveRecomputeResult(std::ostream& stream) const
+{
+    stream << Result.getValue();
+    return true;
+}
+
+bool FeatureTestCache::restoreRecomputeResult(std::istream& stream)
+{
+    long result = 0;
+    if (!(stream >> result)) {
+        return false;
+    }
+    Result.setValue(result);
+    return true;
+}
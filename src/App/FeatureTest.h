@@ -108,6 +108,11 @@ public:
     short mustExecute() const override;
     /// recalculate the Feature
     DocumentObjectExecReturn* execute() override;
+    /// execute() only changes the own properties
+    bool canRecomputeConcurrently() const override
+    {
+        return true;
+    }
     /// returns the type name of the ViewProvider
     // Hint: Probably it makes sense to have a view provider for unittests (e.g.
     // Gui::ViewProviderTest)
@@ -218,6 +223,30 @@ public:
     App::PropertyString Attribute;
 };
 
+/// The recompute cache testing feature
+class FeatureTestCache: public DocumentObject
+{
+    PROPERTY_HEADER_WITH_OVERRIDE(App::FeatureTestCache);
+
+public:
+    FeatureTestCache();
+
+    App::PropertyInteger Input;
+    App::PropertyLink Source;
+    App::PropertyInteger Result;
+    App::PropertyInteger ExecCount;
+
+    /** @name methods override Feature */
+    //@{
+    short mustExecute() const override;
+    /// Result is the sum of Input and the Result of Source
+    DocumentObjectExecReturn* execute() override;
+    std::vector<const Property*> getRecomputeResult() const override;
+    bool saveRecomputeResult(std::ostream& stream) const override;
+    bool restoreRecomputeResult(std::istream& stream) override;
+    //@}
+};
+
 
 }  // namespace App
 
@@ -49,6 +49,8 @@
 
 #include "ProjectFile.h"
 #include "DocumentObject.h"
+#include <Base/BinaryXML.h>
+#include <Base/Exception.h>
 #include <Base/FileInfo.h>
 #include <Base/InputSource.h>
 #include <Base/Reader.h>
@@ -217,6 +219,17 @@ bool ProjectFile::loadDocument()
         return false;
     }
     std::unique_ptr<std::istream> str(project.getInputStream("Document.xml"));
+    if (str && Base::isBinaryXML(*str)) {
+        // the DOM parser needs the XML text
+        auto xml = std::make_unique<std::stringstream>();
+        try {
+            Base::convertBinaryToXML(*str, *xml);
+        }
+        catch (const Base::Exception&) {
+            return false;
+        }
+        str = std::move(xml);
+    }
     if (str) {
         std::unique_ptr<XercesDOMParser> parser(new XercesDOMParser);
         parser->setValidationScheme(XercesDOMParser::Val_Auto);
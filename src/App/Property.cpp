@@ -25,9 +25,14 @@
 
 #ifndef _PreComp_
 #include <cassert>
+#include <mutex>
+#include <unordered_map>
 #endif
 
 #include <atomic>
+#include <Base/Console.h>
+#include <Base/Exception.h>
+#include <Base/Reader.h>
 #include <Base/Tools.h>
 #include <Base/Writer.h>
 #include <CXX/Objects.hxx>
@@ -35,6 +40,9 @@
 #include "Property.h"
 #include "ObjectIdentifier.h"
 #include "PropertyContainer.h"
+#include "Document.h"
+#include "DocumentObject.h"
+#include "RecomputeProfiler.h"
 
 
 using namespace App;
@@ -57,7 +65,37 @@ Property::Property()
     : _id(++_PropID)
 {}
 
-Property::~Property() = default;
+namespace
+{
+struct DeferredFile
+{
+    std::shared_ptr<Base::DocFileArchive> archive;
+    std::string fileName;
+    bool failed {false};
+};
+
+// The deferred files are rare, so they are kept aside instead of adding a
+// member to every property.
+std::recursive_mutex& deferredFileMutex()
+{
+    static std::recursive_mutex mutex;
+    return mutex;
+}
+
+std::unordered_map<const Property*, DeferredFile>& deferredFiles()
+{
+    static std::unordered_map<const Property*, DeferredFile> files;
+    return files;
+}
+}  // namespace
+
+Property::~Property()
+{
+    if (StatusBits.test(DeferredDocFile)) {
+        std::lock_guard<std::recursive_mutex> lock(deferredFileMutex());
+        deferredFiles().erase(this);
+    }
+}
 
 const char* Property::getName() const
 {
@@ -271,6 +309,18 @@ void Property::hasSetValue()
 {
     PropertyCleaner guard(this);
     if (father) {
+        RecomputeProfiler* profiler = nullptr;
+        const DocumentObject* obj = nullptr;
+        if (RecomputeProfiler::isAnyEnabled()) {
+            obj = freecad_cast<DocumentObject>(father);
+            if (obj && obj->getDocument()) {
+                profiler = &obj->getDocument()->getRecomputeProfiler();
+            }
+        }
+        RecomputeProfiler::Scope profile(profiler,
+                                         RecomputeProfiler::Category::Change,
+                                         obj,
+                                         getName());
         father->onChanged(this);
         if (!testStatus(Busy)) {
             Base::BitsetLocker<decltype(StatusBits)> guard(StatusBits, Busy);
@@ -280,8 +330,89 @@ void Property::hasSetValue()
     StatusBits.set(Touched);
 }
 
+bool Property::deferDocFile(const std::shared_ptr<Base::DocFileArchive>& archive,
+                            const std::string& fileName)
+{
+    std::lock_guard<std::recursive_mutex> lock(deferredFileMutex());
+    deferredFiles()[this] = DeferredFile {archive, fileName};
+    StatusBits.set(DeferredDocFile);
+    return true;
+}
+
+bool Property::spillDocFile(const std::shared_ptr<Base::DocFileArchive>& archive,
+                            const std::string& fileName)
+{
+    if (StatusBits.test(DeferredDocFile) || !canSpillDocFile()) {
+        return false;
+    }
+    releaseDocFile();
+    return deferDocFile(archive, fileName);
+}
+
+void Property::_restoreDeferredDocFile() const
+{
+    // Other threads wait here until the file is restored. The entry is removed
+    // before restoring so that nested calls of the same thread return at once.
+    std::lock_guard<std::recursive_mutex> lock(deferredFileMutex());
+    auto& files = deferredFiles();
+    auto it = files.find(this);
+    if (it == files.end()) {
+        // the status may have been copied from another property
+        if (!StatusBits.test(RestoringDocFile)) {
+            const_cast<Property*>(this)->StatusBits.reset(DeferredDocFile);  // NOLINT
+        }
+        return;
+    }
+    if (it->second.failed) {
+        return;
+    }
+    DeferredFile file = std::move(it->second);
+    files.erase(it);
+
+    // The value hasn't changed from the user's point of view
+    auto self = const_cast<Property*>(this);  // NOLINT
+    bool touched = StatusBits.test(Touched);
+    bool restored {};
+    {
+        Base::BitsetLocker<decltype(StatusBits)> guard(self->StatusBits, RestoringDocFile);
+        Base::BitsetLocker<decltype(StatusBits)> guard2(self->StatusBits, NoModify);
+        restored = file.archive->restoreDocFile(file.fileName, self);
+    }
+    self->StatusBits.set(Touched, touched);
+    if (!restored) {
+        // The property stays deferred so that saving it fails instead of
+        // overwriting the data with the empty value. It isn't tried again.
+        Base::Console().Error("Failed to restore %s\n", getFullName().c_str());
+        file.failed = true;
+        files[this] = std::move(file);
+        return;
+    }
+    self->StatusBits.reset(DeferredDocFile);
+}
+
+void Property::restoreDeferredDocFileForSave() const
+{
+    restoreDeferredDocFile();
+    if (StatusBits.test(DeferredDocFile) && !StatusBits.test(RestoringDocFile)) {
+        std::string msg = "Cannot save " + getFullName() + " because its data couldn't be restored";
+        throw Base::FileException(msg.c_str());
+    }
+}
+
+void Property::dropDeferredDocFile()
+{
+    std::lock_guard<std::recursive_mutex> lock(deferredFileMutex());
+    deferredFiles().erase(this);
+    StatusBits.reset(DeferredDocFile);
+}
+
 void Property::aboutToSetValue()
 {
+    restoreDeferredDocFile();
+    if (StatusBits.test(DeferredDocFile) && !StatusBits.test(RestoringDocFile)) {
+        // the file couldn't be restored, the new value replaces it
+        dropDeferredDocFile();
+    }
     if (father) {
         father->onBeforeChange(this);
     }
@@ -316,7 +447,9 @@ void Property::setStatusValue(unsigned long status)
         |(1<<PropOutput)
         |(1<<PropHidden)
         |(1<<PropNoPersist)
-        |(1<<Busy);
+        |(1<<Busy)
+        |(1<<DeferredDocFile)
+        |(1<<RestoringDocFile);
     // clang-format on
 
     status &= ~mask;
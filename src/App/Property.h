@@ -29,6 +29,7 @@
 #include <boost/any.hpp>
 #include <boost/signals2.hpp>
 #include <bitset>
+#include <memory>
 #include <string>
 #include <FCGlobal.h>
 
@@ -86,6 +87,9 @@ public:
         CopyOnChange =
             16,  // for Link to copy the linked object on change of the property with this flag
         UserEdit = 17,  // cause property editor to create button for user defined editing
+        DeferredDocFile = 18,   // the file of the property is restored on first access
+        RestoringDocFile = 19,  // set while a deferred file is restored, the change is neither
+                                // recorded for undo nor does it touch the owner
 
         // The following bits are corresponding to PropertyType set when the
         // property added. These types are meant to be static, and cannot be
@@ -238,6 +242,11 @@ public:
     {
         return StatusBits.to_ulong();
     }
+    /// return the status bits that are saved, i.e. without the runtime-only ones
+    inline unsigned long getPersistentStatus() const
+    {
+        return StatusBits.to_ulong() & ~((1UL << DeferredDocFile) | (1UL << RestoringDocFile));
+    }
     inline bool testStatus(Status pos) const
     {
         return StatusBits.test(static_cast<size_t>(pos));
@@ -294,6 +303,32 @@ public:
     virtual void beforeSave() const
     {}
 
+    /** @name Spilling
+     * Undo/redo snapshots with large payloads can be moved to a file to bound
+     * the memory of the undo stack. The payload is written with SaveDocFile()
+     * and restored like a deferred file on first access.
+     */
+    //@{
+    /// Check if the payload of the property can be spilled to a file
+    virtual bool canSpillDocFile() const
+    {
+        return false;
+    }
+    /** Check if the payload is shared with another property, e.g. by a copy
+     * that is only detached on change. Such a payload is neither accounted to
+     * the undo memory nor spilled, because that wouldn't free it.
+     */
+    virtual bool isPayloadShared() const
+    {
+        return false;
+    }
+    /** Releases the payload, it's restored from \a fileName of \a archive when
+     * the value is accessed. Returns false if the property cannot be spilled.
+     */
+    bool spillDocFile(const std::shared_ptr<Base::DocFileArchive>& archive,
+                      const std::string& fileName);
+    //@}
+
     friend class PropertyContainer;
     friend struct PropertyData;
     friend class DynamicProperty;
@@ -322,6 +357,35 @@ protected:
     /// Return a file name suitable for saving this property
     std::string getFileName(const char* postfix = 0, const char* prefix = 0) const;
 
+    /** @name Lazy restore
+     * Properties with large payloads can restore their file on demand. They
+     * override deferRestoreDocFile() to call deferDocFile() and call
+     * restoreDeferredDocFile() in every method that reads their value. Methods
+     * that change the value call it through aboutToSetValue().
+     */
+    //@{
+    /// Keeps the archive and the file name until the value is accessed
+    bool deferDocFile(const std::shared_ptr<Base::DocFileArchive>& archive,
+                      const std::string& fileName);
+    /// Restores the deferred file, if any
+    void restoreDeferredDocFile() const
+    {
+        if (StatusBits.test(DeferredDocFile)) {
+            _restoreDeferredDocFile();
+        }
+    }
+    /** Restores the deferred file before the value is saved. Throws a
+     * Base::FileException if the file can't be restored because saving the
+     * empty value would lose the data of the file.
+     */
+    void restoreDeferredDocFileForSave() const;
+    /** Frees the payload before the property gets spilled. The value must be
+     * changed silently, i.e. without calling aboutToSetValue() and hasSetValue().
+     */
+    virtual void releaseDocFile()
+    {}
+    //@}
+
 public:
     // forbidden
     Property(const Property&) = delete;
@@ -330,6 +394,8 @@ public:
 private:
     // Sync status with Property_Type
     void syncType(unsigned type);
+    void _restoreDeferredDocFile() const;
+    void dropDeferredDocFile();
 
 private:
     PropertyContainer* father {nullptr};
@@ -253,26 +253,32 @@ void PropertyContainer::Save (Base::Writer &writer) const
     std::map<std::string,Property*> Map;
     getPropertyMap(Map);
 
+    std::vector<Property*> props;
+    props.reserve(Map.size());
+    for(const auto& it : Map) {
+        if(!it.second->testStatus(Property::PropNoPersist))
+            props.push_back(it.second);
+    }
+    saveProperties(writer, props);
+}
+
+void PropertyContainer::saveProperties(Base::Writer &writer, const std::vector<Property*>& props) const
+{
     std::vector<Property*> transients;
-    for(auto it=Map.begin();it!=Map.end();) {
-        auto prop = it->second;
-        if(prop->testStatus(Property::PropNoPersist)) {
-            it = Map.erase(it);
-            continue;
-        }
+    std::vector<Property*> persistents;
+    for(auto prop : props) {
         if(!prop->testStatus(Property::PropDynamic)
                 && (prop->testStatus(Property::Transient) ||
                     getPropertyType(prop) & Prop_Transient))
         {
             transients.push_back(prop);
-            it = Map.erase(it);
         } else {
-            ++it;
+            persistents.push_back(prop);
         }
     }
 
     writer.incInd(); // indentation for 'Properties Count'
-    writer.Stream() << writer.ind() << "<Properties Count=\"" << Map.size()
+    writer.Stream() << writer.ind() << "<Properties Count=\"" << persistents.size()
                     << "\" TransientCount=\"" << transients.size() << "\">" << endl;
 
     // First store transient properties to persist their status value. We use
@@ -282,26 +288,26 @@ void PropertyContainer::Save (Base::Writer &writer) const
     for(auto prop : transients) {
         writer.Stream() << writer.ind() << "<_Property name=\"" << prop->getName()
             << "\" type=\"" << prop->getTypeId().getName()
-            << "\" status=\"" << prop->getStatus() << "\"/>" << std::endl;
+            << "\" status=\"" << prop->getPersistentStatus() << "\"/>" << std::endl;
     }
     writer.decInd();
 
     // Now store normal properties
-    for (const auto& it : Map)
+    for (auto prop : persistents)
     {
         writer.incInd(); // indentation for 'Property name'
-        writer.Stream() << writer.ind() << "<Property name=\"" << it.first << "\" type=\""
-                        << it.second->getTypeId().getName();
+        writer.Stream() << writer.ind() << "<Property name=\"" << prop->getName() << "\" type=\""
+                        << prop->getTypeId().getName();
 
-        dynamicProps.save(it.second,writer);
+        dynamicProps.save(prop,writer);
 
-        auto status = it.second->getStatus();
+        auto status = prop->getPersistentStatus();
         if(status)
             writer.Stream() << "\" status=\"" << status;
         writer.Stream() << "\">";
 
-        if(it.second->testStatus(Property::Transient)
-                || it.second->getType() & Prop_Transient)
+        if(prop->testStatus(Property::Transient)
+                || prop->getType() & Prop_Transient)
         {
             writer.decInd();
             writer.Stream() << "</Property>" << std::endl;
@@ -316,7 +322,7 @@ void PropertyContainer::Save (Base::Writer &writer) const
             // We must make sure to handle all exceptions accordingly so that
             // the project file doesn't get invalidated. In the error case this
             // means to proceed instead of aborting the write operation.
-            it.second->Save(writer);
+            prop->Save(writer);
         }
         catch (const Base::Exception &e) {
             Base::Console().Error("%s\n", e.what());
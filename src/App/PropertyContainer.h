@@ -236,6 +236,8 @@ public:
   virtual void onPropertyStatusChanged(const Property &prop, unsigned long oldStatus);
 
   void Save (Base::Writer &writer) const override;
+  /// Save only the given properties, Restore() reads them back like a full save
+  void saveProperties(Base::Writer &writer, const std::vector<Property*>& props) const;
   void Restore(Base::XMLReader &reader) override;
   virtual void beforeSave() const;
 
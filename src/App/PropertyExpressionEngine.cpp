@@ -26,6 +26,7 @@
 #include <App/Document.h>
 #include <App/DocumentObject.h>
 #include <App/DocumentObserver.h>
+#include <App/RecomputeProfiler.h>
 #include <Base/Reader.h>
 #include <Base/Tools.h>
 #include <Base/Writer.h>
@@ -725,6 +726,13 @@ DocumentObjectExecReturn* App::PropertyExpressionEngine::execute(ExecuteOption o
     std::vector<App::ObjectIdentifier> evaluationOrder = computeEvaluationOrder(option);
     std::vector<ObjectIdentifier>::const_iterator it = evaluationOrder.begin();
 
+    RecomputeProfiler* profiler = nullptr;
+    if (RecomputeProfiler::isAnyEnabled() && docObj->getDocument()
+        && docObj->getDocument()->getRecomputeProfiler().isEnabled()) {
+        profiler = &docObj->getDocument()->getRecomputeProfiler();
+    }
+    bool compile = CompiledExpression::isEnabled();
+
 #ifdef FC_PROPERTYEXPRESSIONENGINE_LOG
     std::clog << "Computing expressions for " << getName() << std::endl;
 #endif
@@ -750,9 +758,24 @@ DocumentObjectExecReturn* App::PropertyExpressionEngine::execute(ExecuteOption o
         App::any value;
         try {
             // Evaluate expression
-            std::shared_ptr<App::Expression> expression = expressions[*it].expression;
+            ExpressionInfo& info = expressions[*it];
+            std::shared_ptr<App::Expression> expression = info.expression;
             if (expression) {
-                value = expression->getValueAsAny();
+                {
+                    std::string path;
+                    if (profiler) {
+                        path = it->toString();
+                    }
+                    RecomputeProfiler::Scope profile(profiler,
+                                                     RecomputeProfiler::Category::Expression,
+                                                     docObj,
+                                                     path.c_str());
+                    const CompiledExpression* program =
+                        compile ? info.compiled.get(expression.get()) : nullptr;
+                    if (!program || !program->evaluate(value)) {
+                        value = expression->getValueAsAny();
+                    }
+                }
 
                 // Enable value comparison for all expression bindings to reduce
                 // unnecessary touch and recompute.
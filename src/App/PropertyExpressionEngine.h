@@ -28,6 +28,7 @@
 #include <boost/signals2.hpp>
 #include <boost_graph_adjacency_list.hpp>
 #include <boost/graph/topological_sort.hpp>
+#include <App/ExpressionCompiler.h>
 #include <App/PropertyLinks.h>
 #include <set>
 
@@ -96,6 +97,7 @@ public:
     {
         std::shared_ptr<App::Expression> expression; /**< The actual expression tree */
         bool busy;
+        CompiledExpressionCache compiled; /**< Compiled form of the expression */
 
         explicit ExpressionInfo(
             std::shared_ptr<App::Expression> expression = std::shared_ptr<App::Expression>())
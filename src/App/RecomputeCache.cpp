@@ -0,0 +1,294 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+#include <algorithm>
+#include <sstream>
+#include <vector>
+#endif
+
+#include <QCryptographicHash>
+
+#include <Base/Console.h>
+#include <Base/FileInfo.h>
+#include <Base/Stream.h>
+#include <Base/Tools.h>
+#include <Base/Writer.h>
+
+#include "RecomputeCache.h"
+#include "Application.h"
+#include "Document.h"
+#include "DocumentObject.h"
+
+
+FC_LOG_LEVEL_INIT("App", true, true)
+
+using namespace App;
+
+namespace
+{
+
+std::string hashString(const std::string& str)
+{
+    QByteArray data = QByteArray::fromRawData(str.c_str(), static_cast<int>(str.size()));
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex().toStdString();
+}
+
+/// Returns the hash of the content of a file, or an empty string if it can't be read
+std::string hashFile(const std::string& fileName)
+{
+    Base::FileInfo fi(fileName);
+    Base::ifstream file(fi, std::ios::in | std::ios::binary);
+    if (!fi.isFile() || !file) {
+        return {};
+    }
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    std::vector<char> buffer(0x10000);
+    while (file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()))
+           || file.gcount() > 0) {
+        hash.addData(QByteArray::fromRawData(buffer.data(), static_cast<int>(file.gcount())));
+    }
+    return hash.result().toHex().toStdString();
+}
+
+/// Serializes the input properties, the payload files are hashed separately
+class HashWriter: public Base::Writer
+{
+public:
+    std::ostream& Stream() override
+    {
+        return stream;
+    }
+    void writeFiles() override
+    {
+        for (std::size_t index = 0; index < FileList.size(); ++index) {
+            FileList[index].Object->SaveDocFile(*this);
+        }
+        FileList.clear();
+    }
+    bool hasFiles() const
+    {
+        return !FileList.empty();
+    }
+    void clearFiles()
+    {
+        FileList.clear();
+    }
+    /// Returns the hash of the files requested so far and forgets them
+    std::string hashFiles()
+    {
+        HashWriter writer;
+        writer.FileList.swap(FileList);
+        writer.writeFiles();
+        return hashString(writer.getString());
+    }
+    std::string getString() const
+    {
+        return stream.str();
+    }
+
+private:
+    std::stringstream stream;
+};
+
+ParameterGrp::handle getParameter()
+{
+    return GetApplication().GetParameterGroupByPath(
+        "User parameter:BaseApp/Preferences/Document");
+}
+
+}  // namespace
+
+bool RecomputeCache::isEnabled()
+{
+    return getParameter()->GetBool("RecomputeCache", false);
+}
+
+std::string RecomputeCache::getCachePath()
+{
+    std::string path = getParameter()->GetASCII("RecomputeCacheDir");
+    if (path.empty()) {
+        path = Application::getUserCachePath() + "RecomputeCache";
+    }
+    if (path.back() != '/' && path.back() != PATHSEP) {
+        path += PATHSEP;
+    }
+    return path;
+}
+
+void RecomputeCache::clear()
+{
+    Base::FileInfo dir(getCachePath());
+    if (dir.isDir()) {
+        for (auto& file : dir.getDirectoryContent()) {
+            if (file.hasExtension("fcrc")) {
+                file.deleteFile();
+            }
+        }
+    }
+}
+
+void RecomputeCache::clearKeys()
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    keys.clear();
+}
+
+std::string RecomputeCache::getKey(const DocumentObject* obj)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = keys.find(obj);
+    if (it != keys.end()) {
+        return it->second;
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    auto addString = [&hash](const std::string& str) {
+        hash.addData(QByteArray::fromRawData(str.c_str(), static_cast<int>(str.size() + 1)));
+    };
+
+    // The element map of a result refers to the object ID and to string IDs
+    // of the document hasher, so a result is only valid for the same object.
+    addString(obj->getTypeId().getName());
+    addString(obj->getDocument()->Uid.getValueStr());
+    addString(std::to_string(obj->getID()));
+
+    auto results = obj->getRecomputeResult();
+    std::vector<Property*> props;
+    obj->getPropertyList(props);
+    HashWriter writer;
+    for (auto prop : props) {
+        if (prop == &obj->ExpressionEngine
+            || std::find(results.begin(), results.end(), prop) != results.end()
+            || prop->testStatus(Property::Transient) || prop->testStatus(Property::Output)
+            || prop->testStatus(Property::NoRecompute)
+            || (obj->getPropertyType(prop) & (Prop_Output | Prop_Transient | Prop_NoRecompute))) {
+            continue;
+        }
+        writer.Stream() << prop->getName() << '\n';
+        prop->Save(writer);
+        // writing the payload is expensive, so its hash is kept until the
+        // property changes
+        if (writer.hasFiles()) {
+            std::string& payload = payloads[{obj->getID(), prop->getName()}];
+            if (payload.empty()) {
+                payload = writer.hashFiles();
+            }
+            else {
+                writer.clearFiles();
+            }
+            writer.Stream() << payload << '\n';
+        }
+    }
+    // the files are read on each recompute because they may be changed outside
+    for (const auto& fileName : obj->getRecomputeInputFiles()) {
+        writer.Stream() << fileName << '\n' << hashFile(fileName) << '\n';
+    }
+    addString(writer.getString());
+
+    for (auto dep : obj->getOutList()) {
+        addString(getKey(dep));
+    }
+
+    std::string key = hash.result().toHex().toStdString();
+    keys[obj] = key;
+    return key;
+}
+
+void RecomputeCache::forget(const DocumentObject* obj, const Property* prop)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (!payloads.empty() && prop->getName()) {
+        payloads.erase({obj->getID(), prop->getName()});
+    }
+}
+
+bool RecomputeCache::restore(DocumentObject* obj)
+{
+    if (obj->getRecomputeResult().empty()) {
+        return false;
+    }
+
+    Base::FileInfo fi(getCachePath() + getKey(obj) + ".fcrc");
+    if (!fi.isReadable()) {
+        return false;
+    }
+
+    Base::ifstream file(fi, std::ios::in | std::ios::binary);
+    try {
+        // the result is set like execute() sets it, e.g. Part::Feature then
+        // keeps its placement
+        Base::ObjectStatusLocker<ObjectStatus, DocumentObject> exe(App::Recompute, obj);
+        if (obj->restoreRecomputeResult(file)) {
+            FC_LOG("Restored " << obj->getFullName() << " from recompute cache");
+            return true;
+        }
+    }
+    catch (Base::Exception& e) {
+        e.ReportException();
+    }
+    catch (std::exception& e) {
+        FC_ERR("Failed to restore " << obj->getFullName() << ": " << e.what());
+    }
+
+    // the entry is outdated or broken
+    file.close();
+    fi.deleteFile();
+    return false;
+}
+
+void RecomputeCache::save(const DocumentObject* obj)
+{
+    if (obj->getRecomputeResult().empty()) {
+        return;
+    }
+
+    std::string path = getCachePath();
+    Base::FileInfo dir(path);
+    if (!dir.exists() && !dir.createDirectories()) {
+        FC_WARN("Cannot create recompute cache directory " << path);
+        return;
+    }
+
+    // write to a temporary file first so that concurrent sessions never see
+    // a partial entry
+    std::string key = getKey(obj);
+    Base::FileInfo tmp(path + key + ".tmp");
+    bool saved = false;
+    {
+        Base::ofstream file(tmp, std::ios::out | std::ios::trunc | std::ios::binary);
+        saved = file && obj->saveRecomputeResult(file) && file.good();
+    }
+    if (!saved) {
+        tmp.deleteFile();
+        return;
+    }
+
+    Base::FileInfo fi(path + key + ".fcrc");
+    if (fi.exists()) {
+        fi.deleteFile();
+    }
+    if (!tmp.renameFile(fi.filePath().c_str())) {
+        tmp.deleteFile();
+    }
+}
@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+#ifndef APP_RECOMPUTECACHE_H
+#define APP_RECOMPUTECACHE_H
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <FCGlobal.h>
+
+namespace App
+{
+
+class DocumentObject;
+class Property;
+
+/*!
+ * \brief The RecomputeCache class
+ * Content addressed store for the results of DocumentObject::execute().
+ *
+ * The key of an object is a hash over its type, its input properties and the
+ * keys of the objects in its OutList. The payload files of the input properties
+ * are only hashed again after they have changed, the external files reported by
+ * DocumentObject::getRecomputeInputFiles() are hashed each time. Objects that report result
+ * properties with DocumentObject::getRecomputeResult() write their result into
+ * a file named after the key, and a later recompute with identical inputs
+ * restores it instead of executing again. The cache is enabled with the
+ * 'RecomputeCache' document preference, the files are kept in
+ * 'RecomputeCacheDir' which defaults to a sub-directory of the user cache path.
+ */
+class AppExport RecomputeCache
+{
+public:
+    /// Check if the cache is enabled in the preferences
+    static bool isEnabled();
+    /// Returns the directory of the cache files, including a trailing separator
+    static std::string getCachePath();
+    /// Removes all cache files
+    static void clear();
+
+    /// Forget the keys computed so far. Must be called before each recompute.
+    void clearKeys();
+    /// Returns the key of the object, computed from its current input properties
+    std::string getKey(const DocumentObject* obj);
+    /// Must be called when a property has changed to forget the hash of its payload
+    void forget(const DocumentObject* obj, const Property* prop);
+    /*!
+     * \brief restore
+     * Replaces the result of the object with the cached one.
+     * \return true if the object has been restored and mustn't be executed
+     */
+    bool restore(DocumentObject* obj);
+    /// Stores the current result of the object
+    void save(const DocumentObject* obj);
+
+private:
+    std::recursive_mutex mutex;
+    std::unordered_map<const DocumentObject*, std::string> keys;
+    /// hashes of the payload files, by object ID and property name
+    std::map<std::pair<long, std::string>, std::string> payloads;
+};
+
+}  // namespace App
+
+#endif  // APP_RECOMPUTECACHE_H
@@ -0,0 +1,196 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+#include <iomanip>
+#include <ostream>
+#endif
+
+#include "RecomputeProfiler.h"
+#include "DocumentObject.h"
+
+
+using namespace App;
+
+std::atomic<int> RecomputeProfiler::enabledCount {0};
+
+namespace
+{
+
+void writeJsonString(std::ostream& str, const std::string& value)
+{
+    str << '"';
+    for (unsigned char ch : value) {
+        switch (ch) {
+            case '"':
+                str << "\\\"";
+                break;
+            case '\\':
+                str << "\\\\";
+                break;
+            case '\n':
+                str << "\\n";
+                break;
+            case '\t':
+                str << "\\t";
+                break;
+            default:
+                if (ch < 0x20) {
+                    str << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                        << static_cast<int>(ch) << std::dec << std::setfill(' ');
+                }
+                else {
+                    str << ch;
+                }
+                break;
+        }
+    }
+    str << '"';
+}
+
+}  // namespace
+
+RecomputeProfiler::Scope::Scope(RecomputeProfiler* profiler,
+                                Category category,
+                                const DocumentObject* obj,
+                                const char* detail)
+    : profiler(profiler && profiler->isEnabled() ? profiler : nullptr)
+    , category(category)
+    , obj(obj)
+    , detail(detail)
+{
+    if (this->profiler) {
+        start = std::chrono::steady_clock::now();
+    }
+}
+
+RecomputeProfiler::Scope::~Scope()
+{
+    if (!profiler) {
+        return;
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    Entry entry;
+    entry.category = category;
+    entry.memSize = 0;
+    if (obj && obj->isAttachedToDocument()) {
+        entry.name = obj->getNameInDocument();
+        // walking the result is too expensive for the finer grained categories
+        if (category == Category::Execute) {
+            entry.memSize = obj->getMemSize();
+        }
+    }
+    if (detail && *detail) {
+        if (!entry.name.empty()) {
+            entry.name += '.';
+        }
+        entry.name += detail;
+    }
+    profiler->addEntry(std::move(entry), start, end);
+}
+
+RecomputeProfiler::~RecomputeProfiler()
+{
+    setEnabled(false);
+}
+
+void RecomputeProfiler::setEnabled(bool on)
+{
+    if (enabled.exchange(on) == on) {
+        return;
+    }
+    if (on) {
+        clear();
+        ++enabledCount;
+    }
+    else {
+        --enabledCount;
+    }
+}
+
+void RecomputeProfiler::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    threads.clear();
+    threads.emplace(std::this_thread::get_id(), 0);
+    epoch = std::chrono::steady_clock::now();
+}
+
+void RecomputeProfiler::addEntry(Entry&& entry,
+                                 std::chrono::steady_clock::time_point begin,
+                                 std::chrono::steady_clock::time_point end)
+{
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    entry.start = duration_cast<microseconds>(begin - epoch).count();
+    entry.duration = duration_cast<microseconds>(end - begin).count();
+    auto res = threads.emplace(std::this_thread::get_id(), static_cast<int>(threads.size()));
+    entry.thread = res.first->second;
+    entries.push_back(std::move(entry));
+}
+
+std::vector<RecomputeProfiler::Entry> RecomputeProfiler::getEntries() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries;
+}
+
+const char* RecomputeProfiler::getCategoryName(Category category)
+{
+    switch (category) {
+        case Category::Recompute:
+            return "Recompute";
+        case Category::Execute:
+            return "Execute";
+        case Category::Expression:
+            return "Expression";
+        case Category::Change:
+            return "Change";
+    }
+    return "";
+}
+
+void RecomputeProfiler::exportChromeTrace(std::ostream& str) const
+{
+    auto list = getEntries();
+
+    str << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto& entry : list) {
+        if (!first) {
+            str << ',';
+        }
+        first = false;
+        str << "\n{\"name\":";
+        writeJsonString(str, entry.name);
+        str << ",\"cat\":\"" << getCategoryName(entry.category) << "\",\"ph\":\"X\""
+            << ",\"ts\":" << entry.start << ",\"dur\":" << entry.duration
+            << ",\"pid\":1,\"tid\":" << entry.thread << ",\"args\":{\"memSize\":" << entry.memSize
+            << "}}";
+    }
+    str << "\n]}\n";
+}
@@ -0,0 +1,137 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+#ifndef APP_RECOMPUTEPROFILER_H
+#define APP_RECOMPUTEPROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <FCGlobal.h>
+
+namespace App
+{
+
+class DocumentObject;
+
+/*!
+ * \brief The RecomputeProfiler class
+ * Records the wall time spent in DocumentObject::execute(), in the evaluation
+ * of each bound expression and in the onChanged() cascade of the objects of a
+ * document.
+ *
+ * Unlike the Tracy macros of Base/Profiler.h the profiler is always compiled
+ * in. It is switched on per document and costs a single atomic load when it is
+ * off. The recorded entries can be queried or written as a Chrome trace file
+ * that can be opened with chrome://tracing, Perfetto or speedscope.
+ */
+class AppExport RecomputeProfiler
+{
+public:
+    enum class Category
+    {
+        Recompute,
+        Execute,
+        Expression,
+        Change,
+    };
+
+    struct Entry
+    {
+        std::string name;
+        Category category;
+        /// Start time in microseconds since the profiler was enabled
+        std::int64_t start;
+        /// Duration in microseconds
+        std::int64_t duration;
+        /// Memory size of the object after execute(), 0 for the other categories
+        std::size_t memSize;
+        /// Index of the thread, 0 is the thread that enabled the profiler
+        int thread;
+    };
+
+    /// Measures the lifetime of the scope if the profiler is enabled
+    class AppExport Scope
+    {
+    public:
+        Scope(RecomputeProfiler* profiler,
+              Category category,
+              const DocumentObject* obj,
+              const char* detail = nullptr);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        RecomputeProfiler* profiler;
+        Category category;
+        const DocumentObject* obj;
+        const char* detail;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    RecomputeProfiler() = default;
+    ~RecomputeProfiler();
+
+    /// Enabling the profiler discards the previously recorded entries
+    void setEnabled(bool on);
+    bool isEnabled() const
+    {
+        return enabled.load(std::memory_order_relaxed);
+    }
+    /// Check if the profiler of any document is enabled
+    static bool isAnyEnabled()
+    {
+        return enabledCount.load(std::memory_order_relaxed) > 0;
+    }
+
+    void clear();
+    std::vector<Entry> getEntries() const;
+    /// Writes the entries in the Chrome trace event format
+    void exportChromeTrace(std::ostream& str) const;
+
+    static const char* getCategoryName(Category category);
+
+private:
+    void addEntry(Entry&& entry,
+                  std::chrono::steady_clock::time_point begin,
+                  std::chrono::steady_clock::time_point end);
+
+private:
+    mutable std::mutex mutex;
+    std::vector<Entry> entries;
+    std::map<std::thread::id, int> threads;
+    std::chrono::steady_clock::time_point epoch;
+    std::atomic<bool> enabled {false};
+
+    static std::atomic<int> enabledCount;
+};
+
+}  // namespace App
+
+#endif  // APP_RECOMPUTEPROFILER_H
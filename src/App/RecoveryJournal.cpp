@@ -0,0 +1,469 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+#include <array>
+#include <sstream>
+#include <vector>
+#endif
+
+#include <Base/Console.h>
+#include <Base/Exception.h>
+#include <Base/FileInfo.h>
+#include <Base/Reader.h>
+#include <Base/Stream.h>
+#include <Base/Tools.h>
+#include <Base/Writer.h>
+#include <zipios++/zipios-config.h>
+#include <zipios++/zipinputstream.h>
+
+#include "RecoveryJournal.h"
+#include "Application.h"
+#include "Document.h"
+#include "DocumentObject.h"
+
+
+FC_LOG_LEVEL_INIT("App", true, true)
+
+using namespace App;
+namespace sp = std::placeholders;
+
+namespace
+{
+
+/// Every record is prefixed with its size as 32 bit little endian value
+constexpr std::size_t RecordHeaderSize = 4;
+
+const DocumentObject* getOwner(const Property& prop, const Document* doc)
+{
+    auto obj = freecad_cast<DocumentObject>(prop.getContainer());
+    if (!obj || obj->getDocument() != doc || !obj->isAttachedToDocument()) {
+        return nullptr;
+    }
+    return obj;
+}
+
+}  // namespace
+
+RecoveryJournal::RecoveryJournal(const Document* doc, std::string fileName)
+    : doc(doc)
+    , fileName(std::move(fileName))
+{
+    auto document = const_cast<Document*>(doc);
+    // NOLINTBEGIN
+    connectNewObject =
+        document->signalNewObject.connect(std::bind(&RecoveryJournal::slotNewObject, this, sp::_1));
+    connectDeletedObject = document->signalDeletedObject.connect(
+        std::bind(&RecoveryJournal::slotDeletedObject, this, sp::_1));
+    connectChangedObject = document->signalChangedObject.connect(
+        std::bind(&RecoveryJournal::slotChangedObject, this, sp::_1, sp::_2));
+    connectAppendDynamicProperty = GetApplication().signalAppendDynamicProperty.connect(
+        std::bind(&RecoveryJournal::slotChangeDynamicProperty, this, sp::_1));
+    connectRemoveDynamicProperty = GetApplication().signalRemoveDynamicProperty.connect(
+        std::bind(&RecoveryJournal::slotRemoveDynamicProperty, this, sp::_1));
+    // NOLINTEND
+}
+
+RecoveryJournal::~RecoveryJournal() = default;
+
+void RecoveryJournal::slotNewObject(const DocumentObject& obj)
+{
+    // a new object is always saved completely
+    std::string name = obj.getNameInDocument();
+    newObjects.insert(name);
+    changedProperties.erase(name);
+    removedProperties.erase(name);
+}
+
+void RecoveryJournal::slotDeletedObject(const DocumentObject& obj)
+{
+    std::string name = obj.getNameInDocument();
+    // an object that doesn't exist in the checkpoint needn't to be removed
+    if (newObjects.erase(name) == 0) {
+        removedObjects.insert(name);
+    }
+    changedProperties.erase(name);
+    removedProperties.erase(name);
+}
+
+void RecoveryJournal::slotChangedObject(const DocumentObject& obj, const Property& prop)
+{
+    if (!obj.isAttachedToDocument() || !prop.getName()) {
+        return;
+    }
+    std::string name = obj.getNameInDocument();
+    if (newObjects.find(name) == newObjects.end()) {
+        changedProperties[name].insert(prop.getName());
+    }
+}
+
+void RecoveryJournal::slotChangeDynamicProperty(const Property& prop)
+{
+    if (auto obj = getOwner(prop, doc)) {
+        slotChangedObject(*obj, prop);
+    }
+}
+
+void RecoveryJournal::slotRemoveDynamicProperty(const Property& prop)
+{
+    auto obj = getOwner(prop, doc);
+    if (!obj || !prop.getName()) {
+        return;
+    }
+    std::string name = obj->getNameInDocument();
+    if (newObjects.find(name) == newObjects.end()) {
+        changedProperties[name].erase(prop.getName());
+        removedProperties[name].insert(prop.getName());
+    }
+}
+
+bool RecoveryJournal::hasChanges() const
+{
+    return !newObjects.empty() || !removedObjects.empty() || !changedProperties.empty()
+        || !removedProperties.empty();
+}
+
+std::uintmax_t RecoveryJournal::size() const
+{
+    Base::FileInfo fi(fileName);
+    return fi.exists() ? fi.size() : 0;
+}
+
+void RecoveryJournal::reset()
+{
+    newObjects.clear();
+    removedObjects.clear();
+    changedProperties.clear();
+    removedProperties.clear();
+
+    Base::FileInfo fi(fileName);
+    if (fi.exists()) {
+        fi.deleteFile();
+    }
+}
+
+bool RecoveryJournal::append()
+{
+    if (!hasChanges()) {
+        return true;
+    }
+
+    std::ostringstream data(std::ios::out | std::ios::binary);
+    try {
+        // the archive is finished when the writer goes out of scope
+        Base::ZipWriter writer(data);
+        if (GetApplication()
+                .GetParameterGroupByPath("User parameter:BaseApp/Preferences/Document")
+                ->GetBool("SaveBinaryBrep", true)) {
+            writer.setMode("BinaryBrep");
+        }
+        writer.setLevel(1);
+        writer.putNextEntry("Journal.xml");
+        saveRecord(writer);
+        writer.writeFiles();
+        if (writer.hasErrors()) {
+            return false;
+        }
+    }
+    catch (const Base::Exception& e) {
+        e.ReportException();
+        return false;
+    }
+    catch (const std::exception& e) {
+        FC_ERR("Failed to write recovery journal " << fileName << ": " << e.what());
+        return false;
+    }
+
+    std::string record = data.str();
+    auto size = static_cast<std::uint32_t>(record.size());
+    std::array<char, RecordHeaderSize> header {};
+    for (std::size_t i = 0; i < RecordHeaderSize; ++i) {
+        header[i] = static_cast<char>((size >> (8 * i)) & 0xff);
+    }
+
+    Base::FileInfo fi(fileName);
+    Base::ofstream file(fi, std::ios::out | std::ios::app | std::ios::binary);
+    file.write(header.data(), header.size());
+    file.write(record.data(), static_cast<std::streamsize>(record.size()));
+    file.flush();
+    if (!file) {
+        FC_ERR("Failed to write recovery journal " << fileName);
+        return false;
+    }
+
+    newObjects.clear();
+    removedObjects.clear();
+    changedProperties.clear();
+    removedProperties.clear();
+    return true;
+}
+
+void RecoveryJournal::saveRecord(Base::Writer& writer) const
+{
+    std::vector<DocumentObject*> created;
+    for (const auto& name : newObjects) {
+        if (auto obj = doc->getObject(name.c_str())) {
+            created.push_back(obj);
+        }
+    }
+
+    std::vector<std::pair<DocumentObject*, std::vector<Property*>>> changed;
+    for (const auto& it : changedProperties) {
+        auto obj = doc->getObject(it.first.c_str());
+        if (!obj) {
+            continue;
+        }
+        std::vector<Property*> props;
+        for (const auto& name : it.second) {
+            auto prop = obj->getPropertyByName(name.c_str());
+            if (prop && prop->getContainer() == obj
+                && !prop->testStatus(Property::PropNoPersist)) {
+                props.push_back(prop);
+            }
+        }
+        if (!props.empty()) {
+            changed.emplace_back(obj, std::move(props));
+        }
+    }
+
+    std::size_t removedCount = 0;
+    for (const auto& it : removedProperties) {
+        removedCount += it.second.size();
+    }
+
+    writer.Stream() << "<?xml version='1.0' encoding='utf-8'?>" << std::endl
+                    << "<Journal SchemaVersion=\"1\" FileVersion=\"" << writer.getFileVersion()
+                    << "\">" << std::endl;
+    writer.incInd();  // indentation for 'RemovedObjects'
+
+    writer.Stream() << writer.ind() << "<RemovedObjects Count=\"" << removedObjects.size()
+                    << "\">" << std::endl;
+    writer.incInd();
+    for (const auto& name : removedObjects) {
+        writer.Stream() << writer.ind() << "<Object name=\"" << name << "\"/>" << std::endl;
+    }
+    writer.decInd();
+    writer.Stream() << writer.ind() << "</RemovedObjects>" << std::endl;
+
+    writer.Stream() << writer.ind() << "<RemovedProperties Count=\"" << removedCount << "\">"
+                    << std::endl;
+    writer.incInd();
+    for (const auto& it : removedProperties) {
+        for (const auto& name : it.second) {
+            writer.Stream() << writer.ind() << "<Property object=\"" << it.first << "\" name=\""
+                            << name << "\"/>" << std::endl;
+        }
+    }
+    writer.decInd();
+    writer.Stream() << writer.ind() << "</RemovedProperties>" << std::endl;
+
+    writer.Stream() << writer.ind() << "<Objects Count=\"" << created.size() << "\">"
+                    << std::endl;
+    writer.incInd();
+    for (auto obj : created) {
+        writer.Stream() << writer.ind() << "<Object type=\"" << obj->getTypeId().getName()
+                        << "\" name=\"" << obj->getNameInDocument() << "\"";
+        std::string viewType = obj->getViewProviderNameStored();
+        if (viewType != obj->getViewProviderName()) {
+            writer.Stream() << " ViewType=\"" << viewType << "\"";
+        }
+        writer.Stream() << "/>" << std::endl;
+    }
+    writer.decInd();
+    writer.Stream() << writer.ind() << "</Objects>" << std::endl;
+
+    // The data of new objects is saved completely like in Document::writeObjects(),
+    // for all others only the changed properties are saved
+    writer.Stream() << writer.ind() << "<ObjectData Count=\"" << created.size() + changed.size()
+                    << "\">" << std::endl;
+    writer.incInd();  // indentation for 'Object name'
+    for (auto obj : created) {
+        obj->beforeSave();
+        writer.Stream() << writer.ind() << "<Object name=\"" << obj->getNameInDocument() << "\"";
+        if (obj->hasExtensions()) {
+            writer.Stream() << " Extensions=\"True\"";
+        }
+        writer.Stream() << ">" << std::endl;
+        obj->Save(writer);
+        writer.Stream() << writer.ind() << "</Object>" << std::endl;
+    }
+    for (auto& it : changed) {
+        for (auto prop : it.second) {
+            prop->beforeSave();
+        }
+        writer.Stream() << writer.ind() << "<Object name=\"" << it.first->getNameInDocument()
+                        << "\" Partial=\"1\">" << std::endl;
+        writer.ObjectName = it.first->getNameInDocument();
+        it.first->saveProperties(writer, it.second);
+        writer.Stream() << writer.ind() << "</Object>" << std::endl;
+    }
+    writer.decInd();  // indentation for 'Object name'
+    writer.Stream() << writer.ind() << "</ObjectData>" << std::endl;
+
+    writer.decInd();
+    writer.Stream() << "</Journal>" << std::endl;
+}
+
+std::vector<DocumentObject*> RecoveryJournal::restoreRecord(Document* doc,
+                                                            Base::XMLReader& reader)
+{
+    reader.readElement("Journal");
+    if (reader.hasAttribute("FileVersion")) {
+        reader.FileVersion = reader.getAttributeAsUnsigned("FileVersion");
+    }
+
+    reader.readElement("RemovedObjects");
+    int count = reader.getAttributeAsInteger("Count");
+    for (int i = 0; i < count; ++i) {
+        reader.readElement("Object");
+        std::string name = reader.getAttribute("name");
+        if (doc->getObject(name.c_str())) {
+            doc->removeObject(name.c_str());
+        }
+    }
+    reader.readEndElement("RemovedObjects");
+
+    reader.readElement("RemovedProperties");
+    count = reader.getAttributeAsInteger("Count");
+    for (int i = 0; i < count; ++i) {
+        reader.readElement("Property");
+        auto obj = doc->getObject(reader.getAttribute("object"));
+        const char* name = reader.getAttribute("name");
+        if (obj && obj->getDynamicPropertyByName(name)) {
+            obj->removeDynamicProperty(name);
+        }
+    }
+    reader.readEndElement("RemovedProperties");
+
+    reader.readElement("Objects");
+    count = reader.getAttributeAsInteger("Count");
+    for (int i = 0; i < count; ++i) {
+        reader.readElement("Object");
+        std::string type = reader.getAttribute("type");
+        std::string name = reader.getAttribute("name");
+        std::string viewType =
+            reader.hasAttribute("ViewType") ? reader.getAttribute("ViewType") : "";
+        try {
+            auto obj = doc->addObject(type.c_str(), name.c_str(), /*isNew=*/false, viewType.c_str());
+            if (obj) {
+                reader.addName(name.c_str(), obj->getNameInDocument());
+            }
+        }
+        catch (const Base::Exception& e) {
+            Base::Console().Error("Cannot create object '%s': (%s)\n", name.c_str(), e.what());
+        }
+    }
+    reader.readEndElement("Objects");
+
+    std::vector<DocumentObject*> objs;
+    reader.readElement("ObjectData");
+    count = reader.getAttributeAsInteger("Count");
+    for (int i = 0; i < count; ++i) {
+        reader.readElement("Object");
+        std::string name = reader.getName(reader.getAttribute("name"));
+        bool partial = reader.hasAttribute("Partial");
+        DocumentObject* obj = doc->getObject(name.c_str());
+        if (obj) {
+            obj->setStatus(ObjectStatus::Restore, true);
+            try {
+                if (partial) {
+                    // only some properties are saved, sub-classes mustn't expect
+                    // their additional elements
+                    obj->PropertyContainer::Restore(reader);
+                }
+                else {
+                    obj->Restore(reader);
+                }
+            }
+            catch (const Base::XMLParseException&) {
+                obj->setStatus(ObjectStatus::Restore, false);
+                throw;
+            }
+            catch (const Base::Exception& e) {
+                e.ReportException();
+            }
+            obj->setStatus(ObjectStatus::Restore, false);
+            objs.push_back(obj);
+        }
+        reader.readEndElement("Object");
+    }
+    reader.readEndElement("ObjectData");
+    reader.readEndElement("Journal");
+    return objs;
+}
+
+int RecoveryJournal::replay(Document* doc, const std::string& fileName)
+{
+    Base::FileInfo fi(fileName);
+    if (!fi.isReadable()) {
+        return 0;
+    }
+
+    Base::ifstream file(fi, std::ios::in | std::ios::binary);
+    Base::ObjectStatusLocker<Document::Status, Document> restoreBit(Document::Restoring, doc);
+
+    int records = 0;
+    std::string data;
+    for (;;) {
+        std::array<unsigned char, RecordHeaderSize> header {};
+        file.read(reinterpret_cast<char*>(header.data()), header.size());  // NOLINT
+        if (file.gcount() != static_cast<std::streamsize>(header.size())) {
+            break;
+        }
+        std::uint32_t size = 0;
+        for (std::size_t i = 0; i < RecordHeaderSize; ++i) {
+            size |= static_cast<std::uint32_t>(header[i]) << (8 * i);
+        }
+        data.resize(size);
+        file.read(data.data(), size);
+        if (file.gcount() != static_cast<std::streamsize>(size)) {
+            FC_WARN("Ignore incomplete record " << records << " of recovery journal " << fileName);
+            break;
+        }
+
+        try {
+            std::istringstream stream(data, std::ios::in | std::ios::binary);
+            zipios::ZipInputStream zipstream(stream);
+            Base::XMLReader reader(fileName.c_str(), zipstream);
+            if (!reader.isValid()) {
+                FC_ERR("Invalid record " << records << " in recovery journal " << fileName);
+                break;
+            }
+            auto objs = restoreRecord(doc, reader);
+            reader.readFiles(zipstream);
+            doc->afterRestore(objs);
+        }
+        catch (const Base::Exception& e) {
+            e.ReportException();
+            break;
+        }
+        catch (const std::exception& e) {
+            FC_ERR("Failed to replay recovery journal " << fileName << ": " << e.what());
+            break;
+        }
+        ++records;
+    }
+
+    return records;
+}
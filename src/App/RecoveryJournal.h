@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+
+#ifndef APP_RECOVERYJOURNAL_H
+#define APP_RECOVERYJOURNAL_H
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <boost/signals2.hpp>
+#include <FCGlobal.h>
+
+namespace Base
+{
+class Writer;
+class XMLReader;
+}  // namespace Base
+
+namespace App
+{
+
+class Document;
+class DocumentObject;
+class Property;
+
+/*!
+ * \brief The RecoveryJournal class
+ * Append-only log of the changes made to a document since its last recovery
+ * checkpoint.
+ *
+ * The journal records the names of created and removed objects and of changed
+ * properties from the document notifications. append() writes the current
+ * values of the recorded properties as one record to the end of the journal
+ * file, so that the cost of a record depends on the size of the edit and not
+ * on the size of the document. Each record is a small zip archive with the
+ * file 'Journal.xml' and the data files of the saved properties, prefixed with
+ * its size. A record that has been cut off by a crash is ignored by replay().
+ *
+ * After a full save of the document to the checkpoint file the journal must be
+ * reset(). Recovery opens the checkpoint and calls replay() with the journal.
+ */
+class AppExport RecoveryJournal
+{
+public:
+    RecoveryJournal(const Document* doc, std::string fileName);
+    ~RecoveryJournal();
+
+    RecoveryJournal(const RecoveryJournal&) = delete;
+    RecoveryJournal& operator=(const RecoveryJournal&) = delete;
+
+    const std::string& getFileName() const
+    {
+        return fileName;
+    }
+    /// Changes the journal file, e.g. when the transient directory has been renamed
+    void setFileName(const std::string& name)
+    {
+        fileName = name;
+    }
+    /// Check if there are changes that haven't been appended yet
+    bool hasChanges() const;
+    /// Returns the size of the journal file in bytes
+    std::uintmax_t size() const;
+    /// Forget all pending changes and remove the journal file
+    void reset();
+    /*!
+     * \brief append
+     * Writes the pending changes as a new record to the journal file.
+     * \return false if the record couldn't be written, the changes are kept
+     * then and the caller should fall back to a full save.
+     */
+    bool append();
+
+    /*!
+     * \brief replay
+     * Applies the records of the journal file to the document, which must have
+     * been restored from the checkpoint the journal has been started on.
+     * \return the number of applied records
+     */
+    static int replay(Document* doc, const std::string& fileName);
+
+private:
+    void slotNewObject(const DocumentObject&);
+    void slotDeletedObject(const DocumentObject&);
+    void slotChangedObject(const DocumentObject&, const Property&);
+    void slotChangeDynamicProperty(const Property&);
+    void slotRemoveDynamicProperty(const Property&);
+    void saveRecord(Base::Writer& writer) const;
+    static std::vector<DocumentObject*> restoreRecord(Document* doc, Base::XMLReader& reader);
+
+private:
+    const Document* doc;
+    std::string fileName;
+    std::set<std::string> newObjects;
+    std::set<std::string> removedObjects;
+    std::map<std::string, std::set<std::string>> changedProperties;
+    std::map<std::string, std::set<std::string>> removedProperties;
+
+    using Connection = boost::signals2::scoped_connection;
+    Connection connectNewObject;
+    Connection connectDeletedObject;
+    Connection connectChangedObject;
+    Connection connectAppendDynamicProperty;
+    Connection connectRemoveDynamicProperty;
+};
+
+}  // namespace App
+
+#endif  // APP_RECOVERYJOURNAL_H
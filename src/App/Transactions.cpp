@@ -28,9 +28,13 @@
 #include <cassert>
 #endif
 
+#include <algorithm>
 #include <atomic>
+#include <limits>
 #include <Base/Console.h>
+#include <Base/FileInfo.h>
 #include <Base/Reader.h>
+#include <Base/Stream.h>
 #include <Base/Writer.h>
 
 #include "Transactions.h"
@@ -44,6 +48,22 @@ FC_LOG_LEVEL_INIT("App", true, true)
 using namespace App;
 using namespace std;
 
+namespace
+{
+// A spilled payload isn't held in memory and a payload that is shared with
+// another property wouldn't be freed by removing or spilling this one
+bool ownsPayload(const Property* prop)
+{
+    return prop && !prop->testStatus(Property::DeferredDocFile) && !prop->isPayloadShared();
+}
+
+unsigned int clampMemSize(std::size_t size)
+{
+    return static_cast<unsigned int>(
+        std::min<std::size_t>(size, std::numeric_limits<unsigned int>::max()));
+}
+}  // namespace
+
 TYPESYSTEM_SOURCE(App::Transaction, Base::Persistence)
 
 //**************************************************************************
@@ -116,7 +136,122 @@ int Transaction::getLastID()
 
 unsigned int Transaction::getMemSize() const
 {
-    return 0;
+    return clampMemSize(getPayloadSize());
+}
+
+std::size_t Transaction::getPayloadSize() const
+{
+    // The content of a committed transaction only changes when it's spilled.
+    // A shared payload is detached once the document changes the property, so
+    // the size is only cached if nothing is shared.
+    if (!memSizeValid) {
+        std::size_t size = 0;
+        bool shared = false;
+        auto addProperty = [&size, &shared](const Property* prop) {
+            if (ownsPayload(prop)) {
+                size += prop->getMemSize();
+            }
+            else if (prop && prop->isPayloadShared()) {
+                shared = true;
+            }
+        };
+
+        std::vector<Property*> props;
+        for (const auto& It : _Objects.get<0>()) {
+            for (const auto& v : It.second->_PropChangeMap) {
+                addProperty(v.second.property);
+            }
+            // objects removed from the document are kept by the transaction
+            if (It.second->status == TransactionObject::New && !It.first->isAttachedToDocument()) {
+                props.clear();
+                It.first->getPropertyList(props);
+                for (auto prop : props) {
+                    addProperty(prop);
+                }
+            }
+        }
+        memSize = size;
+        memSizeValid = !shared;
+    }
+    return memSize;
+}
+
+void Transaction::getSpillableProperties(std::vector<Property*>& props) const
+{
+    auto addProperty = [&props](const Property* prop) {
+        if (ownsPayload(prop) && prop->canSpillDocFile()) {
+            props.push_back(const_cast<Property*>(prop));  // NOLINT
+        }
+    };
+
+    std::vector<Property*> objProps;
+    for (const auto& It : _Objects.get<0>()) {
+        for (const auto& v : It.second->_PropChangeMap) {
+            addProperty(v.second.property);
+        }
+        if (It.second->status == TransactionObject::New && !It.first->isAttachedToDocument()) {
+            objProps.clear();
+            It.first->getPropertyList(objProps);
+            for (auto prop : objProps) {
+                addProperty(prop);
+            }
+        }
+    }
+}
+
+bool Transaction::spill(const std::string& fileName)
+{
+    std::vector<Property*> props;
+    getSpillableProperties(props);
+    if (props.empty()) {
+        return false;
+    }
+
+    Base::FileInfo fi(fileName);
+    std::vector<std::string> names;
+    int fileVersion = 0;
+    try {
+        Base::ofstream file(fi, std::ios::out | std::ios::trunc | std::ios::binary);
+        {
+            Base::ZipWriter writer(file);
+            // the files are only read back by this session, so favour speed
+            writer.setLevel(1);
+            writer.setMode("BinaryBrep");
+            fileVersion = writer.getFileVersion();
+            for (auto prop : props) {
+                names.push_back(writer.addFile("Spill.bin", prop));
+            }
+            writer.writeFiles();
+        }
+        if (!file.good()) {
+            throw Base::FileException("Failed to write file", fi);
+        }
+    }
+    catch (const Base::Exception& e) {
+        FC_WARN("Cannot spill transaction '" << Name << "': " << e.what());
+        fi.deleteFile();
+        return false;
+    }
+    catch (const std::exception& e) {
+        FC_WARN("Cannot spill transaction '" << Name << "': " << e.what());
+        fi.deleteFile();
+        return false;
+    }
+
+    // the file lives as long as a property may restore its payload from it
+    std::shared_ptr<Base::DocFileArchive> archive(new Base::DocFileArchive(fileName),
+                                                  [fileName](Base::DocFileArchive* archive) {
+                                                      delete archive;
+                                                      Base::FileInfo(fileName).deleteFile();
+                                                  });
+    archive->setFileVersion(fileVersion);
+    for (std::size_t i = 0; i < props.size(); ++i) {
+        props[i]->spillDocFile(archive, names[i]);
+    }
+
+    memSizeValid = false;
+    FC_LOG("Spilled transaction '" << Name << "' to " << fileName);
+    return true;
 }
 
 void Transaction::Save(Base::Writer& /*writer*/) const
@@ -146,6 +281,7 @@ bool Transaction::hasObject(const TransactionalObject* Obj) const
 
 void Transaction::addOrRemoveProperty(TransactionalObject* Obj, const Property* pcProp, bool add)
 {
+    memSizeValid = false;
     auto& index = _Objects.get<1>();
     auto pos = index.find(Obj);
 
@@ -199,6 +335,7 @@ void Transaction::apply(Document& Doc, bool forward)
 
 void Transaction::addObjectNew(TransactionalObject* Obj)
 {
+    memSizeValid = false;
     auto& index = _Objects.get<1>();
     auto pos = index.find(Obj);
     if (pos != index.end()) {
@@ -228,6 +365,7 @@ void Transaction::addObjectNew(TransactionalObject* Obj)
 
 void Transaction::addObjectDel(const TransactionalObject* Obj)
 {
+    memSizeValid = false;
     auto& index = _Objects.get<1>();
     auto pos = index.find(Obj);
 
@@ -249,6 +387,7 @@ void Transaction::addObjectDel(const TransactionalObject* Obj)
 
 void Transaction::addObjectChange(const TransactionalObject* Obj, const Property* Prop)
 {
+    memSizeValid = false;
     auto& index = _Objects.get<1>();
     auto pos = index.find(Obj);
 
@@ -424,7 +563,19 @@ void TransactionObject::addOrRemoveProperty(const Property* pcProp, bool add)
 
 unsigned int TransactionObject::getMemSize() const
 {
-    return 0;
+    return clampMemSize(getPayloadSize());
+}
+
+std::size_t TransactionObject::getPayloadSize() const
+{
+    std::size_t size = 0;
+    for (const auto& v : _PropChangeMap) {
+        auto prop = v.second.property;
+        if (ownsPayload(prop)) {
+            size += prop->getMemSize();
+        }
+    }
+    return size;
 }
 
 void TransactionObject::Save(Base::Writer& /*writer*/) const
@@ -66,6 +66,10 @@ public:
     std::string Name;
 
     unsigned int getMemSize() const override;
+    /** Returns the memory of the payloads only held by this transaction
+     * Unlike getMemSize() the size isn't limited to the range of unsigned int.
+     */
+    std::size_t getPayloadSize() const;
     void Save(Base::Writer& writer) const override;
     /// This method is used to restore properties from an XML document.
     void Restore(Base::XMLReader& reader) override;
@@ -87,8 +91,21 @@ public:
     void addObjectDel(const TransactionalObject* Obj);
     void addObjectChange(const TransactionalObject* Obj, const Property* Prop);
 
+    /** Moves the payload of the stored properties to the given file
+     * The properties restore it when the transaction is applied. The file is
+     * removed once no property refers to it anymore.
+     * @return false if there is nothing to spill or writing the file has failed.
+     * @see Property::spillDocFile()
+     */
+    bool spill(const std::string& fileName);
+
+private:
+    void getSpillableProperties(std::vector<Property*>& props) const;
+
 private:
     int transID;
+    mutable std::size_t memSize {0};
+    mutable bool memSizeValid {false};
     using Info = std::pair<const TransactionalObject*, TransactionObject*>;
     bmi::multi_index_container<
         Info,
@@ -118,6 +135,9 @@ public:
     void addOrRemoveProperty(const Property* pcProp, bool add);
 
     unsigned int getMemSize() const override;
+    /// Returns the memory of the payloads only held by this object
+    /// @see Transaction::getPayloadSize()
+    std::size_t getPayloadSize() const;
     void Save(Base::Writer& writer) const override;
     /// This method is used to restore properties from an XML document.
     void Restore(Base::XMLReader& reader) override;
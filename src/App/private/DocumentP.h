@@ -27,9 +27,13 @@
 #pragma warning(disable : 4834)
 #endif
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <map>
 #include <string>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
@@ -41,6 +45,8 @@
 
 #include <App/DocumentObject.h>
 #include <App/DocumentObserver.h>
+#include <App/RecomputeCache.h>
+#include <App/RecomputeProfiler.h>
 #include <App/StringHasher.h>
 #include <Base/UniqueNameManager.h>
 
@@ -89,12 +95,33 @@ struct DocumentP
     bool opentransaction;
     std::bitset<32> StatusBits;
     int iUndoMode;
-    unsigned int UndoMemSize;
+    std::size_t UndoMemSize;
     unsigned int UndoMaxStackSize;
     std::string programVersion;
     mutable HasherMap hashers;
     std::multimap<const App::DocumentObject*, std::unique_ptr<App::DocumentObjectExecReturn>>
         _RecomputeLog;
+    /// guards the shared document state touched by concurrently recomputed objects
+    std::recursive_mutex recomputeMutex;
+    /// property change notifications queued while objects recompute concurrently,
+    /// the flag is true for 'before change' notifications
+    std::unordered_map<const App::DocumentObject*, std::vector<std::pair<const Property*, bool>>>
+        deferredChanges;
+    /// a 'before change' notification that a worker passes to the main thread
+    struct BeforeChangeRequest
+    {
+        const App::DocumentObject* object;
+        const Property* property;
+        bool done;
+        std::exception_ptr error;
+    };
+    /// guards the requests and the number of running workers
+    std::mutex requestMutex;
+    std::condition_variable requestCondition;
+    std::deque<BeforeChangeRequest*> beforeChangeRequests;
+    std::size_t runningWorkers {0};
+    RecomputeCache recomputeCache;
+    RecomputeProfiler recomputeProfiler;
 
     StringHasherRef Hasher;
 
@@ -116,6 +143,7 @@ struct DocumentP
             delete returnCode;
             return;
         }
+        std::lock_guard<std::recursive_mutex> lock(recomputeMutex);
         _RecomputeLog.emplace(returnCode->Which,
                               std::unique_ptr<DocumentObjectExecReturn>(returnCode));
         returnCode->Which->setStatus(ObjectStatus::Error, true);
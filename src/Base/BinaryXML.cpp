@@ -0,0 +1,772 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string_view>
+#include <unordered_map>
+#endif
+
+#include "BinaryXML.h"
+#include "Exception.h"
+
+
+using namespace Base;
+
+namespace
+{
+
+constexpr std::array<char, 4> magic {'\x89', 'F', 'C', 'X'};
+constexpr std::size_t formatVersion = 1;
+// longer runs of white space are not worth to be shared
+constexpr std::size_t maxSharedCharacters = 256;
+
+enum Record : unsigned char
+{
+    EndDocumentRecord,
+    StartElementRecord,
+    EmptyElementRecord,
+    EndElementRecord,
+    CharactersRecord,
+    SharedCharactersRecord,
+    StartCDATARecord,
+    EndCDATARecord
+};
+
+using Attributes = std::vector<std::pair<std::string_view, std::string>>;
+
+struct StringHash
+{
+    using is_transparent = void;
+    std::size_t operator()(std::string_view str) const
+    {
+        return std::hash<std::string_view> {}(str);
+    }
+};
+
+bool isSpace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+
+void appendUtf8(std::string& out, unsigned long code)
+{
+    if (code < 0x80) {
+        out += static_cast<char>(code);
+    }
+    else if (code < 0x800) {
+        out += static_cast<char>(0xC0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+    else if (code < 0x10000) {
+        out += static_cast<char>(0xE0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+    else if (code < 0x110000) {
+        out += static_cast<char>(0xF0 | (code >> 18));
+        out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+    else {
+        throw XMLParseException("Invalid character reference");
+    }
+}
+
+/// Resolves the entity and character references and normalizes line ends
+/// and, for attribute values, white space the same way an XML parser does
+void decodeText(std::string_view raw, bool attribute, std::string& out)
+{
+    out.clear();
+    if (raw.find_first_of(attribute ? "&\r\n\t" : "&\r") == std::string_view::npos) {
+        out.assign(raw);
+        return;
+    }
+
+    out.reserve(raw.size());
+    for (std::size_t i = 0; i < raw.size(); ++i) {
+        char c = raw[i];
+        if (c == '&') {
+            std::size_t end = raw.find(';', i);
+            if (end == std::string_view::npos) {
+                throw XMLParseException("Unterminated entity reference");
+            }
+            std::string_view entity = raw.substr(i + 1, end - i - 1);
+            if (entity == "lt") {
+                out += '<';
+            }
+            else if (entity == "gt") {
+                out += '>';
+            }
+            else if (entity == "amp") {
+                out += '&';
+            }
+            else if (entity == "quot") {
+                out += '"';
+            }
+            else if (entity == "apos") {
+                out += '\'';
+            }
+            else if (entity.size() > 1 && entity[0] == '#') {
+                bool hex = entity[1] == 'x';
+                std::string digits(entity.substr(hex ? 2 : 1));
+                std::size_t count = 0;
+                unsigned long code = 0;
+                try {
+                    code = std::stoul(digits, &count, hex ? 16 : 10);
+                }
+                catch (const std::exception&) {
+                    count = 0;
+                }
+                if (digits.empty() || count != digits.size()) {
+                    throw XMLParseException("Invalid character reference");
+                }
+                appendUtf8(out, code);
+            }
+            else {
+                throw XMLParseException("Unknown entity reference &" + std::string(entity) + ";");
+            }
+            i = end;
+        }
+        else if (c == '\r') {
+            out += attribute ? ' ' : '\n';
+            if (i + 1 < raw.size() && raw[i + 1] == '\n') {
+                ++i;
+            }
+        }
+        else if (attribute && (c == '\n' || c == '\t')) {
+            out += ' ';
+        }
+        else {
+            out += c;
+        }
+    }
+}
+
+/// Writes the records of a document
+class Encoder
+{
+public:
+    explicit Encoder(std::ostream& out)
+        : out(out)
+    {
+        out.write(magic.data(), magic.size());
+        writeSize(formatVersion);
+    }
+
+    void element(std::string_view name, const Attributes& attrs, bool empty)
+    {
+        out.put(static_cast<char>(empty ? EmptyElementRecord : StartElementRecord));
+        writeSharedString(name);
+        writeSize(attrs.size());
+        for (const auto& [key, value] : attrs) {
+            writeSharedString(key);
+            writeString(value);
+        }
+    }
+    void endElement()
+    {
+        out.put(static_cast<char>(EndElementRecord));
+    }
+    void characters(const std::string& text)
+    {
+        bool space = text.size() <= maxSharedCharacters
+            && std::all_of(text.begin(), text.end(), [](char c) {
+                   return isSpace(c);
+               });
+        if (space) {
+            out.put(static_cast<char>(SharedCharactersRecord));
+            writeSharedString(text);
+        }
+        else {
+            out.put(static_cast<char>(CharactersRecord));
+            writeString(text);
+        }
+    }
+    void cdata(const std::string& text)
+    {
+        out.put(static_cast<char>(StartCDATARecord));
+        if (!text.empty()) {
+            out.put(static_cast<char>(CharactersRecord));
+            writeString(text);
+        }
+        out.put(static_cast<char>(EndCDATARecord));
+    }
+    void endDocument()
+    {
+        out.put(static_cast<char>(EndDocumentRecord));
+    }
+
+private:
+    void writeSize(std::size_t size)
+    {
+        // unsigned LEB128
+        do {
+            auto byte = static_cast<unsigned char>(size & 0x7F);
+            size >>= 7;
+            if (size) {
+                byte |= 0x80;
+            }
+            out.put(static_cast<char>(byte));
+        } while (size);
+    }
+    void writeString(std::string_view str)
+    {
+        writeSize(str.size());
+        out.write(str.data(), static_cast<std::streamsize>(str.size()));
+    }
+    void writeSharedString(std::string_view str)
+    {
+        auto it = shared.find(str);
+        if (it != shared.end()) {
+            writeSize(it->second);
+            return;
+        }
+        // the next free index introduces a new string
+        std::size_t index = shared.size();
+        shared.emplace(std::string(str), index);
+        writeSize(index);
+        writeString(str);
+    }
+
+private:
+    std::ostream& out;
+    std::unordered_map<std::string, std::size_t, StringHash, std::equal_to<>> shared;
+};
+
+/// Scans the subset of XML that is written by Base::Writer
+class Scanner
+{
+    // thrown if a token continues beyond the end of a chunk
+    struct Incomplete
+    {
+    };
+
+public:
+    explicit Scanner(Encoder& encoder)
+        : encoder(encoder)
+    {}
+
+    /// Encodes the complete tokens of \a chunk and returns the number of
+    /// scanned characters. The last chunk of a document must be complete.
+    std::size_t scan(std::string_view chunk, bool last)
+    {
+        xml = chunk;
+        pos = 0;
+        final = last;
+        while (pos < xml.size()) {
+            std::size_t start = pos;
+            try {
+                scanToken();
+            }
+            catch (const Incomplete&) {
+                return start;
+            }
+        }
+        if (final) {
+            if (!elements.empty()) {
+                throw XMLParseException("Unexpected end of document");
+            }
+            encoder.endDocument();
+        }
+        return pos;
+    }
+
+private:
+    void scanToken()
+    {
+        std::size_t next = xml.find('<', pos);
+        if (next == std::string_view::npos) {
+            if (!final) {
+                // the text may continue in the next chunk
+                throw Incomplete();
+            }
+            next = xml.size();
+        }
+        if (next > pos) {
+            // text outside of the root element isn't reported
+            if (!elements.empty()) {
+                decodeText(xml.substr(pos, next - pos), false, text);
+                encoder.characters(text);
+            }
+            pos = next;
+            return;
+        }
+
+        require(std::strlen("<![CDATA["));
+        if (startsWith("<?")) {
+            skipPast("?>");
+        }
+        else if (startsWith("<!--")) {
+            skipPast("-->");
+        }
+        else if (startsWith("<![CDATA[")) {
+            scanCDATA();
+        }
+        else if (startsWith("<!")) {
+            throw XMLParseException("Document type declarations are not supported");
+        }
+        else if (startsWith("</")) {
+            scanEndTag();
+        }
+        else {
+            scanStartTag();
+        }
+    }
+    /// Makes sure that the next \a count characters are part of the chunk
+    void require(std::size_t count) const
+    {
+        if (!final && xml.size() - pos < count) {
+            throw Incomplete();
+        }
+    }
+    [[noreturn]] void unexpectedEnd() const
+    {
+        if (!final) {
+            throw Incomplete();
+        }
+        throw XMLParseException("Unexpected end of document");
+    }
+    bool startsWith(std::string_view str) const
+    {
+        return xml.substr(pos, str.size()) == str;
+    }
+    void skipPast(std::string_view str)
+    {
+        std::size_t end = xml.find(str, pos);
+        if (end == std::string_view::npos) {
+            unexpectedEnd();
+        }
+        pos = end + str.size();
+    }
+    void skipSpace()
+    {
+        while (pos < xml.size() && isSpace(xml[pos])) {
+            ++pos;
+        }
+    }
+    void expect(char c)
+    {
+        if (pos >= xml.size()) {
+            unexpectedEnd();
+        }
+        if (xml[pos] != c) {
+            throw XMLParseException(std::string("Expected '") + c + "' in XML document");
+        }
+        ++pos;
+    }
+    std::string_view scanName()
+    {
+        std::size_t start = pos;
+        while (pos < xml.size() && !isSpace(xml[pos]) && xml[pos] != '/' && xml[pos] != '>'
+               && xml[pos] != '=') {
+            ++pos;
+        }
+        if (pos >= xml.size()) {
+            unexpectedEnd();
+        }
+        if (pos == start) {
+            throw XMLParseException("Missing name in XML document");
+        }
+        return xml.substr(start, pos - start);
+    }
+    void scanCDATA()
+    {
+        if (elements.empty()) {
+            throw XMLParseException("CDATA section outside of the root element");
+        }
+        std::size_t start = pos + std::strlen("<![CDATA[");
+        std::size_t end = xml.find("]]>", start);
+        if (end == std::string_view::npos) {
+            unexpectedEnd();
+        }
+        std::string_view raw = xml.substr(start, end - start);
+        text.assign(raw);
+        if (raw.find('\r') != std::string_view::npos) {
+            // only the line ends are normalized inside of CDATA sections
+            text.clear();
+            for (std::size_t i = 0; i < raw.size(); ++i) {
+                if (raw[i] != '\r') {
+                    text += raw[i];
+                }
+                else if (i + 1 >= raw.size() || raw[i + 1] != '\n') {
+                    text += '\n';
+                }
+            }
+        }
+        encoder.cdata(text);
+        pos = end + 3;
+    }
+    void scanStartTag()
+    {
+        ++pos;
+        std::string_view name = scanName();
+        attributes.clear();
+        for (;;) {
+            skipSpace();
+            require(2);
+            if (startsWith("/>")) {
+                pos += 2;
+                encoder.element(name, attributes, true);
+                return;
+            }
+            if (startsWith(">")) {
+                ++pos;
+                encoder.element(name, attributes, false);
+                elements.emplace_back(name);
+                return;
+            }
+            std::string_view key = scanName();
+            skipSpace();
+            expect('=');
+            skipSpace();
+            if (pos >= xml.size()) {
+                unexpectedEnd();
+            }
+            if (xml[pos] != '"' && xml[pos] != '\'') {
+                throw XMLParseException("Attribute value must be quoted");
+            }
+            char quote = xml[pos++];
+            std::size_t end = xml.find(quote, pos);
+            if (end == std::string_view::npos) {
+                unexpectedEnd();
+            }
+            std::string value;
+            decodeText(xml.substr(pos, end - pos), true, value);
+            attributes.emplace_back(key, std::move(value));
+            pos = end + 1;
+        }
+    }
+    void scanEndTag()
+    {
+        pos += 2;
+        std::string_view name = scanName();
+        skipSpace();
+        expect('>');
+        if (elements.empty() || elements.back() != name) {
+            throw XMLParseException("Mismatched end tag </" + std::string(name) + ">");
+        }
+        elements.pop_back();
+        encoder.endElement();
+    }
+
+private:
+    std::string_view xml;
+    std::size_t pos {0};
+    bool final {true};
+    Encoder& encoder;
+    // the names must outlive the chunk of their start tag
+    std::vector<std::string> elements;
+    Attributes attributes;
+    std::string text;
+};
+
+void writeEscaped(std::ostream& out, const std::string& str, bool attribute)
+{
+    for (char c : str) {
+        switch (c) {
+            case '&':
+                out << "&amp;";
+                break;
+            case '<':
+                out << "&lt;";
+                break;
+            case '>':
+                out << "&gt;";
+                break;
+            case '"':
+                out << (attribute ? "&quot;" : "\"");
+                break;
+            case '\n':
+                out << (attribute ? "&#10;" : "\n");
+                break;
+            case '\t':
+                out << (attribute ? "&#9;" : "\t");
+                break;
+            case '\r':
+                out << "&#13;";
+                break;
+            default:
+                out << c;
+                break;
+        }
+    }
+}
+
+}  // namespace
+
+bool Base::isBinaryXML(std::istream& str)
+{
+    // an XML document can't start with this character, so peeking it suffices
+    return str.rdbuf()->sgetc() == std::char_traits<char>::to_int_type(magic[0]);
+}
+
+void Base::convertXMLToBinary(const std::string& xml, std::ostream& out)
+{
+    Encoder encoder(out);
+    Scanner scanner(encoder);
+    scanner.scan(xml, true);
+}
+
+void Base::convertXMLToBinary(std::istream& in, std::ostream& out)
+{
+    BinaryXMLStreambuf buf(out);
+    std::ostream str(&buf);
+    str << in.rdbuf();
+    buf.finish();
+}
+
+// ----------------------------------------------------------------------------
+
+struct BinaryXMLStreambuf::Private
+{
+    explicit Private(std::ostream& out)
+        : encoder(out)
+        , scanner(encoder)
+    {}
+
+    Encoder encoder;
+    Scanner scanner;
+    std::string pending;
+    std::string error;
+    bool finished {false};
+};
+
+BinaryXMLStreambuf::BinaryXMLStreambuf(std::ostream& out)
+    : d(std::make_unique<Private>(out))
+{}
+
+BinaryXMLStreambuf::~BinaryXMLStreambuf() = default;
+
+BinaryXMLStreambuf::int_type BinaryXMLStreambuf::overflow(int_type c)
+{
+    if (traits_type::eq_int_type(c, traits_type::eof())) {
+        return traits_type::not_eof(c);
+    }
+    char ch = traits_type::to_char_type(c);
+    return xsputn(&ch, 1) == 1 ? c : traits_type::eof();
+}
+
+std::streamsize BinaryXMLStreambuf::xsputn(const char* s, std::streamsize n)
+{
+    if (d->finished || !d->error.empty()) {
+        return 0;
+    }
+    d->pending.append(s, static_cast<std::size_t>(n));
+    if (d->pending.size() >= chunkSize) {
+        encode(false);
+    }
+    return d->error.empty() ? n : 0;
+}
+
+void BinaryXMLStreambuf::finish()
+{
+    if (!d->finished) {
+        encode(true);
+        d->finished = true;
+    }
+    if (!d->error.empty()) {
+        throw XMLParseException(d->error);
+    }
+}
+
+void BinaryXMLStreambuf::encode(bool last)
+{
+    if (!d->error.empty()) {
+        return;
+    }
+    try {
+        std::size_t count = d->scanner.scan(d->pending, last);
+        d->pending.erase(0, count);
+    }
+    catch (const XMLParseException& e) {
+        // the stream would swallow the exception, so it's reported by finish()
+        d->error = e.what();
+        std::string().swap(d->pending);
+    }
+}
+
+void Base::convertBinaryToXML(std::istream& in, std::ostream& out)
+{
+    BinaryXMLReader reader(in);
+    out << "<?xml version='1.0' encoding='utf-8'?>\n";
+    bool cdata = false;
+    for (;;) {
+        auto token = reader.next();
+        switch (token) {
+            case BinaryXMLReader::Token::EndDocument:
+                out << '\n';
+                return;
+            case BinaryXMLReader::Token::StartElement:
+            case BinaryXMLReader::Token::EmptyElement:
+                out << '<' << reader.getName();
+                for (const auto& [key, value] : reader.getAttributes()) {
+                    out << ' ' << key << "=\"";
+                    writeEscaped(out, value, true);
+                    out << '"';
+                }
+                out << (token == BinaryXMLReader::Token::EmptyElement ? "/>" : ">");
+                break;
+            case BinaryXMLReader::Token::EndElement:
+                out << "</" << reader.getName() << '>';
+                break;
+            case BinaryXMLReader::Token::Characters:
+                if (cdata) {
+                    out << reader.getCharacters();
+                }
+                else {
+                    writeEscaped(out, reader.getCharacters(), false);
+                }
+                break;
+            case BinaryXMLReader::Token::StartCDATA:
+                cdata = true;
+                out << "<![CDATA[";
+                break;
+            case BinaryXMLReader::Token::EndCDATA:
+                cdata = false;
+                out << "]]>";
+                break;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+BinaryXMLReader::BinaryXMLReader(std::istream& str)
+{
+    std::ostringstream data;
+    data << str.rdbuf();
+    buffer = std::move(data).str();
+
+    if (buffer.compare(0, magic.size(), magic.data(), magic.size()) != 0) {
+        throw XMLParseException("Not a binary XML document");
+    }
+    pos = magic.size();
+    if (readSize() != formatVersion) {
+        throw XMLParseException("Unsupported version of binary XML document");
+    }
+}
+
+BinaryXMLReader::Token BinaryXMLReader::next()
+{
+    if (pos >= buffer.size()) {
+        return Token::EndDocument;
+    }
+
+    switch (readByte()) {
+        case EndDocumentRecord:
+            if (!elements.empty()) {
+                throw XMLParseException("Unexpected end of document");
+            }
+            pos = buffer.size();
+            return Token::EndDocument;
+        case StartElementRecord:
+        case EmptyElementRecord: {
+            bool empty = buffer[pos - 1] == EmptyElementRecord;
+            name = &readSharedString();
+            std::size_t count = readSize();
+            if (count > buffer.size() - pos) {
+                throw XMLParseException("Corrupted binary XML document");
+            }
+            attributes.resize(count);
+            for (auto& [key, value] : attributes) {
+                key = readSharedString();
+                readString(value);
+            }
+            if (empty) {
+                return Token::EmptyElement;
+            }
+            elements.push_back(name);
+            return Token::StartElement;
+        }
+        case EndElementRecord:
+            if (elements.empty()) {
+                throw XMLParseException("Mismatched end of element");
+            }
+            name = elements.back();
+            elements.pop_back();
+            return Token::EndElement;
+        case CharactersRecord:
+            readString(characters);
+            return Token::Characters;
+        case SharedCharactersRecord:
+            characters = readSharedString();
+            return Token::Characters;
+        case StartCDATARecord:
+            return Token::StartCDATA;
+        case EndCDATARecord:
+            return Token::EndCDATA;
+        default:
+            throw XMLParseException("Corrupted binary XML document");
+    }
+}
+
+unsigned char BinaryXMLReader::readByte()
+{
+    if (pos >= buffer.size()) {
+        throw XMLParseException("Unexpected end of binary XML document");
+    }
+    return static_cast<unsigned char>(buffer[pos++]);
+}
+
+std::size_t BinaryXMLReader::readSize()
+{
+    std::size_t size = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        unsigned char byte = readByte();
+        size |= static_cast<std::size_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return size;
+        }
+    }
+    throw XMLParseException("Corrupted binary XML document");
+}
+
+void BinaryXMLReader::readString(std::string& str)
+{
+    std::size_t size = readSize();
+    if (size > buffer.size() - pos) {
+        throw XMLParseException("Unexpected end of binary XML document");
+    }
+    str.assign(buffer, pos, size);
+    pos += size;
+}
+
+const std::string& BinaryXMLReader::readSharedString()
+{
+    std::size_t index = readSize();
+    if (index == strings.size()) {
+        strings.emplace_back();
+        readString(strings.back());
+    }
+    else if (index > strings.size()) {
+        throw XMLParseException("Corrupted binary XML document");
+    }
+    return strings[index];
+}
@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+
+#ifndef BASE_BINARYXML_H
+#define BASE_BINARYXML_H
+
+#include <deque>
+#include <iosfwd>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+#include <FCGlobal.h>
+
+namespace Base
+{
+
+/** @name Binary XML
+ * A compact encoding of the XML documents written by Base::Writer.
+ *
+ * The encoded document starts with a magic number and a format version,
+ * followed by a sequence of length-prefixed records, one for each SAX event.
+ * Element and attribute names as well as the indentation between elements
+ * are interned, i.e. they are stored once and then referenced by an index.
+ * Comments and processing instructions are dropped, everything else is kept
+ * so that a document can be converted back to XML for comparison.
+ *
+ * Base::XMLReader detects the encoding on its own, Base::ZipWriter uses it
+ * for Document.xml if the 'BinaryXML' mode is set.
+ */
+//@{
+/// Returns true if the stream starts with a binary encoded document
+BaseExport bool isBinaryXML(std::istream& str);
+/// Encodes the XML document \a xml, throws XMLParseException if it is malformed
+BaseExport void convertXMLToBinary(const std::string& xml, std::ostream& out);
+/// Encodes the XML document read from \a in chunk by chunk
+BaseExport void convertXMLToBinary(std::istream& in, std::ostream& out);
+/// Converts a binary encoded document back to XML
+BaseExport void convertBinaryToXML(std::istream& in, std::ostream& out);
+//@}
+
+/** The BinaryXMLStreambuf class
+ * Encodes the XML text while it is written, so that a document never has to
+ * be kept as text as a whole. The text is scanned in chunks, only a token
+ * that isn't complete at the end of a chunk is kept for the next one.
+ */
+class BaseExport BinaryXMLStreambuf: public std::streambuf
+{
+public:
+    /// Writes the encoded document to \a out
+    explicit BinaryXMLStreambuf(std::ostream& out);
+    ~BinaryXMLStreambuf() override;
+
+    /// Encodes the rest of the text, throws XMLParseException if the document is malformed
+    void finish();
+
+    BinaryXMLStreambuf(const BinaryXMLStreambuf&) = delete;
+    BinaryXMLStreambuf(BinaryXMLStreambuf&&) = delete;
+    BinaryXMLStreambuf& operator=(const BinaryXMLStreambuf&) = delete;
+    BinaryXMLStreambuf& operator=(BinaryXMLStreambuf&&) = delete;
+
+protected:
+    int_type overflow(int_type c) override;
+    std::streamsize xsputn(const char* s, std::streamsize n) override;
+
+private:
+    void encode(bool last);
+
+private:
+    static constexpr std::size_t chunkSize = 0x10000;
+    struct Private;
+    std::unique_ptr<Private> d;
+};
+
+/** The BinaryXMLReader class
+ * Pull parser for binary encoded documents. It reports the same events that
+ * Xerces would report for the original XML document.
+ */
+class BaseExport BinaryXMLReader
+{
+public:
+    enum class Token
+    {
+        EndDocument,
+        StartElement,
+        EmptyElement,
+        EndElement,
+        Characters,
+        StartCDATA,
+        EndCDATA
+    };
+
+    /// Reads the whole document, throws XMLParseException if it isn't binary encoded
+    explicit BinaryXMLReader(std::istream& str);
+
+    /// Reads the next token
+    Token next();
+    /// Name of the current element
+    const std::string& getName() const
+    {
+        return *name;
+    }
+    /// Attributes of the current element
+    const std::vector<std::pair<std::string, std::string>>& getAttributes() const
+    {
+        return attributes;
+    }
+    /// Character content of the current token
+    const std::string& getCharacters() const
+    {
+        return characters;
+    }
+
+private:
+    unsigned char readByte();
+    std::size_t readSize();
+    void readString(std::string& str);
+    const std::string& readSharedString();
+
+private:
+    std::string buffer;
+    std::size_t pos {0};
+    std::deque<std::string> strings;
+    std::vector<const std::string*> elements;
+    const std::string* name {nullptr};
+    std::vector<std::pair<std::string, std::string>> attributes;
+    std::string characters;
+};
+
+}  // namespace Base
+
+#endif  // BASE_BINARYXML_H
@@ -0,0 +1,525 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <utility>
+#endif
+
+#include "KDTree.h"
+#include "Exception.h"
+
+
+using namespace Base;
+
+namespace
+{
+
+// maximum number of points in a leaf
+constexpr std::size_t LeafSize = 16;
+// number of queries a thread takes at once
+constexpr std::size_t BlockSize = 1024;
+// subtrees with fewer points are built by a single thread
+constexpr std::size_t ParallelBuildSize = std::size_t(1) << 16;
+
+// The two halves of a node differ by one point at most, so there are at most two different
+// sizes on each level and the number of nodes can be counted level by level.
+std::size_t countNodes(std::size_t count)
+{
+    std::size_t total = 0;
+    std::vector<std::pair<std::size_t, std::size_t>> level {{count, 1}};
+    while (!level.empty()) {
+        std::vector<std::pair<std::size_t, std::size_t>> next;
+        auto addSize = [&next](std::size_t size, std::size_t num) {
+            for (auto& it : next) {
+                if (it.first == size) {
+                    it.second += num;
+                    return;
+                }
+            }
+            next.emplace_back(size, num);
+        };
+        for (const auto& [size, num] : level) {
+            total += num;
+            if (size > LeafSize) {
+                addSize(size / 2, num);
+                addSize(size - size / 2, num);
+            }
+        }
+        level.swap(next);
+    }
+    return total;
+}
+
+int numberOfThreads(int threads)
+{
+    if (threads > 0) {
+        return threads;
+    }
+    return std::max(1, int(std::thread::hardware_concurrency()));
+}
+
+// Calls func(begin, end) for blocks of the range [0, count) on several threads and rethrows
+// the first exception of a block afterwards
+template<typename Func>
+void parallelBlocks(std::size_t count, int threads, Func&& func)
+{
+    std::size_t numBlocks = (count + BlockSize - 1) / BlockSize;
+    std::size_t numThreads = std::min<std::size_t>(numberOfThreads(threads), numBlocks);
+    if (numThreads <= 1) {
+        for (std::size_t begin = 0; begin < count; begin += BlockSize) {
+            func(begin, std::min(count, begin + BlockSize));
+        }
+        return;
+    }
+
+    std::atomic<std::size_t> nextBlock {0};
+    std::exception_ptr error;
+    std::mutex mutex;
+    auto work = [&]() {
+        for (;;) {
+            std::size_t begin = BlockSize * nextBlock.fetch_add(1);
+            if (begin >= count) {
+                return;
+            }
+            try {
+                func(begin, std::min(count, begin + BlockSize));
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(numThreads - 1);
+    for (std::size_t i = 1; i < numThreads; i++) {
+        pool.emplace_back(work);
+    }
+    work();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+float squaredDistance(float dist)
+{
+    // a negative distance doesn't accept any point
+    return dist < 0.F ? -1.F : dist * dist;
+}
+
+}  // namespace
+
+// ----------------------------------------------------------------------------
+
+/**
+ * Collects the nearest points found so far. With a capacity the list keeps the closest points
+ * sorted, otherwise all points within the maximum distance are collected unsorted.
+ */
+class KDTree::Neighbours
+{
+public:
+    using Item = std::pair<float, index_type>;
+
+    void reset(std::size_t capacity, float maxDist2)
+    {
+        this->capacity = capacity;
+        this->maxDist2 = maxDist2;
+        items.clear();
+        items.reserve(capacity + 1);
+    }
+
+    /// squared distance a point must not exceed to be added
+    float bound() const
+    {
+        if (capacity > 0 && items.size() == capacity) {
+            return items.back().first;
+        }
+        return maxDist2;
+    }
+
+    void add(float dist2, index_type index)
+    {
+        Item item(dist2, index);
+        if (capacity == 0) {
+            items.push_back(item);
+            return;
+        }
+        if (items.size() == capacity) {
+            if (!(item < items.back())) {
+                return;
+            }
+            items.pop_back();
+        }
+        items.insert(std::upper_bound(items.begin(), items.end(), item), item);
+    }
+
+    void sort()
+    {
+        std::sort(items.begin(), items.end());
+    }
+
+    const std::vector<Item>& getItems() const
+    {
+        return items;
+    }
+
+private:
+    std::size_t capacity {0};
+    float maxDist2 {0.F};
+    std::vector<Item> items;
+};
+
+// ----------------------------------------------------------------------------
+
+KDTree::KDTree() = default;
+
+KDTree::KDTree(const std::vector<Vector3f>& points)
+{
+    build(points.data(), points.size());
+}
+
+KDTree::KDTree(const Vector3f* points, std::size_t count)
+{
+    build(points, count);
+}
+
+void KDTree::build(const Vector3f* points, std::size_t count)
+{
+    if (count >= std::size_t(InvalidIndex)) {
+        throw ValueError("Too many points for a kd-tree");
+    }
+
+    clear();
+    entries.reserve(count);
+    for (std::size_t index = 0; index < count; index++) {
+        const Vector3f& pnt = points[index];
+        if (std::isfinite(pnt.x) && std::isfinite(pnt.y) && std::isfinite(pnt.z)) {
+            entries.push_back({pnt, index_type(index)});
+            bbox.Add(pnt);
+        }
+    }
+    if (entries.empty()) {
+        return;
+    }
+
+    nodes.resize(countNodes(entries.size()));
+    nodes[0].begin = 0;
+    nodes[0].end = index_type(entries.size());
+
+    // the upper levels are split over the cores
+    int parallelDepth = 0;
+    if (entries.size() > ParallelBuildSize) {
+        int threads = numberOfThreads(0);
+        while ((1 << parallelDepth) < threads) {
+            parallelDepth++;
+        }
+    }
+    buildNode(0, bbox, parallelDepth);
+}
+
+void KDTree::buildNode(std::size_t node, const BoundBox3f& cell, int parallelDepth)
+{
+    Node& item = nodes[node];
+    std::size_t count = item.end - item.begin;
+    if (count <= LeafSize) {
+        item.axis = -1;
+        return;
+    }
+
+    // split the longest side of the cell
+    float length[3] = {cell.LengthX(), cell.LengthY(), cell.LengthZ()};
+    item.axis = int(std::max_element(length, length + 3) - length);
+    auto axis = static_cast<unsigned short>(item.axis);
+
+    auto first = entries.begin() + item.begin;
+    auto middle = first + std::ptrdiff_t(count / 2);
+    auto last = entries.begin() + item.end;
+    std::nth_element(first, middle, last, [axis](const Entry& e1, const Entry& e2) {
+        return e1.point[axis] < e2.point[axis];
+    });
+    item.split = middle->point[axis];
+
+    std::size_t left = node + 1;
+    std::size_t right = left + countNodes(count / 2);
+    item.right = index_type(right);
+    nodes[left].begin = item.begin;
+    nodes[left].end = item.begin + index_type(count / 2);
+    nodes[right].begin = nodes[left].end;
+    nodes[right].end = item.end;
+
+    BoundBox3f leftCell = cell;
+    BoundBox3f rightCell = cell;
+    switch (axis) {
+        case 0:
+            leftCell.MaxX = rightCell.MinX = item.split;
+            break;
+        case 1:
+            leftCell.MaxY = rightCell.MinY = item.split;
+            break;
+        default:
+            leftCell.MaxZ = rightCell.MinZ = item.split;
+            break;
+    }
+
+    if (parallelDepth > 0 && count > ParallelBuildSize) {
+        auto future = std::async(std::launch::async, [&]() {
+            buildNode(left, leftCell, parallelDepth - 1);
+        });
+        buildNode(right, rightCell, parallelDepth - 1);
+        future.get();
+    }
+    else {
+        buildNode(left, leftCell, 0);
+        buildNode(right, rightCell, 0);
+    }
+}
+
+void KDTree::clear()
+{
+    nodes.clear();
+    entries.clear();
+    bbox = BoundBox3f();
+}
+
+std::size_t KDTree::size() const
+{
+    return entries.size();
+}
+
+bool KDTree::empty() const
+{
+    return entries.empty();
+}
+
+const BoundBox3f& KDTree::getBoundBox() const
+{
+    return bbox;
+}
+
+void KDTree::search(std::size_t node,
+                    const Vector3f& pnt,
+                    Vector3f& offset,
+                    float cellDist,
+                    Neighbours& result) const
+{
+    const Node& item = nodes[node];
+    if (item.axis < 0) {
+        for (index_type pos = item.begin; pos < item.end; pos++) {
+            const Entry& entry = entries[pos];
+            float dist2 = DistanceP2(pnt, entry.point);
+            if (dist2 <= result.bound()) {
+                result.add(dist2, entry.index);
+            }
+        }
+        return;
+    }
+
+    // visit the half with the point first, the other one only if it can contain closer points
+    auto axis = static_cast<unsigned short>(item.axis);
+    float diff = pnt[axis] - item.split;
+    std::size_t nearNode = diff < 0.F ? node + 1 : std::size_t(item.right);
+    std::size_t farNode = diff < 0.F ? std::size_t(item.right) : node + 1;
+    search(nearNode, pnt, offset, cellDist, result);
+
+    // the distance to the far cell grows by the distance to the split plane
+    float old = offset[axis];
+    float farDist = cellDist - old * old + diff * diff;
+    if (farDist <= result.bound()) {
+        offset[axis] = diff;
+        search(farNode, pnt, offset, farDist, result);
+        offset[axis] = old;
+    }
+}
+
+void KDTree::query(const Vector3f& pnt, Neighbours& result) const
+{
+    if (!nodes.empty()) {
+        Vector3f offset;
+        search(0, pnt, offset, 0.F, result);
+    }
+}
+
+KDTree::index_type KDTree::findNearest(const Vector3f& pnt, float& dist, float maxDist) const
+{
+    index_type index = InvalidIndex;
+    findNearest(pnt, 1, &index, &dist, maxDist);
+    return index;
+}
+
+std::size_t KDTree::findNearest(const Vector3f& pnt,
+                                std::size_t k,
+                                index_type* indices,
+                                float* distances,
+                                float maxDist) const
+{
+    Neighbours result;
+    return findNearest(pnt, k, indices, distances, maxDist, result);
+}
+
+std::size_t KDTree::findNearest(const Vector3f& pnt,
+                                std::size_t k,
+                                index_type* indices,
+                                float* distances,
+                                float maxDist,
+                                Neighbours& result) const
+{
+    std::fill(indices, indices + k, InvalidIndex);
+    std::fill(distances, distances + k, std::numeric_limits<float>::max());
+    if (k == 0) {
+        return 0;
+    }
+
+    result.reset(k, squaredDistance(maxDist));
+    query(pnt, result);
+
+    const auto& items = result.getItems();
+    for (std::size_t i = 0; i < items.size(); i++) {
+        indices[i] = items[i].second;
+        distances[i] = std::sqrt(items[i].first);
+    }
+    return items.size();
+}
+
+void KDTree::findInRadius(const Vector3f& pnt,
+                          float radius,
+                          std::vector<index_type>& indices) const
+{
+    Neighbours result;
+    findInRadius(pnt, radius, indices, result);
+}
+
+void KDTree::findInRadius(const Vector3f& pnt,
+                          float radius,
+                          std::vector<index_type>& indices,
+                          Neighbours& result) const
+{
+    result.reset(0, squaredDistance(radius));
+    query(pnt, result);
+    result.sort();
+
+    for (const auto& it : result.getItems()) {
+        indices.push_back(it.second);
+    }
+}
+
+void KDTree::findInBox(const BoundBox3f& box, std::vector<index_type>& indices) const
+{
+    if (nodes.empty()) {
+        return;
+    }
+
+    std::size_t first = indices.size();
+    std::vector<std::size_t> stack {0};
+    while (!stack.empty()) {
+        const Node& item = nodes[stack.back()];
+        std::size_t node = stack.back();
+        stack.pop_back();
+        if (item.axis < 0) {
+            for (index_type pos = item.begin; pos < item.end; pos++) {
+                if (box.IsInBox(entries[pos].point)) {
+                    indices.push_back(entries[pos].index);
+                }
+            }
+            continue;
+        }
+
+        float minValue = box.MinZ;
+        float maxValue = box.MaxZ;
+        if (item.axis == 0) {
+            minValue = box.MinX;
+            maxValue = box.MaxX;
+        }
+        else if (item.axis == 1) {
+            minValue = box.MinY;
+            maxValue = box.MaxY;
+        }
+        if (minValue <= item.split) {
+            stack.push_back(node + 1);
+        }
+        if (maxValue >= item.split) {
+            stack.push_back(item.right);
+        }
+    }
+
+    std::sort(indices.begin() + std::ptrdiff_t(first), indices.end());
+}
+
+void KDTree::findNearest(const Vector3f* queries,
+                         std::size_t count,
+                         std::size_t k,
+                         index_type* indices,
+                         float* distances,
+                         float maxDist,
+                         int threads) const
+{
+    parallelBlocks(count, threads, [&](std::size_t begin, std::size_t end) {
+        Neighbours result;
+        for (std::size_t i = begin; i < end; i++) {
+            findNearest(queries[i], k, indices + i * k, distances + i * k, maxDist, result);
+        }
+    });
+}
+
+void KDTree::findInRadius(const Vector3f* queries,
+                          std::size_t count,
+                          float radius,
+                          std::vector<std::size_t>& offsets,
+                          std::vector<index_type>& indices,
+                          int threads) const
+{
+    // each block collects its neighbours, they are concatenated afterwards
+    std::vector<std::vector<index_type>> blocks((count + BlockSize - 1) / BlockSize);
+    offsets.assign(count + 1, 0);
+    parallelBlocks(count, threads, [&](std::size_t begin, std::size_t end) {
+        std::vector<index_type>& block = blocks[begin / BlockSize];
+        Neighbours result;
+        for (std::size_t i = begin; i < end; i++) {
+            std::size_t size = block.size();
+            findInRadius(queries[i], radius, block, result);
+            offsets[i + 1] = block.size() - size;
+        }
+    });
+
+    for (std::size_t i = 0; i < count; i++) {
+        offsets[i + 1] += offsets[i];
+    }
+    indices.clear();
+    indices.reserve(offsets.back());
+    for (const auto& block : blocks) {
+        indices.insert(indices.end(), block.begin(), block.end());
+    }
+}
@@ -0,0 +1,166 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+
+#ifndef BASE_KDTREE_H
+#define BASE_KDTREE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <FCGlobal.h>
+
+#include "BoundBox.h"
+#include "Vector3D.h"
+
+namespace Base
+{
+
+/**
+ * The KDTree class is a static kd-tree of 3D points for nearest neighbour and range queries.
+ *
+ * The tree is built once from a set of points and can't be modified afterwards. The points are
+ * split at the median of the longest side of a cell, so the shape of the tree only depends on
+ * the number of points. Nodes are stored depth-first in a flat array and the points are copied in
+ * leaf order together with their original index, so a query touches contiguous memory only.
+ * Points with non-finite coordinates are skipped.
+ *
+ * All queries are const and may be run concurrently. The batched variants split the queries
+ * over several threads and write into buffers provided by the caller. Neighbours are sorted by
+ * their distance, ties are broken by the index.
+ */
+class BaseExport KDTree
+{
+public:
+    using index_type = std::uint32_t;
+    static constexpr index_type InvalidIndex = std::numeric_limits<index_type>::max();
+
+    KDTree();
+    explicit KDTree(const std::vector<Vector3f>& points);
+    KDTree(const Vector3f* points, std::size_t count);
+
+    /// Replaces the points of the tree, throws ValueError if there are too many
+    void build(const Vector3f* points, std::size_t count);
+    void clear();
+
+    /// Number of points in the tree
+    std::size_t size() const;
+    bool empty() const;
+    /// Bounding box of the points in the tree
+    const BoundBox3f& getBoundBox() const;
+
+    /** @name Single queries */
+    //@{
+    /** Returns the index of the point nearest to \a pnt within \a maxDist or InvalidIndex if
+     * there is none. The distance is returned in \a dist.
+     */
+    index_type findNearest(const Vector3f& pnt,
+                           float& dist,
+                           float maxDist = std::numeric_limits<float>::max()) const;
+    /** Searches for the \a k nearest points to \a pnt within \a maxDist and writes their indices
+     * and distances to the arrays of size \a k. Returns the number of found points, the remaining
+     * entries are set to InvalidIndex.
+     */
+    std::size_t findNearest(const Vector3f& pnt,
+                            std::size_t k,
+                            index_type* indices,
+                            float* distances,
+                            float maxDist = std::numeric_limits<float>::max()) const;
+    /// Appends the indices of all points within \a radius of \a pnt, sorted by distance
+    void findInRadius(const Vector3f& pnt, float radius, std::vector<index_type>& indices) const;
+    /// Appends the indices of all points inside \a box in ascending order
+    void findInBox(const BoundBox3f& box, std::vector<index_type>& indices) const;
+    //@}
+
+    /** @name Batched queries
+     * \a threads is the number of threads to use, 0 means all cores.
+     */
+    //@{
+    /** Searches for the \a k nearest points of each of the \a count queries. The arrays
+     * \a indices and \a distances must hold \a count * \a k entries, the neighbours of query i
+     * start at i * \a k.
+     */
+    void findNearest(const Vector3f* queries,
+                     std::size_t count,
+                     std::size_t k,
+                     index_type* indices,
+                     float* distances,
+                     float maxDist = std::numeric_limits<float>::max(),
+                     int threads = 0) const;
+    /** Searches for all points within \a radius of each of the \a count queries. The neighbours
+     * of query i are stored in \a indices from \a offsets[i] to \a offsets[i + 1].
+     */
+    void findInRadius(const Vector3f* queries,
+                      std::size_t count,
+                      float radius,
+                      std::vector<std::size_t>& offsets,
+                      std::vector<index_type>& indices,
+                      int threads = 0) const;
+    //@}
+
+private:
+    struct Node
+    {
+        /// Range of the points of the subtree
+        index_type begin {0};
+        index_type end {0};
+        /// Index of the right child, the left child directly follows its parent
+        index_type right {0};
+        /// Split axis or -1 for leaves
+        std::int32_t axis {-1};
+        float split {0.F};
+    };
+    struct Entry
+    {
+        Vector3f point;
+        index_type index {0};
+    };
+    class Neighbours;
+
+    void buildNode(std::size_t node, const BoundBox3f& cell, int parallelDepth);
+    void query(const Vector3f& pnt, Neighbours& result) const;
+    std::size_t findNearest(const Vector3f& pnt,
+                            std::size_t k,
+                            index_type* indices,
+                            float* distances,
+                            float maxDist,
+                            Neighbours& result) const;
+    void findInRadius(const Vector3f& pnt,
+                      float radius,
+                      std::vector<index_type>& indices,
+                      Neighbours& result) const;
+    void search(std::size_t node,
+                const Vector3f& pnt,
+                Vector3f& offset,
+                float cellDist,
+                Neighbours& result) const;
+
+private:
+    std::vector<Node> nodes;
+    std::vector<Entry> entries;
+    BoundBox3f bbox;
+};
+
+}  // namespace Base
+
+
+#endif  // BASE_KDTREE_H
@@ -24,10 +24,14 @@
 #ifndef APP_PERSISTENCE_H
 #define APP_PERSISTENCE_H
 
+#include <memory>
+#include <string>
+
 #include "BaseClass.h"
 
 namespace Base
 {
+class DocFileArchive;
 class Reader;
 class Writer;
 class XMLReader;
@@ -112,6 +116,15 @@ public:
      * ostream).
      */
     virtual void SaveDocFile(Writer& /*writer*/) const;
+    /** Returns true if SaveDocFile() may be called from a worker thread.
+     * The ZipWriter then serializes and compresses the file in parallel with
+     * the other files of the archive. An implementation that returns true must
+     * only read its own data and must not add further files to the writer.
+     */
+    virtual bool canSaveDocFileConcurrently() const
+    {
+        return false;
+    }
     /** This method is used to restore large amounts of data from a file
      * In this method you simply stream in your SaveDocFile() saved data.
      * Again you have to apply for the call of this method in the Restore() call:
@@ -142,6 +155,16 @@ public:
      * @see Base::Reader,Base::XMLReader
      */
     virtual void RestoreDocFile(Reader& /*reader*/);
+    /** Restore the file on demand instead of while the document is read.
+     * An object that supports it keeps the archive and the file name and
+     * calls DocFileArchive::restoreDocFile() once its data is accessed.
+     * @return true if the object takes care of restoring the file
+     */
+    virtual bool deferRestoreDocFile(const std::shared_ptr<DocFileArchive>& /*archive*/,
+                                     const std::string& /*fileName*/)
+    {
+        return false;
+    }
     /// Encodes an attribute upon saving.
     static std::string encodeAttribute(const std::string&);
 
@@ -60,7 +60,11 @@
 
 // STL
 #include <algorithm>
+#include <atomic>
 #include <bitset>
+#include <condition_variable>
+#include <deque>
+#include <future>
 #include <iomanip>
 #include <list>
 #include <limits>
@@ -73,6 +77,7 @@
 #include <stack>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
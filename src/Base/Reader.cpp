@@ -37,8 +37,10 @@
 #include "Reader.h"
 #include "Base64.h"
 #include "Base64Filter.h"
+#include "BinaryXML.h"
 #include "Console.h"
 #include "Exception.h"
+#include "FileInfo.h"
 #include "InputSource.h"
 #include "Persistence.h"
 #include "Sequencer.h"
@@ -48,6 +50,7 @@
 #ifdef _MSC_VER
 #include <zipios++/zipios-config.h>
 #endif
+#include <zipios++/zipfile.h>
 #include <zipios++/zipinputstream.h>
 #include <boost/iostreams/filtering_stream.hpp>
 
@@ -74,6 +77,19 @@ Base::XMLReader::XMLReader(const char* FileName, std::istream& str)
     str.imbue(std::locale::classic());
 #endif
 
+    // a binary encoded document is decoded without the XML parser
+    if (isBinaryXML(str)) {
+        try {
+            binaryReader = std::make_unique<BinaryXMLReader>(str);
+            ReadType = StartDocument;
+            _valid = true;
+        }
+        catch (const Base::Exception& e) {
+            cerr << "Exception message is: \n" << e.what() << "\n";
+        }
+        return;
+    }
+
     // create the parser
     parser = XMLReaderFactory::createXMLReader();  // NOLINT
 
@@ -160,6 +176,11 @@ bool Base::XMLReader::read()
 {
     ReadType = None;
 
+    if (binaryReader) {
+        readBinary();
+        return true;
+    }
+
     try {
         parser->parseNext(token);
     }
@@ -183,6 +204,80 @@ bool Base::XMLReader::read()
     return true;
 }
 
+namespace
+{
+
+// Xerces counts the characters in UTF-16 code units and not in bytes
+unsigned int countUtf16Units(const std::string& str)
+{
+    unsigned int count = 0;
+    for (char c : str) {
+        auto byte = static_cast<unsigned char>(c);
+        // continuation bytes don't start a new character
+        if ((byte & 0xC0) != 0x80) {
+            count++;
+        }
+        // a four byte sequence is a surrogate pair
+        if (byte >= 0xF0) {
+            count++;
+        }
+    }
+    return count;
+}
+
+}  // namespace
+
+void Base::XMLReader::readBinary()
+{
+    // this mirrors the handlers of the SAX interface below
+    auto token = binaryReader->next();
+    switch (token) {
+        case BinaryXMLReader::Token::StartElement:
+        case BinaryXMLReader::Token::EmptyElement:
+            LocalName = binaryReader->getName();
+            AttrMap.clear();
+            for (const auto& [name, value] : binaryReader->getAttributes()) {
+                AttrMap[name] = value;
+            }
+            if (token == BinaryXMLReader::Token::StartElement) {
+                Level++;
+                ReadType = StartElement;
+            }
+            else {
+                ReadType = StartEndElement;
+            }
+            break;
+        case BinaryXMLReader::Token::EndElement:
+            Level--;
+            LocalName = binaryReader->getName();
+            ReadType = EndElement;
+            break;
+        case BinaryXMLReader::Token::Characters:
+            Characters = binaryReader->getCharacters();
+            CharacterCount += countUtf16Units(Characters);
+            ReadType = Chars;
+            break;
+        case BinaryXMLReader::Token::StartCDATA:
+            // Xerces reports a whole CDATA section in one step
+            Characters.clear();
+            while ((token = binaryReader->next()) == BinaryXMLReader::Token::Characters) {
+                Characters += binaryReader->getCharacters();
+            }
+            if (token != BinaryXMLReader::Token::EndCDATA) {
+                throw Base::XMLParseException("Unterminated CDATA section");
+            }
+            CharacterCount += countUtf16Units(Characters);
+            ReadType = EndCDATA;
+            break;
+        case BinaryXMLReader::Token::EndCDATA:
+            ReadType = EndCDATA;
+            break;
+        case BinaryXMLReader::Token::EndDocument:
+            ReadType = EndDocument;
+            break;
+    }
+}
+
 void Base::XMLReader::readElement(const char* ElementName)
 {
     bool ok {};
@@ -406,6 +501,10 @@ void Base::XMLReader::readFiles(zipios::ZipInputStream& zipstream) const
     // up. In this case the associated GUI document asks for its file which is not part of the ZIP
     // file, then.
     // In either case it's guaranteed that the order of the files is kept.
+    if (Archive) {
+        Archive->setFileVersion(FileVersion);
+    }
+
     zipios::ConstEntryPointer entry;
     try {
         entry = zipstream.getNextEntry();
@@ -426,7 +525,12 @@ void Base::XMLReader::readFiles(zipios::ZipInputStream& zipstream) const
         }
         // If this condition is true both file names match and we can read-in the data, otherwise
         // no file name for the current entry in the zip was registered.
-        if (jt != FileList.end()) {
+        if (jt != FileList.end() && Archive
+            && jt->Object->deferRestoreDocFile(Archive, jt->FileName)) {
+            // the object restores the file when needed
+            it = jt + 1;
+        }
+        else if (jt != FileList.end()) {
             try {
                 Base::Reader reader(zipstream, jt->FileName, FileVersion);
                 jt->Object->RestoreDocFile(reader);
@@ -461,6 +565,11 @@ void Base::XMLReader::readFiles(zipios::ZipInputStream& zipstream) const
     }
 }
 
+void Base::XMLReader::setDocFileArchive(std::shared_ptr<DocFileArchive> archive)
+{
+    Archive = std::move(archive);
+}
+
 const char* Base::XMLReader::addFile(const char* Name, Base::Persistence* Object)
 {
     FileEntry temp;
@@ -687,3 +796,64 @@ std::shared_ptr<Base::XMLReader> Base::Reader::getLocalReader() const
 {
     return (this->localreader);
 }
+
+// ---------------------------------------------------------------------------
+
+Base::DocFileArchive::DocFileArchive(const std::string& fileName, bool ownsFile)
+    : fileName(fileName)
+    , ownsFile(ownsFile)
+{}
+
+Base::DocFileArchive::~DocFileArchive()
+{
+    if (ownsFile) {
+        zipFile.reset();
+        Base::FileInfo(fileName).deleteFile();
+    }
+}
+
+void Base::DocFileArchive::setFileVersion(int version)
+{
+    fileVersion = version;
+}
+
+int Base::DocFileArchive::getFileVersion() const
+{
+    return fileVersion;
+}
+
+bool Base::DocFileArchive::restoreDocFile(const std::string& name, Base::Persistence* obj) const
+{
+    std::unique_ptr<std::istream> str;
+    {
+        // the central directory is read once, each entry gets its own file stream
+        std::lock_guard<std::mutex> lock(mutex);
+        try {
+            if (!zipFile) {
+                zipFile = std::make_unique<zipios::ZipFile>(fileName);
+            }
+            str.reset(zipFile->getInputStream(name));
+        }
+        catch (const std::exception& e) {
+            Base::Console().Error("Cannot open %s in %s: %s\n",
+                                  name.c_str(),
+                                  fileName.c_str(),
+                                  e.what());
+            return false;
+        }
+    }
+    if (!str) {
+        Base::Console().Error("File %s not found in %s\n", name.c_str(), fileName.c_str());
+        return false;
+    }
+
+    try {
+        Base::Reader reader(*str, name, fileVersion);
+        obj->RestoreDocFile(reader);
+    }
+    catch (...) {
+        Base::Console().Error("Reading failed from embedded file: %s\n", name.c_str());
+        return false;
+    }
+    return true;
+}
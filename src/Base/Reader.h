@@ -26,6 +26,7 @@
 #include <bitset>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -39,6 +40,7 @@
 
 namespace zipios
 {
+class ZipFile;
 class ZipInputStream;
 }
 #ifndef XERCES_CPP_NAMESPACE_BEGIN
@@ -59,8 +61,41 @@ XERCES_CPP_NAMESPACE_END
 
 namespace Base
 {
+class BinaryXMLReader;
 class Persistence;
 
+/** The DocFileArchive class
+ * Gives random access to the files of a document archive. It's used to
+ * restore the files of objects on demand after the document has been read.
+ * If \a ownsFile is true the archive is a private copy that is removed
+ * together with this object.
+ * \see Persistence::deferRestoreDocFile()
+ */
+class BaseExport DocFileArchive
+{
+public:
+    explicit DocFileArchive(const std::string& fileName, bool ownsFile = false);
+    ~DocFileArchive();
+
+    /// Version of the file format, set by the XMLReader that reads the document
+    void setFileVersion(int version);
+    int getFileVersion() const;
+    /// Calls RestoreDocFile() of the object, returns false if it has failed
+    bool restoreDocFile(const std::string& name, Persistence* obj) const;
+
+    DocFileArchive(const DocFileArchive&) = delete;
+    DocFileArchive(DocFileArchive&&) = delete;
+    DocFileArchive& operator=(const DocFileArchive&) = delete;
+    DocFileArchive& operator=(DocFileArchive&&) = delete;
+
+private:
+    mutable std::mutex mutex;
+    mutable std::unique_ptr<zipios::ZipFile> zipFile;
+    std::string fileName;
+    int fileVersion {0};
+    bool ownsFile;
+};
+
 /** The XML reader class
  * This is an important helper class for the store and retrieval system
  * of objects in FreeCAD. These classes mainly inherit the App::Persitance
@@ -138,7 +173,9 @@ public:
         PartialRestoreInProperty = 2,        // Local to the Property
         PartialRestoreInObject = 3           // Local to the object partially restored itself
     };
-    /// open the file and read the first element
+    /** open the file and read the first element
+     * The document may also be binary encoded, see Base::convertXMLToBinary()
+     */
     XMLReader(const char* FileName, std::istream&);
     ~XMLReader() override;
 
@@ -251,6 +288,11 @@ public:
     const char* addFile(const char* Name, Base::Persistence* Object);
     /// process the requested file writes
     void readFiles(zipios::ZipInputStream& zipstream) const;
+    /** Set the archive that objects can use to restore their files later.
+     * If set, objects that accept it in Persistence::deferRestoreDocFile()
+     * are skipped in readFiles().
+     */
+    void setDocFileArchive(std::shared_ptr<DocFileArchive> archive);
     /// Returns whether reader has any registered filenames
     bool hasFilenames() const;
     /// returns true if reading the file \a filename has failed
@@ -283,6 +325,8 @@ public:
 protected:
     /// read the next element
     bool read();
+    /// read the next element of a binary encoded document
+    void readBinary();
 
     // -----------------------------------------------------------------------
     //  Handlers for the SAX ContentHandler interface
@@ -350,8 +394,9 @@ private:
 
 
     FileInfo _File;
-    XERCES_CPP_NAMESPACE_QUALIFIER SAX2XMLReader* parser;
+    XERCES_CPP_NAMESPACE_QUALIFIER SAX2XMLReader* parser {nullptr};
     XERCES_CPP_NAMESPACE_QUALIFIER XMLPScanToken token;
+    std::unique_ptr<BinaryXMLReader> binaryReader;
     bool _valid {false};
     bool _verbose {true};
 
@@ -365,6 +410,7 @@ public:
 
 private:
     mutable std::vector<std::string> FailedFiles;
+    std::shared_ptr<DocFileArchive> Archive;
 
     std::bitset<32> StatusBits;
 
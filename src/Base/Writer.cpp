@@ -23,8 +23,12 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <set>
+#include <thread>
 #include <vector>
 #include <string>
 #endif
@@ -32,10 +36,12 @@
 #include <limits>
 #include <locale>
 #include <iomanip>
+#include <zlib.h>
 
 #include "Writer.h"
 #include "Base64.h"
 #include "Base64Filter.h"
+#include "BinaryXML.h"
 #include "Exception.h"
 #include "FileInfo.h"
 #include "Persistence.h"
@@ -316,40 +322,162 @@ void Writer::putNextEntry(const char* file, const char* obj)
 
 // ----------------------------------------------------------------------------
 
-ZipWriter::ZipWriter(const char* FileName)
-    : ZipStream(FileName)
+namespace
+{
+
+void setupZipStream(std::ostream& str)
 {
 #ifdef _MSC_VER
-    ZipStream.imbue(std::locale::empty());
+    str.imbue(std::locale::empty());
 #else
-    ZipStream.imbue(std::locale::classic());
+    str.imbue(std::locale::classic());
 #endif
-    ZipStream.precision(std::numeric_limits<double>::digits10 + 1);
-    ZipStream.setf(std::ios::fixed, std::ios::floatfield);
+    str.precision(std::numeric_limits<double>::digits10 + 1);
+    str.setf(std::ios::fixed, std::ios::floatfield);
+}
+
+/// Writer used to serialize a single file on a worker thread
+class EntryWriter: public Writer
+{
+public:
+    EntryWriter()
+    {
+        setupZipStream(StrStream);
+    }
+    std::ostream& Stream() override
+    {
+        return StrStream;
+    }
+    void writeFiles() override
+    {
+        if (!FileList.empty()) {
+            addError("Nested files are not supported when saving concurrently");
+        }
+    }
+    std::string getString() const
+    {
+        return StrStream.str();
+    }
+
+private:
+    std::ostringstream StrStream;
+};
+
+/// A zip member that is serialized and deflated independently of the others
+struct ZipMember
+{
+    std::string FileName;
+    const Persistence* Object {nullptr};
+    bool SerializeConcurrently {false};
+    bool Done {false};
+    std::string Data;
+    std::string Compressed;
+    uLong Crc {0};
+    std::size_t Size {0};
+    std::vector<std::string> Errors;
+};
+
+// the sizes of a zip entry are 32 bit as zip64 extensions aren't supported
+constexpr std::size_t maxZipEntrySize = std::numeric_limits<zipios::uint32>::max();
+
+void deflateMember(ZipMember& member, int level)
+{
+    member.Size = member.Data.size();
+    if (member.Size > maxZipEntrySize) {
+        std::string().swap(member.Data);
+        return;
+    }
+
+    const auto* input = reinterpret_cast<const Bytef*>(member.Data.data());
+    const auto size = static_cast<uInt>(member.Size);
+    member.Crc = crc32(crc32(0, Z_NULL, 0), input, size);
+
+    z_stream zs {};
+    // windowBits < 0 omits the zlib header as required by the zip format
+    if (deflateInit2(&zs, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        member.Errors.emplace_back("Failed to initialize compression of " + member.FileName);
+        return;
+    }
+    member.Compressed.resize(deflateBound(&zs, size));
+    zs.next_in = const_cast<Bytef*>(input);  // NOLINT
+    zs.avail_in = size;
+    zs.next_out = reinterpret_cast<Bytef*>(member.Compressed.data());
+    zs.avail_out = static_cast<uInt>(member.Compressed.size());
+    if (deflate(&zs, Z_FINISH) != Z_STREAM_END) {
+        member.Errors.emplace_back("Failed to compress " + member.FileName);
+    }
+    member.Compressed.resize(zs.total_out);
+    deflateEnd(&zs);
+
+    // release the uncompressed data as early as possible
+    std::string().swap(member.Data);
+}
+
+}  // namespace
+
+ZipWriter::ZipWriter(const char* FileName)
+    : ZipStream(FileName)
+{
+    setupZipStream(ZipStream);
 }
 
 ZipWriter::ZipWriter(std::ostream& os)
     : ZipStream(os)
 {
-#ifdef _MSC_VER
-    ZipStream.imbue(std::locale::empty());
-#else
-    ZipStream.imbue(std::locale::classic());
-#endif
-    ZipStream.precision(std::numeric_limits<double>::digits10 + 1);
-    ZipStream.setf(std::ios::fixed, std::ios::floatfield);
+    setupZipStream(ZipStream);
 }
 
 void ZipWriter::putNextEntry(const char* file, const char* obj)
 {
+    writeBinaryXML();
+
     Writer::putNextEntry(file, obj);
 
     ZipStream.putNextEntry(file);
 
     Writer::checkErrNo();
+
+    // the XML text is encoded chunk by chunk while it's written
+    if (!WritingFiles && getMode("BinaryXML") && FileInfo(file).hasExtension("xml")) {
+        XMLBuffer = std::make_unique<BinaryXMLStreambuf>(ZipStream);
+        XMLStream = std::make_unique<std::ostream>(XMLBuffer.get());
+        setupZipStream(*XMLStream);
+        EntryStream = XMLStream.get();
+    }
+}
+
+void ZipWriter::writeBinaryXML()
+{
+    if (!XMLStream) {
+        return;
+    }
+
+    EntryStream = nullptr;
+    std::unique_ptr<BinaryXMLStreambuf> buf = std::move(XMLBuffer);
+    XMLStream.reset();
+    try {
+        buf->finish();
+    }
+    catch (const Base::Exception& e) {
+        addError(ObjectName + ": " + e.what());
+    }
 }
 
 void ZipWriter::writeFiles()
+{
+    writeBinaryXML();
+    Base::StateLocker guard(WritingFiles);
+
+    unsigned int numThreads = std::thread::hardware_concurrency();
+    if (numThreads > 1 && FileList.size() > 1) {
+        writeFilesConcurrently(numThreads);
+    }
+    else {
+        writeFilesSerial();
+    }
+}
+
+void ZipWriter::writeFilesSerial()
 {
     // use a while loop because it is possible that while
     // processing the files new ones can be added
@@ -364,8 +492,157 @@ void ZipWriter::writeFiles()
     }
 }
 
+void ZipWriter::writeFilesConcurrently(unsigned int numThreads)
+{
+    std::mutex mutex;
+    std::condition_variable cond;
+
+    // Files can be requested while serializing others, so process them in
+    // batches until no further one is added. Members are always written in
+    // the order they have been requested because the reader relies on it.
+    // Only a limited number of members is processed ahead of the one that is
+    // written next to bound the memory of the buffers.
+    const size_t maxInFlight = 2 * size_t(numThreads);
+    size_t index = 0;
+    while (index < FileList.size()) {
+        std::deque<ZipMember> members;
+        for (; index < FileList.size(); ++index) {
+            ZipMember member;
+            member.FileName = FileList[index].FileName;
+            member.Object = FileList[index].Object;
+            member.SerializeConcurrently = member.Object->canSaveDocFileConcurrently();
+            members.push_back(std::move(member));
+        }
+
+        std::deque<ZipMember*> queue;
+        bool closed = false;
+
+        auto work = [&]() {
+            for (;;) {
+                ZipMember* member = nullptr;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cond.wait(lock, [&]() {
+                        return closed || !queue.empty();
+                    });
+                    if (queue.empty()) {
+                        return;
+                    }
+                    member = queue.front();
+                    queue.pop_front();
+                }
+                try {
+                    if (member->SerializeConcurrently) {
+                        EntryWriter writer;
+                        writer.setModes(getModes());
+                        writer.setForceXML(isForceXML());
+                        writer.setFileVersion(getFileVersion());
+                        writer.ObjectName = member->FileName;
+                        member->Object->SaveDocFile(writer);
+                        writer.writeFiles();
+                        member->Data = writer.getString();
+                        auto errors = writer.getErrors();
+                        member->Errors.insert(member->Errors.end(), errors.begin(), errors.end());
+                    }
+                    deflateMember(*member, Level);
+                }
+                catch (const Base::Exception& e) {
+                    member->Errors.emplace_back(e.what());
+                }
+                catch (const std::exception& e) {
+                    member->Errors.emplace_back(e.what());
+                }
+                catch (...) {
+                    member->Errors.emplace_back("Unknown exception while saving "
+                                                + member->FileName);
+                }
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    member->Done = true;
+                }
+                cond.notify_all();
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(numThreads);
+        for (unsigned int i = 0; i < numThreads; ++i) {
+            threads.emplace_back(work);
+        }
+        auto stop = [&]() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                closed = true;
+            }
+            cond.notify_all();
+            for (auto& thread : threads) {
+                thread.join();
+            }
+        };
+
+        // The objects that can't be serialized concurrently may depend on the
+        // calling thread, e.g. to access Python or the GUI, so only their
+        // compression is done by a worker.
+        auto dispatch = [&](ZipMember& member) {
+            if (!member.SerializeConcurrently) {
+                std::ostringstream str;
+                setupZipStream(str);
+                Writer::putNextEntry(member.FileName.c_str());
+                indent = 0;
+                indBuf[0] = 0;
+                EntryStream = &str;
+                member.Object->SaveDocFile(*this);
+                EntryStream = nullptr;
+                member.Data = str.str();
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                queue.push_back(&member);
+            }
+            cond.notify_one();
+        };
+
+        try {
+            size_t next = 0;
+            for (size_t i = 0; i < members.size(); ++i) {
+                for (; next < members.size() && next - i < maxInFlight; ++next) {
+                    dispatch(members[next]);
+                }
+
+                ZipMember& member = members[i];
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cond.wait(lock, [&]() {
+                        return member.Done;
+                    });
+                }
+                for (const auto& error : member.Errors) {
+                    addError(error);
+                }
+                if (member.Size > maxZipEntrySize || member.Compressed.size() > maxZipEntrySize) {
+                    throw Base::FileException(
+                        ("Exceeds the 4 GiB limit of a zip entry: " + member.FileName).c_str());
+                }
+                ZipStream.putCompressedEntry(zipios::ZipCDirEntry(member.FileName),
+                                             member.Compressed.data(),
+                                             static_cast<zipios::uint32>(member.Compressed.size()),
+                                             static_cast<zipios::uint32>(member.Size),
+                                             static_cast<zipios::uint32>(member.Crc));
+                std::string().swap(member.Compressed);
+            }
+        }
+        catch (...) {
+            EntryStream = nullptr;
+            stop();
+            throw;
+        }
+        stop();
+    }
+}
+
 ZipWriter::~ZipWriter()
 {
+    writeBinaryXML();
     ZipStream.close();
 }
 
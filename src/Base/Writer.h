@@ -40,6 +40,7 @@
 namespace Base
 {
 
+class BinaryXMLStreambuf;
 class Persistence;
 
 
@@ -205,11 +206,23 @@ public:
     explicit ZipWriter(std::ostream&);
     ~ZipWriter() override;
 
+    /** Starts a new zip member.
+     * If the 'BinaryXML' mode is set, members with the extension 'xml' that
+     * are started directly, like Document.xml, are binary encoded while they
+     * are written. Files written in writeFiles() are always stored as they are.
+     */
+    void putNextEntry(const char* filename, const char* objName = nullptr) override;
+    /** Writes the requested files.
+     * The files are deflated on a pool of worker threads and written as
+     * independent zip members in the order they have been requested. Objects
+     * that return true in Persistence::canSaveDocFileConcurrently() are also
+     * serialized on the pool, all others are serialized on the calling thread.
+     */
     void writeFiles() override;
 
     std::ostream& Stream() override
     {
-        return ZipStream;
+        return EntryStream ? *EntryStream : ZipStream;
     }
 
     void setComment(const char* str)
@@ -218,17 +231,27 @@ public:
     }
     void setLevel(int level)
     {
+        Level = level;
         ZipStream.setLevel(level);
     }
-    void putNextEntry(const char* filename, const char* objName = nullptr) override;
 
     ZipWriter(const ZipWriter&) = delete;
     ZipWriter(ZipWriter&&) = delete;
     ZipWriter& operator=(const ZipWriter&) = delete;
     ZipWriter& operator=(ZipWriter&&) = delete;
 
+private:
+    void writeFilesSerial();
+    void writeFilesConcurrently(unsigned int numThreads);
+    void writeBinaryXML();
+
 private:
     zipios::ZipOutputStream ZipStream;
+    std::ostream* EntryStream {nullptr};
+    std::unique_ptr<BinaryXMLStreambuf> XMLBuffer;
+    std::unique_ptr<std::ostream> XMLStream;
+    bool WritingFiles {false};
+    int Level {6};
 };
 
 /** The StringWriter class
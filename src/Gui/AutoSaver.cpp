@@ -35,6 +35,7 @@
 #include <App/Application.h>
 #include <App/Document.h>
 #include <App/DocumentObject.h>
+#include <App/RecoveryJournal.h>
 #include <Base/Console.h>
 #include <Base/FileInfo.h>
 #include <Base/Stream.h>
@@ -200,24 +201,46 @@ void AutoSaver::saveDocument(const std::string& name, AutoSaveProperty& saver)
                 std::string fn = doc->TransientDir.getValue();
                 fn += "/fc_recovery_file.fcstd";
                 Base::FileInfo tmp(fn);
-                Base::ofstream file(tmp, std::ios::out | std::ios::binary);
-                if (file.is_open())
-                {
-                    Base::ZipWriter writer(file);
-                    if (hGrp->GetBool("SaveBinaryBrep", true))
-                        writer.setMode("BinaryBrep");
 
-                    writer.setComment("AutoRecovery file");
-                    writer.setLevel(1); // apparently the fastest compression
-                    writer.putNextEntry("Document.xml");
-
-                    doc->Save(writer);
-
-                    // Special handling for Gui document.
-                    doc->signalSaveDocument(writer);
-
-                    // write additional files
-                    writer.writeFiles();
+                // Once the recovery file exists only the changes are appended to the
+                // journal until it exceeds the size limit, then the recovery file is
+                // rewritten completely.
+                auto& journal = *saver.journal;
+                journal.setFileName(std::string(doc->TransientDir.getValue())
+                                    + "/fc_recovery_journal.fcj");
+                std::uintmax_t limit =
+                    std::uintmax_t(hGrp->GetUnsigned("AutoSaveJournalSize", 64)) * 1024 * 1024;
+                if (saver.checkpoint && limit > 0 && tmp.exists()
+                        && journal.size() < limit && journal.append()) {
+                    FC_LOG("auto saver appended to " << journal.getFileName());
+                }
+                else {
+                    // the journal always refers to the latest recovery file
+                    journal.reset();
+                    saver.checkpoint = false;
+
+                    Base::ofstream file(tmp, std::ios::out | std::ios::binary);
+                    if (file.is_open())
+                    {
+                        {
+                            Base::ZipWriter writer(file);
+                            if (hGrp->GetBool("SaveBinaryBrep", true))
+                                writer.setMode("BinaryBrep");
+
+                            writer.setComment("AutoRecovery file");
+                            writer.setLevel(1); // apparently the fastest compression
+                            writer.putNextEntry("Document.xml");
+
+                            doc->Save(writer);
+
+                            // Special handling for Gui document.
+                            doc->signalSaveDocument(writer);
+
+                            // write additional files
+                            writer.writeFiles();
+                        }
+                        saver.checkpoint = true;
+                    }
                 }
             }
         }
@@ -246,7 +269,9 @@ void AutoSaver::timerEvent(QTimerEvent * event)
 
 // ----------------------------------------------------------------------------
 
-AutoSaveProperty::AutoSaveProperty(const App::Document* doc) : timerId(-1)
+AutoSaveProperty::AutoSaveProperty(const App::Document* doc)
+  : timerId(-1)
+  , journal(std::make_unique<App::RecoveryJournal>(doc, std::string()))
 {
     //NOLINTBEGIN
     documentNew = const_cast<App::Document*>(doc)->signalNewObject.connect
@@ -27,6 +27,7 @@
 #include <QObject>
 
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <boost/signals2.hpp>
@@ -36,6 +37,7 @@ namespace App {
 class Document;
 class DocumentObject;
 class Property;
+class RecoveryJournal;
 }
 
 namespace Gui {
@@ -50,6 +52,10 @@ public:
     std::set<std::string> touched;
     std::string dirName;
     std::map<std::string, std::string> fileMap;
+    /// Changes since the last compressed recovery file
+    std::unique_ptr<App::RecoveryJournal> journal;
+    /// Set when the compressed recovery file has been written by this session
+    bool checkpoint {false};
 
 private:
     void slotNewObject(const App::DocumentObject&);
@@ -23,6 +23,7 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+# include <algorithm>
 # include <tuple>
 # include <memory>
 # include <list>
@@ -516,6 +517,8 @@ Document::Document(App::Document* pcDocument,Application * app)
         d->_pcDocument->setUndoMode(1);
         // set the maximum stack size
         d->_pcDocument->setMaxUndoStackSize(hGrp->GetInt("MaxUndoSize",20));
+        // set the memory limit in MB, older steps are spilled to disk
+        d->_pcDocument->setUndoLimit(std::size_t(std::max(hGrp->GetInt("MaxUndoMemory",0), 0L)) * 1024 * 1024);
     }
 
     d->_changeViewTouchDocument = hGrp->GetBool("ChangeViewProviderTouchDocument", true);
@@ -49,6 +49,7 @@
 
 #include <App/Application.h>
 #include <App/Document.h>
+#include <App/RecoveryJournal.h>
 #include <Base/Exception.h>
 #include <Gui/Application.h>
 #include <Gui/Command.h>
@@ -296,6 +297,15 @@ void DocumentRecovery::accept()
                 d->writeRecoveryInfo(info);
             }
             else {
+                // apply the changes made after the compressed recovery file was written
+                QFileInfo pfi(info.projectFile);
+                QString journal = pfi.dir().absoluteFilePath(QStringLiteral("fc_recovery_journal.fcj"));
+                if (pfi.fileName() == QLatin1String("fc_recovery_file.fcstd") && QFile::exists(journal)) {
+                    int records = App::RecoveryJournal::replay(docs[i], journal.toUtf8().constData());
+                    FC_LOG("Replayed " << records << " records of recovery journal of '"
+                            << docs[i]->Label.getValue() << "'");
+                }
+
                 auto gdoc = Application::Instance->getDocument(docs[i]);
                 if (gdoc)
                     gdoc->setModified(true);
@@ -315,6 +325,13 @@ void DocumentRecovery::accept()
                 if (fi.fileName() == QLatin1String("fc_recovery_file.fcstd")) {
                     transDir.remove(fi.fileName());
                     res = transDir.rename(fi.absoluteFilePath(),fi.fileName());
+
+                    // the journal belongs to the recovery file
+                    QFileInfo jfi(fi.dir().absoluteFilePath(QStringLiteral("fc_recovery_journal.fcj")));
+                    if (res && jfi.exists()) {
+                        transDir.remove(jfi.fileName());
+                        res = transDir.rename(jfi.absoluteFilePath(),jfi.fileName());
+                    }
                 }
                 else {
                     transDir.rmdir(fi.dir().dirName());
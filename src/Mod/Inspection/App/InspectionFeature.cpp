@@ -23,16 +23,23 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
-#include <boost/core/ignore_unused.hpp>
+#include <algorithm>
 #include <numeric>
 #include <limits>
+#include <set>
 
+#include <BRepBuilderAPI_Copy.hxx>
 #include <BRepBuilderAPI_MakeVertex.hxx>
 #include <BRepClass3d_SolidClassifier.hxx>
 #include <BRepExtrema_DistShapeShape.hxx>
 #include <BRepGProp_Face.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <Poly_Triangle.hxx>
 #include <TopExp.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
 #include <TopoDS.hxx>
+#include <TopoDS_Face.hxx>
+#include <TopoDS_Vertex.hxx>
 #include <gp_Pnt.hxx>
 
 #include <QEventLoop>
@@ -43,23 +50,22 @@
 
 #include <Base/Console.h>
 #include <Base/FutureWatcherProgress.h>
+#include <Base/KDTree.h>
 #include <Base/Sequencer.h>
 #include <Base/Stream.h>
 
-#include <Mod/Mesh/App/Core/Algorithm.h>
-#include <Mod/Mesh/App/Core/Grid.h>
-#include <Mod/Mesh/App/Core/Iterator.h>
+#include <Mod/Mesh/App/Core/BVH.h>
+#include <Mod/Mesh/App/Core/Elements.h>
 #include <Mod/Mesh/App/Core/MeshKernel.h>
 #include <Mod/Mesh/App/MeshFeature.h>
 #include <Mod/Part/App/PartFeature.h>
+#include <Mod/Part/App/Tools.h>
 #include <Mod/Points/App/PointsFeature.h>
-#include <Mod/Points/App/PointsGrid.h>
 
 #include "InspectionFeature.h"
 
 
 using namespace Inspection;
-namespace sp = std::placeholders;
 
 InspectActualMesh::InspectActualMesh(const Mesh::MeshObject& rMesh)
     : _mesh(rMesh.getKernel())
@@ -145,141 +151,47 @@ Base::Vector3f InspectActualShape::getPoint(unsigned long index) const
 
 // ----------------------------------------------------------------
 
-namespace Inspection
-{
-class MeshInspectGrid: public MeshCore::MeshGrid
+void InspectNominalGeometry::getDistances(const std::vector<Base::Vector3f>& points,
+                                          std::vector<float>& distances) const
 {
-public:
-    MeshInspectGrid(const MeshCore::MeshKernel& mesh, float fGridLen, const Base::Matrix4D& mat)
-        : MeshCore::MeshGrid(mesh)
-        , _transform(mat)
-    {
-        Base::BoundBox3f clBBMesh = _pclMesh->GetBoundBox().Transformed(mat);
-        Rebuild(std::max<unsigned long>((unsigned long)(clBBMesh.LengthX() / fGridLen), 1),
-                std::max<unsigned long>((unsigned long)(clBBMesh.LengthY() / fGridLen), 1),
-                std::max<unsigned long>((unsigned long)(clBBMesh.LengthZ() / fGridLen), 1));
-    }
-
-    void Validate(const MeshCore::MeshKernel& kernel) override
-    {
-        // do nothing
-        boost::ignore_unused(kernel);
-    }
-
-    void Validate()
-    {
-        // do nothing
-    }
-
-    bool Verify() const override
-    {
-        // do nothing
-        return true;
-    }
-
-protected:
-    void CalculateGridLength(int /*iCtGridPerAxis*/) override
-    {
-        // do nothing
+    distances.resize(points.size());
+    for (std::size_t i = 0; i < points.size(); i++) {
+        distances[i] = getDistance(points[i]);
     }
+}
 
-    unsigned long HasElements() const override
-    {
-        return _pclMesh->CountFacets();
-    }
-
-    void Pos(const Base::Vector3f& rclPoint,
-             unsigned long& rulX,
-             unsigned long& rulY,
-             unsigned long& rulZ) const
-    {
-        rulX = (unsigned long)((rclPoint.x - _fMinX) / _fGridLenX);
-        rulY = (unsigned long)((rclPoint.y - _fMinY) / _fGridLenY);
-        rulZ = (unsigned long)((rclPoint.z - _fMinZ) / _fGridLenZ);
-
-        assert((rulX < _ulCtGridsX) && (rulY < _ulCtGridsY) && (rulZ < _ulCtGridsZ));
-    }
+// ----------------------------------------------------------------
 
-    void AddFacet(const MeshCore::MeshGeomFacet& rclFacet, unsigned long ulFacetIndex)
-    {
-        unsigned long ulX1;
-        unsigned long ulY1;
-        unsigned long ulZ1;
-        unsigned long ulX2;
-        unsigned long ulY2;
-        unsigned long ulZ2;
-
-        Base::BoundBox3f clBB;
-        clBB.Add(rclFacet._aclPoints[0]);
-        clBB.Add(rclFacet._aclPoints[1]);
-        clBB.Add(rclFacet._aclPoints[2]);
-
-        Pos(Base::Vector3f(clBB.MinX, clBB.MinY, clBB.MinZ), ulX1, ulY1, ulZ1);
-        Pos(Base::Vector3f(clBB.MaxX, clBB.MaxY, clBB.MaxZ), ulX2, ulY2, ulZ2);
-
-
-        if ((ulX1 < ulX2) || (ulY1 < ulY2) || (ulZ1 < ulZ2)) {
-            for (unsigned long ulX = ulX1; ulX <= ulX2; ulX++) {
-                for (unsigned long ulY = ulY1; ulY <= ulY2; ulY++) {
-                    for (unsigned long ulZ = ulZ1; ulZ <= ulZ2; ulZ++) {
-                        if (rclFacet.IntersectBoundingBox(GetBoundBox(ulX, ulY, ulZ))) {
-                            _aulGrid[ulX][ulY][ulZ].insert(ulFacetIndex);
-                        }
-                    }
-                }
-            }
-        }
-        else {
-            _aulGrid[ulX1][ulY1][ulZ1].insert(ulFacetIndex);
-        }
+namespace
+{
+/**
+ * Returns the distance of \a point to the nearest facet of \a bvh that is not farther away than
+ * \a maxDist. The distance is negative if the point is below the facet.
+ */
+float signedDistanceToMesh(const MeshCore::MeshKernel& mesh,
+                           const MeshCore::MeshFacetBVH& bvh,
+                           const Base::Matrix4D* transform,
+                           const Base::Vector3f& point,
+                           float maxDist)
+{
+    Base::Vector3f nearest;
+    MeshCore::FacetIndex index = bvh.NearestFacetToPoint(point, nearest, maxDist);
+    if (index == MeshCore::FACET_INDEX_MAX) {
+        return std::numeric_limits<float>::max();
     }
 
-    void InitGrid() override
-    {
-        unsigned long i, j;
-
-        Base::BoundBox3f clBBMesh = _pclMesh->GetBoundBox().Transformed(_transform);
-
-        float fLengthX = clBBMesh.LengthX();
-        float fLengthY = clBBMesh.LengthY();
-        float fLengthZ = clBBMesh.LengthZ();
-
-        _fGridLenX = (1.0f + fLengthX) / float(_ulCtGridsX);
-        _fMinX = clBBMesh.MinX - 0.5f;
-
-        _fGridLenY = (1.0f + fLengthY) / float(_ulCtGridsY);
-        _fMinY = clBBMesh.MinY - 0.5f;
-
-        _fGridLenZ = (1.0f + fLengthZ) / float(_ulCtGridsZ);
-        _fMinZ = clBBMesh.MinZ - 0.5f;
-
-        _aulGrid.clear();
-        _aulGrid.resize(_ulCtGridsX);
-        for (i = 0; i < _ulCtGridsX; i++) {
-            _aulGrid[i].resize(_ulCtGridsY);
-            for (j = 0; j < _ulCtGridsY; j++) {
-                _aulGrid[i][j].resize(_ulCtGridsZ);
-            }
-        }
+    MeshCore::MeshGeomFacet geomFace = mesh.GetFacet(index);
+    if (transform) {
+        geomFace.Transform(*transform);
     }
 
-    void RebuildGrid() override
-    {
-        _ulCtElements = _pclMesh->CountFacets();
-        InitGrid();
-
-        unsigned long i = 0;
-        MeshCore::MeshFacetIterator clFIter(*_pclMesh);
-        clFIter.Transform(_transform);
-        for (clFIter.Init(); clFIter.More(); clFIter.Next()) {
-            AddFacet(*clFIter, i++);
-        }
+    float fDist = Base::Distance(point, nearest);
+    if (point.DistanceToPlane(geomFace._aclPoints[0], geomFace.GetNormal()) <= 0) {
+        fDist = -fDist;
     }
-
-private:
-    Base::Matrix4D _transform;
-};
-}  // namespace Inspection
+    return fDist;
+}
+}  // namespace
 
 InspectNominalMesh::InspectNominalMesh(const Mesh::MeshObject& rMesh, float offset)
     : _mesh(rMesh.getKernel())
@@ -288,30 +200,15 @@ InspectNominalMesh::InspectNominalMesh(const Mesh::MeshObject& rMesh, float offs
     _clTrf = rMesh.getTransform();
     _bApply = _clTrf != tmp;
 
-    // Max. limit of grid elements
-    float fMaxGridElements = 8000000.0f;
-    Base::BoundBox3f box = _mesh.GetBoundBox().Transformed(rMesh.getTransform());
-
-    // estimate the minimum allowed grid length
-    float fMinGridLen =
-        (float)pow((box.LengthX() * box.LengthY() * box.LengthZ() / fMaxGridElements), 0.3333f);
-    float fGridLen = 5.0f * MeshCore::MeshAlgorithm(_mesh).GetAverageEdgeLength();
-
-    // We want to avoid to get too small grid elements otherwise building up the grid structure
-    // would take too much time and memory. Having quite a dense grid speeds up more the following
-    // algorithms extremely. Due to the issue above it's always a compromise between speed and
-    // memory usage.
-    fGridLen = std::max<float>(fMinGridLen, fGridLen);
-
-    // build up grid structure to speed up algorithms
-    _pGrid = new MeshInspectGrid(_mesh, fGridLen, rMesh.getTransform());
-    _box = box;
+    // the hierarchy is built with the transformed facets
+    _pBVH = new MeshCore::MeshFacetBVH(_mesh, _clTrf);
+    _box = _pBVH->GetBoundBox();
     _box.Enlarge(offset);
 }
 
 InspectNominalMesh::~InspectNominalMesh()
 {
-    delete this->_pGrid;
+    delete this->_pBVH;
 }
 
 float InspectNominalMesh::getDistance(const Base::Vector3f& point) const
@@ -320,76 +217,37 @@ float InspectNominalMesh::getDistance(const Base::Vector3f& point) const
         return std::numeric_limits<float>::max();  // must be inside bbox
     }
 
-    std::vector<unsigned long> indices;
-    //_pGrid->GetElements(point, indices);
-    if (indices.empty()) {
-        std::set<unsigned long> inds;
-        _pGrid->MeshGrid::SearchNearestFromPoint(point, inds);
-        indices.insert(indices.begin(), inds.begin(), inds.end());
-    }
-
-    float fMinDist = std::numeric_limits<float>::max();
-    bool positive = true;
-    for (unsigned long it : indices) {
-        MeshCore::MeshGeomFacet geomFace = _mesh.GetFacet(it);
-        if (_bApply) {
-            geomFace.Transform(_clTrf);
-        }
-
-        float fDist = geomFace.DistanceToPoint(point);
-        if (fabs(fDist) < fabs(fMinDist)) {
-            fMinDist = fDist;
-            positive = point.DistanceToPlane(geomFace._aclPoints[0], geomFace.GetNormal()) > 0;
-        }
-    }
-
-    if (!positive) {
-        fMinDist = -fMinDist;
-    }
-    return fMinDist;
+    return signedDistanceToMesh(_mesh,
+                                *_pBVH,
+                                _bApply ? &_clTrf : nullptr,
+                                point,
+                                std::numeric_limits<float>::max());
 }
 
 // ----------------------------------------------------------------
 
 InspectNominalFastMesh::InspectNominalFastMesh(const Mesh::MeshObject& rMesh, float offset)
     : _mesh(rMesh.getKernel())
+    , _offset(offset)
 {
-    const MeshCore::MeshKernel& kernel = rMesh.getKernel();
-
     Base::Matrix4D tmp;
     _clTrf = rMesh.getTransform();
     _bApply = _clTrf != tmp;
 
-    // Max. limit of grid elements
-    float fMaxGridElements = 8000000.0f;
-    Base::BoundBox3f box = kernel.GetBoundBox().Transformed(rMesh.getTransform());
-
-    // estimate the minimum allowed grid length
-    float fMinGridLen =
-        (float)pow((box.LengthX() * box.LengthY() * box.LengthZ() / fMaxGridElements), 0.3333f);
-    float fGridLen = 5.0f * MeshCore::MeshAlgorithm(kernel).GetAverageEdgeLength();
-
-    // We want to avoid to get too small grid elements otherwise building up the grid structure
-    // would take too much time and memory. Having quite a dense grid speeds up more the following
-    // algorithms extremely. Due to the issue above it's always a compromise between speed and
-    // memory usage.
-    fGridLen = std::max<float>(fMinGridLen, fGridLen);
-
-    // build up grid structure to speed up algorithms
-    _pGrid = new MeshInspectGrid(kernel, fGridLen, rMesh.getTransform());
-    _box = box;
+    // the hierarchy is built with the transformed facets
+    _pBVH = new MeshCore::MeshFacetBVH(_mesh, _clTrf);
+    _box = _pBVH->GetBoundBox();
     _box.Enlarge(offset);
-    max_level = (unsigned long)(offset / fGridLen);
 }
 
 InspectNominalFastMesh::~InspectNominalFastMesh()
 {
-    delete this->_pGrid;
+    delete this->_pBVH;
 }
 
 /**
- * This algorithm is not that exact as that from InspectNominalMesh but is by
- * factors faster and sufficient for many cases.
+ * Unlike InspectNominalMesh the search is limited to the facets within the offset,
+ * so points farther away are rejected early.
  */
 float InspectNominalFastMesh::getDistance(const Base::Vector3f& point) const
 {
@@ -397,161 +255,231 @@ float InspectNominalFastMesh::getDistance(const Base::Vector3f& point) const
         return std::numeric_limits<float>::max();  // must be inside bbox
     }
 
-    std::set<unsigned long> indices;
-#if 0  // a point in a neighbour grid can be nearer
-    std::vector<unsigned long> elements;
-    _pGrid->GetElements(point, elements);
-    indices.insert(elements.begin(), elements.end());
-#else
-    unsigned long ulX, ulY, ulZ;
-    _pGrid->Position(point, ulX, ulY, ulZ);
-    unsigned long ulLevel = 0;
-    while (indices.empty() && ulLevel <= max_level) {
-        _pGrid->GetHull(ulX, ulY, ulZ, ulLevel++, indices);
-    }
-    if (indices.empty() || ulLevel == 1) {
-        _pGrid->GetHull(ulX, ulY, ulZ, ulLevel, indices);
-    }
-#endif
-
-    float fMinDist = std::numeric_limits<float>::max();
-    bool positive = true;
-    for (unsigned long it : indices) {
-        MeshCore::MeshGeomFacet geomFace = _mesh.GetFacet(it);
-        if (_bApply) {
-            geomFace.Transform(_clTrf);
-        }
-
-        float fDist = geomFace.DistanceToPoint(point);
-        if (fabs(fDist) < fabs(fMinDist)) {
-            fMinDist = fDist;
-            positive = point.DistanceToPlane(geomFace._aclPoints[0], geomFace.GetNormal()) > 0;
-        }
-    }
-
-    if (!positive) {
-        fMinDist = -fMinDist;
-    }
-    return fMinDist;
+    return signedDistanceToMesh(_mesh, *_pBVH, _bApply ? &_clTrf : nullptr, point, _offset);
 }
 
 // ----------------------------------------------------------------
 
 InspectNominalPoints::InspectNominalPoints(const Points::PointKernel& Kernel, float /*offset*/)
-    : _rKernel(Kernel)
 {
-    int uGridPerAxis = 50;  // totally 125.000 grid elements
-    this->_pGrid = new Points::PointsGrid(Kernel, uGridPerAxis);
+    // the tree is built in the local system of the kernel whose placement is rigid
+    this->_pTree = new Base::KDTree(Kernel.getBasicPoints());
+    this->_clInv = Kernel.getTransform();
+    this->_clInv.inverseGauss();
 }
 
 InspectNominalPoints::~InspectNominalPoints()
 {
-    delete this->_pGrid;
+    delete this->_pTree;
 }
 
 float InspectNominalPoints::getDistance(const Base::Vector3f& point) const
 {
-    // TODO: Make faster
-    std::set<unsigned long> indices;
-    unsigned long x, y, z;
-    Base::Vector3d pointd(point.x, point.y, point.z);
-    _pGrid->Position(pointd, x, y, z);
-    _pGrid->GetElements(x, y, z, indices);
-
-    double fMinDist = std::numeric_limits<double>::max();
-    for (unsigned long it : indices) {
-        Base::Vector3d pt = _rKernel.getPoint(it);
-        double fDist = Base::Distance(pointd, pt);
-        if (fDist < fMinDist) {
-            fMinDist = fDist;
-        }
+    float fMinDist {};
+    if (_pTree->findNearest(_clInv * point, fMinDist) == Base::KDTree::InvalidIndex) {
+        return std::numeric_limits<float>::max();
+    }
+
+    return fMinDist;
+}
+
+void InspectNominalPoints::getDistances(const std::vector<Base::Vector3f>& points,
+                                        std::vector<float>& distances) const
+{
+    std::vector<Base::Vector3f> local(points.size());
+    for (std::size_t i = 0; i < points.size(); i++) {
+        local[i] = _clInv * points[i];
     }
 
-    return (float)fMinDist;
+    // the batch is already run in a worker thread
+    std::vector<Base::KDTree::index_type> indices(points.size());
+    distances.resize(points.size());
+    _pTree->findNearest(local.data(),
+                        local.size(),
+                        1,
+                        indices.data(),
+                        distances.data(),
+                        std::numeric_limits<float>::max(),
+                        1);
+    for (std::size_t i = 0; i < points.size(); i++) {
+        if (indices[i] == Base::KDTree::InvalidIndex) {
+            distances[i] = std::numeric_limits<float>::max();
+        }
+    }
 }
 
 // ----------------------------------------------------------------
 
-InspectNominalShape::InspectNominalShape(const TopoDS_Shape& shape, float /*radius*/)
-    : _rShape(shape)
+InspectNominalShape::InspectNominalShape(const TopoDS_Shape& nominal, float offset)
+    : _offset(offset)
 {
-    distss = new BRepExtrema_DistShapeShape();
-    distss->LoadS1(_rShape);
-
-    // When having a solid then use its shell because otherwise the distance
-    // for inner points will always be zero
-    if (!_rShape.IsNull() && _rShape.ShapeType() == TopAbs_SOLID) {
-        TopExp_Explorer xp;
-        xp.Init(_rShape, TopAbs_SHELL);
-        if (xp.More()) {
-            distss->LoadS1(xp.Current());
-            isSolid = true;
-        }
+    _pMesh = new MeshCore::MeshKernel();
+    _pBVH = new MeshCore::MeshFacetBVH();
+
+    // The tessellation is added to the shape and the worker threads query its geometry. So, a
+    // copy is used that doesn't share anything with the shape of the document object.
+    TopoDS_Shape shape;
+    if (!nominal.IsNull()) {
+        BRepBuilderAPI_Copy copy(nominal,
+                                 /*copyGeom*/ Standard_True,
+                                 /*copyMesh*/ Standard_False);
+        shape = copy.Shape();
+    }
+
+    // When having a solid then the inner points get a negative distance
+    if (!shape.IsNull() && shape.ShapeType() == TopAbs_SOLID) {
+        isSolid = true;
+        _solid = shape;
     }
-    // distss->SetDeflection(radius);
+
+    tessellate(shape);
 }
 
 InspectNominalShape::~InspectNominalShape()
 {
-    delete distss;
+    delete _pBVH;
+    delete _pMesh;
 }
 
-float InspectNominalShape::getDistance(const Base::Vector3f& point) const
+void InspectNominalShape::tessellate(const TopoDS_Shape& shape)
 {
-    gp_Pnt pnt3d(point.x, point.y, point.z);
-    BRepBuilderAPI_MakeVertex mkVert(pnt3d);
-    distss->LoadS2(mkVert.Vertex());
+    if (shape.IsNull()) {
+        return;
+    }
 
-    float fMinDist = std::numeric_limits<float>::max();
-    if (distss->Perform() && distss->NbSolution() > 0) {
-        fMinDist = (float)distss->Value();
-        // the shape is a solid, check if the vertex is inside
-        if (isSolid) {
-            if (isInsideSolid(pnt3d)) {
-                fMinDist = -fMinDist;
-            }
+    // A finer tessellation makes the pre-check more selective but costs memory. The deflection
+    // follows the search radius but is limited by the accuracy of the shape.
+    double accuracy = Part::TopoShape(shape).getAccuracy();
+    _deflection = float(std::min(accuracy, std::max(0.5 * _offset, 0.1 * accuracy)));
+    BRepMesh_IncrementalMesh mesher(shape,
+                                    _deflection,
+                                    /*isRelative*/ Standard_False,
+                                    /*theAngDeflection*/ 0.1,
+                                    /*isInParallel*/ Standard_True);
+
+    MeshCore::MeshPointArray points;
+    MeshCore::MeshFacetArray facets;
+    TopTools_IndexedMapOfShape mapOfFaces;
+    TopExp::MapShapes(shape, TopAbs_FACE, mapOfFaces);
+    for (int i = 1; i <= mapOfFaces.Extent(); i++) {
+        const TopoDS_Face& face = TopoDS::Face(mapOfFaces(i));
+        std::vector<gp_Pnt> nodes;
+        std::vector<Poly_Triangle> triangles;
+        if (!Part::Tools::getTriangulation(face, nodes, triangles)) {
+            continue;
         }
-        else if (fMinDist > 0) {
-            // check if the distance was computed from a face
-            if (isBelowFace(pnt3d)) {
-                fMinDist = -fMinDist;
-            }
+
+        auto base = MeshCore::PointIndex(points.size());
+        for (const auto& node : nodes) {
+            points.emplace_back(float(node.X()), float(node.Y()), float(node.Z()));
+        }
+        for (const auto& triangle : triangles) {
+            Standard_Integer n1 {}, n2 {}, n3 {};
+            triangle.Get(n1, n2, n3);
+            facets.emplace_back(base + n1, base + n2, base + n3);
+            _faceOfFacet.push_back(static_cast<unsigned long>(_faces.size()));
         }
+        _faces.push_back(face);
     }
-    return fMinDist;
+
+    // the facet order is kept, so the facet indices refer to _faceOfFacet
+    _pMesh->Merge(points, facets);
+    _pBVH->Rebuild(*_pMesh);
 }
 
-bool InspectNominalShape::isInsideSolid(const gp_Pnt& pnt3d) const
+float InspectNominalShape::getDistance(const Base::Vector3f& point) const
 {
-    const Standard_Real tol = 0.001;
-    BRepClass3d_SolidClassifier classifier(_rShape);
-    classifier.Perform(pnt3d, tol);
-    return (classifier.State() == TopAbs_IN);
+    if (_pBVH->IsEmpty()) {
+        return std::numeric_limits<float>::max();
+    }
+
+    // the distance to the tessellation differs from the exact distance by the deflection
+    float fDist = signedDistanceToMesh(*_pMesh,
+                                       *_pBVH,
+                                       nullptr,
+                                       point,
+                                       std::numeric_limits<float>::max());
+    bool inside = isSolid ? _pBVH->IsInside(point) : fDist < 0;
+    if (std::fabs(fDist) > _offset + _deflection) {
+        return inside ? -std::fabs(fDist) : std::fabs(fDist);
+    }
+
+    return getExactDistance(point, std::fabs(fDist), inside);
 }
 
-bool InspectNominalShape::isBelowFace(const gp_Pnt& pnt3d) const
+float InspectNominalShape::getExactDistance(const Base::Vector3f& point,
+                                            float distance,
+                                            bool inside) const
 {
-    // check if the distance was computed from a face
-    for (Standard_Integer index = 1; index <= distss->NbSolution(); index++) {
-        if (distss->SupportTypeShape1(index) == BRepExtrema_IsInFace) {
-            TopoDS_Shape face = distss->SupportOnShape1(index);
-            Standard_Real u, v;
-            distss->ParOnFaceS1(index, u, v);
-            // gp_Pnt pnt = distss->PointOnShape1(index);
-            BRepGProp_Face props(TopoDS::Face(face));
+    // Every face nearer than the nearest triangle plus the deflection has a triangle within
+    // twice the deflection
+    float range = distance + 2.0F * _deflection;
+    Base::BoundBox3f box(point.x - range,
+                         point.y - range,
+                         point.z - range,
+                         point.x + range,
+                         point.y + range,
+                         point.z + range);
+    std::vector<MeshCore::FacetIndex> facets;
+    _pBVH->Inside(box, facets);
+    std::set<unsigned long> faces;
+    for (MeshCore::FacetIndex facet : facets) {
+        faces.insert(_faceOfFacet[facet]);
+    }
+
+    gp_Pnt pnt3d(point.x, point.y, point.z);
+    TopoDS_Vertex vertex = BRepBuilderAPI_MakeVertex(pnt3d).Vertex();
+
+    float fMinDist = std::numeric_limits<float>::max();
+    bool below = false;
+    for (unsigned long index : faces) {
+        const TopoDS_Face& face = _faces[index];
+        // the shared face is only read, the algorithm is local to this call
+        BRepExtrema_DistShapeShape distss(face, vertex);
+        if (!distss.IsDone() || distss.NbSolution() == 0 || distss.Value() >= fMinDist) {
+            continue;
+        }
+
+        fMinDist = float(distss.Value());
+        below = false;
+        // check if the distance was computed from the inner of the face
+        if (distss.SupportTypeShape1(1) == BRepExtrema_IsInFace) {
+            Standard_Real u {}, v {};
+            distss.ParOnFaceS1(1, u, v);
+            BRepGProp_Face props(face);
             gp_Vec normal;
             gp_Pnt center;
             props.Normal(u, v, center, normal);
             gp_Vec dir(center, pnt3d);
-            Standard_Real scalar = normal.Dot(dir);
-            if (scalar < 0) {
-                return true;
-            }
-            break;
+            below = normal.Dot(dir) < 0;
         }
     }
 
-    return false;
+    if (fMinDist == std::numeric_limits<float>::max()) {
+        fMinDist = distance;
+        below = inside;
+    }
+
+    // The tessellation deviates from the surface by up to the deflection, so a point that is
+    // nearer to the surface may lie on the other side of the triangles
+    if (isSolid && fMinDist <= 2.0F * _deflection) {
+        inside = isInsideSolid(point);
+    }
+
+    // the shape is a solid, the sign is given by the inside test
+    if (isSolid ? inside : below) {
+        fMinDist = -fMinDist;
+    }
+    return fMinDist;
+}
+
+bool InspectNominalShape::isInsideSolid(const Base::Vector3f& point) const
+{
+    // the classifier keeps state, so each call uses its own
+    const Standard_Real tol = 0.001;
+    BRepClass3d_SolidClassifier classifier(_solid);
+    classifier.Perform(gp_Pnt(point.x, point.y, point.z), tol);
+    return (classifier.State() == TopAbs_IN);
 }
 
 // ----------------------------------------------------------------
@@ -699,44 +627,6 @@ unsigned int PropertyDistanceList::getMemSize() const
 
 namespace Inspection
 {
-// helper class to use Qt's concurrent framework
-struct DistanceInspection
-{
-
-    DistanceInspection(float radius,
-                       InspectActualGeometry* a,
-                       std::vector<InspectNominalGeometry*> n)
-        : radius(radius)
-        , actual(a)
-        , nominal(n)
-    {}
-    float mapped(unsigned long index) const
-    {
-        Base::Vector3f pnt = actual->getPoint(index);
-
-        float fMinDist = std::numeric_limits<float>::max();
-        for (auto it : nominal) {
-            float fDist = it->getDistance(pnt);
-            if (fabs(fDist) < fabs(fMinDist)) {
-                fMinDist = fDist;
-            }
-        }
-
-        if (fMinDist > this->radius) {
-            fMinDist = std::numeric_limits<float>::max();
-        }
-        else if (-fMinDist > this->radius) {
-            fMinDist = -std::numeric_limits<float>::max();
-        }
-
-        return fMinDist;
-    }
-
-    float radius;
-    InspectActualGeometry* actual;
-    std::vector<InspectNominalGeometry*> nominal;
-};
-
 // Helper internal class for QtConcurrent map operation. Holds sums-of-squares and counts for RMS
 // calculation
 class DistanceInspectionRMS
@@ -761,6 +651,122 @@ public:
 };
 }  // namespace Inspection
 
+// ----------------------------------------------------------------
+
+DistanceInspection::DistanceInspection(float radius,
+                                       const InspectActualGeometry& actual,
+                                       const std::vector<InspectNominalGeometry*>& nominals)
+    : radius(radius)
+    , actual(actual)
+    , nominals(nominals)
+{}
+
+void DistanceInspection::cancel()
+{
+    canceled = true;
+}
+
+bool DistanceInspection::isCanceled() const
+{
+    return canceled;
+}
+
+bool DistanceInspection::perform()
+{
+    unsigned long count = actual.countPoints();
+    distances.assign(count, 0.0F);
+    rms = 0.0;
+
+    std::vector<unsigned long> chunks;
+    for (unsigned long start = 0; start < count; start += ChunkSize) {
+        chunks.push_back(start);
+    }
+
+    std::function<DistanceInspectionRMS(unsigned long)> fMap = [&](unsigned long start) {
+        DistanceInspectionRMS res;
+        // the chunks that are scheduled after cancelling are skipped
+        if (isCanceled()) {
+            return res;
+        }
+
+        unsigned long end = std::min(count, start + ChunkSize);
+        std::vector<Base::Vector3f> points;
+        points.reserve(end - start);
+        for (unsigned long index = start; index < end; index++) {
+            points.push_back(actual.getPoint(index));
+        }
+
+        std::vector<float> minDist(points.size(), std::numeric_limits<float>::max());
+        std::vector<float> dists;
+        for (auto it : nominals) {
+            it->getDistances(points, dists);
+            for (std::size_t i = 0; i < points.size(); i++) {
+                if (fabs(dists[i]) < fabs(minDist[i])) {
+                    minDist[i] = dists[i];
+                }
+            }
+        }
+
+        for (std::size_t i = 0; i < points.size(); i++) {
+            float fMinDist = minDist[i];
+            if (fMinDist > radius) {
+                fMinDist = std::numeric_limits<float>::max();
+            }
+            else if (-fMinDist > radius) {
+                fMinDist = -std::numeric_limits<float>::max();
+            }
+            else {
+                res.m_sumsq += fMinDist * fMinDist;
+                res.m_numv++;
+            }
+
+            distances[start + i] = fMinDist;
+        }
+        return res;
+    };
+
+    // Perform map-reduce operation : compute distances and update sum of squares for RMS
+    // computation
+    QFuture<DistanceInspectionRMS> future =
+        QtConcurrent::mappedReduced(chunks, fMap, &DistanceInspectionRMS::operator+=);
+    // Setup progress bar
+    Base::FutureWatcherProgress progress("Inspecting...", chunks.size());
+    QFutureWatcher<DistanceInspectionRMS> watcher;
+    QObject::connect(&watcher,
+                     &QFutureWatcher<DistanceInspectionRMS>::progressValueChanged,
+                     &progress,
+                     &Base::FutureWatcherProgress::progressValueChanged);
+    // Stop scheduling further chunks when the user cancels the operation
+    QObject::connect(&watcher,
+                     &QFutureWatcher<DistanceInspectionRMS>::progressValueChanged,
+                     &watcher,
+                     [this, &watcher](int) {
+                         if (Base::Sequencer().wasCanceled()) {
+                             cancel();
+                             watcher.cancel();
+                         }
+                     });
+    // Keep UI responsive during computation
+    QEventLoop loop;
+    QObject::connect(&watcher,
+                     &QFutureWatcher<DistanceInspectionRMS>::finished,
+                     &loop,
+                     &QEventLoop::quit);
+    watcher.setFuture(future);
+    loop.exec();
+    // without an application the event loop returns at once
+    future.waitForFinished();
+
+    if (isCanceled() || future.isCanceled()) {
+        return false;
+    }
+
+    rms = future.result().getRMS();
+    return true;
+}
+
+// ----------------------------------------------------------------
+
 PROPERTY_SOURCE(Inspection::Feature, App::DocumentObject)
 
 Feature::Feature()
@@ -793,8 +799,6 @@ short Feature::mustExecute() const
 
 App::DocumentObjectExecReturn* Feature::execute()
 {
-    bool useMultithreading = true;
-
     App::DocumentObject* pcActual = Actual.getValue();
     if (!pcActual) {
         throw Base::ValueError("No actual geometry to inspect specified");
@@ -810,7 +814,6 @@ App::DocumentObjectExecReturn* Feature::execute()
         actual = new InspectActualPoints(pts->Points.getValue());
     }
     else if (pcActual->isDerivedFrom<Part::Feature>()) {
-        useMultithreading = false;
         Part::Feature* part = static_cast<Part::Feature*>(pcActual);
         actual = new InspectActualShape(part->Shape.getShape());
     }
@@ -833,7 +836,6 @@ App::DocumentObjectExecReturn* Feature::execute()
             nominal = new InspectNominalPoints(pts->Points.getValue(), this->SearchRadius.getValue());
         }
         else if (it->isDerivedFrom<Part::Feature>()) {
-            useMultithreading = false;
             Part::Feature* part = static_cast<Part::Feature*>(it);
             nominal = new InspectNominalShape(part->Shape.getValue(), this->SearchRadius.getValue());
         }
@@ -844,141 +846,27 @@ App::DocumentObjectExecReturn* Feature::execute()
     }
     // clang-format on
 
-#if 0
-#if 1  // test with some huge data sets
-    std::vector<unsigned long> index(actual->countPoints());
-    std::generate(index.begin(), index.end(), Base::iotaGen<unsigned long>(0));
-    DistanceInspection check(this->SearchRadius.getValue(), actual, inspectNominal);
-    QFuture<float> future = QtConcurrent::mapped
-        (index, std::bind(&DistanceInspection::mapped, &check, sp::_1));
-    //future.waitForFinished(); // blocks the GUI
-    Base::FutureWatcherProgress progress("Inspecting...", actual->countPoints());
-    QFutureWatcher<float> watcher;
-    QObject::connect(&watcher, &QFutureWatcher<float>::progressValueChanged,
-                     &progress, &Base::FutureWatcherProgress::progressValueChanged);
-
-    // keep it responsive during computation
-    QEventLoop loop;
-    QObject::connect(&watcher, &QFutureWatcher::finished, &loop, &QEventLoop::quit);
-    watcher.setFuture(future);
-    loop.exec();
-
-    std::vector<float> vals;
-    vals.insert(vals.end(), future.begin(), future.end());
-#else
-    DistanceInspection insp(this->SearchRadius.getValue(), actual, inspectNominal);
-    unsigned long count = actual->countPoints();
-    std::stringstream str;
-    str << "Inspecting " << this->Label.getValue() << "...";
-    Base::SequencerLauncher seq(str.str().c_str(), count);
-
-    std::vector<float> vals(count);
-    for (unsigned long index = 0; index < count; index++) {
-        float fMinDist = insp.mapped(index);
-        vals[index] = fMinDist;
-        seq.next();
+    float radius = this->SearchRadius.getValue();
+    DistanceInspection inspection(radius, *actual, inspectNominal);
+    bool canceled = !inspection.perform();
+    if (!canceled) {
+        Base::Console().Message("RMS value for '%s' with search radius [%.4f,%.4f] is: %.4f\n",
+                                this->Label.getValue(),
+                                -radius,
+                                radius,
+                                inspection.getRMS());
+        Distances.setValues(inspection.getDistances());
     }
-#endif
-
-    Distances.setValues(vals);
-
-    float fRMS = 0;
-    int countRMS = 0;
-    for (std::vector<float>::iterator it = vals.begin(); it != vals.end(); ++it) {
-        if (fabs(*it) < std::numeric_limits<float>::max()) {
-            fRMS += (*it) * (*it);
-            countRMS++;
-        }
-    }
-
-    if (countRMS > 0) {
-        fRMS = fRMS / countRMS;
-        fRMS = sqrt(fRMS);
-    }
-
-    Base::Console().Message("RMS value for '%s' with search radius [%.4f,%.4f] is: %.4f\n",
-        this->Label.getValue(), -this->SearchRadius.getValue(), this->SearchRadius.getValue(), fRMS);
-#else
-    unsigned long count = actual->countPoints();
-    std::vector<float> vals(count);
-    std::function<DistanceInspectionRMS(int)> fMap = [&](unsigned int index) {
-        DistanceInspectionRMS res;
-        Base::Vector3f pnt = actual->getPoint(index);
-
-        float fMinDist = std::numeric_limits<float>::max();
-        for (auto it : inspectNominal) {
-            float fDist = it->getDistance(pnt);
-            if (fabs(fDist) < fabs(fMinDist)) {
-                fMinDist = fDist;
-            }
-        }
-
-        if (fMinDist > this->SearchRadius.getValue()) {
-            fMinDist = std::numeric_limits<float>::max();
-        }
-        else if (-fMinDist > this->SearchRadius.getValue()) {
-            fMinDist = -std::numeric_limits<float>::max();
-        }
-        else {
-            res.m_sumsq += fMinDist * fMinDist;
-            res.m_numv++;
-        }
-
-        vals[index] = fMinDist;
-        return res;
-    };
-
-    DistanceInspectionRMS res;
-
-    if (useMultithreading) {
-        // Build vector of increasing indices
-        std::vector<unsigned long> index(count);
-        std::iota(index.begin(), index.end(), 0);
-        // Perform map-reduce operation : compute distances and update sum of squares for RMS
-        // computation
-        QFuture<DistanceInspectionRMS> future =
-            QtConcurrent::mappedReduced(index, fMap, &DistanceInspectionRMS::operator+=);
-        // Setup progress bar
-        Base::FutureWatcherProgress progress("Inspecting...", actual->countPoints());
-        QFutureWatcher<DistanceInspectionRMS> watcher;
-        QObject::connect(&watcher,
-                         &QFutureWatcher<DistanceInspectionRMS>::progressValueChanged,
-                         &progress,
-                         &Base::FutureWatcherProgress::progressValueChanged);
-        // Keep UI responsive during computation
-        QEventLoop loop;
-        QObject::connect(&watcher,
-                         &QFutureWatcher<DistanceInspectionRMS>::finished,
-                         &loop,
-                         &QEventLoop::quit);
-        watcher.setFuture(future);
-        loop.exec();
-        res = future.result();
-    }
-    else {
-        // Single-threaded operation
-        std::stringstream str;
-        str << "Inspecting " << this->Label.getValue() << "...";
-        Base::SequencerLauncher seq(str.str().c_str(), count);
-
-        for (unsigned int i = 0; i < count; i++) {
-            res += fMap(i);
-        }
-    }
-
-    Base::Console().Message("RMS value for '%s' with search radius [%.4f,%.4f] is: %.4f\n",
-                            this->Label.getValue(),
-                            -this->SearchRadius.getValue(),
-                            this->SearchRadius.getValue(),
-                            res.getRMS());
-    Distances.setValues(vals);
-#endif
 
     delete actual;
     for (auto it : inspectNominal) {
         delete it;
     }
 
+    if (canceled) {
+        return new App::DocumentObjectExecReturn("Inspection canceled");
+    }
+
     return nullptr;
 }
 
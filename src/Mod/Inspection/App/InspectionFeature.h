@@ -23,6 +23,10 @@
 #ifndef INSPECTION_FEATURE_H
 #define INSPECTION_FEATURE_H
 
+#include <atomic>
+#include <vector>
+#include <TopoDS_Shape.hxx>
+
 #include <App/DocumentObject.h>
 #include <App/DocumentObjectGroup.h>
 
@@ -30,23 +34,21 @@
 #include <Mod/Points/App/Points.h>
 
 
-class TopoDS_Shape;
-class BRepExtrema_DistShapeShape;
-class gp_Pnt;
+class TopoDS_Face;
 
 namespace MeshCore
 {
 class MeshKernel;
-class MeshGrid;
+class MeshFacetBVH;
 }  // namespace MeshCore
 
-namespace Mesh
+namespace Base
 {
-class MeshObject;
+class KDTree;
 }
-namespace Points
+namespace Mesh
 {
-class PointsGrid;
+class MeshObject;
 }
 namespace Part
 {
@@ -114,6 +116,12 @@ public:
     InspectNominalGeometry() = default;
     virtual ~InspectNominalGeometry() = default;
     virtual float getDistance(const Base::Vector3f&) const = 0;
+    /** Computes the distances of a batch of points. The default implementation calls
+     * getDistance() for each point, sub-classes may override it to share work between
+     * the points of a batch. The method is called concurrently for different batches.
+     */
+    virtual void getDistances(const std::vector<Base::Vector3f>& points,
+                              std::vector<float>& distances) const;
 };
 
 class InspectionExport InspectNominalMesh: public InspectNominalGeometry
@@ -125,7 +133,7 @@ public:
 
 private:
     const MeshCore::MeshKernel& _mesh;
-    MeshCore::MeshGrid* _pGrid;
+    MeshCore::MeshFacetBVH* _pBVH;
     Base::BoundBox3f _box;
     bool _bApply;
     Base::Matrix4D _clTrf;
@@ -140,9 +148,9 @@ public:
 
 protected:
     const MeshCore::MeshKernel& _mesh;
-    MeshCore::MeshGrid* _pGrid;
+    MeshCore::MeshFacetBVH* _pBVH;
     Base::BoundBox3f _box;
-    unsigned long max_level;
+    float _offset;
     bool _bApply;
     Base::Matrix4D _clTrf;
 };
@@ -153,12 +161,21 @@ public:
     InspectNominalPoints(const Points::PointKernel&, float offset);
     ~InspectNominalPoints() override;
     float getDistance(const Base::Vector3f&) const override;
+    void getDistances(const std::vector<Base::Vector3f>& points,
+                      std::vector<float>& distances) const override;
 
 private:
-    const Points::PointKernel& _rKernel;
-    Points::PointsGrid* _pGrid;
+    Base::KDTree* _pTree;
+    /// transforms the inspected points into the local system of the kernel
+    Base::Matrix4D _clInv;
 };
 
+/**
+ * The shape is tessellated once and the distance to the nearest triangle is looked up in a
+ * bounding volume hierarchy. Only for points whose distance may be within the search radius the
+ * exact distance is computed, and only to the faces whose triangles are near enough.
+ * A private copy of the shape is tessellated, so the shape passed in is left untouched.
+ */
 class InspectionExport InspectNominalShape: public InspectNominalGeometry
 {
 public:
@@ -167,13 +184,65 @@ public:
     float getDistance(const Base::Vector3f&) const override;
 
 private:
-    bool isInsideSolid(const gp_Pnt&) const;
-    bool isBelowFace(const gp_Pnt&) const;
+    void tessellate(const TopoDS_Shape&);
+    float getExactDistance(const Base::Vector3f&, float distance, bool inside) const;
+    bool isInsideSolid(const Base::Vector3f&) const;
 
 private:
-    BRepExtrema_DistShapeShape* distss;
-    const TopoDS_Shape& _rShape;
+    /// the triangles of all faces
+    MeshCore::MeshKernel* _pMesh;
+    MeshCore::MeshFacetBVH* _pBVH;
+    /// the face of each triangle
+    std::vector<unsigned long> _faceOfFacet;
+    std::vector<TopoDS_Face> _faces;
+    /// the maximum deviation of the triangles from the faces
+    float _deflection {0.0F};
+    float _offset;
     bool isSolid {false};
+    TopoDS_Shape _solid;
+};
+
+/**
+ * Computes the signed distances of the actual points to the nearest nominal. The points are
+ * handed to the nominals in chunks, so that they get batches of points and the overhead of
+ * scheduling is small compared to the work of a chunk.
+ */
+class InspectionExport DistanceInspection
+{
+public:
+    /// Number of points in a chunk
+    static constexpr unsigned long ChunkSize = 4096;
+
+    DistanceInspection(float radius,
+                       const InspectActualGeometry& actual,
+                       const std::vector<InspectNominalGeometry*>& nominals);
+
+    /** Computes the distances of the chunks concurrently and returns false if the inspection
+     * has been canceled. Distances beyond the search radius are set to +/- FLT_MAX.
+     * While waiting for the chunks the events are processed and the progress is shown.
+     */
+    bool perform();
+    /// Stops the inspection, chunks that are not started yet are skipped. It's thread-safe.
+    void cancel();
+    bool isCanceled() const;
+
+    const std::vector<float>& getDistances() const
+    {
+        return distances;
+    }
+    /// Root mean square of the distances within the search radius
+    double getRMS() const
+    {
+        return rms;
+    }
+
+private:
+    float radius;
+    const InspectActualGeometry& actual;
+    std::vector<InspectNominalGeometry*> nominals;
+    std::vector<float> distances;
+    double rms {0.0};
+    std::atomic<bool> canceled {false};
 };
 
 class InspectionExport PropertyDistanceList: public App::PropertyLists
@@ -35,20 +35,26 @@
 #ifdef _PreComp_
 
 // STL
+#include <algorithm>
+#include <limits>
 #include <numeric>
+#include <set>
 
 // OCC
+#include <BRepBuilderAPI_Copy.hxx>
 #include <BRepBuilderAPI_MakeVertex.hxx>
 #include <BRepClass3d_SolidClassifier.hxx>
 #include <BRepExtrema_DistShapeShape.hxx>
 #include <BRepGProp_Face.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <Poly_Triangle.hxx>
 #include <TopExp.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
 #include <TopoDS.hxx>
+#include <TopoDS_Face.hxx>
+#include <TopoDS_Vertex.hxx>
 #include <gp_Pnt.hxx>
 
-// boost
-#include <boost/core/ignore_unused.hpp>
-
 // Qt
 #include <QEventLoop>
 #include <QFuture>
@@ -36,6 +36,7 @@
 #include <Base/PyWrapParseTupleAndKeywords.h>
 #include <Base/VectorPy.h>
 #include "Core/Approximation.h"
+#include "Core/Decimation.h"
 #include "Core/Evaluation.h"
 #include "Core/Iterator.h"
 #include "Core/MeshIO.h"
@@ -112,6 +113,14 @@ public:
             "volume oriented box containing all points. The return value is a\n"
             "tuple of seven items:\n"
             "    center, u, v, w directions and the lengths of the three vectors.\n");
+        add_varargs_method(
+            "simplifyFile",
+            &Module::simplifyFile,
+            "simplifyFile(input, output, [reduction=0.5, tolerance=0.0, memory=1024])\n"
+            "Simplifies the mesh of a binary STL or PLY file without loading it at once\n"
+            "and writes the result to a binary STL file. The mesh is processed in\n"
+            "parallel chunks so that memory in MB limits the used memory.\n"
+            "Returns the number of written facets.\n");
         initialize("The functions in this module allow working with mesh objects.\n"
                    "A set of functions are provided for reading in registered mesh\n"
                    "file formats to either a new or existing document.\n"
@@ -627,6 +636,40 @@ private:
 
         return result;  // NOLINT
     }
+    Py::Object simplifyFile(const Py::Tuple& args)
+    {
+        char* inputName {};
+        char* outputName {};
+        float reduction = 0.5F;
+        float tolerance = 0.0F;
+        unsigned long memory = 1024;
+        if (!PyArg_ParseTuple(args.ptr(),
+                              "etet|ffk",
+                              "utf-8",
+                              &inputName,
+                              "utf-8",
+                              &outputName,
+                              &reduction,
+                              &tolerance,
+                              &memory)) {
+            throw Py::Exception();
+        }
+
+        std::string input(inputName);
+        PyMem_Free(inputName);
+        std::string output(outputName);
+        PyMem_Free(outputName);
+
+        if (reduction < 0.0F || reduction >= 1.0F) {
+            throw Py::ValueError("Reduction must be in the range [0, 1)");
+        }
+
+        MeshCore::MeshStreamSimplify simplify;
+        simplify.SetReduction(reduction);
+        simplify.SetTolerance(tolerance);
+        simplify.SetMemoryBudget(std::size_t(memory) << 20);
+        return Py::Long(static_cast<unsigned long>(simplify.simplify(input, output)));
+    }
 };
 
 PyObject* initModule()
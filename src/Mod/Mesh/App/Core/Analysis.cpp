@@ -0,0 +1,272 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#endif
+
+#include "Analysis.h"
+#include "Evaluation.h"
+#include "Functional.h"
+#include "MeshKernel.h"
+
+
+using namespace MeshCore;
+
+namespace
+{
+// see MeshEvalSelfIntersection, facets with a common vertex aren't tested
+bool shareCommonVertex(const MeshFacet& rface1, const MeshFacet& rface2)
+{
+    for (PointIndex pt1 : rface1._aulPoints) {
+        if (pt1 == rface2._aulPoints[0] || pt1 == rface2._aulPoints[1]
+            || pt1 == rface2._aulPoints[2]) {
+            return true;
+        }
+    }
+    return false;
+}
+}  // namespace
+
+MeshAnalysis::MeshAnalysis(const MeshKernel& rclMesh, float fEpsilon)
+    : _rclMesh(rclMesh)
+    , _fEpsilon(fEpsilon)
+    , _numFacets(rclMesh.CountFacets())
+{}
+
+void MeshAnalysis::SetThreads(int threads)
+{
+    _threads = threads;
+}
+
+void MeshAnalysis::CheckCount()
+{
+    // a cheap guard against modifications that were not reported
+    if (_numFacets != _rclMesh.CountFacets()) {
+        Invalidate();
+    }
+}
+
+const MeshFacetBVH& MeshAnalysis::GetBVH()
+{
+    CheckCount();
+    if (!_validBVH) {
+        _bvh.Rebuild(_rclMesh);
+        _validBVH = true;
+    }
+    return _bvh;
+}
+
+bool MeshAnalysis::HasSelfIntersections()
+{
+    return !GetSelfIntersections().empty();
+}
+
+const std::vector<std::pair<FacetIndex, FacetIndex>>& MeshAnalysis::GetSelfIntersections()
+{
+    const MeshFacetBVH& bvh = GetBVH();
+    if (_validSelfIntersections) {
+        return _selfIntersections;
+    }
+
+    const MeshFacetArray& rFaces = _rclMesh.GetFacets();
+    std::mutex mutex;
+    _selfIntersections.clear();
+    int threads = _threads > 0 ? _threads : int(std::thread::hardware_concurrency());
+    parallel_for(
+        rFaces.size(),
+        [&](std::size_t begin, std::size_t end) {
+            std::vector<std::pair<FacetIndex, FacetIndex>> pairs;
+            std::vector<FacetIndex> elements;
+            Base::Vector3f pt1, pt2;
+            for (FacetIndex index = begin; index < end; index++) {
+                MeshGeomFacet facet1 = _rclMesh.GetFacet(index);
+                elements.clear();
+                bvh.Inside(facet1.GetBoundBox(), elements);
+
+                const MeshFacet& rface1 = rFaces[index];
+                for (FacetIndex jndex : elements) {
+                    // test each pair only once and skip the identical facet
+                    if (jndex <= index || shareCommonVertex(rface1, rFaces[jndex])) {
+                        continue;
+                    }
+                    MeshGeomFacet facet2 = _rclMesh.GetFacet(jndex);
+                    if (facet1.IntersectWithFacet(facet2, pt1, pt2) == 2) {
+                        pairs.emplace_back(index, jndex);
+                    }
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            _selfIntersections.insert(_selfIntersections.end(), pairs.begin(), pairs.end());
+        },
+        threads);
+
+    // same order as MeshEvalSelfIntersection::GetIntersections()
+    std::sort(_selfIntersections.begin(), _selfIntersections.end());
+    _validSelfIntersections = true;
+    return _selfIntersections;
+}
+
+bool MeshAnalysis::HasNonManifolds()
+{
+    return !GetNonManifolds().empty();
+}
+
+const std::list<std::vector<FacetIndex>>& MeshAnalysis::GetNonManifolds()
+{
+    CheckCount();
+    if (!_validNonManifolds) {
+        MeshEvalTopology eval(_rclMesh);
+        eval.Evaluate();
+        _nonManifolds = eval.GetFacets();
+        _validNonManifolds = true;
+    }
+    return _nonManifolds;
+}
+
+bool MeshAnalysis::HasDegeneratedFacets()
+{
+    return !GetDegeneratedFacets().empty();
+}
+
+const std::vector<FacetIndex>& MeshAnalysis::GetDegeneratedFacets()
+{
+    CheckCount();
+    if (_validDegenerated) {
+        return _degenerated;
+    }
+
+    std::size_t numFacets = _rclMesh.CountFacets();
+    std::vector<char> degenerated(numFacets, 0);
+    int threads = _threads > 0 ? _threads : int(std::thread::hardware_concurrency());
+    parallel_for(
+        numFacets,
+        [&](std::size_t begin, std::size_t end) {
+            for (FacetIndex index = begin; index < end; index++) {
+                degenerated[index] = _rclMesh.GetFacet(index).IsDegenerated(_fEpsilon) ? 1 : 0;
+            }
+        },
+        threads);
+
+    _degenerated.clear();
+    for (FacetIndex index = 0; index < numFacets; index++) {
+        if (degenerated[index]) {
+            _degenerated.push_back(index);
+        }
+    }
+    _validDegenerated = true;
+    return _degenerated;
+}
+
+void MeshAnalysis::RemoveFacets(const std::vector<FacetIndex>& raulFacets)
+{
+    if (raulFacets.empty()) {
+        return;
+    }
+
+    // new index of each facet, FACET_INDEX_MAX for the removed ones
+    std::vector<FacetIndex> remap(_numFacets, 0);
+    unsigned long numRemoved = 0;
+    for (FacetIndex index : raulFacets) {
+        if (index < _numFacets && remap[index] != FACET_INDEX_MAX) {
+            remap[index] = FACET_INDEX_MAX;
+            numRemoved++;
+        }
+    }
+    _numFacets -= numRemoved;
+    if (_numFacets != _rclMesh.CountFacets()) {
+        // the facets don't match the modification of the mesh
+        Invalidate();
+        return;
+    }
+
+    FacetIndex next = 0;
+    for (FacetIndex& index : remap) {
+        if (index != FACET_INDEX_MAX) {
+            index = next++;
+        }
+    }
+
+    if (_validBVH) {
+        _bvh.RemoveFacets(raulFacets);
+    }
+
+    // the remap is monotonic, so the order of the results is kept
+    if (_validSelfIntersections) {
+        std::vector<std::pair<FacetIndex, FacetIndex>> pairs;
+        pairs.reserve(_selfIntersections.size());
+        for (const auto& it : _selfIntersections) {
+            FacetIndex index1 = remap[it.first];
+            FacetIndex index2 = remap[it.second];
+            if (index1 != FACET_INDEX_MAX && index2 != FACET_INDEX_MAX) {
+                pairs.emplace_back(index1, index2);
+            }
+        }
+        _selfIntersections.swap(pairs);
+    }
+
+    if (_validNonManifolds) {
+        for (auto it = _nonManifolds.begin(); it != _nonManifolds.end();) {
+            std::vector<FacetIndex> facets;
+            for (FacetIndex index : *it) {
+                if (remap[index] != FACET_INDEX_MAX) {
+                    facets.push_back(remap[index]);
+                }
+            }
+            // an edge with up to two facets is manifold again
+            if (facets.size() > 2) {
+                it->swap(facets);
+                ++it;
+            }
+            else {
+                it = _nonManifolds.erase(it);
+            }
+        }
+    }
+
+    if (_validDegenerated) {
+        std::vector<FacetIndex> facets;
+        facets.reserve(_degenerated.size());
+        for (FacetIndex index : _degenerated) {
+            if (remap[index] != FACET_INDEX_MAX) {
+                facets.push_back(remap[index]);
+            }
+        }
+        _degenerated.swap(facets);
+    }
+}
+
+void MeshAnalysis::Invalidate()
+{
+    _numFacets = _rclMesh.CountFacets();
+    _validBVH = false;
+    _validSelfIntersections = false;
+    _validNonManifolds = false;
+    _validDegenerated = false;
+    _bvh.Clear();
+    _selfIntersections.clear();
+    _nonManifolds.clear();
+    _degenerated.clear();
+}
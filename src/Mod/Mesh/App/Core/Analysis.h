@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+#ifndef MESH_ANALYSIS_H
+#define MESH_ANALYSIS_H
+
+#include <list>
+#include <vector>
+
+#include "BVH.h"
+#include "Definitions.h"
+
+
+namespace MeshCore
+{
+
+class MeshKernel;
+
+/**
+ * The MeshAnalysis class keeps the results of the expensive mesh checks between the
+ * steps of a repair loop.
+ *
+ * The facet hierarchy, the pairs of self-intersecting facets, the facets at
+ * non-manifold edges and the degenerated facets are computed on first access. Removing
+ * facets can neither create a self-intersection nor a non-manifold edge nor a
+ * degenerated facet. So if a repair step only removed facets, e.g. MeshFixTopology or
+ * MeshFixSelfIntersection, and the removed facets are passed to RemoveFacets() the
+ * cached results are renumbered instead of computed again. The facet neighbourhood is
+ * kept up to date by MeshKernel::DeleteFacets() itself. After any other modification
+ * of the mesh Invalidate() must be called.
+ */
+class MeshExport MeshAnalysis
+{
+public:
+    /// \a fEpsilon is the tolerance of the check for degenerated facets
+    explicit MeshAnalysis(const MeshKernel& rclMesh,
+                          float fEpsilon = MeshDefinitions::_fMinPointDistanceP2);
+
+    /// Sets the number of threads, 0 uses all cores
+    void SetThreads(int);
+
+    /** @name Results */
+    //@{
+    /// Returns the hierarchy over the facets of the mesh.
+    const MeshFacetBVH& GetBVH();
+    bool HasSelfIntersections();
+    /// Returns all pairs of intersecting facets, see MeshEvalSelfIntersection
+    const std::vector<std::pair<FacetIndex, FacetIndex>>& GetSelfIntersections();
+    bool HasNonManifolds();
+    /// Returns the facets of each non-manifold edge, see MeshEvalTopology
+    const std::list<std::vector<FacetIndex>>& GetNonManifolds();
+    bool HasDegeneratedFacets();
+    /// Returns all degenerated facets, see MeshEvalDegeneratedFacets
+    const std::vector<FacetIndex>& GetDegeneratedFacets();
+    //@}
+
+    /** @name Modification */
+    //@{
+    /**
+     * Must be called after the facets \a raulFacets were removed from the mesh with
+     * MeshKernel::DeleteFacets(). The cached results are renumbered accordingly.
+     */
+    void RemoveFacets(const std::vector<FacetIndex>& raulFacets);
+    /// Discards all cached results.
+    void Invalidate();
+    //@}
+
+private:
+    void CheckCount();
+
+private:
+    const MeshKernel& _rclMesh;
+    float _fEpsilon;
+    int _threads {0};
+    /// Number of facets the cached results refer to
+    unsigned long _numFacets {0};
+
+    bool _validBVH {false};
+    bool _validSelfIntersections {false};
+    bool _validNonManifolds {false};
+    bool _validDegenerated {false};
+
+    MeshFacetBVH _bvh;
+    std::vector<std::pair<FacetIndex, FacetIndex>> _selfIntersections;
+    std::list<std::vector<FacetIndex>> _nonManifolds;
+    std::vector<FacetIndex> _degenerated;
+};
+
+}  // namespace MeshCore
+
+
+#endif  // MESH_ANALYSIS_H
@@ -24,6 +24,7 @@
 
 #ifndef _PreComp_
 #include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <iterator>
 #include <limits>
@@ -1511,6 +1512,118 @@ void SphereFit::ProjectToSphere()
 
 // -------------------------------------------------------------------------------
 
+void PointMoments::AddPoint(const Base::Vector3f& point)
+{
+    if (_count == 0) {
+        _origin = Base::convertTo<Base::Vector3d>(point);
+    }
+
+    Base::Vector3d pnt = Base::convertTo<Base::Vector3d>(point) - _origin;
+    double normSq = pnt.Sqr();
+    _count++;
+    _sum += pnt;
+    _sumSq[0] += pnt.x * pnt.x;
+    _sumSq[1] += pnt.x * pnt.y;
+    _sumSq[2] += pnt.x * pnt.z;
+    _sumSq[3] += pnt.y * pnt.y;
+    _sumSq[4] += pnt.y * pnt.z;
+    _sumSq[5] += pnt.z * pnt.z;
+    _sumNormSqP += pnt * normSq;
+    _sumNormSq += normSq;
+    _sumNormQuad += normSq * normSq;
+}
+
+void PointMoments::Clear()
+{
+    *this = PointMoments();
+}
+
+float PointMoments::FitPlane(Base::Vector3f& base, Base::Vector3f& normal) const
+{
+    if (_count < 3) {
+        return std::numeric_limits<float>::max();
+    }
+
+    // covariance matrix of the points
+    auto size = double(_count);
+    Eigen::Matrix3d covMat;
+    covMat(0, 0) = _sumSq[0] - _sum.x * _sum.x / size;
+    covMat(0, 1) = _sumSq[1] - _sum.x * _sum.y / size;
+    covMat(0, 2) = _sumSq[2] - _sum.x * _sum.z / size;
+    covMat(1, 1) = _sumSq[3] - _sum.y * _sum.y / size;
+    covMat(1, 2) = _sumSq[4] - _sum.y * _sum.z / size;
+    covMat(2, 2) = _sumSq[5] - _sum.z * _sum.z / size;
+    covMat(1, 0) = covMat(0, 1);
+    covMat(2, 0) = covMat(0, 2);
+    covMat(2, 1) = covMat(1, 2);
+
+    // the eigenvalues are sorted in increasing order
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> eig(covMat);
+    if (eig.info() != Eigen::Success) {
+        return std::numeric_limits<float>::max();
+    }
+    const Eigen::Vector3d& values = eig.eigenvalues();
+    if (values(1) <= std::numeric_limits<double>::epsilon() * values(2)) {
+        // points describe a line or even are identical
+        return std::numeric_limits<float>::max();
+    }
+
+    Eigen::Vector3d dir = eig.eigenvectors().col(0);
+    normal.Set(float(dir.x()), float(dir.y()), float(dir.z()));
+    base = Base::convertTo<Base::Vector3f>(_origin + _sum / size);
+
+    double sigma = std::max(values(0), 0.0);
+    if (_count > 3) {
+        return float(std::sqrt(sigma / double(_count - 3)));
+    }
+    return 0.0F;
+}
+
+float PointMoments::FitSphere(Base::Vector3f& center, float& radius) const
+{
+    if (_count < 4) {
+        return std::numeric_limits<float>::max();
+    }
+
+    // The sphere is |p - c|^2 = r^2 or |p|^2 = 2 * c * p + d with d = r^2 - |c|^2 which is
+    // linear in c and d. Solve the normal equations of the least-squares problem.
+    auto size = double(_count);
+    Eigen::Matrix4d mat;
+    mat << 4.0 * _sumSq[0], 4.0 * _sumSq[1], 4.0 * _sumSq[2], 2.0 * _sum.x,  //
+        4.0 * _sumSq[1], 4.0 * _sumSq[3], 4.0 * _sumSq[4], 2.0 * _sum.y,     //
+        4.0 * _sumSq[2], 4.0 * _sumSq[4], 4.0 * _sumSq[5], 2.0 * _sum.z,     //
+        2.0 * _sum.x, 2.0 * _sum.y, 2.0 * _sum.z, size;
+    Eigen::Vector4d rhs(2.0 * _sumNormSqP.x, 2.0 * _sumNormSqP.y, 2.0 * _sumNormSqP.z, _sumNormSq);
+
+    Eigen::FullPivLU<Eigen::Matrix4d> lu(mat);
+    if (!lu.isInvertible()) {
+        // points are coplanar
+        return std::numeric_limits<float>::max();
+    }
+    Eigen::Vector4d sol = lu.solve(rhs);
+    Base::Vector3d cnt(sol(0), sol(1), sol(2));
+    double dist = sol(3);
+    double radiusSq = dist + cnt.Sqr();
+    if (radiusSq <= 0.0) {
+        return std::numeric_limits<float>::max();
+    }
+
+    center = Base::convertTo<Base::Vector3f>(_origin + cnt);
+    radius = float(std::sqrt(radiusSq));
+
+    // sum of the squared algebraic distances |p|^2 - 2 * c * p - d
+    double cSqc = cnt.x * (_sumSq[0] * cnt.x + _sumSq[1] * cnt.y + _sumSq[2] * cnt.z)
+        + cnt.y * (_sumSq[1] * cnt.x + _sumSq[3] * cnt.y + _sumSq[4] * cnt.z)
+        + cnt.z * (_sumSq[2] * cnt.x + _sumSq[4] * cnt.y + _sumSq[5] * cnt.z);
+    double residual = _sumNormQuad + 4.0 * cSqc + size * dist * dist - 4.0 * (cnt * _sumNormSqP)
+        - 2.0 * dist * _sumNormSq + 4.0 * dist * (cnt * _sum);
+
+    // near the sphere the algebraic distance is about 2 * r times the geometric distance
+    return float(std::sqrt(std::max(residual, 0.0) / size) / (2.0 * std::sqrt(radiusSq)));
+}
+
+// -------------------------------------------------------------------------------
+
 PolynomialFit::PolynomialFit()
     : _fCoeff {}
 {}
@@ -28,6 +28,7 @@
 #include <Mod/Mesh/MeshGlobal.h>
 #endif
 #include <algorithm>
+#include <array>
 #include <limits>
 #include <list>
 #include <set>
@@ -488,6 +489,54 @@ private:
 
 // -------------------------------------------------------------------------------
 
+/**
+ * Keeps the running sums of the moments of the added points. A least-squares plane and an
+ * algebraic sphere can be fitted from these sums in constant time, so a fit can be updated
+ * whenever a point is added. This is used where a region grows point by point, e.g. for the
+ * segmentation of a mesh.
+ */
+class MeshExport PointMoments
+{
+public:
+    /**
+     * Adds the point to the sums.
+     */
+    void AddPoint(const Base::Vector3f& point);
+    /**
+     * Determines the number of the current added points.
+     */
+    std::size_t CountPoints() const
+    {
+        return _count;
+    }
+    /**
+     * Resets all sums.
+     */
+    void Clear();
+    /**
+     * Fits a plane into the points, the same as PlaneFit does. Returns the standard deviation
+     * or FLOAT_MAX if the points are collinear.
+     */
+    float FitPlane(Base::Vector3f& base, Base::Vector3f& normal) const;
+    /**
+     * Fits a sphere into the points by minimizing the algebraic distance. Returns an estimate
+     * of the standard deviation or FLOAT_MAX if the points are coplanar.
+     */
+    float FitSphere(Base::Vector3f& center, float& radius) const;
+
+private:
+    /** The sums are relative to the first point to reduce round-off errors. */
+    Base::Vector3d _origin;
+    std::size_t _count {0};
+    Base::Vector3d _sum;              /**< sum of p */
+    std::array<double, 6> _sumSq {};  /**< sum of xx, xy, xz, yy, yz, zz */
+    Base::Vector3d _sumNormSqP;       /**< sum of |p|^2 * p */
+    double _sumNormSq {0.0};          /**< sum of |p|^2 */
+    double _sumNormQuad {0.0};        /**< sum of |p|^4 */
+};
+
+// -------------------------------------------------------------------------------
+
 /**
  * Helper class for the quadric fit. Includes the
  * partial derivates of the quadric and serves for
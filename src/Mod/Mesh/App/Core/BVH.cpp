@@ -0,0 +1,741 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <numeric>
+#endif
+
+#include <QtConcurrentMap>
+
+#include "BVH.h"
+#include "Elements.h"
+#include "MeshKernel.h"
+
+
+using namespace MeshCore;
+
+namespace
+{
+
+// Leaves with up to this number of facets are never split
+constexpr std::uint32_t MinLeafSize = 4;
+// Leaves with more facets are always split, even if the heuristic doesn't gain anything
+constexpr std::uint32_t MaxLeafSize = 16;
+// Number of bins per axis of the binned surface area heuristic
+constexpr int BinCount = 16;
+// Maximum depth up to which the heuristic is used, deeper ranges are split in
+// halves. So no hierarchy is deeper than MaxDepth plus 32 levels.
+constexpr int MaxDepth = 48;
+// Size of the traversal stacks, at most one node per level is pending
+constexpr int StackSize = MaxDepth + 34;
+// Number of rays of a batched query that are handled by one task
+constexpr std::size_t RaysPerTask = 1024;
+
+struct Bounds
+{
+    std::array<float, 3> min {FLT_MAX, FLT_MAX, FLT_MAX};
+    std::array<float, 3> max {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+    void add(const std::array<float, 3>& lo, const std::array<float, 3>& hi)
+    {
+        for (int i = 0; i < 3; i++) {
+            min[i] = std::min(min[i], lo[i]);
+            max[i] = std::max(max[i], hi[i]);
+        }
+    }
+    void add(const Bounds& other)
+    {
+        add(other.min, other.max);
+    }
+    // half of the surface area is sufficient for the heuristic
+    float area() const
+    {
+        float dx = max[0] - min[0];
+        float dy = max[1] - min[1];
+        float dz = max[2] - min[2];
+        if (dx < 0.0F || dy < 0.0F || dz < 0.0F) {
+            return 0.0F;
+        }
+        return dx * dy + dy * dz + dz * dx;
+    }
+};
+
+struct BuildTask
+{
+    std::uint32_t node;
+    std::uint32_t begin;
+    std::uint32_t end;
+    int depth;
+};
+
+struct Bin
+{
+    Bounds bounds;
+    std::uint32_t count {0};
+};
+
+// Returns the entry parameter of the ray into the box or FLT_MAX if it misses the
+// box or enters it behind tmax. The slab test is kept free of branches.
+template<typename Node>
+inline float intersectBox(const Node& node,
+                          const std::array<float, 3>& org,
+                          const std::array<float, 3>& inv,
+                          float tmax)
+{
+    float tx1 = (node.min[0] - org[0]) * inv[0];
+    float tx2 = (node.max[0] - org[0]) * inv[0];
+    float ty1 = (node.min[1] - org[1]) * inv[1];
+    float ty2 = (node.max[1] - org[1]) * inv[1];
+    float tz1 = (node.min[2] - org[2]) * inv[2];
+    float tz2 = (node.max[2] - org[2]) * inv[2];
+    float tnear = std::max(std::max(std::min(tx1, tx2), std::min(ty1, ty2)),
+                           std::max(std::min(tz1, tz2), 0.0F));
+    float tfar = std::min(std::min(std::max(tx1, tx2), std::max(ty1, ty2)),
+                          std::min(std::max(tz1, tz2), tmax));
+    // compensate the rounding errors of the slab test
+    tfar *= 1.0F + 4.0F * std::numeric_limits<float>::epsilon();
+    return tnear <= tfar ? tnear : FLT_MAX;
+}
+
+// Returns the squared distance of a point to the box
+template<typename Node>
+inline float distanceToBox(const Node& node, const Base::Vector3f& pnt)
+{
+    float dx = std::max(std::max(node.min[0] - pnt.x, pnt.x - node.max[0]), 0.0F);
+    float dy = std::max(std::max(node.min[1] - pnt.y, pnt.y - node.max[1]), 0.0F);
+    float dz = std::max(std::max(node.min[2] - pnt.z, pnt.z - node.max[2]), 0.0F);
+    return dx * dx + dy * dy + dz * dz;
+}
+
+}  // namespace
+
+MeshFacetBVH::MeshFacetBVH(const MeshKernel& rclMesh)
+{
+    Rebuild(rclMesh);
+}
+
+MeshFacetBVH::MeshFacetBVH(const MeshKernel& rclMesh, const Base::Matrix4D& rclMat)
+{
+    Rebuild(rclMesh, rclMat);
+}
+
+void MeshFacetBVH::Rebuild(const MeshKernel& rclMesh)
+{
+    const MeshPointArray& rPoints = rclMesh.GetPoints();
+    const MeshFacetArray& rFacets = rclMesh.GetFacets();
+    std::vector<Base::Vector3f> points;
+    points.reserve(3 * rFacets.size());
+    for (const auto& it : rFacets) {
+        for (PointIndex index : it._aulPoints) {
+            points.push_back(rPoints[index]);
+        }
+    }
+    Build(std::move(points));
+}
+
+void MeshFacetBVH::Rebuild(const MeshKernel& rclMesh, const Base::Matrix4D& rclMat)
+{
+    const MeshPointArray& rPoints = rclMesh.GetPoints();
+    std::vector<Base::Vector3f> transformed;
+    transformed.reserve(rPoints.size());
+    for (const auto& it : rPoints) {
+        Base::Vector3f pnt = it;
+        rclMat.multVec(pnt, pnt);
+        transformed.push_back(pnt);
+    }
+
+    const MeshFacetArray& rFacets = rclMesh.GetFacets();
+    std::vector<Base::Vector3f> points;
+    points.reserve(3 * rFacets.size());
+    for (const auto& it : rFacets) {
+        for (PointIndex index : it._aulPoints) {
+            points.push_back(transformed[index]);
+        }
+    }
+    Build(std::move(points));
+}
+
+void MeshFacetBVH::Clear()
+{
+    _aclNodes.clear();
+    _aulIndices.clear();
+    _aclPoints.clear();
+}
+
+void MeshFacetBVH::RemoveFacets(const std::vector<FacetIndex>& raulFacets)
+{
+    std::size_t numFacets = _aulIndices.size();
+    if (_aclNodes.empty() || raulFacets.empty()) {
+        return;
+    }
+
+    // new index of each facet, FACET_INDEX_MAX for the removed ones
+    std::vector<FacetIndex> remap(numFacets, 0);
+    for (FacetIndex index : raulFacets) {
+        if (index < numFacets) {
+            remap[index] = FACET_INDEX_MAX;
+        }
+    }
+    FacetIndex next = 0;
+    for (FacetIndex& index : remap) {
+        if (index != FACET_INDEX_MAX) {
+            index = next++;
+        }
+    }
+
+    // compact the facets in leaf order, offsets[i] is the new position of the i-th entry
+    std::vector<std::uint32_t> offsets(numFacets + 1, 0);
+    for (std::size_t i = 0; i < numFacets; i++) {
+        FacetIndex index = remap[_aulIndices[i]];
+        std::uint32_t pos = offsets[i];
+        offsets[i + 1] = pos;
+        if (index != FACET_INDEX_MAX) {
+            _aulIndices[pos] = index;
+            _aclPoints[3 * pos] = _aclPoints[3 * i];
+            _aclPoints[3 * pos + 1] = _aclPoints[3 * i + 1];
+            _aclPoints[3 * pos + 2] = _aclPoints[3 * i + 2];
+            offsets[i + 1]++;
+        }
+    }
+    _aulIndices.resize(offsets[numFacets]);
+    _aclPoints.resize(3 * _aulIndices.size());
+    if (_aulIndices.empty()) {
+        Clear();
+        return;
+    }
+
+    // Nodes that were unlinked by an earlier call are still in the array but must not be
+    // touched. The children are always stored behind their parent, so visiting the
+    // reachable nodes backwards handles the children first.
+    std::vector<std::uint32_t> reachable;
+    std::vector<std::uint32_t> stack {0};
+    while (!stack.empty()) {
+        std::uint32_t current = stack.back();
+        stack.pop_back();
+        reachable.push_back(current);
+        const Node& node = _aclNodes[current];
+        if (node.count == 0) {
+            stack.push_back(node.first);
+            stack.push_back(node.first + 1);
+        }
+    }
+    std::sort(reachable.begin(), reachable.end());
+
+    std::vector<bool> empty(_aclNodes.size(), false);
+    for (auto it = reachable.rbegin(); it != reachable.rend(); ++it) {
+        Node& node = _aclNodes[*it];
+        Bounds bounds;
+        if (node.count > 0) {
+            std::uint32_t first = offsets[node.first];
+            std::uint32_t count = offsets[node.first + node.count] - first;
+            if (count == 0) {
+                // a count of 0 would turn the leaf into an inner node, the parent unlinks it
+                empty[*it] = true;
+                continue;
+            }
+            node.first = first;
+            node.count = count;
+            for (std::uint32_t i = 3 * first; i < 3 * (first + count); i++) {
+                const Base::Vector3f& pnt = _aclPoints[i];
+                std::array<float, 3> coords {pnt.x, pnt.y, pnt.z};
+                bounds.add(coords, coords);
+            }
+        }
+        else {
+            std::uint32_t left = node.first;
+            std::uint32_t right = node.first + 1;
+            if (empty[left] && empty[right]) {
+                empty[*it] = true;
+                continue;
+            }
+            if (empty[left] || empty[right]) {
+                // replace the node with its remaining child
+                node = _aclNodes[empty[left] ? right : left];
+                continue;
+            }
+            for (std::uint32_t child : {left, right}) {
+                const Node& other = _aclNodes[child];
+                bounds.add({other.min[0], other.min[1], other.min[2]},
+                           {other.max[0], other.max[1], other.max[2]});
+            }
+        }
+        std::copy(bounds.min.begin(), bounds.min.end(), node.min);
+        std::copy(bounds.max.begin(), bounds.max.end(), node.max);
+    }
+}
+
+Base::BoundBox3f MeshFacetBVH::GetBoundBox() const
+{
+    Base::BoundBox3f box;
+    if (!_aclNodes.empty()) {
+        const Node& root = _aclNodes.front();
+        box.Add(Base::Vector3f(root.min[0], root.min[1], root.min[2]));
+        box.Add(Base::Vector3f(root.max[0], root.max[1], root.max[2]));
+    }
+    return box;
+}
+
+void MeshFacetBVH::Build(std::vector<Base::Vector3f>&& points)
+{
+    Clear();
+
+    std::size_t numFacets = points.size() / 3;
+    if (numFacets == 0) {
+        return;
+    }
+
+    // bounding box and centroid of each facet
+    std::vector<Bounds> boxes(numFacets);
+    std::vector<std::array<float, 3>> centers(numFacets);
+    for (std::size_t i = 0; i < numFacets; i++) {
+        Bounds& box = boxes[i];
+        for (int j = 0; j < 3; j++) {
+            const Base::Vector3f& pnt = points[3 * i + j];
+            std::array<float, 3> coords {pnt.x, pnt.y, pnt.z};
+            box.add(coords, coords);
+        }
+        for (int k = 0; k < 3; k++) {
+            centers[i][k] = 0.5F * (box.min[k] + box.max[k]);
+        }
+    }
+
+    std::vector<std::uint32_t> order(numFacets);
+    std::iota(order.begin(), order.end(), 0);
+
+    _aclNodes.reserve(2 * numFacets / MinLeafSize + 1);
+    _aclNodes.emplace_back();
+
+    std::vector<BuildTask> tasks;
+    tasks.push_back({0, 0, static_cast<std::uint32_t>(numFacets), 0});
+    while (!tasks.empty()) {
+        BuildTask task = tasks.back();
+        tasks.pop_back();
+
+        Bounds bounds;
+        Bounds centroids;
+        for (std::uint32_t i = task.begin; i < task.end; i++) {
+            bounds.add(boxes[order[i]]);
+            centroids.add(centers[order[i]], centers[order[i]]);
+        }
+
+        std::uint32_t count = task.end - task.begin;
+        auto makeLeaf = [&]() {
+            Node& node = _aclNodes[task.node];
+            std::copy(bounds.min.begin(), bounds.min.end(), node.min);
+            std::copy(bounds.max.begin(), bounds.max.end(), node.max);
+            node.first = task.begin;
+            node.count = count;
+        };
+
+        if (count <= MinLeafSize) {
+            makeLeaf();
+            continue;
+        }
+
+        // find the best split plane of the binned surface area heuristic
+        int bestAxis = -1;
+        int bestSplit = 0;
+        float bestCost = FLT_MAX;
+        for (int axis = 0; axis < 3; axis++) {
+            float lo = centroids.min[axis];
+            float extent = centroids.max[axis] - lo;
+            if (extent <= 0.0F) {
+                continue;
+            }
+
+            float scale = BinCount / extent;
+            std::array<Bin, BinCount> bins;
+            for (std::uint32_t i = task.begin; i < task.end; i++) {
+                std::uint32_t index = order[i];
+                int bin =
+                    std::min(BinCount - 1, static_cast<int>((centers[index][axis] - lo) * scale));
+                bins[bin].bounds.add(boxes[index]);
+                bins[bin].count++;
+            }
+
+            // sweep from the right to get the cost of the right sides
+            std::array<float, BinCount - 1> rightCost {};
+            Bounds right;
+            std::uint32_t rightCount = 0;
+            for (int i = BinCount - 1; i > 0; i--) {
+                right.add(bins[i].bounds);
+                rightCount += bins[i].count;
+                rightCost[i - 1] = right.area() * static_cast<float>(rightCount);
+            }
+
+            Bounds left;
+            std::uint32_t leftCount = 0;
+            for (int i = 0; i < BinCount - 1; i++) {
+                left.add(bins[i].bounds);
+                leftCount += bins[i].count;
+                if (leftCount == 0 || leftCount == count) {
+                    continue;
+                }
+                float cost = left.area() * static_cast<float>(leftCount) + rightCost[i];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = i;
+                }
+            }
+        }
+
+        float leafCost = bounds.area() * static_cast<float>(count);
+        if (count <= MaxLeafSize && (bestAxis < 0 || bestCost >= leafCost)) {
+            makeLeaf();
+            continue;
+        }
+
+        auto first = order.begin() + task.begin;
+        auto last = order.begin() + task.end;
+        auto middle = first;
+        if (bestAxis >= 0 && task.depth < MaxDepth) {
+            float lo = centroids.min[bestAxis];
+            float scale = BinCount / (centroids.max[bestAxis] - lo);
+            middle = std::partition(first, last, [&](std::uint32_t index) {
+                int bin = std::min(BinCount - 1,
+                                   static_cast<int>((centers[index][bestAxis] - lo) * scale));
+                return bin <= bestSplit;
+            });
+        }
+        if (middle == first || middle == last) {
+            // identical centroids or a degenerated hierarchy, split in halves
+            middle = first + count / 2;
+            int axis = 0;
+            for (int k = 1; k < 3; k++) {
+                if (centroids.max[k] - centroids.min[k]
+                    > centroids.max[axis] - centroids.min[axis]) {
+                    axis = k;
+                }
+            }
+            std::nth_element(first, middle, last, [&](std::uint32_t a, std::uint32_t b) {
+                return centers[a][axis] < centers[b][axis];
+            });
+        }
+
+        auto left = static_cast<std::uint32_t>(_aclNodes.size());
+        _aclNodes.emplace_back();
+        _aclNodes.emplace_back();
+
+        Node& node = _aclNodes[task.node];
+        std::copy(bounds.min.begin(), bounds.min.end(), node.min);
+        std::copy(bounds.max.begin(), bounds.max.end(), node.max);
+        node.first = left;
+        node.count = 0;
+
+        auto split = static_cast<std::uint32_t>(middle - order.begin());
+        tasks.push_back({left + 1, split, task.end, task.depth + 1});
+        tasks.push_back({left, task.begin, split, task.depth + 1});
+    }
+
+    // store the facets in leaf order
+    _aulIndices.resize(numFacets);
+    _aclPoints.resize(3 * numFacets);
+    for (std::size_t i = 0; i < numFacets; i++) {
+        std::uint32_t index = order[i];
+        _aulIndices[i] = index;
+        _aclPoints[3 * i] = points[3 * index];
+        _aclPoints[3 * i + 1] = points[3 * index + 1];
+        _aclPoints[3 * i + 2] = points[3 * index + 2];
+    }
+}
+
+bool MeshFacetBVH::NearestFacetOnRay(const Base::Vector3f& rclPt,
+                                     const Base::Vector3f& rclDir,
+                                     Base::Vector3f& rclRes,
+                                     FacetIndex& rulFacet,
+                                     float fMaxAngle) const
+{
+    float dd = rclDir * rclDir;
+    if (_aclNodes.empty() || dd == 0.0F) {
+        return false;
+    }
+
+    std::array<float, 3> org {rclPt.x, rclPt.y, rclPt.z};
+    std::array<float, 3> inv {};
+    std::array<float, 3> dir {rclDir.x, rclDir.y, rclDir.z};
+    for (int i = 0; i < 3; i++) {
+        inv[i] = dir[i] != 0.0F ? 1.0F / dir[i] : std::copysign(FLT_MAX, dir[i]);
+    }
+
+    float tbest = FLT_MAX;
+    std::uint32_t best = 0;
+    bool found = false;
+
+    std::uint32_t stack[StackSize];
+    int top = 0;
+    std::uint32_t current = 0;
+    if (intersectBox(_aclNodes[0], org, inv, tbest) == FLT_MAX) {
+        return false;
+    }
+
+    for (;;) {
+        const Node& node = _aclNodes[current];
+        if (node.count > 0) {
+            for (std::uint32_t i = node.first; i < node.first + node.count; i++) {
+                MeshGeomFacet facet(_aclPoints[3 * i],
+                                    _aclPoints[3 * i + 1],
+                                    _aclPoints[3 * i + 2]);
+                Base::Vector3f pnt;
+                if (facet.Foraminate(rclPt, rclDir, pnt, fMaxAngle)) {
+                    float t = ((pnt - rclPt) * rclDir) / dd;
+                    if (t >= 0.0F && t < tbest) {
+                        tbest = t;
+                        best = i;
+                        found = true;
+                        rclRes = pnt;
+                    }
+                }
+            }
+        }
+        else {
+            std::uint32_t nearChild = node.first;
+            std::uint32_t farChild = node.first + 1;
+            float tnear = intersectBox(_aclNodes[nearChild], org, inv, tbest);
+            float tfar = intersectBox(_aclNodes[farChild], org, inv, tbest);
+            if (tnear > tfar) {
+                std::swap(nearChild, farChild);
+                std::swap(tnear, tfar);
+            }
+            if (tnear != FLT_MAX) {
+                if (tfar != FLT_MAX) {
+                    stack[top++] = farChild;
+                }
+                current = nearChild;
+                continue;
+            }
+        }
+
+        // pop the next node that may still contain a nearer hit
+        bool next = false;
+        while (top > 0) {
+            current = stack[--top];
+            if (intersectBox(_aclNodes[current], org, inv, tbest) != FLT_MAX) {
+                next = true;
+                break;
+            }
+        }
+        if (!next) {
+            break;
+        }
+    }
+
+    if (found) {
+        rulFacet = _aulIndices[best];
+    }
+    return found;
+}
+
+void MeshFacetBVH::NearestFacetsOnRays(const std::vector<Ray>& rays,
+                                       std::vector<RayHit>& hits,
+                                       float fMaxAngle) const
+{
+    hits.clear();
+    hits.resize(rays.size());
+
+    std::vector<std::size_t> chunks;
+    for (std::size_t i = 0; i < rays.size(); i += RaysPerTask) {
+        chunks.push_back(i);
+    }
+
+    QtConcurrent::blockingMap(chunks, [&](std::size_t begin) {
+        std::size_t end = std::min(begin + RaysPerTask, rays.size());
+        for (std::size_t i = begin; i < end; i++) {
+            RayHit& hit = hits[i];
+            if (!NearestFacetOnRay(rays[i].point,
+                                   rays[i].direction,
+                                   hit.point,
+                                   hit.facet,
+                                   fMaxAngle)) {
+                hit.facet = FACET_INDEX_MAX;
+            }
+        }
+    });
+}
+
+FacetIndex MeshFacetBVH::NearestFacetToPoint(const Base::Vector3f& rclPt,
+                                             Base::Vector3f& rclRes,
+                                             float fMaxDistance) const
+{
+    if (_aclNodes.empty()) {
+        return FACET_INDEX_MAX;
+    }
+
+    float best = fMaxDistance < std::sqrt(FLT_MAX) ? fMaxDistance * fMaxDistance : FLT_MAX;
+    FacetIndex result = FACET_INDEX_MAX;
+
+    std::uint32_t stack[StackSize];
+    int top = 0;
+    std::uint32_t current = 0;
+    if (distanceToBox(_aclNodes[0], rclPt) > best) {
+        return FACET_INDEX_MAX;
+    }
+
+    for (;;) {
+        const Node& node = _aclNodes[current];
+        if (node.count > 0) {
+            for (std::uint32_t i = node.first; i < node.first + node.count; i++) {
+                MeshGeomFacet facet(_aclPoints[3 * i],
+                                    _aclPoints[3 * i + 1],
+                                    _aclPoints[3 * i + 2]);
+                Base::Vector3f pnt;
+                float dist = facet.DistanceToPoint(rclPt, pnt);
+                if (dist * dist <= best) {
+                    best = dist * dist;
+                    result = _aulIndices[i];
+                    rclRes = pnt;
+                }
+            }
+        }
+        else {
+            std::uint32_t nearChild = node.first;
+            std::uint32_t farChild = node.first + 1;
+            float dnear = distanceToBox(_aclNodes[nearChild], rclPt);
+            float dfar = distanceToBox(_aclNodes[farChild], rclPt);
+            if (dnear > dfar) {
+                std::swap(nearChild, farChild);
+                std::swap(dnear, dfar);
+            }
+            if (dnear <= best) {
+                if (dfar <= best) {
+                    stack[top++] = farChild;
+                }
+                current = nearChild;
+                continue;
+            }
+        }
+
+        bool next = false;
+        while (top > 0) {
+            current = stack[--top];
+            if (distanceToBox(_aclNodes[current], rclPt) <= best) {
+                next = true;
+                break;
+            }
+        }
+        if (!next) {
+            break;
+        }
+    }
+
+    return result;
+}
+
+unsigned long MeshFacetBVH::CountHits(const Base::Vector3f& rclPt,
+                                      const Base::Vector3f& rclDir) const
+{
+    std::array<float, 3> org {rclPt.x, rclPt.y, rclPt.z};
+    std::array<float, 3> inv {1.0F / rclDir.x, 1.0F / rclDir.y, 1.0F / rclDir.z};
+    float dd = rclDir * rclDir;
+
+    unsigned long hits = 0;
+    std::uint32_t stack[StackSize];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node& node = _aclNodes[stack[--top]];
+        if (intersectBox(node, org, inv, FLT_MAX) == FLT_MAX) {
+            continue;
+        }
+        if (node.count > 0) {
+            for (std::uint32_t i = node.first; i < node.first + node.count; i++) {
+                MeshGeomFacet facet(_aclPoints[3 * i],
+                                    _aclPoints[3 * i + 1],
+                                    _aclPoints[3 * i + 2]);
+                Base::Vector3f pnt;
+                if (facet.Foraminate(rclPt, rclDir, pnt) && (pnt - rclPt) * rclDir / dd >= 0.0F) {
+                    hits++;
+                }
+            }
+        }
+        else {
+            stack[top++] = node.first;
+            stack[top++] = node.first + 1;
+        }
+    }
+
+    return hits;
+}
+
+bool MeshFacetBVH::IsInside(const Base::Vector3f& rclPt) const
+{
+    if (_aclNodes.empty()) {
+        return false;
+    }
+
+    const Node& root = _aclNodes.front();
+    if (rclPt.x < root.min[0] || rclPt.x > root.max[0] || rclPt.y < root.min[1]
+        || rclPt.y > root.max[1] || rclPt.z < root.min[2] || rclPt.z > root.max[2]) {
+        return false;
+    }
+
+    // directions that are unlikely to be parallel to the facets of technical models
+    const std::array<Base::Vector3f, 3> directions {Base::Vector3f(0.5773F, 0.5774F, 0.5775F),
+                                                    Base::Vector3f(-0.6133F, 0.2877F, 0.7355F),
+                                                    Base::Vector3f(0.1237F, -0.8462F, 0.5183F)};
+    int votes = 0;
+    for (const auto& dir : directions) {
+        if (CountHits(rclPt, dir) % 2 == 1) {
+            votes++;
+        }
+    }
+    return votes >= 2;
+}
+
+void MeshFacetBVH::Inside(const Base::BoundBox3f& rclBB, std::vector<FacetIndex>& raulFacets) const
+{
+    if (_aclNodes.empty()) {
+        return;
+    }
+
+    std::uint32_t stack[StackSize];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node& node = _aclNodes[stack[--top]];
+        if (node.min[0] > rclBB.MaxX || node.max[0] < rclBB.MinX || node.min[1] > rclBB.MaxY
+            || node.max[1] < rclBB.MinY || node.min[2] > rclBB.MaxZ || node.max[2] < rclBB.MinZ) {
+            continue;
+        }
+        if (node.count > 0) {
+            for (std::uint32_t i = node.first; i < node.first + node.count; i++) {
+                Base::BoundBox3f box;
+                box.Add(_aclPoints[3 * i]);
+                box.Add(_aclPoints[3 * i + 1]);
+                box.Add(_aclPoints[3 * i + 2]);
+                if (box && rclBB) {
+                    raulFacets.push_back(_aulIndices[i]);
+                }
+            }
+        }
+        else {
+            stack[top++] = node.first;
+            stack[top++] = node.first + 1;
+        }
+    }
+}
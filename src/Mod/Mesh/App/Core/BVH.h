@@ -0,0 +1,179 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+
+#ifndef MESH_BVH_H
+#define MESH_BVH_H
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <Base/BoundBox.h>
+#include <Base/Matrix.h>
+
+#include "Definitions.h"
+
+
+namespace MeshCore
+{
+
+class MeshKernel;
+
+/**
+ * The MeshFacetBVH class is a bounding volume hierarchy over the facets of a mesh.
+ *
+ * Unlike the uniform MeshFacetGrid the hierarchy is built with the surface area
+ * heuristic, so it adapts to meshes with a very uneven facet density such as
+ * scans. The nodes are stored depth-first in a flat array and the leaves
+ * reference a copy of the facet points in leaf order, so a query only touches
+ * contiguous memory.
+ *
+ * The hierarchy doesn't keep a reference to the mesh. After modifying the mesh
+ * it must be rebuilt unless facets were only removed, see RemoveFacets(). All
+ * query methods are const and may be called concurrently.
+ */
+class MeshExport MeshFacetBVH
+{
+public:
+    /// A ray for the batched queries
+    struct Ray
+    {
+        Base::Vector3f point;
+        Base::Vector3f direction;
+    };
+
+    /// The result of a ray query, facet is FACET_INDEX_MAX if nothing was hit
+    struct RayHit
+    {
+        FacetIndex facet {FACET_INDEX_MAX};
+        Base::Vector3f point;
+    };
+
+    /** @name Construction */
+    //@{
+    MeshFacetBVH() = default;
+    /// Builds the hierarchy of \a rclMesh.
+    explicit MeshFacetBVH(const MeshKernel& rclMesh);
+    /// Builds the hierarchy of \a rclMesh transformed with \a rclMat.
+    MeshFacetBVH(const MeshKernel& rclMesh, const Base::Matrix4D& rclMat);
+    /// Rebuilds the hierarchy of \a rclMesh.
+    void Rebuild(const MeshKernel& rclMesh);
+    /// Rebuilds the hierarchy of \a rclMesh transformed with \a rclMat.
+    void Rebuild(const MeshKernel& rclMesh, const Base::Matrix4D& rclMat);
+    /// Removes all nodes.
+    void Clear();
+    /**
+     * Removes the facets \a raulFacets and renumbers the remaining facets the same
+     * way as MeshKernel::DeleteFacets() does. Emptied leaves are unlinked and the
+     * boxes are refitted, which is much cheaper than a rebuild. The hierarchy isn't
+     * re-balanced though, so it should be rebuilt after removing most of its facets.
+     */
+    void RemoveFacets(const std::vector<FacetIndex>& raulFacets);
+    //@}
+
+    /** @name Information */
+    //@{
+    bool IsEmpty() const
+    {
+        return _aulIndices.empty();
+    }
+    unsigned long CountFacets() const
+    {
+        return static_cast<unsigned long>(_aulIndices.size());
+    }
+    unsigned long CountNodes() const
+    {
+        return static_cast<unsigned long>(_aclNodes.size());
+    }
+    /// Returns the bounding box of all facets.
+    Base::BoundBox3f GetBoundBox() const;
+    //@}
+
+    /** @name Queries */
+    //@{
+    /**
+     * Searches for the nearest facet that is hit by the ray (\a rclPt, \a rclDir) in
+     * forward direction. The intersection point is \a rclRes and the facet index
+     * \a rulFacet. The angle between the ray and the facet normal must not exceed
+     * \a fMaxAngle, see MeshGeomFacet::Foraminate().
+     */
+    bool NearestFacetOnRay(const Base::Vector3f& rclPt,
+                           const Base::Vector3f& rclDir,
+                           Base::Vector3f& rclRes,
+                           FacetIndex& rulFacet,
+                           float fMaxAngle = Mathf::PI) const;
+    /**
+     * Does the same as NearestFacetOnRay() for all \a rays and distributes the
+     * work over all cores. \a hits has the same size as \a rays afterwards.
+     */
+    void NearestFacetsOnRays(const std::vector<Ray>& rays,
+                             std::vector<RayHit>& hits,
+                             float fMaxAngle = Mathf::PI) const;
+    /**
+     * Searches for the facet nearest to \a rclPt that is not farther away than
+     * \a fMaxDistance. The nearest point on the facet is \a rclRes. If no such facet
+     * exists FACET_INDEX_MAX is returned.
+     */
+    FacetIndex NearestFacetToPoint(const Base::Vector3f& rclPt,
+                                   Base::Vector3f& rclRes,
+                                   float fMaxDistance = std::numeric_limits<float>::max()) const;
+    /**
+     * Checks whether the point \a rclPt lies inside the mesh that must be a closed
+     * solid. Rays in three different directions are cast and the result with the
+     * majority of votes is taken, which makes the test robust against rays that
+     * pass through edges or vertices.
+     */
+    bool IsInside(const Base::Vector3f& rclPt) const;
+    /**
+     * Adds the indices of all facets whose bounding box intersects \a rclBB to
+     * \a raulFacets.
+     */
+    void Inside(const Base::BoundBox3f& rclBB, std::vector<FacetIndex>& raulFacets) const;
+    //@}
+
+private:
+    /// A node of 32 bytes, the children of an inner node are stored next to each other
+    struct Node
+    {
+        float min[3];
+        /// First facet of a leaf or left child of an inner node
+        std::uint32_t first;
+        float max[3];
+        /// Number of facets of a leaf, 0 for an inner node
+        std::uint32_t count;
+    };
+
+    void Build(std::vector<Base::Vector3f>&& points);
+    unsigned long CountHits(const Base::Vector3f& rclPt, const Base::Vector3f& rclDir) const;
+
+private:
+    std::vector<Node> _aclNodes;
+    /// Facet indices in leaf order
+    std::vector<FacetIndex> _aulIndices;
+    /// Three corner points per facet in leaf order
+    std::vector<Base::Vector3f> _aclPoints;
+};
+
+}  // namespace MeshCore
+
+
+#endif  // MESH_BVH_H
@@ -0,0 +1,1714 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#endif
+
+#include "BVH.h"
+#include "Boolean.h"
+#include "Evaluation.h"
+#include "Functional.h"
+#include "MeshKernel.h"
+
+
+using namespace MeshCore;
+
+namespace
+{
+// ----------------------------------------------------------------------------
+// Adaptive-precision predicates, see J. R. Shewchuk: Adaptive Precision Floating-Point
+// Arithmetic and Fast Robust Geometric Predicates
+
+constexpr double Epsilon = std::numeric_limits<double>::epsilon() / 2.0;
+constexpr double Orient2dBound = (3.0 + 16.0 * Epsilon) * Epsilon;
+constexpr double Orient3dBound = (7.0 + 56.0 * Epsilon) * Epsilon;
+constexpr double GradientBound = (8.0 + 64.0 * Epsilon) * Epsilon;
+
+/// Unlike Vector3::operator==() the coordinates are compared without tolerance
+template<class Vector>
+bool sameCoordinates(const Vector& p, const Vector& q)
+{
+    return p.x == q.x && p.y == q.y && p.z == q.z;
+}
+
+/// Sum of non-overlapping components ordered by increasing magnitude
+using Expansion = std::vector<double>;
+
+void twoSum(double a, double b, double& x, double& y)
+{
+    x = a + b;
+    double bv = x - a;
+    double av = x - bv;
+    y = (a - av) + (b - bv);
+}
+
+void twoProduct(double a, double b, double& x, double& y)
+{
+    x = a * b;
+    y = std::fma(a, b, -x);
+}
+
+Expansion difference(double a, double b)
+{
+    double x {};
+    double y {};
+    twoSum(a, -b, x, y);
+    Expansion e;
+    if (y != 0.0) {
+        e.push_back(y);
+    }
+    if (x != 0.0) {
+        e.push_back(x);
+    }
+    return e;
+}
+
+Expansion add(const Expansion& e, const Expansion& f)
+{
+    Expansion h = e;
+    Expansion g;
+    for (double b : f) {
+        g.clear();
+        double q = b;
+        for (double c : h) {
+            double sum {};
+            double err {};
+            twoSum(q, c, sum, err);
+            if (err != 0.0) {
+                g.push_back(err);
+            }
+            q = sum;
+        }
+        if (q != 0.0) {
+            g.push_back(q);
+        }
+        h.swap(g);
+    }
+    return h;
+}
+
+Expansion negate(Expansion e)
+{
+    for (double& c : e) {
+        c = -c;
+    }
+    return e;
+}
+
+Expansion scale(const Expansion& e, double b)
+{
+    Expansion h;
+    double q = 0.0;
+    for (double c : e) {
+        double product {};
+        double productErr {};
+        twoProduct(c, b, product, productErr);
+        double sum {};
+        double err {};
+        twoSum(q, productErr, sum, err);
+        if (err != 0.0) {
+            h.push_back(err);
+        }
+        twoSum(product, sum, q, err);
+        if (err != 0.0) {
+            h.push_back(err);
+        }
+    }
+    if (q != 0.0) {
+        h.push_back(q);
+    }
+    return h;
+}
+
+Expansion multiply(const Expansion& e, const Expansion& f)
+{
+    Expansion h;
+    for (double b : f) {
+        h = add(h, scale(e, b));
+    }
+    return h;
+}
+
+int sign(const Expansion& e)
+{
+    if (e.empty()) {
+        return 0;
+    }
+    return e.back() > 0.0 ? 1 : -1;
+}
+
+struct ExactVector
+{
+    Expansion x, y, z;
+};
+
+ExactVector difference(const Base::Vector3d& a, const Base::Vector3d& b)
+{
+    return {difference(a.x, b.x), difference(a.y, b.y), difference(a.z, b.z)};
+}
+
+ExactVector cross(const ExactVector& u, const ExactVector& v)
+{
+    return {add(multiply(u.y, v.z), negate(multiply(u.z, v.y))),
+            add(multiply(u.z, v.x), negate(multiply(u.x, v.z))),
+            add(multiply(u.x, v.y), negate(multiply(u.y, v.x)))};
+}
+
+Expansion dot(const ExactVector& u, const ExactVector& v)
+{
+    return add(add(multiply(u.x, v.x), multiply(u.y, v.y)), multiply(u.z, v.z));
+}
+
+/// Sign of ((b - a) % (c - a)) * (d - a)
+int orient3d(const Base::Vector3d& a,
+             const Base::Vector3d& b,
+             const Base::Vector3d& c,
+             const Base::Vector3d& d)
+{
+    Base::Vector3d u = b - a;
+    Base::Vector3d v = c - a;
+    Base::Vector3d w = d - a;
+    double det = u.x * (v.y * w.z - v.z * w.y) + u.y * (v.z * w.x - v.x * w.z)
+        + u.z * (v.x * w.y - v.y * w.x);
+    double permanent = std::abs(u.x) * (std::abs(v.y * w.z) + std::abs(v.z * w.y))
+        + std::abs(u.y) * (std::abs(v.z * w.x) + std::abs(v.x * w.z))
+        + std::abs(u.z) * (std::abs(v.x * w.y) + std::abs(v.y * w.x));
+    double bound = Orient3dBound * permanent;
+    if (det > bound) {
+        return 1;
+    }
+    if (-det > bound) {
+        return -1;
+    }
+    if (sameCoordinates(d, a) || sameCoordinates(d, b) || sameCoordinates(d, c)) {
+        return 0;
+    }
+
+    ExactVector eu = difference(b, a);
+    ExactVector ev = difference(c, a);
+    ExactVector ew = difference(d, a);
+    return sign(dot(eu, cross(ev, ew)));
+}
+
+/**
+ * Does the same as orient3d() but the points of the second mesh are moved by the infinitesimal
+ * offset (e, e^2, e^3). As the determinant is affine in the offset an exact zero is resolved by
+ * the components of its gradient.
+ */
+int orient3d(const std::array<const Base::Vector3d*, 4>& p, const std::array<bool, 4>& moved)
+{
+    int result = orient3d(*p[0], *p[1], *p[2], *p[3]);
+    if (result != 0) {
+        return result;
+    }
+
+    std::array<int, 3> factor {};
+    for (int i = 0; i < 3; i++) {
+        factor[i] = int(moved[i + 1]) - int(moved[0]);
+    }
+    if (factor == std::array<int, 3> {0, 0, 0}) {
+        return 0;
+    }
+
+    // floating-point filter of the gradient
+    std::array<Base::Vector3d, 3> approx = {*p[1] - *p[0], *p[2] - *p[0], *p[3] - *p[0]};
+    Base::Vector3d value;
+    Base::Vector3d permanent;
+    for (int i = 0; i < 3; i++) {
+        if (factor[i] == 0) {
+            continue;
+        }
+        const Base::Vector3d& u = approx[(i + 1) % 3];
+        const Base::Vector3d& v = approx[(i + 2) % 3];
+        value += (u % v) * double(factor[i]);
+        permanent += Base::Vector3d(std::abs(u.y * v.z) + std::abs(u.z * v.y),
+                                    std::abs(u.z * v.x) + std::abs(u.x * v.z),
+                                    std::abs(u.x * v.y) + std::abs(u.y * v.x));
+    }
+    for (int i = 0; i < 3; i++) {
+        double bound = GradientBound * permanent[i];
+        if (std::abs(value[i]) > bound) {
+            return value[i] > 0.0 ? 1 : -1;
+        }
+        if (permanent[i] != 0.0) {
+            break;
+        }
+    }
+
+    std::array<ExactVector, 3> column = {difference(*p[1], *p[0]),
+                                         difference(*p[2], *p[0]),
+                                         difference(*p[3], *p[0])};
+    ExactVector gradient;
+    for (int i = 0; i < 3; i++) {
+        if (factor[i] == 0) {
+            continue;
+        }
+        ExactVector term = cross(column[(i + 1) % 3], column[(i + 2) % 3]);
+        if (factor[i] < 0) {
+            term = {negate(term.x), negate(term.y), negate(term.z)};
+        }
+        gradient = {add(gradient.x, term.x), add(gradient.y, term.y), add(gradient.z, term.z)};
+    }
+
+    for (const Expansion* e : {&gradient.x, &gradient.y, &gradient.z}) {
+        if (int s = sign(*e)) {
+            return s;
+        }
+    }
+    return 0;
+}
+
+struct Point2
+{
+    double x, y;
+};
+
+/// Sign of the area of the triangle (a, b, c)
+int orient2d(const Point2& a, const Point2& b, const Point2& c)
+{
+    double left = (a.x - c.x) * (b.y - c.y);
+    double right = (a.y - c.y) * (b.x - c.x);
+    double det = left - right;
+    double bound = Orient2dBound * (std::abs(left) + std::abs(right));
+    if (det > bound) {
+        return 1;
+    }
+    if (-det > bound) {
+        return -1;
+    }
+
+    Expansion exact = add(multiply(difference(a.x, c.x), difference(b.y, c.y)),
+                          negate(multiply(difference(a.y, c.y), difference(b.x, c.x))));
+    return sign(exact);
+}
+
+// ----------------------------------------------------------------------------
+
+/// The point where the edge (v0, v1) of one mesh crosses a facet of the other mesh
+struct CrossingKey
+{
+    PointIndex v0;
+    PointIndex v1;
+    FacetIndex facet;
+
+    bool operator<(const CrossingKey& other) const
+    {
+        return std::tie(v0, v1, facet) < std::tie(other.v0, other.v1, other.facet);
+    }
+    bool operator==(const CrossingKey& other) const
+    {
+        return v0 == other.v0 && v1 == other.v1 && facet == other.facet;
+    }
+};
+
+/// The intersection segment of a facet of the first and a facet of the second mesh
+struct Segment
+{
+    std::array<CrossingKey, 2> points;
+    std::array<FacetIndex, 2> facets;
+};
+
+/// An edge of the first mesh that crosses an edge of the second mesh in a common plane
+struct EdgeCrossing
+{
+    std::array<PointIndex, 2> edge1;
+    std::array<PointIndex, 2> edge2;
+
+    bool operator<(const EdgeCrossing& other) const
+    {
+        return std::tie(edge1, edge2) < std::tie(other.edge1, other.edge2);
+    }
+    bool operator==(const EdgeCrossing& other) const
+    {
+        return edge1 == other.edge1 && edge2 == other.edge2;
+    }
+};
+
+/// The facets of both meshes whose edges cross
+struct CrossingFacets
+{
+    EdgeCrossing crossing;
+    std::array<FacetIndex, 2> facets;
+};
+
+/// End point of an overlap, either a vertex or the crossing of two edges
+struct OverlapPoint
+{
+    PointIndex vertex {POINT_INDEX_MAX};
+    EdgeCrossing crossing {};
+};
+
+/// The part of an edge that lies on a coplanar facet of the other mesh
+struct Overlap
+{
+    FacetIndex facet;
+    std::array<OverlapPoint, 2> points;
+};
+
+/// A constraint edge of a retriangulated facet
+struct Constraint
+{
+    std::size_t key0;
+    std::size_t key1;
+    FacetIndex other;
+};
+
+using Triangle = std::array<PointIndex, 3>;
+
+/**
+ * Constrained triangulation of a single facet. The points of the boundary are inserted by
+ * splitting the facet edges, the interior points by splitting the triangle that contains them
+ * and the constraints are recovered by edge flips.
+ */
+class FacetTriangulation
+{
+public:
+    explicit FacetTriangulation(const std::array<Point2, 3>& corners)
+        : points(corners.begin(), corners.end())
+    {
+        setTriangle(addTriangle(), {0, 1, 2});
+    }
+
+    int addPoint(const Point2& p)
+    {
+        points.push_back(p);
+        return int(points.size()) - 1;
+    }
+
+    /// Splits the triangles with the edge (a, b) at point p
+    void splitEdge(int a, int b, int p)
+    {
+        for (auto edge : {std::make_pair(a, b), std::make_pair(b, a)}) {
+            auto it = edges.find(edge);
+            if (it == edges.end()) {
+                continue;
+            }
+            int index = it->second;
+            std::array<int, 3> tria = triangles[index];
+            int pos = 0;
+            while (tria[pos] != edge.first) {
+                pos++;
+            }
+            int c = tria[(pos + 2) % 3];
+            setTriangle(index, {edge.first, p, c});
+            setTriangle(addTriangle(), {p, edge.second, c});
+            if (isConstraint(a, b)) {
+                constraints.erase(std::minmax(a, b));
+                constraints.insert(std::minmax(a, p));
+                constraints.insert(std::minmax(p, b));
+            }
+        }
+    }
+
+    /**
+     * Inserts point p and returns the index that represents it in the triangulation. If the
+     * point lies on the boundary the split edge is returned in \a boundary.
+     */
+    int insertPoint(int p, std::pair<int, int>& boundary)
+    {
+        int best = -1;
+        int bestNegative = 4;
+        for (std::size_t i = 0; i < triangles.size(); i++) {
+            const auto& tria = triangles[i];
+            std::array<int, 3> orient {};
+            int negative = 0;
+            for (int j = 0; j < 3; j++) {
+                orient[j] = orient2d(points[tria[j]], points[tria[(j + 1) % 3]], points[p]);
+                if (orient[j] < 0) {
+                    negative++;
+                }
+            }
+            if (negative == 0) {
+                int zeros = int(std::count(orient.begin(), orient.end(), 0));
+                if (zeros == 2) {
+                    // coincides with a vertex of the projection
+                    for (int j = 0; j < 3; j++) {
+                        if (orient[j] != 0) {
+                            return tria[(j + 2) % 3];
+                        }
+                    }
+                }
+                if (zeros == 1) {
+                    for (int j = 0; j < 3; j++) {
+                        if (orient[j] == 0) {
+                            int a = tria[j];
+                            int b = tria[(j + 1) % 3];
+                            if (opposite(b, a) < 0) {
+                                boundary = {a, b};
+                            }
+                            splitEdge(a, b, p);
+                            return p;
+                        }
+                    }
+                }
+                best = int(i);
+                break;
+            }
+            if (negative < bestNegative) {
+                bestNegative = negative;
+                best = int(i);
+            }
+        }
+
+        // The point may lie slightly outside due to the rounded coordinates
+        std::array<int, 3> tria = triangles[best];
+        setTriangle(best, {tria[0], tria[1], p});
+        setTriangle(addTriangle(), {tria[1], tria[2], p});
+        setTriangle(addTriangle(), {tria[2], tria[0], p});
+        return p;
+    }
+
+    /// Makes the segment (a, b) an edge of the triangulation
+    void insertSegment(int a, int b)
+    {
+        if (a == b) {
+            return;
+        }
+
+        // guard against cycling in near-degenerate configurations
+        const std::size_t maxFlips = 4 * triangles.size() * triangles.size() + 16;
+        for (std::size_t iteration = 0; iteration < maxFlips; iteration++) {
+            if (edges.count({a, b}) > 0 || edges.count({b, a}) > 0) {
+                constraints.insert(std::minmax(a, b));
+                return;
+            }
+
+            // a vertex on the segment splits it
+            for (int v = 0; v < int(points.size()); v++) {
+                if (v == a || v == b || !isUsed(v) || orient2d(points[a], points[b], points[v]) != 0) {
+                    continue;
+                }
+                double t = (points[v].x - points[a].x) * (points[b].x - points[a].x)
+                    + (points[v].y - points[a].y) * (points[b].y - points[a].y);
+                double len = (points[b].x - points[a].x) * (points[b].x - points[a].x)
+                    + (points[b].y - points[a].y) * (points[b].y - points[a].y);
+                if (t > 0.0 && t < len) {
+                    insertSegment(a, v);
+                    insertSegment(v, b);
+                    return;
+                }
+            }
+
+            if (!flipCrossingEdge(a, b)) {
+                return;
+            }
+        }
+    }
+
+    bool isConstraint(int a, int b) const
+    {
+        return constraints.count(std::minmax(a, b)) > 0;
+    }
+
+    /// Returns the third point of the triangle with the directed edge (a, b) or -1
+    int opposite(int a, int b) const
+    {
+        auto it = edges.find({a, b});
+        if (it == edges.end()) {
+            return -1;
+        }
+        const auto& tria = triangles[it->second];
+        for (int v : tria) {
+            if (v != a && v != b) {
+                return v;
+            }
+        }
+        return -1;
+    }
+
+    std::vector<Point2> points;
+    std::vector<std::array<int, 3>> triangles;
+    std::set<std::pair<int, int>> constraints;
+
+private:
+    int addTriangle()
+    {
+        triangles.push_back({-1, -1, -1});
+        return int(triangles.size()) - 1;
+    }
+
+    void setTriangle(int index, const std::array<int, 3>& tria)
+    {
+        auto& old = triangles[index];
+        if (old[0] >= 0) {
+            for (int j = 0; j < 3; j++) {
+                auto it = edges.find({old[j], old[(j + 1) % 3]});
+                // the edge may already belong to a new triangle
+                if (it != edges.end() && it->second == index) {
+                    edges.erase(it);
+                }
+            }
+        }
+        old = tria;
+        for (int j = 0; j < 3; j++) {
+            edges[{tria[j], tria[(j + 1) % 3]}] = index;
+        }
+    }
+
+    bool isUsed(int v) const
+    {
+        auto it = edges.lower_bound({v, std::numeric_limits<int>::min()});
+        return it != edges.end() && it->first.first == v;
+    }
+
+    bool flipCrossingEdge(int a, int b)
+    {
+        for (const auto& [edge, index] : edges) {
+            auto [c, d] = edge;
+            if (c > d || isConstraint(c, d) || c == a || c == b || d == a || d == b) {
+                continue;
+            }
+            int sc = orient2d(points[a], points[b], points[c]);
+            int sd = orient2d(points[a], points[b], points[d]);
+            if (sc * sd >= 0) {
+                continue;
+            }
+            if (orient2d(points[c], points[d], points[a]) * orient2d(points[c], points[d], points[b])
+                >= 0) {
+                continue;
+            }
+            int e = opposite(c, d);
+            int f = opposite(d, c);
+            if (e < 0 || f < 0) {
+                continue;
+            }
+            // flip only if the quad (c, f, d, e) is strictly convex
+            if (orient2d(points[e], points[f], points[c]) * orient2d(points[e], points[f], points[d])
+                >= 0) {
+                continue;
+            }
+            int t1 = edges[{c, d}];
+            int t2 = edges[{d, c}];
+            setTriangle(t1, {c, f, e});
+            setTriangle(t2, {f, d, e});
+            return true;
+        }
+        return false;
+    }
+
+    std::map<std::pair<int, int>, int> edges;
+};
+
+int numberOfThreads(int threads)
+{
+    return threads > 0 ? threads : std::max(1, int(std::thread::hardware_concurrency()));
+}
+
+struct UnionFind
+{
+    explicit UnionFind(std::size_t size)
+        : parent(size)
+    {
+        for (std::size_t i = 0; i < size; i++) {
+            parent[i] = i;
+        }
+    }
+    std::size_t find(std::size_t i)
+    {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    }
+    void unite(std::size_t i, std::size_t j)
+    {
+        i = find(i);
+        j = find(j);
+        if (i != j) {
+            parent[std::max(i, j)] = std::min(i, j);
+        }
+    }
+    std::vector<std::size_t> parent;
+};
+
+uint64_t edgeKey(PointIndex a, PointIndex b)
+{
+    if (a > b) {
+        std::swap(a, b);
+    }
+    return (uint64_t(a) << 32) | uint64_t(b);
+}
+
+/// Sign of the first non-zero component
+int lexicographicSign(const Base::Vector3d& v)
+{
+    for (int i = 0; i < 3; i++) {
+        if (v[i] != 0.0) {
+            return v[i] > 0.0 ? 1 : -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Returns the axes of the coordinate plane that is most parallel to a facet with the normal
+ * \a normal. The projected facet keeps its counterclockwise orientation.
+ */
+std::pair<int, int> projectionAxes(const Base::Vector3d& normal)
+{
+    int axis = 0;
+    for (int i = 1; i < 3; i++) {
+        if (std::abs(normal[i]) > std::abs(normal[axis])) {
+            axis = i;
+        }
+    }
+    int ix = (axis + 1) % 3;
+    int iy = (axis + 2) % 3;
+    if (normal[axis] < 0.0) {
+        std::swap(ix, iy);
+    }
+    return {ix, iy};
+}
+
+/// A point on an edge of a facet
+struct EdgePoint
+{
+    int edge;
+    PointIndex point;
+    /// Position on the edge measured from its end point with the lower index
+    double param;
+};
+
+/// The retriangulation of a facet
+struct CutFacet
+{
+    std::vector<Triangle> triangles;
+    /// Positive if a triangle lies inside the other mesh, negative if outside, zero if unknown
+    std::vector<double> votes;
+    std::vector<uint64_t> constraints;
+    /// Interior points that lie on an edge of the facet after rounding
+    std::vector<EdgePoint> edgePoints;
+};
+
+/// Triangles that are connected without crossing an intersection curve
+struct Component
+{
+    double vote {0.0};
+    double area {-1.0};
+    std::size_t triangle {0};
+    bool inside {false};
+    /// The facet of the other mesh the component lies on or FACET_INDEX_MAX
+    FacetIndex facet {FACET_INDEX_MAX};
+};
+
+class BooleanEngine
+{
+public:
+    BooleanEngine(const MeshKernel& mesh1, const MeshKernel& mesh2, int threads)
+        : meshes {&mesh1, &mesh2}
+        , threads(threads)
+        , numPoints1(mesh1.CountPoints())
+        , numFacets1(mesh1.CountFacets())
+    {
+        // Points and facets of both meshes with global indices, the second mesh comes last
+        vertices.reserve(numPoints1 + mesh2.CountPoints());
+        facets.reserve(numFacets1 + mesh2.CountFacets());
+        for (std::size_t side = 0; side < 2; side++) {
+            PointIndex offset = side == 0 ? 0 : PointIndex(numPoints1);
+            for (const auto& point : meshes[side]->GetPoints()) {
+                vertices.emplace_back(point.x, point.y, point.z);
+            }
+            for (const auto& facet : meshes[side]->GetFacets()) {
+                facets.push_back({facet._aulPoints[0] + offset,
+                                  facet._aulPoints[1] + offset,
+                                  facet._aulPoints[2] + offset});
+            }
+        }
+        numInput = vertices.size();
+        Base::BoundBox3d box;
+        for (const auto& vertex : vertices) {
+            box.Add(vertex);
+        }
+        if (box.IsValid()) {
+            tolerance = 1.0e-6 * box.CalcDiagonalLength();
+            snapDistance = 1.0e-12 * box.CalcDiagonalLength();
+        }
+        normals.resize(facets.size());
+        for (std::size_t i = 0; i < facets.size(); i++) {
+            const Triangle& tria = facets[i];
+            normals[i] =
+                (vertices[tria[1]] - vertices[tria[0]]) % (vertices[tria[2]] - vertices[tria[0]]);
+        }
+    }
+
+    /// Intersects the candidate pairs of facets of both meshes
+    void intersect()
+    {
+        MeshFacetBVH bvh(*meshes[1]);
+        std::mutex mutex;
+        MeshCore::parallel_for(
+            numFacets1,
+            [&](std::size_t begin, std::size_t end) {
+                std::vector<Segment> found;
+                std::vector<std::pair<FacetIndex, FacetIndex>> touched;
+                std::vector<Overlap> overlapping;
+                std::vector<CrossingFacets> crossing;
+                std::vector<FacetIndex> candidates;
+                for (std::size_t t = begin; t < end; t++) {
+                    Base::BoundBox3f box;
+                    for (PointIndex point : facets[t]) {
+                        const Base::Vector3d& v = vertices[point];
+                        box.Add(Base::Vector3f(float(v.x), float(v.y), float(v.z)));
+                    }
+                    candidates.clear();
+                    bvh.Inside(box, candidates);
+                    for (FacetIndex candidate : candidates) {
+                        Segment segment;
+                        if (intersect(FacetIndex(t), candidate + numFacets1, segment)) {
+                            found.push_back(segment);
+                        }
+                        else if (isCoplanar(FacetIndex(t), candidate + numFacets1)) {
+                            touched.emplace_back(FacetIndex(t), candidate + numFacets1);
+                            clipEdges(FacetIndex(t), candidate + numFacets1, overlapping, crossing);
+                            clipEdges(candidate + numFacets1, FacetIndex(t), overlapping, crossing);
+                        }
+                    }
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                segments.insert(segments.end(), found.begin(), found.end());
+                for (const auto& [facet1, facet2] : touched) {
+                    coplanarFacets[facet1].push_back(facet2);
+                    coplanarFacets[facet2].push_back(facet1);
+                }
+                overlaps.insert(overlaps.end(), overlapping.begin(), overlapping.end());
+                crossingFacets.insert(crossingFacets.end(), crossing.begin(), crossing.end());
+            },
+            threads);
+
+        // independent of the scheduling of the threads
+        MeshCore::parallel_sort(
+            segments.begin(),
+            segments.end(),
+            [](const Segment& a, const Segment& b) {
+                return a.facets < b.facets;
+            },
+            threads);
+        for (auto& it : coplanarFacets) {
+            std::sort(it.second.begin(), it.second.end());
+        }
+        auto byFacet = [](const Overlap& a, const Overlap& b) {
+            const auto& [p, q] = a.points;
+            const auto& [r, s] = b.points;
+            return std::tie(a.facet, p.vertex, p.crossing, q.vertex, q.crossing)
+                < std::tie(b.facet, r.vertex, r.crossing, s.vertex, s.crossing);
+        };
+        std::sort(overlaps.begin(), overlaps.end(), byFacet);
+        std::sort(crossingFacets.begin(),
+                  crossingFacets.end(),
+                  [](const CrossingFacets& a, const CrossingFacets& b) {
+                      return std::tie(a.crossing, a.facets) < std::tie(b.crossing, b.facets);
+                  });
+    }
+
+    /// Computes the crossing points and merges all points that coincide up to rounding errors
+    void computePoints()
+    {
+        keys.reserve(2 * segments.size());
+        for (const auto& segment : segments) {
+            keys.push_back(segment.points[0]);
+            keys.push_back(segment.points[1]);
+        }
+        MeshCore::parallel_sort(keys.begin(), keys.end(), std::less<>(), threads);
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+        lambda.resize(keys.size());
+        vertices.resize(numInput + keys.size());
+        MeshCore::parallel_for(
+            keys.size(),
+            [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; i++) {
+                    const CrossingKey& key = keys[i];
+                    const Base::Vector3d& base = vertices[facets[key.facet][0]];
+                    const Base::Vector3d& normal = normals[key.facet];
+                    double d0 = normal * (vertices[key.v0] - base);
+                    double d1 = normal * (vertices[key.v1] - base);
+                    double t = d0 != d1 ? std::clamp(d0 / (d0 - d1), 0.0, 1.0) : 0.5;
+                    lambda[i] = t;
+                    vertices[numInput + i] =
+                        vertices[key.v0] + (vertices[key.v1] - vertices[key.v0]) * t;
+                }
+            },
+            threads);
+
+        // the crossings of the edges of coplanar facets follow
+        for (const auto& it : crossingFacets) {
+            if (edgeCrossings.empty() || !(edgeCrossings.back() == it.crossing)) {
+                edgeCrossings.push_back(it.crossing);
+            }
+        }
+        std::size_t first = vertices.size();
+        vertices.resize(first + edgeCrossings.size());
+        for (std::size_t i = 0; i < edgeCrossings.size(); i++) {
+            const EdgeCrossing& crossing = edgeCrossings[i];
+            const Base::Vector3d& base = vertices[crossing.edge1[0]];
+            Base::Vector3d dir1 = vertices[crossing.edge1[1]] - base;
+            Base::Vector3d dir2 = vertices[crossing.edge2[1]] - vertices[crossing.edge2[0]];
+            Base::Vector3d normal = dir1 % dir2;
+            double t = normal.Sqr() > 0.0
+                ? ((vertices[crossing.edge2[0]] - base) % dir2) * normal / normal.Sqr()
+                : 0.5;
+            vertices[first + i] = base + dir1 * std::clamp(t, 0.0, 1.0);
+        }
+
+        // Where an edge of each mesh passes through the other mesh at the same location the
+        // crossing points are only apart by rounding errors. They are merged with the help of a
+        // grid with the snap distance as cell size.
+        UnionFind merged(vertices.size());
+        double cellSize = snapDistance > 0.0 ? snapDistance : 1.0;
+        auto cellOf = [cellSize](const Base::Vector3d& point) {
+            return std::array<int64_t, 3> {int64_t(std::floor(point.x / cellSize)),
+                                           int64_t(std::floor(point.y / cellSize)),
+                                           int64_t(std::floor(point.z / cellSize))};
+        };
+        std::map<std::array<int64_t, 3>, std::vector<PointIndex>> grid;
+        for (std::size_t i = 0; i < vertices.size(); i++) {
+            std::array<int64_t, 3> cell = cellOf(vertices[i]);
+            for (int64_t dx = -1; dx <= 1; dx++) {
+                for (int64_t dy = -1; dy <= 1; dy++) {
+                    for (int64_t dz = -1; dz <= 1; dz++) {
+                        auto it = grid.find({cell[0] + dx, cell[1] + dy, cell[2] + dz});
+                        if (it == grid.end()) {
+                            continue;
+                        }
+                        for (PointIndex other : it->second) {
+                            if (sameCoordinates(vertices[i], vertices[other])
+                                || Base::Distance(vertices[i], vertices[other]) <= snapDistance) {
+                                merged.unite(i, other);
+                            }
+                        }
+                    }
+                }
+            }
+            grid[cell].push_back(PointIndex(i));
+        }
+
+        weld.resize(vertices.size());
+        for (std::size_t i = 0; i < vertices.size(); i++) {
+            weld[i] = PointIndex(merged.find(i));
+        }
+    }
+
+    /**
+     * Retriangulates the cut facets. An interior point that lies on an edge of its facet after
+     * rounding is added to the edge of both adjacent facets in the same order, so that the result
+     * has no T-junctions.
+     */
+    void retriangulate()
+    {
+        std::vector<std::pair<FacetIndex, std::size_t>> cuts;
+        cuts.reserve(2 * segments.size());
+        for (std::size_t i = 0; i < segments.size(); i++) {
+            cuts.emplace_back(segments[i].facets[0], i);
+            cuts.emplace_back(segments[i].facets[1], i);
+        }
+        MeshCore::parallel_sort(cuts.begin(), cuts.end(), std::less<>(), threads);
+
+        cutIndex.assign(facets.size(), FACET_INDEX_MAX);
+        std::vector<std::size_t> pending;
+        for (std::size_t i = 0; i < cuts.size(); i++) {
+            if (i == 0 || cuts[i].first != cuts[i - 1].first) {
+                pending.push_back(addCutFacet(cuts[i].first));
+            }
+            facetSegments[cutIndex[cuts[i].first]].push_back(cuts[i].second);
+        }
+
+        // coplanar facets are split where they overlap
+        for (const Overlap& overlap : overlaps) {
+            if (cutIndex[overlap.facet] == FACET_INDEX_MAX) {
+                pending.push_back(addCutFacet(overlap.facet));
+            }
+            facetOverlaps[cutIndex[overlap.facet]].emplace_back(pointOf(overlap.points[0]),
+                                                                pointOf(overlap.points[1]));
+        }
+        for (const CrossingFacets& it : crossingFacets) {
+            PointIndex point = weld[pointOf({POINT_INDEX_MAX, it.crossing})];
+            addBoundaryPoint(it.facets[0], it.crossing.edge1, point, pending);
+            addBoundaryPoint(it.facets[1], it.crossing.edge2, point, pending);
+        }
+        std::sort(pending.begin(), pending.end());
+        pending.erase(std::unique(pending.begin(), pending.end()), pending.end());
+
+        const int maxPasses = 4;
+        for (int pass = 0; pass < maxPasses && !pending.empty(); pass++) {
+            MeshCore::parallel_for(
+                pending.size(),
+                [&](std::size_t begin, std::size_t end) {
+                    for (std::size_t i = begin; i < end; i++) {
+                        triangulate(pending[i]);
+                    }
+                },
+                threads);
+
+            std::vector<std::size_t> next;
+            for (std::size_t index : pending) {
+                const Triangle& tria = facets[cutFacetIndex[index]];
+                // addBoundaryPoint() may reallocate the cut facets
+                std::vector<EdgePoint> edgePoints = cutFacets[index].edgePoints;
+                for (const EdgePoint& edgePoint : edgePoints) {
+                    addBoundaryPoint(cutFacetIndex[index],
+                                     {tria[edgePoint.edge], tria[(edgePoint.edge + 1) % 3]},
+                                     edgePoint.point,
+                                     next);
+                }
+            }
+            std::sort(next.begin(), next.end());
+            next.erase(std::unique(next.begin(), next.end()), next.end());
+            pending.swap(next);
+        }
+    }
+
+    /// Decides for each triangle if it's inside the other mesh
+    void classify()
+    {
+        std::unordered_map<uint64_t, bool> constraintEdges;
+        for (const auto& cut : cutFacets) {
+            for (uint64_t key : cut.constraints) {
+                constraintEdges[key] = true;
+            }
+        }
+
+        for (std::size_t side = 0; side < 2; side++) {
+            std::size_t first = side == 0 ? 0 : numFacets1;
+            std::size_t last = side == 0 ? numFacets1 : facets.size();
+            auto& tris = triangles[side];
+            std::vector<double> votes;
+            std::vector<FacetIndex> source;
+            for (std::size_t f = first; f < last; f++) {
+                if (cutIndex[f] == FACET_INDEX_MAX) {
+                    const Triangle& tria = facets[f];
+                    tris.push_back({weld[tria[0]], weld[tria[1]], weld[tria[2]]});
+                    votes.push_back(0.0);
+                }
+                else {
+                    const CutFacet& cut = cutFacets[cutIndex[f]];
+                    tris.insert(tris.end(), cut.triangles.begin(), cut.triangles.end());
+                    votes.insert(votes.end(), cut.votes.begin(), cut.votes.end());
+                }
+                source.resize(tris.size(), FacetIndex(f));
+            }
+
+            // triangles that are connected without crossing an intersection curve
+            UnionFind components(tris.size());
+            std::unordered_map<uint64_t, std::size_t> edgeOwner;
+            edgeOwner.reserve(3 * tris.size() / 2);
+            for (std::size_t i = 0; i < tris.size(); i++) {
+                for (int j = 0; j < 3; j++) {
+                    uint64_t key = edgeKey(tris[i][j], tris[i][(j + 1) % 3]);
+                    if (constraintEdges.count(key) > 0) {
+                        continue;
+                    }
+                    auto [it, inserted] = edgeOwner.emplace(key, i);
+                    if (!inserted) {
+                        components.unite(it->second, i);
+                    }
+                }
+            }
+
+            // a component on the surface of the other mesh is marked by one of its triangles
+            std::vector<FacetIndex> onFacet(tris.size(), FACET_INDEX_MAX);
+            MeshCore::parallel_for(
+                tris.size(),
+                [&](std::size_t begin, std::size_t end) {
+                    for (std::size_t i = begin; i < end; i++) {
+                        onFacet[i] = coincidentFacet(tris[i], source[i]);
+                    }
+                },
+                threads);
+
+            // the largest triangle of each component represents it
+            std::unordered_map<std::size_t, Component> componentOf;
+            for (std::size_t i = 0; i < tris.size(); i++) {
+                Component& component = componentOf[components.find(i)];
+                component.vote += votes[i];
+                double area = triangleNormal(tris[i]).Sqr();
+                if (area >= component.area) {
+                    component.area = area;
+                    component.triangle = i;
+                }
+                if (onFacet[i] != FACET_INDEX_MAX) {
+                    component.facet = onFacet[i];
+                }
+            }
+            std::vector<Component*> list;
+            list.reserve(componentOf.size());
+            for (auto& it : componentOf) {
+                list.push_back(&it.second);
+            }
+
+            MeshFacetBVH bvh(*meshes[1 - side]);
+            MeshCore::parallel_for(
+                list.size(),
+                [&](std::size_t begin, std::size_t end) {
+                    for (std::size_t i = begin; i < end; i++) {
+                        classify(side, tris[list[i]->triangle], bvh, *list[i]);
+                    }
+                },
+                threads);
+
+            inside[side].resize(tris.size());
+            coincident[side].resize(tris.size());
+            for (std::size_t i = 0; i < tris.size(); i++) {
+                inside[side][i] = componentOf[components.find(i)].inside;
+                if (onFacet[i] != FACET_INDEX_MAX) {
+                    coincident[side][i] = normals[onFacet[i]] * normals[source[i]] > 0.0 ? 1 : -1;
+                }
+            }
+        }
+    }
+
+    /**
+     * Fills \a mesh with the triangles of the first and second mesh that are inside (1) or
+     * outside (-1) the other mesh as given by \a keep.
+     */
+    void collect(const std::array<int, 2>& keep, bool flipSecond, MeshKernel& mesh) const
+    {
+        std::vector<Triangle> selected;
+        for (std::size_t side = 0; side < 2; side++) {
+            if (keep[side] == 0) {
+                continue;
+            }
+            for (std::size_t i = 0; i < triangles[side].size(); i++) {
+                // Coincident facets with opposite normals enclose no volume
+                bool cancelled = keep[1 - side] != 0
+                    && coincident[side][i] * (flipSecond ? -1 : 1) < 0;
+                if (inside[side][i] == (keep[side] > 0) && !cancelled) {
+                    Triangle tria = triangles[side][i];
+                    if (side == 1 && flipSecond) {
+                        std::swap(tria[0], tria[1]);
+                    }
+                    selected.push_back(tria);
+                }
+            }
+        }
+
+        // Merge the points again after rounding them to float
+        std::vector<PointIndex> used;
+        used.reserve(3 * selected.size());
+        for (const auto& tria : selected) {
+            used.insert(used.end(), tria.begin(), tria.end());
+        }
+        std::sort(used.begin(), used.end());
+        used.erase(std::unique(used.begin(), used.end()), used.end());
+
+        std::vector<std::pair<Base::Vector3f, PointIndex>> rounded(used.size());
+        for (std::size_t i = 0; i < used.size(); i++) {
+            const Base::Vector3d& v = vertices[used[i]];
+            rounded[i] = {Base::Vector3f(float(v.x), float(v.y), float(v.z)), used[i]};
+        }
+        std::sort(rounded.begin(), rounded.end(), [](const auto& a, const auto& b) {
+            return std::tie(a.first.x, a.first.y, a.first.z, a.second)
+                < std::tie(b.first.x, b.first.y, b.first.z, b.second);
+        });
+
+        MeshPointArray points;
+        std::unordered_map<PointIndex, PointIndex> pointIndex;
+        for (std::size_t i = 0; i < rounded.size(); i++) {
+            if (i == 0 || !sameCoordinates(rounded[i].first, rounded[i - 1].first)) {
+                points.push_back(rounded[i].first);
+            }
+            pointIndex[rounded[i].second] = PointIndex(points.size() - 1);
+        }
+
+        MeshFacetArray resultFacets;
+        resultFacets.reserve(selected.size());
+        for (const auto& tria : selected) {
+            PointIndex p0 = pointIndex[tria[0]];
+            PointIndex p1 = pointIndex[tria[1]];
+            PointIndex p2 = pointIndex[tria[2]];
+            if (p0 != p1 && p1 != p2 && p2 != p0) {
+                resultFacets.push_back(MeshFacet(p0, p1, p2));
+            }
+        }
+
+        mesh.Adopt(points, resultFacets, true);
+    }
+
+    std::size_t countCutFacets() const
+    {
+        return cutFacets.size();
+    }
+
+private:
+    /**
+     * Computes the intersection segment of the facet \a t of the first and \a u of the second
+     * mesh. Each end point of the segment is an edge of one facet crossing the other facet.
+     */
+    bool intersect(FacetIndex t, FacetIndex u, Segment& segment) const
+    {
+        const std::array<FacetIndex, 2> pair = {t, u};
+        int count = 0;
+        for (int side = 0; side < 2; side++) {
+            const Triangle& edgeTria = facets[pair[side]];
+            const Triangle& planeTria = facets[pair[1 - side]];
+            bool edgeMoved = side == 1;
+            std::array<int, 3> signs {};
+            for (int i = 0; i < 3; i++) {
+                signs[i] = orient3d({&vertices[planeTria[0]],
+                                     &vertices[planeTria[1]],
+                                     &vertices[planeTria[2]],
+                                     &vertices[edgeTria[i]]},
+                                    {!edgeMoved, !edgeMoved, !edgeMoved, edgeMoved});
+            }
+            if (signs[0] == 0 || signs[1] == 0 || signs[2] == 0
+                || (signs[0] == signs[1] && signs[1] == signs[2])) {
+                return false;
+            }
+            for (int i = 0; i < 3; i++) {
+                int j = (i + 1) % 3;
+                if (signs[i] == signs[j]) {
+                    continue;
+                }
+                PointIndex p = edgeTria[i];
+                PointIndex q = edgeTria[j];
+                std::array<int, 3> sides {};
+                for (int k = 0; k < 3; k++) {
+                    sides[k] = orient3d({&vertices[p],
+                                         &vertices[q],
+                                         &vertices[planeTria[k]],
+                                         &vertices[planeTria[(k + 1) % 3]]},
+                                        {edgeMoved, edgeMoved, !edgeMoved, !edgeMoved});
+                }
+                if (sides[0] != 0 && sides[0] == sides[1] && sides[1] == sides[2]) {
+                    if (count == 2) {
+                        return false;
+                    }
+                    segment.points[count++] = {std::min(p, q), std::max(p, q), pair[1 - side]};
+                }
+            }
+        }
+
+        segment.facets = pair;
+        return count == 2;
+    }
+
+    Base::Vector3d triangleNormal(const Triangle& tria) const
+    {
+        return (vertices[tria[1]] - vertices[tria[0]]) % (vertices[tria[2]] - vertices[tria[0]]);
+    }
+
+    /**
+     * Returns the facet of the other mesh that overlaps the triangle \a tria of the facet
+     * \a facet in the same plane or FACET_INDEX_MAX.
+     */
+    FacetIndex coincidentFacet(const Triangle& tria, FacetIndex facet) const
+    {
+        auto it = coplanarFacets.find(facet);
+        if (it == coplanarFacets.end()) {
+            return FACET_INDEX_MAX;
+        }
+
+        Base::Vector3d center = (vertices[tria[0]] + vertices[tria[1]] + vertices[tria[2]]) / 3.0;
+        for (FacetIndex other : it->second) {
+            std::pair<int, int> axes = projectionAxes(normals[other]);
+            auto project = [&](const Base::Vector3d& v) {
+                return Point2 {v[axes.first], v[axes.second]};
+            };
+            const Triangle& corners = facets[other];
+            Point2 point = project(center);
+            bool inside = true;
+            for (int i = 0; i < 3 && inside; i++) {
+                inside = orient2d(project(vertices[corners[i]]),
+                                  project(vertices[corners[(i + 1) % 3]]),
+                                  point)
+                    >= 0;
+            }
+            if (inside) {
+                return other;
+            }
+        }
+        return FACET_INDEX_MAX;
+    }
+
+    /**
+     * A component on the surface of the other mesh is classified by the infinitesimal offset of
+     * the second mesh, otherwise by the votes of its triangles next to an intersection curve or,
+     * if there are none, by casting rays.
+     */
+    void classify(std::size_t side,
+                  const Triangle& tria,
+                  const MeshFacetBVH& bvh,
+                  Component& component) const
+    {
+        if (component.facet != FACET_INDEX_MAX) {
+            int sign = lexicographicSign(normals[component.facet]);
+            component.inside = side == 0 ? sign > 0 : sign < 0;
+        }
+        else if (component.vote != 0.0) {
+            component.inside = component.vote > 0.0;
+        }
+        else {
+            component.inside = bvh.IsInside(center(tria));
+        }
+    }
+
+    Base::Vector3f center(const Triangle& tria) const
+    {
+        Base::Vector3d point = (vertices[tria[0]] + vertices[tria[1]] + vertices[tria[2]]) / 3.0;
+        return Base::Vector3f(float(point.x), float(point.y), float(point.z));
+    }
+
+    bool isCoplanar(FacetIndex t, FacetIndex u) const
+    {
+        const Triangle& plane = facets[u];
+        return std::all_of(facets[t].begin(), facets[t].end(), [&](PointIndex point) {
+            return orient3d(vertices[plane[0]],
+                            vertices[plane[1]],
+                            vertices[plane[2]],
+                            vertices[point])
+                == 0;
+        });
+    }
+
+    std::size_t addCutFacet(FacetIndex facet)
+    {
+        cutIndex[facet] = FacetIndex(cutFacets.size());
+        cutFacetIndex.push_back(facet);
+        cutFacets.emplace_back();
+        facetSegments.emplace_back();
+        facetOverlaps.emplace_back();
+        extraPoints.emplace_back();
+        return cutFacets.size() - 1;
+    }
+
+    /// Adds \a point to \a edge of \a facet and of the neighbour facet at this edge
+    void addBoundaryPoint(FacetIndex facet,
+                          const std::array<PointIndex, 2>& edge,
+                          PointIndex point,
+                          std::vector<std::size_t>& changed)
+    {
+        int index = edgeIndex(facet, edge);
+        if (index < 0) {
+            return;
+        }
+        bool second = facet >= numFacets1;
+        FacetIndex offset = second ? FacetIndex(numFacets1) : 0;
+        FacetIndex neighbour = meshes[second]->GetFacets()[facet - offset]._aulNeighbours[index];
+        if (neighbour != FACET_INDEX_MAX) {
+            neighbour += offset;
+        }
+        double param = edgeParam(edge[0], edge[1], point);
+        for (FacetIndex adjacent : {facet, neighbour}) {
+            int side = adjacent != FACET_INDEX_MAX ? edgeIndex(adjacent, edge) : -1;
+            if (side < 0) {
+                continue;
+            }
+            if (cutIndex[adjacent] == FACET_INDEX_MAX) {
+                addCutFacet(adjacent);
+            }
+            addEdgePoint(cutIndex[adjacent], {side, point, param}, changed);
+        }
+    }
+
+    int edgeIndex(FacetIndex facet, const std::array<PointIndex, 2>& edge) const
+    {
+        const Triangle& tria = facets[facet];
+        for (int i = 0; i < 3; i++) {
+            if (edgeKey(tria[i], tria[(i + 1) % 3]) == edgeKey(edge[0], edge[1])) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    void addEdgePoint(std::size_t index, const EdgePoint& point, std::vector<std::size_t>& changed)
+    {
+        auto& extra = extraPoints[index];
+        auto known = std::find_if(extra.begin(), extra.end(), [&](const EdgePoint& e) {
+            return e.point == point.point;
+        });
+        if (known == extra.end()) {
+            extra.push_back(point);
+            changed.push_back(index);
+        }
+    }
+
+    PointIndex pointOf(const OverlapPoint& point) const
+    {
+        if (point.vertex != POINT_INDEX_MAX) {
+            return point.vertex;
+        }
+        auto it = std::lower_bound(edgeCrossings.begin(), edgeCrossings.end(), point.crossing);
+        return PointIndex(numInput + keys.size() + (it - edgeCrossings.begin()));
+    }
+
+    /**
+     * Clips the edges of facet \a u to the coplanar facet \a t. The parts inside \a t become
+     * constraints of its retriangulation.
+     */
+    void clipEdges(FacetIndex t,
+                   FacetIndex u,
+                   std::vector<Overlap>& result,
+                   std::vector<CrossingFacets>& crossings) const
+    {
+        const Triangle& tria = facets[t];
+        std::pair<int, int> axes = projectionAxes(normals[t]);
+        int ix = axes.first;
+        int iy = axes.second;
+        auto project = [&](PointIndex point) {
+            const Base::Vector3d& v = vertices[point];
+            return Point2 {v[ix], v[iy]};
+        };
+        std::array<Point2, 3> corners = {project(tria[0]), project(tria[1]), project(tria[2])};
+        bool first = t < numFacets1;
+
+        for (int k = 0; k < 3; k++) {
+            std::array<PointIndex, 2> edge = {facets[u][k], facets[u][(k + 1) % 3]};
+            if (edge[0] > edge[1]) {
+                std::swap(edge[0], edge[1]);
+            }
+            Point2 a = project(edge[0]);
+            Point2 b = project(edge[1]);
+
+            // the part of the edge on the inner side of all facet edges
+            double enter = 0.0;
+            double leave = 1.0;
+            int enterEdge = -1;
+            int leaveEdge = -1;
+            bool outside = false;
+            for (int i = 0; i < 3 && !outside; i++) {
+                const Point2& c0 = corners[i];
+                const Point2& c1 = corners[(i + 1) % 3];
+                int sa = orient2d(c0, c1, a);
+                int sb = orient2d(c0, c1, b);
+                if (sa <= 0 && sb <= 0 && (sa != 0 || sb != 0)) {
+                    outside = true;
+                }
+                else if (sa < 0 || sb < 0) {
+                    double da = (c1.x - c0.x) * (a.y - c0.y) - (c1.y - c0.y) * (a.x - c0.x);
+                    double db = (c1.x - c0.x) * (b.y - c0.y) - (c1.y - c0.y) * (b.x - c0.x);
+                    double param = da / (da - db);
+                    if (sa < 0 && param > enter) {
+                        enter = param;
+                        enterEdge = i;
+                    }
+                    else if (sb < 0 && param < leave) {
+                        leave = param;
+                        leaveEdge = i;
+                    }
+                }
+            }
+            if (outside || enter >= leave) {
+                continue;
+            }
+
+            Overlap overlap {t, {}};
+            std::array<int, 2> ends = {enterEdge, leaveEdge};
+            for (int j = 0; j < 2; j++) {
+                if (ends[j] < 0) {
+                    overlap.points[j].vertex = edge[j];
+                    continue;
+                }
+                std::array<PointIndex, 2> side = {tria[ends[j]], tria[(ends[j] + 1) % 3]};
+                if (side[0] > side[1]) {
+                    std::swap(side[0], side[1]);
+                }
+                CrossingFacets crossing;
+                crossing.crossing = first ? EdgeCrossing {side, edge} : EdgeCrossing {edge, side};
+                crossing.facets = first ? std::array<FacetIndex, 2> {t, u}
+                                        : std::array<FacetIndex, 2> {u, t};
+                overlap.points[j].crossing = crossing.crossing;
+                crossings.push_back(crossing);
+            }
+            result.push_back(overlap);
+        }
+    }
+
+    /// Position of \a point on the edge (p, q) measured from the end point with the lower index
+    double edgeParam(PointIndex p, PointIndex q, PointIndex point) const
+    {
+        if (p > q) {
+            std::swap(p, q);
+        }
+        Base::Vector3d dir = vertices[q] - vertices[p];
+        return (vertices[point] - vertices[p]) * dir / (dir * dir);
+    }
+
+    void triangulate(std::size_t index)
+    {
+        FacetIndex facet = cutFacetIndex[index];
+        const Triangle& tria = facets[facet];
+        const Base::Vector3d& normal = normals[facet];
+
+        std::pair<int, int> axes = projectionAxes(normal);
+        int ix = axes.first;
+        int iy = axes.second;
+        auto project = [&](PointIndex point) {
+            const Base::Vector3d& v = vertices[point];
+            return Point2 {v[ix], v[iy]};
+        };
+
+        FacetTriangulation triangulation({project(tria[0]), project(tria[1]), project(tria[2])});
+        std::vector<PointIndex> global = {weld[tria[0]], weld[tria[1]], weld[tria[2]]};
+        std::vector<int> onEdge = {-1, -1, -1};
+        std::unordered_map<PointIndex, int> local;
+        for (int i = 0; i < 3; i++) {
+            local.emplace(global[i], i);
+        }
+        auto addPoint = [&](PointIndex id, int edge) {
+            int index = triangulation.addPoint(project(id));
+            global.push_back(id);
+            onEdge.push_back(edge);
+            return index;
+        };
+
+        std::vector<Constraint> constraints;
+        std::array<std::vector<EdgePoint>, 3> boundary;
+        std::vector<std::size_t> interior;
+        for (std::size_t segmentIndex : facetSegments[index]) {
+            const Segment& segment = segments[segmentIndex];
+            std::size_t key0 = keyIndex(segment.points[0]);
+            std::size_t key1 = keyIndex(segment.points[1]);
+            FacetIndex other = segment.facets[0] == facet ? segment.facets[1] : segment.facets[0];
+            constraints.push_back({key0, key1, other});
+            for (std::size_t key : {key0, key1}) {
+                if (keys[key].facet == facet) {
+                    interior.push_back(key);
+                    continue;
+                }
+                for (int i = 0; i < 3; i++) {
+                    if (edgeKey(keys[key].v0, keys[key].v1)
+                        == edgeKey(tria[i], tria[(i + 1) % 3])) {
+                        boundary[i].push_back({i, weld[numInput + key], lambda[key]});
+                    }
+                }
+            }
+        }
+        for (const EdgePoint& extra : extraPoints[index]) {
+            boundary[extra.edge].push_back(extra);
+        }
+
+        // split the facet edges in the same order as the neighbour facets do
+        for (int i = 0; i < 3; i++) {
+            auto& points = boundary[i];
+            std::sort(points.begin(), points.end(), [](const EdgePoint& a, const EdgePoint& b) {
+                return std::make_pair(a.param, a.point) < std::make_pair(b.param, b.point);
+            });
+            if (tria[i] > tria[(i + 1) % 3]) {
+                std::reverse(points.begin(), points.end());
+            }
+            int last = i;
+            for (const EdgePoint& point : points) {
+                if (local.count(point.point) > 0) {
+                    continue;
+                }
+                int added = addPoint(point.point, i);
+                triangulation.splitEdge(last, (i + 1) % 3, added);
+                local.emplace(point.point, added);
+                last = added;
+            }
+        }
+
+        CutFacet& result = cutFacets[index];
+        result = CutFacet();
+        auto insertInterior = [&](PointIndex id) {
+            if (local.count(id) > 0) {
+                return;
+            }
+            int added = addPoint(id, -1);
+            std::pair<int, int> split {-1, -1};
+            int inserted = triangulation.insertPoint(added, split);
+            local.emplace(id, inserted);
+            if (split.first >= 0) {
+                int u = split.first;
+                int v = split.second;
+                int edge = u < 3 && v < 3 ? (v == (u + 1) % 3 ? u : v)
+                                          : (u < 3 ? onEdge[v] : onEdge[u]);
+                onEdge[added] = edge;
+                result.edgePoints.push_back(
+                    {edge, id, edgeParam(tria[edge], tria[(edge + 1) % 3], id)});
+            }
+        };
+        for (std::size_t key : interior) {
+            insertInterior(weld[numInput + key]);
+        }
+        // vertices of a coplanar facet of the other mesh
+        for (const auto& [p, q] : facetOverlaps[index]) {
+            insertInterior(weld[p]);
+            insertInterior(weld[q]);
+        }
+
+        for (const auto& constraint : constraints) {
+            triangulation.insertSegment(local[weld[numInput + constraint.key0]],
+                                        local[weld[numInput + constraint.key1]]);
+        }
+        for (const auto& [p, q] : facetOverlaps[index]) {
+            triangulation.insertSegment(local[weld[p]], local[weld[q]]);
+        }
+
+        std::map<std::pair<int, int>, std::size_t> triangleOfEdge;
+        for (const auto& t : triangulation.triangles) {
+            for (int j = 0; j < 3; j++) {
+                triangleOfEdge[{t[j], t[(j + 1) % 3]}] = result.triangles.size();
+            }
+            result.triangles.push_back({global[t[0]], global[t[1]], global[t[2]]});
+        }
+        result.votes.resize(result.triangles.size());
+        for (const auto& [a, b] : triangulation.constraints) {
+            result.constraints.push_back(edgeKey(global[a], global[b]));
+        }
+
+        // The triangle on each side of a constraint lies inside the other mesh if its third
+        // point is below the plane of the other facet. The distance weights the vote.
+        for (const auto& constraint : constraints) {
+            int a = local[weld[numInput + constraint.key0]];
+            int b = local[weld[numInput + constraint.key1]];
+            if (a == b) {
+                continue;
+            }
+            const Base::Vector3d& origin = vertices[global[a]];
+            const Base::Vector3d& otherNormal = normals[constraint.other];
+            for (auto edge : {std::make_pair(a, b), std::make_pair(b, a)}) {
+                int c = triangulation.opposite(edge.first, edge.second);
+                if (c >= 0) {
+                    double dist = otherNormal * (vertices[global[c]] - origin);
+                    result.votes[triangleOfEdge[edge]] -= dist / otherNormal.Length();
+                }
+            }
+        }
+    }
+
+    std::size_t keyIndex(const CrossingKey& key) const
+    {
+        return std::size_t(std::lower_bound(keys.begin(), keys.end(), key) - keys.begin());
+    }
+
+private:
+    std::array<const MeshKernel*, 2> meshes;
+    int threads;
+    std::size_t numPoints1;
+    std::size_t numFacets1;
+    std::size_t numInput {0};
+    double tolerance {0.0};
+    double snapDistance {0.0};
+
+    std::vector<Base::Vector3d> vertices;
+    std::vector<Triangle> facets;
+    std::vector<Base::Vector3d> normals;
+    /// The facets of the other mesh in the same plane as a facet
+    std::unordered_map<FacetIndex, std::vector<FacetIndex>> coplanarFacets;
+
+    std::vector<Segment> segments;
+    std::vector<Overlap> overlaps;
+    std::vector<CrossingFacets> crossingFacets;
+    std::vector<EdgeCrossing> edgeCrossings;
+    std::vector<CrossingKey> keys;
+    std::vector<double> lambda;
+    std::vector<PointIndex> weld;
+
+    /// Index of the facet in the cut facets or FACET_INDEX_MAX
+    std::vector<FacetIndex> cutIndex;
+    std::vector<FacetIndex> cutFacetIndex;
+    std::vector<CutFacet> cutFacets;
+    std::vector<std::vector<std::size_t>> facetSegments;
+    std::vector<std::vector<std::pair<PointIndex, PointIndex>>> facetOverlaps;
+    std::vector<std::vector<EdgePoint>> extraPoints;
+
+    std::array<std::vector<Triangle>, 2> triangles;
+    std::array<std::vector<bool>, 2> inside;
+    std::array<std::vector<int>, 2> coincident;
+};
+}  // namespace
+
+MeshBoolean::MeshBoolean(const MeshKernel& mesh1,
+                         const MeshKernel& mesh2,
+                         MeshKernel& result,
+                         OperationType opType)
+    : _mesh1(mesh1)
+    , _mesh2(mesh2)
+    , _resultMesh(result)
+    , _operationType(opType)
+{}
+
+void MeshBoolean::SetThreads(int threads)
+{
+    _threads = threads;
+}
+
+bool MeshBoolean::IsValidInput(const MeshKernel& mesh)
+{
+    if (mesh.CountFacets() == 0) {
+        return false;
+    }
+
+    MeshEvalSolid solid(mesh);
+    MeshEvalTopology topology(mesh);
+    MeshEvalOrientation orientation(mesh);
+    if (!solid.Evaluate() || !topology.Evaluate() || !orientation.Evaluate()) {
+        return false;
+    }
+
+    // with consistent orientation a negative volume means the normals point inwards
+    const MeshPointArray& points = mesh.GetPoints();
+    double volume = 0.0;
+    for (const auto& facet : mesh.GetFacets()) {
+        std::array<Base::Vector3d, 3> corner;
+        for (std::size_t i = 0; i < 3; i++) {
+            const MeshPoint& point = points[facet._aulPoints[i]];
+            corner[i].Set(point.x, point.y, point.z);
+        }
+        volume += corner[0] * (corner[1] % corner[2]);
+    }
+    return volume > 0.0;
+}
+
+void MeshBoolean::Do()
+{
+    // 1: keep the triangles inside the other mesh, -1: outside, 0: none
+    std::array<int, 2> keep {};
+    bool flipSecond = false;
+    switch (_operationType) {
+        case Union:
+            keep = {-1, -1};
+            break;
+        case Intersect:
+            keep = {1, 1};
+            break;
+        case Difference:
+            keep = {-1, 1};
+            flipSecond = true;
+            break;
+        case Inner:
+            keep = {1, 0};
+            break;
+        case Outer:
+            keep = {-1, 0};
+            break;
+    }
+
+    BooleanEngine engine(_mesh1, _mesh2, numberOfThreads(_threads));
+    engine.intersect();
+    engine.computePoints();
+    engine.retriangulate();
+    engine.classify();
+    engine.collect(keep, flipSecond, _resultMesh);
+    _cutFacets = static_cast<unsigned long>(engine.countCutFacets());
+}
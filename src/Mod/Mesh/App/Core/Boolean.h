@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+#ifndef MESH_BOOLEAN_H
+#define MESH_BOOLEAN_H
+
+#include <Mod/Mesh/MeshGlobal.h>
+
+
+namespace MeshCore
+{
+
+class MeshKernel;
+
+/**
+ * The MeshBoolean class computes the union, intersection or difference of two closed meshes
+ * whose facet normals point outwards.
+ *
+ * Candidate pairs of intersecting facets are taken from a MeshFacetBVH and intersected on all
+ * cores. The orientation tests are done with adaptive-precision arithmetic that falls back to
+ * exact arithmetic for nearly degenerate configurations, and the second mesh is symbolically
+ * moved by an infinitesimal offset so that coplanar facets and touching vertices or edges get
+ * a consistent answer. Only the facets that are cut by the other mesh are retriangulated.
+ */
+class MeshExport MeshBoolean
+{
+public:
+    enum OperationType
+    {
+        Union,
+        Intersect,
+        Difference,
+        Inner,
+        Outer
+    };
+
+    /// Construction
+    MeshBoolean(const MeshKernel& mesh1,
+                const MeshKernel& mesh2,
+                MeshKernel& result,
+                OperationType opType);
+
+    /// Sets the number of threads, 0 uses all cores
+    void SetThreads(int);
+    /// Computes the result mesh
+    void Do();
+    /**
+     * Checks that \a mesh is a closed, 2-manifold and consistently oriented mesh whose normals
+     * point outwards. Only for such meshes the result of Do() is well-defined.
+     */
+    static bool IsValidInput(const MeshKernel& mesh);
+    /// Returns the number of facets that were retriangulated by the last call of Do()
+    unsigned long CountCutFacets() const
+    {
+        return _cutFacets;
+    }
+
+private:
+    const MeshKernel& _mesh1;
+    const MeshKernel& _mesh2;
+    MeshKernel& _resultMesh;
+    OperationType _operationType;
+    int _threads {0};
+    unsigned long _cutFacets {0};
+};
+
+}  // namespace MeshCore
+
+
+#endif  // MESH_BOOLEAN_H
@@ -23,8 +23,10 @@
 #include "PreCompiled.h"
 #ifndef _PreComp_
 #include <algorithm>
+#include <cmath>
 #include <functional>
 #include <limits>
+#include <thread>
 #endif
 
 #include <QFuture>
@@ -43,8 +45,10 @@
 
 #include "Approximation.h"
 #include "Curvature.h"
+#include "Functional.h"
 #include "Iterator.h"
 #include "MeshKernel.h"
+#include "Storage.h"
 #include "Tools.h"
 
 
@@ -290,59 +294,163 @@ void MeshCurvature::ComputePerVertex()
     }
 }
 #else
-void MeshCurvature::ComputePerVertex()
+namespace
 {
-    myCurvature.clear();
-
-    // get all points
-    std::vector<Wm4::Vector3<double>> aPnts;
-    aPnts.reserve(myKernel.CountPoints());
-    MeshPointIterator cPIt(myKernel);
-    for (cPIt.Init(); cPIt.More(); cPIt.Next()) {
-        Wm4::Vector3<double> cP(cPIt->x, cPIt->y, cPIt->z);
-        aPnts.push_back(cP);
+CurvatureInfo computeVertexCurvature(PointIndex index,
+                                     const std::vector<Wm4::Vector3<double>>& vertices,
+                                     const std::vector<Wm4::Vector3<double>>& normals,
+                                     const MeshPointNeighbours& neighbours,
+                                     const MeshFacetColumns& facets)
+{
+    // compute the matrix of normal derivatives
+    Wm4::Matrix3<double> akWWTrn;
+    Wm4::Matrix3<double> akDWTrn;
+    const Wm4::Vector3<double>& kN = normals[index];
+    const Wm4::Vector3<double>& kV0 = vertices[index];
+    auto addEdge = [&](PointIndex other) {
+        // Compute edge from V0 to V1, project to tangent plane of vertex,
+        // and compute difference of adjacent normals.
+        Wm4::Vector3<double> kE = vertices[other] - kV0;
+        Wm4::Vector3<double> kW = kE - (kE.Dot(kN)) * kN;
+        Wm4::Vector3<double> kD = normals[other] - kN;
+        for (int iRow = 0; iRow < 3; iRow++) {
+            for (int iCol = 0; iCol < 3; iCol++) {
+                akWWTrn[iRow][iCol] += kW[iRow] * kW[iCol];
+                akDWTrn[iRow][iCol] += kD[iRow] * kW[iCol];
+            }
+        }
+    };
+
+    for (FacetIndex facet : neighbours.GetFacets(index)) {
+        const PointIndex* corner = facets.GetPoints(facet);
+        for (int j = 0; j < 3; j++) {
+            if (corner[j] == index) {
+                addEdge(corner[(j + 1) % 3]);
+                addEdge(corner[(j + 2) % 3]);
+            }
+        }
     }
 
-    // get all point connections
-    std::vector<int> aIdx;
-    aIdx.reserve(3 * myKernel.CountFacets());
-    const MeshFacetArray& raFts = myKernel.GetFacets();
-    for (const auto& it : raFts) {
-        for (PointIndex point : it._aulPoints) {
-            aIdx.push_back(int(point));
+    // Add in N*N^T to W*W^T for numerical stability.  In theory 0*0^T gets
+    // added to D*W^T, but of course no update needed in the implementation.
+    for (int iRow = 0; iRow < 3; iRow++) {
+        for (int iCol = 0; iCol < 3; iCol++) {
+            akWWTrn[iRow][iCol] = 0.5 * akWWTrn[iRow][iCol] + kN[iRow] * kN[iCol];
+            akDWTrn[iRow][iCol] *= 0.5;
         }
     }
 
+    Wm4::Matrix3<double> akDNormal = akDWTrn * akWWTrn.Inverse();
+
+    // compute U and V given N, the principal curvatures are the eigenvalues of
+    // the shape matrix S = J^T * dN/dX * J with J = [U | V]
+    Wm4::Vector3<double> kU, kV;
+    Wm4::Vector3<double>::GenerateComplementBasis(kU, kV, kN);
+
+    // In theory S is symmetric, but because we have estimated dN/dX, we must
+    // slightly adjust our calculations to make sure S is symmetric.
+    double fS01 = kU.Dot(akDNormal * kV);
+    double fS10 = kV.Dot(akDNormal * kU);
+    double fSAvr = 0.5 * (fS01 + fS10);
+    Wm4::Matrix2<double> kS(kU.Dot(akDNormal * kU), fSAvr, fSAvr, kV.Dot(akDNormal * kV));
+
+    // compute the eigenvalues of S (min and max curvatures)
+    double fTrace = kS[0][0] + kS[1][1];
+    double fDet = kS[0][0] * kS[1][1] - kS[0][1] * kS[1][0];
+    double fDiscr = fTrace * fTrace - 4.0 * fDet;
+    double fRootDiscr = std::sqrt(std::fabs(fDiscr));
+    double fMinCurvature = 0.5 * (fTrace - fRootDiscr);
+    double fMaxCurvature = 0.5 * (fTrace + fRootDiscr);
+
+    // compute the eigenvectors of S
+    auto direction = [&](double curvature) {
+        Wm4::Vector2<double> kW0(kS[0][1], curvature - kS[0][0]);
+        Wm4::Vector2<double> kW1(curvature - kS[1][1], kS[1][0]);
+        Wm4::Vector2<double>& kW = kW0.SquaredLength() >= kW1.SquaredLength() ? kW0 : kW1;
+        kW.Normalize();
+        Wm4::Vector3<double> dir = kW.X() * kU + kW.Y() * kV;
+        return Base::Vector3f(float(dir.X()), float(dir.Y()), float(dir.Z()));
+    };
+
+    CurvatureInfo ci;
+    ci.cMaxCurvDir = direction(fMaxCurvature);
+    ci.cMinCurvDir = direction(fMinCurvature);
+    ci.fMaxCurvature = float(fMaxCurvature);
+    ci.fMinCurvature = float(fMinCurvature);
+    return ci;
+}
+}  // namespace
+
+void MeshCurvature::ComputePerVertex()
+{
+    myCurvature.clear();
+
     // in case of an empty mesh no curvature can be calculated
     if (myKernel.CountPoints() == 0 || myKernel.CountFacets() == 0) {
         return;
     }
 
-    // compute vertex based curvatures
-    Wm4::MeshCurvature<double> meshCurv(myKernel.CountPoints(),
-                                        aPnts.data(),
-                                        myKernel.CountFacets(),
-                                        aIdx.data());
-
-    // get curvature information now
-    const Wm4::Vector3<double>* aMaxCurvDir = meshCurv.GetMaxDirections();
-    const Wm4::Vector3<double>* aMinCurvDir = meshCurv.GetMinDirections();
-    const double* aMaxCurv = meshCurv.GetMaxCurvatures();
-    const double* aMinCurv = meshCurv.GetMinCurvatures();
-
-    myCurvature.reserve(myKernel.CountPoints());
-    for (unsigned long i = 0; i < myKernel.CountPoints(); i++) {
-        CurvatureInfo ci;
-        ci.cMaxCurvDir = Base::Vector3f((float)aMaxCurvDir[i].X(),
-                                        (float)aMaxCurvDir[i].Y(),
-                                        (float)aMaxCurvDir[i].Z());
-        ci.cMinCurvDir = Base::Vector3f((float)aMinCurvDir[i].X(),
-                                        (float)aMinCurvDir[i].Y(),
-                                        (float)aMinCurvDir[i].Z());
-        ci.fMaxCurvature = (float)aMaxCurv[i];
-        ci.fMinCurvature = (float)aMinCurv[i];
-        myCurvature.push_back(ci);
-    }
+    // This is the algorithm of Wm4::MeshCurvature. Instead of scattering the contributions of
+    // every facet to its corners it gathers them per vertex from the compressed adjacency, so
+    // that all vertices can be processed in parallel. The facets of a vertex are visited in
+    // ascending order, hence the sums are the same as those of the serial version.
+    const MeshPointArray& points = myKernel.GetPoints();
+    MeshFacetColumns facets(myKernel.GetFacets());
+    MeshPointNeighbours neighbours(points.size(), facets);
+    std::size_t numPoints = points.size();
+    std::size_t numFacets = facets.Size();
+    int threads = int(std::thread::hardware_concurrency());
+
+    // compute the facet normals, the length of the cross products provides a weighted sum
+    std::vector<Wm4::Vector3<double>> vertices(numPoints);
+    std::vector<Wm4::Vector3<double>> normals(numPoints);
+    std::vector<Wm4::Vector3<double>> facetNormals(numFacets);
+    MeshCore::parallel_for(
+        numPoints,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t index = begin; index < end; index++) {
+                const MeshPoint& pnt = points[index];
+                vertices[index] = Wm4::Vector3<double>(pnt.x, pnt.y, pnt.z);
+            }
+        },
+        threads);
+    MeshCore::parallel_for(
+        numFacets,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t index = begin; index < end; index++) {
+                const PointIndex* corner = facets.GetPoints(index);
+                Wm4::Vector3<double> kEdge1 = vertices[corner[1]] - vertices[corner[0]];
+                Wm4::Vector3<double> kEdge2 = vertices[corner[2]] - vertices[corner[0]];
+                facetNormals[index] = kEdge1.Cross(kEdge2);
+            }
+        },
+        threads);
+
+    // compute the vertex normals
+    MeshCore::parallel_for(
+        numPoints,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t index = begin; index < end; index++) {
+                Wm4::Vector3<double> normal(0.0, 0.0, 0.0);
+                for (FacetIndex facet : neighbours.GetFacets(index)) {
+                    normal += facetNormals[facet];
+                }
+                normal.Normalize();
+                normals[index] = normal;
+            }
+        },
+        threads);
+
+    myCurvature.resize(numPoints);
+    MeshCore::parallel_for(
+        numPoints,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t index = begin; index < end; index++) {
+                myCurvature[index] =
+                    computeVertexCurvature(index, vertices, normals, neighbours, facets);
+            }
+        },
+        threads);
 }
 #endif  // OPTIMIZE_CURVATURE
 
@@ -70,6 +70,7 @@ public:
         myRadius = r;
     }
     void ComputePerFace(bool parallel);
+    /// Computes the principal curvatures of all points, the points are processed in parallel
     void ComputePerVertex();
     const std::vector<CurvatureInfo>& GetCurvature() const
     {
@@ -22,36 +22,167 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <future>
 #include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
 #endif
 
+#include <Base/BoundBox.h>
+#include <Base/Exception.h>
+#include <Base/FileInfo.h>
+#include <Base/Stream.h>
+
 #include "Decimation.h"
+#include "Functional.h"
+#include "IO/ReaderPLY.h"
+#include "MeshIO.h"
 #include "MeshKernel.h"
 #include "Simplify.h"
 
+#include <QFile>
+
 
 using namespace MeshCore;
 
-MeshSimplify::MeshSimplify(MeshKernel& mesh)
-    : myKernel(mesh)
-{}
+namespace
+{
+// Interleaves the bits of the cell coordinates so that neighbouring cells get close codes
+uint32_t mortonCode(uint32_t x, uint32_t y, uint32_t z, int bits)
+{
+    uint32_t code = 0;
+    for (int i = 0; i < bits; i++) {
+        code |= ((x >> i) & 1U) << (3 * i);
+        code |= ((y >> i) & 1U) << (3 * i + 1);
+        code |= ((z >> i) & 1U) << (3 * i + 2);
+    }
+    return code;
+}
 
-void MeshSimplify::simplify(float tolerance, float reduction)
+// Calls \a func for each index in [0, count) from \a threads worker threads where each thread
+// takes the next index when it is done with the previous one
+template<class Func>
+void forEachIndex(std::size_t count, int threads, Func func)
 {
-    Simplify alg;
+    std::atomic<std::size_t> next {0};
+    auto worker = [&]() {
+        std::size_t index {};
+        while ((index = next++) < count) {
+            func(index);
+        }
+    };
 
-    const MeshPointArray& points = myKernel.GetPoints();
-    for (std::size_t i = 0; i < points.size(); i++) {
+    std::vector<std::future<void>> futures;
+    for (int i = 1; i < threads; i++) {
+        futures.push_back(std::async(std::launch::async, worker));
+    }
+    worker();
+    for (auto& future : futures) {
+        future.get();
+    }
+}
+
+// Splits the facets into regions of about the same size along the Morton curve of their
+// centroids. With \a shift set the grid is moved by half a region so that the borders of the
+// regions fall into the interior of the regions without shift.
+std::vector<std::vector<FacetIndex>> partitionFacets(const MeshPointArray& points,
+                                                     const MeshFacetArray& facets,
+                                                     std::size_t numRegions,
+                                                     bool shift,
+                                                     int threads)
+{
+    constexpr int bits = 10;
+    constexpr uint32_t gridSize = 1U << bits;
+
+    Base::BoundBox3f bbox;
+    for (const auto& point : points) {
+        bbox.Add(point);
+    }
+
+    Base::Vector3f offset;
+    if (shift) {
+        float cells = std::cbrt(float(numRegions));
+        offset.Set(0.5F * bbox.LengthX() / cells,
+                   0.5F * bbox.LengthY() / cells,
+                   0.5F * bbox.LengthZ() / cells);
+    }
+
+    auto coord = [](float value, float minValue, float length) {
+        if (length <= 0.0F) {
+            return 0U;
+        }
+        auto index = static_cast<int64_t>((value - minValue) / length * float(gridSize));
+        return static_cast<uint32_t>(std::clamp<int64_t>(index, 0, gridSize - 1));
+    };
+
+    std::vector<std::pair<uint32_t, FacetIndex>> codes(facets.size());
+    MeshCore::parallel_for(
+        facets.size(),
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) {
+                const MeshFacet& facet = facets[i];
+                Base::Vector3f center = (points[facet._aulPoints[0]] + points[facet._aulPoints[1]]
+                                         + points[facet._aulPoints[2]])
+                        / 3.0F
+                    + offset;
+                codes[i].first = mortonCode(coord(center.x, bbox.MinX, bbox.LengthX()),
+                                            coord(center.y, bbox.MinY, bbox.LengthY()),
+                                            coord(center.z, bbox.MinZ, bbox.LengthZ()),
+                                            bits);
+                codes[i].second = i;
+            }
+        },
+        threads);
+    MeshCore::parallel_sort(codes.begin(), codes.end(), std::less<>(), threads);
+
+    std::vector<std::vector<FacetIndex>> regions(numRegions);
+    std::size_t regionSize = codes.size() / numRegions + 1;
+    for (std::size_t i = 0; i < codes.size(); i++) {
+        regions[i / regionSize].push_back(codes[i].second);
+    }
+
+    return regions;
+}
+
+// Simplifies the facets of a region. The positions of the points that are not locked are
+// updated in \a points, the remaining facets are returned.
+MeshFacetArray simplifyRegion(MeshPointArray& points,
+                              const MeshFacetArray& facets,
+                              const std::vector<FacetIndex>& region,
+                              const std::vector<bool>& locked,
+                              int targetSize,
+                              float tolerance)
+{
+    std::vector<PointIndex> ids;
+    ids.reserve(3 * region.size());
+    for (FacetIndex index : region) {
+        const MeshFacet& facet = facets[index];
+        ids.insert(ids.end(), facet._aulPoints, facet._aulPoints + 3);
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+    Simplify alg;
+    alg.vertices.reserve(ids.size());
+    for (std::size_t i = 0; i < ids.size(); i++) {
         Simplify::Vertex v;
         v.tstart = 0;
         v.tcount = 0;
         v.border = 0;
-        v.p = points[i];
+        v.p = points[ids[i]];
+        v.id = int(i);
+        v.locked = locked[ids[i]];
         alg.vertices.push_back(v);
     }
 
-    const MeshFacetArray& facets = myKernel.GetFacets();
-    for (std::size_t i = 0; i < facets.size(); i++) {
+    alg.triangles.reserve(region.size());
+    for (FacetIndex index : region) {
+        const MeshFacet& facet = facets[index];
         Simplify::Triangle t;
         t.deleted = 0;
         t.dirty = 0;
@@ -59,45 +190,120 @@ void MeshSimplify::simplify(float tolerance, float reduction)
             j = 0.0;
         }
         for (int j = 0; j < 3; j++) {
-            t.v[j] = facets[i]._aulPoints[j];
+            t.v[j] = int(std::lower_bound(ids.begin(), ids.end(), facet._aulPoints[j]) - ids.begin());
         }
         alg.triangles.push_back(t);
     }
 
-    int target_count = static_cast<int>(static_cast<float>(facets.size()) * (1.0F - reduction));
-
-    // Simplification starts
-    alg.simplify_mesh(target_count, tolerance);
+    alg.simplify_mesh(targetSize, tolerance);
 
-    // Simplification done
-    MeshPointArray new_points;
-    new_points.reserve(alg.vertices.size());
+    // only the region owns its unlocked points
     for (const auto& vertex : alg.vertices) {
-        new_points.push_back(vertex.p);
+        PointIndex index = ids[vertex.id];
+        if (!locked[index]) {
+            points[index] = vertex.p;
+        }
     }
 
-    std::size_t numFacets = 0;
+    MeshFacetArray result;
+    result.reserve(alg.triangles.size());
     for (const auto& triangle : alg.triangles) {
-        if (!triangle.deleted) {
-            numFacets++;
+        MeshFacet face;
+        for (int j = 0; j < 3; j++) {
+            face._aulPoints[j] = ids[alg.vertices[triangle.v[j]].id];
         }
+        result.push_back(face);
     }
-    MeshFacetArray new_facets;
-    new_facets.reserve(numFacets);
-    for (const auto& triangle : alg.triangles) {
-        if (!triangle.deleted) {
-            MeshFacet face;
-            face._aulPoints[0] = triangle.v[0];
-            face._aulPoints[1] = triangle.v[1];
-            face._aulPoints[2] = triangle.v[2];
-            new_facets.push_back(face);
+
+    return result;
+}
+}  // namespace
+
+MeshSimplify::MeshSimplify(MeshKernel& mesh)
+    : myKernel(mesh)
+{}
+
+void MeshSimplify::SetThreads(int value)
+{
+    threads = value;
+}
+
+void MeshSimplify::simplify(float tolerance, float reduction)
+{
+    const MeshFacetArray& facets = myKernel.GetFacets();
+    int target_count = static_cast<int>(static_cast<float>(facets.size()) * (1.0F - reduction));
+    decimate(target_count, tolerance);
+}
+
+void MeshSimplify::simplify(int targetSize)
+{
+    decimate(targetSize, std::numeric_limits<float>::max());
+}
+
+void MeshSimplify::decimate(int targetSize, float tolerance)
+{
+    // Minimum number of facets of a region worth to be simplified in parallel
+    constexpr std::size_t minRegionSize = 20000;
+    // More regions than threads balance the load of the threads
+    constexpr std::size_t regionsPerThread = 4;
+
+    int numThreads = threads > 0 ? threads : int(std::thread::hardware_concurrency());
+    std::size_t numFacets = myKernel.CountFacets();
+    if (numThreads > 1 && numFacets >= 2 * minRegionSize && numFacets > std::size_t(targetSize)) {
+        std::size_t numRegions = std::min(std::size_t(numThreads) * regionsPerThread,
+                                          numFacets / minRegionSize);
+
+        MeshPointArray points = myKernel.GetPoints();
+        MeshFacetArray facets = myKernel.GetFacets();
+
+        // Simplify the regions independently while their shared points are locked. The second
+        // pass uses shifted regions to also simplify along the borders of the first pass.
+        for (int pass = 0; pass < 2 && facets.size() > std::size_t(targetSize); pass++) {
+            std::vector<std::vector<FacetIndex>> regions =
+                partitionFacets(points, facets, numRegions, pass == 1, numThreads);
+
+            std::vector<int> owner(points.size(), -1);
+            std::vector<bool> locked(points.size(), false);
+            for (std::size_t i = 0; i < regions.size(); i++) {
+                for (FacetIndex index : regions[i]) {
+                    for (PointIndex point : facets[index]._aulPoints) {
+                        if (owner[point] < 0) {
+                            owner[point] = int(i);
+                        }
+                        else if (owner[point] != int(i)) {
+                            locked[point] = true;
+                        }
+                    }
+                }
+            }
+
+            double ratio = double(targetSize) / double(facets.size());
+            std::vector<MeshFacetArray> results(regions.size());
+            forEachIndex(regions.size(), numThreads, [&](std::size_t index) {
+                int regionTarget = static_cast<int>(ratio * double(regions[index].size()));
+                results[index] =
+                    simplifyRegion(points, facets, regions[index], locked, regionTarget, tolerance);
+            });
+
+            facets.clear();
+            for (const auto& result : results) {
+                facets.insert(facets.end(), result.begin(), result.end());
+            }
         }
+
+        // remove the points of collapsed edges
+        MeshCleanup meshCleanup(points, facets);
+        meshCleanup.RemoveInvalids();
+        myKernel.Adopt(points, facets, true);
     }
 
-    myKernel.Adopt(new_points, new_facets, true);
+    // simplify the whole mesh if the target size is not reached yet
+    if (myKernel.CountFacets() > std::size_t(targetSize)) {
+        simplifyMesh(targetSize, tolerance);
+    }
 }
 
-void MeshSimplify::simplify(int targetSize)
+void MeshSimplify::simplifyMesh(int targetSize, float tolerance)
 {
     Simplify alg;
 
@@ -126,7 +332,7 @@ void MeshSimplify::simplify(int targetSize)
     }
 
     // Simplification starts
-    alg.simplify_mesh(targetSize, std::numeric_limits<float>::max());
+    alg.simplify_mesh(targetSize, tolerance);
 
     // Simplification done
     MeshPointArray new_points;
@@ -155,3 +361,412 @@ void MeshSimplify::simplify(int targetSize)
 
     myKernel.Adopt(new_points, new_facets, true);
 }
+
+// ----------------------------------------------------------------------------
+
+namespace
+{
+// Random access to the triangles of a memory-mapped mesh file
+class MappedFacets
+{
+public:
+    virtual ~MappedFacets() = default;
+    virtual std::size_t CountFacets() const = 0;
+    // returns false if the facet has invalid point indices
+    virtual bool GetFacet(std::size_t index, Base::Vector3f* points) const = 0;
+};
+
+class MappedSTL: public MappedFacets
+{
+public:
+    static constexpr std::size_t headerSize = 80 + sizeof(uint32_t);
+    static constexpr std::size_t facetSize = 50;
+
+    explicit MappedSTL(const char* data)
+        : data(data)
+    {
+        std::memcpy(&count, data + 80, sizeof(count));
+    }
+    std::size_t CountFacets() const override
+    {
+        return count;
+    }
+    bool GetFacet(std::size_t index, Base::Vector3f* points) const override
+    {
+        // skip the normal
+        float coords[9];
+        std::memcpy(coords, data + headerSize + index * facetSize + 12, sizeof(coords));
+        for (int i = 0; i < 3; i++) {
+            points[i].Set(coords[3 * i], coords[3 * i + 1], coords[3 * i + 2]);
+        }
+        return true;
+    }
+
+private:
+    const char* data;
+    uint32_t count {};
+};
+
+class MappedPLY: public MappedFacets
+{
+public:
+    MappedPLY()
+        : reader(kernel)
+    {}
+    bool Map(const char* data, std::size_t size)
+    {
+        return reader.Map(data, size);
+    }
+    std::size_t CountFacets() const override
+    {
+        return reader.CountMappedFacets();
+    }
+    bool GetFacet(std::size_t index, Base::Vector3f* points) const override
+    {
+        PointIndex indices[3];
+        if (!reader.GetMappedFacet(index, indices)) {
+            return false;
+        }
+        for (int i = 0; i < 3; i++) {
+            points[i] = reader.GetMappedPoint(indices[i]);
+        }
+        return true;
+    }
+
+private:
+    MeshKernel kernel;
+    MeshCore::ReaderPLY reader;
+};
+
+// A facet as stored in the temporary file
+struct ChunkFacet
+{
+    float points[9];
+};
+
+// Simplifies the facets of a chunk. Points on the border of the chunk are kept.
+std::vector<ChunkFacet>
+simplifyChunk(const ChunkFacet* facets, std::size_t count, float tolerance, float reduction)
+{
+    struct Vertex
+    {
+        float x, y, z;
+        uint32_t i;
+
+        bool operator!=(const Vertex& rhs) const
+        {
+            return x != rhs.x || y != rhs.y || z != rhs.z;
+        }
+        bool operator<(const Vertex& rhs) const
+        {
+            if (x != rhs.x) {
+                return x < rhs.x;
+            }
+            if (y != rhs.y) {
+                return y < rhs.y;
+            }
+            return z < rhs.z;
+        }
+    };
+
+    // merge the points of the chunk
+    std::vector<Vertex> verts(3 * count);
+    for (std::size_t i = 0; i < verts.size(); i++) {
+        const float* pt = facets[i / 3].points + 3 * (i % 3);
+        verts[i] = Vertex {pt[0], pt[1], pt[2], uint32_t(i)};
+    }
+    std::sort(verts.begin(), verts.end());
+
+    Simplify alg;
+    alg.lock_border = true;
+    std::vector<int> indices(verts.size());
+    for (std::size_t i = 0; i < verts.size(); i++) {
+        const Vertex& v = verts[i];
+        if (i == 0 || v != verts[i - 1]) {
+            Simplify::Vertex vertex;
+            vertex.tstart = 0;
+            vertex.tcount = 0;
+            vertex.border = 0;
+            vertex.p.Set(v.x, v.y, v.z);
+            alg.vertices.push_back(vertex);
+        }
+        indices[v.i] = int(alg.vertices.size()) - 1;
+    }
+    verts.clear();
+    verts.shrink_to_fit();
+
+    alg.triangles.reserve(count);
+    for (std::size_t i = 0; i < count; i++) {
+        Simplify::Triangle t;
+        t.deleted = 0;
+        t.dirty = 0;
+        for (double& j : t.err) {
+            j = 0.0;
+        }
+        for (int j = 0; j < 3; j++) {
+            t.v[j] = indices[3 * i + j];
+        }
+        // skip degenerated facets
+        if (t.v[0] != t.v[1] && t.v[1] != t.v[2] && t.v[2] != t.v[0]) {
+            alg.triangles.push_back(t);
+        }
+    }
+    indices.clear();
+    indices.shrink_to_fit();
+
+    int target_count =
+        static_cast<int>(static_cast<float>(alg.triangles.size()) * (1.0F - reduction));
+    alg.simplify_mesh(target_count, tolerance);
+
+    std::vector<ChunkFacet> result;
+    result.reserve(alg.triangles.size());
+    for (const auto& triangle : alg.triangles) {
+        ChunkFacet facet {};
+        for (int j = 0; j < 3; j++) {
+            const vec3f& p = alg.vertices[triangle.v[j]].p;
+            facet.points[3 * j] = p.x;
+            facet.points[3 * j + 1] = p.y;
+            facet.points[3 * j + 2] = p.z;
+        }
+        result.push_back(facet);
+    }
+
+    return result;
+}
+}  // namespace
+
+void MeshStreamSimplify::SetMemoryBudget(std::size_t bytes)
+{
+    memoryBudget = bytes;
+}
+
+void MeshStreamSimplify::SetReduction(float value)
+{
+    reduction = value;
+}
+
+void MeshStreamSimplify::SetTolerance(float value)
+{
+    tolerance = value;
+}
+
+std::size_t MeshStreamSimplify::simplify(const std::string& input, const std::string& output)
+{
+    // Estimated memory per facet of a chunk, including the merged points, the quadrics and
+    // the facet references of the simplification
+    constexpr std::size_t bytesPerFacet = 256;
+    // Maximum resolution of the grid used to sort the facets into chunks
+    constexpr int maxGridBits = 7;
+
+    Base::FileInfo fi(input);
+    QFile file(QString::fromUtf8(fi.filePath().c_str()));
+    if (!file.open(QIODevice::ReadOnly) || file.size() <= 0) {
+        throw Base::FileException("Cannot open file", input.c_str());
+    }
+    uchar* memory = file.map(0, file.size());
+    if (!memory) {
+        throw Base::FileException("Cannot map file", input.c_str());
+    }
+
+    const char* data = reinterpret_cast<const char*>(memory);
+    auto size = static_cast<std::size_t>(file.size());
+    std::unique_ptr<MappedFacets> source;
+    if (fi.hasExtension("stl") && MeshInput::IsBinarySTL(data, size)) {
+        source = std::make_unique<MappedSTL>(data);
+    }
+    else if (fi.hasExtension("ply")) {
+        auto ply = std::make_unique<MappedPLY>();
+        if (ply->Map(data, size)) {
+            source = std::move(ply);
+        }
+    }
+    if (!source) {
+        throw Base::FileException("Only binary STL and binary little-endian PLY files with "
+                                  "triangles are supported",
+                                  input.c_str());
+    }
+
+    std::size_t numFacets = source->CountFacets();
+    int threads = std::max(1, int(std::thread::hardware_concurrency()));
+
+    // bounding box of all facets
+    Base::BoundBox3f bbox;
+    std::mutex mutex;
+    MeshCore::parallel_for(
+        numFacets,
+        [&](std::size_t begin, std::size_t end) {
+            Base::BoundBox3f box;
+            Base::Vector3f points[3];
+            for (std::size_t i = begin; i < end; i++) {
+                if (source->GetFacet(i, points)) {
+                    box.Add(points[0]);
+                    box.Add(points[1]);
+                    box.Add(points[2]);
+                }
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            bbox.Add(box);
+        },
+        threads);
+
+    // choose a grid that is fine enough to group its cells into chunks of the wanted size
+    std::size_t chunkSize = std::max<std::size_t>(memoryBudget / (bytesPerFacet * threads), 1000);
+    std::size_t numCells = 8 * (numFacets / chunkSize + 1);
+    int bits = 0;
+    while (bits < maxGridBits && (std::size_t(1) << (3 * bits)) < numCells) {
+        bits++;
+    }
+    uint32_t gridSize = 1U << bits;
+
+    auto cellOfFacet = [&](const Base::Vector3f* points) {
+        Base::Vector3f center = (points[0] + points[1] + points[2]) / 3.0F;
+        auto coord = [gridSize](float value, float minValue, float length) {
+            if (length <= 0.0F) {
+                return 0U;
+            }
+            auto index = static_cast<int64_t>((value - minValue) / length * float(gridSize));
+            return static_cast<uint32_t>(std::clamp<int64_t>(index, 0, gridSize - 1));
+        };
+        return mortonCode(coord(center.x, bbox.MinX, bbox.LengthX()),
+                          coord(center.y, bbox.MinY, bbox.LengthY()),
+                          coord(center.z, bbox.MinZ, bbox.LengthZ()),
+                          bits);
+    };
+
+    // count the facets per cell
+    std::size_t cellCount = std::size_t(1) << (3 * bits);
+    std::vector<std::atomic<std::size_t>> cursor(cellCount);
+    MeshCore::parallel_for(
+        numFacets,
+        [&](std::size_t begin, std::size_t end) {
+            Base::Vector3f points[3];
+            for (std::size_t i = begin; i < end; i++) {
+                if (source->GetFacet(i, points)) {
+                    cursor[cellOfFacet(points)]++;
+                }
+            }
+        },
+        threads);
+
+    // the cells are ordered along the Morton curve so that consecutive cells form compact chunks
+    std::vector<std::size_t> offsets(cellCount + 1, 0);
+    std::vector<std::pair<std::size_t, std::size_t>> chunks;
+    std::size_t chunkBegin = 0;
+    for (std::size_t i = 0; i < cellCount; i++) {
+        std::size_t count = cursor[i];
+        if (offsets[i] > chunkBegin && offsets[i] - chunkBegin + count > chunkSize) {
+            chunks.emplace_back(chunkBegin, offsets[i]);
+            chunkBegin = offsets[i];
+        }
+        offsets[i + 1] = offsets[i] + count;
+        cursor[i] = offsets[i];
+    }
+    std::size_t numValid = offsets[cellCount];
+    if (numValid > chunkBegin) {
+        chunks.emplace_back(chunkBegin, numValid);
+    }
+
+    // sort the facets into a temporary file so that each chunk is a contiguous block
+    std::string tempName =
+        Base::FileInfo::getTempFileName(nullptr, Base::FileInfo(output).dirPath().c_str());
+    QFile temp(QString::fromUtf8(tempName.c_str()));
+    if (!temp.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+        throw Base::FileException("Cannot create temporary file", tempName.c_str());
+    }
+    std::size_t tempSize = std::max<std::size_t>(numValid, 1) * sizeof(ChunkFacet);
+    uchar* tempMemory = nullptr;
+    if (temp.resize(qint64(tempSize))) {
+        tempMemory = temp.map(0, qint64(tempSize));
+    }
+    if (!tempMemory) {
+        temp.remove();
+        throw Base::FileException("Cannot map temporary file", tempName.c_str());
+    }
+
+    auto chunkFacets = reinterpret_cast<ChunkFacet*>(tempMemory);
+    MeshCore::parallel_for(
+        numFacets,
+        [&](std::size_t begin, std::size_t end) {
+            Base::Vector3f points[3];
+            for (std::size_t i = begin; i < end; i++) {
+                if (source->GetFacet(i, points)) {
+                    ChunkFacet& facet = chunkFacets[cursor[cellOfFacet(points)]++];
+                    for (int j = 0; j < 3; j++) {
+                        facet.points[3 * j] = points[j].x;
+                        facet.points[3 * j + 1] = points[j].y;
+                        facet.points[3 * j + 2] = points[j].z;
+                    }
+                }
+            }
+        },
+        threads);
+
+    cursor.clear();
+    cursor.shrink_to_fit();
+    source.reset();
+    file.unmap(memory);
+    file.close();
+
+    Base::FileInfo fo(output);
+    Base::ofstream str(fo, std::ios::out | std::ios::binary);
+    if (!str) {
+        temp.remove();
+        throw Base::FileException("Cannot open file", output.c_str());
+    }
+
+    // the number of facets is written when all chunks are done
+    std::string header = "Simplified by FreeCAD";
+    header.resize(80, ' ');
+    uint32_t numOutput = 0;
+    str.write(header.c_str(), 80);
+    str.write(reinterpret_cast<const char*>(&numOutput), sizeof(numOutput));
+
+    // each thread simplifies one chunk at a time so that the memory stays within the budget
+    std::atomic<std::size_t> nextChunk {0};
+    std::size_t written = 0;
+    auto worker = [&]() {
+        std::size_t index {};
+        while ((index = nextChunk++) < chunks.size()) {
+            const auto& chunk = chunks[index];
+            std::vector<ChunkFacet> result = simplifyChunk(chunkFacets + chunk.first,
+                                                           chunk.second - chunk.first,
+                                                           tolerance,
+                                                           reduction);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto& facet : result) {
+                Base::Vector3f p1(facet.points[0], facet.points[1], facet.points[2]);
+                Base::Vector3f p2(facet.points[3], facet.points[4], facet.points[5]);
+                Base::Vector3f p3(facet.points[6], facet.points[7], facet.points[8]);
+                Base::Vector3f normal = (p2 - p1) % (p3 - p1);
+                normal.Normalize();
+                uint16_t attribute = 0;
+                str.write(reinterpret_cast<const char*>(&normal.x), 3 * sizeof(float));
+                str.write(reinterpret_cast<const char*>(facet.points), sizeof(facet.points));
+                str.write(reinterpret_cast<const char*>(&attribute), sizeof(attribute));
+            }
+            written += result.size();
+        }
+    };
+
+    std::vector<std::future<void>> futures;
+    for (int i = 1; i < threads; i++) {
+        futures.push_back(std::async(std::launch::async, worker));
+    }
+    worker();
+    for (auto& future : futures) {
+        future.get();
+    }
+
+    temp.unmap(tempMemory);
+    temp.remove();
+
+    numOutput = static_cast<uint32_t>(std::min<std::size_t>(written, UINT32_MAX));
+    str.seekp(80);
+    str.write(reinterpret_cast<const char*>(&numOutput), sizeof(numOutput));
+    if (!str) {
+        throw Base::FileException("Failed to write file", output.c_str());
+    }
+
+    return written;
+}
@@ -24,6 +24,8 @@
 #ifndef MESH_DECIMATION_H
 #define MESH_DECIMATION_H
 
+#include <cstddef>
+#include <string>
 #include <Mod/Mesh/MeshGlobal.h>
 
 namespace MeshCore
@@ -34,11 +36,54 @@ class MeshExport MeshSimplify
 {
 public:
     explicit MeshSimplify(MeshKernel&);
+    /**
+     * Sets the number of threads, 0 uses all cores and 1 disables the parallel decimation.
+     * Bigger meshes are split into spatial regions that are simplified concurrently while the
+     * points shared by regions are kept. The region borders are simplified in a second pass
+     * with shifted regions and a final pass over the whole mesh if needed.
+     */
+    void SetThreads(int);
     void simplify(float tolerance, float reduction);
     void simplify(int targetSize);
 
+private:
+    void decimate(int targetSize, float tolerance);
+    void simplifyMesh(int targetSize, float tolerance);
+
 private:
     MeshKernel& myKernel;
+    int threads {0};
+};
+
+/**
+ * Simplifies a binary STL or PLY file that may be too big to be loaded at once. The facets
+ * are sorted into spatially clustered chunks and the chunks are simplified in parallel while
+ * keeping their borders fixed. The reduced chunks are written to a binary STL file where
+ * they share the same border points.
+ * The memory budget limits the size of the chunks that are processed at the same time.
+ */
+class MeshExport MeshStreamSimplify
+{
+public:
+    MeshStreamSimplify() = default;
+    /// Sets the memory budget in bytes, the default is 1 GB
+    void SetMemoryBudget(std::size_t bytes);
+    /// Sets the fraction of facets to be removed, the default is 0.5
+    void SetReduction(float reduction);
+    /// Sets the tolerance of the quadric error, the default is unlimited
+    void SetTolerance(float tolerance);
+    /**
+     * Simplifies the mesh of the file \a input and writes the result to the STL file \a output.
+     * Throws a Base::FileException if a file cannot be accessed or the input is not a binary
+     * STL or binary little-endian PLY file.
+     * Returns the number of written facets.
+     */
+    std::size_t simplify(const std::string& input, const std::string& output);
+
+private:
+    std::size_t memoryBudget {std::size_t(1) << 30};
+    float reduction {0.5F};
+    float tolerance {0.0F};
 };
 
 }  // namespace MeshCore
@@ -24,6 +24,8 @@
 
 #ifndef _PreComp_
 #include <algorithm>
+#include <atomic>
+#include <thread>
 #include <vector>
 #endif
 
@@ -32,10 +34,11 @@
 
 #include "Algorithm.h"
 #include "Approximation.h"
+#include "BVH.h"
 #include "Evaluation.h"
 #include "Functional.h"
-#include "Grid.h"
 #include "Iterator.h"
+#include "Storage.h"
 #include "TopoAlgorithm.h"
 
 
@@ -311,25 +314,82 @@ struct Edge_Index
     FacetIndex f;
 };
 
-struct Edge_Less
+/*
+ * Sorts the edges by their point indices and edges with the same points by facet.
+ * Instead of a comparison sort the edges are distributed with a counting sort over
+ * their smaller point index and only the few edges per point are sorted afterwards.
+ * All steps run in parallel. Unless the point indices are very sparse \a offsets
+ * holds the first edge of every point afterwards, otherwise it's empty.
+ */
+static void sortEdges(std::vector<Edge_Index>& edges, std::vector<std::size_t>& offsets)
 {
-    bool operator()(const Edge_Index& x, const Edge_Index& y) const
-    {
-        if (x.p0 < y.p0) {
-            return true;
-        }
-        if (x.p0 > y.p0) {
-            return false;
-        }
-        if (x.p1 < y.p1) {
-            return true;
+    int threads = int(std::thread::hardware_concurrency());
+    offsets.clear();
+
+    PointIndex maxPoint = 0;
+    for (const auto& edge : edges) {
+        maxPoint = std::max(maxPoint, edge.p0);
+    }
+
+    auto lessEdge = [](const Edge_Index& x, const Edge_Index& y) {
+        if (x.p0 != y.p0) {
+            return x.p0 < y.p0;
         }
-        if (x.p1 > y.p1) {
-            return false;
+        if (x.p1 != y.p1) {
+            return x.p1 < y.p1;
         }
-        return false;
+        return x.f < y.f;
+    };
+
+    // e.g. invalid point indices, the buckets would need too much memory
+    if (maxPoint > 2 * edges.size()) {
+        MeshCore::parallel_sort(edges.begin(), edges.end(), lessEdge, threads);
+        return;
+    }
+
+    std::size_t numPoints = maxPoint + 1;
+    std::vector<std::atomic<std::size_t>> cursors(numPoints);
+    MeshCore::parallel_for(
+        edges.size(),
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t pos = begin; pos < end; pos++) {
+                cursors[edges[pos].p0].fetch_add(1, std::memory_order_relaxed);
+            }
+        },
+        threads);
+
+    offsets.resize(numPoints + 1);
+    offsets[0] = 0;
+    for (std::size_t index = 0; index < numPoints; index++) {
+        std::size_t count = cursors[index].load(std::memory_order_relaxed);
+        cursors[index].store(offsets[index], std::memory_order_relaxed);
+        offsets[index + 1] = offsets[index] + count;
     }
-};
+
+    std::vector<Edge_Index> sorted(edges.size());
+    MeshCore::parallel_for(
+        edges.size(),
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t pos = begin; pos < end; pos++) {
+                const Edge_Index& edge = edges[pos];
+                sorted[cursors[edge.p0].fetch_add(1, std::memory_order_relaxed)] = edge;
+            }
+        },
+        threads);
+
+    MeshCore::parallel_for(
+        numPoints,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t index = begin; index < end; index++) {
+                std::sort(sorted.begin() + offsets[index],
+                          sorted.begin() + offsets[index + 1],
+                          lessEdge);
+            }
+        },
+        threads);
+
+    edges.swap(sorted);
+}
 
 }  // namespace MeshCore
 
@@ -357,7 +417,8 @@ bool MeshEvalTopology::Evaluate()
     }
 
     // sort the edges
-    std::sort(edges.begin(), edges.end(), Edge_Less());
+    std::vector<std::size_t> offsets;
+    sortEdges(edges, offsets);
 
     // search for non-manifold edges
     PointIndex p0 = POINT_INDEX_MAX, p1 = POINT_INDEX_MAX;
@@ -475,16 +536,15 @@ bool MeshEvalPointManifolds::Evaluate()
     this->nonManifoldPoints.clear();
     this->facetsOfNonManifoldPoints.clear();
 
-    MeshCore::MeshRefPointToPoints vv_it(_rclMesh);
-    MeshCore::MeshRefPointToFacets vf_it(_rclMesh);
+    MeshCore::MeshPointNeighbours neighbours(_rclMesh);
 
     unsigned long ctPoints = _rclMesh.CountPoints();
     for (PointIndex index = 0; index < ctPoints; index++) {
         // get the local neighbourhood of the point
-        const std::set<FacetIndex>& nf = vf_it[index];
-        const std::set<PointIndex>& np = vv_it[index];
+        std::span<const FacetIndex> nf = neighbours.GetFacets(index);
+        std::span<const PointIndex> np = neighbours.GetPoints(index);
 
-        std::set<unsigned long>::size_type sp {}, sf {};
+        std::size_t sp {}, sf {};
         sp = np.size();
         sf = nf.size();
         // for an inner point the number of adjacent points is equal to the number of shared faces
@@ -597,17 +657,31 @@ bool MeshFixSingleFacet::Fixup()
 
 // ----------------------------------------------------------------
 
+namespace
+{
+// If the facets share a common vertex we do not check for self-intersections
+// because they could but usually do not intersect each other and the algorithm
+// would detect false-positives, otherwise
+bool shareCommonVertex(const MeshFacet& rface1, const MeshFacet& rface2)
+{
+    for (PointIndex pt1 : rface1._aulPoints) {
+        if (pt1 == rface2._aulPoints[0] || pt1 == rface2._aulPoints[1]
+            || pt1 == rface2._aulPoints[2]) {
+            return true;
+        }
+    }
+    return false;
+}
+}  // namespace
+
 bool MeshEvalSelfIntersection::Evaluate()
 {
     // Contains bounding boxes for every facet
     std::vector<Base::BoundBox3f> boxes;
 
-    // Splits the mesh using grid for speeding up the calculation
-    MeshFacetGrid cMeshFacetGrid(_rclMesh);
+    // The hierarchy adapts to the facet density and reports every pair only once
+    MeshFacetBVH cMeshFacetBVH(_rclMesh);
     const MeshFacetArray& rFaces = _rclMesh.GetFacets();
-    MeshGridIterator clGridIter(cMeshFacetGrid);
-    unsigned long ulGridX {}, ulGridY {}, ulGridZ {};
-    cMeshFacetGrid.GetCtGrids(ulGridX, ulGridY, ulGridZ);
 
     MeshFacetIterator cMFI(_rclMesh);
     for (cMFI.Begin(); cMFI.More(); cMFI.Next()) {
@@ -615,58 +689,35 @@ bool MeshEvalSelfIntersection::Evaluate()
     }
 
     // Calculates the intersections
-    Base::SequencerLauncher seq("Checking for self-intersections...", ulGridX * ulGridY * ulGridZ);
-    for (clGridIter.Init(); clGridIter.More(); clGridIter.Next()) {
-        // Get the facet indices, belonging to the current grid unit
-        std::vector<FacetIndex> aulGridElements;
-        clGridIter.GetElements(aulGridElements);
-
+    Base::SequencerLauncher seq("Checking for self-intersections...", rFaces.size());
+    std::vector<FacetIndex> aulElements;
+    MeshGeomFacet facet1, facet2;
+    Base::Vector3f pt1, pt2;
+    for (FacetIndex index = 0; index < rFaces.size(); index++) {
         seq.next();
-        if (aulGridElements.empty()) {
-            continue;
-        }
 
-        MeshGeomFacet facet1, facet2;
-        Base::Vector3f pt1, pt2;
-        for (auto it = aulGridElements.begin(); it != aulGridElements.end(); ++it) {
-            const Base::BoundBox3f& box1 = boxes[*it];
-            cMFI.Set(*it);
-            facet1 = *cMFI;
-            const MeshFacet& rface1 = rFaces[*it];
-            for (auto jt = it; jt != aulGridElements.end(); ++jt) {
-                if (jt == it) {  // the identical facet
-                    continue;
-                }
-                // If the facets share a common vertex we do not check for self-intersections
-                // because they could but usually do not intersect each other and the algorithm
-                // below would detect false-positives, otherwise
-                const MeshFacet& rface2 = rFaces[*jt];
-                if (rface1._aulPoints[0] == rface2._aulPoints[0]
-                    || rface1._aulPoints[0] == rface2._aulPoints[1]
-                    || rface1._aulPoints[0] == rface2._aulPoints[2]) {
-                    continue;  // ignore facets sharing a common vertex
-                }
-                if (rface1._aulPoints[1] == rface2._aulPoints[0]
-                    || rface1._aulPoints[1] == rface2._aulPoints[1]
-                    || rface1._aulPoints[1] == rface2._aulPoints[2]) {
-                    continue;  // ignore facets sharing a common vertex
-                }
-                if (rface1._aulPoints[2] == rface2._aulPoints[0]
-                    || rface1._aulPoints[2] == rface2._aulPoints[1]
-                    || rface1._aulPoints[2] == rface2._aulPoints[2]) {
-                    continue;  // ignore facets sharing a common vertex
-                }
+        // Get the facets whose bounding boxes overlap with the current facet
+        aulElements.clear();
+        cMeshFacetBVH.Inside(boxes[index], aulElements);
+
+        cMFI.Set(index);
+        facet1 = *cMFI;
+        const MeshFacet& rface1 = rFaces[index];
+        for (FacetIndex jndex : aulElements) {
+            // test each pair only once and skip the identical facet
+            if (jndex <= index) {
+                continue;
+            }
+            if (shareCommonVertex(rface1, rFaces[jndex])) {
+                continue;
+            }
 
-                const Base::BoundBox3f& box2 = boxes[*jt];
-                if (box1 && box2) {
-                    cMFI.Set(*jt);
-                    facet2 = *cMFI;
-                    int ret = facet1.IntersectWithFacet(facet2, pt1, pt2);
-                    if (ret == 2) {
-                        // abort after the first detected self-intersection
-                        return false;
-                    }
-                }
+            cMFI.Set(jndex);
+            facet2 = *cMFI;
+            int ret = facet1.IntersectWithFacet(facet2, pt1, pt2);
+            if (ret == 2) {
+                // abort after the first detected self-intersection
+                return false;
             }
         }
     }
@@ -706,12 +757,9 @@ void MeshEvalSelfIntersection::GetIntersections(
     std::vector<Base::BoundBox3f> boxes;
     // intersection.clear();
 
-    // Splits the mesh using grid for speeding up the calculation
-    MeshFacetGrid cMeshFacetGrid(_rclMesh);
+    // The hierarchy adapts to the facet density and reports every pair only once
+    MeshFacetBVH cMeshFacetBVH(_rclMesh);
     const MeshFacetArray& rFaces = _rclMesh.GetFacets();
-    MeshGridIterator clGridIter(cMeshFacetGrid);
-    unsigned long ulGridX {}, ulGridY {}, ulGridZ {};
-    cMeshFacetGrid.GetCtGrids(ulGridX, ulGridY, ulGridZ);
 
     MeshFacetIterator cMFI(_rclMesh);
     for (cMFI.Begin(); cMFI.More(); cMFI.Next()) {
@@ -719,57 +767,35 @@ void MeshEvalSelfIntersection::GetIntersections(
     }
 
     // Calculates the intersections
-    Base::SequencerLauncher seq("Checking for self-intersections...", ulGridX * ulGridY * ulGridZ);
-    for (clGridIter.Init(); clGridIter.More(); clGridIter.Next()) {
-        // Get the facet indices, belonging to the current grid unit
-        std::vector<FacetIndex> aulGridElements;
-        clGridIter.GetElements(aulGridElements);
-
+    Base::SequencerLauncher seq("Checking for self-intersections...", rFaces.size());
+    std::vector<FacetIndex> aulElements;
+    MeshGeomFacet facet1, facet2;
+    Base::Vector3f pt1, pt2;
+    for (FacetIndex index = 0; index < rFaces.size(); index++) {
         seq.next(true);
-        if (aulGridElements.empty()) {
-            continue;
-        }
 
-        MeshGeomFacet facet1, facet2;
-        Base::Vector3f pt1, pt2;
-        for (auto it = aulGridElements.begin(); it != aulGridElements.end(); ++it) {
-            const Base::BoundBox3f& box1 = boxes[*it];
-            cMFI.Set(*it);
-            facet1 = *cMFI;
-            const MeshFacet& rface1 = rFaces[*it];
-            for (auto jt = it; jt != aulGridElements.end(); ++jt) {
-                if (jt == it) {  // the identical facet
-                    continue;
-                }
-                // If the facets share a common vertex we do not check for self-intersections
-                // because they could but usually do not intersect each other and the algorithm
-                // below would detect false-positives, otherwise
-                const MeshFacet& rface2 = rFaces[*jt];
-                if (rface1._aulPoints[0] == rface2._aulPoints[0]
-                    || rface1._aulPoints[0] == rface2._aulPoints[1]
-                    || rface1._aulPoints[0] == rface2._aulPoints[2]) {
-                    continue;  // ignore facets sharing a common vertex
-                }
-                if (rface1._aulPoints[1] == rface2._aulPoints[0]
-                    || rface1._aulPoints[1] == rface2._aulPoints[1]
-                    || rface1._aulPoints[1] == rface2._aulPoints[2]) {
-                    continue;  // ignore facets sharing a common vertex
-                }
-                if (rface1._aulPoints[2] == rface2._aulPoints[0]
-                    || rface1._aulPoints[2] == rface2._aulPoints[1]
-                    || rface1._aulPoints[2] == rface2._aulPoints[2]) {
-                    continue;  // ignore facets sharing a common vertex
-                }
+        // Get the facets whose bounding boxes overlap with the current facet
+        aulElements.clear();
+        cMeshFacetBVH.Inside(boxes[index], aulElements);
+        std::sort(aulElements.begin(), aulElements.end());
+
+        cMFI.Set(index);
+        facet1 = *cMFI;
+        const MeshFacet& rface1 = rFaces[index];
+        for (FacetIndex jndex : aulElements) {
+            // test each pair only once and skip the identical facet
+            if (jndex <= index) {
+                continue;
+            }
+            if (shareCommonVertex(rface1, rFaces[jndex])) {
+                continue;
+            }
 
-                const Base::BoundBox3f& box2 = boxes[*jt];
-                if (box1 && box2) {
-                    cMFI.Set(*jt);
-                    facet2 = *cMFI;
-                    int ret = facet1.IntersectWithFacet(facet2, pt1, pt2);
-                    if (ret == 2) {
-                        intersection.emplace_back(*it, *jt);
-                    }
-                }
+            cMFI.Set(jndex);
+            facet2 = *cMFI;
+            int ret = facet1.IntersectWithFacet(facet2, pt1, pt2);
+            if (ret == 2) {
+                intersection.emplace_back(index, jndex);
             }
         }
     }
@@ -806,7 +832,8 @@ std::vector<FacetIndex> MeshFixSelfIntersection::GetFacets() const
 
 bool MeshFixSelfIntersection::Fixup()
 {
-    _rclMesh.DeleteFacets(GetFacets());
+    deletedFaces = GetFacets();
+    _rclMesh.DeleteFacets(deletedFaces);
     return true;
 }
 
@@ -844,7 +871,8 @@ bool MeshEvalNeighbourhood::Evaluate()
     }
 
     // sort the edges
-    std::sort(edges.begin(), edges.end(), Edge_Less());
+    std::vector<std::size_t> offsets;
+    sortEdges(edges, offsets);
 
     PointIndex p0 = POINT_INDEX_MAX, p1 = POINT_INDEX_MAX;
     PointIndex f0 = FACET_INDEX_MAX, f1 = FACET_INDEX_MAX;
@@ -911,7 +939,8 @@ std::vector<FacetIndex> MeshEvalNeighbourhood::GetIndices() const
     }
 
     // sort the edges
-    std::sort(edges.begin(), edges.end(), Edge_Less());
+    std::vector<std::size_t> offsets;
+    sortEdges(edges, offsets);
 
     PointIndex p0 = POINT_INDEX_MAX, p1 = POINT_INDEX_MAX;
     PointIndex f0 = FACET_INDEX_MAX, f1 = FACET_INDEX_MAX;
@@ -968,73 +997,72 @@ bool MeshFixNeighbourhood::Fixup()
 
 void MeshKernel::RebuildNeighbours(FacetIndex index)
 {
-    std::vector<Edge_Index> edges;
-    edges.reserve(3 * (this->_aclFacetArray.size() - index));
+    int threads = int(std::thread::hardware_concurrency());
+    std::size_t numFacets = this->_aclFacetArray.size() - index;
+    std::vector<Edge_Index> edges(3 * numFacets);
 
     // build up an array of edges
-    auto pB = this->_aclFacetArray.begin();
-    for (auto pI = pB + index; pI != this->_aclFacetArray.end(); ++pI) {
-        for (int i = 0; i < 3; i++) {
-            Edge_Index item {};
-            item.p0 = std::min<PointIndex>(pI->_aulPoints[i], pI->_aulPoints[(i + 1) % 3]);
-            item.p1 = std::max<PointIndex>(pI->_aulPoints[i], pI->_aulPoints[(i + 1) % 3]);
-            item.f = pI - pB;
-            edges.push_back(item);
-        }
-    }
+    MeshCore::parallel_for(
+        numFacets,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t pos = begin; pos < end; pos++) {
+                const MeshFacet& rFace = this->_aclFacetArray[index + pos];
+                for (int i = 0; i < 3; i++) {
+                    PointIndex ulT0 = rFace._aulPoints[i];
+                    PointIndex ulT1 = rFace._aulPoints[(i + 1) % 3];
+                    Edge_Index& item = edges[3 * pos + i];
+                    item.p0 = std::min<PointIndex>(ulT0, ulT1);
+                    item.p1 = std::max<PointIndex>(ulT0, ulT1);
+                    item.f = index + pos;
+                }
+            }
+        },
+        threads);
 
     // sort the edges
-    // std::sort(edges.begin(), edges.end(), Edge_Less());
-    int threads = int(std::thread::hardware_concurrency());
-    MeshCore::parallel_sort(edges.begin(), edges.end(), Edge_Less(), threads);
+    std::vector<std::size_t> offsets;
+    sortEdges(edges, offsets);
+
+    // Every side of a facet belongs to exactly one edge, so ranges of edges
+    // that don't split a group of equal edges can be handled in parallel
+    auto setNeighbours = [this](std::vector<Edge_Index>::const_iterator pB,
+                                std::vector<Edge_Index>::const_iterator pE) {
+        for (auto pI = pB; pI != pE;) {
+            auto pN = pI + 1;
+            while (pN != pE && pN->p0 == pI->p0 && pN->p1 == pI->p1) {
+                ++pN;
+            }
 
-    PointIndex p0 = POINT_INDEX_MAX, p1 = POINT_INDEX_MAX;
-    PointIndex f0 = FACET_INDEX_MAX, f1 = FACET_INDEX_MAX;
-    int count = 0;
-    std::vector<Edge_Index>::iterator pE;
-    for (pE = edges.begin(); pE != edges.end(); ++pE) {
-        if (p0 == pE->p0 && p1 == pE->p1) {
-            f1 = pE->f;
-            count++;
-        }
-        else {
             // we handle only the cases for 1 and 2, for all higher
             // values we have a non-manifold that is ignored here
-            if (count == 2) {
-                MeshFacet& rFace0 = this->_aclFacetArray[f0];
-                MeshFacet& rFace1 = this->_aclFacetArray[f1];
-                unsigned short side0 = rFace0.Side(p0, p1);
-                unsigned short side1 = rFace1.Side(p0, p1);
-                rFace0._aulNeighbours[side0] = f1;
-                rFace1._aulNeighbours[side1] = f0;
+            if (pN - pI == 2) {
+                MeshFacet& rFace0 = this->_aclFacetArray[pI->f];
+                MeshFacet& rFace1 = this->_aclFacetArray[(pI + 1)->f];
+                unsigned short side0 = rFace0.Side(pI->p0, pI->p1);
+                unsigned short side1 = rFace1.Side(pI->p0, pI->p1);
+                rFace0._aulNeighbours[side0] = (pI + 1)->f;
+                rFace1._aulNeighbours[side1] = pI->f;
             }
-            else if (count == 1) {
-                MeshFacet& rFace = this->_aclFacetArray[f0];
-                unsigned short side = rFace.Side(p0, p1);
+            else if (pN - pI == 1) {
+                MeshFacet& rFace = this->_aclFacetArray[pI->f];
+                unsigned short side = rFace.Side(pI->p0, pI->p1);
                 rFace._aulNeighbours[side] = FACET_INDEX_MAX;
             }
 
-            p0 = pE->p0;
-            p1 = pE->p1;
-            f0 = pE->f;
-            count = 1;
+            pI = pN;
         }
-    }
+    };
 
-    // we handle only the cases for 1 and 2, for all higher
-    // values we have a non-manifold that is ignored here
-    if (count == 2) {
-        MeshFacet& rFace0 = this->_aclFacetArray[f0];
-        MeshFacet& rFace1 = this->_aclFacetArray[f1];
-        unsigned short side0 = rFace0.Side(p0, p1);
-        unsigned short side1 = rFace1.Side(p0, p1);
-        rFace0._aulNeighbours[side0] = f1;
-        rFace1._aulNeighbours[side1] = f0;
+    if (offsets.empty()) {
+        setNeighbours(edges.begin(), edges.end());
     }
-    else if (count == 1) {
-        MeshFacet& rFace = this->_aclFacetArray[f0];
-        unsigned short side = rFace.Side(p0, p1);
-        rFace._aulNeighbours[side] = FACET_INDEX_MAX;
+    else {
+        MeshCore::parallel_for(
+            offsets.size() - 1,
+            [&](std::size_t begin, std::size_t end) {
+                setNeighbours(edges.begin() + offsets[begin], edges.begin() + offsets[end]);
+            },
+            threads);
     }
 }
 
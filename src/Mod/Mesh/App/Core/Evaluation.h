@@ -354,7 +354,13 @@ public:
     std::vector<FacetIndex> GetFacets() const;
     bool Fixup() override;
 
+    const std::vector<FacetIndex>& GetDeletedFaces() const
+    {
+        return deletedFaces;
+    }
+
 private:
+    std::vector<FacetIndex> deletedFaces;
     const std::vector<std::pair<FacetIndex, FacetIndex>>& selfIntersectons;
 };
 
@@ -25,6 +25,7 @@
 
 #include <algorithm>
 #include <future>
+#include <vector>
 
 
 namespace MeshCore
@@ -62,6 +63,27 @@ static void parallel_sort(Iter begin, Iter end, Pred comp, int threads)
     }
 }
 
+/// Calls \a func(begin, end) for consecutive ranges of [0, count) with up to \a threads threads
+template<class Func>
+static void parallel_for(std::size_t count, Func func, int threads)
+{
+    std::size_t chunk = count / std::max(threads, 1) + 1;
+    if (threads < 2 || count < 2) {
+        func(std::size_t(0), count);
+    }
+    else {
+        std::vector<std::future<void>> futures;
+        for (std::size_t begin = chunk; begin < count; begin += chunk) {
+            futures.push_back(
+                std::async(std::launch::async, func, begin, std::min(begin + chunk, count)));
+        }
+        func(std::size_t(0), std::min(chunk, count));
+        for (auto& future : futures) {
+            future.get();
+        }
+    }
+}
+
 }  // namespace MeshCore
 
 
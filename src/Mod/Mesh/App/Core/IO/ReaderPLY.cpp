@@ -23,10 +23,17 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+#include <atomic>
+#include <bit>
 #include <boost/lexical_cast.hpp>
+#include <cstring>
 #include <istream>
+#include <sstream>
+#include <string_view>
+#include <thread>
 #endif
 
+#include "Core/Functional.h"
 #include "Core/MeshIO.h"
 #include "Core/MeshKernel.h"
 #include <Base/Stream.h>
@@ -154,14 +161,8 @@ ReaderPLY::Property ReaderPLY::propertyOfName(const std::string& name)
     return generic;
 }
 
-bool ReaderPLY::ReadVertexProperty(std::istream& str)
+bool ReaderPLY::numberOfType(const std::string& type, Number& number)
 {
-    std::string type;
-    std::string name;
-    char space {};
-    str >> space >> std::ws >> type >> space >> std::ws >> name >> std::ws;
-
-    Number number {};
     if (type == "char" || type == "int8") {
         number = int8;
     }
@@ -191,6 +192,76 @@ bool ReaderPLY::ReadVertexProperty(std::istream& str)
         return false;
     }
 
+    return true;
+}
+
+std::size_t ReaderPLY::sizeOfNumber(Number number)
+{
+    switch (number) {
+        case int8:
+        case uint8:
+            return 1;
+        case int16:
+        case uint16:
+            return 2;
+        case int32:
+        case uint32:
+        case float32:
+            return 4;
+        case float64:
+            return 8;
+    }
+
+    return 0;
+}
+
+namespace
+{
+template<typename T>
+T readValue(const char* data)
+{
+    T value {};
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+}  // namespace
+
+double ReaderPLY::readNumber(const char* data, Number number)
+{
+    switch (number) {
+        case int8:
+            return readValue<int8_t>(data);
+        case uint8:
+            return readValue<uint8_t>(data);
+        case int16:
+            return readValue<int16_t>(data);
+        case uint16:
+            return readValue<uint16_t>(data);
+        case int32:
+            return readValue<int32_t>(data);
+        case uint32:
+            return readValue<uint32_t>(data);
+        case float32:
+            return readValue<float>(data);
+        case float64:
+            return readValue<double>(data);
+    }
+
+    return 0.0;
+}
+
+bool ReaderPLY::ReadVertexProperty(std::istream& str)
+{
+    std::string type;
+    std::string name;
+    char space {};
+    str >> space >> std::ws >> type >> space >> std::ws >> name >> std::ws;
+
+    Number number {};
+    if (!numberOfType(type, number)) {
+        return false;
+    }
+
     // store the property name and type
     vertex_props.emplace_back(propertyOfName(name), number);
 
@@ -217,38 +288,18 @@ bool ReaderPLY::ReadFaceProperty(std::istream& str)
     }
     if (name != "vertex_indices" && name != "vertex_index") {
         Number number {};
-        if (type == "char" || type == "int8") {
-            number = int8;
-        }
-        else if (type == "uchar" || type == "uint8") {
-            number = uint8;
-        }
-        else if (type == "short" || type == "int16") {
-            number = int16;
-        }
-        else if (type == "ushort" || type == "uint16") {
-            number = uint16;
-        }
-        else if (type == "int" || type == "int32") {
-            number = int32;
-        }
-        else if (type == "uint" || type == "uint32") {
-            number = uint32;
-        }
-        else if (type == "float" || type == "float32") {
-            number = float32;
-        }
-        else if (type == "double" || type == "float64") {
-            number = float64;
-        }
-        else {
-            // no valid number type
+        if (!numberOfType(type, number)) {
             return false;
         }
 
         // store the property name and type
         face_props.push_back(number);
     }
+    else if (list == "list") {
+        // store the types of the vertex list
+        face_list_known =
+            numberOfType(uchr, face_list_count) && numberOfType(type, face_list_index);
+    }
     return true;
 }
 
@@ -662,3 +713,176 @@ bool ReaderPLY::LoadBinary(std::istream& input)
     CleanupMesh();
     return true;
 }
+
+bool ReaderPLY::Map(const char* data, std::size_t size)
+{
+    if constexpr (std::endian::native != std::endian::little) {
+        return false;
+    }
+
+    // the header is plain text and ends with the 'end_header' line
+    std::string_view buffer(data, size);
+    std::size_t pos = buffer.find("end_header");
+    if (pos != std::string_view::npos) {
+        pos = buffer.find('\n', pos);
+    }
+    if (pos == std::string_view::npos) {
+        return false;
+    }
+
+    std::istringstream input(std::string(buffer.substr(0, pos + 1)));
+    if (!CheckHeader(input)) {
+        return false;
+    }
+
+    if (!ReadHeader(input)) {
+        return false;
+    }
+
+    if (!VerifyVertexProperty()) {
+        return false;
+    }
+
+    // only binary little-endian files with the vertex indices as sole face property
+    if (format != binary_little_endian || !face_props.empty() || !face_list_known) {
+        return false;
+    }
+
+    vertex_offsets.clear();
+    vertex_size = 0;
+    for (const auto& it : vertex_props) {
+        vertex_offsets.push_back(vertex_size);
+        vertex_size += sizeOfNumber(it.second);
+    }
+
+    face_index_offset = sizeOfNumber(face_list_count);
+    face_index_size = sizeOfNumber(face_list_index);
+    face_size = face_index_offset + 3 * face_index_size;
+
+    size -= pos + 1;
+    if (v_count > size / vertex_size) {
+        return false;
+    }
+    if (f_count > (size - v_count * vertex_size) / face_size) {
+        return false;
+    }
+
+    const char* vertexData = data + pos + 1;
+    const char* faceData = vertexData + v_count * vertex_size;
+
+    // faces other than triangles are handled by the stream-based reader
+    std::atomic<bool> triangles {true};
+    MeshCore::parallel_for(
+        f_count,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end && triangles; i++) {
+                if (readNumber(faceData + i * face_size, face_list_count) != 3.0) {
+                    triangles = false;
+                }
+            }
+        },
+        int(std::thread::hardware_concurrency()));
+    if (!triangles) {
+        return false;
+    }
+
+    mapped_vertices = vertexData;
+    mapped_faces = faceData;
+    return true;
+}
+
+std::size_t ReaderPLY::CountMappedPoints() const
+{
+    return mapped_vertices ? v_count : 0;
+}
+
+std::size_t ReaderPLY::CountMappedFacets() const
+{
+    return mapped_faces ? f_count : 0;
+}
+
+void ReaderPLY::GetMappedPoint(std::size_t index, PropertyArray& prop) const
+{
+    const char* vertex = mapped_vertices + index * vertex_size;
+    for (std::size_t j = 0; j < vertex_props.size(); j++) {
+        prop[vertex_props[j].first] =
+            static_cast<float>(readNumber(vertex + vertex_offsets[j], vertex_props[j].second));
+    }
+}
+
+Base::Vector3f ReaderPLY::GetMappedPoint(std::size_t index) const
+{
+    PropertyArray prop {};
+    GetMappedPoint(index, prop);
+    return Base::Vector3f(prop[coord_x], prop[coord_y], prop[coord_z]);
+}
+
+bool ReaderPLY::GetMappedFacet(std::size_t index, PointIndex* points) const
+{
+    const char* face = mapped_faces + index * face_size + face_index_offset;
+    for (int j = 0; j < 3; j++) {
+        double value = readNumber(face + j * face_index_size, face_list_index);
+        if (value < 0.0 || value >= double(v_count)) {
+            return false;
+        }
+        points[j] = PointIndex(value);
+    }
+
+    return true;
+}
+
+bool ReaderPLY::Load(const char* data, std::size_t size)
+{
+    if (!Map(data, size)) {
+        return false;
+    }
+
+    if (!VerifyColorProperty()) {
+        return false;
+    }
+
+    std::size_t colorOffset = 0;
+    bool colors = _material && _material->binding == MeshIO::PER_VERTEX;
+    if (colors) {
+        colorOffset = _material->diffuseColor.size();
+        _material->diffuseColor.resize(colorOffset + v_count);
+    }
+
+    int threads = int(std::thread::hardware_concurrency());
+    meshPoints.resize(v_count);
+    MeshCore::parallel_for(
+        v_count,
+        [&](std::size_t begin, std::size_t end) {
+            PropertyArray prop {};
+            for (std::size_t i = begin; i < end; i++) {
+                GetMappedPoint(i, prop);
+                meshPoints[i].Set(prop[coord_x], prop[coord_y], prop[coord_z]);
+                if (colors) {
+                    // NOLINTBEGIN
+                    float r = (prop[color_r]) / 255.0F;
+                    float g = (prop[color_g]) / 255.0F;
+                    float b = (prop[color_b]) / 255.0F;
+                    // NOLINTEND
+                    _material->diffuseColor[colorOffset + i] = Base::Color(r, g, b);
+                }
+            }
+        },
+        threads);
+
+    // facets with indices out of range are removed in CleanupMesh()
+    meshFacets.resize(f_count);
+    MeshCore::parallel_for(
+        f_count,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) {
+                MeshFacet& facet = meshFacets[i];
+                if (!GetMappedFacet(i, facet._aulPoints)) {
+                    facet._aulPoints[0] = POINT_INDEX_MAX;
+                }
+            }
+        },
+        threads);
+
+    CleanupMesh();
+    return true;
+}
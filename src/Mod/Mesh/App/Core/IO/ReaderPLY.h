@@ -53,6 +53,28 @@ public:
      * \return true on success and false otherwise
      */
     bool Load(std::istream& input);
+    /*!
+     * \brief Load the mesh from the memory block \a data of \a size bytes, e.g. a
+     * memory-mapped file. Only binary little-endian files with triangles are handled
+     * and the vertices and faces are decoded in parallel.
+     * \return true on success and false if the data cannot be handled this way
+     */
+    bool Load(const char* data, std::size_t size);
+    /*!
+     * \brief Give random access to the points and triangles of the memory block \a data
+     * without loading the whole mesh. The same restrictions as for Load() apply and the
+     * memory block must be kept alive while being accessed.
+     * \return true on success and false if the data cannot be accessed this way
+     */
+    bool Map(const char* data, std::size_t size);
+    std::size_t CountMappedPoints() const;
+    std::size_t CountMappedFacets() const;
+    Base::Vector3f GetMappedPoint(std::size_t index) const;
+    /*!
+     * \brief Get the point indices of the triangle \a index
+     * \return false if an index is out of range
+     */
+    bool GetMappedFacet(std::size_t index, PointIndex* points) const;
 
 private:
     bool CheckHeader(std::istream& input) const;
@@ -88,6 +110,7 @@ private:
     static Property propertyOfName(const std::string& name);
     using PropertyArray = std::array<float, num_props>;
     void addVertexProperty(const PropertyArray& prop);
+    void GetMappedPoint(std::size_t index, PropertyArray& prop) const;
 
     enum Number
     {
@@ -101,6 +124,10 @@ private:
         float64
     };
 
+    static bool numberOfType(const std::string& type, Number& number);
+    static std::size_t sizeOfNumber(Number number);
+    static double readNumber(const char* data, Number number);
+
     struct PropertyComp
     {
         using argument_type_1st = std::pair<Property, int>;
@@ -126,6 +153,17 @@ private:
 
     std::vector<std::pair<Property, Number>> vertex_props;
     std::vector<Number> face_props;
+    Number face_list_count = uint8;
+    Number face_list_index = uint32;
+    bool face_list_known = true;
+
+    const char* mapped_vertices = nullptr;
+    const char* mapped_faces = nullptr;
+    std::vector<std::size_t> vertex_offsets;
+    std::size_t vertex_size = 0;
+    std::size_t face_size = 0;
+    std::size_t face_index_offset = 0;
+    std::size_t face_index_size = 0;
 
     std::size_t v_count = 0;
     std::size_t f_count = 0;
@@ -21,68 +21,54 @@
  ***************************************************************************/
 
 #include "PreCompiled.h"
-#ifdef _MSC_VER
-#pragma warning(disable : 4396)
+#ifndef _PreComp_
+#include <atomic>
+#include <mutex>
 #endif
 
+#include <Base/KDTree.h>
+
 #include "KDTree.h"
-#include <kdtree++/kdtree.hpp>
 
 
 using namespace MeshCore;
 
-struct Point3d
+namespace
 {
-    using value_type = float;
-
-    Point3d(const Base::Vector3f& f, PointIndex i)
-        : p(f)
-        , i(i)
-    {}
-
-    Point3d(const Point3d& pnt) = default;
-
-    Point3d(Point3d&& pnt)
-        : p(pnt.p)
-        , i(pnt.i)
-    {}
-
-    ~Point3d() = default;
-
-    inline value_type operator[](const int N) const
-    {
-        return p[N];
-    }
-
-    inline bool operator==(const Point3d& other) const
-    {
-        return (this->p) == (other.p);
-    }
+PointIndex toPointIndex(Base::KDTree::index_type index)
+{
+    return index == Base::KDTree::InvalidIndex ? POINT_INDEX_MAX : PointIndex(index);
+}
+}  // namespace
 
-    inline bool operator!=(const Point3d& other) const
+// The points are collected and the static tree is rebuilt on the next query after points
+// have been added.
+class MeshKDTree::Private
+{
+public:
+    const Base::KDTree& getTree()
     {
-        return (this->p) != (other.p);
+        if (dirty.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (dirty.load(std::memory_order_relaxed)) {
+                kd_tree.build(points.data(), points.size());
+                dirty.store(false, std::memory_order_release);
+            }
+        }
+        return kd_tree;
     }
 
-    inline Point3d& operator=(const Point3d& other) = default;
-
-    inline Point3d& operator=(Point3d&& other)
+    template<typename Points>
+    void addPoints(const Points& pts)
     {
-        this->p = other.p;
-        this->i = other.i;
-        return *this;
+        points.insert(points.end(), pts.begin(), pts.end());
+        dirty = true;
     }
 
-    Base::Vector3f p;
-    PointIndex i;
-};
-
-using MyKDTree = KDTree::KDTree<3, Point3d>;
-
-class MeshKDTree::Private
-{
-public:
-    MyKDTree kd_tree;
+    std::vector<Base::Vector3f> points;
+    Base::KDTree kd_tree;
+    std::atomic<bool> dirty {false};
+    std::mutex mutex;
 };
 
 MeshKDTree::MeshKDTree()
@@ -92,19 +78,13 @@ MeshKDTree::MeshKDTree()
 MeshKDTree::MeshKDTree(const std::vector<Base::Vector3f>& points)
     : d(new Private)
 {
-    PointIndex index = 0;
-    for (auto it : points) {
-        d->kd_tree.insert(Point3d(it, index++));
-    }
+    d->addPoints(points);
 }
 
 MeshKDTree::MeshKDTree(const MeshPointArray& points)
     : d(new Private)
 {
-    PointIndex index = 0;
-    for (const auto& it : points) {
-        d->kd_tree.insert(Point3d(it, index++));
-    }
+    d->addPoints(points);
 }
 
 MeshKDTree::~MeshKDTree()
@@ -114,52 +94,40 @@ MeshKDTree::~MeshKDTree()
 
 void MeshKDTree::AddPoint(const Base::Vector3f& point)
 {
-    PointIndex index = d->kd_tree.size();
-    d->kd_tree.insert(Point3d(point, index));
+    d->points.push_back(point);
+    d->dirty = true;
 }
 
 void MeshKDTree::AddPoints(const std::vector<Base::Vector3f>& points)
 {
-    PointIndex index = d->kd_tree.size();
-    for (auto it : points) {
-        d->kd_tree.insert(Point3d(it, index++));
-    }
+    d->addPoints(points);
 }
 
 void MeshKDTree::AddPoints(const MeshPointArray& points)
 {
-    PointIndex index = d->kd_tree.size();
-    for (const auto& it : points) {
-        d->kd_tree.insert(Point3d(it, index++));
-    }
+    d->addPoints(points);
 }
 
 bool MeshKDTree::IsEmpty() const
 {
-    return d->kd_tree.empty();
+    return d->points.empty();
 }
 
 void MeshKDTree::Clear()
 {
+    d->points.clear();
     d->kd_tree.clear();
+    d->dirty = false;
 }
 
 void MeshKDTree::Optimize()
 {
-    d->kd_tree.optimize();
+    d->getTree();
 }
 
 PointIndex MeshKDTree::FindNearest(const Base::Vector3f& p, Base::Vector3f& n, float& dist) const
 {
-    std::pair<MyKDTree::const_iterator, MyKDTree::distance_type> it =
-        d->kd_tree.find_nearest(Point3d(p, 0));
-    if (it.first == d->kd_tree.end()) {
-        return POINT_INDEX_MAX;
-    }
-    PointIndex index = it.first->i;
-    n = it.first->p;
-    dist = it.second;
-    return index;
+    return FindNearest(p, std::numeric_limits<float>::max(), n, dist);
 }
 
 PointIndex MeshKDTree::FindNearest(const Base::Vector3f& p,
@@ -167,35 +135,62 @@ PointIndex MeshKDTree::FindNearest(const Base::Vector3f& p,
                                    Base::Vector3f& n,
                                    float& dist) const
 {
-    std::pair<MyKDTree::const_iterator, MyKDTree::distance_type> it =
-        d->kd_tree.find_nearest(Point3d(p, 0), max_dist);
-    if (it.first == d->kd_tree.end()) {
-        return POINT_INDEX_MAX;
+    PointIndex index = toPointIndex(d->getTree().findNearest(p, dist, max_dist));
+    if (index != POINT_INDEX_MAX) {
+        n = d->points[index];
     }
-    PointIndex index = it.first->i;
-    n = it.first->p;
-    dist = it.second;
     return index;
 }
 
 PointIndex MeshKDTree::FindExact(const Base::Vector3f& p) const
 {
-    MyKDTree::const_iterator it = d->kd_tree.find_exact(Point3d(p, 0));
-    if (it == d->kd_tree.end()) {
-        return POINT_INDEX_MAX;
+    const float eps = std::numeric_limits<float>::epsilon();
+    Base::BoundBox3f box(p.x - eps, p.y - eps, p.z - eps, p.x + eps, p.y + eps, p.z + eps);
+    std::vector<Base::KDTree::index_type> indices;
+    d->getTree().findInBox(box, indices);
+    for (auto index : indices) {
+        if (d->points[index] == p) {
+            return index;
+        }
     }
-    PointIndex index = it->i;
-    return index;
+    return POINT_INDEX_MAX;
 }
 
 void MeshKDTree::FindInRange(const Base::Vector3f& p,
                              float range,
                              std::vector<PointIndex>& indices) const
 {
-    std::vector<Point3d> v;
-    d->kd_tree.find_within_range(Point3d(p, 0), range, std::back_inserter(v));
-    indices.reserve(v.size());
-    for (const auto& it : v) {
-        indices.push_back(it.i);
-    }
+    Base::BoundBox3f box(p.x - range,
+                         p.y - range,
+                         p.z - range,
+                         p.x + range,
+                         p.y + range,
+                         p.z + range);
+    std::vector<Base::KDTree::index_type> found;
+    d->getTree().findInBox(box, found);
+    indices.insert(indices.end(), found.begin(), found.end());
+}
+
+void MeshKDTree::FindNearest(const std::vector<Base::Vector3f>& points,
+                             std::size_t k,
+                             std::vector<PointIndex>& indices,
+                             std::vector<float>& distances,
+                             float max_dist) const
+{
+    std::vector<Base::KDTree::index_type> found(points.size() * k);
+    distances.resize(points.size() * k);
+    d->getTree()
+        .findNearest(points.data(), points.size(), k, found.data(), distances.data(), max_dist);
+    indices.resize(found.size());
+    std::transform(found.begin(), found.end(), indices.begin(), toPointIndex);
+}
+
+void MeshKDTree::FindInRadius(const std::vector<Base::Vector3f>& points,
+                              float radius,
+                              std::vector<std::size_t>& offsets,
+                              std::vector<PointIndex>& indices) const
+{
+    std::vector<Base::KDTree::index_type> found;
+    d->getTree().findInRadius(points.data(), points.size(), radius, offsets, found);
+    indices.assign(found.begin(), found.end());
 }
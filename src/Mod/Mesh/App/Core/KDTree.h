@@ -51,6 +51,22 @@ public:
     PointIndex FindExact(const Base::Vector3f& p) const;
     void FindInRange(const Base::Vector3f&, float, std::vector<PointIndex>&) const;
 
+    /** Searches for the \a k nearest points of each point of \a points on all cores. The
+     * neighbours of point i start at i * \a k, missing neighbours are POINT_INDEX_MAX.
+     */
+    void FindNearest(const std::vector<Base::Vector3f>& points,
+                     std::size_t k,
+                     std::vector<PointIndex>& indices,
+                     std::vector<float>& distances,
+                     float max_dist = std::numeric_limits<float>::max()) const;
+    /** Searches for the points within \a radius of each point of \a points on all cores. The
+     * neighbours of point i are stored in \a indices from \a offsets[i] to \a offsets[i + 1].
+     */
+    void FindInRadius(const std::vector<Base::Vector3f>& points,
+                      float radius,
+                      std::vector<std::size_t>& offsets,
+                      std::vector<PointIndex>& indices) const;
+
     MeshKDTree(const MeshKDTree&) = delete;
     MeshKDTree(MeshKDTree&&) = delete;
     void operator=(const MeshKDTree&) = delete;
@@ -26,8 +26,10 @@
 #include <algorithm>
 #include <cmath>
 #include <iomanip>
+#include <cstring>
 #include <sstream>
 #include <string_view>
+#include <thread>
 #endif
 
 #include <boost/algorithm/string.hpp>
@@ -35,6 +37,7 @@
 #include <boost/convert/spirit.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/regex.hpp>
+#include <QFile>
 
 #include "IO/Reader3MF.h"
 #include "IO/ReaderOBJ.h"
@@ -58,6 +61,7 @@
 #include "Builder.h"
 #include "Definitions.h"
 #include "Degeneration.h"
+#include "Functional.h"
 #include "Iterator.h"
 #include "MeshIO.h"
 #include "MeshKernel.h"
@@ -231,6 +235,11 @@ bool MeshInput::LoadAny(const char* FileName)
         throw Base::FileException("No permission on the file", FileName);
     }
 
+    // binary STL and PLY files are parsed directly from the mapped file
+    if (fi.hasExtension({"stl", "ply"}) && LoadMappedFile(fi)) {
+        return true;
+    }
+
     Base::ifstream str(fi, std::ios::in | std::ios::binary);
 
     if (fi.hasExtension("bms")) {
@@ -858,6 +867,150 @@ bool MeshInput::LoadBinarySTL(std::istream& input)
     return true;
 }
 
+bool MeshInput::IsBinarySTL(const char* data, std::size_t size)
+{
+    constexpr std::size_t headerSize = 80 + sizeof(uint32_t);
+    constexpr std::size_t facetSize = 50;
+    if (size < headerSize) {
+        return false;
+    }
+
+    uint32_t ulCt {};
+    std::memcpy(&ulCt, data + 80, sizeof(ulCt));
+    if (ulCt > (size - headerSize) / facetSize) {
+        return false;  // not a valid STL file
+    }
+
+    // Same check for keywords of an ASCII STL file as done in LoadSTL()
+    std::size_t ulBytes = ulCt > 1 ? 100 : 50;
+    if (size < headerSize + ulBytes) {
+        return false;
+    }
+    char szBuf[101];
+    std::memcpy(szBuf, data + headerSize, ulBytes);
+    szBuf[ulBytes] = 0;
+    boost::algorithm::to_upper(szBuf);
+    return !strstr(szBuf, "SOLID") && !strstr(szBuf, "FACET") && !strstr(szBuf, "NORMAL")
+        && !strstr(szBuf, "VERTEX") && !strstr(szBuf, "ENDFACET") && !strstr(szBuf, "ENDLOOP");
+}
+
+bool MeshInput::LoadBinarySTL(const char* data, std::size_t size)
+{
+    if (!IsBinarySTL(data, size)) {
+        return false;
+    }
+
+    constexpr std::size_t headerSize = 80 + sizeof(uint32_t);
+    constexpr std::size_t facetSize = 50;
+    uint32_t ulCt {};
+    std::memcpy(&ulCt, data + 80, sizeof(ulCt));
+
+    // the point indices must fit into 32 bit
+    std::size_t numVerts = 3 * std::size_t(ulCt);
+    if (numVerts > std::numeric_limits<uint32_t>::max()) {
+        return false;
+    }
+
+    struct Vertex
+    {
+        float x, y, z;
+        uint32_t i;
+
+        bool operator!=(const Vertex& rhs) const
+        {
+            return x != rhs.x || y != rhs.y || z != rhs.z;
+        }
+        bool operator<(const Vertex& rhs) const
+        {
+            if (x != rhs.x) {
+                return x < rhs.x;
+            }
+            if (y != rhs.y) {
+                return y < rhs.y;
+            }
+            return z < rhs.z;
+        }
+    };
+
+    // read in the corner points of all facets, the order of the corners is the same as in
+    // LoadBinarySTL(std::istream&)
+    std::vector<Vertex> verts(numVerts);
+    int threads = int(std::thread::hardware_concurrency());
+    MeshCore::parallel_for(
+        ulCt,
+        [&](std::size_t begin, std::size_t end) {
+            static const int corner[3] = {3, 1, 2};
+            float coords[12];
+            for (std::size_t i = begin; i < end; i++) {
+                std::memcpy(coords, data + headerSize + i * facetSize, sizeof(coords));
+                for (int j = 0; j < 3; j++) {
+                    Vertex& v = verts[3 * i + j];
+                    v.x = coords[3 * corner[j]];
+                    v.y = coords[3 * corner[j] + 1];
+                    v.z = coords[3 * corner[j] + 2];
+                    v.i = uint32_t(3 * i + j);
+                }
+            }
+        },
+        threads);
+
+    MeshCore::parallel_sort(verts.begin(), verts.end(), std::less<>(), threads);
+
+    // merge duplicated points
+    std::size_t numPoints = 0;
+    for (std::size_t i = 0; i < verts.size(); i++) {
+        if (i == 0 || verts[i] != verts[i - 1]) {
+            numPoints++;
+        }
+    }
+
+    MeshPointArray rPoints;
+    rPoints.reserve(numPoints);
+    MeshFacetArray rFacets(ulCt);
+    for (std::size_t i = 0; i < verts.size(); i++) {
+        const Vertex& v = verts[i];
+        if (i == 0 || v != verts[i - 1]) {
+            rPoints.push_back(MeshPoint(v.x, v.y, v.z));
+        }
+        rFacets[v.i / 3]._aulPoints[v.i % 3] = PointIndex(rPoints.size() - 1);
+    }
+
+    verts.clear();
+    verts.shrink_to_fit();
+    _rclMesh.Adopt(rPoints, rFacets, true);
+
+    return true;
+}
+
+bool MeshInput::LoadMappedFile(const Base::FileInfo& fi)
+{
+    // If the file cannot be mapped or has a format that is not handled for a memory block the
+    // caller falls back to the stream-based readers
+    QFile file(QString::fromUtf8(fi.filePath().c_str()));
+    if (!file.open(QIODevice::ReadOnly) || file.size() <= 0) {
+        return false;
+    }
+
+    uchar* memory = file.map(0, file.size());
+    if (!memory) {
+        return false;
+    }
+
+    const char* data = reinterpret_cast<const char*>(memory);
+    std::size_t size = static_cast<std::size_t>(file.size());
+    bool ok = false;
+    if (fi.hasExtension("stl")) {
+        ok = LoadBinarySTL(data, size);
+    }
+    else {
+        ReaderPLY reader(this->_rclMesh, this->_material);
+        ok = reader.Load(data, size);
+    }
+
+    file.unmap(memory);
+    return ok;
+}
+
 /** Loads the mesh object from an XML file. */
 void MeshInput::LoadXML(Base::XMLReader& reader)
 {
@@ -2921,51 +3074,57 @@ MeshPointFacetAdjacency::MeshPointFacetAdjacency(std::size_t p, MeshFacetArray&
 
 void MeshPointFacetAdjacency::Build()
 {
-    std::vector<std::size_t> numFacetAdjacency(numPoints);
+    pointOffsets.assign(numPoints + 1, 0);
     for (const auto& it : facets) {
-        numFacetAdjacency[it._aulPoints[0]]++;
-        numFacetAdjacency[it._aulPoints[1]]++;
-        numFacetAdjacency[it._aulPoints[2]]++;
+        pointOffsets[it._aulPoints[0] + 1]++;
+        pointOffsets[it._aulPoints[1] + 1]++;
+        pointOffsets[it._aulPoints[2] + 1]++;
     }
 
-    pointFacetAdjacency.resize(numPoints);
     for (std::size_t i = 0; i < numPoints; i++) {
-        pointFacetAdjacency[i].reserve(numFacetAdjacency[i]);
+        pointOffsets[i + 1] += pointOffsets[i];
     }
 
+    pointFacets.resize(pointOffsets.back());
+    std::vector<std::size_t> insertPos(pointOffsets.begin(), pointOffsets.end() - 1);
     std::size_t numFacets = facets.size();
     for (std::size_t i = 0; i < numFacets; i++) {
         for (PointIndex ptIndex : facets[i]._aulPoints) {
-            pointFacetAdjacency[ptIndex].push_back(i);
+            pointFacets[insertPos[ptIndex]++] = i;
         }
     }
 }
 
 void MeshPointFacetAdjacency::SetFacetNeighbourhood()
 {
-    std::size_t numFacets = facets.size();
-    for (std::size_t index = 0; index < numFacets; index++) {
-        MeshFacet& facet1 = facets[index];
-        for (int i = 0; i < 3; i++) {
-            std::size_t n1 = facet1._aulPoints[i];
-            std::size_t n2 = facet1._aulPoints[(i + 1) % 3];
-
-            bool success = false;
-            const std::vector<std::size_t>& refFacets = pointFacetAdjacency[n1];
-            for (std::size_t it : refFacets) {
-                if (it != index) {
-                    MeshFacet& facet2 = facets[it];
-                    if (facet2.HasPoint(n2)) {
-                        facet1._aulNeighbours[i] = it;
-                        success = true;
-                        break;
+    // every facet only modifies its own neighbours, so the facets can be handled in parallel
+    auto setNeighbours = [this](std::size_t begin, std::size_t end) {
+        for (std::size_t index = begin; index < end; index++) {
+            MeshFacet& facet1 = facets[index];
+            for (int i = 0; i < 3; i++) {
+                std::size_t n1 = facet1._aulPoints[i];
+                std::size_t n2 = facet1._aulPoints[(i + 1) % 3];
+
+                bool success = false;
+                for (std::size_t pos = pointOffsets[n1]; pos < pointOffsets[n1 + 1]; pos++) {
+                    FacetIndex it = pointFacets[pos];
+                    if (it != index) {
+                        const MeshFacet& facet2 = facets[it];
+                        if (facet2.HasPoint(n2)) {
+                            facet1._aulNeighbours[i] = it;
+                            success = true;
+                            break;
+                        }
                     }
                 }
-            }
 
-            if (!success) {
-                facet1._aulNeighbours[i] = FACET_INDEX_MAX;
+                if (!success) {
+                    facet1._aulNeighbours[i] = FACET_INDEX_MAX;
+                }
             }
         }
-    }
+    };
+
+    int threads = int(std::thread::hardware_concurrency());
+    MeshCore::parallel_for(facets.size(), setNeighbours, threads);
 }
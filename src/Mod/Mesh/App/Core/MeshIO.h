@@ -31,6 +31,7 @@
 
 namespace Base
 {
+class FileInfo;
 class XMLReader;
 class Writer;
 }  // namespace Base
@@ -131,6 +132,12 @@ public:
     bool LoadAsciiSTL(std::istream& input);
     /** Loads a binary STL file. */
     bool LoadBinarySTL(std::istream& input);
+    /** Loads a binary STL file from the memory block \a data of \a size bytes, e.g. a
+     * memory-mapped file. The facets are read and their points are merged in parallel.
+     */
+    bool LoadBinarySTL(const char* data, std::size_t size);
+    /** Checks if the memory block \a data of \a size bytes is a valid binary STL file. */
+    static bool IsBinarySTL(const char* data, std::size_t size);
     /** Loads an OBJ Mesh file. */
     bool LoadOBJ(std::istream& input);
     /** Loads an OBJ Mesh file. */
@@ -157,6 +164,9 @@ public:
     static std::vector<std::string> supportedMeshFormats();
     static MeshIO::Format getFormat(const char* FileName);
 
+private:
+    bool LoadMappedFile(const Base::FileInfo& fi);
+
 private:
     MeshKernel& _rclMesh; /**< reference to mesh data structure */
     Material* _material;
@@ -341,7 +351,9 @@ private:
 private:
     std::size_t numPoints;
     MeshFacetArray& facets;
-    std::vector<std::vector<std::size_t>> pointFacetAdjacency;
+    /// the facets of point i are pointFacets[pointOffsets[i]] to pointFacets[pointOffsets[i + 1]]
+    std::vector<std::size_t> pointOffsets;
+    std::vector<FacetIndex> pointFacets;
 };
 
 
@@ -23,12 +23,14 @@
 #include "PreCompiled.h"
 #ifndef _PreComp_
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <limits>
+#include <thread>
 #endif
 
-#include "Algorithm.h"
 #include "Approximation.h"
+#include "Functional.h"
 #include "Segmentation.h"
 
 using namespace MeshCore;
@@ -44,6 +46,11 @@ bool MeshSurfaceSegment::TestInitialFacet(FacetIndex) const
 void MeshSurfaceSegment::AddFacet(const MeshFacet&)
 {}
 
+MeshSurfaceSegmentPtr MeshSurfaceSegment::Clone() const
+{
+    return {};
+}
+
 void MeshSurfaceSegment::AddSegment(const std::vector<FacetIndex>& segm)
 {
     if (segm.size() >= minFacets) {
@@ -68,7 +75,7 @@ MeshDistancePlanarSegment::MeshDistancePlanarSegment(const MeshKernel& mesh,
                                                      unsigned long minFacets,
                                                      float tol)
     : MeshDistanceSurfaceSegment(mesh, minFacets, tol)
-    , fitter(new PlaneFit)
+    , fitter(new PlaneSurfaceFit)
 {}
 
 MeshDistancePlanarSegment::~MeshDistancePlanarSegment()
@@ -78,14 +85,8 @@ MeshDistancePlanarSegment::~MeshDistancePlanarSegment()
 
 void MeshDistancePlanarSegment::Initialize(FacetIndex index)
 {
-    fitter->Clear();
-
     MeshGeomFacet triangle = kernel.GetFacet(index);
-    basepoint = triangle.GetGravityPoint();
-    normal = triangle.GetNormal();
-    fitter->AddPoint(triangle._aclPoints[0]);
-    fitter->AddPoint(triangle._aclPoints[1]);
-    fitter->AddPoint(triangle._aclPoints[2]);
+    fitter->Initialize(triangle);
 }
 
 bool MeshDistancePlanarSegment::TestFacet(const MeshFacet& face) const
@@ -95,7 +96,7 @@ bool MeshDistancePlanarSegment::TestFacet(const MeshFacet& face) const
     }
     MeshGeomFacet triangle = kernel.GetFacet(face);
     for (auto pnt : triangle._aclPoints) {
-        if (std::fabs(fitter->GetDistanceToPlane(pnt)) > tolerance) {
+        if (std::fabs(fitter->GetDistanceToSurface(pnt)) > tolerance) {
             return false;
         }
     }
@@ -106,13 +107,25 @@ bool MeshDistancePlanarSegment::TestFacet(const MeshFacet& face) const
 void MeshDistancePlanarSegment::AddFacet(const MeshFacet& face)
 {
     MeshGeomFacet triangle = kernel.GetFacet(face);
-    fitter->AddPoint(triangle.GetGravityPoint());
+    fitter->AddTriangle(triangle);
+}
+
+MeshSurfaceSegmentPtr MeshDistancePlanarSegment::Clone() const
+{
+    return std::make_shared<MeshDistancePlanarSegment>(kernel, GetMinFacets(), tolerance);
+}
+
+// --------------------------------------------------------
+
+AbstractSurfaceFit* AbstractSurfaceFit::Clone() const
+{
+    return nullptr;
 }
 
 // --------------------------------------------------------
 
 PlaneSurfaceFit::PlaneSurfaceFit()
-    : fitter(new PlaneFit)
+    : fitter(new PointMoments)
 {}
 
 PlaneSurfaceFit::PlaneSurfaceFit(const Base::Vector3f& b, const Base::Vector3f& n)
@@ -137,7 +150,7 @@ void PlaneSurfaceFit::Initialize(const MeshCore::MeshGeomFacet& tria)
         fitter->AddPoint(tria._aclPoints[0]);
         fitter->AddPoint(tria._aclPoints[1]);
         fitter->AddPoint(tria._aclPoints[2]);
-        fitter->Fit();
+        Fit();
     }
 }
 
@@ -150,6 +163,7 @@ void PlaneSurfaceFit::AddTriangle(const MeshCore::MeshGeomFacet& tria)
 {
     if (fitter) {
         fitter->AddPoint(tria.GetGravityPoint());
+        fitted = false;
     }
 }
 
@@ -159,7 +173,7 @@ bool PlaneSurfaceFit::Done() const
         return true;
     }
 
-    return fitter->Done();
+    return fitted;
 }
 
 float PlaneSurfaceFit::Fit()
@@ -168,35 +182,42 @@ float PlaneSurfaceFit::Fit()
         return 0;
     }
 
-    return fitter->Fit();
+    // the sums of the points are kept, so this is done in constant time
+    Base::Vector3f base, norm;
+    float fit = fitter->FitPlane(base, norm);
+    if (fit < std::numeric_limits<float>::max()) {
+        basepoint = base;
+        // keep the orientation of the previous fit
+        normal = norm * normal < 0.0F ? -norm : norm;
+    }
+    fitted = true;
+    return fit;
 }
 
 float PlaneSurfaceFit::GetDistanceToSurface(const Base::Vector3f& pnt) const
 {
-    if (!fitter) {
-        return pnt.DistanceToPlane(basepoint, normal);
-    }
-
-    return fitter->GetDistanceToPlane(pnt);
+    return pnt.DistanceToPlane(basepoint, normal);
 }
 
 std::vector<float> PlaneSurfaceFit::Parameters() const
 {
-    Base::Vector3f base = basepoint;
-    Base::Vector3f norm = normal;
+    std::vector<float> c;
+    c.push_back(basepoint.x);
+    c.push_back(basepoint.y);
+    c.push_back(basepoint.z);
+    c.push_back(normal.x);
+    c.push_back(normal.y);
+    c.push_back(normal.z);
+    return c;
+}
+
+AbstractSurfaceFit* PlaneSurfaceFit::Clone() const
+{
     if (fitter) {
-        base = fitter->GetBase();
-        norm = fitter->GetNormal();
+        return new PlaneSurfaceFit();
     }
 
-    std::vector<float> c;
-    c.push_back(base.x);
-    c.push_back(base.y);
-    c.push_back(base.z);
-    c.push_back(norm.x);
-    c.push_back(norm.y);
-    c.push_back(norm.z);
-    return c;
+    return new PlaneSurfaceFit(basepoint, normal);
 }
 
 // --------------------------------------------------------
@@ -227,7 +248,13 @@ CylinderSurfaceFit::~CylinderSurfaceFit()
 void CylinderSurfaceFit::Initialize(const MeshCore::MeshGeomFacet& tria)
 {
     if (fitter) {
-        fitter->Clear();
+        // forget the cylinder of the previous region, including the initial guess
+        *fitter = CylinderFit();
+        basepoint.Set(0, 0, 0);
+        axis.Set(0, 0, 0);
+        radius = std::numeric_limits<float>::max();
+        refitPoints = 0;
+
         fitter->AddPoint(tria._aclPoints[0]);
         fitter->AddPoint(tria._aclPoints[1]);
         fitter->AddPoint(tria._aclPoints[2]);
@@ -254,7 +281,9 @@ bool CylinderSurfaceFit::TestTriangle(const MeshGeomFacet& tria) const
 bool CylinderSurfaceFit::Done() const
 {
     if (fitter) {
-        return fitter->Done();
+        // The cylinder fit is iterative and needs all points. So, the cylinder is only
+        // fitted again when the number of points has noticeably grown.
+        return fitter->Done() || fitter->CountPoints() < refitPoints;
     }
 
     return true;
@@ -271,13 +300,18 @@ float CylinderSurfaceFit::Fit()
         basepoint = fitter->GetBase();
         axis = fitter->GetAxis();
         radius = fitter->GetRadius();
+
+        // start the next fit from this cylinder
+        fitter->SetInitialValues(basepoint, axis);
+        std::size_t numPoints = fitter->CountPoints();
+        refitPoints = numPoints + numPoints / 8;
     }
     return fit;
 }
 
 float CylinderSurfaceFit::GetDistanceToSurface(const Base::Vector3f& pnt) const
 {
-    if (fitter && !fitter->Done()) {
+    if (fitter && !fitter->Done() && refitPoints == 0) {
         // collect some points
         return 0;
     }
@@ -287,31 +321,37 @@ float CylinderSurfaceFit::GetDistanceToSurface(const Base::Vector3f& pnt) const
 
 std::vector<float> CylinderSurfaceFit::Parameters() const
 {
-    Base::Vector3f base = basepoint;
-    Base::Vector3f norm = axis;
-    float radval = radius;
+    std::vector<float> c;
+    c.push_back(basepoint.x);
+    c.push_back(basepoint.y);
+    c.push_back(basepoint.z);
+    c.push_back(axis.x);
+    c.push_back(axis.y);
+    c.push_back(axis.z);
+    c.push_back(radius);
+    return c;
+}
+
+AbstractSurfaceFit* CylinderSurfaceFit::Clone() const
+{
     if (fitter) {
-        base = fitter->GetBase();
-        norm = fitter->GetAxis();
-        radval = fitter->GetRadius();
+        return new CylinderSurfaceFit();
     }
 
-    std::vector<float> c;
-    c.push_back(base.x);
-    c.push_back(base.y);
-    c.push_back(base.z);
-    c.push_back(norm.x);
-    c.push_back(norm.y);
-    c.push_back(norm.z);
-    c.push_back(radval);
-    return c;
+    return new CylinderSurfaceFit(basepoint, axis, radius);
 }
 
 // --------------------------------------------------------
 
+namespace
+{
+// like for the cylinder collect the points of some triangles before the first fit
+constexpr std::size_t minSpherePoints = 9;
+}  // namespace
+
 SphereSurfaceFit::SphereSurfaceFit()
     : radius(std::numeric_limits<float>::max())
-    , fitter(new SphereFit)
+    , fitter(new PointMoments)
 {
     center.Set(0, 0, 0);
 }
@@ -330,6 +370,10 @@ SphereSurfaceFit::~SphereSurfaceFit()
 void SphereSurfaceFit::Initialize(const MeshCore::MeshGeomFacet& tria)
 {
     if (fitter) {
+        center.Set(0, 0, 0);
+        radius = std::numeric_limits<float>::max();
+        fitted = false;
+
         fitter->Clear();
         fitter->AddPoint(tria._aclPoints[0]);
         fitter->AddPoint(tria._aclPoints[1]);
@@ -343,6 +387,7 @@ void SphereSurfaceFit::AddTriangle(const MeshCore::MeshGeomFacet& tria)
         fitter->AddPoint(tria._aclPoints[0]);
         fitter->AddPoint(tria._aclPoints[1]);
         fitter->AddPoint(tria._aclPoints[2]);
+        fitted = false;
     }
 }
 
@@ -355,7 +400,7 @@ bool SphereSurfaceFit::TestTriangle(const MeshGeomFacet&) const
 bool SphereSurfaceFit::Done() const
 {
     if (fitter) {
-        return fitter->Done();
+        return fitted;
     }
 
     return true;
@@ -367,35 +412,45 @@ float SphereSurfaceFit::Fit()
         return 0;
     }
 
-    float fit = fitter->Fit();
+    // the sums of the points are kept, so this is done in constant time
+    Base::Vector3f cnt;
+    float rad {};
+    float fit = fitter->FitSphere(cnt, rad);
     if (fit < std::numeric_limits<float>::max()) {
-        center = fitter->GetCenter();
-        radius = fitter->GetRadius();
+        center = cnt;
+        radius = rad;
     }
+    fitted = true;
     return fit;
 }
 
 float SphereSurfaceFit::GetDistanceToSurface(const Base::Vector3f& pnt) const
 {
+    if (fitter && fitter->CountPoints() < minSpherePoints) {
+        // collect some points
+        return 0;
+    }
     float dist = Base::Distance(pnt, center);
     return (dist - radius);
 }
 
 std::vector<float> SphereSurfaceFit::Parameters() const
 {
-    Base::Vector3f base = center;
-    float radval = radius;
+    std::vector<float> c;
+    c.push_back(center.x);
+    c.push_back(center.y);
+    c.push_back(center.z);
+    c.push_back(radius);
+    return c;
+}
+
+AbstractSurfaceFit* SphereSurfaceFit::Clone() const
+{
     if (fitter) {
-        base = fitter->GetCenter();
-        radval = fitter->GetRadius();
+        return new SphereSurfaceFit();
     }
 
-    std::vector<float> c;
-    c.push_back(base.x);
-    c.push_back(base.y);
-    c.push_back(base.z);
-    c.push_back(radval);
-    return c;
+    return new SphereSurfaceFit(center, radius);
 }
 
 // --------------------------------------------------------
@@ -451,6 +506,19 @@ void MeshDistanceGenericSurfaceFitSegment::AddFacet(const MeshFacet& face)
     fitter->AddTriangle(triangle);
 }
 
+MeshSurfaceSegmentPtr MeshDistanceGenericSurfaceFitSegment::Clone() const
+{
+    AbstractSurfaceFit* fit = fitter->Clone();
+    if (!fit) {
+        return {};
+    }
+
+    return std::make_shared<MeshDistanceGenericSurfaceFitSegment>(fit,
+                                                                  kernel,
+                                                                  GetMinFacets(),
+                                                                  tolerance);
+}
+
 std::vector<float> MeshDistanceGenericSurfaceFitSegment::Parameters() const
 {
     return fitter->Parameters();
@@ -473,6 +541,11 @@ bool MeshCurvaturePlanarSegment::TestFacet(const MeshFacet& rclFacet) const
     return true;
 }
 
+MeshSurfaceSegmentPtr MeshCurvaturePlanarSegment::Clone() const
+{
+    return std::make_shared<MeshCurvaturePlanarSegment>(GetCurvature(), GetMinFacets(), tolerance);
+}
+
 bool MeshCurvatureCylindricalSegment::TestFacet(const MeshFacet& rclFacet) const
 {
     for (PointIndex ptIndex : rclFacet._aulPoints) {
@@ -490,6 +563,15 @@ bool MeshCurvatureCylindricalSegment::TestFacet(const MeshFacet& rclFacet) const
     return true;
 }
 
+MeshSurfaceSegmentPtr MeshCurvatureCylindricalSegment::Clone() const
+{
+    return std::make_shared<MeshCurvatureCylindricalSegment>(GetCurvature(),
+                                                             GetMinFacets(),
+                                                             toleranceMin,
+                                                             toleranceMax,
+                                                             curvature);
+}
+
 bool MeshCurvatureSphericalSegment::TestFacet(const MeshFacet& rclFacet) const
 {
     for (PointIndex ptIndex : rclFacet._aulPoints) {
@@ -511,6 +593,14 @@ bool MeshCurvatureSphericalSegment::TestFacet(const MeshFacet& rclFacet) const
     return true;
 }
 
+MeshSurfaceSegmentPtr MeshCurvatureSphericalSegment::Clone() const
+{
+    return std::make_shared<MeshCurvatureSphericalSegment>(GetCurvature(),
+                                                           GetMinFacets(),
+                                                           tolerance,
+                                                           curvature);
+}
+
 bool MeshCurvatureFreeformSegment::TestFacet(const MeshFacet& rclFacet) const
 {
     for (PointIndex ptIndex : rclFacet._aulPoints) {
@@ -526,6 +616,16 @@ bool MeshCurvatureFreeformSegment::TestFacet(const MeshFacet& rclFacet) const
     return true;
 }
 
+MeshSurfaceSegmentPtr MeshCurvatureFreeformSegment::Clone() const
+{
+    return std::make_shared<MeshCurvatureFreeformSegment>(GetCurvature(),
+                                                          GetMinFacets(),
+                                                          toleranceMin,
+                                                          toleranceMax,
+                                                          c1,
+                                                          c2);
+}
+
 // --------------------------------------------------------
 
 MeshSurfaceVisitor::MeshSurfaceVisitor(MeshSurfaceSegment& segm, std::vector<FacetIndex>& indices)
@@ -554,63 +654,186 @@ bool MeshSurfaceVisitor::Visit(const MeshFacet& face,
 
 // --------------------------------------------------------
 
-void MeshSegmentAlgorithm::FindSegments(std::vector<MeshSurfaceSegmentPtr>& segm)
+namespace
+{
+/// The result of growing a region from a seed facet
+struct GrownRegion
 {
-    // reset VISIT flags
-    FacetIndex startFacet {};
-    MeshCore::MeshAlgorithm cAlgo(myKernel);
-    cAlgo.ResetFacetFlag(MeshCore::MeshFacet::VISIT);
+    FacetIndex seed {};
+    /// The facets of the region, this may or may not include the seed
+    std::vector<FacetIndex> indices;
+    /// Set if the region touched a facet of a region with a lower rank
+    bool conflict {false};
+};
 
-    const MeshCore::MeshFacetArray& rFAry = myKernel.GetFacets();
-    MeshCore::MeshFacetArray::_TConstIterator iCur = rFAry.begin();
-    MeshCore::MeshFacetArray::_TConstIterator iBeg = rFAry.begin();
-    MeshCore::MeshFacetArray::_TConstIterator iEnd = rFAry.end();
+/**
+ * Grows the region of the seed in the same order as MeshKernel::VisitNeighbourFacets() does
+ * with the MeshSurfaceVisitor. Instead of the VISIT flag the facets of already accepted
+ * regions are marked in \a visited. Each facet of the region is claimed with \a rank + 1. If
+ * a region with a lower rank claimed the facet before, the growth is stopped because this
+ * region cannot be accepted in the current round anyway.
+ */
+void growRegion(const MeshKernel& kernel,
+                MeshSurfaceSegment& segm,
+                const std::vector<char>& visited,
+                std::vector<std::atomic<unsigned int>>& claims,
+                unsigned int rank,
+                GrownRegion& region)
+{
+    const unsigned int owner = rank + 1;
+    auto claim = [&claims, owner](FacetIndex index) {
+        unsigned int value = claims[index].load();
+        while (value == 0 || value > owner) {
+            if (claims[index].compare_exchange_weak(value, owner)) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    FacetIndex seed = region.seed;
+    if (!claim(seed)) {
+        region.conflict = true;
+        return;
+    }
+
+    segm.Initialize(seed);
+    if (segm.TestInitialFacet(seed)) {
+        region.indices.push_back(seed);
+    }
+
+    const MeshFacetArray& rFAry = kernel.GetFacets();
+    std::size_t numFacets = rFAry.size();
+    std::vector<FacetIndex> currentLevel {seed};
+    std::vector<FacetIndex> nextLevel;
+    while (!currentLevel.empty()) {
+        for (FacetIndex index : currentLevel) {
+            for (FacetIndex neighbour : rFAry[index]._aulNeighbours) {
+                if (neighbour >= numFacets || visited[neighbour] != 0) {
+                    continue;
+                }
+                if (claims[neighbour].load() == owner) {
+                    continue;  // already part of this region
+                }
+
+                const MeshFacet& face = rFAry[neighbour];
+                if (!segm.TestFacet(face)) {
+                    continue;
+                }
+                if (!claim(neighbour)) {
+                    region.conflict = true;
+                    return;
+                }
+
+                nextLevel.push_back(neighbour);
+                region.indices.push_back(neighbour);
+                segm.AddFacet(face);
+            }
+        }
+
+        currentLevel.swap(nextLevel);
+        nextLevel.clear();
+    }
+}
+}  // namespace
+
+void MeshSegmentAlgorithm::SetThreads(int num)
+{
+    threads = num;
+}
 
-    // start from the first not visited facet
-    cAlgo.CountFacetFlag(MeshCore::MeshFacet::VISIT);
+void MeshSegmentAlgorithm::FindSegments(std::vector<MeshSurfaceSegmentPtr>& segm)
+{
+    const MeshFacetArray& rFAry = myKernel.GetFacets();
+    std::size_t numFacets = rFAry.size();
+    std::vector<char> visited(numFacets, 0);
+    std::vector<std::atomic<unsigned int>> claims(numFacets);
     std::vector<FacetIndex> resetVisited;
+    int numThreads = threads > 0 ? threads : int(std::thread::hardware_concurrency());
 
+    std::vector<GrownRegion> regions;
     for (auto& it : segm) {
-        cAlgo.ResetFacetsFlag(resetVisited, MeshCore::MeshFacet::VISIT);
+        for (FacetIndex index : resetVisited) {
+            visited[index] = 0;
+        }
         resetVisited.clear();
 
-        MeshCore::MeshIsNotFlag<MeshCore::MeshFacet> flag;
-        iCur = std::find_if(iBeg, iEnd, [flag](const MeshFacet& f) {
-            return flag(f, MeshFacet::VISIT);
-        });
-        if (iCur < iEnd) {
-            startFacet = iCur - iBeg;
-        }
-        else {
-            startFacet = FACET_INDEX_MAX;
+        // several regions are only grown at once if the segment can be cloned
+        std::size_t batchSize = 1;
+        if (numThreads > 1 && it->Clone()) {
+            batchSize = 4 * std::size_t(numThreads);
         }
-        while (startFacet != FACET_INDEX_MAX) {
-            // collect all facets of the same geometry
-            std::vector<FacetIndex> indices;
-            it->Initialize(startFacet);
-            if (it->TestInitialFacet(startFacet)) {
-                indices.push_back(startFacet);
+
+        // start from the first not visited facet
+        FacetIndex startFacet = 0;
+        while (startFacet < numFacets) {
+            regions.clear();
+            for (FacetIndex index = startFacet; index < numFacets && regions.size() < batchSize;
+                 index++) {
+                if (visited[index] == 0) {
+                    regions.emplace_back();
+                    regions.back().seed = index;
+                }
+            }
+            if (regions.empty()) {
+                break;
             }
-            MeshSurfaceVisitor pv(*it, indices);
-            myKernel.VisitNeighbourFacets(pv, startFacet);
 
-            // add or discard the segment
-            if (indices.size() <= 1) {
-                resetVisited.push_back(startFacet);
+            if (regions.size() == 1) {
+                growRegion(myKernel, *it, visited, claims, 0, regions.front());
             }
             else {
-                it->AddSegment(indices);
+                parallel_for(
+                    regions.size(),
+                    [&](std::size_t begin, std::size_t end) {
+                        MeshSurfaceSegmentPtr clone = it->Clone();
+                        for (std::size_t index = begin; index < end; index++) {
+                            growRegion(myKernel,
+                                       *clone,
+                                       visited,
+                                       claims,
+                                       static_cast<unsigned int>(index),
+                                       regions[index]);
+                        }
+                    },
+                    numThreads);
             }
 
-            // search for the next start facet
-            iCur = std::find_if(iCur, iEnd, [flag](const MeshFacet& f) {
-                return flag(f, MeshFacet::VISIT);
-            });
-            if (iCur < iEnd) {
-                startFacet = iCur - iBeg;
+            // accept the regions in the order of their seeds until the first region that
+            // would have grown differently after the previous regions were accepted
+            startFacet = regions.back().seed + 1;
+            for (const auto& region : regions) {
+                if (visited[region.seed] != 0) {
+                    continue;  // the seed is part of an accepted region
+                }
+                bool conflict = region.conflict;
+                for (FacetIndex index : region.indices) {
+                    conflict = conflict || visited[index] != 0;
+                }
+                if (conflict) {
+                    startFacet = region.seed;
+                    break;
+                }
+
+                visited[region.seed] = 1;
+                for (FacetIndex index : region.indices) {
+                    visited[index] = 1;
+                }
+
+                // add or discard the segment
+                if (region.indices.size() <= 1) {
+                    resetVisited.push_back(region.seed);
+                }
+                else {
+                    it->AddSegment(region.indices);
+                }
             }
-            else {
-                startFacet = FACET_INDEX_MAX;
+
+            for (const auto& region : regions) {
+                claims[region.seed] = 0;
+                for (FacetIndex index : region.indices) {
+                    claims[index] = 0;
+                }
             }
         }
     }
@@ -34,11 +34,13 @@
 namespace MeshCore
 {
 
-class PlaneFit;
 class CylinderFit;
-class SphereFit;
+class PointMoments;
+class PlaneSurfaceFit;
 class MeshFacet;
+class MeshSurfaceSegment;
 using MeshSegment = std::vector<FacetIndex>;
+using MeshSurfaceSegmentPtr = std::shared_ptr<MeshSurfaceSegment>;
 
 class MeshExport MeshSurfaceSegment
 {
@@ -58,6 +60,11 @@ public:
     virtual void Initialize(FacetIndex);
     virtual bool TestInitialFacet(FacetIndex) const;
     virtual void AddFacet(const MeshFacet& rclFacet);
+    /**
+     * Returns a new segment with the same settings that grows regions in another thread. If
+     * null is returned, which is the default, the regions are grown one after another.
+     */
+    virtual MeshSurfaceSegmentPtr Clone() const;
     void AddSegment(const std::vector<FacetIndex>&);
     const std::vector<MeshSegment>& GetSegments() const
     {
@@ -65,11 +72,16 @@ public:
     }
     MeshSegment FindSegment(FacetIndex) const;
 
+protected:
+    unsigned long GetMinFacets() const
+    {
+        return minFacets;
+    }
+
 private:
     std::vector<MeshSegment> segments;
     unsigned long minFacets;
 };
-using MeshSurfaceSegmentPtr = std::shared_ptr<MeshSurfaceSegment>;
 
 // --------------------------------------------------------
 
@@ -107,11 +119,10 @@ public:
     }
     void Initialize(FacetIndex) override;
     void AddFacet(const MeshFacet& face) override;
+    MeshSurfaceSegmentPtr Clone() const override;
 
 private:
-    Base::Vector3f basepoint;
-    Base::Vector3f normal;
-    PlaneFit* fitter;
+    PlaneSurfaceFit* fitter;
 };
 
 class MeshExport AbstractSurfaceFit
@@ -133,6 +144,11 @@ public:
     virtual float Fit() = 0;
     virtual float GetDistanceToSurface(const Base::Vector3f&) const = 0;
     virtual std::vector<float> Parameters() const = 0;
+    /**
+     * Returns a new fit with the same settings to be used in another thread, or null if the
+     * fit cannot be copied.
+     */
+    virtual AbstractSurfaceFit* Clone() const;
 };
 
 class MeshExport PlaneSurfaceFit: public AbstractSurfaceFit
@@ -158,11 +174,13 @@ public:
     float Fit() override;
     float GetDistanceToSurface(const Base::Vector3f&) const override;
     std::vector<float> Parameters() const override;
+    AbstractSurfaceFit* Clone() const override;
 
 private:
     Base::Vector3f basepoint;
     Base::Vector3f normal;
-    PlaneFit* fitter;
+    bool fitted {false};
+    PointMoments* fitter;
 };
 
 class MeshExport CylinderSurfaceFit: public AbstractSurfaceFit
@@ -188,11 +206,14 @@ public:
     float Fit() override;
     float GetDistanceToSurface(const Base::Vector3f&) const override;
     std::vector<float> Parameters() const override;
+    AbstractSurfaceFit* Clone() const override;
 
 private:
     Base::Vector3f basepoint;
     Base::Vector3f axis;
     float radius;
+    /** Number of points at which the cylinder is fitted again, 0 if it's not fitted yet */
+    std::size_t refitPoints {0};
     CylinderFit* fitter;
 };
 
@@ -219,11 +240,13 @@ public:
     float Fit() override;
     float GetDistanceToSurface(const Base::Vector3f&) const override;
     std::vector<float> Parameters() const override;
+    AbstractSurfaceFit* Clone() const override;
 
 private:
     Base::Vector3f center;
     float radius;
-    SphereFit* fitter;
+    bool fitted {false};
+    PointMoments* fitter;
 };
 
 class MeshExport MeshDistanceGenericSurfaceFitSegment: public MeshDistanceSurfaceSegment
@@ -250,6 +273,7 @@ public:
     void Initialize(FacetIndex) override;
     bool TestInitialFacet(FacetIndex) const override;
     void AddFacet(const MeshFacet& face) override;
+    MeshSurfaceSegmentPtr Clone() const override;
     std::vector<float> Parameters() const;
 
 private:
@@ -271,6 +295,12 @@ public:
         return info.at(pos);
     }
 
+protected:
+    const std::vector<CurvatureInfo>& GetCurvature() const
+    {
+        return info;
+    }
+
 private:
     const std::vector<CurvatureInfo>& info;
 };
@@ -289,6 +319,7 @@ public:
     {
         return "Plane";
     }
+    MeshSurfaceSegmentPtr Clone() const override;
 
 private:
     float tolerance;
@@ -312,6 +343,7 @@ public:
     {
         return "Cylinder";
     }
+    MeshSurfaceSegmentPtr Clone() const override;
 
 private:
     float curvature;
@@ -335,6 +367,7 @@ public:
     {
         return "Sphere";
     }
+    MeshSurfaceSegmentPtr Clone() const override;
 
 private:
     float curvature;
@@ -361,6 +394,7 @@ public:
     {
         return "Freeform";
     }
+    MeshSurfaceSegmentPtr Clone() const override;
 
 private:
     float c1, c2;
@@ -384,16 +418,29 @@ private:
     MeshSurfaceSegment& segm;
 };
 
+/**
+ * The MeshSegmentAlgorithm grows regions of facets that fit to the given surface types.
+ *
+ * The regions are started at the unvisited facets in the order of their indices. With
+ * several threads the next seeds are grown at the same time, each thread with its own
+ * clone of the segment, see MeshSurfaceSegment::Clone(). The regions are then accepted in
+ * the order of their seeds. A region that touches a facet claimed by a region of a lower
+ * seed is discarded and grown again in the next round. So the segments don't depend on the
+ * number of threads.
+ */
 class MeshExport MeshSegmentAlgorithm
 {
 public:
     explicit MeshSegmentAlgorithm(const MeshKernel& kernel)
         : myKernel(kernel)
     {}
+    /// Sets the number of threads, 0 uses all cores
+    void SetThreads(int);
     void FindSegments(std::vector<MeshSurfaceSegmentPtr>&);
 
 private:
     const MeshKernel& myKernel;
+    int threads {0};
 };
 
 }  // namespace MeshCore
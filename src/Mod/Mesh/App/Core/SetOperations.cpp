@@ -31,6 +31,7 @@
 #include <Base/Sequencer.h>
 
 #include "Algorithm.h"
+#include "BVH.h"
 #include "Builder.h"
 #include "Definitions.h"
 #include "Elements.h"
@@ -644,8 +645,8 @@ void MeshIntersection::getIntersection(std::list<MeshIntersection::Tuple>& intsc
         boxes2.push_back((*cMFI2).GetBoundBox());
     }
 
-    // Splits the mesh using grid for speeding up the calculation
-    MeshFacetGrid cMeshFacetGrid(k1);
+    // Builds a bounding volume hierarchy for speeding up the calculation
+    MeshFacetBVH cMeshFacetBVH(k1);
 
     const MeshFacetArray& rFaces2 = k2.GetFacets();
     Base::SequencerLauncher seq("Checking for intersections...", rFaces2.size());
@@ -653,11 +654,11 @@ void MeshIntersection::getIntersection(std::list<MeshIntersection::Tuple>& intsc
     MeshGeomFacet facet1, facet2;
     Base::Vector3f pt1, pt2;
 
-    // Iterate over the facets of the 2nd mesh and find the grid elements of the 1st mesh
+    // Iterate over the facets of the 2nd mesh and find the overlapping facets of the 1st mesh
     for (auto it = rFaces2.begin(); it != rFaces2.end(); ++it, index++) {
         seq.next();
         std::vector<FacetIndex> elements;
-        cMeshFacetGrid.Inside(boxes2[index], elements, true);
+        cMeshFacetBVH.Inside(boxes2[index], elements);
 
         cMFI2.Set(index);
         facet2 = *cMFI2;
@@ -696,8 +697,8 @@ bool MeshIntersection::testIntersection(const MeshKernel& k1, const MeshKernel&
         boxes2.push_back((*cMFI2).GetBoundBox());
     }
 
-    // Splits the mesh using grid for speeding up the calculation
-    MeshFacetGrid cMeshFacetGrid(k1);
+    // Builds a bounding volume hierarchy for speeding up the calculation
+    MeshFacetBVH cMeshFacetBVH(k1);
 
     const MeshFacetArray& rFaces2 = k2.GetFacets();
     Base::SequencerLauncher seq("Checking for intersections...", rFaces2.size());
@@ -705,11 +706,11 @@ bool MeshIntersection::testIntersection(const MeshKernel& k1, const MeshKernel&
     MeshGeomFacet facet1, facet2;
     Base::Vector3f pt1, pt2;
 
-    // Iterate over the facets of the 2nd mesh and find the grid elements of the 1st mesh
+    // Iterate over the facets of the 2nd mesh and find the overlapping facets of the 1st mesh
     for (auto it = rFaces2.begin(); it != rFaces2.end(); ++it, index++) {
         seq.next();
         std::vector<FacetIndex> elements;
-        cMeshFacetGrid.Inside(boxes2[index], elements, true);
+        cMeshFacetBVH.Inside(boxes2[index], elements);
 
         cMFI2.Set(index);
         facet2 = *cMFI2;
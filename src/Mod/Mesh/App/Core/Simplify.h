@@ -10,6 +10,8 @@
 // * Comment out printf statements
 // * Fix compiler warnings
 // * Remove macros loop,i,j,k
+// * Add option to keep the border vertices fixed
+// * Add locked vertices and keep the vertex ids when compacting the mesh
 
 #include <vector>
 
@@ -80,11 +82,13 @@ class Simplify
 {
 public:
     struct Triangle { int v[3];double err[4];int deleted,dirty;vec3f n; };
-    struct Vertex { vec3f p;int tstart,tcount;SymmetricMatrix q;int border;};
+    struct Vertex { vec3f p;int tstart,tcount;SymmetricMatrix q;int border;int id=-1;bool locked=false;};
     struct Ref { int tid,tvertex; };
     std::vector<Triangle> triangles;
     std::vector<Vertex> vertices;
     std::vector<Ref> refs;
+    // keep the border vertices fixed, e.g. if parts of a mesh are simplified separately
+    bool lock_border = false;
 
     void simplify_mesh(int target_count, double tolerance, double aggressiveness=7);
 
@@ -193,6 +197,10 @@ void Simplify::simplify_mesh(int target_count, double tolerance, double aggressi
                     // Border check
                     if (v0.border != v1.border)
                         continue;
+                    if (lock_border && v0.border)
+                        continue;
+                    if (v0.locked || v1.locked)
+                        continue;
 
                     // Compute vertex to collapse to
                     vec3f p;
@@ -474,6 +482,7 @@ void Simplify::compact_mesh()
         {
             vertices[i].tstart=dst;
             vertices[dst].p=vertices[i].p;
+            vertices[dst].id=vertices[i].id;
             dst++;
         }
     }
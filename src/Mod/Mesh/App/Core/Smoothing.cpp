@@ -22,16 +22,20 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+#include <algorithm>
 #include <cmath>
+#include <thread>
 #endif
 
 #include <Base/Tools.h>
 
 #include "Algorithm.h"
 #include "Approximation.h"
+#include "Functional.h"
 #include "Iterator.h"
 #include "MeshKernel.h"
 #include "Smoothing.h"
+#include "Storage.h"
 
 
 using namespace MeshCore;
@@ -169,99 +173,105 @@ LaplaceSmoothing::LaplaceSmoothing(MeshKernel& m)
     : AbstractSmoothing(m)
 {}
 
-void LaplaceSmoothing::Umbrella(const MeshRefPointToPoints& vv_it,
-                                const MeshRefPointToFacets& vf_it,
-                                double stepsize)
+namespace
 {
-    const MeshCore::MeshPointArray& points = kernel.GetPoints();
-    MeshCore::MeshPointArray::_TConstIterator v_it, v_beg = points.begin(), v_end = points.end();
+// Computes the new position of a point from the old positions of its neighbours. Border points
+// and points with less than three neighbours keep their position.
+Base::Vector3f umbrellaPoint(const MeshPointColumns& points,
+                             const MeshPointNeighbours& neighbours,
+                             double stepsize,
+                             PointIndex pos)
+{
+    std::span<const PointIndex> cv = neighbours.GetPoints(pos);
+    if (cv.size() < 3 || cv.size() != neighbours.GetFacets(pos).size()) {
+        return points.Get(pos);
+    }
 
-    PointIndex pos = 0;
-    for (v_it = points.begin(); v_it != v_end; ++v_it, ++pos) {
-        const std::set<PointIndex>& cv = vv_it[pos];
-        if (cv.size() < 3) {
-            continue;
-        }
-        if (cv.size() != vf_it[pos].size()) {
-            // do nothing for border points
-            continue;
-        }
+    const float* px = points.X().data();
+    const float* py = points.Y().data();
+    const float* pz = points.Z().data();
 
-        size_t n_count = cv.size();
-        double w {};
-        w = 1.0 / double(n_count);
+    // sum up the neighbours and weight them once instead of weighting every term
+    double sumx = 0.0, sumy = 0.0, sumz = 0.0;
+    for (PointIndex cv_it : cv) {
+        sumx += static_cast<double>(px[cv_it]);
+        sumy += static_cast<double>(py[cv_it]);
+        sumz += static_cast<double>(pz[cv_it]);
+    }
 
-        double delx = 0.0, dely = 0.0, delz = 0.0;
-        std::set<PointIndex>::const_iterator cv_it;
-        for (cv_it = cv.begin(); cv_it != cv.end(); ++cv_it) {
-            delx += w * static_cast<double>((v_beg[*cv_it]).x - v_it->x);
-            dely += w * static_cast<double>((v_beg[*cv_it]).y - v_it->y);
-            delz += w * static_cast<double>((v_beg[*cv_it]).z - v_it->z);
-        }
+    double w = 1.0 / double(cv.size());
+    double x = static_cast<double>(px[pos]);
+    double y = static_cast<double>(py[pos]);
+    double z = static_cast<double>(pz[pos]);
+    return Base::Vector3f(static_cast<float>(x + stepsize * (w * sumx - x)),
+                          static_cast<float>(y + stepsize * (w * sumy - y)),
+                          static_cast<float>(z + stepsize * (w * sumz - z)));
+}
+}  // namespace
 
-        float x = static_cast<float>(static_cast<double>(v_it->x) + stepsize * delx);
-        float y = static_cast<float>(static_cast<double>(v_it->y) + stepsize * dely);
-        float z = static_cast<float>(static_cast<double>(v_it->z) + stepsize * delz);
-        kernel.SetPoint(pos, x, y, z);
-    }
+void LaplaceSmoothing::Umbrella(const MeshPointColumns& points,
+                                MeshPointColumns& result,
+                                const MeshPointNeighbours& neighbours,
+                                double stepsize)
+{
+    // every point only reads the old positions, so all points can be moved in parallel
+    MeshCore::parallel_for(
+        points.Size(),
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t pos = begin; pos < end; ++pos) {
+                Base::Vector3f pnt = umbrellaPoint(points, neighbours, stepsize, pos);
+                result.Set(pos, pnt.x, pnt.y, pnt.z);
+            }
+        },
+        int(std::thread::hardware_concurrency()));
 }
 
-void LaplaceSmoothing::Umbrella(const MeshRefPointToPoints& vv_it,
-                                const MeshRefPointToFacets& vf_it,
+void LaplaceSmoothing::Umbrella(MeshPointColumns& points,
+                                const MeshPointNeighbours& neighbours,
                                 double stepsize,
                                 const std::vector<PointIndex>& point_indices)
 {
-    const MeshCore::MeshPointArray& points = kernel.GetPoints();
-    MeshCore::MeshPointArray::_TConstIterator v_beg = points.begin();
-
-    for (PointIndex it : point_indices) {
-        const std::set<PointIndex>& cv = vv_it[it];
-        if (cv.size() < 3) {
-            continue;
-        }
-        if (cv.size() != vf_it[it].size()) {
-            // do nothing for border points
-            continue;
-        }
-
-        size_t n_count = cv.size();
-        double w {};
-        w = 1.0 / double(n_count);
-
-        double delx = 0.0, dely = 0.0, delz = 0.0;
-        std::set<PointIndex>::const_iterator cv_it;
-        for (cv_it = cv.begin(); cv_it != cv.end(); ++cv_it) {
-            delx += w * static_cast<double>((v_beg[*cv_it]).x - (v_beg[it]).x);
-            dely += w * static_cast<double>((v_beg[*cv_it]).y - (v_beg[it]).y);
-            delz += w * static_cast<double>((v_beg[*cv_it]).z - (v_beg[it]).z);
-        }
+    std::vector<Base::Vector3f> moved(point_indices.size());
+    MeshCore::parallel_for(
+        point_indices.size(),
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t index = begin; index < end; ++index) {
+                moved[index] = umbrellaPoint(points, neighbours, stepsize, point_indices[index]);
+            }
+        },
+        int(std::thread::hardware_concurrency()));
 
-        float x = static_cast<float>(static_cast<double>((v_beg[it]).x) + stepsize * delx);
-        float y = static_cast<float>(static_cast<double>((v_beg[it]).y) + stepsize * dely);
-        float z = static_cast<float>(static_cast<double>((v_beg[it]).z) + stepsize * delz);
-        kernel.SetPoint(it, x, y, z);
+    for (std::size_t index = 0; index < point_indices.size(); ++index) {
+        const Base::Vector3f& pnt = moved[index];
+        points.Set(point_indices[index], pnt.x, pnt.y, pnt.z);
     }
 }
 
 void LaplaceSmoothing::Smooth(unsigned int iterations)
 {
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
+    MeshCore::MeshPointNeighbours neighbours(kernel);
+    MeshCore::MeshPointColumns points(kernel.GetPoints());
+    MeshCore::MeshPointColumns result(points);
 
     for (unsigned int i = 0; i < iterations; i++) {
-        Umbrella(vv_it, vf_it, lambda);
+        Umbrella(points, result, neighbours, lambda);
+        std::swap(points, result);
     }
+
+    points.CopyTo(kernel);
 }
 
 void LaplaceSmoothing::SmoothPoints(unsigned int iterations,
                                     const std::vector<PointIndex>& point_indices)
 {
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
+    MeshCore::MeshPointNeighbours neighbours(kernel);
+    MeshCore::MeshPointColumns points(kernel.GetPoints());
 
     for (unsigned int i = 0; i < iterations; i++) {
-        Umbrella(vv_it, vf_it, lambda, point_indices);
+        Umbrella(points, neighbours, lambda, point_indices);
     }
+
+    points.CopyTo(kernel);
 }
 
 TaubinSmoothing::TaubinSmoothing(MeshKernel& m)
@@ -270,29 +280,34 @@ TaubinSmoothing::TaubinSmoothing(MeshKernel& m)
 
 void TaubinSmoothing::Smooth(unsigned int iterations)
 {
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
+    MeshCore::MeshPointNeighbours neighbours(kernel);
+    MeshCore::MeshPointColumns points(kernel.GetPoints());
+    MeshCore::MeshPointColumns result(points);
 
     // Theoretically Taubin does not shrink the surface
     iterations = (iterations + 1) / 2;  // two steps per iteration
     for (unsigned int i = 0; i < iterations; i++) {
-        Umbrella(vv_it, vf_it, GetLambda());
-        Umbrella(vv_it, vf_it, -(GetLambda() + micro));
+        Umbrella(points, result, neighbours, GetLambda());
+        Umbrella(result, points, neighbours, -(GetLambda() + micro));
     }
+
+    points.CopyTo(kernel);
 }
 
 void TaubinSmoothing::SmoothPoints(unsigned int iterations,
                                    const std::vector<PointIndex>& point_indices)
 {
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
+    MeshCore::MeshPointNeighbours neighbours(kernel);
+    MeshCore::MeshPointColumns points(kernel.GetPoints());
 
     // Theoretically Taubin does not shrink the surface
     iterations = (iterations + 1) / 2;  // two steps per iteration
     for (unsigned int i = 0; i < iterations; i++) {
-        Umbrella(vv_it, vf_it, GetLambda(), point_indices);
-        Umbrella(vv_it, vf_it, -(GetLambda() + micro), point_indices);
+        Umbrella(points, neighbours, GetLambda(), point_indices);
+        Umbrella(points, neighbours, -(GetLambda() + micro), point_indices);
     }
+
+    points.CopyTo(kernel);
 }
 
 namespace
@@ -327,94 +342,123 @@ MedianFilterSmoothing::MedianFilterSmoothing(MeshKernel& m)
 
 void MedianFilterSmoothing::Smooth(unsigned int iterations)
 {
-    std::vector<unsigned long> point_indices(kernel.CountPoints());
-    std::generate(point_indices.begin(), point_indices.end(), Base::iotaGen<unsigned long>(0));
-    MeshCore::MeshRefFacetToFacets ff_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
+    std::vector<PointIndex> point_indices(kernel.CountPoints());
+    std::generate(point_indices.begin(), point_indices.end(), Base::iotaGen<PointIndex>(0));
+    MeshCore::MeshPointNeighbours neighbours(kernel);
 
     for (unsigned int i = 0; i < iterations; i++) {
-        UpdatePoints(ff_it, vf_it, point_indices);
+        UpdatePoints(neighbours, point_indices);
     }
 }
 
 void MedianFilterSmoothing::SmoothPoints(unsigned int iterations,
                                          const std::vector<PointIndex>& point_indices)
 {
-    MeshCore::MeshRefFacetToFacets ff_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
+    MeshCore::MeshPointNeighbours neighbours(kernel);
 
     for (unsigned int i = 0; i < iterations; i++) {
-        UpdatePoints(ff_it, vf_it, point_indices);
+        UpdatePoints(neighbours, point_indices);
     }
 }
 
-void MedianFilterSmoothing::UpdatePoints(const MeshRefFacetToFacets& ff_it,
-                                         const MeshRefPointToFacets& vf_it,
+void MedianFilterSmoothing::UpdatePoints(const MeshPointNeighbours& neighbours,
                                          const std::vector<PointIndex>& point_indices)
 {
     const MeshCore::MeshPointArray& points = kernel.GetPoints();
     const MeshCore::MeshFacetArray& facets = kernel.GetFacets();
-
-    // Initialize the array with the real normals
-    std::vector<Base::Vector3d> faceNormals;
-    faceNormals.reserve(facets.size());
-    MeshCore::MeshFacetIterator iter(kernel);
-    for (iter.Init(); iter.More(); iter.Next()) {
-        faceNormals.emplace_back(Base::toVector<double>(iter->GetNormal()));
-    }
+    std::size_t numFacets = facets.size();
+    int threads = int(std::thread::hardware_concurrency());
+
+    // Initialize the arrays with the real normals, areas and centers of the facets
+    std::vector<Base::Vector3d> realNormals(numFacets);
+    std::vector<Base::Vector3d> centers(numFacets);
+    std::vector<double> areas(numFacets);
+    MeshCore::parallel_for(
+        numFacets,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t pos = begin; pos < end; pos++) {
+                MeshGeomFacet face = kernel.GetFacet(facets[pos]);
+                realNormals[pos] = Base::toVector<double>(face.GetNormal());
+                centers[pos] = Base::toVector<double>(face.GetGravityPoint());
+                areas[pos] = face.Area();
+            }
+        },
+        threads);
 
     // Step 1: determine face normals
-    for (FacetIndex pos = 0; pos < facets.size(); pos++) {
-        iter.Set(pos);
-        Base::Vector3d refNormal = Base::toVector<double>(iter->GetNormal());
-        const std::set<FacetIndex>& cv = ff_it[pos];
-        const MeshCore::MeshFacet& facet = facets[pos];
-
-        std::vector<AngleNormal> anglesWithFaces;
-        for (auto fi : cv) {
-            iter.Set(fi);
-            Base::Vector3d faceNormal = Base::toVector<double>(iter->GetNormal());
-            double angle = refNormal.GetAngle(faceNormal);
-
-            int absWeight = std::abs(weights);
-            if (absWeight > 1 && facet.IsNeighbour(fi)) {
-                if (weights < 0) {
-                    angle = -angle;
+    std::vector<Base::Vector3d> faceNormals(numFacets);
+    MeshCore::parallel_for(
+        numFacets,
+        [&](std::size_t begin, std::size_t end) {
+            std::vector<FacetIndex> cv;
+            std::vector<AngleNormal> anglesWithFaces;
+            for (std::size_t pos = begin; pos < end; pos++) {
+                const MeshCore::MeshFacet& facet = facets[pos];
+
+                // all facets that share a point with this facet, including itself
+                cv.clear();
+                for (PointIndex pt : facet._aulPoints) {
+                    std::span<const FacetIndex> ring = neighbours.GetFacets(pt);
+                    cv.insert(cv.end(), ring.begin(), ring.end());
                 }
-                for (int i = 0; i < absWeight; i++) {
-                    anglesWithFaces.emplace_back(angle, faceNormal);
+                std::sort(cv.begin(), cv.end());
+                cv.erase(std::unique(cv.begin(), cv.end()), cv.end());
+
+                const Base::Vector3d& refNormal = realNormals[pos];
+                anglesWithFaces.clear();
+                for (auto fi : cv) {
+                    const Base::Vector3d& faceNormal = realNormals[fi];
+                    double angle = refNormal.GetAngle(faceNormal);
+
+                    int absWeight = std::abs(weights);
+                    if (absWeight > 1 && facet.IsNeighbour(fi)) {
+                        if (weights < 0) {
+                            angle = -angle;
+                        }
+                        for (int i = 0; i < absWeight; i++) {
+                            anglesWithFaces.emplace_back(angle, faceNormal);
+                        }
+                    }
+                    else {
+                        anglesWithFaces.emplace_back(angle, faceNormal);
+                    }
                 }
-            }
-            else {
-                anglesWithFaces.emplace_back(angle, faceNormal);
-            }
-        }
-
-        faceNormals[pos] = find_median(anglesWithFaces);
-    }
-
-    // Step 2: move vertices
-    for (auto pos : point_indices) {
-        Base::Vector3d P = Base::toVector<double>(points[pos]);
-        const std::set<FacetIndex>& cv = vf_it[pos];
-
-        double totalArea = 0.0;
-        Base::Vector3d totalvT;
-        for (auto it : cv) {
-            iter.Set(it);
-
-            double faceArea = iter->Area();
-            totalArea += faceArea;
 
-            Base::Vector3d C = Base::toVector<double>(iter->GetGravityPoint());
+                faceNormals[pos] = find_median(anglesWithFaces);
+            }
+        },
+        threads);
+
+    // Step 2: move vertices, all of them are computed from the old positions
+    std::vector<Base::Vector3f> moved(point_indices.size());
+    MeshCore::parallel_for(
+        point_indices.size(),
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t index = begin; index < end; index++) {
+                PointIndex pos = point_indices[index];
+                Base::Vector3d P = Base::toVector<double>(points[pos]);
+
+                double totalArea = 0.0;
+                Base::Vector3d totalvT;
+                for (auto it : neighbours.GetFacets(pos)) {
+                    double faceArea = areas[it];
+                    totalArea += faceArea;
+
+                    Base::Vector3d PC = centers[it] - P;
+                    const Base::Vector3d& mT = faceNormals[it];
+                    Base::Vector3d vT = (PC * mT) * mT;
+                    totalvT += vT * faceArea;
+                }
 
-            Base::Vector3d PC = C - P;
-            Base::Vector3d mT = faceNormals[it];
-            Base::Vector3d vT = (PC * mT) * mT;
-            totalvT += vT * faceArea;
-        }
+                if (totalArea > 0.0) {
+                    P = P + totalvT / totalArea;
+                }
+                moved[index] = Base::toVector<float>(P);
+            }
+        },
+        threads);
 
-        P = P + totalvT / totalArea;
-        kernel.SetPoint(pos, Base::toVector<float>(P));
+    for (std::size_t index = 0; index < point_indices.size(); index++) {
+        kernel.SetPoint(point_indices[index], moved[index]);
     }
 }
@@ -32,9 +32,8 @@
 namespace MeshCore
 {
 class MeshKernel;
-class MeshRefPointToPoints;
-class MeshRefPointToFacets;
-class MeshRefFacetToFacets;
+class MeshPointColumns;
+class MeshPointNeighbours;
 
 /** Base class for smoothing algorithms. */
 class MeshExport AbstractSmoothing
@@ -107,9 +106,9 @@ public:
     }
 
 protected:
-    void Umbrella(const MeshRefPointToPoints&, const MeshRefPointToFacets&, double);
-    void Umbrella(const MeshRefPointToPoints&,
-                  const MeshRefPointToFacets&,
+    void Umbrella(const MeshPointColumns&, MeshPointColumns&, const MeshPointNeighbours&, double);
+    void Umbrella(MeshPointColumns&,
+                  const MeshPointNeighbours&,
                   double,
                   const std::vector<PointIndex>&);
 
@@ -149,9 +148,7 @@ public:
     void SmoothPoints(unsigned int, const std::vector<PointIndex>&) override;
 
 private:
-    void UpdatePoints(const MeshRefFacetToFacets&,
-                      const MeshRefPointToFacets&,
-                      const std::vector<PointIndex>&);
+    void UpdatePoints(const MeshPointNeighbours&, const std::vector<PointIndex>&);
 
 private:
     int weights {1};
@@ -0,0 +1,232 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+#include <algorithm>
+#include <bit>
+#include <thread>
+#endif
+
+#include "Functional.h"
+#include "MeshKernel.h"
+#include "Storage.h"
+
+
+using namespace MeshCore;
+
+MeshFlagPlane::MeshFlagPlane(std::size_t size)
+{
+    Resize(size);
+}
+
+void MeshFlagPlane::Resize(std::size_t size)
+{
+    _size = size;
+    _words.resize((size + 63) / 64);
+    // keep the bits beyond the size cleared so that Count() is correct
+    if (size % 64 != 0) {
+        _words.back() &= (std::uint64_t(1) << (size % 64)) - 1;
+    }
+}
+
+void MeshFlagPlane::Reset()
+{
+    std::fill(_words.begin(), _words.end(), 0);
+}
+
+std::size_t MeshFlagPlane::Count() const
+{
+    std::size_t count = 0;
+    for (std::uint64_t word : _words) {
+        count += std::popcount(word);
+    }
+    return count;
+}
+
+std::size_t MeshFlagPlane::FindFirstUnset(std::size_t start) const
+{
+    for (std::size_t index = start / 64; index < _words.size(); index++) {
+        std::uint64_t word = ~_words[index];
+        if (index == start / 64) {
+            word &= ~std::uint64_t(0) << (start % 64);
+        }
+        if (word != 0) {
+            return std::min(_size, 64 * index + std::countr_zero(word));
+        }
+    }
+    return _size;
+}
+
+// ----------------------------------------------------------------------------
+
+MeshPointColumns::MeshPointColumns(const MeshPointArray& rPoints)
+{
+    Assign(rPoints);
+}
+
+void MeshPointColumns::Assign(const MeshPointArray& rPoints)
+{
+    std::size_t size = rPoints.size();
+    _x.resize(size);
+    _y.resize(size);
+    _z.resize(size);
+    for (std::size_t index = 0; index < size; index++) {
+        const MeshPoint& rPoint = rPoints[index];
+        _x[index] = rPoint.x;
+        _y[index] = rPoint.y;
+        _z[index] = rPoint.z;
+    }
+}
+
+void MeshPointColumns::CopyTo(MeshKernel& rclMesh) const
+{
+    PointIndex size = std::min<PointIndex>(rclMesh.CountPoints(), Size());
+    for (PointIndex index = 0; index < size; index++) {
+        rclMesh.SetPoint(index, _x[index], _y[index], _z[index]);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+MeshFacetColumns::MeshFacetColumns(const MeshFacetArray& rFacets)
+{
+    Assign(rFacets);
+}
+
+void MeshFacetColumns::Assign(const MeshFacetArray& rFacets)
+{
+    _points.resize(3 * rFacets.size());
+    _neighbours.resize(3 * rFacets.size());
+    std::size_t pos = 0;
+    for (const auto& rFacet : rFacets) {
+        for (int i = 0; i < 3; i++, pos++) {
+            _points[pos] = rFacet._aulPoints[i];
+            _neighbours[pos] = rFacet._aulNeighbours[i];
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+namespace
+{
+// Sorts every row, removes duplicates and unused entries and closes the gaps
+template<typename T>
+void compactRows(std::vector<std::size_t>& offsets, std::vector<T>& values, T unused)
+{
+    std::size_t numRows = offsets.size() - 1;
+    int threads = int(std::thread::hardware_concurrency());
+
+    // the rows are independent, so they are cleaned up in parallel
+    std::vector<std::size_t> sizes(numRows);
+    MeshCore::parallel_for(
+        numRows,
+        [&](std::size_t first, std::size_t last) {
+            for (std::size_t row = first; row < last; row++) {
+                auto begin = values.begin() + std::ptrdiff_t(offsets[row]);
+                auto end = values.begin() + std::ptrdiff_t(offsets[row + 1]);
+                std::sort(begin, end);
+                auto unique = std::unique(begin, end);
+                if (unique != begin && *(unique - 1) == unused) {
+                    --unique;
+                }
+                sizes[row] = std::size_t(unique - begin);
+            }
+        },
+        threads);
+
+    std::vector<std::size_t> compact(numRows + 1);
+    compact[0] = 0;
+    for (std::size_t row = 0; row < numRows; row++) {
+        compact[row + 1] = compact[row] + sizes[row];
+    }
+
+    std::vector<T> result(compact.back());
+    MeshCore::parallel_for(
+        numRows,
+        [&](std::size_t first, std::size_t last) {
+            for (std::size_t row = first; row < last; row++) {
+                auto begin = values.begin() + std::ptrdiff_t(offsets[row]);
+                std::copy(begin,
+                          begin + std::ptrdiff_t(sizes[row]),
+                          result.begin() + std::ptrdiff_t(compact[row]));
+            }
+        },
+        threads);
+
+    offsets.swap(compact);
+    values.swap(result);
+}
+}  // namespace
+
+MeshPointNeighbours::MeshPointNeighbours(std::size_t numPoints, const MeshFacetColumns& rFacets)
+{
+    Rebuild(numPoints, rFacets);
+}
+
+MeshPointNeighbours::MeshPointNeighbours(const MeshKernel& rclMesh)
+{
+    Rebuild(rclMesh.CountPoints(), MeshFacetColumns(rclMesh.GetFacets()));
+}
+
+void MeshPointNeighbours::Rebuild(std::size_t numPoints, const MeshFacetColumns& rFacets)
+{
+    // count the corners of every point, a point has at most two neighbours per facet
+    std::vector<std::size_t> counts(numPoints, 0);
+    std::size_t numFacets = rFacets.Size();
+    for (FacetIndex index = 0; index < numFacets; index++) {
+        const PointIndex* pts = rFacets.GetPoints(index);
+        for (int i = 0; i < 3; i++) {
+            counts[pts[i]]++;
+        }
+    }
+
+    _facetOffsets.assign(numPoints + 1, 0);
+    _pointOffsets.assign(numPoints + 1, 0);
+    for (std::size_t index = 0; index < numPoints; index++) {
+        _facetOffsets[index + 1] = _facetOffsets[index] + counts[index];
+        _pointOffsets[index + 1] = _pointOffsets[index] + 2 * counts[index];
+    }
+
+    _facets.resize(_facetOffsets.back());
+    _points.assign(_pointOffsets.back(), POINT_INDEX_MAX);
+    std::vector<std::size_t> facetPos(_facetOffsets.begin(), _facetOffsets.end() - 1);
+    std::vector<std::size_t> pointPos(_pointOffsets.begin(), _pointOffsets.end() - 1);
+    for (FacetIndex index = 0; index < numFacets; index++) {
+        const PointIndex* pts = rFacets.GetPoints(index);
+        for (int i = 0; i < 3; i++) {
+            PointIndex pt = pts[i];
+            _facets[facetPos[pt]++] = index;
+            // degenerated facets reference a point more than once
+            for (int j = 1; j < 3; j++) {
+                PointIndex other = pts[(i + j) % 3];
+                if (other != pt) {
+                    _points[pointPos[pt]++] = other;
+                }
+            }
+        }
+    }
+
+    compactRows(_facetOffsets, _facets, FACET_INDEX_MAX);
+    compactRows(_pointOffsets, _points, POINT_INDEX_MAX);
+}
@@ -0,0 +1,211 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+
+#ifndef MESH_STORAGE_H
+#define MESH_STORAGE_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <Base/Vector3D.h>
+
+#include "Definitions.h"
+
+
+namespace MeshCore
+{
+
+class MeshKernel;
+class MeshPointArray;
+class MeshFacetArray;
+
+/**
+ * The MeshFlagPlane class stores one flag per element packed into bits.
+ * Compared to the flag byte of MeshPoint and MeshFacet a plane needs 1/8 of
+ * the memory, and scanning it doesn't load the rest of the elements.
+ */
+class MeshExport MeshFlagPlane
+{
+public:
+    MeshFlagPlane() = default;
+    explicit MeshFlagPlane(std::size_t size);
+
+    void Resize(std::size_t size);
+    /// Clears all flags.
+    void Reset();
+    std::size_t Size() const
+    {
+        return _size;
+    }
+    bool Get(std::size_t index) const
+    {
+        return (_words[index >> 6] >> (index & 63)) & 1;
+    }
+    void Set(std::size_t index)
+    {
+        _words[index >> 6] |= std::uint64_t(1) << (index & 63);
+    }
+    void Set(std::size_t index, bool value)
+    {
+        if (value) {
+            Set(index);
+        }
+        else {
+            Unset(index);
+        }
+    }
+    void Unset(std::size_t index)
+    {
+        _words[index >> 6] &= ~(std::uint64_t(1) << (index & 63));
+    }
+    /// Returns the number of set flags.
+    std::size_t Count() const;
+    /// Returns the first index with a cleared flag at or after \a start, or Size().
+    std::size_t FindFirstUnset(std::size_t start = 0) const;
+
+private:
+    std::vector<std::uint64_t> _words;
+    std::size_t _size {0};
+};
+
+/**
+ * The MeshPointColumns class holds the coordinates of the mesh points as a
+ * structure of arrays. Algorithms that only need positions, like smoothing,
+ * work on the columns and write them back to the kernel at the end.
+ */
+class MeshExport MeshPointColumns
+{
+public:
+    MeshPointColumns() = default;
+    explicit MeshPointColumns(const MeshPointArray& rPoints);
+
+    void Assign(const MeshPointArray& rPoints);
+    /// Writes the coordinates back to the points of \a rclMesh.
+    void CopyTo(MeshKernel& rclMesh) const;
+
+    std::size_t Size() const
+    {
+        return _x.size();
+    }
+    Base::Vector3f Get(PointIndex index) const
+    {
+        return Base::Vector3f(_x[index], _y[index], _z[index]);
+    }
+    void Set(PointIndex index, float x, float y, float z)
+    {
+        _x[index] = x;
+        _y[index] = y;
+        _z[index] = z;
+    }
+    const std::vector<float>& X() const
+    {
+        return _x;
+    }
+    const std::vector<float>& Y() const
+    {
+        return _y;
+    }
+    const std::vector<float>& Z() const
+    {
+        return _z;
+    }
+
+private:
+    std::vector<float> _x;
+    std::vector<float> _y;
+    std::vector<float> _z;
+};
+
+/**
+ * The MeshFacetColumns class holds the corner and neighbour indices of the
+ * facets in two contiguous arrays with three entries per facet.
+ */
+class MeshExport MeshFacetColumns
+{
+public:
+    MeshFacetColumns() = default;
+    explicit MeshFacetColumns(const MeshFacetArray& rFacets);
+
+    void Assign(const MeshFacetArray& rFacets);
+
+    std::size_t Size() const
+    {
+        return _points.size() / 3;
+    }
+    const PointIndex* GetPoints(FacetIndex index) const
+    {
+        return &_points[3 * index];
+    }
+    const FacetIndex* GetNeighbours(FacetIndex index) const
+    {
+        return &_neighbours[3 * index];
+    }
+
+private:
+    std::vector<PointIndex> _points;
+    std::vector<FacetIndex> _neighbours;
+};
+
+/**
+ * The MeshPointNeighbours class stores for every point the adjacent points and
+ * facets in compressed rows. It provides the same information as
+ * MeshRefPointToPoints and MeshRefPointToFacets with sorted rows, but uses two
+ * flat arrays instead of a tree per point.
+ */
+class MeshExport MeshPointNeighbours
+{
+public:
+    MeshPointNeighbours() = default;
+    MeshPointNeighbours(std::size_t numPoints, const MeshFacetColumns& rFacets);
+    explicit MeshPointNeighbours(const MeshKernel& rclMesh);
+
+    void Rebuild(std::size_t numPoints, const MeshFacetColumns& rFacets);
+
+    std::size_t Size() const
+    {
+        return _pointOffsets.empty() ? 0 : _pointOffsets.size() - 1;
+    }
+    /// The sorted indices of the points connected with \a index by an edge.
+    std::span<const PointIndex> GetPoints(PointIndex index) const
+    {
+        return {_points.data() + _pointOffsets[index],
+                _points.data() + _pointOffsets[index + 1]};
+    }
+    /// The sorted indices of the facets that reference \a index.
+    std::span<const FacetIndex> GetFacets(PointIndex index) const
+    {
+        return {_facets.data() + _facetOffsets[index],
+                _facets.data() + _facetOffsets[index + 1]};
+    }
+
+private:
+    std::vector<std::size_t> _pointOffsets;
+    std::vector<PointIndex> _points;
+    std::vector<std::size_t> _facetOffsets;
+    std::vector<FacetIndex> _facets;
+};
+
+}  // namespace MeshCore
+
+
+#endif  // MESH_STORAGE_H
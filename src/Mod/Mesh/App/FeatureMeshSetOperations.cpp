@@ -22,6 +22,7 @@
 
 #include "PreCompiled.h"
 
+#include "Core/Boolean.h"
 #include "Core/Iterator.h"
 #include "Core/SetOperations.h"
 
@@ -67,36 +68,31 @@ App::DocumentObjectExecReturn* SetOperations::execute()
         const MeshObject& meshKernel1 = mesh1->Mesh.getValue();
         const MeshObject& meshKernel2 = mesh2->Mesh.getValue();
 
-        std::unique_ptr<MeshObject> pcKernel(new MeshObject());  // Result Meshkernel
-
-        MeshCore::SetOperations::OperationType type {};
+        MeshCore::MeshBoolean::OperationType type {};
         string ot(OperationType.getValue());
         if (ot == "union") {
-            type = MeshCore::SetOperations::Union;
+            type = MeshCore::MeshBoolean::Union;
         }
         else if (ot == "intersection") {
-            type = MeshCore::SetOperations::Intersect;
+            type = MeshCore::MeshBoolean::Intersect;
         }
         else if (ot == "difference") {
-            type = MeshCore::SetOperations::Difference;
+            type = MeshCore::MeshBoolean::Difference;
         }
         else if (ot == "inner") {
-            type = MeshCore::SetOperations::Inner;
+            type = MeshCore::MeshBoolean::Inner;
         }
         else if (ot == "outer") {
-            type = MeshCore::SetOperations::Outer;
+            type = MeshCore::MeshBoolean::Outer;
         }
         else {
             throw Base::ValueError("Operation type must either be 'union' or 'intersection'"
                                    " or 'difference' or 'inner' or 'outer'");
         }
 
-        MeshCore::SetOperations setOp(meshKernel1.getKernel(),
-                                      meshKernel2.getKernel(),
-                                      pcKernel->getKernel(),
-                                      type,
-                                      1.0e-5F);
-        setOp.Do();
+        // Result Meshkernel
+        std::unique_ptr<MeshObject> pcKernel(new MeshObject(MeshObject::setOperation(
+            meshKernel1.getKernel(), meshKernel2.getKernel(), type, 1.0e-5F)));
         Mesh.setValuePtr(pcKernel.release());
     }
     else {
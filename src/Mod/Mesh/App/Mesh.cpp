@@ -26,6 +26,7 @@
 #include <sstream>
 #endif
 
+#include <App/Application.h>
 #include <Base/Builder3D.h>
 #include <Base/Console.h>
 #include <Base/Converter.h>
@@ -38,6 +39,8 @@
 #include <Base/ViewProj.h>
 #include <Base/Writer.h>
 
+#include "Core/Analysis.h"
+#include "Core/Boolean.h"
 #include "Core/Builder.h"
 #include "Core/Decimation.h"
 #include "Core/Degeneration.h"
@@ -1076,15 +1079,17 @@ void MeshObject::smooth(int iterations, float d_max)
     _kernel.Smooth(iterations, d_max);
 }
 
-void MeshObject::decimate(float fTolerance, float fReduction)
+void MeshObject::decimate(float fTolerance, float fReduction, int threads)
 {
     MeshCore::MeshSimplify dm(this->_kernel);
+    dm.SetThreads(threads);
     dm.simplify(fTolerance, fReduction);
 }
 
-void MeshObject::decimate(int targetSize)
+void MeshObject::decimate(int targetSize, int threads)
 {
     MeshCore::MeshSimplify dm(this->_kernel);
+    dm.SetThreads(threads);
     dm.simplify(targetSize);
 }
 
@@ -1217,84 +1222,99 @@ void MeshObject::trimByPlane(const Base::Vector3f& base, const Base::Vector3f& n
     }
 }
 
-MeshObject* MeshObject::unite(const MeshObject& mesh) const
+namespace
+{
+MeshCore::SetOperations::OperationType toLegacyType(MeshCore::MeshBoolean::OperationType type)
+{
+    switch (type) {
+        case MeshCore::MeshBoolean::Union:
+            return MeshCore::SetOperations::Union;
+        case MeshCore::MeshBoolean::Intersect:
+            return MeshCore::SetOperations::Intersect;
+        case MeshCore::MeshBoolean::Difference:
+            return MeshCore::SetOperations::Difference;
+        case MeshCore::MeshBoolean::Inner:
+            return MeshCore::SetOperations::Inner;
+        case MeshCore::MeshBoolean::Outer:
+            return MeshCore::SetOperations::Outer;
+    }
+    throw Base::ValueError("Unknown boolean operation type");
+}
+}  // namespace
+
+MeshCore::MeshKernel MeshObject::setOperation(const MeshCore::MeshKernel& kernel1,
+                                              const MeshCore::MeshKernel& kernel2,
+                                              MeshCore::MeshBoolean::OperationType type,
+                                              float epsilon)
 {
     MeshCore::MeshKernel result;
+    auto hGrp(App::GetApplication().GetParameterGroupByPath(
+        "User parameter:BaseApp/Preferences/Mod/Mesh"));
+    bool legacy = hGrp->GetBool("LegacySetOperations", false);
+    if (!legacy
+        && (!MeshCore::MeshBoolean::IsValidInput(kernel1)
+            || !MeshCore::MeshBoolean::IsValidInput(kernel2))) {
+        Base::Console().Log("Input meshes are not closed and outwards oriented solids, "
+                            "falling back to the legacy set operations\n");
+        legacy = true;
+    }
+
+    if (legacy) {
+        MeshCore::SetOperations setOp(kernel1, kernel2, result, toLegacyType(type), epsilon);
+        setOp.Do();
+    }
+    else {
+        MeshCore::MeshBoolean boolean(kernel1, kernel2, result, type);
+        boolean.Do();
+    }
+    return result;
+}
+
+MeshObject* MeshObject::unite(const MeshObject& mesh) const
+{
     MeshCore::MeshKernel kernel1(this->_kernel);
     kernel1.Transform(this->_Mtrx);
     MeshCore::MeshKernel kernel2(mesh._kernel);
     kernel2.Transform(mesh._Mtrx);
-    MeshCore::SetOperations setOp(kernel1,
-                                  kernel2,
-                                  result,
-                                  MeshCore::SetOperations::Union,
-                                  Epsilon);
-    setOp.Do();
-    return new MeshObject(result);
+    return new MeshObject(setOperation(kernel1, kernel2, MeshCore::MeshBoolean::Union, Epsilon));
 }
 
 MeshObject* MeshObject::intersect(const MeshObject& mesh) const
 {
-    MeshCore::MeshKernel result;
     MeshCore::MeshKernel kernel1(this->_kernel);
     kernel1.Transform(this->_Mtrx);
     MeshCore::MeshKernel kernel2(mesh._kernel);
     kernel2.Transform(mesh._Mtrx);
-    MeshCore::SetOperations setOp(kernel1,
-                                  kernel2,
-                                  result,
-                                  MeshCore::SetOperations::Intersect,
-                                  Epsilon);
-    setOp.Do();
-    return new MeshObject(result);
+    return new MeshObject(
+        setOperation(kernel1, kernel2, MeshCore::MeshBoolean::Intersect, Epsilon));
 }
 
 MeshObject* MeshObject::subtract(const MeshObject& mesh) const
 {
-    MeshCore::MeshKernel result;
     MeshCore::MeshKernel kernel1(this->_kernel);
     kernel1.Transform(this->_Mtrx);
     MeshCore::MeshKernel kernel2(mesh._kernel);
     kernel2.Transform(mesh._Mtrx);
-    MeshCore::SetOperations setOp(kernel1,
-                                  kernel2,
-                                  result,
-                                  MeshCore::SetOperations::Difference,
-                                  Epsilon);
-    setOp.Do();
-    return new MeshObject(result);
+    return new MeshObject(
+        setOperation(kernel1, kernel2, MeshCore::MeshBoolean::Difference, Epsilon));
 }
 
 MeshObject* MeshObject::inner(const MeshObject& mesh) const
 {
-    MeshCore::MeshKernel result;
     MeshCore::MeshKernel kernel1(this->_kernel);
     kernel1.Transform(this->_Mtrx);
     MeshCore::MeshKernel kernel2(mesh._kernel);
     kernel2.Transform(mesh._Mtrx);
-    MeshCore::SetOperations setOp(kernel1,
-                                  kernel2,
-                                  result,
-                                  MeshCore::SetOperations::Inner,
-                                  Epsilon);
-    setOp.Do();
-    return new MeshObject(result);
+    return new MeshObject(setOperation(kernel1, kernel2, MeshCore::MeshBoolean::Inner, Epsilon));
 }
 
 MeshObject* MeshObject::outer(const MeshObject& mesh) const
 {
-    MeshCore::MeshKernel result;
     MeshCore::MeshKernel kernel1(this->_kernel);
     kernel1.Transform(this->_Mtrx);
     MeshCore::MeshKernel kernel2(mesh._kernel);
     kernel2.Transform(mesh._Mtrx);
-    MeshCore::SetOperations setOp(kernel1,
-                                  kernel2,
-                                  result,
-                                  MeshCore::SetOperations::Outer,
-                                  Epsilon);
-    setOp.Do();
-    return new MeshObject(result);
+    return new MeshObject(setOperation(kernel1, kernel2, MeshCore::MeshBoolean::Outer, Epsilon));
 }
 
 std::vector<std::vector<Base::Vector3f>>
@@ -1520,6 +1540,16 @@ void MeshObject::removeNonManifolds()
     }
 }
 
+void MeshObject::removeNonManifolds(MeshCore::MeshAnalysis& analysis)
+{
+    if (analysis.HasNonManifolds()) {
+        MeshCore::MeshFixTopology f_fix(_kernel, analysis.GetNonManifolds());
+        f_fix.Fixup();
+        deletedFacets(f_fix.GetDeletedFaces());
+        analysis.RemoveFacets(f_fix.GetDeletedFaces());
+    }
+}
+
 void MeshObject::removeNonManifoldPoints()
 {
     MeshCore::MeshEvalPointManifolds p_eval(_kernel);
@@ -1610,6 +1640,16 @@ void MeshObject::removeSelfIntersections(const std::vector<FacetIndex>& indices)
     }
 }
 
+void MeshObject::removeSelfIntersections(MeshCore::MeshAnalysis& analysis)
+{
+    if (analysis.HasSelfIntersections()) {
+        MeshCore::MeshFixSelfIntersection cMeshFix(_kernel, analysis.GetSelfIntersections());
+        cMeshFix.Fixup();
+        deletedFacets(cMeshFix.GetDeletedFaces());
+        analysis.RemoveFacets(cMeshFix.GetDeletedFaces());
+    }
+}
+
 void MeshObject::removeFoldsOnSurface()
 {
     std::vector<FacetIndex> indices;
@@ -35,6 +35,7 @@
 #include <Base/Matrix.h>
 #include <Base/Tools3D.h>
 
+#include "Core/Boolean.h"
 #include "Core/Iterator.h"
 #include "Core/MeshIO.h"
 #include "Core/MeshKernel.h"
@@ -58,6 +59,7 @@ class ViewProjMethod;
 namespace MeshCore
 {
 class AbstractPolygonTriangulator;
+class MeshAnalysis;
 }
 
 namespace Mesh
@@ -262,8 +264,9 @@ public:
     void movePoint(PointIndex, const Base::Vector3d& v);
     void setPoint(PointIndex index, const Base::Vector3d& p);
     void smooth(int iterations, float d_max);
-    void decimate(float fTolerance, float fReduction);
-    void decimate(int targetSize);
+    /// Decimates the mesh, \a threads set to 0 uses all cores
+    void decimate(float fTolerance, float fReduction, int threads = 0);
+    void decimate(int targetSize, int threads = 0);
     Base::Vector3d getPointNormal(PointIndex) const;
     std::vector<Base::Vector3d> getPointNormals() const;
     void crossSections(const std::vector<TPlane>&,
@@ -302,6 +305,17 @@ public:
     MeshObject* outer(const MeshObject&) const;
     std::vector<std::vector<Base::Vector3f>>
     section(const MeshObject&, bool connectLines, float fMinDist) const;
+    /**
+     * Computes the boolean operation \a type of the two meshes. MeshCore::MeshBoolean is used
+     * unless the LegacySetOperations preference is set or one of the meshes is not a closed,
+     * outwards oriented solid, in which case MeshCore::SetOperations is used instead.
+     * \a epsilon is only used by MeshCore::SetOperations, MeshCore::MeshBoolean works with
+     * exact predicates and has no tolerance.
+     */
+    static MeshCore::MeshKernel setOperation(const MeshCore::MeshKernel& kernel1,
+                                             const MeshCore::MeshKernel& kernel2,
+                                             MeshCore::MeshBoolean::OperationType type,
+                                             float epsilon);
     //@}
 
     /** @name Topological operations */
@@ -338,12 +352,16 @@ public:
     bool hasFacetsOutOfRange() const;
     bool hasCorruptedFacets() const;
     void removeNonManifolds();
+    /// Removes the non-manifolds found by \a analysis that is kept up to date
+    void removeNonManifolds(MeshCore::MeshAnalysis& analysis);
     void removeNonManifoldPoints();
     bool hasSelfIntersections() const;
     TFacePairs getSelfIntersections() const;
     std::vector<Base::Line3d> getSelfIntersections(const TFacePairs&) const;
     void removeSelfIntersections();
     void removeSelfIntersections(const std::vector<FacetIndex>&);
+    /// Removes the self-intersections found by \a analysis that is kept up to date
+    void removeSelfIntersections(MeshCore::MeshAnalysis& analysis);
     void removeFoldsOnSurface();
     void removeFullBoundaryFacets();
     bool hasInvalidPoints() const;
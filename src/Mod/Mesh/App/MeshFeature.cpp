@@ -64,7 +64,8 @@ void Feature::onChanged(const App::Property* prop)
         this->Mesh.setTransform(this->Placement.getValue().toMatrix());
     }
     // if the mesh data has changed check and adjust the transformation as well
-    else if (prop == &this->Mesh) {
+    // data that is loaded on demand must not override the current placement
+    else if (prop == &this->Mesh && !this->Mesh.testStatus(App::Property::RestoringDocFile)) {
         try {
             Base::Placement p;
             p.fromMatrix(this->Mesh.getTransform());
@@ -22,6 +22,10 @@
 
 #include "PreCompiled.h"
 
+#ifndef _PreComp_
+#include <algorithm>
+#endif
+
 #include <Base/Converter.h>
 #include <Base/Exception.h>
 #include <Base/Reader.h>
@@ -730,6 +734,7 @@ PropertyMeshKernel::PropertyMeshKernel()
 
 PropertyMeshKernel::~PropertyMeshKernel()
 {
+    unlinkCopies();
     if (meshPyObject) {
         // Note: Do not call setInvalid() of the Python binding
         // because the mesh should still be accessible afterwards.
@@ -744,13 +749,17 @@ void PropertyMeshKernel::setValuePtr(MeshObject* mesh)
     // before calling hasSetValue()
     Base::Reference<MeshObject> tmp(_meshObject);
     aboutToSetValue();
-    _meshObject = mesh;
+    // the copies keep the current mesh object
+    unlinkCopies();
+    replaceMeshObject(mesh);
+    _shared = false;
     hasSetValue();
 }
 
 void PropertyMeshKernel::setValue(const MeshObject& mesh)
 {
     aboutToSetValue();
+    detachMesh(false);
     *_meshObject = mesh;
     hasSetValue();
 }
@@ -758,6 +767,7 @@ void PropertyMeshKernel::setValue(const MeshObject& mesh)
 void PropertyMeshKernel::setValue(const MeshCore::MeshKernel& mesh)
 {
     aboutToSetValue();
+    detachMesh(false);
     _meshObject->setKernel(mesh);
     hasSetValue();
 }
@@ -765,6 +775,7 @@ void PropertyMeshKernel::setValue(const MeshCore::MeshKernel& mesh)
 void PropertyMeshKernel::swapMesh(MeshObject& mesh)
 {
     aboutToSetValue();
+    detachMesh();
     _meshObject->swap(mesh);
     hasSetValue();
 }
@@ -772,32 +783,99 @@ void PropertyMeshKernel::swapMesh(MeshObject& mesh)
 void PropertyMeshKernel::swapMesh(MeshCore::MeshKernel& mesh)
 {
     aboutToSetValue();
+    detachMesh();
     _meshObject->swap(mesh);
     hasSetValue();
 }
 
+void PropertyMeshKernel::detachMesh(bool copy)
+{
+    // The copies take the current mesh so that the mesh object of this
+    // property stays the same, references to it remain valid
+    if (!_copies.empty()) {
+        Base::Reference<MeshObject> mesh(copy ? new MeshObject(*_meshObject) : new MeshObject());
+        if (!copy) {
+            // the content gets replaced, so the copies can take it over
+            mesh->swap(*_meshObject);
+            _meshObject->setTransform(mesh->getTransform());
+        }
+        for (auto prop : _copies) {
+            prop->_original = nullptr;
+            prop->replaceMeshObject(mesh);
+        }
+        _copies.clear();
+    }
+
+    // a copy itself gets a new mesh object
+    unlinkCopies();
+    if (!_shared) {
+        return;
+    }
+    _shared = false;
+    if (_meshObject.getRefCount() < 2) {
+        return;
+    }
+
+    Base::Reference<MeshObject> mesh;
+    if (copy) {
+        mesh = new MeshObject(*_meshObject);
+    }
+    else {
+        mesh = new MeshObject();
+        mesh->setTransform(_meshObject->getTransform());
+    }
+    replaceMeshObject(mesh);
+}
+
+void PropertyMeshKernel::unlinkCopies()
+{
+    for (auto prop : _copies) {
+        prop->_original = nullptr;
+    }
+    _copies.clear();
+    if (_original) {
+        auto& copies = _original->_copies;
+        copies.erase(std::remove(copies.begin(), copies.end(), this), copies.end());
+        _original = nullptr;
+    }
+}
+
+void PropertyMeshKernel::replaceMeshObject(const Base::Reference<MeshObject>& mesh)
+{
+    _meshObject = mesh;
+    // the Python wrapper always refers to the current mesh object
+    if (meshPyObject) {
+        meshPyObject->setTwinPointer(static_cast<MeshObject*>(_meshObject));
+    }
+}
+
 const MeshObject& PropertyMeshKernel::getValue() const
 {
+    restoreDeferredDocFile();
     return *_meshObject;
 }
 
 const MeshObject* PropertyMeshKernel::getValuePtr() const
 {
+    restoreDeferredDocFile();
     return static_cast<MeshObject*>(_meshObject);
 }
 
 const Data::ComplexGeoData* PropertyMeshKernel::getComplexData() const
 {
+    restoreDeferredDocFile();
     return static_cast<MeshObject*>(_meshObject);
 }
 
 Base::BoundBox3d PropertyMeshKernel::getBoundingBox() const
 {
+    restoreDeferredDocFile();
     return _meshObject->getBoundBox();
 }
 
 unsigned int PropertyMeshKernel::getMemSize() const
 {
+    restoreDeferredDocFile();
     unsigned int size = 0;
     size += _meshObject->getMemSize();
 
@@ -807,6 +885,7 @@ unsigned int PropertyMeshKernel::getMemSize() const
 MeshObject* PropertyMeshKernel::startEditing()
 {
     aboutToSetValue();
+    detachMesh();
     return static_cast<MeshObject*>(_meshObject);
 }
 
@@ -818,6 +897,7 @@ void PropertyMeshKernel::finishEditing()
 void PropertyMeshKernel::transformGeometry(const Base::Matrix4D& rclMat)
 {
     aboutToSetValue();
+    detachMesh();
     _meshObject->transformGeometry(rclMat);
     hasSetValue();
 }
@@ -826,6 +906,7 @@ void PropertyMeshKernel::setPointIndices(
     const std::vector<std::pair<PointIndex, Base::Vector3f>>& inds)
 {
     aboutToSetValue();
+    detachMesh();
     MeshCore::MeshKernel& kernel = _meshObject->getKernel();
     for (const auto& it : inds) {
         kernel.SetPoint(it.first, it.second);
@@ -835,16 +916,20 @@ void PropertyMeshKernel::setPointIndices(
 
 void PropertyMeshKernel::setTransform(const Base::Matrix4D& rclTrf)
 {
+    restoreDeferredDocFile();
+    detachMesh();
     _meshObject->setTransform(rclTrf);
 }
 
 Base::Matrix4D PropertyMeshKernel::getTransform() const
 {
+    restoreDeferredDocFile();
     return _meshObject->getTransform();
 }
 
 PyObject* PropertyMeshKernel::getPyObject()
 {
+    restoreDeferredDocFile();
     if (!meshPyObject) {
         meshPyObject = new MeshPy(
             &*_meshObject);  // Lgtm[cpp/resource-not-released-in-destructor] ** Not destroyed in
@@ -882,6 +967,7 @@ void PropertyMeshKernel::setPyObject(PyObject* value)
 
 void PropertyMeshKernel::Save(Base::Writer& writer) const
 {
+    restoreDeferredDocFile();
     if (writer.isForceXML()) {
         writer.Stream() << writer.ind() << "<Mesh>" << std::endl;
         MeshCore::MeshOutput saver(_meshObject->getKernel());
@@ -910,6 +996,7 @@ void PropertyMeshKernel::Restore(Base::XMLReader& reader)
         kernel.Adopt(points, facets);
 
         aboutToSetValue();
+        detachMesh();
         _meshObject->getKernel().Adopt(points, facets);
         hasSetValue();
     }
@@ -921,21 +1008,50 @@ void PropertyMeshKernel::Restore(Base::XMLReader& reader)
 
 void PropertyMeshKernel::SaveDocFile(Base::Writer& writer) const
 {
+    restoreDeferredDocFileForSave();
     _meshObject->save(writer.Stream());
 }
 
+bool PropertyMeshKernel::deferRestoreDocFile(const std::shared_ptr<Base::DocFileArchive>& archive,
+                                             const std::string& fileName)
+{
+    return deferDocFile(archive, fileName);
+}
+
 void PropertyMeshKernel::RestoreDocFile(Base::Reader& reader)
 {
     aboutToSetValue();
+    detachMesh(false);
     _meshObject->load(reader);
     hasSetValue();
 }
 
+void PropertyMeshKernel::releaseDocFile()
+{
+    // keep the placement, it's not part of the file
+    Base::Reference<MeshObject> mesh(new MeshObject());
+    mesh->setTransform(_meshObject->getTransform());
+    unlinkCopies();
+    replaceMeshObject(mesh);
+    _shared = false;
+}
+
 App::Property* PropertyMeshKernel::Copy() const
 {
-    // Note: Copy the content, do NOT reference the same mesh object
+    restoreDeferredDocFile();
+    // Note: Reference the same mesh object, the copy gets its own one when
+    // either of them is changed
     PropertyMeshKernel* prop = new PropertyMeshKernel();
-    *(prop->_meshObject) = *(this->_meshObject);
+    prop->_meshObject = this->_meshObject;
+    prop->_shared = true;
+    PropertyMeshKernel* original = _original;
+    if (!original && !_shared) {
+        original = const_cast<PropertyMeshKernel*>(this);  // NOLINT
+    }
+    if (original) {
+        prop->_original = original;
+        original->_copies.push_back(prop);
+    }
     return prop;
 }
 
@@ -944,6 +1060,11 @@ void PropertyMeshKernel::Paste(const App::Property& from)
     // Note: Copy the content, do NOT reference the same mesh object
     aboutToSetValue();
     const PropertyMeshKernel& prop = dynamic_cast<const PropertyMeshKernel&>(from);
-    *(this->_meshObject) = *(prop._meshObject);
+    prop.restoreDeferredDocFile();
+    // a copy that still shares the mesh object has the same content
+    if (&*prop._meshObject != &*_meshObject) {
+        detachMesh(false);
+        *_meshObject = *prop._meshObject;
+    }
     hasSetValue();
 }
@@ -315,14 +315,48 @@ public:
 
     void SaveDocFile(Base::Writer& writer) const override;
     void RestoreDocFile(Base::Reader& reader) override;
+    bool deferRestoreDocFile(const std::shared_ptr<Base::DocFileArchive>& archive,
+                             const std::string& fileName) override;
+    bool canSaveDocFileConcurrently() const override
+    {
+        return true;
+    }
+    bool canSpillDocFile() const override
+    {
+        return true;
+    }
+    bool isPayloadShared() const override
+    {
+        return _meshObject.getRefCount() > 1;
+    }
 
+    /** Copy() shares the mesh object with the new property. When this
+     * property is changed, its copies get their own mesh object, so that
+     * getValue() keeps referring to the same object.
+     */
     App::Property* Copy() const override;
     void Paste(const App::Property& from) override;
     //@}
 
+protected:
+    void releaseDocFile() override;
+
+private:
+    /// Makes sure the mesh object isn't shared, \a copy is false if its kernel gets replaced
+    void detachMesh(bool copy = true);
+    /// Stops tracking the copies that share the mesh object, and the property this is a copy of
+    void unlinkCopies();
+    void replaceMeshObject(const Base::Reference<MeshObject>& mesh);
+
 private:
     Base::Reference<MeshObject> _meshObject;
     MeshPy* meshPyObject {nullptr};
+    /// the mesh object may be shared with other copies and is copied before it's changed
+    bool _shared {false};
+    /// the copies that share the mesh object of this property
+    mutable std::vector<PropertyMeshKernel*> _copies;
+    /// the property whose mesh object this copy shares
+    PropertyMeshKernel* _original {nullptr};
 };
 
 }  // namespace Mesh
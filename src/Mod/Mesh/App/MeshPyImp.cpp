@@ -2056,14 +2056,25 @@ PyObject* MeshPy::smooth(PyObject* args, PyObject* kwds)
     Py_Return;
 }
 
-PyObject* MeshPy::decimate(PyObject* args)
+PyObject* MeshPy::decimate(PyObject* args, PyObject* kwds)
 {
     float fTol {};
     float fRed {};
-    if (PyArg_ParseTuple(args, "ff", &fTol, &fRed)) {
+    int threads {};
+    static const std::array<const char*, 4> keywords_reduction {"Tolerance",
+                                                                "Reduction",
+                                                                "Threads",
+                                                                nullptr};
+    if (Base::Wrapped_ParseTupleAndKeywords(args,
+                                            kwds,
+                                            "ff|$i",
+                                            keywords_reduction,
+                                            &fTol,
+                                            &fRed,
+                                            &threads)) {
         PY_TRY
         {
-            getMeshObjectPtr()->decimate(fTol, fRed);
+            getMeshObjectPtr()->decimate(fTol, fRed, threads);
         }
         PY_CATCH;
 
@@ -2072,10 +2083,16 @@ PyObject* MeshPy::decimate(PyObject* args)
 
     PyErr_Clear();
     int targetSize {};
-    if (PyArg_ParseTuple(args, "i", &targetSize)) {
+    static const std::array<const char*, 3> keywords_target {"TargetSize", "Threads", nullptr};
+    if (Base::Wrapped_ParseTupleAndKeywords(args,
+                                            kwds,
+                                            "i|$i",
+                                            keywords_target,
+                                            &targetSize,
+                                            &threads)) {
         PY_TRY
         {
-            getMeshObjectPtr()->decimate(targetSize);
+            getMeshObjectPtr()->decimate(targetSize, threads);
         }
         PY_CATCH;
 
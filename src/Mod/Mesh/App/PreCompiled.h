@@ -47,11 +47,13 @@
 
 // STL
 #include <algorithm>
+#include <atomic>
 #include <iomanip>
 #include <iostream>
 #include <list>
 #include <limits>
 #include <map>
+#include <mutex>
 #include <queue>
 #include <set>
 #include <sstream>
@@ -37,6 +37,7 @@
 #include <Gui/View3DInventor.h>
 #include <Gui/View3DInventorViewer.h>
 #include <Mod/Mesh/App/MeshFeature.h>
+#include <Mod/Mesh/App/Core/Analysis.h>
 #include <Mod/Mesh/App/Core/Evaluation.h>
 #include <Mod/Mesh/App/Core/Degeneration.h>
 
@@ -1181,16 +1182,19 @@ void DlgEvaluateMeshImp::onRepairAllTogetherClicked()
         bool run = false;
         bool self = true;
         int max_iter = 10;
+        // the mesh object of the property stays the same when it's changed
         const MeshKernel& rMesh = d->meshFeature->Mesh.getValue().getKernel();
+        // keeps the expensive checks across the iterations until the mesh is repaired
+        MeshAnalysis analysis(rMesh, d->epsilonDegenerated);
         try {
             do {
                 run = false;
                 {
-                    MeshEvalSelfIntersection eval(rMesh);
-                    if (self && !eval.Evaluate()) {
+                    if (self && analysis.HasSelfIntersections()) {
                         Gui::Command::doCommand(Gui::Command::App,
                             "App.getDocument(\"%s\").getObject(\"%s\").fixSelfIntersections()",
                             docName, objName);
+                        analysis.Invalidate();
                         run = true;
                     }
                     else {
@@ -1206,11 +1210,13 @@ void DlgEvaluateMeshImp::onRepairAllTogetherClicked()
                         Gui::Command::doCommand(Gui::Command::App,
                             "App.getDocument(\"%s\").getObject(\"%s\").removeFoldsOnSurface()",
                             docName, objName);
+                        analysis.Invalidate();
                         run = true;
                     }
                     qApp->processEvents();
                 }
                 {
+                    // flipping facets doesn't affect the results of the analysis
                     MeshEvalOrientation eval(rMesh);
                     if (!eval.Evaluate()) {
                         Gui::Command::doCommand(Gui::Command::App,
@@ -1221,11 +1227,11 @@ void DlgEvaluateMeshImp::onRepairAllTogetherClicked()
                     qApp->processEvents();
                 }
                 {
-                    MeshEvalTopology eval(rMesh);
-                    if (!eval.Evaluate()) {
+                    if (analysis.HasNonManifolds()) {
                         Gui::Command::doCommand(Gui::Command::App,
                             "App.getDocument(\"%s\").getObject(\"%s\").removeNonManifolds()",
                             docName, objName);
+                        analysis.Invalidate();
                         run = true;
                     }
                     qApp->processEvents();
@@ -1239,15 +1245,16 @@ void DlgEvaluateMeshImp::onRepairAllTogetherClicked()
                         Gui::Command::doCommand(Gui::Command::App,
                             "App.getDocument(\"%s\").getObject(\"%s\").fixIndices()",
                             docName, objName);
+                        analysis.Invalidate();
                         run = true;
                     }
                 }
                 {
-                    MeshEvalDegeneratedFacets eval(rMesh, d->epsilonDegenerated);
-                    if (!eval.Evaluate()) {
+                    if (analysis.HasDegeneratedFacets()) {
                         Gui::Command::doCommand(Gui::Command::App,
                             "App.getDocument(\"%s\").getObject(\"%s\").fixDegenerations(%f)",
                             docName, objName, d->epsilonDegenerated);
+                        analysis.Invalidate();
                         run = true;
                     }
                     qApp->processEvents();
@@ -1258,6 +1265,7 @@ void DlgEvaluateMeshImp::onRepairAllTogetherClicked()
                         Gui::Command::doCommand(Gui::Command::App,
                             "App.getDocument(\"%s\").getObject(\"%s\").removeDuplicatedFacets()",
                             docName, objName);
+                        analysis.Invalidate();
                         run = true;
                     }
                     qApp->processEvents();
@@ -1268,6 +1276,7 @@ void DlgEvaluateMeshImp::onRepairAllTogetherClicked()
                         Gui::Command::doCommand(Gui::Command::App,
                             "App.getDocument(\"%s\").getObject(\"%s\").removeDuplicatedPoints()",
                             docName, objName);
+                        analysis.Invalidate();
                         run = true;
                     }
                     qApp->processEvents();
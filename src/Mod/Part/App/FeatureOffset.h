@@ -55,6 +55,10 @@ public:
     const char* getViewProviderName() const override {
         return "PartGui::ViewProviderOffset";
     }
+    /// execute() changes nothing but the shape
+    std::vector<const App::Property*> getRecomputeResult() const override {
+        return {&Shape};
+    }
     //@}
 
 private:
@@ -45,6 +45,10 @@ public:
     /// recalculate the Feature
     App::DocumentObjectExecReturn *execute() override;
     short mustExecute() const override;
+    /// execute() reads the file
+    std::vector<std::string> getRecomputeInputFiles() const override {
+        return {FileName.getValue()};
+    }
     /// returns the type name of the ViewProvider
     const char* getViewProviderName() const override {
         return "PartGui::ViewProviderImport";
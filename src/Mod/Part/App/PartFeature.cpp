@@ -67,9 +67,11 @@
 #include <App/Datums.h>
 #include <Base/Exception.h>
 #include <Base/Placement.h>
+#include <Base/Reader.h>
 #include <Base/Rotation.h>
 #include <Base/Stream.h>
 #include <Base/Tools.h>
+#include <Base/Writer.h>
 #include <Mod/Material/App/MaterialManager.h>
 
 #include "Geometry.h"
@@ -101,6 +103,78 @@ short Feature::mustExecute() const
     return GeoFeature::mustExecute();
 }
 
+bool Feature::saveRecomputeResult(std::ostream& stream) const
+{
+    const TopoShape& shape = Shape.getShape();
+    if (shape.isNull()) {
+        return false;
+    }
+
+    std::string version = getElementMapVersion(&Shape);
+    std::stringstream brep;
+    shape.exportBinary(brep);
+    std::string data = brep.str();
+    stream << "PartRecomputeResult 1\n"
+           << (version.empty() ? "-" : version) << '\n'
+           << data.size() << '\n';
+    stream.write(data.c_str(), static_cast<std::streamsize>(data.size()));
+
+    bool hasMap = shape.getElementMapSize() > 0;
+    stream << '\n' << (hasMap ? 1 : 0) << '\n';
+    if (hasMap) {
+        // mark the string IDs used by the map, or else they are not written
+        shape.beforeSave();
+        Base::StringWriter writer;
+        shape.SaveDocFile(writer);
+        stream << writer.getString();
+    }
+    return true;
+}
+
+bool Feature::restoreRecomputeResult(std::istream& stream)
+{
+    std::string marker;
+    int format = 0;
+    std::string version;
+    std::size_t size = 0;
+    if (!(stream >> marker >> format >> version >> size) || marker != "PartRecomputeResult"
+        || format != 1) {
+        return false;
+    }
+    std::string current = getElementMapVersion(&Shape);
+    if (version != (current.empty() ? "-" : current)) {
+        return false;
+    }
+
+    stream.get();
+    std::string data(size, '\0');
+    if (!stream.read(data.data(), static_cast<std::streamsize>(size))) {
+        return false;
+    }
+
+    TopoShape shape(getID(), getDocument()->getStringHasher());
+    std::istringstream brep(data);
+    shape.importBinary(brep);
+    if (shape.isNull()) {
+        return false;
+    }
+
+    int hasMap = 0;
+    if (!(stream >> hasMap)) {
+        return false;
+    }
+    if (hasMap) {
+        Base::Reader reader(stream, getFullName(), 1);
+        shape.RestoreDocFile(reader);
+        if (shape.isRestoreFailed()) {
+            return false;
+        }
+    }
+
+    Shape.setValue(shape);
+    return true;
+}
+
 App::DocumentObjectExecReturn *Feature::recompute()
 {
     try {
@@ -1490,7 +1564,8 @@ void Feature::onChanged(const App::Property* prop)
         if (this->isRecomputing()) {
             this->Shape._Shape.setTransform(this->Placement.getValue().toMatrix());
         }
-        else {
+        // a shape that is loaded on demand must not override the current placement
+        else if (!this->Shape.testStatus(App::Property::RestoringDocFile)) {
             Base::Placement p;
             // shape must not be null to override the placement
             if (!this->Shape.getValue().IsNull()) {
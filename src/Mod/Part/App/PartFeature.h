@@ -65,6 +65,15 @@ public:
     short mustExecute() const override;
     //@}
 
+    /** @name Recompute result cache
+     * Stores the shape including its element map. Sub-classes whose execute()
+     * changes nothing but Shape enable the cache by overriding getRecomputeResult().
+     */
+    //@{
+    bool saveRecomputeResult(std::ostream& stream) const override;
+    bool restoreRecomputeResult(std::istream& stream) override;
+    //@}
+
     /// returns the type name of the ViewProvider
     const char* getViewProviderName() const override;
     const App::PropertyComplexGeoData* getPropertyOfGeometry() const override;
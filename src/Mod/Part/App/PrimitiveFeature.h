@@ -44,6 +44,10 @@ public:
     App::DocumentObjectExecReturn *execute() override;
     short mustExecute() const override;
     PyObject* getPyObject() override;
+    /// primitives only build their own shape from their own properties
+    bool canRecomputeConcurrently() const override {
+        return true;
+    }
     //@}
 
 protected:
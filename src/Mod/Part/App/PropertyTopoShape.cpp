@@ -97,11 +97,13 @@ void PropertyPartShape::setValue(const TopoDS_Shape& sh, bool resetElementMap)
 
 const TopoDS_Shape& PropertyPartShape::getValue() const
 {
+    restoreDeferredDocFile();
     return _Shape.getShape();
 }
 
 const TopoShape& PropertyPartShape::getShape() const
 {
+    restoreDeferredDocFile();
     _Shape.initCache(-1);
     // March, 2024 Toponaming project:  There was originally an unused feature to disable
     // elementMapping that has not been kept:
@@ -118,12 +120,14 @@ const TopoShape& PropertyPartShape::getShape() const
 
 const Data::ComplexGeoData* PropertyPartShape::getComplexData() const
 {
+    restoreDeferredDocFile();
     _Shape.initCache(-1);
     return &(this->_Shape);
 }
 
 Base::BoundBox3d PropertyPartShape::getBoundingBox() const
 {
+    restoreDeferredDocFile();
     Base::BoundBox3d box;
     if (_Shape.getShape().IsNull())
         return box;
@@ -150,11 +154,13 @@ Base::BoundBox3d PropertyPartShape::getBoundingBox() const
 
 void PropertyPartShape::setTransform(const Base::Matrix4D &rclTrf)
 {
+    restoreDeferredDocFile();
     _Shape.setTransform(rclTrf);
 }
 
 Base::Matrix4D PropertyPartShape::getTransform() const
 {
+    restoreDeferredDocFile();
     return _Shape.getTransform();
 }
 
@@ -167,6 +173,7 @@ void PropertyPartShape::transformGeometry(const Base::Matrix4D &rclTrf)
 
 PyObject *PropertyPartShape::getPyObject()
 {
+    restoreDeferredDocFile();
     Base::PyObjectBase* prop = static_cast<Base::PyObjectBase*>(_Shape.getPyObject());
     if (prop)
         prop->setConst();
@@ -203,6 +210,7 @@ void PropertyPartShape::setPyObject(PyObject *value)
 
 App::Property *PropertyPartShape::Copy() const
 {
+    restoreDeferredDocFile();
     PropertyPartShape *prop = new PropertyPartShape();
 
     // March, 2024 Toponaming project:  There was originally a feature to enable making an element
@@ -221,6 +229,7 @@ void PropertyPartShape::Paste(const App::Property &from)
 {
     auto prop = freecad_cast<const PropertyPartShape>(&from);
     if(prop) {
+        prop->restoreDeferredDocFile();
         setValue(prop->_Shape);
         _Ver = prop->_Ver;
     }
@@ -228,6 +237,7 @@ void PropertyPartShape::Paste(const App::Property &from)
 
 unsigned int PropertyPartShape::getMemSize () const
 {
+    restoreDeferredDocFile();
     return _Shape.getMemSize();
 }
 
@@ -247,6 +257,7 @@ void PropertyPartShape::getPaths(std::vector<App::ObjectIdentifier> &paths) cons
 
 void PropertyPartShape::beforeSave() const
 {
+    restoreDeferredDocFile();
     _HasherIndex = 0;
     _SaveHasher = false;
     auto owner = freecad_cast<App::DocumentObject>(getContainer());
@@ -259,6 +270,7 @@ void PropertyPartShape::beforeSave() const
 }
 void PropertyPartShape::Save (Base::Writer &writer) const
 {
+    restoreDeferredDocFile();
     //See SaveDocFile(), RestoreDocFile()
     writer.Stream() << writer.ind() << "<Part";
     auto owner = dynamic_cast<App::DocumentObject*>(getContainer());
@@ -562,8 +574,19 @@ void PropertyPartShape::loadFromStream(Base::Reader &reader)
     }
 }
 
+namespace {
+bool isDirectAccess()
+{
+    // On a worker thread this only reads the group, canSaveDocFileConcurrently() has
+    // already looked it up on the main thread
+    return App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Mod/Part/General")->GetBool("DirectAccess", true);
+}
+}
+
 void PropertyPartShape::SaveDocFile (Base::Writer &writer) const
 {
+    restoreDeferredDocFileForSave();
     // If the shape is empty we simply store nothing. The file size will be 0 which
     // can be checked when reading in the data.
     if (_Shape.getShape().IsNull())
@@ -575,9 +598,7 @@ void PropertyPartShape::SaveDocFile (Base::Writer &writer) const
         shape.exportBinary(writer.Stream());
     }
     else {
-        bool direct = App::GetApplication().GetParameterGroupByPath
-            ("User parameter:BaseApp/Preferences/Mod/Part/General")->GetBool("DirectAccess", true);
-        if (!direct) {
+        if (!isDirectAccess()) {
             saveToFile(writer);
         }
         else {
@@ -588,6 +609,38 @@ void PropertyPartShape::SaveDocFile (Base::Writer &writer) const
     }
 }
 
+bool PropertyPartShape::canSaveDocFileConcurrently() const
+{
+    // saveToFile() always uses the same temporary file
+    return isDirectAccess();
+}
+
+bool PropertyPartShape::deferRestoreDocFile(const std::shared_ptr<Base::DocFileArchive>& archive,
+                                            const std::string& fileName)
+{
+    return deferDocFile(archive, fileName);
+}
+
+bool PropertyPartShape::canSpillDocFile() const
+{
+    // nothing is written for an empty shape
+    return !_Shape.getShape().IsNull();
+}
+
+bool PropertyPartShape::isPayloadShared() const
+{
+    // Copy() shares the TShape, so a snapshot doesn't use memory of its own
+    // until the shape of the original property is replaced
+    const TopoDS_Shape& shape = _Shape.getShape();
+    return !shape.IsNull() && shape.TShape()->GetRefCount() > 1;
+}
+
+void PropertyPartShape::releaseDocFile()
+{
+    // keep the element map and the hasher, RestoreDocFile() applies them again
+    _Shape.setShape(TopoDS_Shape(), false);
+}
+
 void PropertyPartShape::RestoreDocFile(Base::Reader &reader)
 {
 
@@ -611,9 +664,7 @@ void PropertyPartShape::RestoreDocFile(Base::Reader &reader)
         shape.importBinary(reader);
     }
     else {
-        bool direct = App::GetApplication().GetParameterGroupByPath
-            ("User parameter:BaseApp/Preferences/Mod/Part/General")->GetBool("DirectAccess", true);
-        if (!direct) {
+        if (!isDirectAccess()) {
             loadFromFile(reader);
         }
         else {
@@ -90,6 +90,11 @@ public:
 
     void SaveDocFile (Base::Writer &writer) const override;
     void RestoreDocFile(Base::Reader &reader) override;
+    bool deferRestoreDocFile(const std::shared_ptr<Base::DocFileArchive>& archive,
+                             const std::string& fileName) override;
+    bool canSaveDocFileConcurrently() const override;
+    bool canSpillDocFile() const override;
+    bool isPayloadShared() const override;
 
     App::Property *Copy() const override;
     void Paste(const App::Property &from) override;
@@ -106,6 +111,9 @@ public:
 
     friend class Feature;
 
+protected:
+    void releaseDocFile() override;
+
 private:
     void saveToFile(Base::Writer &writer) const;
     void loadFromFile(Base::Reader &reader);
@@ -25,6 +25,7 @@
 #include <Base/Console.h>
 #include <Base/Interpreter.h>
 
+#include "FeatureProcessing.h"
 #include "Points.h"
 #include "PointsPy.h"
 #include "Properties.h"
@@ -60,6 +61,10 @@ PyMOD_INIT_FUNC(Points)
     Points::FeatureCustom           ::init();
     Points::StructuredCustom        ::init();
     Points::FeaturePython           ::init();
+    Points::ProcessingFeature       ::init();
+    Points::EstimateNormals         ::init();
+    Points::RemoveOutliers          ::init();
+    Points::Downsample              ::init();
     PyMOD_Return(pointsModule);
     // clang-format on
 }
@@ -0,0 +1,262 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+#include <limits>
+#include <vector>
+#endif
+
+#include <Base/Converter.h>
+#include <Base/Exception.h>
+
+#include "FeatureProcessing.h"
+#include "Processing.h"
+#include "Properties.h"
+
+
+namespace Points
+{
+const App::PropertyIntegerConstraint::Constraints intNeighbours = {1,
+                                                                   std::numeric_limits<int>::max(),
+                                                                   1};
+const App::PropertyLength::Constraints floatVoxelSize = {std::numeric_limits<float>::epsilon(),
+                                                         std::numeric_limits<float>::max(),
+                                                         0.1};
+}  // namespace Points
+
+using namespace Points;
+
+namespace
+{
+
+template<typename PropertyType, typename Values>
+void setDynamicValues(App::DocumentObject* obj, const char* name, const Values& values)
+{
+    if (values.empty()) {
+        obj->removeDynamicProperty(name);
+        return;
+    }
+    auto prop = dynamic_cast<PropertyType*>(obj->getPropertyByName(name));
+    if (!prop) {
+        prop = static_cast<PropertyType*>(
+            obj->addDynamicProperty(PropertyType::getClassTypeId().getName(), name));
+    }
+    prop->setValues(values);
+}
+
+}  // namespace
+
+//===========================================================================
+// ProcessingFeature
+//===========================================================================
+
+PROPERTY_SOURCE(Points::ProcessingFeature, Points::Feature)
+
+ProcessingFeature::ProcessingFeature()
+{
+    ADD_PROPERTY(Source, (nullptr));
+}
+
+short ProcessingFeature::mustExecute() const
+{
+    if (Source.isTouched()) {
+        return 1;
+    }
+    return 0;
+}
+
+App::DocumentObjectExecReturn* ProcessingFeature::execute()
+{
+    return App::DocumentObject::StdReturn;
+}
+
+Points::Feature* ProcessingFeature::getSourceFeature() const
+{
+    return dynamic_cast<Points::Feature*>(Source.getValue());
+}
+
+PointProperties ProcessingFeature::getPointProperties(const Points::Feature* source)
+{
+    PointProperties properties;
+    std::size_t size = source->Points.getValue().size();
+
+    auto normals = dynamic_cast<PropertyNormalList*>(source->getPropertyByName("Normal"));
+    if (normals && normals->getSize() == int(size)) {
+        properties.normals = normals->getValues();
+    }
+    auto intensity = dynamic_cast<PropertyGreyValueList*>(source->getPropertyByName("Intensity"));
+    if (intensity && intensity->getSize() == int(size)) {
+        properties.intensity = intensity->getValues();
+    }
+    auto colors = dynamic_cast<App::PropertyColorList*>(source->getPropertyByName("Color"));
+    if (colors && colors->getSize() == int(size)) {
+        properties.colors = colors->getValues();
+    }
+
+    return properties;
+}
+
+void ProcessingFeature::setPointProperties(const PointProperties& properties)
+{
+    setDynamicValues<PropertyNormalList>(this, "Normal", properties.normals);
+    setDynamicValues<PropertyGreyValueList>(this, "Intensity", properties.intensity);
+    setDynamicValues<App::PropertyColorList>(this, "Color", properties.colors);
+}
+
+// ----------------------------------------------------------------------
+
+PROPERTY_SOURCE(Points::EstimateNormals, Points::ProcessingFeature)
+
+EstimateNormals::EstimateNormals()
+{
+    ADD_PROPERTY(Neighbours, (10));
+    ADD_PROPERTY(Viewpoint, (Base::Vector3d()));
+    Neighbours.setConstraints(&intNeighbours);
+}
+
+short EstimateNormals::mustExecute() const
+{
+    if (Neighbours.isTouched() || Viewpoint.isTouched()) {
+        return 1;
+    }
+    return ProcessingFeature::mustExecute();
+}
+
+App::DocumentObjectExecReturn* EstimateNormals::execute()
+{
+    Points::Feature* source = getSourceFeature();
+    if (!source) {
+        return new App::DocumentObjectExecReturn("No points linked");
+    }
+
+    const PointKernel& kernel = source->Points.getValue();
+    PointProperties properties = getPointProperties(source);
+
+    // the viewpoint is given in global coordinates
+    Base::Matrix4D inverse = kernel.getTransform();
+    inverse.inverseGauss();
+    Base::Vector3d viewpoint = inverse * Viewpoint.getValue();
+
+    NormalEstimation estimation(kernel);
+    estimation.setNeighbours(Neighbours.getValue());
+    estimation.setViewpoint(Base::convertTo<Base::Vector3f>(viewpoint));
+    properties.normals = estimation.perform();
+
+    this->Points.setValue(kernel);
+    setPointProperties(properties);
+    return App::DocumentObject::StdReturn;
+}
+
+// ----------------------------------------------------------------------
+
+PROPERTY_SOURCE(Points::RemoveOutliers, Points::ProcessingFeature)
+
+RemoveOutliers::RemoveOutliers()
+{
+    ADD_PROPERTY(Neighbours, (8));
+    ADD_PROPERTY(StdDevFactor, (1.0));
+    Neighbours.setConstraints(&intNeighbours);
+}
+
+short RemoveOutliers::mustExecute() const
+{
+    if (Neighbours.isTouched() || StdDevFactor.isTouched()) {
+        return 1;
+    }
+    return ProcessingFeature::mustExecute();
+}
+
+App::DocumentObjectExecReturn* RemoveOutliers::execute()
+{
+    Points::Feature* source = getSourceFeature();
+    if (!source) {
+        return new App::DocumentObjectExecReturn("No points linked");
+    }
+
+    const PointKernel& kernel = source->Points.getValue();
+    PointProperties properties = getPointProperties(source);
+
+    OutlierRemoval removal(kernel);
+    removal.setNeighbours(Neighbours.getValue());
+    removal.setStdDevFactor(StdDevFactor.getValue());
+    std::vector<unsigned long> indices = removal.perform();
+
+    const std::vector<Base::Vector3f>& points = kernel.getBasicPoints();
+    std::vector<Base::Vector3f> kept;
+    kept.reserve(indices.size());
+    for (unsigned long index : indices) {
+        kept.push_back(points[index]);
+    }
+    properties.keep(indices);
+
+    PointKernel result;
+    result.swap(kept);
+    result.setTransform(kernel.getTransform());
+    this->Points.setValue(result);
+    setPointProperties(properties);
+    return App::DocumentObject::StdReturn;
+}
+
+// ----------------------------------------------------------------------
+
+PROPERTY_SOURCE(Points::Downsample, Points::ProcessingFeature)
+
+Downsample::Downsample()
+{
+    ADD_PROPERTY(VoxelSize, (1.0));
+    VoxelSize.setConstraints(&floatVoxelSize);
+}
+
+short Downsample::mustExecute() const
+{
+    if (VoxelSize.isTouched()) {
+        return 1;
+    }
+    return ProcessingFeature::mustExecute();
+}
+
+App::DocumentObjectExecReturn* Downsample::execute()
+{
+    Points::Feature* source = getSourceFeature();
+    if (!source) {
+        return new App::DocumentObjectExecReturn("No points linked");
+    }
+
+    try {
+        PointKernel result;
+        PointProperties resultProperties;
+        VoxelDownsampling sampling(VoxelSize.getValue());
+        sampling.perform(source->Points.getValue(),
+                         getPointProperties(source),
+                         result,
+                         resultProperties);
+
+        this->Points.setValue(result);
+        setPointProperties(resultProperties);
+    }
+    catch (const Base::Exception& e) {
+        return new App::DocumentObjectExecReturn(e.what());
+    }
+
+    return App::DocumentObject::StdReturn;
+}
@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+#ifndef POINTS_FEATURE_PROCESSING_H
+#define POINTS_FEATURE_PROCESSING_H
+
+#include <App/PropertyLinks.h>
+#include <App/PropertyStandard.h>
+#include <App/PropertyUnits.h>
+
+#include "PointsFeature.h"
+
+
+namespace Points
+{
+
+struct PointProperties;
+
+/**
+ * The ProcessingFeature class is the base class of the operations that process the points of
+ * the linked feature. The per-point properties Normal, Intensity and Color of the source are
+ * passed on to the result.
+ */
+class PointsExport ProcessingFeature: public Points::Feature
+{
+    PROPERTY_HEADER_WITH_OVERRIDE(Points::ProcessingFeature);
+
+public:
+    /// Constructor
+    ProcessingFeature();
+
+    /** @name Properties */
+    //@{
+    App::PropertyLink Source;
+    //@}
+
+    /** @name methods override Feature */
+    //@{
+    /// recalculate the Feature
+    App::DocumentObjectExecReturn* execute() override;
+    short mustExecute() const override;
+    //@}
+
+protected:
+    /// Returns the points feature linked by Source or null
+    Points::Feature* getSourceFeature() const;
+    /// Returns the per-point properties of \a source that have an entry for each point
+    static PointProperties getPointProperties(const Points::Feature* source);
+    /// Adds, sets or removes the dynamic per-point properties of this feature
+    void setPointProperties(const PointProperties& properties);
+};
+
+/**
+ * The EstimateNormals class computes the normals of the points of the source.
+ */
+class PointsExport EstimateNormals: public Points::ProcessingFeature
+{
+    PROPERTY_HEADER_WITH_OVERRIDE(Points::EstimateNormals);
+
+public:
+    /// Constructor
+    EstimateNormals();
+
+    /** @name Properties */
+    //@{
+    App::PropertyIntegerConstraint Neighbours;
+    App::PropertyVector Viewpoint;
+    //@}
+
+    /** @name methods override Feature */
+    //@{
+    /// recalculate the Feature
+    App::DocumentObjectExecReturn* execute() override;
+    short mustExecute() const override;
+    //@}
+};
+
+/**
+ * The RemoveOutliers class removes the statistical outliers of the points of the source.
+ */
+class PointsExport RemoveOutliers: public Points::ProcessingFeature
+{
+    PROPERTY_HEADER_WITH_OVERRIDE(Points::RemoveOutliers);
+
+public:
+    /// Constructor
+    RemoveOutliers();
+
+    /** @name Properties */
+    //@{
+    App::PropertyIntegerConstraint Neighbours;
+    App::PropertyFloat StdDevFactor;
+    //@}
+
+    /** @name methods override Feature */
+    //@{
+    /// recalculate the Feature
+    App::DocumentObjectExecReturn* execute() override;
+    short mustExecute() const override;
+    //@}
+};
+
+/**
+ * The Downsample class replaces the points of the source inside each voxel by their centroid.
+ */
+class PointsExport Downsample: public Points::ProcessingFeature
+{
+    PROPERTY_HEADER_WITH_OVERRIDE(Points::Downsample);
+
+public:
+    /// Constructor
+    Downsample();
+
+    /** @name Properties */
+    //@{
+    App::PropertyLength VoxelSize;
+    //@}
+
+    /** @name methods override Feature */
+    //@{
+    /// recalculate the Feature
+    App::DocumentObjectExecReturn* execute() override;
+    short mustExecute() const override;
+    //@}
+};
+
+}  // namespace Points
+
+
+#endif  // POINTS_FEATURE_PROCESSING_H
@@ -0,0 +1,510 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <random>
+#include <QFile>
+#endif
+
+#include <Base/Exception.h>
+#include <Base/FileInfo.h>
+
+#include "PointOctree.h"
+
+
+using namespace Points;
+
+namespace
+{
+// below this the octants get too small for float coordinates
+constexpr int maxDepth = 20;
+// number of points collected before they are written to the spill file
+constexpr std::size_t spillBlock = 65536;
+
+int octantOf(const Base::Vector3f& pnt, const Base::Vector3f& center)
+{
+    return (pnt.x >= center.x ? 1 : 0) | (pnt.y >= center.y ? 2 : 0)
+        | (pnt.z >= center.z ? 4 : 0);
+}
+
+float distanceToBox(const Base::BoundBox3f& box, const Base::Vector3f& pnt)
+{
+    float dx = std::max({box.MinX - pnt.x, 0.0F, pnt.x - box.MaxX});
+    float dy = std::max({box.MinY - pnt.y, 0.0F, pnt.y - box.MaxY});
+    float dz = std::max({box.MinZ - pnt.z, 0.0F, pnt.z - box.MaxZ});
+    return dx * dx + dy * dy + dz * dz;
+}
+}  // namespace
+
+bool PointOctree::Node::isLeaf() const
+{
+    return std::all_of(children.begin(), children.end(), [](std::int32_t child) {
+        return child < 0;
+    });
+}
+
+PointOctree::PointOctree(std::size_t maxLeafSize, std::size_t memoryBudget)
+    : maxLeafSize(std::max<std::size_t>(maxLeafSize, 1))
+    , memoryBudget(memoryBudget)
+{}
+
+PointOctree::~PointOctree()
+{
+    clear();
+}
+
+void PointOctree::addPoints(const value_type* points, std::size_t count)
+{
+    if (isFinished()) {
+        throw Base::RuntimeError("Points cannot be added to a finished octree");
+    }
+
+    for (std::size_t index = 0; index < count; index++) {
+        const value_type& pnt = points[index];
+        if (std::isnan(pnt.x) || std::isnan(pnt.y) || std::isnan(pnt.z)) {
+            numInvalid++;
+            continue;
+        }
+
+        bbox.Add(pnt);
+        buffer.push_back(pnt);
+        numPoints++;
+        if (buffer.size() >= spillBlock) {
+            flush();
+        }
+    }
+}
+
+void PointOctree::addPoints(const std::vector<value_type>& points)
+{
+    addPoints(points.data(), points.size());
+}
+
+void PointOctree::addPoints(const PointKernel& kernel)
+{
+    addPoints(kernel.getBasicPoints());
+    transform = kernel.getTransform();
+}
+
+void PointOctree::flush()
+{
+    if (buffer.empty()) {
+        return;
+    }
+
+    if (!spillFile) {
+        spillName = Base::FileInfo::getTempFileName("PointOctree");
+        spillFile = std::make_unique<QFile>(QString::fromUtf8(spillName.c_str()));
+        if (!spillFile->open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+            spillFile.reset();
+            throw Base::FileSystemError("Cannot create the point spill file");
+        }
+    }
+
+    writePoints(spillFile.get(), numPoints - buffer.size(), buffer.size(), buffer.data());
+    buffer.clear();
+}
+
+void PointOctree::finish()
+{
+    if (isFinished()) {
+        return;
+    }
+
+    flush();
+    buffer.shrink_to_fit();
+    if (numPoints == 0) {
+        return;
+    }
+
+    // the root is a cube around all points
+    Base::Vector3f center = bbox.GetCenter();
+    float half = 0.5F * std::max({bbox.LengthX(), bbox.LengthY(), bbox.LengthZ()});
+    half = half > 0.0F ? half * 1.0001F : 1.0F;
+
+    Node root;
+    root.box = Base::BoundBox3f(center.x - half,
+                                center.y - half,
+                                center.z - half,
+                                center.x + half,
+                                center.y + half,
+                                center.z + half);
+    root.count = numPoints;
+    nodes.push_back(root);
+
+    cacheName = Base::FileInfo::getTempFileName("PointOctree");
+    cacheFile = std::make_unique<QFile>(QString::fromUtf8(cacheName.c_str()));
+    qint64 bytes = qint64(numPoints * sizeof(value_type));
+    if (!cacheFile->open(QIODevice::ReadWrite | QIODevice::Truncate)
+        || !cacheFile->resize(bytes)) {
+        throw Base::FileSystemError("Cannot create the point cache file");
+    }
+
+    build(0, spillFile.get(), 0);
+    spillFile->remove();
+    spillFile.reset();
+
+    mapped = reinterpret_cast<const value_type*>(cacheFile->map(0, bytes));
+    if (!mapped) {
+        throw Base::FileSystemError("Cannot map the point cache file");
+    }
+}
+
+void PointOctree::build(std::int32_t node, QFile* source, int depth)
+{
+    const size_type offset = nodes[node].offset;
+    const size_type count = nodes[node].count;
+    const bool leaf = count <= maxLeafSize || depth >= maxDepth;
+    const bool fits = count * sizeof(value_type) <= memoryBudget;
+
+    if (leaf && !fits && count > maxLeafSize) {
+        // too many equal points for the memory budget, keep them as they are
+        if (source != cacheFile.get()) {
+            copyPoints(source, cacheFile.get(), offset, count);
+        }
+        return;
+    }
+
+    if (leaf || fits) {
+        std::vector<value_type> points(count);
+        readPoints(source, offset, count, points.data());
+        buildInMemory(node, points.data(), depth);
+        writePoints(cacheFile.get(), offset, count, points.data());
+        return;
+    }
+
+    // distribute the points over the octants, alternating between the two files
+    const Base::Vector3f center = nodes[node].box.GetCenter();
+    const size_type block = std::max<size_type>(memoryBudget / (2 * sizeof(value_type)), 1024);
+    std::vector<value_type> points(std::min(block, count));
+
+    std::array<size_type, 8> counts {};
+    for (size_type start = 0; start < count; start += block) {
+        size_type num = std::min(block, count - start);
+        readPoints(source, offset + start, num, points.data());
+        for (size_type index = 0; index < num; index++) {
+            counts[octantOf(points[index], center)]++;
+        }
+    }
+
+    std::array<size_type, 8> positions {};
+    positions[0] = offset;
+    for (int octant = 1; octant < 8; octant++) {
+        positions[octant] = positions[octant - 1] + counts[octant - 1];
+    }
+
+    QFile* target = source == cacheFile.get() ? spillFile.get() : cacheFile.get();
+    const std::size_t bucketSize = std::max<std::size_t>(block / 8, 256);
+    std::array<std::vector<value_type>, 8> buckets;
+    auto writeBucket = [&](int octant) {
+        std::vector<value_type>& bucket = buckets[octant];
+        writePoints(target, positions[octant], bucket.size(), bucket.data());
+        positions[octant] += bucket.size();
+        bucket.clear();
+    };
+
+    for (size_type start = 0; start < count; start += block) {
+        size_type num = std::min(block, count - start);
+        readPoints(source, offset + start, num, points.data());
+        for (size_type index = 0; index < num; index++) {
+            int octant = octantOf(points[index], center);
+            buckets[octant].push_back(points[index]);
+            if (buckets[octant].size() >= bucketSize) {
+                writeBucket(octant);
+            }
+        }
+    }
+    for (int octant = 0; octant < 8; octant++) {
+        writeBucket(octant);
+    }
+    points.clear();
+    points.shrink_to_fit();
+
+    size_type start = offset;
+    for (int octant = 0; octant < 8; octant++) {
+        if (counts[octant] > 0) {
+            std::int32_t child = addChild(node, octant, start, counts[octant]);
+            build(child, target, depth + 1);
+            start += counts[octant];
+        }
+    }
+}
+
+void PointOctree::buildInMemory(std::int32_t node, value_type* points, int depth)
+{
+    const size_type offset = nodes[node].offset;
+    const size_type count = nodes[node].count;
+    if (count <= maxLeafSize || depth >= maxDepth) {
+        // so that any prefix of the leaf is an evenly thinned out subset
+        std::mt19937 generator(static_cast<std::uint32_t>(offset));
+        std::shuffle(points, points + count, generator);
+        return;
+    }
+
+    // sort by octant, with the same numbering as octantOf()
+    const Base::Vector3f center = nodes[node].box.GetCenter();
+    std::array<value_type*, 9> bounds {};
+    bounds[0] = points;
+    bounds[8] = points + count;
+    bounds[4] = std::partition(bounds[0], bounds[8], [&](const value_type& pnt) {
+        return pnt.z < center.z;
+    });
+    for (int index = 0; index < 8; index += 4) {
+        bounds[index + 2] =
+            std::partition(bounds[index], bounds[index + 4], [&](const value_type& pnt) {
+                return pnt.y < center.y;
+            });
+    }
+    for (int index = 0; index < 8; index += 2) {
+        bounds[index + 1] =
+            std::partition(bounds[index], bounds[index + 2], [&](const value_type& pnt) {
+                return pnt.x < center.x;
+            });
+    }
+
+    for (int octant = 0; octant < 8; octant++) {
+        size_type num = size_type(bounds[octant + 1] - bounds[octant]);
+        if (num > 0) {
+            size_type start = offset + size_type(bounds[octant] - points);
+            std::int32_t child = addChild(node, octant, start, num);
+            buildInMemory(child, bounds[octant], depth + 1);
+        }
+    }
+}
+
+std::int32_t PointOctree::addChild(std::int32_t node, int octant, size_type offset, size_type count)
+{
+    const Base::BoundBox3f& box = nodes[node].box;
+    const Base::Vector3f center = box.GetCenter();
+
+    Node child;
+    child.box.MinX = (octant & 1) != 0 ? center.x : box.MinX;
+    child.box.MaxX = (octant & 1) != 0 ? box.MaxX : center.x;
+    child.box.MinY = (octant & 2) != 0 ? center.y : box.MinY;
+    child.box.MaxY = (octant & 2) != 0 ? box.MaxY : center.y;
+    child.box.MinZ = (octant & 4) != 0 ? center.z : box.MinZ;
+    child.box.MaxZ = (octant & 4) != 0 ? box.MaxZ : center.z;
+    child.offset = offset;
+    child.count = count;
+
+    auto index = static_cast<std::int32_t>(nodes.size());
+    nodes.push_back(child);
+    nodes[node].children[octant] = index;
+    return index;
+}
+
+void PointOctree::readPoints(QFile* file,
+                             size_type offset,
+                             size_type count,
+                             value_type* points) const
+{
+    auto bytes = qint64(count * sizeof(value_type));
+    if (!file->seek(qint64(offset * sizeof(value_type)))
+        || file->read(reinterpret_cast<char*>(points), bytes) != bytes) {
+        throw Base::FileSystemError("Cannot read from the point cache file");
+    }
+}
+
+void PointOctree::writePoints(QFile* file,
+                              size_type offset,
+                              size_type count,
+                              const value_type* points)
+{
+    auto bytes = qint64(count * sizeof(value_type));
+    if (!file->seek(qint64(offset * sizeof(value_type)))
+        || file->write(reinterpret_cast<const char*>(points), bytes) != bytes) {
+        throw Base::FileSystemError("Cannot write to the point cache file");
+    }
+}
+
+void PointOctree::copyPoints(QFile* source, QFile* target, size_type offset, size_type count)
+{
+    const size_type block = std::max<size_type>(memoryBudget / sizeof(value_type), 1024);
+    std::vector<value_type> points(std::min(block, count));
+    for (size_type start = 0; start < count; start += block) {
+        size_type num = std::min(block, count - start);
+        readPoints(source, offset + start, num, points.data());
+        writePoints(target, offset + start, num, points.data());
+    }
+}
+
+void PointOctree::clear()
+{
+    if (cacheFile) {
+        if (mapped) {
+            cacheFile->unmap(reinterpret_cast<uchar*>(const_cast<value_type*>(mapped)));
+        }
+        cacheFile->remove();
+        cacheFile.reset();
+    }
+    if (spillFile) {
+        spillFile->remove();
+        spillFile.reset();
+    }
+
+    mapped = nullptr;
+    numPoints = 0;
+    numInvalid = 0;
+    bbox = Base::BoundBox3f();
+    nodes.clear();
+    buffer.clear();
+}
+
+bool PointOctree::isFinished() const
+{
+    return !nodes.empty();
+}
+
+PointOctree::size_type PointOctree::size() const
+{
+    return numPoints;
+}
+
+PointOctree::size_type PointOctree::countInvalid() const
+{
+    return numInvalid;
+}
+
+const Base::Matrix4D& PointOctree::getTransform() const
+{
+    return transform;
+}
+
+void PointOctree::setTransform(const Base::Matrix4D& mat)
+{
+    transform = mat;
+}
+
+const Base::BoundBox3f& PointOctree::getBoundBox() const
+{
+    return bbox;
+}
+
+const std::vector<PointOctree::Node>& PointOctree::getNodes() const
+{
+    return nodes;
+}
+
+const PointOctree::value_type* PointOctree::getPoints(const Node& node) const
+{
+    return mapped + node.offset;
+}
+
+void PointOctree::visitLeaves(const Base::BoundBox3f& box, const LeafVisitor& visitor) const
+{
+    if (nodes.empty()) {
+        return;
+    }
+
+    std::vector<std::int32_t> stack {0};
+    while (!stack.empty()) {
+        const Node& node = nodes[stack.back()];
+        stack.pop_back();
+        if (!node.box.Intersect(box)) {
+            continue;
+        }
+
+        if (node.isLeaf()) {
+            visitor(getPoints(node), std::size_t(node.count));
+        }
+        else {
+            // keep the order of the cache file
+            for (auto it = node.children.rbegin(); it != node.children.rend(); ++it) {
+                if (*it >= 0) {
+                    stack.push_back(*it);
+                }
+            }
+        }
+    }
+}
+
+void PointOctree::searchBox(const Base::BoundBox3f& box, std::vector<value_type>& points) const
+{
+    visitLeaves(box, [&](const value_type* leaf, std::size_t count) {
+        std::copy_if(leaf, leaf + count, std::back_inserter(points), [&](const value_type& pnt) {
+            return box.IsInBox(pnt);
+        });
+    });
+}
+
+void PointOctree::getLevelOfDetail(const Base::BoundBox3f& box,
+                                   std::size_t maxPoints,
+                                   std::vector<value_type>& points) const
+{
+    std::vector<std::pair<const value_type*, std::size_t>> leaves;
+    std::size_t total = 0;
+    visitLeaves(box, [&](const value_type* leaf, std::size_t count) {
+        leaves.emplace_back(leaf, count);
+        total += count;
+    });
+
+    // the leaves are shuffled, so their prefixes are evenly distributed
+    double fraction = total > maxPoints ? double(maxPoints) / double(total) : 1.0;
+    for (const auto& it : leaves) {
+        auto num = std::min(it.second, std::size_t(std::ceil(double(it.second) * fraction)));
+        points.insert(points.end(), it.first, it.first + num);
+    }
+}
+
+bool PointOctree::nearestPoint(const value_type& pnt, value_type& nearest) const
+{
+    if (nodes.empty()) {
+        return false;
+    }
+
+    // visit the nodes by their distance to the point
+    using Entry = std::pair<float, std::int32_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<>> queue;
+    queue.emplace(distanceToBox(nodes.front().box, pnt), 0);
+
+    float minDist = std::numeric_limits<float>::max();
+    while (!queue.empty() && queue.top().first < minDist) {
+        const Node& node = nodes[queue.top().second];
+        queue.pop();
+        if (node.isLeaf()) {
+            const value_type* leaf = getPoints(node);
+            for (size_type index = 0; index < node.count; index++) {
+                float dist = Base::DistanceP2(pnt, leaf[index]);
+                if (dist < minDist) {
+                    minDist = dist;
+                    nearest = leaf[index];
+                }
+            }
+        }
+        else {
+            for (std::int32_t child : node.children) {
+                if (child >= 0) {
+                    float dist = distanceToBox(nodes[child].box, pnt);
+                    if (dist < minDist) {
+                        queue.emplace(dist, child);
+                    }
+                }
+            }
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,170 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+#ifndef POINTS_POINTOCTREE_H
+#define POINTS_POINTOCTREE_H
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Base/BoundBox.h>
+#include <Base/Matrix.h>
+
+#include "Points.h"
+
+class QFile;
+
+namespace Points
+{
+
+/**
+ * The PointOctree keeps a point cloud that doesn't need to fit into memory.
+ *
+ * The points are streamed in with addPoints() and spilled to a temporary file. finish()
+ * sorts them into the leaves of an octree so that the points of each subtree are
+ * contiguous in a cache file. Parts that fit into the memory budget are sorted in memory,
+ * larger parts are distributed over the octants on disk. Afterwards the cache file is
+ * memory-mapped, so only the leaves that are accessed are paged in by the operating system.
+ *
+ * The points of a leaf are shuffled, so every prefix of a leaf is an evenly thinned out
+ * subset of it. This is used by getLevelOfDetail() to pick a subset of a given size.
+ *
+ * The points are kept in the local coordinate system, i.e. without the placement.
+ * Points with NaN coordinates are skipped.
+ */
+class PointsExport PointOctree
+{
+public:
+    using value_type = PointKernel::value_type;
+    using size_type = std::uint64_t;
+    /// Called with the points of a leaf and their number
+    using LeafVisitor = std::function<void(const value_type*, std::size_t)>;
+
+    struct Node
+    {
+        /// The octant of the node
+        Base::BoundBox3f box;
+        /// Index of the first point of the subtree in the cache file
+        size_type offset {0};
+        /// Number of points in the subtree
+        size_type count {0};
+        /// Indices of the child nodes, -1 for empty octants
+        std::array<std::int32_t, 8> children {-1, -1, -1, -1, -1, -1, -1, -1};
+
+        bool isLeaf() const;
+    };
+
+    /**
+     * \a maxLeafSize is the number of points a leaf is split at, \a memoryBudget the
+     * number of bytes the points may occupy in memory while sorting.
+     */
+    explicit PointOctree(std::size_t maxLeafSize = 65536,
+                         std::size_t memoryBudget = std::size_t(256) << 20);
+    ~PointOctree();
+
+    PointOctree(const PointOctree&) = delete;
+    PointOctree(PointOctree&&) = delete;
+    PointOctree& operator=(const PointOctree&) = delete;
+    PointOctree& operator=(PointOctree&&) = delete;
+
+    /** @name Construction */
+    //@{
+    /// Appends the points to the spill file, must be called before finish()
+    void addPoints(const value_type* points, std::size_t count);
+    void addPoints(const std::vector<value_type>& points);
+    /// Appends the points of the kernel and takes over its placement
+    void addPoints(const PointKernel& kernel);
+    /// Builds the octree of all added points
+    void finish();
+    /// Removes all points and the temporary files
+    void clear();
+    bool isFinished() const;
+    //@}
+
+    /** @name Access */
+    //@{
+    /// Number of points in the octree
+    size_type size() const;
+    /// Number of skipped points with NaN coordinates
+    size_type countInvalid() const;
+    const Base::Matrix4D& getTransform() const;
+    void setTransform(const Base::Matrix4D& mat);
+    /// Bounding box of the points in local coordinates
+    const Base::BoundBox3f& getBoundBox() const;
+    /// The nodes in depth-first order, the first one is the root
+    const std::vector<Node>& getNodes() const;
+    /// The points of the subtree of \a node, they are paged in on access
+    const value_type* getPoints(const Node& node) const;
+    //@}
+
+    /** @name Queries */
+    //@{
+    /// Calls \a visitor for all leaves whose octant intersects with \a box
+    void visitLeaves(const Base::BoundBox3f& box, const LeafVisitor& visitor) const;
+    /// Appends all points inside \a box to \a points
+    void searchBox(const Base::BoundBox3f& box, std::vector<value_type>& points) const;
+    /**
+     * Appends an evenly distributed subset of about \a maxPoints points of the leaves that
+     * intersect with \a box to \a points. Points of these leaves outside the box are
+     * included too.
+     */
+    void getLevelOfDetail(const Base::BoundBox3f& box,
+                          std::size_t maxPoints,
+                          std::vector<value_type>& points) const;
+    /// Searches for the point nearest to \a pnt, returns false if the octree is empty
+    bool nearestPoint(const value_type& pnt, value_type& nearest) const;
+    //@}
+
+private:
+    void flush();
+    void build(std::int32_t node, QFile* source, int depth);
+    void buildInMemory(std::int32_t node, value_type* points, int depth);
+    std::int32_t addChild(std::int32_t node, int octant, size_type offset, size_type count);
+    void readPoints(QFile* file, size_type offset, size_type count, value_type* points) const;
+    void writePoints(QFile* file, size_type offset, size_type count, const value_type* points);
+    void copyPoints(QFile* source, QFile* target, size_type offset, size_type count);
+
+private:
+    std::size_t maxLeafSize;
+    std::size_t memoryBudget;
+    size_type numPoints {0};
+    size_type numInvalid {0};
+    Base::BoundBox3f bbox;
+    Base::Matrix4D transform;
+    std::vector<Node> nodes;
+
+    /// Points not yet written to the spill file
+    std::vector<value_type> buffer;
+    std::string spillName;
+    std::string cacheName;
+    std::unique_ptr<QFile> spillFile;
+    std::unique_ptr<QFile> cacheFile;
+    const value_type* mapped {nullptr};
+};
+
+}  // namespace Points
+
+
+#endif  // POINTS_POINTOCTREE_H
@@ -114,6 +114,10 @@ public:
     unsigned int getMemSize() const override;
     void Save(Base::Writer& writer) const override;
     void SaveDocFile(Base::Writer& writer) const override;
+    bool canSaveDocFileConcurrently() const override
+    {
+        return true;
+    }
     void Restore(Base::XMLReader& reader) override;
     void RestoreDocFile(Base::Reader& reader) override;
     void save(const char* file) const;
@@ -25,8 +25,15 @@
 #ifdef FC_OS_LINUX
 #include <unistd.h>
 #endif
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdlib>
+#include <cstring>
 #include <memory>
 #include <sstream>
+#include <QFile>
+#include <QtConcurrentMap>
 
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
@@ -47,6 +54,189 @@
 
 using namespace Points;
 
+namespace
+{
+// Gives access to the content of a file, see MeshInput::LoadMappedFile. If the file cannot be
+// mapped into memory its content is read instead.
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& filename)
+        : file(QString::fromUtf8(filename.c_str()))
+    {
+        if (!file.open(QIODevice::ReadOnly)) {
+            throw Base::FileException("File to load not existing or not readable",
+                                      filename.c_str());
+        }
+
+        size = static_cast<std::size_t>(file.size());
+        if (size > 0) {
+            memory = file.map(0, file.size());
+            if (memory) {
+                data = reinterpret_cast<const char*>(memory);
+            }
+            else {
+                buffer.resize(size);
+                if (file.read(buffer.data(), file.size()) != file.size()) {
+                    throw Base::FileException("Failed to read file", filename.c_str());
+                }
+                data = buffer.data();
+            }
+        }
+    }
+    ~MappedFile()
+    {
+        if (memory) {
+            file.unmap(memory);
+        }
+    }
+
+    const char* begin() const
+    {
+        return data;
+    }
+    const char* end() const
+    {
+        return data + size;
+    }
+    // the end is returned for positions outside, e.g. of tellg() at the end of the file
+    const char* at(std::streamoff pos) const
+    {
+        return pos >= 0 && std::size_t(pos) < size ? data + pos : end();
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile(MappedFile&&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile& operator=(MappedFile&&) = delete;
+
+private:
+    QFile file;
+    uchar* memory {nullptr};
+    std::vector<char> buffer;
+    const char* data {nullptr};
+    std::size_t size {0};
+};
+
+// A part of a text that starts at the beginning of a line
+struct TextChunk
+{
+    const char* begin {nullptr};
+    const char* end {nullptr};
+    // index of the first line over all chunks
+    std::size_t first {0};
+    // number of lines, or of the lines that were used
+    std::size_t count {0};
+    bool failed {false};
+};
+
+// Splits the text into chunks of a few megabytes at line breaks
+std::vector<TextChunk> splitLines(const char* begin, const char* end)
+{
+    constexpr std::ptrdiff_t chunkSize = 4 << 20;
+    std::vector<TextChunk> chunks;
+    while (begin < end) {
+        const char* next = end;
+        if (end - begin > chunkSize) {
+            next = static_cast<const char*>(
+                std::memchr(begin + chunkSize, '\n', std::size_t(end - begin - chunkSize)));
+            next = next ? next + 1 : end;
+        }
+
+        TextChunk chunk;
+        chunk.begin = begin;
+        chunk.end = next;
+        chunks.push_back(chunk);
+        begin = next;
+    }
+    return chunks;
+}
+
+// Calls func with the begin and end of each line, without the line break
+template<typename Func>
+void forEachLine(const char* begin, const char* end, Func&& func)
+{
+    while (begin < end) {
+        const char* eol =
+            static_cast<const char*>(std::memchr(begin, '\n', std::size_t(end - begin)));
+        if (!eol) {
+            eol = end;
+        }
+        func(begin, eol);
+        begin = eol + 1;
+    }
+}
+
+bool isBlank(const char* begin, const char* end)
+{
+    return std::all_of(begin, end, [](char c) {
+        return std::isspace(static_cast<unsigned char>(c)) != 0;
+    });
+}
+
+// Reads up to maxValues numbers of a line. Returns the number of numbers of the line or -1 if
+// it contains anything else. In strict mode only plain decimal numbers are accepted.
+int parseNumbers(const char* begin,
+                 const char* end,
+                 bool strict,
+                 std::string& line,
+                 double* values,
+                 int maxValues)
+{
+    auto isSpace = [](char c) {
+        return std::isspace(static_cast<unsigned char>(c)) != 0;
+    };
+    auto isDecimal = [](char c) {
+        return std::isdigit(static_cast<unsigned char>(c)) != 0 || c == '+' || c == '-'
+            || c == '.' || c == 'e' || c == 'E';
+    };
+
+    // strtod needs a terminated string
+    line.assign(begin, end);
+    const char* pos = line.c_str();
+    int count = 0;
+    while (true) {
+        while (isSpace(*pos)) {
+            pos++;
+        }
+        if (*pos == '\0') {
+            break;
+        }
+
+        char* next = nullptr;
+        double value = std::strtod(pos, &next);
+        if (next == pos || (*next != '\0' && !isSpace(*next))) {
+            return -1;
+        }
+        if (strict && !std::all_of(pos, static_cast<const char*>(next), isDecimal)) {
+            return -1;
+        }
+
+        if (count < maxValues) {
+            values[count] = value;
+        }
+        count++;
+        pos = next;
+    }
+
+    return count;
+}
+
+// Calls func for consecutive ranges of [0, count) on all cores
+template<typename Func>
+void parallelRanges(std::size_t count, Func&& func)
+{
+    constexpr std::size_t blockSize = 65536;
+    std::vector<std::pair<std::size_t, std::size_t>> ranges;
+    for (std::size_t begin = 0; begin < count; begin += blockSize) {
+        ranges.emplace_back(begin, std::min(count, begin + blockSize));
+    }
+    QtConcurrent::blockingMap(ranges, [&func](std::pair<std::size_t, std::size_t>& range) {
+        func(range.first, range.second);
+    });
+}
+}  // namespace
+
 void PointsAlgos::Load(PointKernel& points, const char* FileName)
 {
     Base::FileInfo File(FileName);
@@ -66,60 +256,60 @@ void PointsAlgos::Load(PointKernel& points, const char* FileName)
 
 void PointsAlgos::LoadAscii(PointKernel& points, const char* FileName)
 {
-    boost::regex rx("^\\s*([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                    "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                    "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)\\s*$");
-    // boost::regex rx("(\\b[0-9]+\\.([0-9]+\\b)?|\\.[0-9]+\\b)");
-    // boost::regex
-    // rx("^\\s*(-?[0-9]*)\\.([0-9]+)\\s+(-?[0-9]*)\\.([0-9]+)\\s+(-?[0-9]*)\\.([0-9]+)\\s*$");
-    boost::cmatch what;
-
-    Base::Vector3d pt;
-    int LineCnt = 0;
-    std::string line;
-    Base::FileInfo fi(FileName);
+    MappedFile file(FileName);
+    std::vector<TextChunk> chunks = splitLines(file.begin(), file.end());
 
-    Base::ifstream tmp_str(fi, std::ios::in);
+    // the number of lines is an upper bound of the number of points
+    QtConcurrent::blockingMap(chunks, [](TextChunk& chunk) {
+        chunk.count = std::size_t(std::count(chunk.begin, chunk.end, '\n'));
+        if (chunk.begin < chunk.end && chunk.end[-1] != '\n') {
+            chunk.count++;
+        }
+    });
 
-    // estimating size
-    while (std::getline(tmp_str, line)) {
-        LineCnt++;
+    std::size_t numLines = 0;
+    for (TextChunk& chunk : chunks) {
+        chunk.first = numLines;
+        numLines += chunk.count;
     }
 
     // resize the PointKernel
-    points.resize(LineCnt);
-
-    Base::SequencerLauncher seq("Loading points...", LineCnt);
-
-    // again to the beginning
-    Base::ifstream file(fi, std::ios::in);
-    LineCnt = 0;
+    points.resize(numLines);
+
+    // each chunk writes the points of its valid lines to the start of its range and the
+    // progress is updated after a few chunks
+    constexpr std::ptrdiff_t batchSize = 16;
+    Base::SequencerLauncher seq("Loading points...", chunks.size());
+    for (auto it = chunks.begin(); it != chunks.end();) {
+        auto next = it + std::min(batchSize, std::distance(it, chunks.end()));
+        QtConcurrent::blockingMap(it, next, [&points](TextChunk& chunk) {
+            std::string buffer;
+            std::array<double, 3> pt {};
+            std::size_t index = chunk.first;
+            forEachLine(chunk.begin, chunk.end, [&](const char* line, const char* eol) {
+                if (parseNumbers(line, eol, true, buffer, pt.data(), 3) == 3) {
+                    points.setPoint(int(index++), Base::Vector3d(pt[0], pt[1], pt[2]));
+                }
+            });
+            chunk.count = index - chunk.first;
+        });
 
-    try {
-        // read file
-        while (std::getline(file, line)) {
-            if (boost::regex_match(line.c_str(), what, rx)) {
-                pt.x = std::atof(what[1].first);
-                pt.y = std::atof(what[4].first);
-                pt.z = std::atof(what[7].first);
-
-                points.setPoint(LineCnt, pt);
-                seq.next();
-                LineCnt++;
-            }
+        for (; it != next; ++it) {
+            seq.next();
         }
     }
-    catch (...) {
-        points.clear();
-        throw Base::BadFormatError("Reading in points failed.");
-    }
 
-    // now remove the last points from the kernel
-    // Note: first we allocate memory corresponding to the number of lines (points and comments)
-    //       and read in the file twice. But then the size of the kernel is too high
-    if (LineCnt < (int)points.size()) {
-        points.erase(LineCnt, points.size());
-    }
+    // now remove the gaps of the lines that are not points
+    std::vector<PointKernel::value_type>& kernel = points.getBasicPoints();
+    std::size_t numPoints = 0;
+    for (const TextChunk& chunk : chunks) {
+        auto first = kernel.begin() + std::ptrdiff_t(chunk.first);
+        std::copy(first,
+                  first + std::ptrdiff_t(chunk.count),
+                  kernel.begin() + std::ptrdiff_t(numPoints));
+        numPoints += chunk.count;
+    }
+    points.resize(numPoints);
 }
 
 // ----------------------------------------------------------------------------
@@ -246,90 +436,6 @@ public:
 
 using ConverterPtr = std::shared_ptr<Converter>;
 
-class DataStreambuf: public std::streambuf
-{
-public:
-    explicit DataStreambuf(const std::vector<char>& data)
-        : _buffer(data)
-        , _end(int(data.size()))
-    {}
-    ~DataStreambuf() override = default;
-
-protected:
-    int_type uflow() override
-    {
-        if (_cur == _end) {
-            return traits_type::eof();
-        }
-
-        return static_cast<DataStreambuf::int_type>(_buffer[_cur++]) & 0x000000ff;
-    }
-    int_type underflow() override
-    {
-        if (_cur == _end) {
-            return traits_type::eof();
-        }
-
-        return static_cast<DataStreambuf::int_type>(_buffer[_cur]) & 0x000000ff;
-    }
-    int_type pbackfail(int_type ch) override
-    {
-        if (_cur == _beg || (ch != traits_type::eof() && ch != _buffer[_cur - 1])) {
-            return traits_type::eof();
-        }
-
-        return static_cast<DataStreambuf::int_type>(_buffer[--_cur]) & 0x000000ff;
-    }
-    std::streamsize showmanyc() override
-    {
-        return _end - _cur;
-    }
-    pos_type seekoff(std::streambuf::off_type off,
-                     std::ios_base::seekdir way,
-                     std::ios_base::openmode mode = std::ios::in | std::ios::out) override
-    {
-        (void)mode;
-        int p_pos = -1;
-        if (way == std::ios_base::beg) {
-            p_pos = _beg;
-        }
-        else if (way == std::ios_base::end) {
-            p_pos = _end;
-        }
-        else if (way == std::ios_base::cur) {
-            p_pos = _cur;
-        }
-
-        if (p_pos > _end) {
-            return traits_type::eof();
-        }
-
-        if (((p_pos + off) > _end) || ((p_pos + off) < _beg)) {
-            return traits_type::eof();
-        }
-
-        _cur = p_pos + off;
-
-        return ((p_pos + off) - _beg);
-    }
-    pos_type seekpos(std::streambuf::pos_type pos,
-                     std::ios_base::openmode which = std::ios::in | std::ios::out) override
-    {
-        (void)which;
-        return seekoff(pos, std::ios_base::beg);
-    }
-
-public:
-    DataStreambuf(const DataStreambuf&) = delete;
-    DataStreambuf(DataStreambuf&&) = delete;
-    DataStreambuf& operator=(const DataStreambuf&) = delete;
-    DataStreambuf& operator=(DataStreambuf&&) = delete;
-
-private:
-    const std::vector<char>& _buffer;
-    int _beg {0}, _end {0}, _cur {0};
-};
-
 // NOLINTBEGIN
 // Taken from https://github.com/PointCloudLibrary/pcl/blob/master/io/src/lzf.cpp
 unsigned int
@@ -543,177 +649,437 @@ lzfDecompress(const void* const in_data, unsigned int in_len, void* out_data, un
 }  // namespace Points
 // NOLINTEND
 
-PlyReader::PlyReader() = default;
+namespace
+{
+enum class FieldType
+{
+    Int8,
+    UInt8,
+    Int16,
+    UInt16,
+    Int32,
+    UInt32,
+    Float32,
+    Float64
+};
 
-void PlyReader::read(const std::string& filename)
+FieldType getPlyFieldType(const std::string& type, int size)
 {
-    clear();
+    if (size == 1 && (type == "char" || type == "int8")) {
+        return FieldType::Int8;
+    }
+    if (size == 1 && (type == "uchar" || type == "uint8")) {
+        return FieldType::UInt8;
+    }
+    if (size == 2 && (type == "short" || type == "int16")) {
+        return FieldType::Int16;
+    }
+    if (size == 2 && (type == "ushort" || type == "uint16")) {
+        return FieldType::UInt16;
+    }
+    if (size == 4 && (type == "int" || type == "int32")) {
+        return FieldType::Int32;
+    }
+    if (size == 4 && (type == "uint" || type == "uint32")) {
+        return FieldType::UInt32;
+    }
+    if (size == 4 && (type == "float" || type == "float32")) {
+        return FieldType::Float32;
+    }
+    if (size == 8 && (type == "double" || type == "float64")) {
+        return FieldType::Float64;
+    }
+    throw Base::BadFormatError("Unexpected type");
+}
+
+FieldType getPcdFieldType(const std::string& type, int size)
+{
+    char t = type.empty() ? '\0' : type[0];
+    switch (size) {
+        case 1:
+            if (t == 'I') {
+                return FieldType::Int8;
+            }
+            if (t == 'U') {
+                return FieldType::UInt8;
+            }
+            break;
+        case 2:
+            if (t == 'I') {
+                return FieldType::Int16;
+            }
+            if (t == 'U') {
+                return FieldType::UInt16;
+            }
+            break;
+        case 4:
+            if (t == 'I') {
+                return FieldType::Int32;
+            }
+            if (t == 'U') {
+                return FieldType::UInt32;
+            }
+            if (t == 'F') {
+                return FieldType::Float32;
+            }
+            break;
+        case 8:
+            if (t == 'F') {
+                return FieldType::Float64;
+            }
+            break;
+        default:
+            break;
+    }
+    throw Base::BadFormatError("Unexpected type");
+}
 
-    Base::FileInfo fi(filename);
-    Base::ifstream inp(fi, std::ios::in | std::ios::binary);
+// swapping is needed if the byte order of the file differs from the one of the machine
+bool needsSwap(bool bigEndian)
+{
+    return bigEndian != (std::endian::native == std::endian::big);
+}
 
-    std::string format;
-    std::vector<std::string> fields;
-    std::vector<std::string> types;
-    std::vector<int> sizes;
-    std::size_t offset = 0;
-    Eigen::Index numPoints = Eigen::Index(readHeader(inp, format, offset, fields, types, sizes));
+template<typename T>
+T readNumber(const char* data, bool swapByteOrder)
+{
+    std::array<char, sizeof(T)> bytes {};
+    std::memcpy(bytes.data(), data, sizeof(T));
+    if (swapByteOrder) {
+        std::reverse(bytes.begin(), bytes.end());
+    }
+    T value {};
+    std::memcpy(&value, bytes.data(), sizeof(T));
+    return value;
+}
 
-    this->width = numPoints;
-    this->height = 1;
+double readNumber(const char* data, FieldType type, bool swapByteOrder)
+{
+    switch (type) {
+        case FieldType::Int8:
+            return readNumber<int8_t>(data, swapByteOrder);
+        case FieldType::UInt8:
+            return readNumber<uint8_t>(data, swapByteOrder);
+        case FieldType::Int16:
+            return readNumber<int16_t>(data, swapByteOrder);
+        case FieldType::UInt16:
+            return readNumber<uint16_t>(data, swapByteOrder);
+        case FieldType::Int32:
+            return readNumber<int32_t>(data, swapByteOrder);
+        case FieldType::UInt32:
+            return readNumber<uint32_t>(data, swapByteOrder);
+        case FieldType::Float32:
+            return readNumber<float>(data, swapByteOrder);
+        case FieldType::Float64:
+            return readNumber<double>(data, swapByteOrder);
+    }
+    return 0.0;
+}
 
-    Eigen::MatrixXd data(numPoints, fields.size());
-    if (format == "ascii") {
-        readAscii(inp, offset, data);
-    }
-    else if (format == "binary_little_endian") {
-        readBinary(false, inp, offset, types, sizes, data);
-    }
-    else if (format == "binary_big_endian") {
-        readBinary(true, inp, offset, types, sizes, data);
+// A field of the records of a binary file
+struct BinaryField
+{
+    FieldType type;
+    // position of the field of the first record
+    std::size_t offset;
+    // distance between the fields of two consecutive records
+    std::size_t stride;
+};
+
+int findField(const std::vector<std::string>& fields, std::initializer_list<const char*> names)
+{
+    for (const char* name : names) {
+        auto it = std::ranges::find(fields, name);
+        if (it != fields.end()) {
+            return int(std::distance(fields.begin(), it));
+        }
     }
+    return -1;
+}
 
-    std::vector<std::string>::iterator it;
-    Eigen::Index max_size = std::numeric_limits<Eigen::Index>::max();
+enum class ColorType
+{
+    None,
+    // red, green, blue and alpha in the range [0, 255]
+    Byte,
+    // red, green, blue and alpha in the range [0, 1]
+    Float,
+    // packed ARGB as integer
+    Packed,
+    // packed ARGB in the bits of a float
+    PackedFloat
+};
 
-    // x field
-    Eigen::Index x = max_size;
-    it = std::ranges::find(fields, "x");
-    if (it != fields.end()) {
-        x = std::distance(fields.begin(), it);
-    }
+// The fields of a record that are stored, -1 for missing ones
+struct Channels
+{
+    explicit Channels(const std::vector<std::string>& fields)
+        : numFields(fields.size())
+        , x(findField(fields, {"x"}))
+        , y(findField(fields, {"y"}))
+        , z(findField(fields, {"z"}))
+        , nx(findField(fields, {"normal_x", "nx"}))
+        , ny(findField(fields, {"normal_y", "ny"}))
+        , nz(findField(fields, {"normal_z", "nz"}))
+        , intensity(findField(fields, {"intensity"}))
+    {}
 
-    // y field
-    Eigen::Index y = max_size;
-    it = std::ranges::find(fields, "y");
-    if (it != fields.end()) {
-        y = std::distance(fields.begin(), it);
-    }
+    std::size_t numFields;
+    int x, y, z;
+    int nx, ny, nz;
+    int intensity;
+    int red {-1}, green {-1}, blue {-1}, alpha {-1};
+    ColorType color {ColorType::None};
+};
 
-    // z field
-    Eigen::Index z = max_size;
-    it = std::ranges::find(fields, "z");
-    if (it != fields.end()) {
-        z = std::distance(fields.begin(), it);
-    }
+// Stores decoded records directly in the containers of the reader. The containers are sized
+// in advance so that the records can be written from several threads.
+class RecordWriter
+{
+public:
+    RecordWriter(const Channels& channels,
+                 std::size_t count,
+                 PointKernel& kernel,
+                 std::vector<Base::Vector3f>& normals,
+                 std::vector<float>& intensity,
+                 std::vector<Base::Color>& colors)
+        : ch(channels)
+    {
+        if (ch.x < 0 || ch.y < 0 || ch.z < 0) {
+            return;
+        }
 
-    // normal x field
-    Eigen::Index normal_x = max_size;
-    it = std::ranges::find(fields, "normal_x");
-    if (it == fields.end()) {
-        it = std::ranges::find(fields, "nx");
+        kernel.resize(count);
+        points = kernel.getBasicPoints().data();
+        if (ch.nx >= 0 && ch.ny >= 0 && ch.nz >= 0) {
+            normals.resize(count);
+            this->normals = normals.data();
+        }
+        if (ch.intensity >= 0) {
+            intensity.resize(count);
+            this->intensity = intensity.data();
+        }
+        if (ch.color != ColorType::None) {
+            colors.resize(count);
+            this->colors = colors.data();
+        }
     }
-    if (it != fields.end()) {
-        normal_x = std::distance(fields.begin(), it);
+
+    bool hasPoints() const
+    {
+        return points != nullptr;
     }
 
-    // normal y field
-    Eigen::Index normal_y = max_size;
-    it = std::ranges::find(fields, "normal_y");
-    if (it == fields.end()) {
-        it = std::ranges::find(fields, "ny");
+    void write(std::size_t row, const double* values) const
+    {
+        points[row].Set(static_cast<float>(values[ch.x]),
+                        static_cast<float>(values[ch.y]),
+                        static_cast<float>(values[ch.z]));
+        if (normals) {
+            normals[row].Set(static_cast<float>(values[ch.nx]),
+                             static_cast<float>(values[ch.ny]),
+                             static_cast<float>(values[ch.nz]));
+        }
+        if (intensity) {
+            intensity[row] = static_cast<float>(values[ch.intensity]);
+        }
+        if (colors) {
+            colors[row] = getColor(values);
+        }
     }
-    if (it != fields.end()) {
-        normal_y = std::distance(fields.begin(), it);
+
+private:
+    Base::Color getColor(const double* values) const
+    {
+        switch (ch.color) {
+            case ColorType::Byte: {
+                float a = ch.alpha >= 0 ? static_cast<float>(values[ch.alpha]) : 255.0F;
+                return Base::Color(static_cast<float>(values[ch.red]) / 255.0F,
+                                   static_cast<float>(values[ch.green]) / 255.0F,
+                                   static_cast<float>(values[ch.blue]) / 255.0F,
+                                   a / 255.0F);
+            }
+            case ColorType::Float: {
+                float a = ch.alpha >= 0 ? static_cast<float>(values[ch.alpha]) : 1.0F;
+                return Base::Color(static_cast<float>(values[ch.red]),
+                                   static_cast<float>(values[ch.green]),
+                                   static_cast<float>(values[ch.blue]),
+                                   a);
+            }
+            case ColorType::Packed: {
+                Base::Color col;
+                col.setPackedARGB(static_cast<uint32_t>(values[ch.red]));
+                return col;
+            }
+            case ColorType::PackedFloat: {
+                static_assert(sizeof(float) == sizeof(uint32_t),
+                              "float and uint32_t have different sizes");
+                float f = static_cast<float>(values[ch.red]);
+                uint32_t packed {};
+                std::memcpy(&packed, &f, sizeof(packed));
+                Base::Color col;
+                col.setPackedARGB(packed);
+                return col;
+            }
+            case ColorType::None:
+                break;
+        }
+        return Base::Color();
     }
 
-    // normal z field
-    Eigen::Index normal_z = max_size;
-    it = std::ranges::find(fields, "normal_z");
-    if (it == fields.end()) {
-        it = std::ranges::find(fields, "nz");
+private:
+    const Channels& ch;
+    Base::Vector3f* points {nullptr};
+    Base::Vector3f* normals {nullptr};
+    float* intensity {nullptr};
+    Base::Color* colors {nullptr};
+};
+
+// Reads one record per non-empty line after skipping the first lines, in parallel chunks
+void readAsciiRecords(const char* begin,
+                      const char* end,
+                      std::size_t skip,
+                      std::size_t numRecords,
+                      const Channels& channels,
+                      const RecordWriter& writer)
+{
+    std::vector<TextChunk> chunks = splitLines(begin, end);
+    QtConcurrent::blockingMap(chunks, [](TextChunk& chunk) {
+        forEachLine(chunk.begin, chunk.end, [&chunk](const char* line, const char* eol) {
+            if (!isBlank(line, eol)) {
+                chunk.count++;
+            }
+        });
+    });
+
+    std::size_t numLines = 0;
+    for (TextChunk& chunk : chunks) {
+        chunk.first = numLines;
+        numLines += chunk.count;
     }
-    if (it != fields.end()) {
-        normal_z = std::distance(fields.begin(), it);
+    if (numLines < skip + numRecords) {
+        throw Base::BadFormatError("File expects too many elements");
     }
 
-    // intensity field
-    Eigen::Index greyvalue = max_size;
-    it = std::ranges::find(fields, "intensity");
-    if (it != fields.end()) {
-        greyvalue = std::distance(fields.begin(), it);
-    }
+    QtConcurrent::blockingMap(chunks, [&](TextChunk& chunk) {
+        if (chunk.first + chunk.count <= skip || chunk.first >= skip + numRecords) {
+            return;
+        }
 
-    // rgb(a) field
-    Eigen::Index red = max_size;
-    Eigen::Index green = max_size;
-    Eigen::Index blue = max_size;
-    Eigen::Index alpha = max_size;
-    it = std::ranges::find(fields, "red");
-    if (it != fields.end()) {
-        red = std::distance(fields.begin(), it);
-    }
+        std::string buffer;
+        std::vector<double> values(channels.numFields);
+        std::size_t index = chunk.first;
+        forEachLine(chunk.begin, chunk.end, [&](const char* line, const char* eol) {
+            if (isBlank(line, eol)) {
+                return;
+            }
+            if (index >= skip && index < skip + numRecords) {
+                std::fill(values.begin(), values.end(), 0.0);
+                if (parseNumbers(line, eol, false, buffer, values.data(), int(values.size()))
+                    < 0) {
+                    chunk.failed = true;
+                }
+                else {
+                    writer.write(index - skip, values.data());
+                }
+            }
+            index++;
+        });
+    });
 
-    it = std::ranges::find(fields, "green");
-    if (it != fields.end()) {
-        green = std::distance(fields.begin(), it);
+    if (std::ranges::any_of(chunks, [](const TextChunk& chunk) {
+            return chunk.failed;
+        })) {
+        throw Base::BadFormatError("Invalid number in ASCII data");
     }
+}
 
-    it = std::ranges::find(fields, "blue");
-    if (it != fields.end()) {
-        blue = std::distance(fields.begin(), it);
-    }
+// Decodes the records of a binary block in parallel
+void readBinaryRecords(const char* data,
+                       std::size_t numRecords,
+                       const std::vector<BinaryField>& fields,
+                       bool swapByteOrder,
+                       const RecordWriter& writer)
+{
+    parallelRanges(numRecords, [&](std::size_t begin, std::size_t end) {
+        std::vector<double> values(fields.size());
+        for (std::size_t row = begin; row < end; row++) {
+            for (std::size_t col = 0; col < fields.size(); col++) {
+                const BinaryField& field = fields[col];
+                values[col] =
+                    readNumber(data + field.offset + row * field.stride, field.type, swapByteOrder);
+            }
+            writer.write(row, values.data());
+        }
+    });
+}
+}  // namespace
 
-    it = std::ranges::find(fields, "alpha");
-    if (it != fields.end()) {
-        alpha = std::distance(fields.begin(), it);
-    }
+PlyReader::PlyReader() = default;
 
-    // transfer the data
-    bool hasData = (x != max_size && y != max_size && z != max_size);
-    bool hasNormal = (normal_x != max_size && normal_y != max_size && normal_z != max_size);
-    bool hasIntensity = (greyvalue != max_size);
-    bool hasColor = (red != max_size && green != max_size && blue != max_size);
+void PlyReader::read(const std::string& filename)
+{
+    clear();
 
-    if (hasData) {
-        points.reserve(numPoints);
-        for (Eigen::Index i = 0; i < numPoints; i++) {
-            points.push_back(Base::Vector3d(data(i, x), data(i, y), data(i, z)));
-        }
+    std::string format;
+    std::vector<std::string> fields;
+    std::vector<std::string> types;
+    std::vector<int> sizes;
+    std::size_t offset = 0;
+    std::size_t numPoints = 0;
+    std::streamoff start = 0;
+    {
+        Base::FileInfo fi(filename);
+        Base::ifstream inp(fi, std::ios::in | std::ios::binary);
+        numPoints = readHeader(inp, format, offset, fields, types, sizes);
+        start = inp.tellg();
     }
 
-    if (hasData && hasNormal) {
-        normals.reserve(numPoints);
-        for (Eigen::Index i = 0; i < numPoints; i++) {
-            normals.emplace_back(data(i, normal_x), data(i, normal_y), data(i, normal_z));
+    this->width = int(numPoints);
+    this->height = 1;
+
+    Channels channels(fields);
+    channels.red = findField(fields, {"red"});
+    channels.green = findField(fields, {"green"});
+    channels.blue = findField(fields, {"blue"});
+    channels.alpha = findField(fields, {"alpha"});
+    if (channels.red >= 0 && channels.green >= 0 && channels.blue >= 0) {
+        const std::string& type = types[channels.red];
+        if (type == "uchar" || type == "uint8") {
+            channels.color = ColorType::Byte;
+        }
+        else if (type == "float" || type == "float32") {
+            channels.color = ColorType::Float;
         }
     }
 
-    if (hasData && hasIntensity) {
-        intensity.reserve(numPoints);
-        for (Eigen::Index i = 0; i < numPoints; i++) {
-            intensity.push_back(static_cast<float>(data(i, greyvalue)));
-        }
+    // the points and their properties are decoded directly into their final place
+    RecordWriter writer(channels, numPoints, points, normals, intensity, colors);
+    if (!writer.hasPoints()) {
+        return;
     }
 
-    if (hasData && hasColor) {
-        colors.reserve(numPoints);
-        float a = 1.0;
-        if (types[red] == "uchar") {
-            for (Eigen::Index i = 0; i < numPoints; i++) {
-                float r = static_cast<float>(data(i, red));
-                float g = static_cast<float>(data(i, green));
-                float b = static_cast<float>(data(i, blue));
-                if (alpha != max_size) {
-                    a = static_cast<float>(data(i, alpha));
-                }
-                colors.emplace_back(static_cast<float>(r) / 255.0F,
-                                    static_cast<float>(g) / 255.0F,
-                                    static_cast<float>(b) / 255.0F,
-                                    static_cast<float>(a) / 255.0F);
-            }
+    MappedFile file(filename);
+    const char* data = file.at(start);
+    if (format == "ascii") {
+        readAsciiRecords(data, file.end(), offset, numPoints, channels, writer);
+    }
+    else {
+        std::vector<BinaryField> binary;
+        std::size_t recordSize = 0;
+        for (std::size_t i = 0; i < fields.size(); i++) {
+            binary.push_back({getPlyFieldType(types[i], sizes[i]), offset + recordSize, 0});
+            recordSize += std::size_t(sizes[i]);
         }
-        else if (types[red] == "float") {
-            for (Eigen::Index i = 0; i < numPoints; i++) {
-                float r = static_cast<float>(data(i, red));
-                float g = static_cast<float>(data(i, green));
-                float b = static_cast<float>(data(i, blue));
-                if (alpha != max_size) {
-                    a = static_cast<float>(data(i, alpha));
-                }
-                colors.emplace_back(r, g, b, a);
-            }
+        for (BinaryField& field : binary) {
+            field.stride = recordSize;
+        }
+
+        if (std::size_t(file.end() - data) < offset + recordSize * numPoints) {
+            throw Base::BadFormatError("File expects too many elements");
         }
+        bool swapByteOrder = needsSwap(format == "binary_big_endian");
+        readBinaryRecords(data, numPoints, binary, swapByteOrder, writer);
     }
 }
 
@@ -887,136 +1253,6 @@ std::size_t PlyReader::readHeader(std::istream& in,
     return numPoints;
 }
 
-void PlyReader::readAscii(std::istream& inp, std::size_t offset, Eigen::MatrixXd& data)
-{
-    std::string line;
-    Eigen::Index row = 0;
-    Eigen::Index numPoints = Eigen::Index(data.rows());
-    Eigen::Index numFields = Eigen::Index(data.cols());
-    std::vector<std::string> list;
-    while (std::getline(inp, line) && row < numPoints) {
-        if (line.empty()) {
-            continue;
-        }
-
-        if (offset > 0) {
-            offset--;
-            continue;
-        }
-
-        // since the file is loaded in binary mode we may get the CR at the end
-        boost::trim(line);
-        boost::split(list, line, boost::is_any_of("\t\r "), boost::token_compress_on);
-
-        std::istringstream str(line);
-
-        Eigen::Index size = Eigen::Index(list.size());
-        for (Eigen::Index col = 0; col < size && col < numFields; col++) {
-            double value = boost::lexical_cast<double>(list[col]);
-            data(row, col) = value;
-        }
-
-        ++row;
-    }
-}
-
-void PlyReader::readBinary(bool swapByteOrder,
-                           std::istream& inp,
-                           std::size_t offset,
-                           const std::vector<std::string>& types,
-                           const std::vector<int>& sizes,
-                           Eigen::MatrixXd& data)
-{
-    Eigen::Index numPoints = data.rows();
-    Eigen::Index numFields = data.cols();
-
-    int neededSize = 0;
-    ConverterPtr convert_float32(new ConverterT<float>);
-    ConverterPtr convert_float64(new ConverterT<double>);
-    ConverterPtr convert_int8(new ConverterT<int8_t>);
-    ConverterPtr convert_uint8(new ConverterT<uint8_t>);
-    ConverterPtr convert_int16(new ConverterT<int16_t>);
-    ConverterPtr convert_uint16(new ConverterT<uint16_t>);
-    ConverterPtr convert_int32(new ConverterT<int32_t>);
-    ConverterPtr convert_uint32(new ConverterT<uint32_t>);
-
-    std::vector<ConverterPtr> converters;
-    for (Eigen::Index j = 0; j < numFields; j++) {
-        const std::string& t = types[j];
-        switch (sizes[j]) {
-            case 1:
-                if (t == "char" || t == "int8") {
-                    converters.push_back(convert_int8);
-                }
-                else if (t == "uchar" || t == "uint8") {
-                    converters.push_back(convert_uint8);
-                }
-                else {
-                    throw Base::BadFormatError("Unexpected type");
-                }
-                break;
-            case 2:
-                if (t == "short" || t == "int16") {
-                    converters.push_back(convert_int16);
-                }
-                else if (t == "ushort" || t == "uint16") {
-                    converters.push_back(convert_uint16);
-                }
-                else {
-                    throw Base::BadFormatError("Unexpected type");
-                }
-                break;
-            case 4:
-                if (t == "int" || t == "int32") {
-                    converters.push_back(convert_int32);
-                }
-                else if (t == "uint" || t == "uint32") {
-                    converters.push_back(convert_uint32);
-                }
-                else if (t == "float" || t == "float32") {
-                    converters.push_back(convert_float32);
-                }
-                else {
-                    throw Base::BadFormatError("Unexpected type");
-                }
-                break;
-            case 8:
-                if (t == "double" || t == "float64") {
-                    converters.push_back(convert_float64);
-                }
-                else {
-                    throw Base::BadFormatError("Unexpected type");
-                }
-                break;
-            default:
-                throw Base::BadFormatError("Unexpected type");
-        }
-
-        neededSize += converters.back()->getSizeOf();
-    }
-
-    std::streamoff ulSize = 0;
-    std::streamoff ulCurr = 0;
-    std::streambuf* buf = inp.rdbuf();
-    if (buf) {
-        ulCurr = buf->pubseekoff(static_cast<std::streamoff>(offset), std::ios::cur, std::ios::in);
-        ulSize = buf->pubseekoff(0, std::ios::end, std::ios::in);
-        buf->pubseekoff(ulCurr, std::ios::beg, std::ios::in);
-        if (ulCurr + neededSize * static_cast<std::streamoff>(numPoints) > ulSize) {
-            throw Base::BadFormatError("File expects too many elements");
-        }
-    }
-
-    Base::InputStream str(inp);
-    str.setByteOrder(swapByteOrder ? Base::Stream::BigEndian : Base::Stream::LittleEndian);
-    for (Eigen::Index i = 0; i < numPoints; i++) {
-        for (Eigen::Index j = 0; j < numFields; j++) {
-            double value = converters[j]->toDouble(str);
-            data(i, j) = value;
-        }
-    }
-}
-
 // ----------------------------------------------------------------------------
 
 PcdReader::PcdReader() = default;
@@ -1027,162 +1263,90 @@ void PcdReader::read(const std::string& filename)
     this->width = 0;
     this->height = 1;
 
-    Base::FileInfo fi(filename);
-    Base::ifstream inp(fi, std::ios::in | std::ios::binary);
-
     std::string format;
     std::vector<std::string> fields;
     std::vector<std::string> types;
     std::vector<int> sizes;
-    Eigen::Index numPoints = Eigen::Index(readHeader(inp, format, fields, types, sizes));
-
-    Eigen::MatrixXd data(numPoints, fields.size());
-    if (format == "ascii") {
-        readAscii(inp, data);
-    }
-    else if (format == "binary") {
-        readBinary(false, inp, types, sizes, data);
+    std::size_t numPoints = 0;
+    std::streamoff start = 0;
+    {
+        Base::FileInfo fi(filename);
+        Base::ifstream inp(fi, std::ios::in | std::ios::binary);
+        numPoints = readHeader(inp, format, fields, types, sizes);
+        start = inp.tellg();
     }
-    else if (format == "binary_compressed") {
-        unsigned int c {};
-        unsigned int u {};
-        Base::InputStream str(inp);
-        str >> c >> u;
 
-        std::vector<char> compressed(c);
-        inp.read(compressed.data(), c);
-        std::vector<char> uncompressed(u);
-        if (lzfDecompress(compressed.data(), c, uncompressed.data(), u) == u) {
-            DataStreambuf ibuf(uncompressed);
-            std::istream istr(nullptr);
-            istr.rdbuf(&ibuf);
-            readBinary(true, istr, types, sizes, data);
+    Channels channels(fields);
+    channels.red = findField(fields, {"rgb", "rgba"});
+    if (channels.red >= 0) {
+        if (types[channels.red] == "U") {
+            channels.color = ColorType::Packed;
         }
-        else {
-            throw Base::BadFormatError("Failed to decompress binary data");
+        else if (types[channels.red] == "F") {
+            channels.color = ColorType::PackedFloat;
         }
     }
 
-    std::vector<std::string>::iterator it;
-    Eigen::Index max_size = std::numeric_limits<Eigen::Index>::max();
-
-    // x field
-    Eigen::Index x = max_size;
-    it = std::ranges::find(fields, "x");
-    if (it != fields.end()) {
-        x = std::distance(fields.begin(), it);
-    }
-
-    // y field
-    Eigen::Index y = max_size;
-    it = std::ranges::find(fields, "y");
-    if (it != fields.end()) {
-        y = std::distance(fields.begin(), it);
+    // the points and their properties are decoded directly into their final place
+    RecordWriter writer(channels, numPoints, points, normals, intensity, colors);
+    if (!writer.hasPoints()) {
+        return;
     }
 
-    // z field
-    Eigen::Index z = max_size;
-    it = std::ranges::find(fields, "z");
-    if (it != fields.end()) {
-        z = std::distance(fields.begin(), it);
-    }
-
-    // normal x field
-    Eigen::Index normal_x = max_size;
-    it = std::ranges::find(fields, "normal_x");
-    if (it == fields.end()) {
-        it = std::ranges::find(fields, "nx");
-    }
-    if (it != fields.end()) {
-        normal_x = std::distance(fields.begin(), it);
-    }
-
-    // normal y field
-    Eigen::Index normal_y = max_size;
-    it = std::ranges::find(fields, "normal_y");
-    if (it == fields.end()) {
-        it = std::ranges::find(fields, "ny");
-    }
-    if (it != fields.end()) {
-        normal_y = std::distance(fields.begin(), it);
-    }
-
-    // normal z field
-    Eigen::Index normal_z = max_size;
-    it = std::ranges::find(fields, "normal_z");
-    if (it == fields.end()) {
-        it = std::ranges::find(fields, "nz");
-    }
-    if (it != fields.end()) {
-        normal_z = std::distance(fields.begin(), it);
-    }
+    MappedFile file(filename);
+    const char* data = file.at(start);
+    std::size_t available = std::size_t(file.end() - data);
 
-    // intensity field
-    Eigen::Index greyvalue = max_size;
-    it = std::ranges::find(fields, "intensity");
-    if (it != fields.end()) {
-        greyvalue = std::distance(fields.begin(), it);
+    std::size_t recordSize = 0;
+    for (int fieldSize : sizes) {
+        recordSize += std::size_t(fieldSize);
     }
 
-    // rgb(a) field
-    Eigen::Index rgba = max_size;
-    it = std::ranges::find(fields, "rgb");
-    if (it == fields.end()) {
-        it = std::ranges::find(fields, "rgba");
-    }
-    if (it != fields.end()) {
-        rgba = std::distance(fields.begin(), it);
+    if (format == "ascii") {
+        readAsciiRecords(data, file.end(), 0, numPoints, channels, writer);
     }
-
-    // transfer the data
-    bool hasData = (x != max_size && y != max_size && z != max_size);
-    bool hasNormal = (normal_x != max_size && normal_y != max_size && normal_z != max_size);
-    bool hasIntensity = (greyvalue != max_size);
-    bool hasColor = (rgba != max_size);
-
-    if (hasData) {
-        points.reserve(numPoints);
-        for (Eigen::Index i = 0; i < numPoints; i++) {
-            points.push_back(Base::Vector3d(data(i, x), data(i, y), data(i, z)));
+    else if (format == "binary") {
+        // the fields of a point are stored together
+        std::vector<BinaryField> binary;
+        std::size_t offset = 0;
+        for (std::size_t i = 0; i < fields.size(); i++) {
+            binary.push_back({getPcdFieldType(types[i], sizes[i]), offset, recordSize});
+            offset += std::size_t(sizes[i]);
         }
-    }
 
-    if (hasData && hasNormal) {
-        normals.reserve(numPoints);
-        for (Eigen::Index i = 0; i < numPoints; i++) {
-            normals.emplace_back(data(i, normal_x), data(i, normal_y), data(i, normal_z));
+        if (available < recordSize * numPoints) {
+            throw Base::BadFormatError("File expects too many elements");
         }
+        readBinaryRecords(data, numPoints, binary, needsSwap(false), writer);
     }
+    else if (format == "binary_compressed") {
+        if (available < 2 * sizeof(uint32_t)) {
+            throw Base::BadFormatError("Failed to decompress binary data");
+        }
+        uint32_t c = readNumber<uint32_t>(data, needsSwap(false));
+        uint32_t u = readNumber<uint32_t>(data + sizeof(uint32_t), needsSwap(false));
+        if (available - 2 * sizeof(uint32_t) < c) {
+            throw Base::BadFormatError("Failed to decompress binary data");
+        }
 
-    if (hasData && hasIntensity) {
-        intensity.reserve(numPoints);
-        for (Eigen::Index i = 0; i < numPoints; i++) {
-            intensity.push_back(data(i, greyvalue));
+        std::vector<char> uncompressed(u);
+        if (lzfDecompress(data + 2 * sizeof(uint32_t), c, uncompressed.data(), u) != u) {
+            throw Base::BadFormatError("Failed to decompress binary data");
         }
-    }
 
-    if (hasData && hasColor) {
-        colors.reserve(numPoints);
-        if (types[rgba] == "U") {
-            for (Eigen::Index i = 0; i < numPoints; i++) {
-                uint32_t packed = static_cast<uint32_t>(data(i, rgba));
-                Base::Color col;
-                col.setPackedARGB(packed);
-                colors.emplace_back(col);
-            }
+        // each field is stored for all points before the next field
+        std::vector<BinaryField> binary;
+        std::size_t offset = 0;
+        for (std::size_t i = 0; i < fields.size(); i++) {
+            std::size_t fieldSize = std::size_t(sizes[i]);
+            binary.push_back({getPcdFieldType(types[i], sizes[i]), offset, fieldSize});
+            offset += fieldSize * numPoints;
         }
-        else if (types[rgba] == "F") {
-            static_assert(sizeof(float) == sizeof(uint32_t),
-                          "float and uint32_t have different sizes");
-            for (Eigen::Index i = 0; i < numPoints; i++) {
-                float f = static_cast<float>(data(i, rgba));
-                uint32_t packed {};
-                std::memcpy(&packed, &f, sizeof(packed));
-                Base::Color col;
-                col.setPackedARGB(packed);
-                colors.emplace_back(col);
-            }
+
+        if (uncompressed.size() < recordSize * numPoints) {
+            throw Base::BadFormatError("File expects too many elements");
         }
+        readBinaryRecords(uncompressed.data(), numPoints, binary, needsSwap(false), writer);
     }
 }
 
@@ -1257,139 +1421,6 @@ std::size_t PcdReader::readHeader(std::istream& in,
     return points;
 }
 
-void PcdReader::readAscii(std::istream& inp, Eigen::MatrixXd& data)
-{
-    std::string line;
-    Eigen::Index row = 0;
-    Eigen::Index numPoints = data.rows();
-    Eigen::Index numFields = data.cols();
-    std::vector<std::string> list;
-    while (std::getline(inp, line) && row < numPoints) {
-        if (line.empty()) {
-            continue;
-        }
-
-        // since the file is loaded in binary mode we may get the CR at the end
-        boost::trim(line);
-        boost::split(list, line, boost::is_any_of("\t\r "), boost::token_compress_on);
-
-        std::istringstream str(line);
-
-        Eigen::Index size = Eigen::Index(list.size());
-        for (Eigen::Index col = 0; col < size && col < numFields; col++) {
-            double value = boost::lexical_cast<double>(list[col]);
-            data(row, col) = value;
-        }
-
-        ++row;
-    }
-}
-
-void PcdReader::readBinary(bool transpose,
-                           std::istream& inp,
-                           const std::vector<std::string>& types,
-                           const std::vector<int>& sizes,
-                           Eigen::MatrixXd& data)
-{
-    Eigen::Index numPoints = data.rows();
-    Eigen::Index numFields = data.cols();
-
-    int neededSize = 0;
-    ConverterPtr convert_float32(new ConverterT<float>);
-    ConverterPtr convert_float64(new ConverterT<double>);
-    ConverterPtr convert_int8(new ConverterT<int8_t>);
-    ConverterPtr convert_uint8(new ConverterT<uint8_t>);
-    ConverterPtr convert_int16(new ConverterT<int16_t>);
-    ConverterPtr convert_uint16(new ConverterT<uint16_t>);
-    ConverterPtr convert_int32(new ConverterT<int32_t>);
-    ConverterPtr convert_uint32(new ConverterT<uint32_t>);
-
-    std::vector<ConverterPtr> converters;
-    for (Eigen::Index j = 0; j < numFields; j++) {
-        char t = types[j][0];
-        switch (sizes[j]) {
-            case 1:
-                if (t == 'I') {
-                    converters.push_back(convert_int8);
-                }
-                else if (t == 'U') {
-                    converters.push_back(convert_uint8);
-                }
-                else {
-                    throw Base::BadFormatError("Unexpected type");
-                }
-                break;
-            case 2:
-                if (t == 'I') {
-                    converters.push_back(convert_int16);
-                }
-                else if (t == 'U') {
-                    converters.push_back(convert_uint16);
-                }
-                else {
-                    throw Base::BadFormatError("Unexpected type");
-                }
-                break;
-            case 4:
-                if (t == 'I') {
-                    converters.push_back(convert_int32);
-                }
-                else if (t == 'U') {
-                    converters.push_back(convert_uint32);
-                }
-                else if (t == 'F') {
-                    converters.push_back(convert_float32);
-                }
-                else {
-                    throw Base::BadFormatError("Unexpected type");
-                }
-                break;
-            case 8:
-                if (t == 'F') {
-                    converters.push_back(convert_float64);
-                }
-                else {
-                    throw Base::BadFormatError("Unexpected type");
-                }
-                break;
-            default:
-                throw Base::BadFormatError("Unexpected type");
-        }
-
-        neededSize += converters.back()->getSizeOf();
-    }
-
-    std::streamoff ulSize = 0;
-    std::streamoff ulCurr = 0;
-    std::streambuf* buf = inp.rdbuf();
-    if (buf) {
-        ulCurr = buf->pubseekoff(0, std::ios::cur, std::ios::in);
-        ulSize = buf->pubseekoff(0, std::ios::end, std::ios::in);
-        buf->pubseekoff(ulCurr, std::ios::beg, std::ios::in);
-        if (ulCurr + neededSize * static_cast<std::streamoff>(numPoints) > ulSize) {
-            throw Base::BadFormatError("File expects too many elements");
-        }
-    }
-
-    Base::InputStream str(inp);
-    if (transpose) {
-        for (Eigen::Index j = 0; j < numFields; j++) {
-            for (Eigen::Index i = 0; i < numPoints; i++) {
-                double value = converters[j]->toDouble(str);
-                data(i, j) = value;
-            }
-        }
-    }
-    else {
-        for (Eigen::Index i = 0; i < numPoints; i++) {
-            for (Eigen::Index j = 0; j < numFields; j++) {
-                double value = converters[j]->toDouble(str);
-                data(i, j) = value;
-            }
-        }
-    }
-}
-
 // ----------------------------------------------------------------------------
 
 namespace
@@ -1398,339 +1429,238 @@ class E57ReaderImp
 {
 public:
     E57ReaderImp(const std::string& filename, bool color, bool state, double distance)
-        : imfi(filename, "r")
+        : filename {filename}
         , useColor {color}
         , checkState {state}
         , minDistance {distance}
     {}
 
-    void read()
-    {
-        e57::StructureNode root = imfi.root();
-        if (root.isDefined("data3D")) {
-            e57::VectorNode data3D(root.get("data3D"));
-            readData3D(data3D);
-        }
-    }
-
-    std::vector<Base::Color> getColors() const
-    {
-        return colors;
-    }
-
-    std::vector<float> getItensity() const
-    {
-        return intensity;
-    }
-
-    const PointKernel& getPoints() const
-    {
-        return points;
-    }
-
-    const std::vector<Base::Vector3f>& getNormals() const
+    void read(PointKernel& points,
+              std::vector<Base::Color>& colors,
+              std::vector<float>& intensity,
+              std::vector<Base::Vector3f>& normals)
     {
-        return normals;
-    }
-
-private:
-    void readData3D(const e57::VectorNode& data3D)
-    {
-        for (int child = 0; child < data3D.childCount(); ++child) {
-            e57::StructureNode scan_data(data3D.get(child));
-            Base::Placement plm;
-            bool hasPlacement = getPlacement(scan_data, plm);
-
-            e57::CompressedVectorNode cvn(scan_data.get("points"));
-            e57::StructureNode prototype(cvn.prototype());
-            Proto proto = readProto(prototype);
-            processProto(cvn, proto, hasPlacement, plm);
-        }
-    }
-
-    struct Proto
-    {
-        bool inty = false;
-        bool inv_state = false;
-        unsigned cnt_xyz = 0;
-        unsigned cnt_nor = 0;
-        unsigned cnt_rgb = 0;
-
-        std::vector<double> xData;
-        std::vector<double> yData;
-        std::vector<double> zData;
-
-        std::vector<double> xNormal;
-        std::vector<double> yNormal;
-        std::vector<double> zNormal;
-
-        std::vector<unsigned> redData;
-        std::vector<unsigned> greenData;
-        std::vector<unsigned> blueData;
-
-        std::vector<double> intensity;
-        std::vector<int64_t> state;
-        std::vector<int64_t> nil;
-
-        std::vector<e57::SourceDestBuffer> sdb;
-    };
+        std::vector<Scan> scans = readScans();
+
+        // reserve the space for all points so that each scan can write to its own range
+        std::size_t total = 0;
+        bool hasColor = false;
+        bool hasIntensity = false;
+        bool hasNormal = false;
+        for (Scan& scan : scans) {
+            scan.offset = total;
+            total += scan.count;
+            hasColor = hasColor || scan.hasColor;
+            hasIntensity = hasIntensity || scan.hasIntensity;
+            hasNormal = hasNormal || scan.hasNormal;
+        }
+
+        points.resize(total);
+        colors.resize(hasColor ? total : 0);
+        intensity.resize(hasIntensity ? total : 0);
+        normals.resize(hasNormal ? total : 0);
+
+        Output out;
+        out.points = points.getBasicPoints().data();
+        out.colors = hasColor ? colors.data() : nullptr;
+        out.intensity = hasIntensity ? intensity.data() : nullptr;
+        out.normals = hasNormal ? normals.data() : nullptr;
+
+        // the scans are decoded in parallel, each with its own handle of the file
+        QtConcurrent::blockingMap(scans, [this, &out](Scan& scan) {
+            try {
+                readScan(scan, out);
+            }
+            catch (...) {
+                scan.failed = true;
+            }
+        });
+        if (std::ranges::any_of(scans, [](const Scan& scan) {
+                return scan.failed;
+            })) {
+            throw Base::BadFormatError("Reading E57 file failed");
+        }
+
+        // skip points too close to their predecessor and close the gaps of the skipped ones
+        std::size_t numPoints = 0;
+        Base::Vector3d last;
+        for (const Scan& scan : scans) {
+            for (std::size_t index = scan.offset; index < scan.offset + scan.numRead; index++) {
+                Base::Vector3d pt = Base::convertTo<Base::Vector3d>(out.points[index]);
+                if (numPoints > 0 && Base::Distance(last, pt) < minDistance) {
+                    continue;
+                }
 
-    Proto readProto(const e57::StructureNode& prototype)
-    {
-        Proto proto;
-        resizeArrays(proto);
-
-        for (int i = 0; i < prototype.childCount(); ++i) {
-            e57::Node node(prototype.get(i));
-            if ((node.type() == e57::E57_FLOAT) || (node.type() == e57::E57_SCALED_INTEGER)) {
-                if (readCartesian(node, proto)) {}
-                else if (readNormal(node, proto)) {}
-                else if (readItensity(node, proto)) {}
-                else {
-                    readOther(node, proto);
+                last = pt;
+                out.points[numPoints] = out.points[index];
+                if (out.colors) {
+                    out.colors[numPoints] = out.colors[index];
                 }
-            }
-            else if (node.type() == e57::E57_INTEGER) {
-                if (readColor(node, proto)) {}
-                else if (readCartesianInvalidState(node, proto)) {}
-                else {
-                    readOther(node, proto);
+                if (out.intensity) {
+                    out.intensity[numPoints] = out.intensity[index];
                 }
+                if (out.normals) {
+                    out.normals[numPoints] = out.normals[index];
+                }
+                numPoints++;
             }
         }
 
-        return proto;
-    }
-
-    bool readCartesian(const e57::Node& node, Proto& proto)
-    {
-        if (node.elementName() == "cartesianX") {
-            proto.cnt_xyz++;
-            proto.sdb
-                .emplace_back(imfi, node.elementName(), proto.xData.data(), buf_size, true, true
-
-                );
-            return true;
-        }
-        else if (node.elementName() == "cartesianY") {
-            proto.cnt_xyz++;
-            proto.sdb
-                .emplace_back(imfi, node.elementName(), proto.yData.data(), buf_size, true, true
-
-                );
-            return true;
-        }
-        else if (node.elementName() == "cartesianZ") {
-            proto.cnt_xyz++;
-            proto.sdb
-                .emplace_back(imfi, node.elementName(), proto.zData.data(), buf_size, true, true
-
-                );
-            return true;
-        }
-
-        return false;
+        points.resize(numPoints);
+        colors.resize(hasColor ? numPoints : 0);
+        intensity.resize(hasIntensity ? numPoints : 0);
+        normals.resize(hasNormal ? numPoints : 0);
     }
 
-    bool readNormal(const e57::Node& node, Proto& proto)
-    {
-        if (node.elementName() == "nor:normalX") {
-            proto.cnt_nor++;
-            proto.sdb
-                .emplace_back(imfi, node.elementName(), proto.xNormal.data(), buf_size, true, true
-
-                );
-            return true;
-        }
-        else if (node.elementName() == "nor:normalY") {
-            proto.cnt_nor++;
-            proto.sdb
-                .emplace_back(imfi, node.elementName(), proto.yNormal.data(), buf_size, true, true
-
-                );
-            return true;
-        }
-        else if (node.elementName() == "nor:normalZ") {
-            proto.cnt_nor++;
-            proto.sdb
-                .emplace_back(imfi, node.elementName(), proto.zNormal.data(), buf_size, true, true
-
-                );
-            return true;
-        }
-
-        return false;
-    }
-
-    bool readCartesianInvalidState(const e57::Node& node, Proto& proto)
+private:
+    struct Scan
     {
-        if (node.elementName() == "cartesianInvalidState") {
-            proto.inv_state = true;
-            proto.sdb
-                .emplace_back(imfi, node.elementName(), proto.state.data(), buf_size, true, true
-
-                );
-            return true;
-        }
-
-        return false;
-    }
+        int64_t index = 0;
+        bool hasPlacement = false;
+        Base::Placement placement;
+        bool hasColor = false;
+        bool hasIntensity = false;
+        bool hasNormal = false;
+        bool hasState = false;
+        // number of records of the scan
+        std::size_t count = 0;
+        // position of the first point in the output
+        std::size_t offset = 0;
+        // number of points that are not filtered out by their state
+        std::size_t numRead = 0;
+        bool failed = false;
+    };
 
-    bool readColor(const e57::Node& node, Proto& proto)
+    struct Output
     {
-        if (node.elementName() == "colorRed") {
-            proto.cnt_rgb++;
-            proto.sdb
-                .emplace_back(imfi, node.elementName(), proto.redData.data(), buf_size, true, true
-
-                );
-            return true;
-        }
-        if (node.elementName() == "colorGreen") {
-            proto.cnt_rgb++;
-            proto.sdb
-                .emplace_back(imfi, node.elementName(), proto.greenData.data(), buf_size, true, true
-
-                );
-            return true;
-        }
-        if (node.elementName() == "colorBlue") {
-            proto.cnt_rgb++;
-            proto.sdb
-                .emplace_back(imfi, node.elementName(), proto.blueData.data(), buf_size, true, true
-
-                );
-            return true;
-        }
-
-        return false;
-    }
+        Base::Vector3f* points = nullptr;
+        Base::Color* colors = nullptr;
+        float* intensity = nullptr;
+        Base::Vector3f* normals = nullptr;
+    };
 
-    bool readItensity(const e57::Node& node, Proto& proto)
+    std::vector<Scan> readScans() const
     {
-        if (node.elementName() == "intensity") {
-            proto.inty = true;
-            proto.sdb
-                .emplace_back(imfi, node.elementName(), proto.intensity.data(), buf_size, true, true
+        std::vector<Scan> scans;
+        e57::ImageFile imfi(filename, "r");
+        e57::StructureNode root = imfi.root();
+        if (root.isDefined("data3D")) {
+            e57::VectorNode data3D(root.get("data3D"));
+            for (int64_t child = 0; child < data3D.childCount(); ++child) {
+                e57::StructureNode scan_data(data3D.get(child));
+                e57::CompressedVectorNode cvn(scan_data.get("points"));
+                e57::StructureNode prototype(cvn.prototype());
+                auto hasField = [&prototype](const char* name) {
+                    return prototype.isDefined(name);
+                };
+
+                if (!hasField("cartesianX") || !hasField("cartesianY")
+                    || !hasField("cartesianZ")) {
+                    throw Base::BadFormatError("Missing channels xyz");
+                }
 
-                );
-            return true;
+                Scan scan;
+                scan.index = child;
+                scan.hasPlacement = getPlacement(scan_data, scan.placement);
+                scan.count = static_cast<std::size_t>(cvn.childCount());
+                scan.hasColor = useColor && hasField("colorRed") && hasField("colorGreen")
+                    && hasField("colorBlue");
+                scan.hasIntensity = hasField("intensity");
+                scan.hasNormal =
+                    hasField("nor:normalX") && hasField("nor:normalY") && hasField("nor:normalZ");
+                scan.hasState = checkState && hasField("cartesianInvalidState");
+                scans.push_back(scan);
+            }
         }
-
-        return false;
+        imfi.close();
+        return scans;
     }
 
-    void readOther(const e57::Node& node, Proto& proto)
+    void readScan(Scan& scan, const Output& out) const
     {
-        proto.sdb.emplace_back(imfi, node.elementName(), proto.nil.data(), buf_size, true, true
-
-        );
-    }
+        e57::ImageFile imfi(filename, "r");
+        e57::VectorNode data3D(imfi.root().get("data3D"));
+        e57::StructureNode scan_data(data3D.get(scan.index));
+        e57::CompressedVectorNode cvn(scan_data.get("points"));
+
+        std::vector<double> xData, yData, zData;
+        std::vector<double> xNormal, yNormal, zNormal;
+        std::vector<unsigned> redData, greenData, blueData;
+        std::vector<double> intensityData;
+        std::vector<int64_t> state;
 
-    void processProto(e57::CompressedVectorNode& cvn,
-                      const Proto& proto,
-                      bool hasPlacement,
-                      const Base::Placement& plm)
-    {
-        if (proto.cnt_xyz != 3) {
-            throw Base::BadFormatError("Missing channels xyz");
-        }
-        unsigned count;
-        unsigned cnt_pts = 0;
-        Base::Vector3d pt, last;
-        e57::CompressedVectorReader cvr(cvn.reader(proto.sdb));
-        bool hasColor = (proto.cnt_rgb == 3) && useColor;
-        bool hasItensity = proto.inty;
-        bool hasNormal = (proto.cnt_nor == 3);
-        bool hasState = proto.inv_state && checkState;
-        bool filter = false;
-
-        while ((count = cvr.read())) {
-            for (size_t i = 0; i < count; ++i) {
-                filter = false;
-                if (hasState) {
-                    if (proto.state[i] != 0) {
-                        filter = true;
-                    }
+        std::vector<e57::SourceDestBuffer> sdb;
+        auto addBuffer = [&](const char* name, auto& buffer) {
+            buffer.resize(buf_size);
+            sdb.emplace_back(imfi, name, buffer.data(), buf_size, true, true);
+        };
+        addBuffer("cartesianX", xData);
+        addBuffer("cartesianY", yData);
+        addBuffer("cartesianZ", zData);
+        if (scan.hasNormal) {
+            addBuffer("nor:normalX", xNormal);
+            addBuffer("nor:normalY", yNormal);
+            addBuffer("nor:normalZ", zNormal);
+        }
+        if (scan.hasColor) {
+            addBuffer("colorRed", redData);
+            addBuffer("colorGreen", greenData);
+            addBuffer("colorBlue", blueData);
+        }
+        if (scan.hasIntensity) {
+            addBuffer("intensity", intensityData);
+        }
+        if (scan.hasState) {
+            addBuffer("cartesianInvalidState", state);
+        }
+
+        std::size_t index = scan.offset;
+        std::size_t end = scan.offset + scan.count;
+        unsigned count {};
+        e57::CompressedVectorReader cvr(cvn.reader(sdb));
+        while ((count = cvr.read()) > 0) {
+            for (std::size_t i = 0; i < count && index < end; ++i) {
+                if (scan.hasState && state[i] != 0) {
+                    continue;
                 }
 
-                pt = getCoord(proto, i, hasPlacement, plm);
-
-                if ((!filter) && (cnt_pts > 0)) {
-                    if (Base::Distance(last, pt) < minDistance) {
-                        filter = true;
-                    }
+                Base::Vector3d pt(xData[i], yData[i], zData[i]);
+                if (scan.hasPlacement) {
+                    scan.placement.multVec(pt, pt);
                 }
-                if (!filter) {
-                    cnt_pts++;
-                    points.push_back(pt);
-                    last = pt;
-                    if (hasColor) {
-                        colors.push_back(getColor(proto, i));
+                out.points[index] = Base::convertTo<Base::Vector3f>(pt);
+
+                if (out.colors) {
+                    Base::Color c;
+                    if (scan.hasColor) {
+                        c.r = static_cast<float>(redData[i]) / 255.0F;
+                        c.g = static_cast<float>(greenData[i]) / 255.0F;
+                        c.b = static_cast<float>(blueData[i]) / 255.0F;
                     }
-                    if (hasItensity) {
-                        intensity.push_back(proto.intensity[i]);
-                    }
-                    if (hasNormal) {
-                        normals.push_back(getNormal(proto, i, hasPlacement, plm.getRotation()));
+                    out.colors[index] = c;
+                }
+                if (out.intensity) {
+                    out.intensity[index] =
+                        scan.hasIntensity ? static_cast<float>(intensityData[i]) : 0.0F;
+                }
+                if (out.normals) {
+                    Base::Vector3f nor;
+                    if (scan.hasNormal) {
+                        nor.Set(static_cast<float>(xNormal[i]),
+                                static_cast<float>(yNormal[i]),
+                                static_cast<float>(zNormal[i]));
+                        if (scan.hasPlacement) {
+                            scan.placement.getRotation().multVec(nor, nor);
+                        }
                     }
+                    out.normals[index] = nor;
                 }
+                index++;
             }
         }
-    }
-
-    Base::Vector3d
-    getCoord(const Proto& proto, size_t index, bool hasPlacement, const Base::Placement& plm) const
-    {
-        Base::Vector3d pt;
-        pt.x = proto.xData[index];
-        pt.y = proto.yData[index];
-        pt.z = proto.zData[index];
-        if (hasPlacement) {
-            plm.multVec(pt, pt);
-        }
-        return pt;
-    }
-
-    Base::Vector3f
-    getNormal(const Proto& proto, size_t index, bool hasPlacement, const Base::Rotation& rot) const
-    {
-        Base::Vector3f pt;
-        pt.x = proto.xNormal[index];
-        pt.y = proto.yNormal[index];
-        pt.z = proto.zNormal[index];
-        if (hasPlacement) {
-            rot.multVec(pt, pt);
-        }
-        return pt;
-    }
-
-    Base::Color getColor(const Proto& proto, size_t index) const
-    {
-        Base::Color c;
-        c.r = static_cast<float>(proto.redData[index]) / 255.0F;
-        c.g = static_cast<float>(proto.greenData[index]) / 255.0F;
-        c.b = static_cast<float>(proto.blueData[index]) / 255.0F;
-        return c;
-    }
-
-    void resizeArrays(Proto& proto)
-    {
-        proto.xData.resize(buf_size);
-        proto.yData.resize(buf_size);
-        proto.zData.resize(buf_size);
-
-        proto.xNormal.resize(buf_size);
-        proto.yNormal.resize(buf_size);
-        proto.zNormal.resize(buf_size);
-
-        proto.redData.resize(buf_size);
-        proto.greenData.resize(buf_size);
-        proto.blueData.resize(buf_size);
+        cvr.close();
 
-        proto.intensity.resize(buf_size);
-        proto.state.resize(buf_size);
-        proto.nil.resize(buf_size);
+        scan.numRead = index - scan.offset;
     }
 
     bool getPlacement(const e57::StructureNode& scan_data, Base::Placement& plm) const
@@ -1764,15 +1694,11 @@ private:
     }
 
 private:
-    e57::ImageFile imfi;
+    std::string filename;
     bool useColor;
     bool checkState;
     double minDistance;
-    const size_t buf_size = 1024;
-    std::vector<Base::Color> colors;
-    std::vector<float> intensity;
-    PointKernel points;
-    std::vector<Base::Vector3f> normals;
+    const size_t buf_size = 65536;
 };
 }  // namespace
 
@@ -1785,12 +1711,9 @@ E57Reader::E57Reader(bool Color, bool State, double Distance)
 void E57Reader::read(const std::string& filename)
 {
     try {
+        clear();
         E57ReaderImp reader(filename, useColor, checkState, minDistance);
-        reader.read();
-        points = reader.getPoints();
-        normals = reader.getNormals();
-        colors = reader.getColors();
-        intensity = reader.getItensity();
+        reader.read(points, colors, intensity, normals);
         width = points.size();
         height = 1;
     }
@@ -71,7 +71,8 @@ void Feature::onChanged(const App::Property* prop)
         this->Points.setTransform(this->Placement.getValue().toMatrix());
     }
     // if the point data has changed check and adjust the transformation as well
-    else if (prop == &this->Points) {
+    // data that is loaded on demand must not override the current placement
+    else if (prop == &this->Points && !this->Points.testStatus(App::Property::RestoringDocFile)) {
         try {
             Base::Placement p;
             p.fromMatrix(this->Points.getTransform());
@@ -35,15 +35,24 @@
 #ifdef _PreComp_
 
 // standard
+#include <cstdint>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
 // STL
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <cmath>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <queue>
+#include <random>
 #include <set>
 #include <sstream>
+#include <unordered_map>
 #include <vector>
 
 // boost
@@ -53,6 +62,8 @@
 #include <boost/regex.hpp>
 
 // Qt
+#include <QFile>
+#include <QThreadPool>
 #include <QtConcurrentMap>
 
 #endif  //_PreComp_
@@ -0,0 +1,400 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <QThreadPool>
+#include <QtConcurrentMap>
+#endif
+
+#include <Eigen/Eigenvalues>
+
+#include <Base/Exception.h>
+#include <Base/KDTree.h>
+
+#include "Processing.h"
+
+
+using namespace Points;
+
+namespace
+{
+
+// Calls func(begin, end) for blocks of the range [0, count) on all cores
+template<typename Func>
+void parallelRanges(std::size_t count, Func&& func)
+{
+    constexpr std::size_t blockSize = 65536;
+    std::vector<std::pair<std::size_t, std::size_t>> ranges;
+    for (std::size_t begin = 0; begin < count; begin += blockSize) {
+        ranges.emplace_back(begin, std::min(count, begin + blockSize));
+    }
+    QtConcurrent::blockingMap(ranges, [&func](std::pair<std::size_t, std::size_t>& range) {
+        func(range.first, range.second);
+    });
+}
+
+bool isValid(const Base::Vector3f& pnt)
+{
+    return std::isfinite(pnt.x) && std::isfinite(pnt.y) && std::isfinite(pnt.z);
+}
+
+template<typename T>
+void keepEntries(std::vector<T>& values, const std::vector<unsigned long>& indices)
+{
+    if (values.empty()) {
+        return;
+    }
+    std::vector<T> kept;
+    kept.reserve(indices.size());
+    for (unsigned long index : indices) {
+        kept.push_back(values[index]);
+    }
+    values.swap(kept);
+}
+
+}  // namespace
+
+void PointProperties::keep(const std::vector<unsigned long>& indices)
+{
+    keepEntries(normals, indices);
+    keepEntries(intensity, indices);
+    keepEntries(colors, indices);
+}
+
+// ----------------------------------------------------------------------------
+
+NormalEstimation::NormalEstimation(const PointKernel& kernel)
+    : kernel(kernel)
+{}
+
+void NormalEstimation::setNeighbours(int num)
+{
+    neighbours = std::max(3, num);
+}
+
+void NormalEstimation::setViewpoint(const Base::Vector3f& pnt)
+{
+    viewpoint = pnt;
+}
+
+std::vector<Base::Vector3f> NormalEstimation::perform() const
+{
+    const std::vector<Base::Vector3f>& points = kernel.getBasicPoints();
+    std::vector<Base::Vector3f> normals(points.size());
+    Base::KDTree tree(points);
+
+    auto k = std::size_t(neighbours);
+    float maxDist = std::numeric_limits<float>::max();
+    parallelRanges(points.size(), [&](std::size_t begin, std::size_t end) {
+        std::vector<Base::KDTree::index_type> indices(k * (end - begin));
+        std::vector<float> distances(k * (end - begin));
+        tree.findNearest(&points[begin],
+                         end - begin,
+                         k,
+                         indices.data(),
+                         distances.data(),
+                         maxDist,
+                         1);
+
+        for (std::size_t i = begin; i < end; i++) {
+            const Base::KDTree::index_type* nb = &indices[k * (i - begin)];
+            auto count = std::size_t(std::find(nb, nb + k, Base::KDTree::InvalidIndex) - nb);
+            if (count < 3 || !isValid(points[i])) {
+                continue;
+            }
+
+            // covariance of the neighbours relative to their centroid
+            Eigen::Vector3d center = Eigen::Vector3d::Zero();
+            for (std::size_t j = 0; j < count; j++) {
+                const Base::Vector3f& pnt = points[nb[j]];
+                center += Eigen::Vector3d(pnt.x, pnt.y, pnt.z);
+            }
+            center /= double(count);
+            Eigen::Matrix3d cov = Eigen::Matrix3d::Zero();
+            for (std::size_t j = 0; j < count; j++) {
+                const Base::Vector3f& pnt = points[nb[j]];
+                Eigen::Vector3d diff = Eigen::Vector3d(pnt.x, pnt.y, pnt.z) - center;
+                cov += diff * diff.transpose();
+            }
+
+            // the eigenvalues are sorted in increasing order
+            Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver;
+            solver.computeDirect(cov);
+            Eigen::Vector3d dir = solver.eigenvectors().col(0);
+            Base::Vector3f normal(float(dir.x()), float(dir.y()), float(dir.z()));
+            normal.Normalize();
+            if (normal * (viewpoint - points[i]) < 0.F) {
+                normal = -normal;
+            }
+            normals[i] = normal;
+        }
+    });
+
+    return normals;
+}
+
+// ----------------------------------------------------------------------------
+
+OutlierRemoval::OutlierRemoval(const PointKernel& kernel)
+    : kernel(kernel)
+{}
+
+void OutlierRemoval::setNeighbours(int num)
+{
+    neighbours = std::max(1, num);
+}
+
+void OutlierRemoval::setStdDevFactor(double factor)
+{
+    stdDevFactor = factor;
+}
+
+std::vector<unsigned long> OutlierRemoval::perform() const
+{
+    const std::vector<Base::Vector3f>& points = kernel.getBasicPoints();
+    Base::KDTree tree(points);
+
+    // the nearest neighbour of a point is the point itself
+    auto k = std::size_t(neighbours) + 1;
+    float maxDist = std::numeric_limits<float>::max();
+    std::vector<float> meanDist(points.size(), -1.F);
+    parallelRanges(points.size(), [&](std::size_t begin, std::size_t end) {
+        std::vector<Base::KDTree::index_type> indices(k * (end - begin));
+        std::vector<float> distances(k * (end - begin));
+        tree.findNearest(&points[begin],
+                         end - begin,
+                         k,
+                         indices.data(),
+                         distances.data(),
+                         maxDist,
+                         1);
+
+        for (std::size_t i = begin; i < end; i++) {
+            if (!isValid(points[i])) {
+                continue;
+            }
+            const float* dist = &distances[k * (i - begin)];
+            const Base::KDTree::index_type* nb = &indices[k * (i - begin)];
+            double sum = 0.0;
+            std::size_t count = 0;
+            for (std::size_t j = 1; j < k && nb[j] != Base::KDTree::InvalidIndex; j++) {
+                sum += dist[j];
+                count++;
+            }
+            meanDist[i] = count > 0 ? float(sum / double(count)) : 0.F;
+        }
+    });
+
+    double sum = 0.0;
+    double sumSquares = 0.0;
+    std::size_t count = 0;
+    for (float dist : meanDist) {
+        if (dist >= 0.F) {
+            sum += dist;
+            sumSquares += double(dist) * double(dist);
+            count++;
+        }
+    }
+
+    std::vector<unsigned long> kept;
+    if (count == 0) {
+        return kept;
+    }
+
+    double mean = sum / double(count);
+    double variance = std::max(0.0, sumSquares / double(count) - mean * mean);
+    double threshold = mean + stdDevFactor * std::sqrt(variance);
+    for (std::size_t i = 0; i < meanDist.size(); i++) {
+        if (meanDist[i] >= 0.F && double(meanDist[i]) <= threshold) {
+            kept.push_back(static_cast<unsigned long>(i));
+        }
+    }
+    return kept;
+}
+
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// the sums of the points of a voxel and their properties
+struct Voxel
+{
+    double x {0.0}, y {0.0}, z {0.0};
+    double nx {0.0}, ny {0.0}, nz {0.0};
+    double intensity {0.0};
+    double r {0.0}, g {0.0}, b {0.0}, a {0.0};
+    std::size_t count {0};
+
+    void add(const Voxel& other)
+    {
+        x += other.x;
+        y += other.y;
+        z += other.z;
+        nx += other.nx;
+        ny += other.ny;
+        nz += other.nz;
+        intensity += other.intensity;
+        r += other.r;
+        g += other.g;
+        b += other.b;
+        a += other.a;
+        count += other.count;
+    }
+};
+
+using VoxelMap = std::unordered_map<std::uint64_t, Voxel>;
+
+}  // namespace
+
+VoxelDownsampling::VoxelDownsampling(double voxelSize)
+    : voxelSize(voxelSize)
+{
+    if (!(voxelSize > 0.0)) {
+        throw Base::ValueError("Voxel size must be positive");
+    }
+}
+
+void VoxelDownsampling::perform(const PointKernel& points,
+                                const PointProperties& properties,
+                                PointKernel& result,
+                                PointProperties& resultProperties) const
+{
+    const std::vector<Base::Vector3f>& pts = points.getBasicPoints();
+    bool hasNormals = properties.normals.size() == pts.size();
+    bool hasIntensity = properties.intensity.size() == pts.size();
+    bool hasColors = properties.colors.size() == pts.size();
+
+    Base::BoundBox3d bbox;
+    for (const auto& pnt : pts) {
+        if (isValid(pnt)) {
+            bbox.Add(Base::Vector3d(pnt.x, pnt.y, pnt.z));
+        }
+    }
+
+    // the cell indices are packed into 21 bits per axis
+    constexpr std::uint64_t maxCells = std::uint64_t(1) << 21;
+    if (bbox.IsValid()
+        && std::max({bbox.LengthX(), bbox.LengthY(), bbox.LengthZ()}) / voxelSize
+            >= double(maxCells - 1)) {
+        throw Base::ValueError("Voxel size is too small for the extent of the points");
+    }
+
+    auto cellOf = [&](const Base::Vector3f& pnt) {
+        auto ix = std::uint64_t((double(pnt.x) - bbox.MinX) / voxelSize);
+        auto iy = std::uint64_t((double(pnt.y) - bbox.MinY) / voxelSize);
+        auto iz = std::uint64_t((double(pnt.z) - bbox.MinZ) / voxelSize);
+        return (ix << 42) | (iy << 21) | iz;
+    };
+
+    // Blocks of points are summed up in parallel and merged into the result after each round,
+    // so only the occupied voxels of the blocks of a round are kept in addition to the result.
+    constexpr std::size_t blockSize = 1 << 20;
+    std::size_t blocksPerRound = std::max(1, QThreadPool::globalInstance()->maxThreadCount());
+    VoxelMap voxels;
+    for (std::size_t start = 0; start < pts.size(); start += blockSize * blocksPerRound) {
+        std::vector<std::pair<std::size_t, VoxelMap>> blocks;
+        for (std::size_t i = 0; i < blocksPerRound; i++) {
+            std::size_t begin = start + i * blockSize;
+            if (begin < pts.size()) {
+                blocks.emplace_back(begin, VoxelMap());
+            }
+        }
+
+        QtConcurrent::blockingMap(blocks, [&](std::pair<std::size_t, VoxelMap>& block) {
+            std::size_t end = std::min(pts.size(), block.first + blockSize);
+            for (std::size_t i = block.first; i < end; i++) {
+                const Base::Vector3f& pnt = pts[i];
+                if (!isValid(pnt)) {
+                    continue;
+                }
+                Voxel& voxel = block.second[cellOf(pnt)];
+                voxel.x += pnt.x;
+                voxel.y += pnt.y;
+                voxel.z += pnt.z;
+                if (hasNormals) {
+                    voxel.nx += properties.normals[i].x;
+                    voxel.ny += properties.normals[i].y;
+                    voxel.nz += properties.normals[i].z;
+                }
+                if (hasIntensity) {
+                    voxel.intensity += properties.intensity[i];
+                }
+                if (hasColors) {
+                    const Base::Color& col = properties.colors[i];
+                    voxel.r += col.r;
+                    voxel.g += col.g;
+                    voxel.b += col.b;
+                    voxel.a += col.a;
+                }
+                voxel.count++;
+            }
+        });
+
+        for (auto& block : blocks) {
+            for (const auto& it : block.second) {
+                voxels[it.first].add(it.second);
+            }
+            VoxelMap().swap(block.second);
+        }
+    }
+
+    // sort the voxels to get a deterministic order
+    std::vector<std::pair<std::uint64_t, const Voxel*>> sorted;
+    sorted.reserve(voxels.size());
+    for (const auto& it : voxels) {
+        sorted.emplace_back(it.first, &it.second);
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    std::vector<Base::Vector3f> centers;
+    centers.reserve(sorted.size());
+    resultProperties = PointProperties();
+    for (const auto& it : sorted) {
+        const Voxel& voxel = *it.second;
+        auto num = double(voxel.count);
+        centers.emplace_back(float(voxel.x / num), float(voxel.y / num), float(voxel.z / num));
+        if (hasNormals) {
+            Base::Vector3f normal(float(voxel.nx), float(voxel.ny), float(voxel.nz));
+            resultProperties.normals.push_back(normal.Normalize());
+        }
+        if (hasIntensity) {
+            resultProperties.intensity.push_back(float(voxel.intensity / num));
+        }
+        if (hasColors) {
+            resultProperties.colors.emplace_back(float(voxel.r / num),
+                                                 float(voxel.g / num),
+                                                 float(voxel.b / num),
+                                                 float(voxel.a / num));
+        }
+    }
+
+    result.clear();
+    result.swap(centers);
+    result.setTransform(points.getTransform());
+}
@@ -0,0 +1,126 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   This file is part of FreeCAD.                                         *
+ *                                                                         *
+ *   FreeCAD is free software: you can redistribute it and/or modify it    *
+ *   under the terms of the GNU Lesser General Public License as           *
+ *   published by the Free Software Foundation, either version 2.1 of the  *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful, but        *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with FreeCAD. If not, see                               *
+ *   <https://www.gnu.org/licenses/>.                                      *
+ *                                                                         *
+ **************************************************************************/
+
+#ifndef POINTS_PROCESSING_H
+#define POINTS_PROCESSING_H
+
+#include <vector>
+
+#include <Base/Color.h>
+#include <Base/Vector3D.h>
+
+#include "Points.h"
+
+
+namespace Points
+{
+
+/** The per-point properties of a point cloud. An empty list means that the cloud doesn't have
+ * the property, otherwise the list has an entry for each point.
+ */
+struct PointsExport PointProperties
+{
+    std::vector<Base::Vector3f> normals;
+    std::vector<float> intensity;
+    std::vector<Base::Color> colors;
+
+    /// Keeps the entries of the points with the given indices
+    void keep(const std::vector<unsigned long>& indices);
+};
+
+/**
+ * The NormalEstimation class estimates the normals of a point cloud by a principal component
+ * analysis of the nearest neighbours of each point. The normal is the direction of the least
+ * variance and it is oriented towards the viewpoint.
+ * Points with non-finite coordinates and points with fewer than three neighbours get a zero
+ * normal.
+ */
+class PointsExport NormalEstimation
+{
+public:
+    explicit NormalEstimation(const PointKernel& kernel);
+
+    /// Sets the number of neighbours including the point itself, the default is 10
+    void setNeighbours(int num);
+    /// Sets the viewpoint in the local system of the kernel, the default is the origin
+    void setViewpoint(const Base::Vector3f& pnt);
+    /// Returns a normal for each point in the local system of the kernel
+    std::vector<Base::Vector3f> perform() const;
+
+private:
+    const PointKernel& kernel;
+    int neighbours {10};
+    Base::Vector3f viewpoint;
+};
+
+/**
+ * The OutlierRemoval class is a statistical outlier filter. For each point the mean distance to
+ * its nearest neighbours is computed. Points whose mean distance exceeds the mean of all points
+ * by more than a multiple of the standard deviation are outliers.
+ * Points with non-finite coordinates are always removed.
+ */
+class PointsExport OutlierRemoval
+{
+public:
+    explicit OutlierRemoval(const PointKernel& kernel);
+
+    /// Sets the number of neighbours without the point itself, the default is 8
+    void setNeighbours(int num);
+    /// Sets the multiple of the standard deviation, the default is 1
+    void setStdDevFactor(double factor);
+    /// Returns the indices of the points to keep in ascending order
+    std::vector<unsigned long> perform() const;
+
+private:
+    const PointKernel& kernel;
+    int neighbours {8};
+    double stdDevFactor {1.0};
+};
+
+/**
+ * The VoxelDownsampling class replaces the points inside each cell of a regular grid by their
+ * centroid. Normals, intensities and colors are averaged, too.
+ * The input is processed in blocks, so the memory needed is proportional to the number of
+ * occupied cells and not to the number of points. Points with non-finite coordinates are skipped.
+ */
+class PointsExport VoxelDownsampling
+{
+public:
+    /// Throws ValueError if \a voxelSize isn't positive
+    explicit VoxelDownsampling(double voxelSize);
+
+    /** Downsamples \a points and their \a properties into \a result and \a resultProperties.
+     * The result has the placement of \a points, the order of its points is deterministic.
+     * Throws ValueError if the grid has too many cells along an axis.
+     */
+    void perform(const PointKernel& points,
+                 const PointProperties& properties,
+                 PointKernel& result,
+                 PointProperties& resultProperties) const;
+
+private:
+    double voxelSize;
+};
+
+}  // namespace Points
+
+
+#endif  // POINTS_PROCESSING_H
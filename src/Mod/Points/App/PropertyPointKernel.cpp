@@ -52,31 +52,37 @@ void PropertyPointKernel::setValue(const PointKernel& m)
 
 const PointKernel& PropertyPointKernel::getValue() const
 {
+    restoreDeferredDocFile();
     return *_cPoints;
 }
 
 const Data::ComplexGeoData* PropertyPointKernel::getComplexData() const
 {
+    restoreDeferredDocFile();
     return _cPoints;
 }
 
 void PropertyPointKernel::setTransform(const Base::Matrix4D& rclTrf)
 {
+    restoreDeferredDocFile();
     _cPoints->setTransform(rclTrf);
 }
 
 Base::Matrix4D PropertyPointKernel::getTransform() const
 {
+    restoreDeferredDocFile();
     return _cPoints->getTransform();
 }
 
 Base::BoundBox3d PropertyPointKernel::getBoundingBox() const
 {
+    restoreDeferredDocFile();
     return _cPoints->getBoundBox();
 }
 
 PyObject* PropertyPointKernel::getPyObject()
 {
+    restoreDeferredDocFile();
     PointsPy* points = new PointsPy(&*_cPoints);
     points->setConst();  // set immutable
     return points;
@@ -97,6 +103,7 @@ void PropertyPointKernel::setPyObject(PyObject* value)
 
 void PropertyPointKernel::Save(Base::Writer& writer) const
 {
+    restoreDeferredDocFileForSave();
     _cPoints->Save(writer);
 }
 
@@ -122,8 +129,16 @@ void PropertyPointKernel::Restore(Base::XMLReader& reader)
 
 void PropertyPointKernel::SaveDocFile(Base::Writer& writer) const
 {
-    // does nothing
-    (void)writer;
+    // Save() registers the point kernel itself, this is only used to spill
+    // undo/redo snapshots
+    restoreDeferredDocFileForSave();
+    _cPoints->SaveDocFile(writer);
+}
+
+bool PropertyPointKernel::deferRestoreDocFile(const std::shared_ptr<Base::DocFileArchive>& archive,
+                                              const std::string& fileName)
+{
+    return deferDocFile(archive, fileName);
 }
 
 void PropertyPointKernel::RestoreDocFile(Base::Reader& reader)
@@ -133,8 +148,16 @@ void PropertyPointKernel::RestoreDocFile(Base::Reader& reader)
     hasSetValue();
 }
 
+void PropertyPointKernel::releaseDocFile()
+{
+    // keep the placement, it's not part of the file
+    std::vector<PointKernel::value_type> points;
+    _cPoints->swap(points);
+}
+
 App::Property* PropertyPointKernel::Copy() const
 {
+    restoreDeferredDocFile();
     PropertyPointKernel* prop = new PropertyPointKernel();
     (*prop->_cPoints) = (*this->_cPoints);
     return prop;
@@ -144,12 +167,14 @@ void PropertyPointKernel::Paste(const App::Property& from)
 {
     aboutToSetValue();
     const PropertyPointKernel& prop = dynamic_cast<const PropertyPointKernel&>(from);
+    prop.restoreDeferredDocFile();
     *(this->_cPoints) = *(prop._cPoints);
     hasSetValue();
 }
 
 unsigned int PropertyPointKernel::getMemSize() const
 {
+    restoreDeferredDocFile();
     return sizeof(Base::Vector3f) * this->_cPoints->size();
 }
 
@@ -166,6 +191,7 @@ void PropertyPointKernel::finishEditing()
 
 void PropertyPointKernel::removeIndices(const std::vector<unsigned long>& uIndices)
 {
+    restoreDeferredDocFile();
     // We need a sorted array
     std::vector<unsigned long> uSortedInds = uIndices;
     std::sort(uSortedInds.begin(), uSortedInds.end());
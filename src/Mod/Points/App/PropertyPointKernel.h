@@ -76,6 +76,12 @@ public:
     void Restore(Base::XMLReader& reader) override;
     void SaveDocFile(Base::Writer& writer) const override;
     void RestoreDocFile(Base::Reader& reader) override;
+    bool deferRestoreDocFile(const std::shared_ptr<Base::DocFileArchive>& archive,
+                             const std::string& fileName) override;
+    bool canSpillDocFile() const override
+    {
+        return true;
+    }
     //@}
 
     /** @name Modification */
@@ -87,6 +93,9 @@ public:
     void removeIndices(const std::vector<unsigned long>&);
     //@}
 
+protected:
+    void releaseDocFile() override;
+
 private:
     Base::Reference<PointKernel> _cPoints;
 };
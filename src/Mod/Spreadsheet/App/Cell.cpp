@@ -211,6 +211,7 @@ void Cell::setExpression(App::ExpressionPtr&& expr)
     }
 
     expression = std::move(expr);
+    compiled.clear();
     setUsed(EXPRESSION_SET, !!expression);
 
     /* Update dependencies */
@@ -238,6 +239,19 @@ const App::Expression* Cell::getExpression(bool withFormat) const
     return expression.get();
 }
 
+/**
+ * Get the compiled form of the expression, or nullptr if it must be interpreted.
+ *
+ */
+
+const App::CompiledExpression* Cell::getCompiledExpression() const
+{
+    if (!expression) {
+        return nullptr;
+    }
+    return compiled.get(expression.get());
+}
+
 /**
  * Get string content.
  *
@@ -292,6 +306,7 @@ void Cell::setContent(const char* value)
                 return;
             }
             expression = std::make_unique<App::StringExpression>(owner->sheet(), value);
+            compiled.clear();
             setUsed(EXPRESSION_SET, true);
             return;
         }
@@ -574,6 +589,8 @@ void Cell::setAlias(const std::string& n)
         else {
             owner->aliasProp.erase(address);
         }
+        // references to the alias resolve to another cell now
+        App::CompiledExpression::invalidate(owner->sheet());
 
         if (!alias.empty()) {
             // The property may have been added in Sheet::updateAlias
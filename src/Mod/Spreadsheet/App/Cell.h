@@ -27,6 +27,7 @@
 #include <string>
 
 #include <App/Expression.h>
+#include <App/ExpressionCompiler.h>
 #include <App/Material.h>
 
 #include "DisplayUnit.h"
@@ -62,6 +63,8 @@ public:
 
     const App::Expression* getExpression(bool withFormat = false) const;
 
+    const App::CompiledExpression* getCompiledExpression() const;
+
     bool getStringContent(std::string& s, bool persistent = false) const;
 
     void setContent(const char* value);
@@ -197,6 +200,7 @@ private:
 
     int used;
     mutable App::ExpressionPtr expression;
+    mutable App::CompiledExpressionCache compiled;
     int alignment;
     std::set<std::string> style;
     Base::Color foregroundColor;
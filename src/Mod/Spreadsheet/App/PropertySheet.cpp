@@ -23,6 +23,7 @@
 #include "PreCompiled.h"
 #ifndef _PreComp_
 #include <algorithm>
+#include <deque>
 
 #include <boost/range/adaptor/map.hpp>
 #include <boost/range/algorithm/copy.hpp>
@@ -33,6 +34,7 @@
 #include <App/DocumentObject.h>
 #include <App/DocumentObserver.h>
 #include <App/Expression.h>
+#include <App/ExpressionCompiler.h>
 #include <App/ExpressionParser.h>
 #include <App/ExpressionVisitors.h>
 #include <App/Property.h>
@@ -73,8 +75,12 @@ void PropertySheet::clear()
     cellToPropertyNameMap.clear();
     documentObjectToCellMap.clear();
     cellToDocumentObjectMap.clear();
+    cellToDependentsMap.clear();
+    cellToPrecedentsMap.clear();
+    cellLevelsValid = false;
     aliasProp.clear();
     revAliasProp.clear();
+    CompiledExpression::invalidate(owner);
 
     clearDeps();
 }
@@ -289,6 +295,8 @@ PropertySheet::PropertySheet(const PropertySheet& other)
     , cellToPropertyNameMap(other.cellToPropertyNameMap)
     , documentObjectToCellMap(other.documentObjectToCellMap)
     , cellToDocumentObjectMap(other.cellToDocumentObjectMap)
+    , cellToDependentsMap(other.cellToDependentsMap)
+    , cellToPrecedentsMap(other.cellToPrecedentsMap)
     , aliasProp(other.aliasProp)
     , revAliasProp(other.revAliasProp)
     , updateCount(other.updateCount)
@@ -817,6 +825,7 @@ void PropertySheet::clearAlias(CellAddress address)
     if (j != aliasProp.end()) {
         revAliasProp.erase(j->second);
         aliasProp.erase(j);
+        CompiledExpression::invalidate(owner);
     }
 }
 
@@ -856,6 +865,7 @@ void PropertySheet::moveAlias(CellAddress currPos, CellAddress newPos)
         aliasProp[newPos] = j->second;
         revAliasProp[j->second] = newPos;
         aliasProp.erase(currPos);
+        CompiledExpression::invalidate(owner);
     }
 }
 
@@ -1386,12 +1396,22 @@ void PropertySheet::addDependencies(CellAddress key)
                 propertyNameToCellMap[propName].insert(key);
                 cellToPropertyNameMap[key].insert(propName);
 
+                if (!name.empty() && docObj == owner) {
+                    CellAddress precedent = stringToAddress(name.c_str(), true);
+                    if (precedent.isValid()) {
+                        addCellDependency(key, precedent);
+                    }
+                }
+
                 // Also an alias?
                 if (!name.empty() && docObj->isDerivedFrom<Sheet>()) {
                     auto other = static_cast<Sheet*>(docObj);
                     auto j = other->cells.revAliasProp.find(name);
 
                     if (j != other->cells.revAliasProp.end()) {
+                        if (docObj == owner) {
+                            addCellDependency(key, j->second);
+                        }
                         propName = docObjName + "." + j->second.toString();
                         FC_LOG("dep " << key.toString() << " -> " << propName);
 
@@ -1462,6 +1482,32 @@ void PropertySheet::removeDependencies(CellAddress key)
         cellToDocumentObjectMap.erase(i2);
         ++updateCount;
     }
+
+    /* Remove from cell <-> cell maps */
+
+    auto i3 = cellToPrecedentsMap.find(key);
+
+    if (i3 != cellToPrecedentsMap.end()) {
+        for (const auto& precedent : i3->second) {
+            auto k = cellToDependentsMap.find(precedent);
+            if (k != cellToDependentsMap.end()) {
+                k->second.erase(key);
+                if (k->second.empty()) {
+                    cellToDependentsMap.erase(k);
+                }
+            }
+        }
+        cellToPrecedentsMap.erase(i3);
+        cellLevelsValid = false;
+    }
+}
+
+void PropertySheet::addCellDependency(CellAddress key, CellAddress precedent)
+{
+    if (cellToPrecedentsMap[key].insert(precedent).second) {
+        cellToDependentsMap[precedent].insert(key);
+        cellLevelsValid = false;
+    }
 }
 
 /**
@@ -1645,12 +1691,121 @@ const std::set<std::string>& PropertySheet::getDeps(CellAddress pos) const
     }
 }
 
+const std::set<CellAddress>& PropertySheet::getCellDependents(CellAddress pos) const
+{
+    static std::set<CellAddress> empty;
+    auto i = cellToDependentsMap.find(pos);
+
+    if (i != cellToDependentsMap.end()) {
+        return i->second;
+    }
+    else {
+        return empty;
+    }
+}
+
+/**
+ * Assign each cell the length of the longest dependency chain leading to it,
+ * using Kahn's algorithm on the cell <-> cell maps.
+ */
+
+void PropertySheet::updateCellLevels()
+{
+    cellLevels.clear();
+    cellLevelsValid = true;
+    cyclicDependency = false;
+
+    std::map<CellAddress, std::size_t> pending;
+    std::deque<CellAddress> workQueue;
+    for (const auto& v : cellToDependentsMap) {
+        auto it = cellToPrecedentsMap.find(v.first);
+        if (it == cellToPrecedentsMap.end()) {
+            cellLevels[v.first] = 0;
+            workQueue.push_back(v.first);
+        }
+    }
+    for (const auto& v : cellToPrecedentsMap) {
+        pending[v.first] = v.second.size();
+    }
+
+    while (!workQueue.empty()) {
+        CellAddress currPos = workQueue.front();
+        workQueue.pop_front();
+        int level = cellLevels[currPos] + 1;
+
+        for (const auto& dep : getCellDependents(currPos)) {
+            auto& depLevel = cellLevels[dep];
+            depLevel = std::max(depLevel, level);
+            if (--pending[dep] == 0) {
+                workQueue.push_back(dep);
+            }
+        }
+    }
+
+    for (const auto& v : pending) {
+        if (v.second != 0) {
+            cyclicDependency = true;
+            cellLevels.clear();
+            break;
+        }
+    }
+}
+
+bool PropertySheet::getRecomputeOrder(const std::set<CellAddress>& cells,
+                                      std::vector<std::vector<CellAddress>>& levels)
+{
+    if (!cellLevelsValid) {
+        updateCellLevels();
+    }
+    if (cyclicDependency) {
+        return false;
+    }
+
+    std::set<CellAddress> visited(cells.begin(), cells.end());
+    std::deque<CellAddress> workQueue(cells.begin(), cells.end());
+    std::map<int, std::vector<CellAddress>> levelMap;
+    while (!workQueue.empty()) {
+        CellAddress currPos = workQueue.front();
+        workQueue.pop_front();
+
+        auto it = cellLevels.find(currPos);
+        levelMap[it != cellLevels.end() ? it->second : 0].push_back(currPos);
+
+        for (const auto& dep : getCellDependents(currPos)) {
+            if (visited.insert(dep).second) {
+                workQueue.push_back(dep);
+            }
+        }
+    }
+
+    levels.clear();
+    levels.reserve(levelMap.size());
+    for (auto& v : levelMap) {
+        levels.push_back(std::move(v.second));
+    }
+    return true;
+}
+
 void PropertySheet::recomputeDependencies(CellAddress key)
 {
     AtomicPropertyChange signaller(*this);
 
+    // keep the cached cell levels if the cell still depends on the same cells
+    bool levelsValid = cellLevelsValid;
+    std::set<CellAddress> precedents;
+    auto it = cellToPrecedentsMap.find(key);
+    if (it != cellToPrecedentsMap.end()) {
+        precedents = it->second;
+    }
+
     removeDependencies(key);
     addDependencies(key);
+
+    it = cellToPrecedentsMap.find(key);
+    if (levelsValid
+        && precedents == (it != cellToPrecedentsMap.end() ? it->second : std::set<CellAddress>())) {
+        cellLevelsValid = true;
+    }
     signaller.tryInvoke();
 }
 
@@ -200,6 +200,20 @@ public:
 
     const std::set<std::string>& getDeps(App::CellAddress pos) const;
 
+    /*! Cells of this sheet that directly depend on the cell at \a pos */
+    const std::set<App::CellAddress>& getCellDependents(App::CellAddress pos) const;
+
+    /*!
+     * Collect \a cells and all cells of this sheet that transitively depend
+     * on them, grouped by dependency level. A level only depends on the levels
+     * before it, so cells of the same level can be evaluated in any order.
+     * The levels of the sheet are cached until a cell dependency changes.
+     *
+     * \return false if the sheet contains a cyclic dependency
+     */
+    bool getRecomputeOrder(const std::set<App::CellAddress>& cells,
+                           std::vector<std::vector<App::CellAddress>>& levels);
+
     void recomputeDependencies(App::CellAddress key);
 
     PyObject* getPyObject() override;
@@ -322,6 +336,21 @@ private:
     /*! DocumentObject this cell depends on */
     std::map<App::CellAddress, std::set<std::string>> cellToDocumentObjectMap;
 
+    /*! Cells of this sheet depending on the cell given in key */
+    std::map<App::CellAddress, std::set<App::CellAddress>> cellToDependentsMap;
+
+    /*! Cells of this sheet the cell given in key depends on */
+    std::map<App::CellAddress, std::set<App::CellAddress>> cellToPrecedentsMap;
+
+    void addCellDependency(App::CellAddress key, App::CellAddress precedent);
+
+    void updateCellLevels();
+
+    /*! Cached dependency level of each cell with dependencies */
+    std::map<App::CellAddress, int> cellLevels;
+    bool cellLevelsValid = false;
+    bool cyclicDependency = false;
+
     /*! Mapping of cell position to alias property */
     std::map<App::CellAddress, std::string> aliasProp;
 
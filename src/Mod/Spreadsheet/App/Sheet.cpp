@@ -27,6 +27,7 @@
 #include <boost/regex.hpp>
 #include <deque>
 #include <memory>
+#include <numeric>
 #include <sstream>
 #include <tuple>
 #include <list>
@@ -36,9 +37,12 @@
 #include <vector>
 #endif
 
+#include <QtConcurrentMap>
+
 #include <App/Application.h>
 #include <App/Document.h>
 #include <App/DynamicProperty.h>
+#include <App/ExpressionCompiler.h>
 #include <App/ExpressionParser.h>
 #include <App/FeaturePythonPyImp.h>
 #include <Base/Exception.h>
@@ -765,10 +769,11 @@ struct CurrentAddressLock
  * depending on \a key.
  *
  * @param key The address of the cell we want to recompute.
+ * @param value Result of the compiled expression of the cell, if already evaluated.
  *
  */
 
-void Sheet::updateProperty(CellAddress key)
+void Sheet::updateProperty(CellAddress key, const CompiledExpression::Value* value)
 {
     Cell* cell = getCell(key);
 
@@ -778,7 +783,28 @@ void Sheet::updateProperty(CellAddress key)
 
         if (input) {
             CurrentAddressLock lock(currentRow, currentCol, key);
-            output.reset(input->eval());
+            CompiledExpression::Value result;
+            if (!value) {
+                const CompiledExpression* program =
+                    CompiledExpression::isEnabled() ? cell->getCompiledExpression() : nullptr;
+                if (program && program->evaluate(result)) {
+                    value = &result;
+                }
+            }
+            if (value) {
+                // build what eval() returns for the same value
+                if (value->type == CompiledExpression::Value::Boolean) {
+                    output = std::make_unique<ConstantExpression>(this,
+                                                                  value->integer ? "True" : "False",
+                                                                  Quantity(value->toDouble()));
+                }
+                else {
+                    output = std::make_unique<NumberExpression>(this, value->toQuantity());
+                }
+            }
+            else {
+                output.reset(input->eval());
+            }
         }
         else {
             std::string s;
@@ -915,9 +941,10 @@ void Sheet::recomputeCells(Range range)
 /**
  * @brief Recompute cell at address \a p.
  * @param p Address of cell.
+ * @param value Result of the compiled expression of the cell, if already evaluated.
  */
 
-void Sheet::recomputeCell(CellAddress p)
+void Sheet::recomputeCell(CellAddress p, const CompiledExpression::Value* value)
 {
     Cell* cell = cells.getValue(p);
 
@@ -928,7 +955,7 @@ void Sheet::recomputeCell(CellAddress p)
             cell->setContent(content.c_str());
         }
 
-        updateProperty(p);
+        updateProperty(p, value);
 
         if (!cell || !cell->hasException()) {
             cells.clearDirty(p);
@@ -956,6 +983,60 @@ void Sheet::recomputeCell(CellAddress p)
     }
 }
 
+/**
+ * @brief Recompute the cells of one dependency level.
+ *
+ * The cells of a level don't depend on each other, so the compiled
+ * expressions of a large level are evaluated concurrently. The cell
+ * properties are then updated in order on the calling thread.
+ *
+ * @param level Addresses of the cells.
+ */
+
+void Sheet::recomputeLevel(const std::vector<CellAddress>& level)
+{
+    constexpr std::size_t minConcurrentCells = 256;
+
+    std::vector<const CompiledExpression*> programs;
+    if (level.size() >= minConcurrentCells && CompiledExpression::isEnabled()) {
+        std::size_t count = 0;
+        programs.reserve(level.size());
+        for (const auto& addr : level) {
+            Cell* cell = cells.getValue(addr);
+            const CompiledExpression* program = nullptr;
+            if (cell && !cell->hasException()) {
+                program = cell->getCompiledExpression();
+            }
+            count += program ? 1 : 0;
+            programs.push_back(program);
+        }
+        if (count < minConcurrentCells) {
+            programs.clear();
+        }
+    }
+
+    if (programs.empty()) {
+        for (const auto& addr : level) {
+            recomputeCell(addr);
+        }
+        return;
+    }
+
+    std::vector<CompiledExpression::Value> values(level.size());
+    std::vector<char> evaluated(level.size(), 0);
+    std::vector<std::size_t> indices(level.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    QtConcurrent::blockingMap(indices, [&](std::size_t i) {
+        if (programs[i]) {
+            evaluated[i] = programs[i]->evaluate(values[i]) ? 1 : 0;
+        }
+    });
+
+    for (std::size_t i = 0; i < level.size(); ++i) {
+        recomputeCell(level[i], evaluated[i] ? &values[i] : nullptr);
+    }
+}
+
 PropertySheet::BindingType Sheet::getCellBinding(Range& range,
                                                  ExpressionPtr* pStart,
                                                  ExpressionPtr* pEnd,
@@ -1063,6 +1144,18 @@ DocumentObjectExecReturn* Sheet::execute()
         dirtyCells.insert(cellError);
     }
 
+    // The cached cell levels give the evaluation order of the dirty cells and
+    // their dependents. If the sheet has a cyclic dependency, build the graph
+    // of the dirty cells below to find and report the cycles.
+    std::vector<std::vector<CellAddress>> levels;
+    if (cells.getRecomputeOrder(dirtyCells, levels)) {
+        FC_LOG("recomputing " << getFullName());
+        for (const auto& level : levels) {
+            recomputeLevel(level);
+        }
+        return finishExecute();
+    }
+
     DependencyList graph;
     std::map<CellAddress, Vertex> VertexList;
     std::map<Vertex, CellAddress> VertexIndexList;
@@ -1185,6 +1278,11 @@ DocumentObjectExecReturn* Sheet::execute()
         }
     }
 
+    return finishExecute();
+}
+
+DocumentObjectExecReturn* Sheet::finishExecute()
+{
     // Signal update of column widths
     const std::set<int>& dirtyColumns = columnWidths.getDirty();
 
@@ -1649,7 +1747,7 @@ void Sheet::providesTo(CellAddress address, std::set<std::string>& result) const
 
 std::set<CellAddress> Sheet::providesTo(CellAddress address) const
 {
-    return cells.getDeps(getFullName() + "." + address.toString());
+    return cells.getCellDependents(address);
 }
 
 void Sheet::onDocumentRestored()
@@ -250,13 +250,18 @@ protected:
 
     void onDocumentRestored() override;
 
-    void recomputeCell(App::CellAddress p);
+    void recomputeCell(App::CellAddress p, const App::CompiledExpression::Value* value = nullptr);
+
+    void recomputeLevel(const std::vector<App::CellAddress>& level);
+
+    App::DocumentObjectExecReturn* finishExecute();
 
     App::Property* getProperty(App::CellAddress key) const;
 
     App::Property* getProperty(const char* addr) const;
 
-    void updateProperty(App::CellAddress key);
+    void updateProperty(App::CellAddress key,
+                        const App::CompiledExpression::Value* value = nullptr);
 
     App::Property* setStringProperty(App::CellAddress key, const std::string& value);
 
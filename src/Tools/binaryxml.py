@@ -0,0 +1,252 @@
+# SPDX-License-Identifier: LGPL-2.1-or-later
+
+"""
+Converts documents between XML and the binary encoding of Base::convertXMLToBinary().
+
+Usage:
+
+binaryxml.py decode <input> [<output>]   binary (or FCStd) to XML
+binaryxml.py encode <input> [<output>]   XML to binary
+
+If the input is a FCStd file its Document.xml is converted. Without output file
+the result is written to stdout, so the script can be used as a textconv driver
+to diff FCStd files:
+
+git config diff.fcstd.textconv "python3 binaryxml.py decode"
+"""
+
+import io
+import re
+import sys
+import zipfile
+
+MAGIC = b"\x89FCX"
+VERSION = 1
+MAX_SHARED_CHARACTERS = 256
+
+(
+    END_DOCUMENT,
+    START_ELEMENT,
+    EMPTY_ELEMENT,
+    END_ELEMENT,
+    CHARACTERS,
+    SHARED_CHARACTERS,
+    START_CDATA,
+    END_CDATA,
+) = range(8)
+
+ENTITIES = {"lt": "<", "gt": ">", "amp": "&", "quot": '"', "apos": "'"}
+
+
+class Decoder:
+    def __init__(self, data):
+        if not data.startswith(MAGIC):
+            raise ValueError("Not a binary XML document")
+        self.data = data
+        self.pos = len(MAGIC)
+        self.strings = []
+        if self.size() != VERSION:
+            raise ValueError("Unsupported version of binary XML document")
+
+    def size(self):
+        result = 0
+        shift = 0
+        while True:
+            byte = self.data[self.pos]
+            self.pos += 1
+            result |= (byte & 0x7F) << shift
+            if not byte & 0x80:
+                return result
+            shift += 7
+
+    def string(self):
+        size = self.size()
+        value = self.data[self.pos : self.pos + size].decode("utf-8")
+        self.pos += size
+        return value
+
+    def shared(self):
+        index = self.size()
+        if index == len(self.strings):
+            self.strings.append(self.string())
+        return self.strings[index]
+
+
+def escape(text, attribute):
+    text = text.replace("&", "&amp;").replace("<", "&lt;").replace(">", "&gt;")
+    if attribute:
+        text = text.replace('"', "&quot;").replace("\n", "&#10;").replace("\t", "&#9;")
+    return text.replace("\r", "&#13;")
+
+
+def decode(data):
+    decoder = Decoder(data)
+    out = ["<?xml version='1.0' encoding='utf-8'?>\n"]
+    elements = []
+    cdata = False
+    while decoder.pos < len(data):
+        record = data[decoder.pos]
+        decoder.pos += 1
+        if record == END_DOCUMENT:
+            break
+        if record in (START_ELEMENT, EMPTY_ELEMENT):
+            name = decoder.shared()
+            out.append("<" + name)
+            for _ in range(decoder.size()):
+                key = decoder.shared()
+                out.append(' {}="{}"'.format(key, escape(decoder.string(), True)))
+            if record == EMPTY_ELEMENT:
+                out.append("/>")
+            else:
+                out.append(">")
+                elements.append(name)
+        elif record == END_ELEMENT:
+            out.append("</{}>".format(elements.pop()))
+        elif record in (CHARACTERS, SHARED_CHARACTERS):
+            text = decoder.string() if record == CHARACTERS else decoder.shared()
+            out.append(text if cdata else escape(text, False))
+        elif record == START_CDATA:
+            cdata = True
+            out.append("<![CDATA[")
+        elif record == END_CDATA:
+            cdata = False
+            out.append("]]>")
+        else:
+            raise ValueError("Corrupted binary XML document")
+    out.append("\n")
+    return "".join(out).encode("utf-8")
+
+
+class Encoder:
+    def __init__(self):
+        self.out = io.BytesIO()
+        self.shared = {}
+        self.out.write(MAGIC)
+        self.size(VERSION)
+
+    def size(self, value):
+        while True:
+            byte = value & 0x7F
+            value >>= 7
+            self.out.write(bytes([byte | 0x80 if value else byte]))
+            if not value:
+                return
+
+    def string(self, value):
+        data = value.encode("utf-8")
+        self.size(len(data))
+        self.out.write(data)
+
+    def shared_string(self, value):
+        index = self.shared.get(value)
+        if index is not None:
+            self.size(index)
+            return
+        index = len(self.shared)
+        self.shared[value] = index
+        self.size(index)
+        self.string(value)
+
+    def record(self, record):
+        self.out.write(bytes([record]))
+
+
+def unescape(text, attribute):
+    def entity(match):
+        name = match.group(1)
+        if name.startswith("#x"):
+            return chr(int(name[2:], 16))
+        if name.startswith("#"):
+            return chr(int(name[1:]))
+        return ENTITIES[name]
+
+    text = text.replace("\r\n", "\n").replace("\r", "\n")
+    if attribute:
+        text = text.replace("\n", " ").replace("\t", " ")
+    return re.sub(r"&([^;]+);", entity, text)
+
+
+TOKEN = re.compile(
+    r"<\?.*?\?>|<!--.*?-->|<!\[CDATA\[(?P<cdata>.*?)\]\]>"
+    r"|</(?P<end>[^\s/>]+)\s*>"
+    r"|<(?P<start>[^\s/>=!?]+)(?P<attrs>(?:\s+[^\s/>=]+\s*=\s*(?:\"[^\"]*\"|'[^']*'))*)\s*(?P<empty>/?)>"
+    r"|(?P<text>[^<]+)",
+    re.DOTALL,
+)
+ATTRIBUTE = re.compile(r"([^\s/>=]+)\s*=\s*(?:\"([^\"]*)\"|'([^']*)')")
+
+
+def encode(data):
+    encoder = Encoder()
+    depth = 0
+    text = data.decode("utf-8")
+    pos = 0
+    while pos < len(text):
+        match = TOKEN.match(text, pos)
+        if not match:
+            raise ValueError("Malformed XML at offset {}".format(pos))
+        pos = match.end()
+        if match.group("start"):
+            attrs = [
+                (key, unescape(double if double is not None else single, True))
+                for key, double, single in ATTRIBUTE.findall(match.group("attrs"))
+            ]
+            encoder.record(EMPTY_ELEMENT if match.group("empty") else START_ELEMENT)
+            encoder.shared_string(match.group("start"))
+            encoder.size(len(attrs))
+            for key, value in attrs:
+                encoder.shared_string(key)
+                encoder.string(value)
+            if not match.group("empty"):
+                depth += 1
+        elif match.group("end"):
+            encoder.record(END_ELEMENT)
+            depth -= 1
+        elif match.group("cdata") is not None:
+            encoder.record(START_CDATA)
+            cdata = match.group("cdata").replace("\r\n", "\n").replace("\r", "\n")
+            if cdata:
+                encoder.record(CHARACTERS)
+                encoder.string(cdata)
+            encoder.record(END_CDATA)
+        elif match.group("text") is not None and depth > 0:
+            value = unescape(match.group("text"), False)
+            if len(value) <= MAX_SHARED_CHARACTERS and not value.strip(" \n\t\r"):
+                encoder.record(SHARED_CHARACTERS)
+                encoder.shared_string(value)
+            else:
+                encoder.record(CHARACTERS)
+                encoder.string(value)
+    encoder.record(END_DOCUMENT)
+    return encoder.out.getvalue()
+
+
+def read_input(path):
+    if zipfile.is_zipfile(path):
+        with zipfile.ZipFile(path) as archive:
+            return archive.read("Document.xml")
+    with open(path, "rb") as file:
+        return file.read()
+
+
+def main(argv):
+    if len(argv) < 3 or argv[1] not in ("decode", "encode"):
+        sys.stderr.write(__doc__)
+        return 2
+
+    data = read_input(argv[2])
+    if argv[1] == "decode":
+        result = decode(data) if data.startswith(MAGIC) else data
+    else:
+        result = data if data.startswith(MAGIC) else encode(data)
+
+    if len(argv) > 3:
+        with open(argv[3], "wb") as file:
+            file.write(result)
+    else:
+        sys.stdout.buffer.write(result)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
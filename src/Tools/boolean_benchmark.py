@@ -0,0 +1,98 @@
+# SPDX-License-Identifier: LGPL-2.1-or-later
+
+"""
+Mesh boolean benchmark.
+
+Computes the union, intersection and difference of two overlapping tessellated
+spheres or of two mesh files once with the legacy set operations and once with
+the robust boolean engine and compares the run times and whether the results
+are closed solids. The script is run with:
+
+FreeCADCmd boolean_benchmark.py
+
+and is configured through environment variables:
+
+FC_BOOLEAN_BENCHMARK_FILE1     first mesh file, by default a sphere is used
+FC_BOOLEAN_BENCHMARK_FILE2     second mesh file, by default a shifted sphere is used
+FC_BOOLEAN_BENCHMARK_SAMPLING  sampling of the spheres, default 200
+FC_BOOLEAN_BENCHMARK_RUNS      number of runs per mode, default 3
+"""
+
+import os
+import sys
+import time
+
+import FreeCAD
+import Mesh
+
+
+def env(name, default):
+    value = os.environ.get(name)
+    return int(value) if value else default
+
+
+def load_meshes():
+    path1 = os.environ.get("FC_BOOLEAN_BENCHMARK_FILE1")
+    path2 = os.environ.get("FC_BOOLEAN_BENCHMARK_FILE2")
+    if path1 and path2:
+        return Mesh.Mesh(path1), Mesh.Mesh(path2)
+    sampling = max(3, env("FC_BOOLEAN_BENCHMARK_SAMPLING", 200))
+    mesh1 = Mesh.createSphere(10.0, sampling)
+    mesh2 = Mesh.createSphere(10.0, sampling)
+    mesh2.translate(7.0, 1.0, 0.5)
+    return mesh1, mesh2
+
+
+def measure(mesh1, mesh2, operation, runs):
+    """Returns the best run time in seconds and the last result mesh"""
+    best = None
+    result = None
+    for _ in range(runs):
+        start = time.perf_counter()
+        result = getattr(mesh1, operation)(mesh2)
+        duration = time.perf_counter() - start
+        best = duration if best is None else min(best, duration)
+    return best, result
+
+
+def main():
+    mesh1, mesh2 = load_meshes()
+    runs = max(1, env("FC_BOOLEAN_BENCHMARK_RUNS", 3))
+
+    param = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Mod/Mesh")
+    legacy = param.GetBool("LegacySetOperations", False)
+    broken = 0
+    try:
+        for operation in ("unite", "intersect", "subtract"):
+            timings = {}
+            results = {}
+            for mode, flag in (("legacy", True), ("robust", False)):
+                param.SetBool("LegacySetOperations", flag)
+                timings[mode], results[mode] = measure(mesh1, mesh2, operation, runs)
+
+            FreeCAD.Console.PrintMessage(
+                "{} of {} and {} facets: legacy {:.3f} s ({} facets, solid {}), "
+                "robust {:.3f} s ({} facets, solid {})\n".format(
+                    operation,
+                    mesh1.CountFacets,
+                    mesh2.CountFacets,
+                    timings["legacy"],
+                    results["legacy"].CountFacets,
+                    results["legacy"].isSolid(),
+                    timings["robust"],
+                    results["robust"].CountFacets,
+                    results["robust"].isSolid(),
+                )
+            )
+            if results["robust"].CountFacets > 0 and not results["robust"].isSolid():
+                broken += 1
+    finally:
+        param.SetBool("LegacySetOperations", legacy)
+
+    if broken:
+        FreeCAD.Console.PrintError("{} results of the boolean engine are not solid\n".format(broken))
+        return 1
+    return 0
+
+
+sys.exit(main())
@@ -0,0 +1,86 @@
+# SPDX-License-Identifier: LGPL-2.1-or-later
+
+"""
+Mesh decimation benchmark.
+
+Decimates a tessellated torus or a mesh file once with the serial and once
+with the parallel quadric-error decimation and compares the run times, the
+number of remaining facets and the topology of the results. The script is run
+with:
+
+FreeCADCmd decimation_benchmark.py
+
+and is configured through environment variables:
+
+FC_DECIMATION_BENCHMARK_FILE      mesh file to decimate, by default a torus is used
+FC_DECIMATION_BENCHMARK_SAMPLING  sampling of the torus, default 600
+FC_DECIMATION_BENCHMARK_TARGET    number of facets to keep, default 10 percent
+FC_DECIMATION_BENCHMARK_THREADS   number of threads of the parallel run, default 0
+                                  for all cores
+FC_DECIMATION_BENCHMARK_RUNS      number of runs per mode, default 3
+"""
+
+import os
+import sys
+import time
+
+import FreeCAD
+import Mesh
+
+
+def env(name, default):
+    value = os.environ.get(name)
+    return int(value) if value else default
+
+
+def load_mesh():
+    path = os.environ.get("FC_DECIMATION_BENCHMARK_FILE")
+    if path:
+        return Mesh.Mesh(path)
+    sampling = max(3, env("FC_DECIMATION_BENCHMARK_SAMPLING", 600))
+    return Mesh.createTorus(10.0, 2.0, sampling)
+
+
+def measure(mesh, target, threads, runs):
+    """Returns the best decimation time in seconds and the last decimated mesh"""
+    best = None
+    result = None
+    for _ in range(runs):
+        result = mesh.copy()
+        start = time.perf_counter()
+        result.decimate(target, Threads=threads)
+        duration = time.perf_counter() - start
+        best = duration if best is None else min(best, duration)
+    return best, result
+
+
+def main():
+    mesh = load_mesh()
+    target = env("FC_DECIMATION_BENCHMARK_TARGET", mesh.CountFacets // 10)
+    threads = max(0, env("FC_DECIMATION_BENCHMARK_THREADS", 0))
+    runs = max(1, env("FC_DECIMATION_BENCHMARK_RUNS", 3))
+
+    timings = {}
+    results = {}
+    for mode, count in (("serial", 1), ("parallel", threads)):
+        timings[mode], results[mode] = measure(mesh, target, count, runs)
+
+    FreeCAD.Console.PrintMessage(
+        "{} facets to {}: serial {:.3f} s ({} facets), parallel {:.3f} s ({} facets), "
+        "speedup {:.1f}x\n".format(
+            mesh.CountFacets,
+            target,
+            timings["serial"],
+            results["serial"].CountFacets,
+            timings["parallel"],
+            results["parallel"].CountFacets,
+            timings["serial"] / max(timings["parallel"], 1e-9),
+        )
+    )
+    if results["serial"].isSolid() and not results["parallel"].isSolid():
+        FreeCAD.Console.PrintError("Parallel decimation broke the solid\n")
+        return 1
+    return 0
+
+
+sys.exit(main())
@@ -0,0 +1,104 @@
+# SPDX-License-Identifier: LGPL-2.1-or-later
+
+"""
+Expression evaluation benchmark.
+
+Builds a spreadsheet with a chain of dependent cells and a chain of objects
+bound through the expression engine, then compares the recompute time of the
+tree interpreter with the compiled expressions. The script is run with:
+
+FreeCADCmd expression_benchmark.py
+
+and is configured through environment variables:
+
+FC_EXPRESSION_BENCHMARK_CELLS    number of spreadsheet cells, default 20000
+FC_EXPRESSION_BENCHMARK_OBJECTS  number of bound objects, default 1000
+FC_EXPRESSION_BENCHMARK_RUNS     number of recomputes per mode, default 3
+"""
+
+import os
+import sys
+import time
+
+import FreeCAD
+
+PREFERENCES = "User parameter:BaseApp/Preferences/Document"
+
+
+def env(name, default):
+    value = os.environ.get(name)
+    return int(value) if value else default
+
+
+def build_document(cells, objects):
+    doc = FreeCAD.newDocument("ExpressionBenchmark", hidden=True)
+    sheet = doc.addObject("Spreadsheet::Sheet", "Sheet")
+    sheet.set("A1", "1 mm")
+    for row in range(2, cells + 1):
+        sheet.set(
+            "A{}".format(row),
+            "=A{} * 1.0001 + (A{} > 10 mm ? 0.5 mm : 1 mm)".format(row - 1, row - 1),
+        )
+
+    previous = None
+    for index in range(objects):
+        obj = doc.addObject("App::FeatureTest", "Feature")
+        if previous is None:
+            obj.setExpression("Float", "Sheet.A1 / 1 mm")
+        else:
+            obj.setExpression(
+                "Float", "{0}.Float * 2 - {0}.Integer + sqrt(abs({0}.Float))".format(previous.Name)
+            )
+        previous = obj
+    doc.recompute()
+    return doc
+
+
+def measure(doc, cells, runs):
+    """Returns the best recompute time in seconds"""
+    sheet = doc.getObject("Sheet")
+    best = None
+    for _ in range(runs):
+        sheet.touchCells("A1", "A{}".format(cells))
+        for obj in doc.Objects:
+            obj.touch()
+        start = time.perf_counter()
+        doc.recompute()
+        duration = time.perf_counter() - start
+        best = duration if best is None else min(best, duration)
+    return best
+
+
+def main():
+    cells = max(2, env("FC_EXPRESSION_BENCHMARK_CELLS", 20000))
+    objects = max(1, env("FC_EXPRESSION_BENCHMARK_OBJECTS", 1000))
+    runs = max(1, env("FC_EXPRESSION_BENCHMARK_RUNS", 3))
+
+    params = FreeCAD.ParamGet(PREFERENCES)
+    enabled = params.GetBool("CompiledExpressions", True)
+    doc = build_document(cells, objects)
+    try:
+        timings = {}
+        results = {}
+        for compiled in (False, True):
+            params.SetBool("CompiledExpressions", compiled)
+            timings[compiled] = measure(doc, cells, runs)
+            results[compiled] = doc.getObject("Sheet").get("A{}".format(cells))
+    finally:
+        params.SetBool("CompiledExpressions", enabled)
+        FreeCAD.closeDocument(doc.Name)
+
+    FreeCAD.Console.PrintMessage(
+        "{} cells, {} objects: interpreted {:.3f} s, compiled {:.3f} s, speedup {:.1f}x\n".format(
+            cells, objects, timings[False], timings[True], timings[False] / max(timings[True], 1e-9)
+        )
+    )
+    if results[False] != results[True]:
+        FreeCAD.Console.PrintError(
+            "Results differ: {} != {}\n".format(results[False], results[True])
+        )
+        return 1
+    return 0
+
+
+sys.exit(main())
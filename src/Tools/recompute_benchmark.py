@@ -0,0 +1,105 @@
+# SPDX-License-Identifier: LGPL-2.1-or-later
+
+"""
+Recompute regression benchmark.
+
+Opens every FCStd file of a directory, recomputes it with the recompute
+profiler enabled and compares the execute() time of each feature with a
+baseline. The script is run with:
+
+FreeCADCmd recompute_benchmark.py
+
+and is configured through environment variables:
+
+FC_RECOMPUTE_BENCHMARK_DIR       directory with the reference documents
+FC_RECOMPUTE_BENCHMARK_BASELINE  JSON file with the baseline timings
+FC_RECOMPUTE_BENCHMARK_THRESHOLD allowed slowdown factor, default 1.5
+FC_RECOMPUTE_BENCHMARK_MIN_TIME  timings below this value in microseconds are
+                                 ignored, default 1000
+FC_RECOMPUTE_BENCHMARK_RUNS      number of recomputes per document, default 3
+FC_RECOMPUTE_BENCHMARK_UPDATE    if set the baseline is (re)written
+
+The process exits with code 1 if any feature regressed past the threshold.
+"""
+
+import json
+import os
+import sys
+
+import FreeCAD
+
+
+def env(name, default=None):
+    value = os.environ.get(name)
+    return value if value else default
+
+
+def profile_document(path, runs):
+    """Returns the best execute time in microseconds of each feature"""
+    doc = FreeCAD.openDocument(path, True)
+    timings = {}
+    try:
+        for _ in range(runs):
+            for obj in doc.Objects:
+                obj.touch()
+            doc.RecomputeProfiling = True
+            doc.recompute()
+            doc.RecomputeProfiling = False
+            for entry in doc.getRecomputeProfile():
+                if entry["Category"] != "Execute":
+                    continue
+                name = entry["Name"]
+                duration = entry["Duration"]
+                timings[name] = min(duration, timings.get(name, duration))
+    finally:
+        FreeCAD.closeDocument(doc.Name)
+    return timings
+
+
+def main():
+    directory = env("FC_RECOMPUTE_BENCHMARK_DIR")
+    baseline_file = env("FC_RECOMPUTE_BENCHMARK_BASELINE")
+    if not directory or not baseline_file:
+        FreeCAD.Console.PrintError(
+            "FC_RECOMPUTE_BENCHMARK_DIR and FC_RECOMPUTE_BENCHMARK_BASELINE must be set\n"
+        )
+        return 2
+
+    threshold = float(env("FC_RECOMPUTE_BENCHMARK_THRESHOLD", "1.5"))
+    min_time = int(env("FC_RECOMPUTE_BENCHMARK_MIN_TIME", "1000"))
+    runs = max(1, int(env("FC_RECOMPUTE_BENCHMARK_RUNS", "3")))
+
+    results = {}
+    for name in sorted(os.listdir(directory)):
+        if name.lower().endswith(".fcstd"):
+            results[name] = profile_document(os.path.join(directory, name), runs)
+
+    if env("FC_RECOMPUTE_BENCHMARK_UPDATE") or not os.path.exists(baseline_file):
+        with open(baseline_file, "w", encoding="utf-8") as file:
+            json.dump(results, file, indent=1, sort_keys=True)
+        FreeCAD.Console.PrintMessage("Baseline written to {}\n".format(baseline_file))
+        return 0
+
+    with open(baseline_file, encoding="utf-8") as file:
+        baseline = json.load(file)
+
+    regressions = 0
+    for doc_name, timings in results.items():
+        reference = baseline.get(doc_name, {})
+        for feature, duration in sorted(timings.items()):
+            base = reference.get(feature)
+            if base is None or max(base, duration) < min_time:
+                continue
+            if duration > base * threshold:
+                regressions += 1
+                FreeCAD.Console.PrintError(
+                    "{}: {} took {} us, baseline {} us\n".format(doc_name, feature, duration, base)
+                )
+
+    FreeCAD.Console.PrintMessage(
+        "{} documents checked, {} regressions\n".format(len(results), regressions)
+    )
+    return 1 if regressions else 0
+
+
+sys.exit(main())
@@ -2,10 +2,17 @@
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+#include <mutex>
+#include <thread>
 
 #include "App/Application.h"
 #include "App/Document.h"
+#include "App/FeatureTest.h"
+#include "App/RecomputeCache.h"
+#include "App/RecomputeProfiler.h"
+#include "App/RecoveryJournal.h"
 #include "App/StringHasher.h"
+#include "Base/FileInfo.h"
 #include "Base/Writer.h"
 #include <src/App/InitApplication.h>
 
@@ -94,4 +101,337 @@ TEST_F(DocumentTest, getStringHasherGivesExpectedHasher)
     EXPECT_EQ(hasher, foundHasher);
 }
 
+TEST_F(DocumentTest, parallelRecomputeKeepsDependencyOrder)
+{
+    // Arrange
+    auto hGrp = App::GetApplication().GetParameterGroupByPath(
+        "User parameter:BaseApp/Preferences/Document");
+    bool parallel = hGrp->GetBool("ParallelRecompute", false);
+    hGrp->SetBool("ParallelRecompute", true);
+
+    auto first = static_cast<App::FeatureTest*>(doc()->addObject("App::FeatureTest"));
+    auto second = static_cast<App::FeatureTest*>(doc()->addObject("App::FeatureTest"));
+    auto third = static_cast<App::FeatureTest*>(doc()->addObject("App::FeatureTest"));
+    auto result = static_cast<App::FeatureTest*>(doc()->addObject("App::FeatureTest"));
+    result->Source1.setValue(first);
+    result->Source2.setValue(second);
+    third->Source1.setValue(result);
+
+    std::vector<const App::DocumentObject*> recomputed;
+    auto conn = doc()->signalRecomputedObject.connect([&](const App::DocumentObject& obj) {
+        recomputed.push_back(&obj);
+    });
+
+    // Act
+    bool hasError = false;
+    int count = doc()->recompute({}, false, &hasError);
+    conn.disconnect();
+    hGrp->SetBool("ParallelRecompute", parallel);
+
+    // Assert
+    EXPECT_FALSE(hasError);
+    EXPECT_EQ(count, 4);
+    EXPECT_EQ(first->ExecCount.getValue(), 1);
+    EXPECT_EQ(second->ExecCount.getValue(), 1);
+    EXPECT_EQ(result->ExecCount.getValue(), 1);
+    EXPECT_EQ(third->ExecCount.getValue(), 1);
+    ASSERT_EQ(recomputed.size(), 4);
+    EXPECT_EQ(recomputed[2], result);
+    EXPECT_EQ(recomputed[3], third);
+    EXPECT_FALSE(result->isTouched());
+}
+
+TEST_F(DocumentTest, parallelRecomputeRejectsChangesOfOtherObjects)
+{
+    // Arrange
+    auto hGrp = App::GetApplication().GetParameterGroupByPath(
+        "User parameter:BaseApp/Preferences/Document");
+    bool parallel = hGrp->GetBool("ParallelRecompute", false);
+    hGrp->SetBool("ParallelRecompute", true);
+
+    auto first = static_cast<App::FeatureTest*>(doc()->addObject("App::FeatureTest"));
+    auto second = static_cast<App::FeatureTest*>(doc()->addObject("App::FeatureTest"));
+    auto other = static_cast<App::FeatureTestPlacement*>(
+        doc()->addObject("App::FeatureTestPlacement"));
+    doc()->recompute();
+    first->touch();
+    second->touch();
+
+    // the first object changes another one from within execute()
+    auto propConn = first->ExecCount.signalChanged.connect([&](const App::Property&) {
+        other->Input1.setValue(Base::Placement(Base::Vector3d(1, 2, 3), Base::Rotation()));
+    });
+    std::vector<const App::Property*> changed;
+    auto conn = doc()->signalChangedObject.connect(
+        [&](const App::DocumentObject& obj, const App::Property& prop) {
+            if (&obj == other) {
+                changed.push_back(&prop);
+            }
+        });
+
+    // Act
+    bool hasError = false;
+    doc()->recompute({}, false, &hasError);
+    propConn.disconnect();
+    conn.disconnect();
+    hGrp->SetBool("ParallelRecompute", parallel);
+
+    // Assert
+    EXPECT_TRUE(hasError);
+    EXPECT_TRUE(first->isError());
+    EXPECT_FALSE(second->isError());
+    EXPECT_EQ(second->ExecCount.getValue(), 2);
+    EXPECT_TRUE(changed.empty());
+    EXPECT_EQ(other->Input1.getValue(), Base::Placement());
+}
+
+TEST_F(DocumentTest, parallelRecomputeKeepsOldValueForBeforeChange)
+{
+    // Arrange
+    auto hGrp = App::GetApplication().GetParameterGroupByPath(
+        "User parameter:BaseApp/Preferences/Document");
+    bool parallel = hGrp->GetBool("ParallelRecompute", false);
+    hGrp->SetBool("ParallelRecompute", true);
+
+    auto first = static_cast<App::FeatureTest*>(doc()->addObject("App::FeatureTest"));
+    auto second = static_cast<App::FeatureTest*>(doc()->addObject("App::FeatureTest"));
+    std::vector<long> oldValues;
+    std::vector<std::thread::id> notifyThreads;
+    auto conn = doc()->signalBeforeChangeObject.connect(
+        [&](const App::DocumentObject& obj, const App::Property& prop) {
+            if (&prop == &static_cast<const App::FeatureTest&>(obj).ExecCount) {
+                oldValues.push_back(static_cast<const App::PropertyInteger&>(prop).getValue());
+                notifyThreads.push_back(std::this_thread::get_id());
+            }
+        });
+    // the property signal is emitted by the thread that executes the object
+    std::mutex mutex;
+    std::vector<std::thread::id> execThreads;
+    auto recordThread = [&](const App::Property&) {
+        std::lock_guard<std::mutex> lock(mutex);
+        execThreads.push_back(std::this_thread::get_id());
+    };
+    auto firstConn = first->ExecCount.signalChanged.connect(recordThread);
+    auto secondConn = second->ExecCount.signalChanged.connect(recordThread);
+
+    // Act
+    doc()->recompute();
+    conn.disconnect();
+    firstConn.disconnect();
+    secondConn.disconnect();
+    hGrp->SetBool("ParallelRecompute", parallel);
+
+    // Assert
+    EXPECT_EQ(first->ExecCount.getValue(), 1);
+    EXPECT_EQ(second->ExecCount.getValue(), 1);
+    EXPECT_EQ(oldValues, std::vector<long>({0, 0}));
+    // observed objects still run on the workers, the observers on the main thread
+    auto mainThread = std::this_thread::get_id();
+    EXPECT_EQ(notifyThreads, std::vector<std::thread::id>(2, mainThread));
+    ASSERT_EQ(execThreads.size(), 2);
+    EXPECT_NE(execThreads[0], mainThread);
+    EXPECT_NE(execThreads[1], mainThread);
+}
+
+class RecomputeCacheTest: public DocumentTest
+{
+protected:
+    void SetUp() override
+    {
+        DocumentTest::SetUp();
+        _hGrp = App::GetApplication().GetParameterGroupByPath(
+            "User parameter:BaseApp/Preferences/Document");
+        _enabled = _hGrp->GetBool("RecomputeCache", false);
+        _path = _hGrp->GetASCII("RecomputeCacheDir");
+        std::string path = std::string(doc()->TransientDir.getValue()) + "/RecomputeCache";
+        _hGrp->SetBool("RecomputeCache", true);
+        _hGrp->SetASCII("RecomputeCacheDir", path.c_str());
+    }
+
+    void TearDown() override
+    {
+        App::RecomputeCache::clear();
+        _hGrp->SetBool("RecomputeCache", _enabled);
+        _hGrp->SetASCII("RecomputeCacheDir", _path.c_str());
+        DocumentTest::TearDown();
+    }
+
+    App::FeatureTestCache* addFeature(long input, App::DocumentObject* source = nullptr)
+    {
+        auto feature =
+            static_cast<App::FeatureTestCache*>(doc()->addObject("App::FeatureTestCache"));
+        feature->Input.setValue(input);
+        feature->Source.setValue(source);
+        return feature;
+    }
+
+private:
+    ParameterGrp::handle _hGrp;
+    bool _enabled {};
+    std::string _path;
+};
+
+TEST_F(RecomputeCacheTest, unchangedInputsRestoreResult)
+{
+    // Arrange
+    auto feature = addFeature(2);
+    doc()->recompute();
+    feature->Result.setValue(0);
+    feature->touch();
+
+    // Act
+    doc()->recompute();
+
+    // Assert
+    EXPECT_EQ(feature->ExecCount.getValue(), 1);
+    EXPECT_EQ(feature->Result.getValue(), 2);
+}
+
+TEST_F(RecomputeCacheTest, changedInputExecutes)
+{
+    // Arrange
+    auto feature = addFeature(2);
+    doc()->recompute();
+
+    // Act
+    feature->Input.setValue(3);
+    doc()->recompute();
+    feature->Input.setValue(2);
+    doc()->recompute();
+
+    // Assert
+    EXPECT_EQ(feature->ExecCount.getValue(), 2);
+    EXPECT_EQ(feature->Result.getValue(), 2);
+}
+
+TEST_F(RecomputeCacheTest, changedDependencyExecutes)
+{
+    // Arrange
+    auto source = addFeature(1);
+    auto feature = addFeature(2, source);
+    doc()->recompute();
+
+    // Act
+    source->Input.setValue(5);
+    doc()->recompute();
+
+    // Assert
+    EXPECT_EQ(source->ExecCount.getValue(), 2);
+    EXPECT_EQ(feature->ExecCount.getValue(), 2);
+    EXPECT_EQ(feature->Result.getValue(), 7);
+}
+
+TEST_F(RecomputeCacheTest, clearRemovesResults)
+{
+    // Arrange
+    auto feature = addFeature(2);
+    doc()->recompute();
+    App::RecomputeCache cache;
+    std::string fileName = App::RecomputeCache::getCachePath() + cache.getKey(feature) + ".fcrc";
+    EXPECT_TRUE(Base::FileInfo(fileName).exists());
+
+    // Act
+    App::RecomputeCache::clear();
+    feature->touch();
+    doc()->recompute();
+
+    // Assert
+    EXPECT_EQ(feature->ExecCount.getValue(), 2);
+}
+
+TEST_F(DocumentTest, recomputeProfilerRecordsExecute)
+{
+    // Arrange
+    auto feature = static_cast<App::FeatureTest*>(doc()->addObject("App::FeatureTest"));
+    auto& profiler = doc()->getRecomputeProfiler();
+    profiler.setEnabled(true);
+
+    // Act
+    doc()->recompute();
+    profiler.setEnabled(false);
+    auto entries = profiler.getEntries();
+    std::ostringstream trace;
+    profiler.exportChromeTrace(trace);
+
+    // Assert
+    auto execute = std::find_if(entries.begin(), entries.end(), [&](const auto& entry) {
+        return entry.category == App::RecomputeProfiler::Category::Execute;
+    });
+    ASSERT_NE(execute, entries.end());
+    EXPECT_EQ(execute->name, feature->getNameInDocument());
+    EXPECT_GE(execute->duration, 0);
+    EXPECT_NE(trace.str().find("\"traceEvents\""), std::string::npos);
+    EXPECT_NE(trace.str().find(feature->getNameInDocument()), std::string::npos);
+}
+
+TEST_F(DocumentTest, recoveryJournalReplaysChanges)
+{
+    // Arrange
+    std::string fileName = std::string(doc()->TransientDir.getValue()) + "/journal.fcj";
+    std::string targetName = App::GetApplication().getUniqueDocumentName("recovered");
+    auto target = App::GetApplication().newDocument(targetName.c_str(), "testUser");
+    for (auto document : {doc(), target}) {
+        document->addObject("App::FeatureTest", "Keep");
+        document->addObject("App::FeatureTest", "Remove");
+    }
+
+    {
+        App::RecoveryJournal journal(doc(), fileName);
+        auto keep = static_cast<App::FeatureTest*>(doc()->getObject("Keep"));
+        keep->Integer.setValue(42);
+        keep->String.setValue("journal");
+        ASSERT_TRUE(journal.append());
+
+        doc()->removeObject("Remove");
+        auto added = static_cast<App::FeatureTest*>(doc()->addObject("App::FeatureTest", "Added"));
+        added->Float.setValue(1.5);
+        auto extra = keep->addDynamicProperty("App::PropertyInteger", "Extra");
+        static_cast<App::PropertyInteger*>(extra)->setValue(7);
+        ASSERT_TRUE(journal.append());
+        EXPECT_FALSE(journal.hasChanges());
+    }
+
+    // Act
+    int records = App::RecoveryJournal::replay(target, fileName);
+
+    // Assert
+    EXPECT_EQ(records, 2);
+    auto keep = dynamic_cast<App::FeatureTest*>(target->getObject("Keep"));
+    auto added = dynamic_cast<App::FeatureTest*>(target->getObject("Added"));
+    ASSERT_NE(keep, nullptr);
+    ASSERT_NE(added, nullptr);
+    EXPECT_EQ(target->getObject("Remove"), nullptr);
+    EXPECT_EQ(keep->Integer.getValue(), 42);
+    EXPECT_STREQ(keep->String.getValue(), "journal");
+    EXPECT_DOUBLE_EQ(added->Float.getValue(), 1.5);
+    auto extra = dynamic_cast<App::PropertyInteger*>(keep->getDynamicPropertyByName("Extra"));
+    ASSERT_NE(extra, nullptr);
+    EXPECT_EQ(extra->getValue(), 7);
+    App::GetApplication().closeDocument(targetName.c_str());
+}
+
+TEST_F(DocumentTest, undoLimitRemovesOldestSteps)
+{
+    // Arrange
+    doc()->setUndoMode(1);
+    auto feature = static_cast<App::FeatureTest*>(doc()->addObject("App::FeatureTest", "Feature"));
+    for (char step = 'a'; step < 'f'; ++step) {
+        doc()->openTransaction("Change");
+        feature->String.setValue(std::string(1000, step));
+        doc()->commitTransaction();
+    }
+    EXPECT_EQ(doc()->getAvailableUndos(), 5);
+    EXPECT_GE(doc()->getUndoMemSize(), 4000U);
+
+    // Act
+    doc()->setUndoLimit(1500);
+
+    // Assert
+    EXPECT_EQ(doc()->getUndoLimit(), 1500U);
+    EXPECT_EQ(doc()->getAvailableUndos(), 1);
+    EXPECT_LE(doc()->getUndoMemSize(), 1500U);
+    EXPECT_TRUE(doc()->undo());
+    EXPECT_EQ(std::string(feature->String.getValue()), std::string(1000, 'd'));
+}
+
 // NOLINTEND(readability-magic-numbers)
@@ -0,0 +1,196 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+#include <App/Application.h>
+#include <App/Document.h>
+#include <App/Expression.h>
+#include <App/ExpressionCompiler.h>
+#include <App/FeatureTest.h>
+#include <Base/Quantity.h>
+
+#include <src/App/InitApplication.h>
+
+class ExpressionCompilerTest: public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        tests::initApplication();
+    }
+
+    void SetUp() override
+    {
+        _docName = App::GetApplication().getUniqueDocumentName("test");
+        _doc = App::GetApplication().newDocument(_docName.c_str(), "testUser");
+        _feature = static_cast<App::FeatureTest*>(_doc->addObject("App::FeatureTest"));
+        _feature->Integer.setValue(7);
+        _feature->Float.setValue(2.5);
+        _feature->Bool.setValue(true);
+        _feature->Distance.setValue(12.0);
+        _feature->Angle.setValue(30.0);
+    }
+
+    void TearDown() override
+    {
+        App::GetApplication().closeDocument(_docName.c_str());
+    }
+
+    App::FeatureTest* feature()
+    {
+        return _feature;
+    }
+
+    std::unique_ptr<App::Expression> parse(const char* text)
+    {
+        return std::unique_ptr<App::Expression>(App::Expression::parse(_feature, text));
+    }
+
+private:
+    std::string _docName;
+    App::Document* _doc {};
+    App::FeatureTest* _feature {};
+};
+
+TEST_F(ExpressionCompilerTest, matchesInterpreter)
+{
+    // Arrange
+    const char* texts[] = {
+        "Integer + 2",
+        "Integer / 2",
+        "Integer % 3",
+        "-Integer * 3",
+        "Float * 2",
+        "Float ^ 2",
+        "Distance * 2",
+        "Distance / Distance",
+        "Distance + 1 cm",
+        "Bool ? Distance : 1 mm",
+        "Integer > 5",
+        "sin(Angle) + cos(30 deg)",
+        "hypot(3; 4)",
+        "pow(Integer; 2)",
+        "abs(-Distance)",
+    };
+
+    for (auto text : texts) {
+        auto expr = parse(text);
+
+        // Act
+        auto program = App::CompiledExpression::compile(expr.get());
+        App::any compiled;
+
+        // Assert
+        ASSERT_TRUE(program) << text;
+        ASSERT_TRUE(program->evaluate(compiled)) << text;
+        auto interpreted = expr->getValueAsAny();
+        EXPECT_EQ(compiled.type(), interpreted.type()) << text;
+        EXPECT_TRUE(App::isAnyEqual(compiled, interpreted)) << text;
+    }
+}
+
+TEST_F(ExpressionCompilerTest, foldsConstants)
+{
+    // Arrange
+    auto expr = parse("(1 + 2) * 3 mm");
+
+    // Act
+    auto program = App::CompiledExpression::compile(expr.get());
+    App::any value;
+
+    // Assert
+    ASSERT_TRUE(program);
+    EXPECT_EQ(program->size(), 1);
+    ASSERT_TRUE(program->evaluate(value));
+    EXPECT_EQ(App::any_cast<Base::Quantity>(value), Base::Quantity(9.0, Base::Unit::Length));
+}
+
+TEST_F(ExpressionCompilerTest, rejectsUnsupportedExpressions)
+{
+    // Arrange
+    auto string = parse("<<text>>");
+    auto mismatch = parse("Float + 1 mm");
+
+    // Act
+    auto stringProgram = App::CompiledExpression::compile(string.get());
+    auto mismatchProgram = App::CompiledExpression::compile(mismatch.get());
+
+    // Assert
+    EXPECT_FALSE(stringProgram);
+    EXPECT_FALSE(mismatchProgram);
+}
+
+TEST_F(ExpressionCompilerTest, fallsBackOnErrors)
+{
+    // Arrange
+    auto expr = parse("Integer / (Integer - 7)");
+
+    // Act
+    auto program = App::CompiledExpression::compile(expr.get());
+    App::any value;
+
+    // Assert
+    ASSERT_TRUE(program);
+    EXPECT_FALSE(program->evaluate(value));
+}
+
+TEST_F(ExpressionCompilerTest, cacheFollowsReferences)
+{
+    // Arrange
+    feature()->addDynamicProperty("App::PropertyFloat", "Extra");
+    auto expr = parse("Extra + 1");
+    App::CompiledExpressionCache cache;
+    auto program = cache.get(expr.get());
+    ASSERT_TRUE(program);
+
+    // Act
+    feature()->removeDynamicProperty("Extra");
+
+    // Assert
+    EXPECT_TRUE(program->isOutdated());
+    EXPECT_FALSE(cache.get(expr.get()));
+}
+
+TEST_F(ExpressionCompilerTest, cacheKeepsProgramForOtherDocuments)
+{
+    // Arrange
+    auto expr = parse("Integer + 1");
+    App::CompiledExpressionCache cache;
+    auto program = cache.get(expr.get());
+    ASSERT_TRUE(program);
+    std::string otherName = App::GetApplication().getUniqueDocumentName("other");
+    auto other = App::GetApplication().newDocument(otherName.c_str(), "testUser");
+
+    // Act
+    other->addObject("App::FeatureTest");
+    other->Label.setValue("Renamed");
+    bool outdatedByOther = program->isOutdated();
+    App::GetApplication().closeDocument(otherName.c_str());
+    bool outdatedByClose = program->isOutdated();
+    feature()->getDocument()->addObject("App::FeatureTest");
+
+    // Assert
+    EXPECT_FALSE(outdatedByOther);
+    EXPECT_FALSE(outdatedByClose);
+    EXPECT_TRUE(program->isOutdated());
+}
+
+TEST_F(ExpressionCompilerTest, cacheCompilesReplacedExpression)
+{
+    // Arrange
+    App::CompiledExpressionCache cache;
+    auto expr = parse("Integer + 1");
+    ASSERT_TRUE(cache.get(expr.get()));
+
+    // Act
+    // the new expression may be allocated at the address of the old one
+    expr.reset();
+    expr = parse("<<text>>");
+    auto program = cache.get(expr.get());
+
+    // Assert
+    EXPECT_FALSE(program);
+}
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <Base/KDTree.h>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+
+class KDTreeTest: public ::testing::Test
+{
+protected:
+    using index_type = Base::KDTree::index_type;
+
+    static std::vector<Base::Vector3f> makePoints(std::size_t count, unsigned int seed)
+    {
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<float> coord(-10.F, 10.F);
+        std::vector<Base::Vector3f> points;
+        for (std::size_t index = 0; index < count; index++) {
+            points.emplace_back(coord(generator), coord(generator), 0.2F * coord(generator));
+        }
+        return points;
+    }
+
+    // the k nearest points by brute force, sorted by distance and index
+    static std::vector<index_type> nearest(const std::vector<Base::Vector3f>& points,
+                                           const Base::Vector3f& pnt,
+                                           std::size_t k,
+                                           float maxDist)
+    {
+        std::vector<std::pair<float, index_type>> dists;
+        for (std::size_t index = 0; index < points.size(); index++) {
+            float dist = Base::DistanceP2(pnt, points[index]);
+            if (dist <= maxDist * maxDist) {
+                dists.emplace_back(dist, index_type(index));
+            }
+        }
+        std::sort(dists.begin(), dists.end());
+        dists.resize(std::min(dists.size(), k));
+
+        std::vector<index_type> indices;
+        for (const auto& it : dists) {
+            indices.push_back(it.second);
+        }
+        return indices;
+    }
+};
+
+TEST_F(KDTreeTest, TestEmpty)
+{
+    Base::KDTree tree;
+    EXPECT_TRUE(tree.empty());
+
+    float dist {};
+    EXPECT_EQ(tree.findNearest(Base::Vector3f(), dist), Base::KDTree::InvalidIndex);
+    std::vector<index_type> indices;
+    tree.findInRadius(Base::Vector3f(), 1.F, indices);
+    tree.findInBox(Base::BoundBox3f(-1.F, -1.F, -1.F, 1.F, 1.F, 1.F), indices);
+    EXPECT_TRUE(indices.empty());
+}
+
+TEST_F(KDTreeTest, TestNearest)
+{
+    std::vector<Base::Vector3f> points = makePoints(5000, 1);
+    Base::KDTree tree(points);
+    EXPECT_EQ(tree.size(), 5000);
+
+    std::vector<index_type> indices(10);
+    std::vector<float> distances(10);
+    for (const auto& pnt : makePoints(200, 2)) {
+        std::size_t count = tree.findNearest(pnt, 10, indices.data(), distances.data());
+        ASSERT_EQ(count, 10);
+        EXPECT_EQ(indices, nearest(points, pnt, 10, std::numeric_limits<float>::max()));
+        EXPECT_FLOAT_EQ(distances[0], Base::Distance(pnt, points[indices[0]]));
+        EXPECT_TRUE(std::is_sorted(distances.begin(), distances.end()));
+
+        // only a few points are within the maximum distance
+        count = tree.findNearest(pnt, 10, indices.data(), distances.data(), 0.4F);
+        std::vector<index_type> expected = nearest(points, pnt, 10, 0.4F);
+        ASSERT_EQ(count, expected.size());
+        EXPECT_TRUE(std::equal(expected.begin(), expected.end(), indices.begin()));
+        EXPECT_TRUE(std::all_of(indices.begin() + count, indices.end(), [](index_type index) {
+            return index == Base::KDTree::InvalidIndex;
+        }));
+    }
+}
+
+TEST_F(KDTreeTest, TestRadiusAndBox)
+{
+    std::vector<Base::Vector3f> points = makePoints(5000, 3);
+    Base::KDTree tree(points);
+
+    for (const auto& pnt : makePoints(50, 4)) {
+        std::vector<index_type> indices;
+        tree.findInRadius(pnt, 1.5F, indices);
+        EXPECT_EQ(indices, nearest(points, pnt, points.size(), 1.5F));
+    }
+
+    Base::BoundBox3f box(-2.F, 1.F, -1.F, 3.F, 4.F, 1.F);
+    std::vector<index_type> indices;
+    tree.findInBox(box, indices);
+    std::vector<index_type> expected;
+    for (std::size_t index = 0; index < points.size(); index++) {
+        if (box.IsInBox(points[index])) {
+            expected.push_back(index_type(index));
+        }
+    }
+    EXPECT_EQ(indices, expected);
+}
+
+TEST_F(KDTreeTest, TestBatched)
+{
+    std::vector<Base::Vector3f> points = makePoints(20000, 5);
+    Base::KDTree tree(points);
+    std::vector<Base::Vector3f> queries = makePoints(5000, 6);
+
+    const std::size_t k = 4;
+    std::vector<index_type> indices(queries.size() * k);
+    std::vector<float> distances(queries.size() * k);
+    tree.findNearest(queries.data(), queries.size(), k, indices.data(), distances.data(), 1.F, 3);
+
+    std::vector<std::size_t> offsets;
+    std::vector<index_type> neighbours;
+    tree.findInRadius(queries.data(), queries.size(), 0.3F, offsets, neighbours, 3);
+    ASSERT_EQ(offsets.size(), queries.size() + 1);
+    EXPECT_EQ(offsets.back(), neighbours.size());
+
+    std::vector<index_type> single(k);
+    std::vector<float> singleDist(k);
+    for (std::size_t i = 0; i < queries.size(); i++) {
+        tree.findNearest(queries[i], k, single.data(), singleDist.data(), 1.F);
+        EXPECT_TRUE(std::equal(single.begin(), single.end(), indices.begin() + i * k));
+
+        std::vector<index_type> radius;
+        tree.findInRadius(queries[i], 0.3F, radius);
+        EXPECT_TRUE(std::equal(radius.begin(),
+                               radius.end(),
+                               neighbours.begin() + offsets[i],
+                               neighbours.begin() + offsets[i + 1]));
+    }
+}
+
+TEST_F(KDTreeTest, TestDuplicatesAndInvalidPoints)
+{
+    std::vector<Base::Vector3f> points(100, Base::Vector3f(1.F, 2.F, 3.F));
+    points[10].x = std::numeric_limits<float>::quiet_NaN();
+    points[20].z = std::numeric_limits<float>::infinity();
+    Base::KDTree tree(points);
+    EXPECT_EQ(tree.size(), 98);
+
+    // equal distances are sorted by the index
+    std::vector<index_type> indices(3);
+    std::vector<float> distances(3);
+    tree.findNearest(Base::Vector3f(), 3, indices.data(), distances.data());
+    EXPECT_EQ(indices, std::vector<index_type>({0, 1, 2}));
+
+    std::vector<index_type> found;
+    tree.findInRadius(Base::Vector3f(1.F, 2.F, 3.F), 0.F, found);
+    EXPECT_EQ(found.size(), 98);
+    EXPECT_EQ(std::count(found.begin(), found.end(), 10), 0);
+}
+
+// NOLINTEND(cppcoreguidelines-*,readability-*)
@@ -6,12 +6,16 @@
 #pragma warning(disable : 4996)
 #endif
 
+#include "Base/BinaryXML.h"
 #include "Base/Exception.h"
+#include "Base/Persistence.h"
 #include "Base/Reader.h"
+#include "Base/Writer.h"
 #include <array>
 #include <filesystem>
 #include <fstream>
 #include <random>
+#include <sstream>
 #include <string>
 #include <xercesc/util/PlatformUtils.hpp>
 
@@ -387,3 +391,114 @@ TEST_F(ReaderTest, invalidDefaults)
         { xml.Reader()->getAttributeAsInteger("missing", "Not a Float"); },
         std::invalid_argument);
 }
+
+class DocFileArchiveTestFile: public Base::Persistence
+{
+public:
+    unsigned int getMemSize() const override
+    {
+        return 0;
+    }
+    void Save(Base::Writer& /*writer*/) const override
+    {}
+    void Restore(Base::XMLReader& /*reader*/) override
+    {}
+    void SaveDocFile(Base::Writer& writer) const override
+    {
+        writer.Stream() << content;
+    }
+    void RestoreDocFile(Base::Reader& reader) override
+    {
+        std::ostringstream str;
+        str << reader.rdbuf();
+        content = str.str();
+    }
+
+    std::string content;
+};
+
+TEST_F(ReaderTest, docFileArchiveRestoresOnDemand)
+{
+    // Arrange
+    fs::path file =
+        fs::temp_directory_path() / ("unit_test_Reader-" + random_string(4) + ".FCStd");
+    std::array<DocFileArchiveTestFile, 3> files;
+    {
+        std::ofstream stream(file.string(), std::ios::out | std::ios::binary);
+        Base::ZipWriter writer(stream);
+        writer.putNextEntry("Document.xml");
+        writer.Stream() << "<Document/>";
+        for (std::size_t i = 0; i < files.size(); ++i) {
+            files[i].content = std::string(1000 * (i + 1), static_cast<char>('a' + i));
+            writer.addFile(("File" + std::to_string(i)).c_str(), &files[i]);
+        }
+        writer.writeFiles();
+    }
+    Base::DocFileArchive archive(file.string());
+    DocFileArchiveTestFile restored;
+
+    // Act
+    bool found = archive.restoreDocFile("File2", &restored);
+    bool missing = archive.restoreDocFile("File3", &restored);
+
+    // Assert
+    EXPECT_TRUE(found);
+    EXPECT_FALSE(missing);
+    EXPECT_EQ(restored.content, files[2].content);
+    fs::remove(file);
+}
+
+TEST_F(ReaderTest, binaryXMLMatchesXML)
+{
+    // Arrange
+    std::string xml = R"(<?xml version='1.0' encoding='utf-8'?>
+<!-- comment -->
+<Document SchemaVersion="4">
+    <Empty name="a &amp; b&#10;c"/>
+    <Text>x &lt; y</Text>
+    <Data><![CDATA[raw <data>]]></Data>
+</Document>
+)";
+    std::stringstream binary;
+    Base::convertXMLToBinary(xml, binary);
+
+    // Act
+    Base::XMLReader reader("Document.xml", binary);
+    reader.readElement("Document");
+    long schema = reader.getAttributeAsInteger("SchemaVersion");
+    reader.readElement("Empty");
+    std::string name = reader.getAttribute("name");
+    reader.readElement("Text");
+    std::ostringstream text;
+    text << reader.beginCharStream().rdbuf();
+    reader.readEndElement("Text");
+    reader.readElement("Data");
+    std::ostringstream data;
+    data << reader.beginCharStream().rdbuf();
+    reader.readEndElement("Document");
+
+    // Assert
+    EXPECT_TRUE(reader.isValid());
+    EXPECT_EQ(schema, 4);
+    EXPECT_EQ(name, "a & b\nc");
+    EXPECT_EQ(text.str(), "x < y");
+    EXPECT_EQ(data.str(), "raw <data>");
+    EXPECT_EQ(reader.level(), 0);
+}
+
+TEST_F(ReaderTest, binaryXMLRoundTrip)
+{
+    // Arrange
+    std::string xml = "<?xml version='1.0' encoding='utf-8'?>\n"
+                      "<Document a=\"&quot;1&quot;\">\n    <Empty/>\n    <Text>&amp;</Text>\n"
+                      "    <Data><![CDATA[<raw>]]></Data>\n</Document>\n";
+    std::stringstream binary;
+    Base::convertXMLToBinary(xml, binary);
+
+    // Act
+    std::stringstream result;
+    Base::convertBinaryToXML(binary, result);
+
+    // Assert
+    EXPECT_EQ(result.str(), xml);
+}
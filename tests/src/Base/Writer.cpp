@@ -2,7 +2,15 @@
 
 #include <gtest/gtest.h>
 
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <zipios++/zipinputstream.h>
+
+#include "Base/BinaryXML.h"
 #include "Base/Exception.h"
+#include "Base/Persistence.h"
 #include "Base/Writer.h"
 
 // Writer is designed to be a base class, so for testing we actually instantiate a StringWriter,
@@ -129,3 +137,173 @@ TEST_F(WriterTest, charStreamBase64Encoded)
     // Conversion done using https://www.base64encode.org for testing purposes
     EXPECT_EQ(std::string("RnJlZUNBRCByb2NrcyEg8J+qqPCfqqjwn6qo\n"), _writer.getString());
 }
+
+class ZipWriterTestFile: public Base::Persistence
+{
+public:
+    ZipWriterTestFile(std::string content, bool concurrent)
+        : content(std::move(content))
+        , concurrent(concurrent)
+    {}
+    unsigned int getMemSize() const override
+    {
+        return 0;
+    }
+    void Save(Base::Writer& /*writer*/) const override
+    {}
+    void Restore(Base::XMLReader& /*reader*/) override
+    {}
+    void SaveDocFile(Base::Writer& writer) const override
+    {
+        writer.Stream() << content;
+    }
+    bool canSaveDocFileConcurrently() const override
+    {
+        return concurrent;
+    }
+
+private:
+    std::string content;
+    bool concurrent;
+};
+
+TEST(ZipWriterTest, writeFilesKeepsOrder)
+{
+    // Arrange
+    std::vector<std::unique_ptr<ZipWriterTestFile>> files;
+    std::stringstream archive;
+    {
+        Base::ZipWriter writer(archive);
+        writer.putNextEntry("Document.xml");
+        writer.Stream() << "<Document/>";
+        for (int i = 0; i < 8; ++i) {
+            std::string content(10000 * (i + 1), static_cast<char>('a' + i));
+            files.push_back(std::make_unique<ZipWriterTestFile>(content, i % 2 == 0));
+            writer.addFile(("File" + std::to_string(i)).c_str(), files.back().get());
+        }
+
+        // Act
+        writer.writeFiles();
+        EXPECT_FALSE(writer.hasErrors());
+    }
+
+    // Assert
+    zipios::ZipInputStream zip(archive);
+    for (int i = 0; i < 8; ++i) {
+        auto entry = zip.getNextEntry();
+        ASSERT_TRUE(entry->isValid());
+        EXPECT_EQ(entry->getName(), "File" + std::to_string(i));
+        std::ostringstream content;
+        content << zip.rdbuf();
+        EXPECT_EQ(content.str(), std::string(10000 * (i + 1), static_cast<char>('a' + i)));
+    }
+}
+
+TEST(ZipWriterTest, writeFilesKeepsOrderOfManyFiles)
+{
+    // Arrange
+    // more files than are processed ahead of the one written next
+    const int numFiles = 4 * static_cast<int>(std::thread::hardware_concurrency()) + 5;
+    std::vector<std::unique_ptr<ZipWriterTestFile>> files;
+    std::stringstream archive;
+    {
+        Base::ZipWriter writer(archive);
+        writer.putNextEntry("Document.xml");
+        writer.Stream() << "<Document/>";
+        for (int i = 0; i < numFiles; ++i) {
+            files.push_back(std::make_unique<ZipWriterTestFile>(std::to_string(i), i % 3 == 0));
+            writer.addFile(("File" + std::to_string(i)).c_str(), files.back().get());
+        }
+
+        // Act
+        writer.writeFiles();
+        EXPECT_FALSE(writer.hasErrors());
+    }
+
+    // Assert
+    zipios::ZipInputStream zip(archive);
+    for (int i = 0; i < numFiles; ++i) {
+        auto entry = zip.getNextEntry();
+        ASSERT_TRUE(entry->isValid());
+        EXPECT_EQ(entry->getName(), "File" + std::to_string(i));
+        std::ostringstream content;
+        content << zip.rdbuf();
+        EXPECT_EQ(content.str(), std::to_string(i));
+    }
+}
+
+TEST(ZipWriterTest, binaryXMLMode)
+{
+    // Arrange
+    std::string xml = "<?xml version='1.0' encoding='utf-8'?>\n"
+                      "<Document>\n    <A b=\"1\"/>\n</Document>\n";
+    std::stringstream archive;
+    {
+        Base::ZipWriter writer(archive);
+        writer.setMode("BinaryXML");
+
+        // Act
+        writer.putNextEntry("Document.xml");
+        writer.Stream() << xml;
+        writer.writeFiles();
+        EXPECT_FALSE(writer.hasErrors());
+    }
+
+    // Assert
+    zipios::ZipInputStream zip(archive);
+    EXPECT_TRUE(Base::isBinaryXML(zip));
+    std::stringstream result;
+    Base::convertBinaryToXML(zip, result);
+    EXPECT_EQ(result.str(), xml);
+}
+
+TEST(ZipWriterTest, binaryXMLModeEncodesWhileWriting)
+{
+    // Arrange
+    std::ostringstream str;
+    str << "<?xml version='1.0' encoding='utf-8'?>\n<Document>\n";
+    for (int i = 0; i < 5000; i++) {
+        str << "    <Property name=\"P" << i << "\" value=\"a &amp; b\"/>\n"
+            << "    <Text>" << std::string(i % 50, 'x') << "</Text>\n"
+            << "    <Data><![CDATA[<" << i << ">]]></Data>\n";
+    }
+    str << "</Document>\n";
+    std::string xml = str.str();
+    std::stringstream archive;
+    {
+        Base::ZipWriter writer(archive);
+        writer.setMode("BinaryXML");
+
+        // Act
+        writer.putNextEntry("Document.xml");
+        // small pieces make the tokens cross the chunk boundaries
+        for (std::size_t pos = 0; pos < xml.size(); pos += 7) {
+            writer.Stream() << xml.substr(pos, 7);
+        }
+        writer.writeFiles();
+        EXPECT_FALSE(writer.hasErrors());
+    }
+
+    // Assert
+    zipios::ZipInputStream zip(archive);
+    EXPECT_TRUE(Base::isBinaryXML(zip));
+    std::stringstream result;
+    Base::convertBinaryToXML(zip, result);
+    EXPECT_EQ(result.str(), xml);
+}
+
+TEST(ZipWriterTest, binaryXMLModeReportsMalformedDocument)
+{
+    // Arrange
+    std::stringstream archive;
+    Base::ZipWriter writer(archive);
+    writer.setMode("BinaryXML");
+
+    // Act
+    writer.putNextEntry("Document.xml");
+    writer.Stream() << "<Document><A></B></Document>";
+    writer.writeFiles();
+
+    // Assert
+    EXPECT_TRUE(writer.hasErrors());
+}
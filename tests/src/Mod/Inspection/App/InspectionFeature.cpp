@@ -0,0 +1,261 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <BRep_Tool.hxx>
+#include <BRepBuilderAPI_MakeVertex.hxx>
+#include <BRepClass3d_SolidClassifier.hxx>
+#include <BRepExtrema_DistShapeShape.hxx>
+#include <BRepPrimAPI_MakeBox.hxx>
+#include <BRepPrimAPI_MakeSphere.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Solid.hxx>
+
+#include <src/App/InitApplication.h>
+#include <Mod/Inspection/App/InspectionFeature.h>
+#include <Mod/Mesh/App/Core/Iterator.h>
+#include <Mod/Mesh/App/Mesh.h>
+#include <Mod/Part/App/TopoShape.h>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+
+class InspectionTest: public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        tests::initApplication();
+    }
+
+    // directions that are evenly distributed over the unit sphere
+    static std::vector<Base::Vector3f> makeDirections(int count)
+    {
+        std::vector<Base::Vector3f> dirs;
+        const float golden = float(M_PI) * (3.0F - std::sqrt(5.0F));
+        for (int i = 0; i < count; i++) {
+            float z = 1.0F - 2.0F * (float(i) + 0.5F) / float(count);
+            float r = std::sqrt(1.0F - z * z);
+            float phi = golden * float(i);
+            dirs.emplace_back(r * std::cos(phi), r * std::sin(phi), z);
+        }
+        return dirs;
+    }
+
+    // The points lie on rays from the center of the shape and are moved from the surface along
+    // the ray. The small offsets are within the deflection of the tessellation.
+    static std::vector<Base::Vector3f> makePoints(const TopoDS_Shape& solid,
+                                                  const Base::Vector3f& center)
+    {
+        const std::vector<float> offsets {-3.0F, -0.5F, -0.02F, -0.005F, 0.005F, 0.02F, 0.5F, 3.0F};
+        std::vector<Base::Vector3f> points;
+        for (const auto& dir : makeDirections(100)) {
+            // find the surface along the ray by bisection
+            float inner = 0.0F;
+            float outer = 100.0F;
+            for (int i = 0; i < 40; i++) {
+                float mid = 0.5F * (inner + outer);
+                if (isInside(solid, center + dir * mid)) {
+                    inner = mid;
+                }
+                else {
+                    outer = mid;
+                }
+            }
+            for (float offset : offsets) {
+                points.push_back(center + dir * (inner + offset));
+            }
+        }
+        return points;
+    }
+
+    static bool isInside(const TopoDS_Shape& solid, const Base::Vector3f& point)
+    {
+        BRepClass3d_SolidClassifier classifier(solid);
+        classifier.Perform(gp_Pnt(point.x, point.y, point.z), 0.001);
+        return classifier.State() == TopAbs_IN;
+    }
+
+    // the signed distance as computed with BRepExtrema before the tessellation was used
+    static float shapeDistance(const TopoDS_Shape& solid, const Base::Vector3f& point)
+    {
+        TopExp_Explorer xp(solid, TopAbs_SHELL);
+        gp_Pnt pnt(point.x, point.y, point.z);
+        BRepExtrema_DistShapeShape distss(xp.Current(), BRepBuilderAPI_MakeVertex(pnt).Vertex());
+        float dist = float(distss.Value());
+        return isInside(solid, point) ? -dist : dist;
+    }
+
+    // the signed distance to the nearest facet as computed with the mesh grid before the BVH
+    static float meshDistance(const MeshCore::MeshKernel& kernel, const Base::Vector3f& point)
+    {
+        float minDist = std::numeric_limits<float>::max();
+        MeshCore::MeshFacetIterator it(kernel);
+        for (it.Init(); it.More(); it.Next()) {
+            float dist = it->DistanceToPoint(point);
+            if (dist < std::fabs(minDist)) {
+                bool below = point.DistanceToPlane(it->_aclPoints[0], it->GetNormal()) <= 0;
+                minDist = below ? -dist : dist;
+            }
+        }
+        return minDist;
+    }
+
+    static Mesh::MeshObject makeMesh(const TopoDS_Shape& shape)
+    {
+        std::vector<Base::Vector3d> points;
+        std::vector<Data::ComplexGeoData::Facet> facets;
+        Part::TopoShape(shape).getFaces(points, facets, 0.05);
+        Mesh::MeshObject mesh;
+        mesh.setFacets(facets, points);
+        return mesh;
+    }
+
+    void testShape(const TopoDS_Shape& solid, const Base::Vector3f& center)
+    {
+        Inspection::InspectNominalShape nominal(solid, radius);
+        for (const auto& point : makePoints(solid, center)) {
+            float expected = shapeDistance(solid, point);
+            float dist = nominal.getDistance(point);
+            // the distances beyond the search radius are taken from the tessellation
+            float tolerance = std::fabs(expected) <= radius ? 1e-4F : 0.05F;
+            EXPECT_NEAR(dist, expected, tolerance) << point.x << ", " << point.y << ", " << point.z;
+            EXPECT_EQ(dist < 0, expected < 0) << point.x << ", " << point.y << ", " << point.z;
+        }
+    }
+
+    void testMesh(const TopoDS_Shape& solid, const Base::Vector3f& center)
+    {
+        Mesh::MeshObject mesh = makeMesh(solid);
+        ASSERT_GT(mesh.countFacets(), 0);
+        Inspection::InspectNominalMesh nominal(mesh, radius);
+        Inspection::InspectNominalFastMesh fastNominal(mesh, radius);
+        for (const auto& point : makePoints(solid, center)) {
+            float expected = meshDistance(mesh.getKernel(), point);
+            float dist = nominal.getDistance(point);
+            float fastDist = fastNominal.getDistance(point);
+            if (std::fabs(expected) <= radius) {
+                EXPECT_NEAR(dist, expected, 1e-4F);
+                EXPECT_NEAR(fastDist, expected, 1e-4F);
+            }
+            else {
+                // points outside of the enlarged bounding box are skipped
+                if (dist != std::numeric_limits<float>::max()) {
+                    EXPECT_NEAR(dist, expected, 1e-4F);
+                }
+                EXPECT_EQ(fastDist, std::numeric_limits<float>::max());
+            }
+        }
+    }
+
+    const float radius = 1.0F;
+};
+
+// A nominal that returns the same distance for all points
+class ConstantNominal: public Inspection::InspectNominalGeometry
+{
+public:
+    explicit ConstantNominal(float distance)
+        : distance(distance)
+    {}
+    float getDistance(const Base::Vector3f&) const override
+    {
+        return distance;
+    }
+    void getDistances(const std::vector<Base::Vector3f>& points,
+                      std::vector<float>& distances) const override
+    {
+        chunks++;
+        if (inspection) {
+            inspection->cancel();
+        }
+        InspectNominalGeometry::getDistances(points, distances);
+    }
+
+    float distance;
+    mutable std::atomic<int> chunks {0};
+    // cancels this inspection when it gets the first chunk
+    Inspection::DistanceInspection* inspection {nullptr};
+};
+
+TEST_F(InspectionTest, shapeDistancesOfBox)
+{
+    TopoDS_Solid box = BRepPrimAPI_MakeBox(10.0, 10.0, 10.0).Solid();
+    testShape(box, Base::Vector3f(5.0F, 5.0F, 5.0F));
+}
+
+TEST_F(InspectionTest, shapeDistancesOfSphere)
+{
+    TopoDS_Solid sphere = BRepPrimAPI_MakeSphere(10.0).Solid();
+    testShape(sphere, Base::Vector3f());
+}
+
+TEST_F(InspectionTest, shapeIsNotTessellated)
+{
+    TopoDS_Solid sphere = BRepPrimAPI_MakeSphere(10.0).Solid();
+    Inspection::InspectNominalShape nominal(sphere, radius);
+    EXPECT_LT(nominal.getDistance(Base::Vector3f()), 0.0F);
+    for (TopExp_Explorer xp(sphere, TopAbs_FACE); xp.More(); xp.Next()) {
+        TopLoc_Location loc;
+        EXPECT_TRUE(BRep_Tool::Triangulation(TopoDS::Face(xp.Current()), loc).IsNull());
+    }
+}
+
+TEST_F(InspectionTest, meshDistancesOfBox)
+{
+    TopoDS_Solid box = BRepPrimAPI_MakeBox(10.0, 10.0, 10.0).Solid();
+    testMesh(box, Base::Vector3f(5.0F, 5.0F, 5.0F));
+}
+
+TEST_F(InspectionTest, meshDistancesOfSphere)
+{
+    TopoDS_Solid sphere = BRepPrimAPI_MakeSphere(10.0).Solid();
+    testMesh(sphere, Base::Vector3f());
+}
+
+TEST_F(InspectionTest, inspectChunks)
+{
+    const unsigned long count = 3 * Inspection::DistanceInspection::ChunkSize + 5;
+    Points::PointKernel kernel;
+    std::vector<Base::Vector3f> points(count);
+    kernel.swap(points);
+    Inspection::InspectActualPoints actual(kernel);
+
+    ConstantNominal nominal(0.5F);
+    Inspection::DistanceInspection inside(radius, actual, {&nominal});
+    ConstantNominal farNominal(-2.0F);
+    Inspection::DistanceInspection outside(radius, actual, {&farNominal});
+
+    EXPECT_TRUE(inside.perform());
+    EXPECT_EQ(nominal.chunks.load(), 4);
+    EXPECT_EQ(inside.getDistances(), std::vector<float>(count, 0.5F));
+    EXPECT_DOUBLE_EQ(inside.getRMS(), 0.5);
+
+    EXPECT_TRUE(outside.perform());
+    EXPECT_EQ(outside.getDistances(),
+              std::vector<float>(count, -std::numeric_limits<float>::max()));
+    EXPECT_DOUBLE_EQ(outside.getRMS(), 0.0);
+}
+
+TEST_F(InspectionTest, cancelInspection)
+{
+    const unsigned long numChunks = 64;
+    Points::PointKernel kernel;
+    std::vector<Base::Vector3f> points(numChunks * Inspection::DistanceInspection::ChunkSize);
+    kernel.swap(points);
+    Inspection::InspectActualPoints actual(kernel);
+
+    ConstantNominal nominal(0.5F);
+    Inspection::DistanceInspection inspection(radius, actual, {&nominal});
+    nominal.inspection = &inspection;
+
+    // only the chunks that are already running when it's canceled are computed
+    EXPECT_FALSE(inspection.perform());
+    EXPECT_TRUE(inspection.isCanceled());
+    EXPECT_GE(nominal.chunks.load(), 1);
+    EXPECT_LT(nominal.chunks.load(), int(numChunks));
+}
+
+// NOLINTEND(cppcoreguidelines-*,readability-*)
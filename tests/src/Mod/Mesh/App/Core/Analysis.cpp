@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include <Mod/Mesh/App/Core/Analysis.h>
+#include <Mod/Mesh/App/Core/Evaluation.h>
+#include <Mod/Mesh/App/Core/MeshKernel.h>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+
+class AnalysisTest: public ::testing::Test
+{
+protected:
+    // adds an axis-aligned box with outward pointing normals
+    static void addBox(std::vector<MeshCore::MeshGeomFacet>& facets,
+                       const Base::Vector3f& pos,
+                       const Base::Vector3f& size)
+    {
+        auto corner = [&](int x, int y, int z) {
+            return Base::Vector3f(pos.x + float(x) * size.x,
+                                  pos.y + float(y) * size.y,
+                                  pos.z + float(z) * size.z);
+        };
+
+        facets.emplace_back(corner(0, 0, 0), corner(0, 1, 0), corner(1, 1, 0));  // bottom
+        facets.emplace_back(corner(0, 0, 0), corner(1, 1, 0), corner(1, 0, 0));
+        facets.emplace_back(corner(0, 0, 1), corner(1, 0, 1), corner(1, 1, 1));  // top
+        facets.emplace_back(corner(0, 0, 1), corner(1, 1, 1), corner(0, 1, 1));
+        facets.emplace_back(corner(0, 0, 0), corner(1, 0, 0), corner(1, 0, 1));  // front
+        facets.emplace_back(corner(0, 0, 0), corner(1, 0, 1), corner(0, 0, 1));
+        facets.emplace_back(corner(0, 1, 0), corner(0, 1, 1), corner(1, 1, 1));  // back
+        facets.emplace_back(corner(0, 1, 0), corner(1, 1, 1), corner(1, 1, 0));
+        facets.emplace_back(corner(0, 0, 0), corner(0, 0, 1), corner(0, 1, 1));  // left
+        facets.emplace_back(corner(0, 0, 0), corner(0, 1, 1), corner(0, 1, 0));
+        facets.emplace_back(corner(1, 0, 0), corner(1, 1, 0), corner(1, 1, 1));  // right
+        facets.emplace_back(corner(1, 0, 0), corner(1, 1, 1), corner(1, 0, 1));
+    }
+
+    // two overlapping boxes, a fin at a box edge and a degenerated facet
+    static MeshCore::MeshKernel makeDefectMesh()
+    {
+        std::vector<MeshCore::MeshGeomFacet> facets;
+        addBox(facets, Base::Vector3f(0.F, 0.F, 0.F), Base::Vector3f(1.F, 1.F, 1.F));
+        addBox(facets, Base::Vector3f(0.5F, 0.3F, 0.2F), Base::Vector3f(1.F, 1.F, 1.F));
+        facets.emplace_back(Base::Vector3f(0.F, 0.F, 0.F),
+                            Base::Vector3f(-1.F, -1.F, 0.5F),
+                            Base::Vector3f(0.F, 0.F, 1.F));
+        facets.emplace_back(Base::Vector3f(5.F, 5.F, 5.F),
+                            Base::Vector3f(6.F, 5.F, 5.F),
+                            Base::Vector3f(7.F, 5.F, 5.F));
+
+        MeshCore::MeshKernel kernel;
+        kernel = facets;
+        return kernel;
+    }
+};
+
+TEST_F(AnalysisTest, TestSameResultsAsEvaluation)
+{
+    MeshCore::MeshKernel kernel = makeDefectMesh();
+    MeshCore::MeshAnalysis analysis(kernel);
+
+    std::vector<std::pair<MeshCore::FacetIndex, MeshCore::FacetIndex>> pairs;
+    MeshCore::MeshEvalSelfIntersection selfEval(kernel);
+    selfEval.GetIntersections(pairs);
+    EXPECT_FALSE(pairs.empty());
+    EXPECT_EQ(analysis.GetSelfIntersections(), pairs);
+
+    MeshCore::MeshEvalTopology topoEval(kernel);
+    EXPECT_FALSE(topoEval.Evaluate());
+    EXPECT_EQ(analysis.GetNonManifolds(), topoEval.GetFacets());
+
+    ASSERT_EQ(analysis.GetDegeneratedFacets().size(), 1);
+    EXPECT_EQ(analysis.GetDegeneratedFacets().front(), kernel.CountFacets() - 1);
+}
+
+TEST_F(AnalysisTest, TestRemoveFacets)
+{
+    MeshCore::MeshKernel kernel = makeDefectMesh();
+    MeshCore::MeshAnalysis analysis(kernel);
+    ASSERT_TRUE(analysis.HasSelfIntersections());
+    ASSERT_TRUE(analysis.HasNonManifolds());
+    ASSERT_TRUE(analysis.HasDegeneratedFacets());
+
+    // remove a facet of each box and the fin
+    std::vector<MeshCore::FacetIndex> removed {3, 17, 24};
+    kernel.DeleteFacets(removed);
+    analysis.RemoveFacets(removed);
+
+    MeshCore::MeshAnalysis fresh(kernel);
+    EXPECT_EQ(analysis.GetSelfIntersections(), fresh.GetSelfIntersections());
+    EXPECT_EQ(analysis.GetNonManifolds(), fresh.GetNonManifolds());
+    EXPECT_EQ(analysis.GetDegeneratedFacets(), fresh.GetDegeneratedFacets());
+    EXPECT_FALSE(analysis.HasNonManifolds());
+    EXPECT_EQ(analysis.GetBVH().CountFacets(), kernel.CountFacets());
+}
+
+TEST_F(AnalysisTest, TestFixSelfIntersections)
+{
+    MeshCore::MeshKernel kernel = makeDefectMesh();
+    MeshCore::MeshAnalysis analysis(kernel);
+
+    MeshCore::MeshFixSelfIntersection fix(kernel, analysis.GetSelfIntersections());
+    fix.Fixup();
+    EXPECT_FALSE(fix.GetDeletedFaces().empty());
+    analysis.RemoveFacets(fix.GetDeletedFaces());
+
+    EXPECT_FALSE(analysis.HasSelfIntersections());
+    MeshCore::MeshEvalSelfIntersection eval(kernel);
+    EXPECT_TRUE(eval.Evaluate());
+}
+
+TEST_F(AnalysisTest, TestUnreportedChange)
+{
+    MeshCore::MeshKernel kernel = makeDefectMesh();
+    MeshCore::MeshAnalysis analysis(kernel);
+    ASSERT_TRUE(analysis.HasDegeneratedFacets());
+
+    // the analysis notices that the number of facets has changed
+    kernel.DeleteFacets({kernel.CountFacets() - 1});
+    EXPECT_FALSE(analysis.HasDegeneratedFacets());
+}
+
+// NOLINTEND(cppcoreguidelines-*,readability-*)
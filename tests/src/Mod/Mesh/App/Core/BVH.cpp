@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <Mod/Mesh/App/Core/BVH.h>
+#include <Mod/Mesh/App/Core/MeshKernel.h>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+
+class BVHTest: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // unit cube with outward pointing normals
+        Base::Vector3f p000(0.F, 0.F, 0.F);
+        Base::Vector3f p100(1.F, 0.F, 0.F);
+        Base::Vector3f p010(0.F, 1.F, 0.F);
+        Base::Vector3f p110(1.F, 1.F, 0.F);
+        Base::Vector3f p001(0.F, 0.F, 1.F);
+        Base::Vector3f p101(1.F, 0.F, 1.F);
+        Base::Vector3f p011(0.F, 1.F, 1.F);
+        Base::Vector3f p111(1.F, 1.F, 1.F);
+
+        std::vector<MeshCore::MeshGeomFacet> facets;
+        facets.emplace_back(p000, p010, p110);  // bottom
+        facets.emplace_back(p000, p110, p100);
+        facets.emplace_back(p001, p101, p111);  // top
+        facets.emplace_back(p001, p111, p011);
+        facets.emplace_back(p000, p100, p101);  // front
+        facets.emplace_back(p000, p101, p001);
+        facets.emplace_back(p010, p011, p111);  // back
+        facets.emplace_back(p010, p111, p110);
+        facets.emplace_back(p000, p001, p011);  // left
+        facets.emplace_back(p000, p011, p010);
+        facets.emplace_back(p100, p110, p111);  // right
+        facets.emplace_back(p100, p111, p101);
+        kernel = facets;
+    }
+
+    void TearDown() override
+    {}
+
+    const MeshCore::MeshKernel& GetKernel() const
+    {
+        return kernel;
+    }
+
+private:
+    MeshCore::MeshKernel kernel;
+};
+
+TEST_F(BVHTest, TestBVHEmpty)
+{
+    MeshCore::MeshFacetBVH bvh;
+    EXPECT_EQ(bvh.IsEmpty(), true);
+
+    Base::Vector3f res;
+    MeshCore::FacetIndex facet {};
+    EXPECT_EQ(bvh.NearestFacetOnRay(Base::Vector3f(), Base::Vector3f(0.F, 0.F, 1.F), res, facet),
+              false);
+    EXPECT_EQ(bvh.NearestFacetToPoint(Base::Vector3f(), res), MeshCore::FACET_INDEX_MAX);
+    EXPECT_EQ(bvh.IsInside(Base::Vector3f()), false);
+}
+
+TEST_F(BVHTest, TestBVHBuild)
+{
+    MeshCore::MeshFacetBVH bvh(GetKernel());
+    EXPECT_EQ(bvh.IsEmpty(), false);
+    EXPECT_EQ(bvh.CountFacets(), 12);
+
+    Base::BoundBox3f box = bvh.GetBoundBox();
+    EXPECT_FLOAT_EQ(box.MinX, 0.F);
+    EXPECT_FLOAT_EQ(box.MaxZ, 1.F);
+}
+
+TEST_F(BVHTest, TestBVHNearestFacetOnRay)
+{
+    MeshCore::MeshFacetBVH bvh(GetKernel());
+
+    Base::Vector3f res;
+    MeshCore::FacetIndex facet {};
+    EXPECT_EQ(bvh.NearestFacetOnRay(Base::Vector3f(0.25F, 0.5F, 2.F),
+                                    Base::Vector3f(0.F, 0.F, -1.F),
+                                    res,
+                                    facet),
+              true);
+    EXPECT_FLOAT_EQ(res.z, 1.F);
+    EXPECT_TRUE(facet == 2 || facet == 3);
+
+    // the ray points away from the cube
+    EXPECT_EQ(bvh.NearestFacetOnRay(Base::Vector3f(0.25F, 0.5F, 2.F),
+                                    Base::Vector3f(0.F, 0.F, 1.F),
+                                    res,
+                                    facet),
+              false);
+}
+
+TEST_F(BVHTest, TestBVHNearestFacetsOnRays)
+{
+    MeshCore::MeshFacetBVH bvh(GetKernel());
+
+    std::vector<MeshCore::MeshFacetBVH::Ray> rays;
+    rays.push_back({Base::Vector3f(0.5F, 0.25F, -1.F), Base::Vector3f(0.F, 0.F, 1.F)});
+    rays.push_back({Base::Vector3f(2.F, 2.F, 2.F), Base::Vector3f(1.F, 0.F, 0.F)});
+
+    std::vector<MeshCore::MeshFacetBVH::RayHit> hits;
+    bvh.NearestFacetsOnRays(rays, hits);
+    EXPECT_EQ(hits.size(), 2);
+    EXPECT_TRUE(hits[0].facet == 0 || hits[0].facet == 1);
+    EXPECT_FLOAT_EQ(hits[0].point.z, 0.F);
+    EXPECT_EQ(hits[1].facet, MeshCore::FACET_INDEX_MAX);
+}
+
+TEST_F(BVHTest, TestBVHNearestFacetToPoint)
+{
+    MeshCore::MeshFacetBVH bvh(GetKernel());
+
+    Base::Vector3f res;
+    MeshCore::FacetIndex facet = bvh.NearestFacetToPoint(Base::Vector3f(2.F, 0.5F, 0.25F), res);
+    EXPECT_TRUE(facet == 10 || facet == 11);
+    EXPECT_FLOAT_EQ(res.x, 1.F);
+
+    facet = bvh.NearestFacetToPoint(Base::Vector3f(2.F, 0.5F, 0.25F), res, 0.5F);
+    EXPECT_EQ(facet, MeshCore::FACET_INDEX_MAX);
+}
+
+TEST_F(BVHTest, TestBVHIsInside)
+{
+    MeshCore::MeshFacetBVH bvh(GetKernel());
+    EXPECT_EQ(bvh.IsInside(Base::Vector3f(0.5F, 0.5F, 0.5F)), true);
+    EXPECT_EQ(bvh.IsInside(Base::Vector3f(0.1F, 0.9F, 0.2F)), true);
+    EXPECT_EQ(bvh.IsInside(Base::Vector3f(1.5F, 0.5F, 0.5F)), false);
+    EXPECT_EQ(bvh.IsInside(Base::Vector3f(0.5F, 0.5F, -0.1F)), false);
+}
+
+TEST_F(BVHTest, TestBVHInside)
+{
+    MeshCore::MeshFacetBVH bvh(GetKernel());
+
+    std::vector<MeshCore::FacetIndex> facets;
+    bvh.Inside(Base::BoundBox3f(0.2F, 0.2F, 0.9F, 0.8F, 0.8F, 1.1F), facets);
+    std::sort(facets.begin(), facets.end());
+    EXPECT_EQ(facets, std::vector<MeshCore::FacetIndex>({2, 3}));
+}
+
+TEST_F(BVHTest, TestBVHRemoveFacets)
+{
+    MeshCore::MeshFacetBVH bvh(GetKernel());
+
+    // remove the bottom and the front, the top facets are renumbered to 0 and 1
+    bvh.RemoveFacets({0, 1, 4, 5});
+    EXPECT_EQ(bvh.CountFacets(), 8);
+
+    std::vector<MeshCore::FacetIndex> facets;
+    bvh.Inside(Base::BoundBox3f(0.2F, 0.2F, 0.9F, 0.8F, 0.8F, 1.1F), facets);
+    std::sort(facets.begin(), facets.end());
+    EXPECT_EQ(facets, std::vector<MeshCore::FacetIndex>({0, 1}));
+
+    Base::Vector3f res;
+    MeshCore::FacetIndex facet {};
+    EXPECT_EQ(bvh.NearestFacetOnRay(Base::Vector3f(0.5F, 0.25F, -1.F),
+                                    Base::Vector3f(0.F, 0.F, 1.F),
+                                    res,
+                                    facet),
+              true);
+    EXPECT_FLOAT_EQ(res.z, 1.F);
+    EXPECT_TRUE(facet == 0 || facet == 1);
+
+    bvh.RemoveFacets({0, 1, 2, 3, 4, 5, 6, 7});
+    EXPECT_EQ(bvh.IsEmpty(), true);
+}
+
+TEST_F(BVHTest, TestBVHTransform)
+{
+    Base::Matrix4D mat;
+    mat.move(Base::Vector3d(10.0, 0.0, 0.0));
+    MeshCore::MeshFacetBVH bvh(GetKernel(), mat);
+    EXPECT_EQ(bvh.IsInside(Base::Vector3f(10.5F, 0.5F, 0.5F)), true);
+    EXPECT_EQ(bvh.IsInside(Base::Vector3f(0.5F, 0.5F, 0.5F)), false);
+}
+
+// NOLINTEND(cppcoreguidelines-*,readability-*)
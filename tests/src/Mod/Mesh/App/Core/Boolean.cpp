@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <Mod/Mesh/App/Core/Boolean.h>
+#include <Mod/Mesh/App/Core/Evaluation.h>
+#include <Mod/Mesh/App/Core/MeshKernel.h>
+#include <Mod/Mesh/App/Core/TopoAlgorithm.h>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+
+class BooleanTest: public ::testing::Test
+{
+protected:
+    // axis-aligned box with outward pointing normals
+    static MeshCore::MeshKernel makeBox(const Base::Vector3f& pos, const Base::Vector3f& size)
+    {
+        auto corner = [&](int x, int y, int z) {
+            return Base::Vector3f(pos.x + float(x) * size.x,
+                                  pos.y + float(y) * size.y,
+                                  pos.z + float(z) * size.z);
+        };
+
+        std::vector<MeshCore::MeshGeomFacet> facets;
+        facets.emplace_back(corner(0, 0, 0), corner(0, 1, 0), corner(1, 1, 0));  // bottom
+        facets.emplace_back(corner(0, 0, 0), corner(1, 1, 0), corner(1, 0, 0));
+        facets.emplace_back(corner(0, 0, 1), corner(1, 0, 1), corner(1, 1, 1));  // top
+        facets.emplace_back(corner(0, 0, 1), corner(1, 1, 1), corner(0, 1, 1));
+        facets.emplace_back(corner(0, 0, 0), corner(1, 0, 0), corner(1, 0, 1));  // front
+        facets.emplace_back(corner(0, 0, 0), corner(1, 0, 1), corner(0, 0, 1));
+        facets.emplace_back(corner(0, 1, 0), corner(0, 1, 1), corner(1, 1, 1));  // back
+        facets.emplace_back(corner(0, 1, 0), corner(1, 1, 1), corner(1, 1, 0));
+        facets.emplace_back(corner(0, 0, 0), corner(0, 0, 1), corner(0, 1, 1));  // left
+        facets.emplace_back(corner(0, 0, 0), corner(0, 1, 1), corner(0, 1, 0));
+        facets.emplace_back(corner(1, 0, 0), corner(1, 1, 0), corner(1, 1, 1));  // right
+        facets.emplace_back(corner(1, 0, 0), corner(1, 1, 1), corner(1, 0, 1));
+
+        MeshCore::MeshKernel kernel;
+        kernel = facets;
+        return kernel;
+    }
+
+    // checks the volume of the result and that a non-empty result is a closed 2-manifold
+    static void checkResult(const MeshCore::MeshKernel& mesh1,
+                            const MeshCore::MeshKernel& mesh2,
+                            MeshCore::MeshBoolean::OperationType type,
+                            float volume)
+    {
+        MeshCore::MeshKernel result;
+        MeshCore::MeshBoolean boolean(mesh1, mesh2, result, type);
+        boolean.Do();
+
+        EXPECT_NEAR(result.GetVolume(), volume, 1.0e-4F);
+        if (result.CountFacets() > 0) {
+            MeshCore::MeshEvalSolid eval(result);
+            EXPECT_EQ(eval.Evaluate(), true);
+            MeshCore::MeshEvalTopology topo(result);
+            EXPECT_EQ(topo.Evaluate(), true);
+        }
+    }
+};
+
+TEST_F(BooleanTest, TestOverlappingBoxes)
+{
+    auto box1 = makeBox(Base::Vector3f(0.F, 0.F, 0.F), Base::Vector3f(1.F, 1.F, 1.F));
+    auto box2 = makeBox(Base::Vector3f(0.5F, 0.3F, 0.2F), Base::Vector3f(1.F, 1.F, 1.F));
+    const float common = 0.5F * 0.7F * 0.8F;
+
+    checkResult(box1, box2, MeshCore::MeshBoolean::Union, 2.F - common);
+    checkResult(box1, box2, MeshCore::MeshBoolean::Intersect, common);
+    checkResult(box1, box2, MeshCore::MeshBoolean::Difference, 1.F - common);
+}
+
+TEST_F(BooleanTest, TestCoplanarFaces)
+{
+    auto box1 = makeBox(Base::Vector3f(0.F, 0.F, 0.F), Base::Vector3f(1.F, 1.F, 1.F));
+    auto box2 = makeBox(Base::Vector3f(0.5F, 0.F, 0.F), Base::Vector3f(1.F, 1.F, 1.F));
+
+    checkResult(box1, box2, MeshCore::MeshBoolean::Union, 1.5F);
+    checkResult(box1, box2, MeshCore::MeshBoolean::Intersect, 0.5F);
+    checkResult(box1, box2, MeshCore::MeshBoolean::Difference, 0.5F);
+}
+
+TEST_F(BooleanTest, TestIdenticalBoxes)
+{
+    auto box = makeBox(Base::Vector3f(0.F, 0.F, 0.F), Base::Vector3f(1.F, 1.F, 1.F));
+
+    checkResult(box, box, MeshCore::MeshBoolean::Union, 1.F);
+    checkResult(box, box, MeshCore::MeshBoolean::Intersect, 1.F);
+    checkResult(box, box, MeshCore::MeshBoolean::Difference, 0.F);
+}
+
+TEST_F(BooleanTest, TestTouchingBoxes)
+{
+    auto box1 = makeBox(Base::Vector3f(0.F, 0.F, 0.F), Base::Vector3f(1.F, 1.F, 1.F));
+    auto box2 = makeBox(Base::Vector3f(1.F, 0.F, 0.F), Base::Vector3f(1.F, 1.F, 1.F));
+
+    checkResult(box1, box2, MeshCore::MeshBoolean::Union, 2.F);
+    checkResult(box1, box2, MeshCore::MeshBoolean::Intersect, 0.F);
+    checkResult(box1, box2, MeshCore::MeshBoolean::Difference, 1.F);
+}
+
+TEST_F(BooleanTest, TestPocket)
+{
+    auto box1 = makeBox(Base::Vector3f(0.F, 0.F, 0.F), Base::Vector3f(1.F, 1.F, 1.F));
+    auto box2 = makeBox(Base::Vector3f(0.25F, 0.25F, 0.5F), Base::Vector3f(0.5F, 0.5F, 0.5F));
+
+    checkResult(box1, box2, MeshCore::MeshBoolean::Union, 1.F);
+    checkResult(box1, box2, MeshCore::MeshBoolean::Intersect, 0.125F);
+    checkResult(box1, box2, MeshCore::MeshBoolean::Difference, 0.875F);
+}
+
+TEST_F(BooleanTest, TestThreadsGiveSameResult)
+{
+    auto box1 = makeBox(Base::Vector3f(0.F, 0.F, 0.F), Base::Vector3f(1.F, 1.F, 1.F));
+    auto box2 = makeBox(Base::Vector3f(0.5F, 0.3F, 0.2F), Base::Vector3f(1.F, 1.F, 1.F));
+
+    MeshCore::MeshKernel result1;
+    MeshCore::MeshBoolean serial(box1, box2, result1, MeshCore::MeshBoolean::Union);
+    serial.SetThreads(1);
+    serial.Do();
+
+    MeshCore::MeshKernel result2;
+    MeshCore::MeshBoolean parallel(box1, box2, result2, MeshCore::MeshBoolean::Union);
+    parallel.SetThreads(4);
+    parallel.Do();
+
+    EXPECT_GT(serial.CountCutFacets(), 0);
+    EXPECT_EQ(serial.CountCutFacets(), parallel.CountCutFacets());
+    ASSERT_EQ(result1.CountPoints(), result2.CountPoints());
+    ASSERT_EQ(result1.CountFacets(), result2.CountFacets());
+    for (std::size_t i = 0; i < result1.CountPoints(); i++) {
+        const auto& p1 = result1.GetPoints()[i];
+        const auto& p2 = result2.GetPoints()[i];
+        EXPECT_EQ(p1.x, p2.x);
+        EXPECT_EQ(p1.y, p2.y);
+        EXPECT_EQ(p1.z, p2.z);
+    }
+    for (std::size_t i = 0; i < result1.CountFacets(); i++) {
+        for (int j = 0; j < 3; j++) {
+            EXPECT_EQ(result1.GetFacets()[i]._aulPoints[j], result2.GetFacets()[i]._aulPoints[j]);
+        }
+    }
+}
+
+TEST_F(BooleanTest, TestValidInput)
+{
+    MeshCore::MeshKernel box = makeBox(Base::Vector3f(0, 0, 0), Base::Vector3f(1, 1, 1));
+    EXPECT_TRUE(MeshCore::MeshBoolean::IsValidInput(box));
+    EXPECT_FALSE(MeshCore::MeshBoolean::IsValidInput(MeshCore::MeshKernel()));
+
+    // inwards pointing normals
+    MeshCore::MeshKernel flipped(box);
+    MeshCore::MeshTopoAlgorithm(flipped).FlipNormals();
+    EXPECT_FALSE(MeshCore::MeshBoolean::IsValidInput(flipped));
+
+    // open mesh
+    MeshCore::MeshKernel open(box);
+    open.DeleteFacet(0);
+    EXPECT_FALSE(MeshCore::MeshBoolean::IsValidInput(open));
+}
+
+// NOLINTEND(cppcoreguidelines-*,readability-*)
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <Base/Exception.h>
+#include <Base/FileInfo.h>
+#include <Base/Stream.h>
+#include <Mod/Mesh/App/Core/Decimation.h>
+#include <Mod/Mesh/App/Core/Evaluation.h>
+#include <Mod/Mesh/App/Core/MeshIO.h>
+#include <Mod/Mesh/App/Core/MeshKernel.h>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+
+class DecimationTest: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        input.setFile(Base::FileInfo::getTempFileName() + ".stl");
+        output.setFile(Base::FileInfo::getTempFileName() + ".stl");
+
+        // closed torus
+        const int nu = 200;
+        const int nv = 100;
+        auto point = [&](int i, int j) {
+            double u = 2.0 * M_PI * (i % nu) / nu;
+            double v = 2.0 * M_PI * (j % nv) / nv;
+            return Base::Vector3f(float((3.0 + std::cos(v)) * std::cos(u)),
+                                  float((3.0 + std::cos(v)) * std::sin(u)),
+                                  float(std::sin(v)));
+        };
+
+        std::vector<MeshCore::MeshGeomFacet> facets;
+        for (int i = 0; i < nu; i++) {
+            for (int j = 0; j < nv; j++) {
+                facets.emplace_back(point(i, j), point(i + 1, j), point(i + 1, j + 1));
+                facets.emplace_back(point(i, j), point(i + 1, j + 1), point(i, j + 1));
+            }
+        }
+
+        MeshCore::MeshKernel kernel;
+        kernel = facets;
+        MeshCore::MeshOutput out(kernel);
+        Base::ofstream str(input, std::ios::out | std::ios::binary);
+        out.SaveBinarySTL(str);
+    }
+
+    void TearDown() override
+    {
+        input.deleteFile();
+        output.deleteFile();
+    }
+
+    Base::FileInfo input;
+    Base::FileInfo output;
+};
+
+TEST_F(DecimationTest, TestStreamSimplify)
+{
+    MeshCore::MeshStreamSimplify simplify;
+    simplify.SetReduction(0.75F);
+    // force many chunks
+    simplify.SetMemoryBudget(1 << 20);
+    std::size_t count = simplify.simplify(input.filePath(), output.filePath());
+    EXPECT_LT(count, 40000);
+    EXPECT_GT(count, 0);
+
+    MeshCore::MeshKernel kernel;
+    MeshCore::MeshInput in(kernel);
+    EXPECT_EQ(in.LoadAny(output.filePath().c_str()), true);
+    EXPECT_EQ(kernel.CountFacets(), count);
+
+    // the chunks are stitched without gaps
+    MeshCore::MeshEvalSolid eval(kernel);
+    EXPECT_EQ(eval.Evaluate(), true);
+    MeshCore::MeshEvalTopology topo(kernel);
+    EXPECT_EQ(topo.Evaluate(), true);
+}
+
+TEST_F(DecimationTest, TestParallelSimplify)
+{
+    MeshCore::MeshKernel kernel;
+    MeshCore::MeshInput in(kernel);
+    EXPECT_EQ(in.LoadAny(input.filePath().c_str()), true);
+
+    MeshCore::MeshSimplify simplify(kernel);
+    simplify.SetThreads(4);
+    simplify.simplify(4000);
+    EXPECT_LE(kernel.CountFacets(), 4000);
+    EXPECT_GT(kernel.CountFacets(), 3000);
+
+    // the borders of the regions are merged again
+    MeshCore::MeshEvalSolid eval(kernel);
+    EXPECT_EQ(eval.Evaluate(), true);
+    MeshCore::MeshEvalTopology topo(kernel);
+    EXPECT_EQ(topo.Evaluate(), true);
+}
+
+TEST_F(DecimationTest, TestStreamSimplifyUnsupported)
+{
+    Base::FileInfo ascii(Base::FileInfo::getTempFileName() + ".stl");
+    {
+        Base::ofstream str(ascii, std::ios::out);
+        str << "solid\nendsolid\n";
+    }
+
+    MeshCore::MeshStreamSimplify simplify;
+    EXPECT_THROW(simplify.simplify(ascii.filePath(), output.filePath()), Base::FileException);
+    ascii.deleteFile();
+}
+
+// NOLINTEND(cppcoreguidelines-*,readability-*)
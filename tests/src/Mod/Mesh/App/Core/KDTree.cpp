@@ -88,4 +88,29 @@ TEST_F(KDTreeTest, TestKDTreeFindRange)
     tree.FindInRange(Base::Vector3f(0.5F, 0, 0), 0.6F, index);
     EXPECT_EQ(index, result);
 }
+
+TEST_F(KDTreeTest, TestKDTreeBatched)
+{
+    MeshCore::MeshKDTree tree(GetPoints());
+    tree.AddPoint(Base::Vector3f(2.F, 0.F, 0.F));
+
+    std::vector<Base::Vector3f> queries {Base::Vector3f(0.9F, 0.1F, 0.1F),
+                                         Base::Vector3f(1.9F, 0.F, 0.F)};
+    std::vector<MeshCore::PointIndex> indices;
+    std::vector<float> distances;
+    tree.FindNearest(queries, 2, indices, distances, 0.5F);
+    std::vector<MeshCore::PointIndex> result = {4,
+                                                MeshCore::POINT_INDEX_MAX,
+                                                8,
+                                                MeshCore::POINT_INDEX_MAX};
+    EXPECT_EQ(indices, result);
+    EXPECT_FLOAT_EQ(distances[2], 0.1F);
+
+    std::vector<std::size_t> offsets;
+    tree.FindInRadius(queries, 1.F, offsets, indices);
+    EXPECT_EQ(offsets, std::vector<std::size_t>({0, 4, 6}));
+    // points at the same distance are sorted by their index
+    result = {4, 0, 5, 6, 8, 4};
+    EXPECT_EQ(indices, result);
+}
 // NOLINTEND(cppcoreguidelines-*,readability-*)
@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <Mod/Mesh/App/Core/Approximation.h>
+#include <Mod/Mesh/App/Core/MeshKernel.h>
+#include <Mod/Mesh/App/Core/Segmentation.h>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+
+class SegmentationTest: public ::testing::Test
+{
+protected:
+    // unit cube with n x n quads on each side
+    static MeshCore::MeshKernel makeCube(int n)
+    {
+        std::vector<MeshCore::MeshGeomFacet> facets;
+        auto addSide = [&](const Base::Vector3f& org,
+                           const Base::Vector3f& u,
+                           const Base::Vector3f& v) {
+            auto pnt = [&](int i, int j) {
+                return org + u * (float(i) / float(n)) + v * (float(j) / float(n));
+            };
+            for (int j = 0; j < n; j++) {
+                for (int i = 0; i < n; i++) {
+                    facets.emplace_back(pnt(i, j), pnt(i + 1, j), pnt(i + 1, j + 1));
+                    facets.emplace_back(pnt(i, j), pnt(i + 1, j + 1), pnt(i, j + 1));
+                }
+            }
+        };
+
+        Base::Vector3f ex(1.F, 0.F, 0.F), ey(0.F, 1.F, 0.F), ez(0.F, 0.F, 1.F);
+        addSide(Base::Vector3f(0.F, 0.F, 0.F), ey, ex);
+        addSide(Base::Vector3f(0.F, 0.F, 1.F), ex, ey);
+        addSide(Base::Vector3f(0.F, 0.F, 0.F), ex, ez);
+        addSide(Base::Vector3f(0.F, 1.F, 0.F), ez, ex);
+        addSide(Base::Vector3f(0.F, 0.F, 0.F), ez, ey);
+        addSide(Base::Vector3f(1.F, 0.F, 0.F), ey, ez);
+
+        MeshCore::MeshKernel kernel;
+        kernel = facets;
+        return kernel;
+    }
+
+    // UV sphere with n rings
+    static MeshCore::MeshKernel makeSphere(float radius, int n)
+    {
+        MeshCore::MeshPointArray points;
+        MeshCore::MeshFacetArray facets;
+        points.push_back(Base::Vector3f(0.F, 0.F, radius));
+        points.push_back(Base::Vector3f(0.F, 0.F, -radius));
+        for (int i = 1; i < n; i++) {
+            for (int j = 0; j < 2 * n; j++) {
+                double theta = M_PI * i / n;
+                double phi = M_PI * j / n;
+                points.push_back(Base::Vector3f(float(radius * std::sin(theta) * std::cos(phi)),
+                                                float(radius * std::sin(theta) * std::sin(phi)),
+                                                float(radius * std::cos(theta))));
+            }
+        }
+        auto id = [n](int i, int j) {
+            return MeshCore::PointIndex(2 + (i - 1) * 2 * n + (j % (2 * n)));
+        };
+        for (int j = 0; j < 2 * n; j++) {
+            facets.push_back(MeshCore::MeshFacet(0, id(1, j), id(1, j + 1)));
+            facets.push_back(MeshCore::MeshFacet(1, id(n - 1, j + 1), id(n - 1, j)));
+        }
+        for (int i = 1; i + 1 < n; i++) {
+            for (int j = 0; j < 2 * n; j++) {
+                facets.push_back(MeshCore::MeshFacet(id(i, j), id(i + 1, j), id(i + 1, j + 1)));
+                facets.push_back(MeshCore::MeshFacet(id(i, j), id(i + 1, j + 1), id(i, j + 1)));
+            }
+        }
+
+        MeshCore::MeshKernel kernel;
+        kernel.Adopt(points, facets, true);
+        return kernel;
+    }
+
+    static std::vector<MeshCore::MeshSegment> findPlanes(const MeshCore::MeshKernel& kernel,
+                                                         int threads)
+    {
+        std::vector<MeshCore::MeshSurfaceSegmentPtr> segm;
+        segm.emplace_back(std::make_shared<MeshCore::MeshDistanceGenericSurfaceFitSegment>(
+            new MeshCore::PlaneSurfaceFit,
+            kernel,
+            10,
+            0.01F));
+        MeshCore::MeshSegmentAlgorithm finder(kernel);
+        finder.SetThreads(threads);
+        finder.FindSegments(segm);
+        return segm.front()->GetSegments();
+    }
+};
+
+TEST_F(SegmentationTest, TestPointMoments)
+{
+    MeshCore::PointMoments moments;
+    for (int i = 0; i < 10; i++) {
+        for (int j = 0; j < 10; j++) {
+            moments.AddPoint(Base::Vector3f(100.F + float(i), 50.F + float(j), 20.F));
+        }
+    }
+
+    Base::Vector3f base, normal;
+    EXPECT_FLOAT_EQ(moments.FitPlane(base, normal), 0.F);
+    EXPECT_FLOAT_EQ(std::fabs(normal.z), 1.F);
+    EXPECT_FLOAT_EQ(base.z, 20.F);
+
+    // points of a plane don't define a sphere
+    Base::Vector3f center;
+    float radius {};
+    EXPECT_EQ(moments.FitSphere(center, radius), std::numeric_limits<float>::max());
+
+    moments.Clear();
+    MeshCore::MeshKernel sphere = makeSphere(3.F, 20);
+    for (const auto& pnt : sphere.GetPoints()) {
+        moments.AddPoint(pnt + Base::Vector3f(10.F, 20.F, 30.F));
+    }
+    EXPECT_LT(moments.FitSphere(center, radius), 1e-4F);
+    EXPECT_NEAR(radius, 3.F, 1e-4F);
+    EXPECT_NEAR(Base::Distance(center, Base::Vector3f(10.F, 20.F, 30.F)), 0.F, 1e-4F);
+}
+
+TEST_F(SegmentationTest, TestPlanesOfCube)
+{
+    MeshCore::MeshKernel kernel = makeCube(8);
+    std::vector<MeshCore::MeshSegment> segments = findPlanes(kernel, 1);
+    ASSERT_EQ(segments.size(), 6);
+    for (const auto& segment : segments) {
+        EXPECT_EQ(segment.size(), 128);
+    }
+}
+
+TEST_F(SegmentationTest, TestSameSegmentsWithThreads)
+{
+    MeshCore::MeshKernel kernel = makeCube(20);
+    std::vector<MeshCore::MeshSegment> segments = findPlanes(kernel, 1);
+    EXPECT_EQ(findPlanes(kernel, 2), segments);
+    EXPECT_EQ(findPlanes(kernel, 5), segments);
+
+    // many small regions of alternating curvature
+    MeshCore::MeshKernel sphere = makeSphere(2.F, 40);
+    std::vector<MeshCore::CurvatureInfo> info(sphere.CountPoints());
+    for (std::size_t index = 0; index < info.size(); index++) {
+        info[index].fMaxCurvature = (index / 7) % 3 == 0 ? 1.F : 0.5F;
+        info[index].fMinCurvature = (index / 5) % 2 == 0 ? 0.5F : 0.F;
+    }
+
+    auto findFreeform = [&](int threads) {
+        std::vector<MeshCore::MeshSurfaceSegmentPtr> segm;
+        segm.emplace_back(std::make_shared<MeshCore::MeshCurvatureFreeformSegment>(info,
+                                                                                    2,
+                                                                                    0.1F,
+                                                                                    0.1F,
+                                                                                    0.5F,
+                                                                                    0.F));
+        segm.emplace_back(std::make_shared<MeshCore::MeshCurvatureFreeformSegment>(info,
+                                                                                    2,
+                                                                                    0.1F,
+                                                                                    0.1F,
+                                                                                    1.F,
+                                                                                    0.5F));
+        MeshCore::MeshSegmentAlgorithm finder(sphere);
+        finder.SetThreads(threads);
+        finder.FindSegments(segm);
+        return std::make_pair(segm[0]->GetSegments(), segm[1]->GetSegments());
+    };
+
+    auto freeform = findFreeform(1);
+    EXPECT_GT(freeform.first.size(), 10);
+    EXPECT_GT(freeform.second.size(), 10);
+    EXPECT_EQ(findFreeform(3), freeform);
+    EXPECT_EQ(findFreeform(8), freeform);
+}
+
+TEST_F(SegmentationTest, TestSphere)
+{
+    MeshCore::MeshKernel kernel = makeSphere(2.F, 40);
+    auto fit = std::make_shared<MeshCore::MeshDistanceGenericSurfaceFitSegment>(
+        new MeshCore::SphereSurfaceFit,
+        kernel,
+        10,
+        0.01F);
+    std::vector<MeshCore::MeshSurfaceSegmentPtr> segm {fit};
+    MeshCore::MeshSegmentAlgorithm finder(kernel);
+    finder.FindSegments(segm);
+
+    ASSERT_EQ(fit->GetSegments().size(), 1);
+    EXPECT_EQ(fit->GetSegments().front().size(), kernel.CountFacets());
+    std::vector<float> param = fit->Parameters();
+    ASSERT_EQ(param.size(), 4);
+    EXPECT_NEAR(param[3], 2.F, 0.01F);
+}
+
+// NOLINTEND(cppcoreguidelines-*,readability-*)
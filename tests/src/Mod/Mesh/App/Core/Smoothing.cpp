@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <Mod/Mesh/App/Core/Curvature.h>
+#include <Mod/Mesh/App/Core/MeshKernel.h>
+#include <Mod/Mesh/App/Core/Smoothing.h>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+
+class SmoothingTest: public ::testing::Test
+{
+protected:
+    // n x n grid in the xy plane with some noise in z
+    static MeshCore::MeshKernel makeGrid(int n, float noise)
+    {
+        MeshCore::MeshPointArray points;
+        MeshCore::MeshFacetArray facets;
+        std::srand(1);
+        for (int j = 0; j < n; j++) {
+            for (int i = 0; i < n; i++) {
+                float z = noise * (float(std::rand()) / float(RAND_MAX) - 0.5F);
+                points.push_back(Base::Vector3f(float(i), float(j), z));
+            }
+        }
+        auto id = [n](int i, int j) {
+            return MeshCore::PointIndex(j * n + i);
+        };
+        for (int j = 0; j + 1 < n; j++) {
+            for (int i = 0; i + 1 < n; i++) {
+                facets.push_back(MeshCore::MeshFacet(id(i, j), id(i + 1, j), id(i + 1, j + 1)));
+                facets.push_back(MeshCore::MeshFacet(id(i, j), id(i + 1, j + 1), id(i, j + 1)));
+            }
+        }
+
+        MeshCore::MeshKernel kernel;
+        kernel.Adopt(points, facets, true);
+        return kernel;
+    }
+
+    // UV sphere with n rings
+    static MeshCore::MeshKernel makeSphere(float radius, int n)
+    {
+        MeshCore::MeshPointArray points;
+        MeshCore::MeshFacetArray facets;
+        points.push_back(Base::Vector3f(0.F, 0.F, radius));
+        points.push_back(Base::Vector3f(0.F, 0.F, -radius));
+        for (int i = 1; i < n; i++) {
+            for (int j = 0; j < 2 * n; j++) {
+                double theta = M_PI * i / n;
+                double phi = M_PI * j / n;
+                points.push_back(Base::Vector3f(float(radius * std::sin(theta) * std::cos(phi)),
+                                                float(radius * std::sin(theta) * std::sin(phi)),
+                                                float(radius * std::cos(theta))));
+            }
+        }
+        auto id = [n](int i, int j) {
+            return MeshCore::PointIndex(2 + (i - 1) * 2 * n + (j % (2 * n)));
+        };
+        for (int j = 0; j < 2 * n; j++) {
+            facets.push_back(MeshCore::MeshFacet(0, id(1, j), id(1, j + 1)));
+            facets.push_back(MeshCore::MeshFacet(1, id(n - 1, j + 1), id(n - 1, j)));
+        }
+        for (int i = 1; i + 1 < n; i++) {
+            for (int j = 0; j < 2 * n; j++) {
+                facets.push_back(MeshCore::MeshFacet(id(i, j), id(i + 1, j), id(i + 1, j + 1)));
+                facets.push_back(MeshCore::MeshFacet(id(i, j), id(i + 1, j + 1), id(i, j + 1)));
+            }
+        }
+
+        MeshCore::MeshKernel kernel;
+        kernel.Adopt(points, facets, true);
+        return kernel;
+    }
+
+    static float maxHeight(const MeshCore::MeshKernel& kernel)
+    {
+        float height = 0.F;
+        for (const auto& pnt : kernel.GetPoints()) {
+            height = std::max(height, std::fabs(pnt.z));
+        }
+        return height;
+    }
+};
+
+TEST_F(SmoothingTest, TestLaplaceFlattensGrid)
+{
+    MeshCore::MeshKernel kernel = makeGrid(20, 0.1F);
+    MeshCore::MeshKernel original = kernel;
+
+    MeshCore::LaplaceSmoothing smooth(kernel);
+    smooth.Smooth(10);
+
+    // border points keep their position
+    for (MeshCore::PointIndex index = 0; index < 20; index++) {
+        EXPECT_EQ(kernel.GetPoint(index), original.GetPoint(index));
+    }
+    EXPECT_LT(maxHeight(kernel), maxHeight(original));
+}
+
+TEST_F(SmoothingTest, TestLaplaceSmoothPoints)
+{
+    MeshCore::MeshKernel kernel = makeGrid(20, 0.1F);
+    MeshCore::MeshKernel original = kernel;
+
+    // only the point in the middle is moved
+    MeshCore::PointIndex center = 10 * 20 + 10;
+    MeshCore::LaplaceSmoothing smooth(kernel);
+    smooth.SmoothPoints(1, {center});
+
+    for (MeshCore::PointIndex index = 0; index < kernel.CountPoints(); index++) {
+        if (index != center) {
+            EXPECT_EQ(kernel.GetPoint(index), original.GetPoint(index));
+        }
+    }
+    EXPECT_NE(kernel.GetPoint(center), original.GetPoint(center));
+}
+
+TEST_F(SmoothingTest, TestTaubinKeepsSize)
+{
+    MeshCore::MeshKernel kernel = makeSphere(2.F, 40);
+    float volume = kernel.GetVolume();
+
+    MeshCore::TaubinSmoothing smooth(kernel);
+    smooth.Smooth(10);
+
+    EXPECT_NEAR(kernel.GetVolume(), volume, 0.01F * volume);
+}
+
+TEST_F(SmoothingTest, TestMedianFilterFlattensGrid)
+{
+    MeshCore::MeshKernel kernel = makeGrid(20, 0.1F);
+    float height = maxHeight(kernel);
+
+    MeshCore::MedianFilterSmoothing smooth(kernel);
+    smooth.Smooth(3);
+
+    EXPECT_LT(maxHeight(kernel), height);
+}
+
+TEST_F(SmoothingTest, TestCurvaturePerVertex)
+{
+    MeshCore::MeshKernel kernel = makeSphere(2.F, 60);
+
+    MeshCore::MeshCurvature curvature(kernel);
+    curvature.ComputePerVertex();
+    const std::vector<MeshCore::CurvatureInfo>& info = curvature.GetCurvature();
+    ASSERT_EQ(info.size(), kernel.CountPoints());
+
+    // a point on the equator
+    const MeshCore::CurvatureInfo& ci = info[2 + 29 * 120];
+    EXPECT_NEAR(ci.fMinCurvature, 0.5F, 0.05F);
+    EXPECT_NEAR(ci.fMaxCurvature, 0.5F, 0.05F);
+}
+
+// NOLINTEND(cppcoreguidelines-*,readability-*)
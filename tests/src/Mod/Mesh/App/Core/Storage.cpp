@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <Mod/Mesh/App/Core/Elements.h>
+#include <Mod/Mesh/App/Core/Storage.h>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+
+class StorageTest: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // a fan of four triangles around point 0 and a degenerated facet
+        points.push_back(MeshCore::MeshPoint(Base::Vector3f(0.F, 0.F, 0.F)));
+        points.push_back(MeshCore::MeshPoint(Base::Vector3f(1.F, 0.F, 0.F)));
+        points.push_back(MeshCore::MeshPoint(Base::Vector3f(0.F, 1.F, 0.F)));
+        points.push_back(MeshCore::MeshPoint(Base::Vector3f(-1.F, 0.F, 0.F)));
+        points.push_back(MeshCore::MeshPoint(Base::Vector3f(0.F, -1.F, 0.F)));
+        facets.push_back(MeshCore::MeshFacet(0, 1, 2));
+        facets.push_back(MeshCore::MeshFacet(0, 2, 3));
+        facets.push_back(MeshCore::MeshFacet(0, 3, 4));
+        facets.push_back(MeshCore::MeshFacet(0, 4, 1));
+        facets.push_back(MeshCore::MeshFacet(1, 1, 2));
+    }
+
+    void TearDown() override
+    {}
+
+    MeshCore::MeshPointArray points;
+    MeshCore::MeshFacetArray facets;
+};
+
+TEST_F(StorageTest, TestFlagPlane)
+{
+    MeshCore::MeshFlagPlane plane(130);
+    EXPECT_EQ(plane.Size(), 130);
+    EXPECT_EQ(plane.Count(), 0);
+
+    plane.Set(0);
+    plane.Set(64);
+    plane.Set(129, true);
+    EXPECT_EQ(plane.Get(64), true);
+    EXPECT_EQ(plane.Get(65), false);
+    EXPECT_EQ(plane.Count(), 3);
+    EXPECT_EQ(plane.FindFirstUnset(), 1);
+    EXPECT_EQ(plane.FindFirstUnset(64), 65);
+
+    plane.Unset(64);
+    EXPECT_EQ(plane.Count(), 2);
+
+    plane.Resize(100);
+    EXPECT_EQ(plane.Count(), 1);
+
+    plane.Reset();
+    EXPECT_EQ(plane.Count(), 0);
+}
+
+TEST_F(StorageTest, TestFlagPlaneFull)
+{
+    MeshCore::MeshFlagPlane plane(64);
+    for (std::size_t i = 0; i < 64; i++) {
+        plane.Set(i);
+    }
+    EXPECT_EQ(plane.FindFirstUnset(), 64);
+}
+
+TEST_F(StorageTest, TestPointColumns)
+{
+    MeshCore::MeshPointColumns columns(points);
+    EXPECT_EQ(columns.Size(), 5);
+    EXPECT_EQ(columns.Get(3), Base::Vector3f(-1.F, 0.F, 0.F));
+
+    columns.Set(3, 1.F, 2.F, 3.F);
+    EXPECT_FLOAT_EQ(columns.X()[3], 1.F);
+    EXPECT_FLOAT_EQ(columns.Y()[3], 2.F);
+    EXPECT_FLOAT_EQ(columns.Z()[3], 3.F);
+}
+
+TEST_F(StorageTest, TestFacetColumns)
+{
+    MeshCore::MeshFacetColumns columns(facets);
+    EXPECT_EQ(columns.Size(), 5);
+    EXPECT_EQ(columns.GetPoints(1)[2], 3);
+    EXPECT_EQ(columns.GetNeighbours(1)[0], MeshCore::FACET_INDEX_MAX);
+}
+
+TEST_F(StorageTest, TestPointNeighbours)
+{
+    MeshCore::MeshPointNeighbours neighbours(points.size(), MeshCore::MeshFacetColumns(facets));
+    EXPECT_EQ(neighbours.Size(), 5);
+
+    auto pts = neighbours.GetPoints(0);
+    EXPECT_EQ(std::vector<MeshCore::PointIndex>(pts.begin(), pts.end()),
+              std::vector<MeshCore::PointIndex>({1, 2, 3, 4}));
+    auto fts = neighbours.GetFacets(0);
+    EXPECT_EQ(std::vector<MeshCore::FacetIndex>(fts.begin(), fts.end()),
+              std::vector<MeshCore::FacetIndex>({0, 1, 2, 3}));
+
+    // the degenerated facet doesn't make point 1 its own neighbour
+    pts = neighbours.GetPoints(1);
+    EXPECT_EQ(std::vector<MeshCore::PointIndex>(pts.begin(), pts.end()),
+              std::vector<MeshCore::PointIndex>({0, 2, 4}));
+    fts = neighbours.GetFacets(1);
+    EXPECT_EQ(std::vector<MeshCore::FacetIndex>(fts.begin(), fts.end()),
+              std::vector<MeshCore::FacetIndex>({0, 3, 4}));
+}
+
+// NOLINTEND(cppcoreguidelines-*,readability-*)
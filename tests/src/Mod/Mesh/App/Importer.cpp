@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 #include <Base/FileInfo.h>
+#include <sstream>
 #include <Mod/Mesh/App/Core/IO/Reader3MF.h>
+#include <Mod/Mesh/App/Core/IO/ReaderPLY.h>
+#include <Mod/Mesh/App/Core/MeshIO.h>
 #include <xercesc/util/PlatformUtils.hpp>
 #include <zipios++/fcoll.h>
 
@@ -14,6 +17,127 @@ protected:
 };
 
 // NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+namespace
+{
+MeshCore::MeshKernel makeCube()
+{
+    Base::Vector3f p000(0.F, 0.F, 0.F);
+    Base::Vector3f p100(1.F, 0.F, 0.F);
+    Base::Vector3f p010(0.F, 1.F, 0.F);
+    Base::Vector3f p110(1.F, 1.F, 0.F);
+    Base::Vector3f p001(0.F, 0.F, 1.F);
+    Base::Vector3f p101(1.F, 0.F, 1.F);
+    Base::Vector3f p011(0.F, 1.F, 1.F);
+    Base::Vector3f p111(1.F, 1.F, 1.F);
+
+    std::vector<MeshCore::MeshGeomFacet> facets;
+    facets.emplace_back(p000, p010, p110);
+    facets.emplace_back(p000, p110, p100);
+    facets.emplace_back(p001, p101, p111);
+    facets.emplace_back(p001, p111, p011);
+    facets.emplace_back(p000, p100, p101);
+    facets.emplace_back(p000, p101, p001);
+    facets.emplace_back(p010, p011, p111);
+    facets.emplace_back(p010, p111, p110);
+    facets.emplace_back(p000, p001, p011);
+    facets.emplace_back(p000, p011, p010);
+    facets.emplace_back(p100, p110, p111);
+    facets.emplace_back(p100, p111, p101);
+
+    MeshCore::MeshKernel kernel;
+    kernel = facets;
+    return kernel;
+}
+
+void expectSameMesh(const MeshCore::MeshKernel& mesh1, const MeshCore::MeshKernel& mesh2)
+{
+    ASSERT_EQ(mesh1.CountPoints(), mesh2.CountPoints());
+    ASSERT_EQ(mesh1.CountFacets(), mesh2.CountFacets());
+    for (MeshCore::PointIndex i = 0; i < mesh1.CountPoints(); i++) {
+        EXPECT_EQ(Base::Vector3f(mesh1.GetPoint(i)), Base::Vector3f(mesh2.GetPoint(i)));
+    }
+    const MeshCore::MeshFacetArray& facets1 = mesh1.GetFacets();
+    const MeshCore::MeshFacetArray& facets2 = mesh2.GetFacets();
+    for (std::size_t i = 0; i < facets1.size(); i++) {
+        for (int j = 0; j < 3; j++) {
+            EXPECT_EQ(facets1[i]._aulPoints[j], facets2[i]._aulPoints[j]);
+            EXPECT_EQ(facets1[i]._aulNeighbours[j], facets2[i]._aulNeighbours[j]);
+        }
+    }
+}
+}  // namespace
+
+TEST_F(ImporterTest, TestBinarySTLFromMemory)
+{
+    std::stringstream str;
+    MeshCore::MeshOutput output(makeCube());
+    EXPECT_EQ(output.SaveBinarySTL(str), true);
+    std::string data = str.str();
+
+    MeshCore::MeshKernel mesh1;
+    MeshCore::MeshInput input1(mesh1);
+    EXPECT_EQ(input1.LoadSTL(str), true);
+
+    MeshCore::MeshKernel mesh2;
+    MeshCore::MeshInput input2(mesh2);
+    EXPECT_EQ(input2.LoadBinarySTL(data.data(), data.size()), true);
+    EXPECT_EQ(mesh2.CountPoints(), 8);
+    EXPECT_EQ(mesh2.CountFacets(), 12);
+    expectSameMesh(mesh1, mesh2);
+
+    // truncated data
+    MeshCore::MeshKernel mesh3;
+    MeshCore::MeshInput input3(mesh3);
+    EXPECT_EQ(input3.LoadBinarySTL(data.data(), data.size() - 1), false);
+}
+
+TEST_F(ImporterTest, TestAsciiSTLFromMemory)
+{
+    std::stringstream str;
+    MeshCore::MeshOutput output(makeCube());
+    EXPECT_EQ(output.SaveAsciiSTL(str), true);
+    std::string data = str.str();
+
+    // ASCII files are left to the stream-based reader
+    MeshCore::MeshKernel mesh;
+    MeshCore::MeshInput input(mesh);
+    EXPECT_EQ(input.LoadBinarySTL(data.data(), data.size()), false);
+    EXPECT_EQ(mesh.CountFacets(), 0);
+}
+
+TEST_F(ImporterTest, TestBinaryPLYFromMemory)
+{
+    std::stringstream str;
+    MeshCore::MeshOutput output(makeCube());
+    EXPECT_EQ(output.SaveBinaryPLY(str), true);
+    std::string data = str.str();
+
+    MeshCore::MeshKernel mesh1;
+    MeshCore::ReaderPLY reader1(mesh1);
+    EXPECT_EQ(reader1.Load(str), true);
+
+    MeshCore::MeshKernel mesh2;
+    MeshCore::ReaderPLY reader2(mesh2);
+    EXPECT_EQ(reader2.Load(data.data(), data.size()), true);
+    EXPECT_EQ(mesh2.CountPoints(), 8);
+    EXPECT_EQ(mesh2.CountFacets(), 12);
+    expectSameMesh(mesh1, mesh2);
+}
+
+TEST_F(ImporterTest, TestAsciiPLYFromMemory)
+{
+    std::stringstream str;
+    MeshCore::MeshOutput output(makeCube());
+    EXPECT_EQ(output.SaveAsciiPLY(str), true);
+    std::string data = str.str();
+
+    // ASCII files are left to the stream-based reader
+    MeshCore::MeshKernel mesh;
+    MeshCore::ReaderPLY reader(mesh);
+    EXPECT_EQ(reader.Load(data.data(), data.size()), false);
+    EXPECT_EQ(mesh.CountFacets(), 0);
+}
+
 TEST_F(ImporterTest, Test3MF)
 {
     std::string file(DATADIR);
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <Mod/Mesh/App/Mesh.h>
+#include <Mod/Mesh/App/Core/Evaluation.h>
 #include <Mod/Mesh/App/Core/Grid.h>
 
 // NOLINTBEGIN(cppcoreguidelines-*,readability-*)
@@ -95,4 +96,74 @@ TEST(MeshTest, TestGrid2OfAlmostPlanarMesh)
     EXPECT_EQ(countY, 1);
     EXPECT_EQ(countZ, 1);
 }
+
+TEST(MeshTest, TestRebuildNeighbours)
+{
+    // a planar grid of n x n quads, each split into two facets
+    const MeshCore::PointIndex n = 40;
+    MeshCore::MeshPointArray points;
+    for (MeshCore::PointIndex i = 0; i <= n; i++) {
+        for (MeshCore::PointIndex j = 0; j <= n; j++) {
+            points.push_back(MeshCore::MeshPoint(Base::Vector3f(float(i), float(j), 0)));
+        }
+    }
+    MeshCore::MeshFacetArray facets;
+    for (MeshCore::PointIndex i = 0; i < n; i++) {
+        for (MeshCore::PointIndex j = 0; j < n; j++) {
+            MeshCore::PointIndex p0 = i * (n + 1) + j;
+            MeshCore::PointIndex p1 = p0 + n + 1;
+            facets.push_back(MeshCore::MeshFacet(p0, p1, p1 + 1));
+            facets.push_back(MeshCore::MeshFacet(p0, p1 + 1, p0 + 1));
+        }
+    }
+
+    MeshCore::MeshKernel kernel;
+    kernel.Adopt(points, facets, true);
+    EXPECT_EQ(kernel.CountFacets(), 2 * n * n);
+
+    // compare with the neighbours found by testing all pairs of facets
+    const MeshCore::MeshFacetArray& rFacets = kernel.GetFacets();
+    for (MeshCore::FacetIndex f = 0; f < rFacets.size(); f++) {
+        for (unsigned short side = 0; side < 3; side++) {
+            MeshCore::PointIndex p0 = rFacets[f]._aulPoints[side];
+            MeshCore::PointIndex p1 = rFacets[f]._aulPoints[(side + 1) % 3];
+            MeshCore::FacetIndex expected = MeshCore::FACET_INDEX_MAX;
+            for (MeshCore::FacetIndex g = 0; g < rFacets.size(); g++) {
+                if (g != f && rFacets[g].HasPoint(p0) && rFacets[g].HasPoint(p1)) {
+                    expected = g;
+                }
+            }
+            EXPECT_EQ(rFacets[f]._aulNeighbours[side], expected);
+        }
+    }
+
+    MeshCore::MeshEvalNeighbourhood eval(kernel);
+    EXPECT_TRUE(eval.Evaluate());
+}
+
+TEST(MeshTest, TestRebuildNeighboursNonManifold)
+{
+    // three facets share the edge (0, 1)
+    MeshCore::MeshPointArray points;
+    points.push_back(MeshCore::MeshPoint(Base::Vector3f(0, 0, 0)));
+    points.push_back(MeshCore::MeshPoint(Base::Vector3f(1, 0, 0)));
+    points.push_back(MeshCore::MeshPoint(Base::Vector3f(0, 1, 0)));
+    points.push_back(MeshCore::MeshPoint(Base::Vector3f(0, -1, 0)));
+    points.push_back(MeshCore::MeshPoint(Base::Vector3f(0, 0, 1)));
+    MeshCore::MeshFacetArray facets;
+    facets.push_back(MeshCore::MeshFacet(0, 1, 2));
+    facets.push_back(MeshCore::MeshFacet(1, 0, 3));
+    facets.push_back(MeshCore::MeshFacet(1, 0, 4));
+
+    MeshCore::MeshKernel kernel;
+    kernel.Adopt(points, facets, true);
+
+    const MeshCore::MeshFacetArray& rFacets = kernel.GetFacets();
+    EXPECT_EQ(rFacets[0]._aulNeighbours[0], MeshCore::FACET_INDEX_MAX);
+    EXPECT_EQ(rFacets[0]._aulNeighbours[1], MeshCore::FACET_INDEX_MAX);
+
+    MeshCore::MeshEvalTopology eval(kernel);
+    EXPECT_FALSE(eval.Evaluate());
+    EXPECT_EQ(eval.GetFacets().size(), 1);
+}
 // NOLINTEND(cppcoreguidelines-*,readability-*)
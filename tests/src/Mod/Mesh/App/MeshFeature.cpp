@@ -1,5 +1,6 @@
 #include "gtest/gtest.h"
 #include <src/App/InitApplication.h>
+#include <memory>
 #include <Mod/Mesh/App/MeshFeature.h>
 
 class MeshFeatureTest: public ::testing::Test
@@ -15,6 +16,15 @@ protected:
 
     void TearDown() override
     {}
+
+    static MeshCore::MeshKernel makeTriangle()
+    {
+        MeshCore::MeshKernel kernel;
+        kernel.AddFacet(MeshCore::MeshGeomFacet(Base::Vector3f(0, 0, 0),
+                                                Base::Vector3f(1, 0, 0),
+                                                Base::Vector3f(0, 1, 0)));
+        return kernel;
+    }
 };
 
 // NOLINTBEGIN(cppcoreguidelines-*,readability-*)
@@ -37,4 +47,50 @@ TEST_F(MeshFeatureTest, getComplexElementTypes)
     EXPECT_STREQ(types[0], "Mesh");
     EXPECT_STREQ(types[1], "Segment");
 }
+
+TEST_F(MeshFeatureTest, changeKeepsMeshObjectOfCopiedProperty)
+{
+    Mesh::Feature mf;
+    mf.Mesh.setValue(makeTriangle());
+    const Mesh::MeshObject* mesh = &mf.Mesh.getValue();
+    std::unique_ptr<App::Property> copy(mf.Mesh.Copy());
+    auto snapshot = static_cast<Mesh::PropertyMeshKernel*>(copy.get());
+    EXPECT_EQ(snapshot->getValuePtr(), mesh);
+
+    Base::Matrix4D mat;
+    mat.move(Base::Vector3d(1, 0, 0));
+    mf.Mesh.transformGeometry(mat);
+
+    // the copy takes the old mesh, references to the value stay valid
+    EXPECT_EQ(&mf.Mesh.getValue(), mesh);
+    EXPECT_NE(snapshot->getValuePtr(), mesh);
+    EXPECT_EQ(mf.Mesh.getValue().getKernel().GetPoint(0), Base::Vector3f(1, 0, 0));
+    EXPECT_EQ(snapshot->getValue().getKernel().GetPoint(0), Base::Vector3f(0, 0, 0));
+}
+
+TEST_F(MeshFeatureTest, pasteKeepsMeshObject)
+{
+    Mesh::Feature mf;
+    mf.Mesh.setValue(makeTriangle());
+    const Mesh::MeshObject* mesh = &mf.Mesh.getValue();
+    std::unique_ptr<App::Property> copy(mf.Mesh.Copy());
+    mf.Mesh.setValue(MeshCore::MeshKernel());
+
+    mf.Mesh.Paste(*copy);
+
+    EXPECT_EQ(&mf.Mesh.getValue(), mesh);
+    EXPECT_EQ(mf.Mesh.getValue().countFacets(), 1);
+}
+
+TEST_F(MeshFeatureTest, destroyedPropertyKeepsMeshOfCopy)
+{
+    std::unique_ptr<App::Property> copy;
+    {
+        Mesh::Feature mf;
+        mf.Mesh.setValue(makeTriangle());
+        copy.reset(mf.Mesh.Copy());
+    }
+    auto snapshot = static_cast<Mesh::PropertyMeshKernel*>(copy.get());
+    EXPECT_EQ(snapshot->getValue().countFacets(), 1);
+}
 // NOLINTEND(cppcoreguidelines-*,readability-*)
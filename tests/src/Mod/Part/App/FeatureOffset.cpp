@@ -3,12 +3,45 @@
 #include <gtest/gtest.h>
 
 #include <src/App/InitApplication.h>
+#include <App/RecomputeCache.h>
+#include <Base/FileInfo.h>
+#include <Base/Stream.h>
 
 #include "PartTestHelpers.h"
 #include "Mod/Part/App/FeatureOffset.h"
+#include "Mod/Part/App/FeaturePartImportBrep.h"
 
 using namespace PartTestHelpers;
 
+// Enables the recompute cache in the transient directory of the document
+class RecomputeCacheEnabler
+{
+public:
+    explicit RecomputeCacheEnabler(App::Document* doc)
+        : _hGrp(App::GetApplication().GetParameterGroupByPath(
+            "User parameter:BaseApp/Preferences/Document"))
+    {
+        _enabled = _hGrp->GetBool("RecomputeCache", false);
+        _path = _hGrp->GetASCII("RecomputeCacheDir");
+        std::string path = std::string(doc->TransientDir.getValue()) + "/RecomputeCache";
+        _hGrp->SetBool("RecomputeCache", true);
+        _hGrp->SetASCII("RecomputeCacheDir", path.c_str());
+    }
+    ~RecomputeCacheEnabler()
+    {
+        App::RecomputeCache::clear();
+        _hGrp->SetBool("RecomputeCache", _enabled);
+        _hGrp->SetASCII("RecomputeCacheDir", _path.c_str());
+    }
+    RecomputeCacheEnabler(const RecomputeCacheEnabler&) = delete;
+    RecomputeCacheEnabler& operator=(const RecomputeCacheEnabler&) = delete;
+
+private:
+    ParameterGrp::handle _hGrp;
+    bool _enabled {};
+    std::string _path;
+};
+
 // NOLINTBEGIN(readability-magic-numbers,cppcoreguidelines-avoid-magic-numbers)
 class FeatureOffsetTest: public ::testing::Test, public PartTestHelperClass
 {
@@ -94,4 +127,54 @@ TEST_F(FeatureOffsetTest, testOffset2D)
     EXPECT_EQ(_offset2->Shape.getShape().getElementMapSize(), 0);
 }
 
+TEST_F(FeatureOffsetTest, testOffsetRestoredFromRecomputeCache)
+{
+    // Arrange
+    RecomputeCacheEnabler enabler(_doc);
+    _doc->recompute();
+    // replace the cached result with a bigger offset at another placement
+    auto other = _doc->addObject<Part::Offset>();
+    other->Source.setValue(_boxes[0]);
+    other->Value.setValue(2);
+    other->Join.setValue((int)JoinType::intersection);
+    other->Placement.setValue(Base::Placement(Base::Vector3d(5, 0, 0), Base::Rotation()));
+    other->recomputeFeature();
+    std::string fileName =
+        App::RecomputeCache::getCachePath() + App::RecomputeCache().getKey(_offset) + ".fcrc";
+    {
+        Base::FileInfo fi(fileName);
+        Base::ofstream file(fi, std::ios::out | std::ios::trunc | std::ios::binary);
+        ASSERT_TRUE(other->saveRecomputeResult(file));
+    }
+    _offset->touch();
+    // Act
+    _doc->recompute();
+    // Assert the cached shape is used but the placement of the offset is kept.
+    // A 1x2x3 box 3doffset by 2 becomes a 5x6x7 box, so volume is 210.
+    EXPECT_NEAR(getVolume(_offset->Shape.getShape().getShape()), 210, 1e-6);
+    EXPECT_EQ(_offset->Placement.getValue(), Base::Placement());
+    EXPECT_TRUE(boxesMatch(_offset->Shape.getShape().getBoundBox(),
+                           Base::BoundBox3d(-2, -2, -2, 3, 4, 5)));
+    EXPECT_FALSE(_offset->isError());
+}
+
+TEST_F(FeatureOffsetTest, testOffsetOfChangedFileExecutes)
+{
+    // Arrange
+    RecomputeCacheEnabler enabler(_doc);
+    std::string fileName = std::string(_doc->TransientDir.getValue()) + "/box.brep";
+    TopoShape(BRepPrimAPI_MakeBox(1, 2, 3).Shape()).exportBrep(fileName.c_str());
+    auto import = _doc->addObject<Part::ImportBrep>();
+    import->FileName.setValue(fileName);
+    _offset->Source.setValue(import);
+    _doc->recompute();
+    // Act
+    TopoShape(BRepPrimAPI_MakeBox(2, 2, 3).Shape()).exportBrep(fileName.c_str());
+    import->touch();
+    _doc->recompute();
+    // Assert the offset isn't restored from the result of the old file.
+    // A 2x2x3 box 3doffset by 1 becomes a 4x4x5 box, so volume is 80.
+    EXPECT_NEAR(getVolume(_offset->Shape.getShape().getShape()), 80, 1e-6);
+}
+
 // NOLINTEND(readability-magic-numbers,cppcoreguidelines-avoid-magic-numbers)
@@ -1,7 +1,10 @@
 // SPDX-License-Identifier: LGPL-2.1-or-later
 
 #include <gtest/gtest.h>
+#include <mutex>
+#include <thread>
 
+#include <App/Application.h>
 #include "Mod/Part/App/PartFeatures.h"
 #include <src/App/InitApplication.h>
 
@@ -205,3 +208,38 @@ TEST_F(PartFeaturesTest, testReverse)
     // Assert element map is correct
     EXPECT_EQ(0, elementMap.size());  // TODO: Expect this to be non-zero.
 }
+
+TEST_F(PartFeaturesTest, testParallelRecomputeOfPrimitives)
+{
+    // Arrange
+    auto hGrp = App::GetApplication().GetParameterGroupByPath(
+        "User parameter:BaseApp/Preferences/Document");
+    bool parallel = hGrp->GetBool("ParallelRecompute", false);
+    hGrp->SetBool("ParallelRecompute", true);
+    // the property signal is emitted by the thread that executes the object
+    std::mutex mutex;
+    std::vector<std::thread::id> execThreads;
+    std::vector<boost::signals2::scoped_connection> conns;
+    for (auto box : _boxes) {
+        conns.emplace_back(box->Shape.signalChanged.connect([&](const App::Property&) {
+            std::lock_guard<std::mutex> lock(mutex);
+            execThreads.push_back(std::this_thread::get_id());
+        }));
+    }
+    // Act
+    bool hasError = false;
+    int count = _doc->recompute({}, false, &hasError);
+    conns.clear();
+    hGrp->SetBool("ParallelRecompute", parallel);
+    // Assert
+    EXPECT_FALSE(hasError);
+    EXPECT_EQ(count, int(_boxes.size()));
+    EXPECT_GE(execThreads.size(), _boxes.size());
+    for (auto id : execThreads) {
+        EXPECT_NE(id, std::this_thread::get_id());
+    }
+    for (auto box : _boxes) {
+        EXPECT_FALSE(box->isTouched());
+        EXPECT_DOUBLE_EQ(getVolume(box->Shape.getShape().getShape()), 6.0);
+    }
+}
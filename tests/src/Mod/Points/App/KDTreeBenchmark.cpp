@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <set>
+#include <Base/KDTree.h>
+#include <Mod/Points/App/Points.h>
+#include <Mod/Points/App/PointsGrid.h>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+
+// Compares the nearest neighbour search of Base::KDTree with the one of PointsGrid. The benchmark
+// needs a lot of memory and time and is therefore disabled, it's run with:
+//
+// Points_tests_run --gtest_also_run_disabled_tests --gtest_filter=*KDTreeBenchmark*
+//
+// FC_KDTREE_BENCHMARK_POINTS   number of points, default 100 million
+// FC_KDTREE_BENCHMARK_QUERIES  number of queries, default 1 million
+class KDTreeBenchmark: public ::testing::Test
+{
+protected:
+    static std::size_t env(const char* name, std::size_t value)
+    {
+        const char* str = std::getenv(name);
+        return str ? std::size_t(std::strtoull(str, nullptr, 10)) : value;
+    }
+
+    static std::vector<Base::Vector3f> makePoints(std::size_t count, unsigned int seed)
+    {
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<float> coord(0.F, 100.F);
+        std::vector<Base::Vector3f> points(count);
+        for (auto& pnt : points) {
+            pnt.Set(coord(generator), coord(generator), 0.1F * coord(generator));
+        }
+        return points;
+    }
+
+    template<typename Func>
+    static double measure(Func&& func)
+    {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+        return duration.count();
+    }
+};
+
+TEST_F(KDTreeBenchmark, DISABLED_NearestNeighbours)
+{
+    std::size_t numPoints = env("FC_KDTREE_BENCHMARK_POINTS", 100000000);
+    std::size_t numQueries = env("FC_KDTREE_BENCHMARK_QUERIES", 1000000);
+
+    Points::PointKernel kernel;
+    std::vector<Base::Vector3f> points = makePoints(numPoints, 1);
+    kernel.swap(points);
+    std::vector<Base::Vector3f> queries = makePoints(numQueries, 2);
+
+    // the grid search is done point by point as in the existing algorithms
+    Points::PointsGrid grid;
+    double gridBuild = measure([&]() {
+        grid.Attach(kernel);
+    });
+    std::vector<float> gridDist(numQueries, std::numeric_limits<float>::max());
+    double gridQuery = measure([&]() {
+        std::set<unsigned long> indices;
+        for (std::size_t i = 0; i < numQueries; i++) {
+            Base::Vector3d pnt(queries[i].x, queries[i].y, queries[i].z);
+            grid.SearchNearestFromPoint(pnt, indices);
+            for (unsigned long index : indices) {
+                float dist = float(Base::Distance(pnt, kernel.getPoint(int(index))));
+                gridDist[i] = std::min(gridDist[i], dist);
+            }
+        }
+    });
+
+    Base::KDTree tree;
+    double treeBuild = measure([&]() {
+        tree.build(kernel.getBasicPoints().data(), kernel.size());
+    });
+    std::vector<Base::KDTree::index_type> indices(numQueries * 16);
+    std::vector<float> treeDist(numQueries * 16);
+    double treeQuery = measure([&]() {
+        tree.findNearest(queries.data(), numQueries, 1, indices.data(), treeDist.data());
+    });
+    double treeQuery16 = measure([&]() {
+        tree.findNearest(queries.data(), numQueries, 16, indices.data(), treeDist.data());
+    });
+
+    std::cout << numPoints << " points, " << numQueries << " queries\n"
+              << "PointsGrid: build " << gridBuild << " s, nearest " << gridQuery << " s\n"
+              << "KDTree:     build " << treeBuild << " s, nearest " << treeQuery
+              << " s, 16 nearest " << treeQuery16 << " s\n";
+
+    // the first of the 16 neighbours is the nearest point
+    for (std::size_t i = 0; i < numQueries; i++) {
+        ASSERT_LE(treeDist[16 * i], gridDist[i] + 1e-4F);
+    }
+}
+
+// NOLINTEND(cppcoreguidelines-*,readability-*)
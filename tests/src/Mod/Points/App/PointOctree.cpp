@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <tuple>
+#include <Base/Exception.h>
+#include <Mod/Points/App/PointOctree.h>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+
+class PointOctreeTest: public ::testing::Test
+{
+protected:
+    static std::vector<Base::Vector3f> makePoints(std::size_t count)
+    {
+        std::mt19937 generator(1);
+        std::uniform_real_distribution<float> coord(-10.F, 10.F);
+        std::vector<Base::Vector3f> points;
+        for (std::size_t index = 0; index < count; index++) {
+            points.emplace_back(coord(generator), coord(generator), 0.1F * coord(generator));
+        }
+        return points;
+    }
+
+    static bool lessPoint(const Base::Vector3f& p1, const Base::Vector3f& p2)
+    {
+        return std::tie(p1.x, p1.y, p1.z) < std::tie(p2.x, p2.y, p2.z);
+    }
+
+    // checks that the leaves partition the points and lie in their octants
+    static void checkTree(const Points::PointOctree& octree, std::vector<Base::Vector3f> points)
+    {
+        std::vector<Base::Vector3f> stored;
+        for (const auto& node : octree.getNodes()) {
+            if (node.isLeaf()) {
+                const Base::Vector3f* leaf = octree.getPoints(node);
+                for (std::size_t index = 0; index < node.count; index++) {
+                    EXPECT_TRUE(node.box.IsInBox(leaf[index]));
+                    stored.push_back(leaf[index]);
+                }
+            }
+        }
+
+        std::sort(stored.begin(), stored.end(), lessPoint);
+        std::sort(points.begin(), points.end(), lessPoint);
+        EXPECT_EQ(stored, points);
+    }
+};
+
+TEST_F(PointOctreeTest, TestBuildInMemory)
+{
+    std::vector<Base::Vector3f> points = makePoints(5000);
+    Points::PointOctree octree(100);
+    octree.addPoints(points);
+    octree.finish();
+
+    EXPECT_EQ(octree.size(), 5000);
+    EXPECT_GT(octree.getNodes().size(), 8);
+    EXPECT_EQ(octree.getNodes().front().count, 5000);
+    checkTree(octree, points);
+}
+
+TEST_F(PointOctreeTest, TestBuildOnDisk)
+{
+    std::vector<Base::Vector3f> points = makePoints(20000);
+    points[17].x = std::numeric_limits<float>::quiet_NaN();
+    points[4711].z = std::numeric_limits<float>::quiet_NaN();
+
+    // the budget only holds a small part of the points
+    Points::PointOctree octree(100, 1000 * sizeof(Base::Vector3f));
+    for (std::size_t start = 0; start < points.size(); start += 3000) {
+        std::size_t count = std::min<std::size_t>(3000, points.size() - start);
+        octree.addPoints(points.data() + start, count);
+    }
+    octree.finish();
+
+    EXPECT_EQ(octree.size(), 19998);
+    EXPECT_EQ(octree.countInvalid(), 2);
+    points.erase(points.begin() + 4711);
+    points.erase(points.begin() + 17);
+    checkTree(octree, points);
+    EXPECT_THROW(octree.addPoints(points), Base::RuntimeError);
+}
+
+TEST_F(PointOctreeTest, TestQueries)
+{
+    std::vector<Base::Vector3f> points = makePoints(20000);
+    Points::PointOctree octree(200, 2000 * sizeof(Base::Vector3f));
+    octree.addPoints(points);
+    octree.finish();
+
+    Base::BoundBox3f box(-2.F, 1.F, -1.F, 3.F, 4.F, 1.F);
+    std::vector<Base::Vector3f> found;
+    octree.searchBox(box, found);
+    std::vector<Base::Vector3f> inside;
+    std::copy_if(points.begin(), points.end(), std::back_inserter(inside), [&](const auto& pnt) {
+        return box.IsInBox(pnt);
+    });
+    std::sort(found.begin(), found.end(), lessPoint);
+    std::sort(inside.begin(), inside.end(), lessPoint);
+    EXPECT_EQ(found, inside);
+
+    Base::Vector3f pnt(1.234F, -5.678F, 0.5F);
+    Base::Vector3f nearest;
+    ASSERT_TRUE(octree.nearestPoint(pnt, nearest));
+    float minDist = std::numeric_limits<float>::max();
+    for (const auto& it : points) {
+        minDist = std::min(minDist, Base::DistanceP2(pnt, it));
+    }
+    EXPECT_FLOAT_EQ(Base::DistanceP2(pnt, nearest), minDist);
+}
+
+TEST_F(PointOctreeTest, TestLevelOfDetail)
+{
+    std::vector<Base::Vector3f> points = makePoints(20000);
+    Points::PointOctree octree(500);
+    octree.addPoints(points);
+    octree.finish();
+
+    std::vector<Base::Vector3f> subset;
+    octree.getLevelOfDetail(octree.getBoundBox(), 1000, subset);
+    EXPECT_GE(subset.size(), 1000);
+    EXPECT_LT(subset.size(), 1100);
+
+    // the subset covers the whole cloud
+    Base::BoundBox3f box;
+    for (const auto& pnt : subset) {
+        box.Add(pnt);
+    }
+    EXPECT_GT(box.LengthX(), 18.F);
+    EXPECT_GT(box.LengthY(), 18.F);
+
+    subset.clear();
+    octree.getLevelOfDetail(octree.getBoundBox(), 50000, subset);
+    EXPECT_EQ(subset.size(), 20000);
+}
+
+TEST_F(PointOctreeTest, TestKernel)
+{
+    Points::PointKernel kernel;
+    kernel.setBasicPoints(makePoints(1000));
+    Base::Matrix4D mat;
+    mat.move(Base::Vector3d(1, 2, 3));
+    kernel.setTransform(mat);
+
+    Points::PointOctree octree;
+    octree.addPoints(kernel);
+    octree.finish();
+    EXPECT_EQ(octree.size(), 1000);
+    EXPECT_EQ(octree.getTransform(), mat);
+    EXPECT_EQ(octree.getNodes().size(), 1);
+
+    octree.clear();
+    EXPECT_EQ(octree.size(), 0);
+    EXPECT_TRUE(octree.getNodes().empty());
+    Base::Vector3f nearest;
+    EXPECT_FALSE(octree.nearestPoint(Base::Vector3f(), nearest));
+}
+
+// NOLINTEND(cppcoreguidelines-*,readability-*)
@@ -1,4 +1,7 @@
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
 #include <Base/FileInfo.h>
 #include <Mod/Points/App/Points.h>
 #include <Mod/Points/App/PointsAlgos.h>
@@ -46,6 +49,23 @@ protected:
         std::vector<Base::Vector3f> vec(8, Base::Vector3f(0, 0, 1));
         return vec;
     }
+    // appends the bytes of a float in the given byte order
+    static void appendFloat(std::string& data, float value, bool bigEndian)
+    {
+        char bytes[sizeof(float)];
+        std::memcpy(bytes, &value, sizeof(float));
+        const std::uint16_t probe = 1;
+        bool littleHost = *reinterpret_cast<const char*>(&probe) == 1;
+        if (bigEndian == littleHost) {
+            std::reverse(bytes, bytes + sizeof(float));
+        }
+        data.append(bytes, sizeof(float));
+    }
+    void writeFile(const std::string& name, const std::string& data) const
+    {
+        std::ofstream str(name, std::ios::out | std::ios::binary);
+        str.write(data.data(), std::streamsize(data.size()));
+    }
     std::vector<Base::Color> getColors() const
     {
         std::vector<Base::Color> col(8);
@@ -238,4 +258,108 @@ TEST_F(PointsTest, TestPCDStructured)
     EXPECT_EQ(reader.getWidth(), 4);
     EXPECT_EQ(reader.getHeight(), 2);
 }
+
+TEST_F(PointsTest, TestASCIIWithComments)
+{
+    std::string name = getFileName() + ".asc";
+    writeFile(name,
+              "# comment\n"
+              "1.5 2 3\r\n"
+              "\n"
+              "-4 5e-1 +6\n"
+              "7 8\n"
+              "nan 1 2\n"
+              "9 10 11");
+
+    Points::AscReader reader;
+    reader.read(name);
+
+    const Points::PointKernel& points = reader.getPoints();
+    ASSERT_EQ(points.size(), 3);
+    EXPECT_EQ(points.getPoint(0), Base::Vector3d(1.5, 2, 3));
+    EXPECT_EQ(points.getPoint(1), Base::Vector3d(-4, 0.5, 6));
+    EXPECT_EQ(points.getPoint(2), Base::Vector3d(9, 10, 11));
+}
+
+TEST_F(PointsTest, TestBinaryPLY)
+{
+    for (bool bigEndian : {true, false}) {
+        std::string name = getFileName();
+        std::string data = "ply\n";
+        data += bigEndian ? "format binary_big_endian 1.0\n" : "format binary_little_endian 1.0\n";
+        data += "element vertex 2\n"
+                "property float x\n"
+                "property float y\n"
+                "property float z\n"
+                "property uchar red\n"
+                "property uchar green\n"
+                "property uchar blue\n"
+                "end_header\n";
+        for (int i = 0; i < 2; i++) {
+            appendFloat(data, 1.F + float(i), bigEndian);
+            appendFloat(data, -2.F, bigEndian);
+            appendFloat(data, 0.25F, bigEndian);
+            data += char(255);
+            data += char(0);
+            data += char(i * 255);
+        }
+        writeFile(name, data);
+
+        Points::PlyReader reader;
+        reader.read(name);
+
+        const Points::PointKernel& points = reader.getPoints();
+        ASSERT_EQ(points.size(), 2);
+        EXPECT_EQ(points.getPoint(0), Base::Vector3d(1, -2, 0.25));
+        EXPECT_EQ(points.getPoint(1), Base::Vector3d(2, -2, 0.25));
+        ASSERT_TRUE(reader.hasColors());
+        EXPECT_FALSE(reader.hasNormals());
+        EXPECT_EQ(reader.getColors()[0], Base::Color(1, 0, 0));
+        EXPECT_EQ(reader.getColors()[1], Base::Color(1, 0, 1));
+    }
+}
+
+TEST_F(PointsTest, TestCompressedPCD)
+{
+    std::string name = getFileName();
+    std::string data = "VERSION 0.7\n"
+                       "FIELDS x y z\n"
+                       "SIZE 4 4 4\n"
+                       "TYPE F F F\n"
+                       "COUNT 1 1 1\n"
+                       "WIDTH 3\n"
+                       "HEIGHT 1\n"
+                       "POINTS 3\n"
+                       "DATA binary_compressed\n";
+
+    // all x values, then all y and z values
+    std::string fields;
+    for (float value : {1.F, 2.F, 3.F, 4.F, 5.F, 6.F, 7.F, 8.F, 9.F}) {
+        appendFloat(fields, value, false);
+    }
+
+    // store the fields as LZF literal runs of at most 32 bytes
+    std::string compressed;
+    for (std::size_t pos = 0; pos < fields.size(); pos += 32) {
+        std::size_t len = std::min<std::size_t>(32, fields.size() - pos);
+        compressed += char(len - 1);
+        compressed += fields.substr(pos, len);
+    }
+
+    std::uint32_t sizes[2] = {std::uint32_t(compressed.size()), std::uint32_t(fields.size())};
+    data.append(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+    data += compressed;
+    writeFile(name, data);
+
+    Points::PcdReader reader;
+    reader.read(name);
+
+    const Points::PointKernel& points = reader.getPoints();
+    ASSERT_EQ(points.size(), 3);
+    EXPECT_EQ(points.getPoint(0), Base::Vector3d(1, 4, 7));
+    EXPECT_EQ(points.getPoint(1), Base::Vector3d(2, 5, 8));
+    EXPECT_EQ(points.getPoint(2), Base::Vector3d(3, 6, 9));
+    EXPECT_FALSE(reader.hasProperties());
+}
+
 // NOLINTEND(cppcoreguidelines-*,readability-*)
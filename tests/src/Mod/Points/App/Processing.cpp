@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <Base/Exception.h>
+#include <Mod/Points/App/Processing.h>
+
+// NOLINTBEGIN(cppcoreguidelines-*,readability-*)
+
+class PointsProcessing: public ::testing::Test
+{
+protected:
+    // a regular grid of n x n points in the plane z = 0 with a spacing of 1
+    static std::vector<Base::Vector3f> makePlane(int n)
+    {
+        std::vector<Base::Vector3f> points;
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                points.emplace_back(float(i), float(j), 0.F);
+            }
+        }
+        return points;
+    }
+};
+
+TEST_F(PointsProcessing, testNormalsOfPlane)
+{
+    Points::PointKernel kernel;
+    std::vector<Base::Vector3f> points = makePlane(20);
+    kernel.swap(points);
+
+    Points::NormalEstimation estimation(kernel);
+    estimation.setNeighbours(9);
+    estimation.setViewpoint(Base::Vector3f(5.F, 5.F, -10.F));
+    std::vector<Base::Vector3f> normals = estimation.perform();
+
+    ASSERT_EQ(normals.size(), kernel.size());
+    for (const auto& normal : normals) {
+        EXPECT_NEAR(normal.x, 0.F, 1e-5F);
+        EXPECT_NEAR(normal.y, 0.F, 1e-5F);
+        EXPECT_NEAR(normal.z, -1.F, 1e-5F);
+    }
+}
+
+TEST_F(PointsProcessing, testNormalOfInvalidPoint)
+{
+    Points::PointKernel kernel;
+    std::vector<Base::Vector3f> points = makePlane(5);
+    points.emplace_back(std::numeric_limits<float>::quiet_NaN(), 0.F, 0.F);
+    kernel.swap(points);
+
+    Points::NormalEstimation estimation(kernel);
+    std::vector<Base::Vector3f> normals = estimation.perform();
+
+    ASSERT_EQ(normals.size(), kernel.size());
+    EXPECT_EQ(normals.back(), Base::Vector3f());
+    EXPECT_FLOAT_EQ(std::fabs(normals.front().z), 1.F);
+}
+
+TEST_F(PointsProcessing, testRemoveOutliers)
+{
+    Points::PointKernel kernel;
+    std::vector<Base::Vector3f> points = makePlane(20);
+    points.emplace_back(10.F, 10.F, 50.F);
+    points.emplace_back(-40.F, 3.F, 0.F);
+    points.emplace_back(std::numeric_limits<float>::infinity(), 0.F, 0.F);
+    kernel.swap(points);
+
+    Points::OutlierRemoval removal(kernel);
+    removal.setNeighbours(4);
+    removal.setStdDevFactor(1.0);
+    std::vector<unsigned long> indices = removal.perform();
+
+    ASSERT_EQ(indices.size(), 400);
+    for (unsigned long i = 0; i < 400; i++) {
+        EXPECT_EQ(indices[i], i);
+    }
+
+    Points::PointProperties properties;
+    properties.intensity.resize(kernel.size());
+    for (std::size_t i = 0; i < kernel.size(); i++) {
+        properties.intensity[i] = float(i);
+    }
+    properties.keep({3, 7});
+    EXPECT_EQ(properties.intensity, std::vector<float>({3.F, 7.F}));
+    EXPECT_TRUE(properties.normals.empty());
+}
+
+TEST_F(PointsProcessing, testVoxelDownsampling)
+{
+    Points::PointKernel kernel;
+    std::vector<Base::Vector3f> points = makePlane(10);
+    Points::PointProperties properties;
+    for (const auto& pnt : points) {
+        properties.intensity.push_back(pnt.x);
+        properties.colors.emplace_back(1.F, 0.F, 0.F);
+    }
+    kernel.swap(points);
+    Base::Matrix4D mat;
+    mat.move(Base::Vector3d(1, 2, 3));
+    kernel.setTransform(mat);
+
+    Points::PointKernel result;
+    Points::PointProperties resultProperties;
+    Points::VoxelDownsampling sampling(5.0);
+    sampling.perform(kernel, properties, result, resultProperties);
+
+    // the 10 x 10 points fall into 2 x 2 voxels of 5 x 5 points each
+    ASSERT_EQ(result.size(), 4);
+    EXPECT_EQ(result.getTransform(), mat);
+    EXPECT_TRUE(resultProperties.normals.empty());
+    ASSERT_EQ(resultProperties.intensity.size(), 4);
+    ASSERT_EQ(resultProperties.colors.size(), 4);
+
+    const std::vector<Base::Vector3f>& centers = result.getBasicPoints();
+    EXPECT_EQ(centers[0], Base::Vector3f(2.F, 2.F, 0.F));
+    EXPECT_EQ(centers[1], Base::Vector3f(2.F, 7.F, 0.F));
+    EXPECT_EQ(centers[2], Base::Vector3f(7.F, 2.F, 0.F));
+    EXPECT_EQ(centers[3], Base::Vector3f(7.F, 7.F, 0.F));
+    EXPECT_FLOAT_EQ(resultProperties.intensity[0], 2.F);
+    EXPECT_FLOAT_EQ(resultProperties.intensity[3], 7.F);
+    EXPECT_EQ(resultProperties.colors[2], Base::Color(1.F, 0.F, 0.F));
+}
+
+TEST_F(PointsProcessing, testVoxelSize)
+{
+    EXPECT_THROW(Points::VoxelDownsampling(0.0), Base::ValueError);
+
+    Points::PointKernel kernel;
+    std::vector<Base::Vector3f> points {Base::Vector3f(0.F, 0.F, 0.F),
+                                        Base::Vector3f(1e6F, 0.F, 0.F)};
+    kernel.swap(points);
+
+    Points::PointKernel result;
+    Points::PointProperties resultProperties;
+    Points::VoxelDownsampling sampling(1e-3);
+    EXPECT_THROW(sampling.perform(kernel, {}, result, resultProperties), Base::ValueError);
+}
+
+// NOLINTEND(cppcoreguidelines-*,readability-*)
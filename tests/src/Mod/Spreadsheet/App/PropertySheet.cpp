@@ -4,7 +4,14 @@
 #include "src/App/InitApplication.h"
 
 #include <memory>
+#include <set>
+#include <string>
+#include <vector>
 
+#include <App/Application.h>
+#include <App/Document.h>
+#include <App/PropertyStandard.h>
+#include <Base/Interpreter.h>
 #include <Mod/Spreadsheet/App/Sheet.h>
 #include <Mod/Spreadsheet/App/PropertySheet.h>
 
@@ -87,3 +94,139 @@ TEST_F(PropertySheetTest, invalidAliases)  // NOLINT
             << "\"" << name << "\" was accepted as an alias name, and should not be";
     }
 }
+
+class PropertySheetDependencyTest: public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        tests::initApplication();
+        Base::Interpreter().runString("import Spreadsheet");
+    }
+    void SetUp() override
+    {
+        _docName = App::GetApplication().getUniqueDocumentName("test");
+        _doc = App::GetApplication().newDocument(_docName.c_str(), "testUser");
+        _sheet = static_cast<Spreadsheet::Sheet*>(_doc->addObject("Spreadsheet::Sheet"));
+    }
+    void TearDown() override
+    {
+        App::GetApplication().closeDocument(_docName.c_str());
+    }
+
+    App::Document* doc()
+    {
+        return _doc;
+    }
+
+    Spreadsheet::Sheet* sheet()
+    {
+        return _sheet;
+    }
+
+    Spreadsheet::PropertySheet* cells()
+    {
+        return static_cast<Spreadsheet::PropertySheet*>(_sheet->getPropertyByName("cells"));
+    }
+
+    double floatValue(const char* address)
+    {
+        auto prop = dynamic_cast<App::PropertyFloat*>(_sheet->getPropertyByName(address));
+        return prop ? prop->getValue() : 0.0;
+    }
+
+private:
+    std::string _docName;
+    App::Document* _doc {};
+    Spreadsheet::Sheet* _sheet {};
+};
+
+TEST_F(PropertySheetDependencyTest, recomputeOrderFollowsDependencies)  // NOLINT
+{
+    // Arrange
+    sheet()->setCell("A1", "1.5");
+    sheet()->setCell("A2", "=A1 + 1");
+    sheet()->setCell("B1", "=A1 * 2");
+    sheet()->setCell("A3", "=A2 + B1");
+    std::vector<std::vector<App::CellAddress>> levels;
+
+    // Act
+    bool ok = cells()->getRecomputeOrder({App::CellAddress("A1")}, levels);
+
+    // Assert
+    ASSERT_TRUE(ok);
+    ASSERT_EQ(levels.size(), 3);
+    EXPECT_EQ(levels[0], std::vector<App::CellAddress> {App::CellAddress("A1")});
+    std::set<App::CellAddress> second(levels[1].begin(), levels[1].end());
+    EXPECT_EQ(second, (std::set<App::CellAddress> {App::CellAddress("A2"), App::CellAddress("B1")}));
+    EXPECT_EQ(levels[2], std::vector<App::CellAddress> {App::CellAddress("A3")});
+}
+
+TEST_F(PropertySheetDependencyTest, recomputeOrderOnlyContainsDependents)  // NOLINT
+{
+    // Arrange
+    sheet()->setCell("A1", "1.5");
+    sheet()->setCell("A2", "=A1 + 1");
+    sheet()->setCell("B1", "2.5");
+    sheet()->setCell("B2", "=B1 + 1");
+    std::vector<std::vector<App::CellAddress>> levels;
+
+    // Act
+    bool ok = cells()->getRecomputeOrder({App::CellAddress("B1")}, levels);
+
+    // Assert
+    ASSERT_TRUE(ok);
+    ASSERT_EQ(levels.size(), 2);
+    EXPECT_EQ(levels[0], std::vector<App::CellAddress> {App::CellAddress("B1")});
+    EXPECT_EQ(levels[1], std::vector<App::CellAddress> {App::CellAddress("B2")});
+}
+
+TEST_F(PropertySheetDependencyTest, recomputeOrderRejectsCycles)  // NOLINT
+{
+    // Arrange
+    sheet()->setCell("A1", "=A2 + 1");
+    sheet()->setCell("A2", "=A1 + 1");
+    std::vector<std::vector<App::CellAddress>> levels;
+
+    // Act
+    bool ok = cells()->getRecomputeOrder({App::CellAddress("A1")}, levels);
+
+    // Assert
+    EXPECT_FALSE(ok);
+}
+
+TEST_F(PropertySheetDependencyTest, recomputeUpdatesDependents)  // NOLINT
+{
+    // Arrange
+    sheet()->setCell("A1", "1.5");
+    sheet()->setCell("A2", "=A1 + 1");
+    sheet()->setCell("B1", "=A1 * 2");
+    sheet()->setCell("A3", "=A2 + B1");
+    doc()->recompute();
+    EXPECT_DOUBLE_EQ(floatValue("A3"), 5.5);
+
+    // Act
+    sheet()->setCell("A1", "2.5");
+    doc()->recompute();
+
+    // Assert
+    EXPECT_DOUBLE_EQ(floatValue("A3"), 8.5);
+}
+
+TEST_F(PropertySheetDependencyTest, recomputeWideLevel)  // NOLINT
+{
+    // Arrange
+    const int count = 300;
+    sheet()->setCell("A1", "0.5");
+    for (int row = 1; row <= count; ++row) {
+        sheet()->setCell(App::CellAddress(row, 1), ("=A1 + " + std::to_string(row)).c_str());
+    }
+
+    // Act
+    doc()->recompute();
+
+    // Assert
+    for (int row = 1; row <= count; ++row) {
+        EXPECT_DOUBLE_EQ(floatValue(App::CellAddress(row, 1).toString().c_str()), row + 0.5);
+    }
+}